@@ -132,6 +132,89 @@ K4A_EXPORT k4a_result_t k4a_set_debug_message_handler(k4a_logging_message_cb_t *
  */
 K4A_EXPORT k4a_result_t k4a_set_allocator(k4a_memory_allocate_cb_t allocate, k4a_memory_destroy_cb_t free);
 
+/** Sets limits on the memory held by SDK frame allocations.
+ *
+ * \param soft_limit_bytes
+ * Once outstanding image allocations reach this many bytes, new color frames are dropped. Pass 0 for no limit.
+ *
+ * \param hard_limit_bytes
+ * Once outstanding image allocations reach this many bytes, new depth frames are also dropped and k4a_image_create()
+ * fails. Pass 0 for no limit.
+ *
+ * \return ::K4A_RESULT_SUCCEEDED if the limits were set. ::K4A_RESULT_FAILED if \p soft_limit_bytes is larger than a
+ * non-zero \p hard_limit_bytes.
+ *
+ * \remarks
+ * The limits apply to all image memory allocated by the SDK in this process, including captures and images still held
+ * by the application. They let a slow consumer degrade the stream predictably rather than grow without bound: color
+ * is shed first, then depth along with its IR image, since both are produced into the same buffer. IMU samples are
+ * never dropped. Frames that are dropped never reach the capture queue and do not stop streaming.
+ *
+ * \remarks
+ * Limits are checked before each frame is allocated, so concurrent allocations may briefly exceed them by up to one
+ * frame per stream.
+ *
+ * \remarks
+ * Use k4a_get_memory_usage() to observe current usage and how many frames have been dropped.
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">k4a.h (include k4a/k4a.h)</requirement>
+ *   <requirement name="Library">k4a.lib</requirement>
+ *   <requirement name="DLL">k4a.dll</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+K4A_EXPORT k4a_result_t k4a_set_memory_limits(size_t soft_limit_bytes, size_t hard_limit_bytes);
+
+/** Gets the memory held by SDK frame allocations.
+ *
+ * \param usage
+ * Location to write the memory usage to.
+ *
+ * \return ::K4A_RESULT_SUCCEEDED if \p usage was written. ::K4A_RESULT_FAILED if \p usage is NULL.
+ *
+ * \remarks
+ * Reports the outstanding bytes per allocation source, the peak total, the limits set with k4a_set_memory_limits(),
+ * and the number of frames dropped to honor those limits.
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">k4a.h (include k4a/k4a.h)</requirement>
+ *   <requirement name="Library">k4a.lib</requirement>
+ *   <requirement name="DLL">k4a.dll</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+K4A_EXPORT k4a_result_t k4a_get_memory_usage(k4a_memory_usage_t *usage);
+
+/** Sets the directory in which device calibration is cached.
+ *
+ * \param path
+ * Existing directory to store calibration files in, or NULL to disable the cache. When NULL, the
+ * K4A_CALIBRATION_CACHE_DIR environment variable is used instead if it is set.
+ *
+ * \return ::K4A_RESULT_SUCCEEDED if the directory was set, otherwise ::K4A_RESULT_FAILED.
+ *
+ * \remarks
+ * Reading the calibration is the slowest part of k4a_device_open(). With the cache enabled, the first open of each
+ * device stores its calibration in a file named after the serial number. Later opens only read the firmware versions
+ * from the device and load the calibration from that file, falling back to the device if the firmware has changed or
+ * the file fails its checksum.
+ *
+ * \remarks
+ * The setting applies to devices opened after this call.
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">k4a.h (include k4a/k4a.h)</requirement>
+ *   <requirement name="Library">k4a.lib</requirement>
+ *   <requirement name="DLL">k4a.dll</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+K4A_EXPORT k4a_result_t k4a_set_calibration_cache_directory(const char *path);
+
 /** Open an Azure Kinect device.
  *
  * \param index
@@ -161,6 +244,49 @@ K4A_EXPORT k4a_result_t k4a_set_allocator(k4a_memory_allocate_cb_t allocate, k4a
  */
 K4A_EXPORT k4a_result_t k4a_device_open(uint32_t index, k4a_device_t *device_handle);
 
+/** Open several Azure Kinect devices concurrently.
+ *
+ * \param indices
+ * The indices of the devices to open, as passed to k4a_device_open().
+ *
+ * \param device_count
+ * Number of entries in \p indices, \p device_handles, \p results and \p timings.
+ *
+ * \param device_handles
+ * Output array which receives a handle for each device that was opened, and NULL for each device that failed.
+ *
+ * \param results
+ * Optional output array which receives the result of opening each device.
+ *
+ * \param timings
+ * Optional output array which receives the time spent in each step of opening each device.
+ *
+ * \relates k4a_device_t
+ *
+ * \return ::K4A_RESULT_SUCCEEDED if all devices were opened successfully.
+ *
+ * \remarks
+ * Each device is opened on its own thread, and all of them use a single enumeration of the USB bus. Within a device,
+ * the calibration is read while the color MCU is opened, and the depth and color modules are created concurrently.
+ *
+ * \remarks
+ * Devices that were opened are returned even if others failed. Each handle in \p device_handles that is not NULL must
+ * be closed with k4a_device_close().
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">k4a.h (include k4a/k4a.h)</requirement>
+ *   <requirement name="Library">k4a.lib</requirement>
+ *   <requirement name="DLL">k4a.dll</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+K4A_EXPORT k4a_result_t k4a_device_open_multiple(const uint32_t *indices,
+                                                 uint32_t device_count,
+                                                 k4a_device_t *device_handles,
+                                                 k4a_result_t *results,
+                                                 k4a_device_open_timing_t *timings);
+
 /** Closes an Azure Kinect device.
  *
  * \param device_handle
@@ -541,6 +667,113 @@ K4A_EXPORT void k4a_capture_set_depth_image(k4a_capture_t capture_handle, k4a_im
  */
 K4A_EXPORT void k4a_capture_set_ir_image(k4a_capture_t capture_handle, k4a_image_t image_handle);
 
+/** Set a loader that produces the color image of a capture the first time it is accessed.
+ *
+ * \param capture_handle
+ * Capture handle to hold the image.
+ *
+ * \param load_cb
+ * Callback that produces the image. It is called by the first call to k4a_capture_get_color_image().
+ *
+ * \param release_cb
+ * Callback invoked once the loader is no longer needed, or NULL.
+ *
+ * \param loader_context
+ * Context passed to \p load_cb and \p release_cb.
+ *
+ * \returns
+ * ::K4A_RESULT_SUCCEEDED if the loader was set. On failure \p release_cb is not called.
+ *
+ * \relates k4a_capture_t
+ *
+ * \remarks
+ * Any color image already contained in the capture is dereferenced and replaced by the loader. Calling
+ * k4a_capture_set_color_image() before the image is loaded releases the loader without calling \p load_cb, so images
+ * that are never accessed are never produced.
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">k4a.h (include k4a/k4a.h)</requirement>
+ *   <requirement name="Library">k4a.lib</requirement>
+ *   <requirement name="DLL">k4a.dll</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+K4A_EXPORT k4a_result_t k4a_capture_set_color_image_loader(k4a_capture_t capture_handle,
+                                                           k4a_capture_image_load_cb_t *load_cb,
+                                                           k4a_capture_image_loader_release_cb_t *release_cb,
+                                                           void *loader_context);
+
+/** Set a loader that produces the depth image of a capture the first time it is accessed.
+ *
+ * \param capture_handle
+ * Capture handle to hold the image.
+ *
+ * \param load_cb
+ * Callback that produces the image. It is called by the first call to k4a_capture_get_depth_image().
+ *
+ * \param release_cb
+ * Callback invoked once the loader is no longer needed, or NULL.
+ *
+ * \param loader_context
+ * Context passed to \p load_cb and \p release_cb.
+ *
+ * \returns
+ * ::K4A_RESULT_SUCCEEDED if the loader was set. On failure \p release_cb is not called.
+ *
+ * \relates k4a_capture_t
+ *
+ * \remarks
+ * See k4a_capture_set_color_image_loader().
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">k4a.h (include k4a/k4a.h)</requirement>
+ *   <requirement name="Library">k4a.lib</requirement>
+ *   <requirement name="DLL">k4a.dll</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+K4A_EXPORT k4a_result_t k4a_capture_set_depth_image_loader(k4a_capture_t capture_handle,
+                                                           k4a_capture_image_load_cb_t *load_cb,
+                                                           k4a_capture_image_loader_release_cb_t *release_cb,
+                                                           void *loader_context);
+
+/** Set a loader that produces the IR image of a capture the first time it is accessed.
+ *
+ * \param capture_handle
+ * Capture handle to hold the image.
+ *
+ * \param load_cb
+ * Callback that produces the image. It is called by the first call to k4a_capture_get_ir_image().
+ *
+ * \param release_cb
+ * Callback invoked once the loader is no longer needed, or NULL.
+ *
+ * \param loader_context
+ * Context passed to \p load_cb and \p release_cb.
+ *
+ * \returns
+ * ::K4A_RESULT_SUCCEEDED if the loader was set. On failure \p release_cb is not called.
+ *
+ * \relates k4a_capture_t
+ *
+ * \remarks
+ * See k4a_capture_set_color_image_loader().
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">k4a.h (include k4a/k4a.h)</requirement>
+ *   <requirement name="Library">k4a.lib</requirement>
+ *   <requirement name="DLL">k4a.dll</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+K4A_EXPORT k4a_result_t k4a_capture_set_ir_image_loader(k4a_capture_t capture_handle,
+                                                        k4a_capture_image_load_cb_t *load_cb,
+                                                        k4a_capture_image_loader_release_cb_t *release_cb,
+                                                        void *loader_context);
+
 /** Set the temperature associated with the capture.
  *
  * \param capture_handle
@@ -704,6 +937,76 @@ K4A_EXPORT k4a_result_t k4a_image_create_from_buffer(k4a_image_format_t format,
                                                      void *buffer_release_cb_context,
                                                      k4a_image_t *image_handle);
 
+/** Create an image that views a region of an existing image's buffer without copying it.
+ *
+ * \param parent_image_handle
+ * Handle of the image whose buffer the view will reference.
+ *
+ * \param format
+ * The format of the view.
+ *
+ * \param width_pixels
+ * Width of the view in pixels.
+ *
+ * \param height_pixels
+ * Height of the view in pixels.
+ *
+ * \param stride_bytes
+ * The number of bytes per horizontal line of the view. Pass 0 to use the stride of \p parent_image_handle.
+ *
+ * \param offset_bytes
+ * Offset in bytes from the start of the parent's buffer to the first pixel of the view.
+ *
+ * \param view_image_handle
+ * Pointer to store the handle of the view in.
+ *
+ * \remarks
+ * The view shares the memory of \p parent_image_handle. Writes through either image are visible in the other. The view
+ * holds a reference on the parent, so the parent's buffer remains valid until the view is released, even if the caller
+ * releases the parent first.
+ *
+ * \remarks
+ * To view the rectangle starting at column x and row y of an image with 2 bytes per pixel, set \p offset_bytes to
+ * y * stride + x * 2 and keep the parent's stride. To view the Y plane of a #K4A_IMAGE_FORMAT_COLOR_NV12 image use
+ * #K4A_IMAGE_FORMAT_CUSTOM8 with an offset of 0; the interleaved UV plane starts at height * stride.
+ *
+ * \remarks
+ * k4a_image_get_buffer() returns the address of the first pixel of the view and k4a_image_get_size() returns the number
+ * of bytes spanned by the view. The device and system timestamps, exposure, white balance and ISO speed are copied from
+ * the parent when the view is created.
+ *
+ * \remarks
+ * A view can be passed to any function that accepts a \ref k4a_image_t, including the k4a_transformation functions,
+ * as long as its format, size and stride meet that function's requirements.
+ *
+ * \remarks
+ * #K4A_IMAGE_FORMAT_COLOR_MJPG views are not supported.
+ *
+ * \remarks
+ * The \ref k4a_image_t is created with a reference count of 1. Release it with k4a_image_release().
+ *
+ * \returns
+ * Returns #K4A_RESULT_SUCCEEDED on success. #K4A_RESULT_FAILED is returned if the view does not fit within the parent's
+ * buffer or the arguments are invalid.
+ *
+ * \relates k4a_image_t
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">k4a.h (include k4a/k4a.h)</requirement>
+ *   <requirement name="Library">k4a.lib</requirement>
+ *   <requirement name="DLL">k4a.dll</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+K4A_EXPORT k4a_result_t k4a_image_create_view(k4a_image_t parent_image_handle,
+                                              k4a_image_format_t format,
+                                              int width_pixels,
+                                              int height_pixels,
+                                              int stride_bytes,
+                                              size_t offset_bytes,
+                                              k4a_image_t *view_image_handle);
+
 /** Get the image buffer.
  *
  * \param image_handle
@@ -1002,6 +1305,37 @@ K4A_EXPORT uint32_t k4a_image_get_white_balance(k4a_image_t image_handle);
  */
 K4A_EXPORT uint32_t k4a_image_get_iso_speed(k4a_image_t image_handle);
 
+/** Get all of the image's properties in one call.
+ *
+ * \param image_handle
+ * Handle of the image for which the get operation is performed on.
+ *
+ * \param info
+ * Location to write the image properties to.
+ *
+ * \returns
+ * ::K4A_RESULT_SUCCEEDED if \p info was written. ::K4A_RESULT_FAILED if \p image_handle is invalid or \p info is
+ * NULL.
+ *
+ * \remarks
+ * Returns the same values as k4a_image_get_buffer(), k4a_image_get_size(), k4a_image_get_format(),
+ * k4a_image_get_width_pixels(), k4a_image_get_height_pixels(), k4a_image_get_stride_bytes(),
+ * k4a_image_get_device_timestamp_usec(), k4a_image_get_system_timestamp_nsec(), k4a_image_get_exposure_usec(),
+ * k4a_image_get_white_balance() and k4a_image_get_iso_speed(), but validates \p image_handle once rather than once per
+ * property. Prefer it when reading several properties of every image in a streaming loop.
+ *
+ * \relates k4a_image_t
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">k4a.h (include k4a/k4a.h)</requirement>
+ *   <requirement name="Library">k4a.lib</requirement>
+ *   <requirement name="DLL">k4a.dll</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+K4A_EXPORT k4a_result_t k4a_image_get_info(k4a_image_t image_handle, k4a_image_info_t *info);
+
 /** Set the device time stamp, in microseconds, of the image.
  *
  * \param image_handle
@@ -1261,6 +1595,51 @@ K4A_EXPORT void k4a_image_release(k4a_image_t image_handle);
  */
 K4A_EXPORT k4a_result_t k4a_device_start_cameras(k4a_device_t device_handle, const k4a_device_configuration_t *config);
 
+/** Sets whether the frame buffers used while streaming are preallocated.
+ *
+ * \param device_handle
+ * Handle obtained by k4a_device_open().
+ *
+ * \param preallocation
+ * Preallocation to use the next time k4a_device_start_cameras() is called. The default is
+ * ::K4A_BUFFER_PREALLOCATION_NONE.
+ *
+ * \returns
+ * ::K4A_RESULT_SUCCEEDED if the setting was stored. ::K4A_RESULT_FAILED if \p preallocation is not a valid value or the
+ * cameras are running.
+ *
+ * \relates k4a_device_t
+ *
+ * \remarks
+ * By default frame buffers are allocated as frames arrive, and the first write to each new buffer takes a page fault
+ * for every page. On hosts with tight latency requirements this shows up as periodic stalls.
+ *
+ * \remarks
+ * When enabled, k4a_device_start_cameras() sets aside one capture queue's worth of color, depth and raw USB frame
+ * buffers for the configured mode, touches every page, and recycles those buffers rather than freeing them. All of the
+ * buffers are created before k4a_device_start_cameras() returns, so the streaming path does not take page faults or
+ * allocate unless the application holds more frames than the capture queue depth, in which case the extra frames are
+ * allocated normally.
+ *
+ * \remarks
+ * ::K4A_BUFFER_PREALLOCATION_PREFAULT_AND_LOCK also locks the buffers into physical memory. This requires the process to
+ * be allowed to lock that much memory, otherwise k4a_device_start_cameras() fails.
+ *
+ * \remarks
+ * Preallocated buffers are obtained from the allocator set with k4a_set_allocator() at the time the cameras start. They
+ * are released when the cameras stop and the application has released all captures that use them.
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">k4a.h (include k4a/k4a.h)</requirement>
+ *   <requirement name="Library">k4a.lib</requirement>
+ *   <requirement name="DLL">k4a.dll</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+K4A_EXPORT k4a_result_t k4a_device_set_buffer_preallocation(k4a_device_t device_handle,
+                                                            k4a_buffer_preallocation_t preallocation);
+
 /** Stops the color and depth camera capture.
  *
  * \param device_handle
@@ -2014,12 +2393,28 @@ K4A_EXPORT k4a_result_t k4a_calibration_color_2d_to_depth_2d(const k4a_calibrati
  */
 K4A_EXPORT k4a_transformation_t k4a_transformation_create(const k4a_calibration_t *calibration);
 
-/** Destroy transformation handle.
+/** Get a transformation handle that routes each operation to the fastest backend on this machine.
  *
- * \param transformation_handle
- * Transformation handle to destroy.
+ * \param calibration
+ * A calibration structure obtained by k4a_device_get_calibration().
  *
- * \relates k4a_transformation_t
+ * \returns
+ * A transformation handle. A NULL is returned if creation fails.
+ *
+ * \remarks
+ * Behaves like k4a_transformation_create(), except that creation also times every backend available for each
+ * ::k4a_transformation_operation_t on synthetic frames at the resolutions of \p calibration. Each operation is then run
+ * on the backend that was fastest. If the transform engine plugin cannot be loaded, only the CPU backends are
+ * considered.
+ *
+ * \remarks
+ * Tuning runs each backend a few times per operation, so creation takes longer than k4a_transformation_create(); in
+ * the order of a second at the highest color resolution on a CPU-only machine. Create the handle once and reuse it.
+ *
+ * \remarks
+ * Use k4a_transformation_get_tuning() to see the selected backends and the measured timings.
+ *
+ * \relates k4a_calibration_t
  *
  * \xmlonly
  * <requirements>
@@ -2029,32 +2424,74 @@ K4A_EXPORT k4a_transformation_t k4a_transformation_create(const k4a_calibration_
  * </requirements>
  * \endxmlonly
  */
-K4A_EXPORT void k4a_transformation_destroy(k4a_transformation_t transformation_handle);
+K4A_EXPORT k4a_transformation_t k4a_transformation_create_auto_tuned(const k4a_calibration_t *calibration);
 
-/** Transforms the depth map into the geometry of the color camera.
+/** Get the backend selection of a transformation handle.
  *
  * \param transformation_handle
  * Transformation handle.
  *
- * \param depth_image
- * Handle to input depth image.
- *
- * \param transformed_depth_image
- * Handle to output transformed depth image.
- *
- * \remarks
- * This produces a depth image for which each pixel matches the corresponding pixel coordinates of the color camera.
+ * \param tuning
+ * Location to write the backend of each operation and, for handles created with
+ * k4a_transformation_create_auto_tuned(), the timings that the selection was based on.
  *
- * \remarks
- * \p depth_image and \p transformed_depth_image must be of format ::K4A_IMAGE_FORMAT_DEPTH16.
+ * \returns
+ * ::K4A_RESULT_SUCCEEDED if \p tuning was written, otherwise ::K4A_RESULT_FAILED.
  *
- * \remarks
- * \p transformed_depth_image must have a width and height matching the width and height of the color camera in the mode
- * specified by the \ref k4a_calibration_t used to create the \p transformation_handle with k4a_transformation_create().
+ * \relates k4a_transformation_t
  *
- * \remarks
- * The contents \p transformed_depth_image will be filled with the depth values derived from \p depth_image in the color
- * camera's coordinate space.
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">k4a.h (include k4a/k4a.h)</requirement>
+ *   <requirement name="Library">k4a.lib</requirement>
+ *   <requirement name="DLL">k4a.dll</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+K4A_EXPORT k4a_result_t k4a_transformation_get_tuning(k4a_transformation_t transformation_handle,
+                                                       k4a_transformation_tuning_t *tuning);
+
+/** Destroy transformation handle.
+ *
+ * \param transformation_handle
+ * Transformation handle to destroy.
+ *
+ * \relates k4a_transformation_t
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">k4a.h (include k4a/k4a.h)</requirement>
+ *   <requirement name="Library">k4a.lib</requirement>
+ *   <requirement name="DLL">k4a.dll</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+K4A_EXPORT void k4a_transformation_destroy(k4a_transformation_t transformation_handle);
+
+/** Transforms the depth map into the geometry of the color camera.
+ *
+ * \param transformation_handle
+ * Transformation handle.
+ *
+ * \param depth_image
+ * Handle to input depth image.
+ *
+ * \param transformed_depth_image
+ * Handle to output transformed depth image.
+ *
+ * \remarks
+ * This produces a depth image for which each pixel matches the corresponding pixel coordinates of the color camera.
+ *
+ * \remarks
+ * \p depth_image and \p transformed_depth_image must be of format ::K4A_IMAGE_FORMAT_DEPTH16.
+ *
+ * \remarks
+ * \p transformed_depth_image must have a width and height matching the width and height of the color camera in the mode
+ * specified by the \ref k4a_calibration_t used to create the \p transformation_handle with k4a_transformation_create().
+ *
+ * \remarks
+ * The contents \p transformed_depth_image will be filled with the depth values derived from \p depth_image in the color
+ * camera's coordinate space.
  *
  * \remarks
  * \p transformed_depth_image should be created by the caller using k4a_image_create() or
@@ -2077,6 +2514,47 @@ K4A_EXPORT k4a_result_t k4a_transformation_depth_image_to_color_camera(k4a_trans
                                                                        const k4a_image_t depth_image,
                                                                        k4a_image_t transformed_depth_image);
 
+/** Enables or disables incremental mode for transforming depth images into the color camera.
+ *
+ * \param transformation_handle
+ * Transformation handle.
+ *
+ * \param enable
+ * True to keep the previous frame between calls to k4a_transformation_depth_image_to_color_camera(), false to release
+ * it and rasterize every frame in full.
+ *
+ * \param max_changed_fraction
+ * Fraction of the depth image, between 0 and 1, that may change before a frame is rasterized in full instead.
+ *
+ * \remarks
+ * Intended for cameras watching mostly static scenes. The depth image is split into tiles, and only the parts of the
+ * color image covered by tiles that differ from the previous frame are rasterized again. The output is the same as
+ * without incremental mode.
+ *
+ * \remarks
+ * Incremental mode only applies to k4a_transformation_depth_image_to_color_camera(), and runs on the CPU on the
+ * calling thread. The first frame after enabling it is rasterized in full.
+ *
+ * \remarks
+ * The previous frame is kept per \p transformation_handle. Consecutive depth images should come from the same camera.
+ *
+ * \returns
+ * ::K4A_RESULT_SUCCEEDED if the mode was set and ::K4A_RESULT_FAILED otherwise.
+ *
+ * \relates k4a_transformation_t
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">k4a.h (include k4a/k4a.h)</requirement>
+ *   <requirement name="Library">k4a.lib</requirement>
+ *   <requirement name="DLL">k4a.dll</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+K4A_EXPORT k4a_result_t k4a_transformation_set_incremental(k4a_transformation_t transformation_handle,
+                                                           bool enable,
+                                                           float max_changed_fraction);
+
 /** Transforms depth map and a custom image into the geometry of the color camera.
  *
  * \param transformation_handle
@@ -2162,6 +2640,107 @@ k4a_transformation_depth_image_to_color_camera_custom(k4a_transformation_t trans
                                                       k4a_transformation_interpolation_type_t interpolation_type,
                                                       uint32_t invalid_custom_value);
 
+/** Transforms the depth map and several custom images into the geometry of the color camera.
+ *
+ * \param transformation_handle
+ * Transformation handle.
+ *
+ * \param depth_image
+ * Handle to input depth image.
+ *
+ * \param transformed_depth_image
+ * Handle to output transformed depth image.
+ *
+ * \param channels
+ * Custom images to transform, each with its own output image, interpolation type and invalid value.
+ *
+ * \param channel_count
+ * Number of entries in \p channels, at most #K4A_TRANSFORMATION_MAX_CUSTOM_CHANNELS. 0 transforms only the depth map.
+ *
+ * \remarks
+ * The result is the same as calling k4a_transformation_depth_image_to_color_camera_custom() once per channel, but the
+ * depth map is rasterized only once and every channel is interpolated in the same pass.
+ *
+ * \remarks
+ * Each channel may be ::K4A_IMAGE_FORMAT_CUSTOM8 or ::K4A_IMAGE_FORMAT_CUSTOM16, independently of the others.
+ *
+ * \remarks
+ * A single channel runs on the same backend as k4a_transformation_depth_image_to_color_camera_custom(). Several
+ * channels always run on the CPU, since the transform engine carries one custom image at a time.
+ *
+ * \returns
+ * ::K4A_RESULT_SUCCEEDED if \p transformed_depth_image and every transformed custom image were successfully written
+ * and ::K4A_RESULT_FAILED otherwise.
+ *
+ * \relates k4a_transformation_t
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">k4a.h (include k4a/k4a.h)</requirement>
+ *   <requirement name="Library">k4a.lib</requirement>
+ *   <requirement name="DLL">k4a.dll</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+K4A_EXPORT k4a_result_t
+k4a_transformation_depth_image_to_color_camera_custom_channels(k4a_transformation_t transformation_handle,
+                                                               const k4a_image_t depth_image,
+                                                               k4a_image_t transformed_depth_image,
+                                                               const k4a_transformation_custom_channel_t *channels,
+                                                               uint32_t channel_count);
+
+/** Registers an IR image into the geometry of the color camera.
+ *
+ * \param transformation_handle
+ * Transformation handle.
+ *
+ * \param depth_image
+ * Handle to input depth image.
+ *
+ * \param ir_image
+ * Handle to input IR image, captured together with \p depth_image.
+ *
+ * \param transformed_ir_image
+ * Handle to output transformed IR image.
+ *
+ * \param transformed_depth_image
+ * Handle to output transformed depth image, or NULL if the registered depth image is not needed.
+ *
+ * \remarks
+ * \p ir_image must be of format ::K4A_IMAGE_FORMAT_IR16 with the width and height of \p depth_image.
+ * \p transformed_ir_image must be of format ::K4A_IMAGE_FORMAT_IR16 and, like \p transformed_depth_image, have the
+ * width and height of the color camera in the mode specified by the \ref k4a_calibration_t used to create the
+ * \p transformation_handle.
+ *
+ * \remarks
+ * The IR image is warped with the same rasterization of \p depth_image that produces \p transformed_depth_image,
+ * using linear interpolation. Color pixels that no depth pixel maps to are set to 0 in both output images.
+ *
+ * \remarks
+ * This is equivalent to passing \p ir_image to k4a_transformation_depth_image_to_color_camera_custom() as a
+ * ::K4A_IMAGE_FORMAT_CUSTOM16 image, without re-tagging the image format and without requiring an output depth
+ * image. It runs on the backend selected for ::K4A_TRANSFORMATION_OPERATION_DEPTH_IMAGE_TO_COLOR_CAMERA_CUSTOM.
+ *
+ * \returns
+ * ::K4A_RESULT_SUCCEEDED if \p transformed_ir_image, and \p transformed_depth_image if provided, were successfully
+ * written and ::K4A_RESULT_FAILED otherwise.
+ *
+ * \relates k4a_transformation_t
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">k4a.h (include k4a/k4a.h)</requirement>
+ *   <requirement name="Library">k4a.lib</requirement>
+ *   <requirement name="DLL">k4a.dll</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+K4A_EXPORT k4a_result_t k4a_transformation_ir_image_to_color_camera(k4a_transformation_t transformation_handle,
+                                                                    const k4a_image_t depth_image,
+                                                                    const k4a_image_t ir_image,
+                                                                    k4a_image_t transformed_ir_image,
+                                                                    k4a_image_t transformed_depth_image);
+
 /** Transforms a color image into the geometry of the depth camera.
  *
  * \param transformation_handle
@@ -2266,6 +2845,385 @@ K4A_EXPORT k4a_result_t k4a_transformation_depth_image_to_point_cloud(k4a_transf
                                                                       const k4a_calibration_type_t camera,
                                                                       k4a_image_t xyz_image);
 
+/** Triangulates a depth image into a mesh of its 3D points.
+ *
+ * \param transformation_handle
+ * Transformation handle.
+ *
+ * \param depth_image
+ * Handle to input depth image.
+ *
+ * \param camera
+ * Geometry in which depth map was computed.
+ *
+ * \param max_discontinuity_ratio
+ * Quads whose depth range exceeds this fraction of their nearest depth are dropped. Use
+ * #K4A_TRANSFORMATION_MESH_DEFAULT_DISCONTINUITY_RATIO for the threshold of the depth to color transformation.
+ *
+ * \param xyz_image
+ * Handle to output xyz image, which holds the vertices of the mesh.
+ *
+ * \param indices
+ * Location to write the indices of the triangles. May be NULL to query the required capacity.
+ *
+ * \param index_count
+ * On input, the number of entries \p indices can hold. On output, the number of indices written, or the required
+ * capacity if it was too small.
+ *
+ * \remarks
+ * \p xyz_image is filled exactly as by k4a_transformation_depth_image_to_point_cloud(), and has the same requirements.
+ * Its pixels are the vertices of the mesh: the vertex of pixel (x, y) has index y * width + x.
+ *
+ * \remarks
+ * Each triangle is three consecutive entries of \p indices. Every 2x2 block of pixels gives two triangles, split along
+ * the diagonal from its top left pixel, or one triangle if exactly one of its pixels has no valid depth. Triangles are
+ * wound clockwise in image coordinates.
+ *
+ * \remarks
+ * The required capacity of \p indices is the worst case of two triangles per block, 6 * (width - 1) * (height - 1).
+ * The triangles are generated on several threads and written in row order, independently of the number of threads.
+ *
+ * \returns
+ * ::K4A_BUFFER_RESULT_SUCCEEDED if \p xyz_image and \p indices were successfully written. If \p indices is NULL or
+ * \p index_count is smaller than the required capacity, \p index_count is set to the required capacity and
+ * ::K4A_BUFFER_RESULT_TOO_SMALL is returned. ::K4A_BUFFER_RESULT_FAILED is returned otherwise.
+ *
+ * \relates k4a_transformation_t
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">k4a.h (include k4a/k4a.h)</requirement>
+ *   <requirement name="Library">k4a.lib</requirement>
+ *   <requirement name="DLL">k4a.dll</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+K4A_EXPORT k4a_buffer_result_t k4a_transformation_depth_image_to_mesh(k4a_transformation_t transformation_handle,
+                                                                      const k4a_image_t depth_image,
+                                                                      const k4a_calibration_type_t camera,
+                                                                      float max_discontinuity_ratio,
+                                                                      k4a_image_t xyz_image,
+                                                                      uint32_t *indices,
+                                                                      size_t *index_count);
+
+/** Computes the point cloud of a depth image downsampled to a voxel grid.
+ *
+ * \param transformation_handle
+ * Transformation handle.
+ *
+ * \param depth_image
+ * Handle to input depth image.
+ *
+ * \param color_image
+ * Optional handle to a ::K4A_IMAGE_FORMAT_COLOR_BGRA32 image with the width and height of \p depth_image, for example
+ * the output of k4a_transformation_color_image_to_depth_camera(). May be NULL.
+ *
+ * \param camera
+ * Geometry in which depth map was computed.
+ *
+ * \param grid
+ * Voxel size and bounds of the grid. Points outside the bounds are dropped.
+ *
+ * \param points
+ * Location to write one entry per occupied voxel. May be NULL to query the required capacity.
+ *
+ * \param point_count
+ * On input, the number of entries \p points can hold. On output, the number of occupied voxels, or the required
+ * capacity if it was too small.
+ *
+ * \remarks
+ * This gives the same points as binning the output of k4a_transformation_depth_image_to_point_cloud() into \p grid and
+ * averaging them, without writing the full resolution point cloud. Positions are averaged from the millimeter
+ * coordinates of the point cloud. If \p color_image is given, the colors of the pixels are averaged too.
+ *
+ * \remarks
+ * The required capacity of \p points is the smaller of the number of pixels of \p depth_image and the number of
+ * voxels in \p grid.
+ *
+ * \remarks
+ * The depth image is processed on several threads. Voxels are written in the order in which they are first hit when
+ * scanning \p depth_image row by row, and the result does not depend on the number of threads.
+ *
+ * \returns
+ * ::K4A_BUFFER_RESULT_SUCCEEDED if \p points was successfully written. If \p points is NULL or \p point_count is
+ * smaller than the required capacity, \p point_count is set to the required capacity and
+ * ::K4A_BUFFER_RESULT_TOO_SMALL is returned. ::K4A_BUFFER_RESULT_FAILED is returned otherwise.
+ *
+ * \relates k4a_transformation_t
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">k4a.h (include k4a/k4a.h)</requirement>
+ *   <requirement name="Library">k4a.lib</requirement>
+ *   <requirement name="DLL">k4a.dll</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+K4A_EXPORT k4a_buffer_result_t k4a_transformation_depth_image_to_voxel_cloud(k4a_transformation_t transformation_handle,
+                                                                             const k4a_image_t depth_image,
+                                                                             const k4a_image_t color_image,
+                                                                             const k4a_calibration_type_t camera,
+                                                                             const k4a_voxel_grid_t *grid,
+                                                                             k4a_voxel_point_t *points,
+                                                                             size_t *point_count);
+
+/** Set the maximum number of asynchronous requests a transformation handle accepts.
+ *
+ * \param transformation_handle
+ * Transformation handle.
+ *
+ * \param max_in_flight
+ * Maximum number of requests submitted with k4a_transformation_submit() that may be outstanding at once, between 1 and
+ * 32. The default is 4.
+ *
+ * \returns
+ * ::K4A_RESULT_SUCCEEDED on success, ::K4A_RESULT_FAILED if \p max_in_flight is out of range.
+ *
+ * \remarks
+ * A request is outstanding from when it is submitted until its callback returns, or until
+ * k4a_transformation_wait() returns its result. Lowering the limit does not affect requests already submitted.
+ *
+ * \relates k4a_transformation_t
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">k4a.h (include k4a/k4a.h)</requirement>
+ *   <requirement name="Library">k4a.lib</requirement>
+ *   <requirement name="DLL">k4a.dll</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+K4A_EXPORT k4a_result_t k4a_transformation_set_max_in_flight(k4a_transformation_t transformation_handle,
+                                                             uint32_t max_in_flight);
+
+/** Submit a transformation without waiting for it to complete.
+ *
+ * \param transformation_handle
+ * Transformation handle.
+ *
+ * \param request
+ * The operation and images to transform. The transformation holds a reference to each image until the request
+ * completes.
+ *
+ * \param timeout_in_ms
+ * Specifies the time in milliseconds the function should block waiting for the number of outstanding requests to drop
+ * below the limit set by k4a_transformation_set_max_in_flight(). 0 is a check of the status without blocking. Passing
+ * a value of #K4A_WAIT_INFINITE will block indefinitely.
+ *
+ * \param ticket
+ * Output parameter which on success receives the ticket identifying the request.
+ *
+ * \returns
+ * ::K4A_WAIT_RESULT_SUCCEEDED if the request was submitted, ::K4A_WAIT_RESULT_TIMEOUT if too many requests were
+ * outstanding, or ::K4A_WAIT_RESULT_FAILED if the request is invalid.
+ *
+ * \remarks
+ * Depth to color and color to depth requests run on the GPU transform engine when it is in use, and all other requests
+ * run on a worker thread owned by the transformation handle. Requests on the same engine complete in the order they
+ * were submitted. k4a_transformation_destroy() completes requests that are still queued before it returns.
+ *
+ * \remarks
+ * Parameter errors that the synchronous functions would report are reported through the request's result. The
+ * callback may then be called before k4a_transformation_submit() returns; \p ticket is set before that happens.
+ *
+ * \relates k4a_transformation_t
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">k4a.h (include k4a/k4a.h)</requirement>
+ *   <requirement name="Library">k4a.lib</requirement>
+ *   <requirement name="DLL">k4a.dll</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+K4A_EXPORT k4a_wait_result_t k4a_transformation_submit(k4a_transformation_t transformation_handle,
+                                                       const k4a_transformation_request_t *request,
+                                                       int32_t timeout_in_ms,
+                                                       k4a_transformation_ticket_t *ticket);
+
+/** Wait for a submitted transformation to complete.
+ *
+ * \param transformation_handle
+ * Transformation handle.
+ *
+ * \param ticket
+ * Ticket returned by k4a_transformation_submit() for a request without a callback.
+ *
+ * \param timeout_in_ms
+ * Specifies the time in milliseconds the function should block waiting for the request. 0 is a check of the status
+ * without blocking. Passing a value of #K4A_WAIT_INFINITE will block indefinitely.
+ *
+ * \param result
+ * Output parameter which receives the result of the transformation once it has completed.
+ *
+ * \returns
+ * ::K4A_WAIT_RESULT_SUCCEEDED if the request has completed, ::K4A_WAIT_RESULT_TIMEOUT if it has not, or
+ * ::K4A_WAIT_RESULT_FAILED if \p ticket is unknown.
+ *
+ * \remarks
+ * A ticket can be waited for successfully only once. Tickets of requests that were submitted with a callback can not be
+ * waited for.
+ *
+ * \relates k4a_transformation_t
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">k4a.h (include k4a/k4a.h)</requirement>
+ *   <requirement name="Library">k4a.lib</requirement>
+ *   <requirement name="DLL">k4a.dll</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+K4A_EXPORT k4a_wait_result_t k4a_transformation_wait(k4a_transformation_t transformation_handle,
+                                                     k4a_transformation_ticket_t ticket,
+                                                     int32_t timeout_in_ms,
+                                                     k4a_result_t *result);
+
+/** Create a transformation pipeline.
+ *
+ * \param transformation_handle
+ * Transformation handle used by the pipeline. It must not be destroyed before the pipeline.
+ *
+ * \param config
+ * Outputs to produce for every capture and how results are delivered.
+ *
+ * \param pipeline_handle
+ * Output parameter which on success will return a handle to the pipeline.
+ *
+ * \returns
+ * ::K4A_RESULT_SUCCEEDED if the pipeline was created. ::K4A_RESULT_FAILED if the configuration is invalid or resources
+ * could not be allocated.
+ *
+ * \remarks
+ * The output images and their descriptors are sized once from the calibration of \p transformation_handle. Output
+ * buffers are allocated up front for \p max_in_flight captures and reused for every later capture.
+ *
+ * \remarks
+ * Depth to color and color to depth run on one worker thread and point clouds on a second, so the point clouds of one
+ * capture are computed while the next capture is being transformed.
+ *
+ * \remarks
+ * The pipeline must be destroyed with k4a_transformation_pipeline_destroy().
+ *
+ * \relates k4a_transformation_pipeline_t
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">k4a.h (include k4a/k4a.h)</requirement>
+ *   <requirement name="Library">k4a.lib</requirement>
+ *   <requirement name="DLL">k4a.dll</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+K4A_EXPORT k4a_result_t k4a_transformation_pipeline_create(k4a_transformation_t transformation_handle,
+                                                           const k4a_transformation_pipeline_config_t *config,
+                                                           k4a_transformation_pipeline_t *pipeline_handle);
+
+/** Destroy a transformation pipeline.
+ *
+ * \param pipeline_handle
+ * Pipeline handle to destroy.
+ *
+ * \remarks
+ * Captures that have been submitted but not delivered are discarded. Output images that the application still holds
+ * remain valid after the pipeline is destroyed.
+ *
+ * \relates k4a_transformation_pipeline_t
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">k4a.h (include k4a/k4a.h)</requirement>
+ *   <requirement name="Library">k4a.lib</requirement>
+ *   <requirement name="DLL">k4a.dll</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+K4A_EXPORT void k4a_transformation_pipeline_destroy(k4a_transformation_pipeline_t pipeline_handle);
+
+/** Submit a capture to a transformation pipeline.
+ *
+ * \param pipeline_handle
+ * Pipeline handle.
+ *
+ * \param capture_handle
+ * Capture to transform. It must contain a depth image, and a BGRA32 color image when
+ * ::K4A_TRANSFORMATION_PIPELINE_OUTPUT_COLOR_IN_DEPTH is requested. The pipeline holds a reference to the capture until
+ * its result is released.
+ *
+ * \param timeout_in_ms
+ * Specifies the time in milliseconds the function should block waiting for room in the pipeline. 0 is a check of the
+ * status without blocking. Passing a value of #K4A_WAIT_INFINITE will block indefinitely.
+ *
+ * \returns
+ * ::K4A_WAIT_RESULT_SUCCEEDED if the capture was submitted. ::K4A_WAIT_RESULT_TIMEOUT if \p max_in_flight captures were
+ * still in the pipeline when the timeout elapsed. ::K4A_WAIT_RESULT_FAILED if the capture is missing a required image
+ * or the pipeline is being destroyed.
+ *
+ * \relates k4a_transformation_pipeline_t
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">k4a.h (include k4a/k4a.h)</requirement>
+ *   <requirement name="Library">k4a.lib</requirement>
+ *   <requirement name="DLL">k4a.dll</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+K4A_EXPORT k4a_wait_result_t k4a_transformation_pipeline_submit(k4a_transformation_pipeline_t pipeline_handle,
+                                                                k4a_capture_t capture_handle,
+                                                                int32_t timeout_in_ms);
+
+/** Get the next result from a transformation pipeline.
+ *
+ * \param pipeline_handle
+ * Pipeline handle. The pipeline must have been created without a callback.
+ *
+ * \param result
+ * Output parameter which on success receives the result of the oldest capture that has completed.
+ *
+ * \param timeout_in_ms
+ * Specifies the time in milliseconds the function should block waiting for a result. 0 is a check of the status
+ * without blocking. Passing a value of #K4A_WAIT_INFINITE will block indefinitely.
+ *
+ * \returns
+ * ::K4A_WAIT_RESULT_SUCCEEDED if a result was returned, ::K4A_WAIT_RESULT_TIMEOUT if no result completed in time, or
+ * ::K4A_WAIT_RESULT_FAILED on error.
+ *
+ * \remarks
+ * Results are returned in the order the captures were submitted. Each result must be released with
+ * k4a_transformation_pipeline_release_result().
+ *
+ * \relates k4a_transformation_pipeline_t
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">k4a.h (include k4a/k4a.h)</requirement>
+ *   <requirement name="Library">k4a.lib</requirement>
+ *   <requirement name="DLL">k4a.dll</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+K4A_EXPORT k4a_wait_result_t k4a_transformation_pipeline_get_result(k4a_transformation_pipeline_t pipeline_handle,
+                                                                    k4a_transformation_pipeline_result_t *result,
+                                                                    int32_t timeout_in_ms);
+
+/** Release the handles held by a transformation pipeline result.
+ *
+ * \param result
+ * Result returned by k4a_transformation_pipeline_get_result(). The handles in it are set to 0.
+ *
+ * \relates k4a_transformation_pipeline_t
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">k4a.h (include k4a/k4a.h)</requirement>
+ *   <requirement name="Library">k4a.lib</requirement>
+ *   <requirement name="DLL">k4a.dll</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+K4A_EXPORT void k4a_transformation_pipeline_release_result(k4a_transformation_pipeline_result_t *result);
+
 /**
  * @}
  */
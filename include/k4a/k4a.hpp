@@ -258,6 +258,27 @@ public:
         return image(handle);
     }
 
+    /** Create an image that views a region of this image's buffer without copying it
+     * Throws error on failure
+     *
+     * \sa k4a_image_create_view
+     */
+    image create_view(k4a_image_format_t format,
+                      int width_pixels,
+                      int height_pixels,
+                      int stride_bytes,
+                      size_t offset_bytes) const
+    {
+        k4a_image_t handle = nullptr;
+        k4a_result_t result =
+            k4a_image_create_view(m_handle, format, width_pixels, height_pixels, stride_bytes, offset_bytes, &handle);
+        if (K4A_RESULT_SUCCEEDED != result)
+        {
+            throw error("Failed to create image view!");
+        }
+        return image(handle);
+    }
+
     /** Get the image buffer
      *
      * \sa k4a_image_get_buffer
@@ -366,6 +387,22 @@ public:
         return k4a_image_get_iso_speed(m_handle);
     }
 
+    /** Get all of the image's properties in one call
+     * Throws error on failure
+     *
+     * \sa k4a_image_get_info
+     */
+    k4a_image_info_t get_info() const
+    {
+        k4a_image_info_t info;
+        k4a_result_t result = k4a_image_get_info(m_handle, &info);
+        if (K4A_RESULT_SUCCEEDED != result)
+        {
+            throw error("Failed to get image info!");
+        }
+        return info;
+    }
+
     /** Set the image's timestamp in microseconds
      *
      * \sa k4a_image_set_device_timestamp_usec
@@ -1224,6 +1261,20 @@ public:
         return get_imu_sample(imu_sample, std::chrono::milliseconds(K4A_WAIT_INFINITE));
     }
 
+    /** Sets whether the frame buffers used while streaming are preallocated by start_cameras()
+     * Throws error on failure.
+     *
+     * \sa k4a_device_set_buffer_preallocation
+     */
+    void set_buffer_preallocation(k4a_buffer_preallocation_t preallocation)
+    {
+        k4a_result_t result = k4a_device_set_buffer_preallocation(m_handle, preallocation);
+        if (K4A_RESULT_SUCCEEDED != result)
+        {
+            throw error("Failed to set buffer preallocation!");
+        }
+    }
+
     /** Starts the K4A device's cameras
      * Throws error on failure.
      *
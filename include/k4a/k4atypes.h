@@ -194,6 +194,28 @@ K4A_DECLARE_HANDLE(k4a_image_t);
  */
 K4A_DECLARE_HANDLE(k4a_transformation_t);
 
+/** \class k4a_transformation_pipeline_t k4a.h <k4a/k4a.h>
+ * Handle to an Azure Kinect transformation pipeline.
+ *
+ * \remarks
+ * Handles are created with k4a_transformation_pipeline_create() and closed with
+ * k4a_transformation_pipeline_destroy().
+ *
+ * \remarks
+ * A transformation pipeline applies a fixed set of transformations to every capture submitted to it. The stages run on
+ * worker threads owned by the pipeline, so the transformations of consecutive captures overlap.
+ *
+ * \remarks
+ * Invalid handles are set to 0.
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">k4atypes.h (include k4a/k4a.h)</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+K4A_DECLARE_HANDLE(k4a_transformation_pipeline_t);
+
 /**
  *
  * @}
@@ -462,6 +484,85 @@ typedef enum
     K4A_TRANSFORMATION_INTERPOLATION_TYPE_LINEAR,      /**< Linear interpolation */
 } k4a_transformation_interpolation_type_t;
 
+/** Transformation pipeline outputs.
+ *
+ * \remarks
+ * Values are combined into the \p outputs field of \ref k4a_transformation_pipeline_config_t to select the images
+ * produced for every capture submitted to a \ref k4a_transformation_pipeline_t.
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">k4atypes.h (include k4a/k4a.h)</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+typedef enum
+{
+    K4A_TRANSFORMATION_PIPELINE_OUTPUT_DEPTH_IN_COLOR = 0x1,    /**< Depth image in the color camera geometry, as
+                                                                   produced by
+                                                                   k4a_transformation_depth_image_to_color_camera(). */
+    K4A_TRANSFORMATION_PIPELINE_OUTPUT_COLOR_IN_DEPTH = 0x2,    /**< BGRA32 color image in the depth camera geometry, as
+                                                                   produced by
+                                                                   k4a_transformation_color_image_to_depth_camera(). */
+    K4A_TRANSFORMATION_PIPELINE_OUTPUT_POINT_CLOUD = 0x4,       /**< Point cloud of the depth image in the depth camera
+                                                                   coordinate system. */
+    K4A_TRANSFORMATION_PIPELINE_OUTPUT_COLOR_POINT_CLOUD = 0x8, /**< Point cloud of the depth image in the color camera
+                                                                   coordinate system. Implies
+                                                                   ::K4A_TRANSFORMATION_PIPELINE_OUTPUT_DEPTH_IN_COLOR.
+                                                                 */
+} k4a_transformation_pipeline_output_t;
+
+/** Transformation operations.
+ *
+ * \remarks
+ * Selects the transformation performed by a \ref k4a_transformation_request_t submitted with
+ * k4a_transformation_submit().
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">k4atypes.h (include k4a/k4a.h)</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+typedef enum
+{
+    /** As k4a_transformation_depth_image_to_color_camera(). */
+    K4A_TRANSFORMATION_OPERATION_DEPTH_IMAGE_TO_COLOR_CAMERA = 0,
+
+    /** As k4a_transformation_depth_image_to_color_camera_custom(). */
+    K4A_TRANSFORMATION_OPERATION_DEPTH_IMAGE_TO_COLOR_CAMERA_CUSTOM,
+
+    /** As k4a_transformation_color_image_to_depth_camera(). */
+    K4A_TRANSFORMATION_OPERATION_COLOR_IMAGE_TO_DEPTH_CAMERA,
+
+    /** As k4a_transformation_depth_image_to_point_cloud(). */
+    K4A_TRANSFORMATION_OPERATION_DEPTH_IMAGE_TO_POINT_CLOUD,
+
+    /** Number of operations, not a valid operation. */
+    K4A_TRANSFORMATION_OPERATION_COUNT,
+} k4a_transformation_operation_t;
+
+/** Implementations a transformation operation can run on.
+ *
+ * \remarks
+ * Reported per operation by k4a_transformation_get_tuning().
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">k4atypes.h (include k4a/k4a.h)</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+typedef enum
+{
+    K4A_TRANSFORMATION_BACKEND_CPU = 0,  /**< Portable CPU implementation. */
+    K4A_TRANSFORMATION_BACKEND_CPU_SIMD, /**< CPU implementation using SSE4.1. Only available for
+                                            ::K4A_TRANSFORMATION_OPERATION_DEPTH_IMAGE_TO_POINT_CLOUD on x86 builds. */
+    K4A_TRANSFORMATION_BACKEND_GPU,      /**< Transform engine plugin. Not available for
+                                            ::K4A_TRANSFORMATION_OPERATION_DEPTH_IMAGE_TO_POINT_CLOUD. */
+    K4A_TRANSFORMATION_BACKEND_COUNT,    /**< Number of backends, not a valid backend. */
+} k4a_transformation_backend_t;
+
 /** Color and depth sensor frame rate.
  *
  * \remarks
@@ -645,6 +746,23 @@ typedef enum
                                      */
 } k4a_wired_sync_mode_t;
 
+/** Preallocation of the frame buffers used while streaming.
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">k4atypes.h (include k4a/k4a.h)</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+typedef enum
+{
+    K4A_BUFFER_PREALLOCATION_NONE = 0,         /**< Frame buffers are allocated as frames arrive. */
+    K4A_BUFFER_PREALLOCATION_PREFAULT,         /**< Frame buffers are allocated up front, touched so that every page is
+                                                  resident, and recycled while streaming. */
+    K4A_BUFFER_PREALLOCATION_PREFAULT_AND_LOCK /**< As ::K4A_BUFFER_PREALLOCATION_PREFAULT, and the buffers are also
+                                                  locked into physical memory so they can not be paged out. */
+} k4a_buffer_preallocation_t;
+
 /** Calibration types.
  *
  * Specifies a type of calibration.
@@ -891,6 +1009,49 @@ typedef void(k4a_memory_destroy_cb_t)(void *buffer, void *context);
  */
 typedef uint8_t *(k4a_memory_allocate_cb_t)(int size, void **context);
 
+/** Callback function that produces an image of a capture the first time the image is accessed.
+ *
+ * \param context
+ * The context that was supplied by the caller as \p loader_context to \ref k4a_capture_set_color_image_loader(),
+ * \ref k4a_capture_set_depth_image_loader() or \ref k4a_capture_set_ir_image_loader().
+ *
+ * \param image_handle
+ * Location to write the new image. The capture takes ownership of the reference written here.
+ *
+ * \return
+ * ::K4A_RESULT_SUCCEEDED if \p image_handle was written. On failure the capture is left without an image.
+ *
+ * \remarks
+ * The callback is invoked at most once, while the capture is locked. It must not call any function on the capture.
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">k4atypes.h (include k4a/k4a.h)</requirement>
+ * </requirements>
+ * \endxmlonly
+ *
+ */
+typedef k4a_result_t(k4a_capture_image_load_cb_t)(void *context, k4a_image_t *image_handle);
+
+/** Callback function for an image loader that is no longer needed.
+ *
+ * \param context
+ * The context that was supplied by the caller as \p loader_context along with the \ref k4a_capture_image_load_cb_t.
+ *
+ * \remarks
+ * This callback is invoked exactly once for each loader, after the image has been loaded, or when the capture is
+ * destroyed or its image is replaced before it was ever loaded. Like the \ref k4a_capture_image_load_cb_t, it may be
+ * invoked while the capture is locked.
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">k4atypes.h (include k4a/k4a.h)</requirement>
+ * </requirements>
+ * \endxmlonly
+ *
+ */
+typedef void(k4a_capture_image_loader_release_cb_t)(void *context);
+
 /**
  *
  * @}
@@ -1205,6 +1366,311 @@ typedef struct _k4a_imu_sample_t
     uint64_t gyro_timestamp_usec; /**< Timestamp of the gyroscope in microseconds */
 } k4a_imu_sample_t;
 
+/** Image properties returned together by k4a_image_get_info().
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">k4atypes.h (include k4a/k4a.h)</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+typedef struct _k4a_image_info_t
+{
+    uint8_t *buffer;                /**< Image buffer, as returned by k4a_image_get_buffer(). */
+    size_t size;                    /**< Image buffer size in bytes. */
+    k4a_image_format_t format;      /**< Image format. */
+    int width_pixels;               /**< Image width in pixels. */
+    int height_pixels;              /**< Image height in pixels. */
+    int stride_bytes;               /**< Image stride in bytes. */
+    uint64_t device_timestamp_usec; /**< Device timestamp in microseconds. */
+    uint64_t system_timestamp_nsec; /**< System timestamp in nanoseconds. */
+    uint64_t exposure_usec;         /**< Exposure time in microseconds (color images only). */
+    uint32_t white_balance;         /**< White balance in Kelvin (color images only). */
+    uint32_t iso_speed;             /**< ISO speed (color images only). */
+} k4a_image_info_t;
+
+/** Memory usage of the SDK's frame allocations.
+ *
+ * \remarks
+ * Byte counts cover the outstanding image buffers allocated by the SDK for the entire process, including buffers held
+ * by the application.
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">k4atypes.h (include k4a/k4a.h)</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+typedef struct _k4a_memory_usage_t
+{
+    uint64_t user_bytes;               /**< Bytes held by images created by the application. */
+    uint64_t color_bytes;              /**< Bytes held by color images. */
+    uint64_t depth_bytes;              /**< Bytes held by depth and IR images. */
+    uint64_t imu_bytes;                /**< Bytes held by IMU samples. */
+    uint64_t usb_bytes;                /**< Bytes held by raw USB transfers. */
+    uint64_t total_bytes;              /**< Sum of all of the above. */
+    uint64_t peak_total_bytes;         /**< Largest value total_bytes has reached. */
+    uint64_t soft_limit_bytes;         /**< Soft limit set with k4a_set_memory_limits(), 0 if none. */
+    uint64_t hard_limit_bytes;         /**< Hard limit set with k4a_set_memory_limits(), 0 if none. */
+    uint32_t color_frames_dropped;     /**< Color frames dropped because of the memory limits. */
+    uint32_t depth_frames_dropped;     /**< Depth frames dropped because of the hard limit. */
+    uint32_t user_allocations_refused; /**< Application image allocations refused because of the hard limit. */
+} k4a_memory_usage_t;
+
+/** Time spent in each step of opening a device with k4a_device_open_multiple().
+ *
+ * \remarks
+ * Steps that run concurrently overlap, so the steps may add up to more than total_ms.
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">k4atypes.h (include k4a/k4a.h)</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+typedef struct _k4a_device_open_timing_t
+{
+    uint64_t depth_mcu_ms;   /**< Opening the depth MCU, including waiting for it to accept commands. */
+    uint64_t color_mcu_ms;   /**< Opening the color MCU, including waiting for other devices' color MCU opens. */
+    uint64_t calibration_ms; /**< Reading the calibration from the device. */
+    uint64_t depth_ms;       /**< Creating the depth module. */
+    uint64_t color_ms;       /**< Creating the color camera module. */
+    uint64_t imu_ms;         /**< Creating the IMU module. */
+    uint64_t total_ms;       /**< Opening the device from start to end. */
+} k4a_device_open_timing_t;
+
+/** Images and timing produced by a \ref k4a_transformation_pipeline_t for one capture.
+ *
+ * \remarks
+ * Image handles are 0 for outputs that were not requested or that could not be produced. Results retrieved with
+ * k4a_transformation_pipeline_get_result() must be released with k4a_transformation_pipeline_release_result().
+ *
+ * \remarks
+ * Output images are backed by buffers owned by the pipeline. A buffer is recycled for a later capture once every
+ * reference to the image using it has been released.
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">k4atypes.h (include k4a/k4a.h)</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+typedef struct _k4a_transformation_pipeline_result_t
+{
+    k4a_result_t result;              /**< ::K4A_RESULT_SUCCEEDED if every requested output was produced. */
+    k4a_capture_t capture;            /**< The capture that was submitted. */
+    k4a_image_t depth_image_in_color; /**< ::K4A_TRANSFORMATION_PIPELINE_OUTPUT_DEPTH_IN_COLOR output. */
+    k4a_image_t color_image_in_depth; /**< ::K4A_TRANSFORMATION_PIPELINE_OUTPUT_COLOR_IN_DEPTH output. */
+    k4a_image_t point_cloud;          /**< ::K4A_TRANSFORMATION_PIPELINE_OUTPUT_POINT_CLOUD output. */
+    k4a_image_t color_point_cloud;    /**< ::K4A_TRANSFORMATION_PIPELINE_OUTPUT_COLOR_POINT_CLOUD output. */
+    uint64_t queued_usec;             /**< Time the capture waited for a worker after it was submitted. */
+    uint64_t depth_to_color_usec;     /**< Time spent transforming the depth image to the color camera. */
+    uint64_t color_to_depth_usec;     /**< Time spent transforming the color image to the depth camera. */
+    uint64_t point_cloud_usec;        /**< Time spent computing point clouds. */
+    uint64_t total_usec;              /**< Time from submission until the result was delivered. */
+} k4a_transformation_pipeline_result_t;
+
+/** Callback function for a transformation pipeline result.
+ *
+ * \param context
+ * The context supplied in \ref k4a_transformation_pipeline_config_t.
+ *
+ * \param result
+ * The result for one submitted capture.
+ *
+ * \remarks
+ * The callback is called from a pipeline worker thread, in the order the captures were submitted. The pipeline
+ * releases \p result when the callback returns; call k4a_image_reference() or k4a_capture_reference() on any handle
+ * that needs to outlive the callback.
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">k4atypes.h (include k4a/k4a.h)</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+typedef void(k4a_transformation_pipeline_result_cb_t)(void *context,
+                                                      const k4a_transformation_pipeline_result_t *result);
+
+/** Configuration parameters for a transformation pipeline.
+ *
+ * \remarks
+ * Used by k4a_transformation_pipeline_create().
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">k4atypes.h (include k4a/k4a.h)</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+typedef struct _k4a_transformation_pipeline_config_t
+{
+    /** Combination of \ref k4a_transformation_pipeline_output_t values selecting the images to produce. */
+    uint32_t outputs;
+
+    /** Maximum number of captures that may be in the pipeline at once, 0 for the default.
+     *
+     * A capture stays in flight until its output images have all been released, which bounds the memory used by the
+     * pipeline and makes k4a_transformation_pipeline_submit() block when the application falls behind. */
+    uint32_t max_in_flight;
+
+    /** Called with every result. When NULL, results are retrieved with k4a_transformation_pipeline_get_result(). */
+    k4a_transformation_pipeline_result_cb_t *callback;
+
+    /** Context passed to \p callback. */
+    void *callback_context;
+} k4a_transformation_pipeline_config_t;
+
+/** Identifies a request submitted with k4a_transformation_submit().
+ *
+ * \remarks
+ * Tickets are unique for the lifetime of a \ref k4a_transformation_t. A ticket of 0 is never issued.
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">k4atypes.h (include k4a/k4a.h)</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+typedef uint64_t k4a_transformation_ticket_t;
+
+/** Callback function for a completed transformation request.
+ *
+ * \param context
+ * The \p callback_context of the request.
+ *
+ * \param ticket
+ * The ticket returned when the request was submitted.
+ *
+ * \param result
+ * ::K4A_RESULT_SUCCEEDED if the output images were written.
+ *
+ * \remarks
+ * The callback is called from a transformation worker thread. The request's images have been released by the
+ * transformation by the time it is called.
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">k4atypes.h (include k4a/k4a.h)</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+typedef void(k4a_transformation_complete_cb_t)(void *context, k4a_transformation_ticket_t ticket, k4a_result_t result);
+
+/** An asynchronous transformation request.
+ *
+ * \remarks
+ * Used by k4a_transformation_submit(). The images have the same requirements as for the synchronous function named by
+ * \p operation. Images that \p operation does not use should be 0.
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">k4atypes.h (include k4a/k4a.h)</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+typedef struct _k4a_transformation_request_t
+{
+    k4a_transformation_operation_t operation; /**< Transformation to perform. */
+    k4a_image_t depth_image;                  /**< Input depth image, used by every operation. */
+    k4a_image_t color_image;                  /**< Input BGRA32 color image for
+                                                 ::K4A_TRANSFORMATION_OPERATION_COLOR_IMAGE_TO_DEPTH_CAMERA. */
+    k4a_image_t custom_image;                 /**< Input custom image for
+                                                 ::K4A_TRANSFORMATION_OPERATION_DEPTH_IMAGE_TO_COLOR_CAMERA_CUSTOM. */
+    k4a_image_t transformed_image;            /**< Output depth, color or point cloud image. */
+    k4a_image_t transformed_custom_image;     /**< Output custom image for
+                                                 ::K4A_TRANSFORMATION_OPERATION_DEPTH_IMAGE_TO_COLOR_CAMERA_CUSTOM. */
+    k4a_calibration_type_t camera; /**< Camera of \p depth_image for
+                                      ::K4A_TRANSFORMATION_OPERATION_DEPTH_IMAGE_TO_POINT_CLOUD. */
+    k4a_transformation_interpolation_type_t interpolation_type; /**< Interpolation of the custom image. */
+    uint32_t invalid_custom_value;                              /**< Invalid value of the custom image. */
+
+    /** Called when the request completes. When NULL, the result is retrieved with k4a_transformation_wait(). */
+    k4a_transformation_complete_cb_t *callback;
+
+    /** Context passed to \p callback. */
+    void *callback_context;
+} k4a_transformation_request_t;
+
+/** A custom image transformed along with a depth image.
+ *
+ * \remarks
+ * Used by k4a_transformation_depth_image_to_color_camera_custom_channels(). The images have the same requirements as
+ * \p custom_image and \p transformed_custom_image of k4a_transformation_depth_image_to_color_camera_custom().
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">k4atypes.h (include k4a/k4a.h)</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+typedef struct _k4a_transformation_custom_channel_t
+{
+    k4a_image_t custom_image;                                   /**< Custom8 or custom16 image in the depth camera. */
+    k4a_image_t transformed_custom_image;                       /**< Output image in the color camera, of the same
+                                                                   format as \p custom_image. */
+    k4a_transformation_interpolation_type_t interpolation_type; /**< Interpolation of this channel. */
+    uint32_t invalid_custom_value;                              /**< Value of pixels that no depth pixel maps to. */
+} k4a_transformation_custom_channel_t;
+
+/** Backend selection of a transformation handle.
+ *
+ * \remarks
+ * Filled in by k4a_transformation_get_tuning().
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">k4atypes.h (include k4a/k4a.h)</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+typedef struct _k4a_transformation_tuning_t
+{
+    /** True if the handle was created with k4a_transformation_create_auto_tuned(). */
+    bool auto_tuned;
+
+    /** Backend each ::k4a_transformation_operation_t runs on. */
+    k4a_transformation_backend_t backend[K4A_TRANSFORMATION_OPERATION_COUNT];
+
+    /** Fastest measured time of each backend for each operation, in microseconds. 0 if the backend was not measured,
+     * either because it is not available for the operation or because the handle was not auto tuned. */
+    uint32_t time_usec[K4A_TRANSFORMATION_OPERATION_COUNT][K4A_TRANSFORMATION_BACKEND_COUNT];
+} k4a_transformation_tuning_t;
+
+/** Voxel grid of k4a_transformation_depth_image_to_voxel_cloud().
+ *
+ * \remarks
+ * The grid covers [\p min_bounds, \p max_bounds) in the coordinate system of the camera the depth image was captured
+ * or transformed in, with cubic voxels of \p voxel_size millimeters starting at \p min_bounds.
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">k4atypes.h (include k4a/k4a.h)</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+typedef struct _k4a_voxel_grid_t
+{
+    float voxel_size;        /**< Edge length of a voxel in millimeters. */
+    k4a_float3_t min_bounds; /**< Lowest X, Y and Z in millimeters of points kept, inclusive. */
+    k4a_float3_t max_bounds; /**< Highest X, Y and Z in millimeters of points kept, exclusive. */
+} k4a_voxel_grid_t;
+
+/** One occupied voxel of k4a_transformation_depth_image_to_voxel_cloud().
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">k4atypes.h (include k4a/k4a.h)</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+typedef struct _k4a_voxel_point_t
+{
+    k4a_float3_t position; /**< Mean position in millimeters of the points in the voxel. */
+    uint8_t bgra[4];       /**< Mean color of the points in the voxel, or 0 if no color image was given. */
+    uint32_t point_count;  /**< Number of points in the voxel. */
+} k4a_voxel_point_t;
+
 /**
  *
  * @}
@@ -1239,6 +1705,31 @@ typedef struct _k4a_imu_sample_t
  */
 #define K4A_WAIT_INFINITE (-1)
 
+/** Maximum number of custom channels that k4a_transformation_depth_image_to_color_camera_custom_channels() transforms
+ * in one call.
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">k4atypes.h (include k4a/k4a.h)</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+#define K4A_TRANSFORMATION_MAX_CUSTOM_CHANNELS (8)
+
+/** Default depth discontinuity ratio of k4a_transformation_depth_image_to_mesh().
+ *
+ * \remarks
+ * The same threshold that k4a_transformation_depth_image_to_color_camera() uses to avoid interpolating across depth
+ * discontinuities. It keeps surfaces slanted up to about 85 degrees at the depth camera's angular resolution.
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">k4atypes.h (include k4a/k4a.h)</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+#define K4A_TRANSFORMATION_MESH_DEFAULT_DISCONTINUITY_RATIO (0.04693441759f)
+
 /** Initial configuration setting for disabling all sensors.
  *
  * \remarks
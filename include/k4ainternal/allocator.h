@@ -10,6 +10,7 @@
 #include <k4a/k4atypes.h>
 
 #include <stddef.h>
+#include <stdbool.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -33,6 +34,10 @@ typedef enum
     ALLOCATION_SOURCE_USB_IMU,   /**< Memory was allocated by the USB reader */
 } allocation_source_t;
 
+/** Largest number of buffers a pool will hold for one allocation source
+ */
+#define ALLOCATOR_POOL_MAX_BUFFERS (32)
+
 /** Initializes the globals used by the allocator
  *
  */
@@ -101,6 +106,102 @@ uint8_t *allocator_alloc(allocation_source_t source, size_t alloc_size);
  */
 void allocator_free(void *buffer);
 
+/** Sets the memory limits applied to outstanding allocations
+ *
+ * \param soft_limit_bytes
+ * Once outstanding allocations reach this many bytes, new color frames are dropped. 0 disables the limit.
+ *
+ * \param hard_limit_bytes
+ * Once outstanding allocations reach this many bytes, new depth frames are also dropped and user allocations fail.
+ * 0 disables the limit.
+ *
+ * \return ::K4A_RESULT_FAILED if \p soft_limit_bytes is larger than a non-zero \p hard_limit_bytes.
+ */
+k4a_result_t allocator_set_memory_limits(size_t soft_limit_bytes, size_t hard_limit_bytes);
+
+/** Reads the current byte accounting, limits, and drop counters
+ *
+ * \param usage
+ * Location to write the memory usage to
+ */
+void allocator_get_memory_usage(k4a_memory_usage_t *usage);
+
+/** Checks whether a streaming frame should be dropped rather than allocated
+ *
+ * \param source
+ * The source that is about to allocate
+ *
+ * \param alloc_size
+ * The size of the allocation that is about to be made
+ *
+ * \return true if the frame should be dropped to stay within the memory limits. The drop is counted in the memory
+ * usage reported by allocator_get_memory_usage().
+ *
+ * \remarks
+ * Streaming readers call this before allocator_alloc() so that running out of budget drops a frame instead of
+ * failing the stream. Color is dropped at the soft limit and depth at the hard limit; other sources are never
+ * dropped.
+ */
+bool allocator_should_drop(allocation_source_t source, size_t alloc_size);
+
+/** Sets aside prefaulted buffers for an allocation source
+ *
+ * \param source
+ * The allocation source the buffers are used for
+ *
+ * \param buffer_size
+ * Size of each buffer. Allocations from \p source up to this size are served from the pool. Pass 0 if the size is not
+ * known yet; the pool then serves no allocations until the stream sizes it with allocator_pool_prepare().
+ *
+ * \param buffer_count
+ * Number of buffers to set aside, up to ::ALLOCATOR_POOL_MAX_BUFFERS
+ *
+ * \param lock_memory
+ * Lock the buffers into physical memory
+ *
+ * \return ::K4A_RESULT_FAILED if the buffers could not be allocated or locked.
+ *
+ * \remarks
+ * Every page of a pool buffer is written when it is created, and buffers are recycled by allocator_free() instead of
+ * being freed, so allocations served by the pool don't take page faults. Allocations that don't fit, or that happen
+ * while every pool buffer is in use, fall back to the regular allocator.
+ *
+ * \remarks
+ * Each call must be matched by allocator_pool_disable(). Calls for a source that already has a pool share it; the
+ * pool grows by \p buffer_count and keeps its original buffer size.
+ */
+k4a_result_t allocator_pool_enable(allocation_source_t source,
+                                   size_t buffer_size,
+                                   uint32_t buffer_count,
+                                   bool lock_memory);
+
+/** Sizes and fills a pool that was enabled before its buffer size was known
+ *
+ * \param source
+ * The allocation source the buffers are used for
+ *
+ * \param buffer_size
+ * Size of each buffer
+ *
+ * \return ::K4A_RESULT_FAILED if the buffers could not be allocated or locked. ::K4A_RESULT_SUCCEEDED if they were, or
+ * if no pool is enabled for \p source.
+ *
+ * \remarks
+ * Streams call this while starting, once they know their frame size, so that allocation and locking failures fail the
+ * start. The streaming path never allocates pool buffers. A pool that already has a buffer size keeps it.
+ */
+k4a_result_t allocator_pool_prepare(allocation_source_t source, size_t buffer_size);
+
+/** Releases the pool set aside by allocator_pool_enable()
+ *
+ * \param source
+ * The allocation source to release the pool for
+ *
+ * \remarks
+ * Buffers that are still in use are released once they are freed.
+ */
+void allocator_pool_disable(allocation_source_t source);
+
 /** Verifies there are no outstanding allocations
  *
  * \remarks
@@ -90,6 +90,34 @@ typedef struct _k4a_calibration_imu_t
  */
 k4a_result_t calibration_create(depthmcu_t depthmcu, calibration_t *calibration_handle);
 
+/** Sets the directory of the calibration cache
+ *
+ * \param directory
+ * Directory to store the calibration of each device in, or NULL to use the K4A_CALIBRATION_CACHE_DIR environment
+ * variable. The cache is disabled if neither is set.
+ *
+ * \remarks
+ * When the cache is enabled, \ref calibration_create reads the firmware versions and loads the calibration from the
+ * cache file of the device's serial number if the versions match. Otherwise it reads the calibration from the device
+ * and updates the file.
+ *
+ * \return K4A_RESULT_SUCCEEDED is returned on success, otherwise K4A_RESULT_FAILED is returned
+ */
+k4a_result_t calibration_set_cache_directory(const char *directory);
+
+/** Gets the firmware versions read by \ref calibration_create
+ *
+ * \param calibration_handle
+ * The calibration handle
+ *
+ * \param firmware_versions
+ * Location to write the firmware versions to
+ *
+ * \return K4A_RESULT_SUCCEEDED if the versions were read, which only happens when the calibration cache is enabled.
+ */
+k4a_result_t calibration_get_firmware_versions(calibration_t calibration_handle,
+                                               depthmcu_firmware_versions_t *firmware_versions);
+
 /** Creates an calibration instance
  *
  * \param raw_calibration
@@ -53,6 +53,18 @@ void capture_set_color_image(k4a_capture_t capture_handle, k4a_image_t image_han
 void capture_set_depth_image(k4a_capture_t capture_handle, k4a_image_t image_handle);
 void capture_set_imu_image(k4a_capture_t capture_handle, k4a_image_t image_handle);
 void capture_set_ir_image(k4a_capture_t capture_handle, k4a_image_t image_handle);
+k4a_result_t capture_set_color_image_loader(k4a_capture_t capture_handle,
+                                            k4a_capture_image_load_cb_t *load_cb,
+                                            k4a_capture_image_loader_release_cb_t *release_cb,
+                                            void *loader_context);
+k4a_result_t capture_set_depth_image_loader(k4a_capture_t capture_handle,
+                                            k4a_capture_image_load_cb_t *load_cb,
+                                            k4a_capture_image_loader_release_cb_t *release_cb,
+                                            void *loader_context);
+k4a_result_t capture_set_ir_image_loader(k4a_capture_t capture_handle,
+                                         k4a_capture_image_load_cb_t *load_cb,
+                                         k4a_capture_image_loader_release_cb_t *release_cb,
+                                         void *loader_context);
 void capture_set_temperature_c(k4a_capture_t capture_handle, float temperature_c);
 float capture_get_temperature_c(k4a_capture_t capture_handle);
 
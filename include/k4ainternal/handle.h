@@ -17,6 +17,13 @@ extern "C" {
 
 #define IF_LOGGER(x) x
 
+#ifdef K4A_FAST_HANDLE_VALIDATION
+#define LOG_INVALID_HANDLE(_type_name_, _handle_)                                                                      \
+    logger_log_invalid_handle(__FILE__, __LINE__, __func__, _type_name_, "handle", _handle_)
+#else
+#define LOG_INVALID_HANDLE(_type_name_, _handle_) LOG_ERROR("Invalid " _type_name_ " %p", _handle_)
+#endif
+
 #ifdef _WIN32
 #define KSELECTANY __declspec(selectany)
 #else
@@ -71,10 +78,10 @@ used with CPP and destroy being used with C, or vise-vesa, the types get c or cp
     /* Define "context_t* handle_t_get_context(handle_t handle)" function */                                           \
     static inline _internal_context_type_ *_public_handle_name_##_get_context(_public_handle_name_ handle)             \
     {                                                                                                                  \
-        if ((handle == NULL) ||                                                                                        \
-            ((PUB_HANDLE_TYPE(_public_handle_name_) *)handle)->handleType != PRIV_HANDLE_TYPE(_public_handle_name_))   \
+        if (K4A_UNLIKELY((handle == NULL) || ((PUB_HANDLE_TYPE(_public_handle_name_) *)handle)->handleType !=       \
+                                                    PRIV_HANDLE_TYPE(_public_handle_name_)))                           \
         {                                                                                                              \
-            IF_LOGGER(LOG_ERROR("Invalid " #_public_handle_name_ " %p", handle);)                                      \
+            IF_LOGGER(LOG_INVALID_HANDLE(#_public_handle_name_, handle);)                                              \
             return NULL;                                                                                               \
         }                                                                                                              \
         return &(((PUB_HANDLE_TYPE(_public_handle_name_) *)handle)->context);                                          \
@@ -97,6 +97,45 @@ k4a_result_t image_create_from_buffer(k4a_image_format_t format,
                                       void *buffer_destroy_cb_context,
                                       k4a_image_t *image_handle);
 
+/** Create a handle to an image object that views a region of another image's buffer.
+ *
+ * \param parent_handle [IN]
+ * image whose buffer the view will reference
+ *
+ * \param format [IN]
+ * format of the view
+ *
+ * \param width_pixels [IN]
+ * width of the view
+ *
+ * \param height_pixels [IN]
+ * height of the view
+ *
+ * \param stride_bytes [IN]
+ * stride of the view, 0 to use the stride of the parent
+ *
+ * \param offset_bytes [IN]
+ * offset in bytes of the first pixel of the view from the start of the parent's buffer
+ *
+ * \param view_handle [OUT]
+ * location to store the handle of the view
+ *
+ * \return K4A_RESULT_SUCCEEDED if the view was created
+ *
+ * The view does not copy any data. It holds a reference on the parent for as long as the view exists, so the parent's
+ * buffer stays valid even if the caller releases the parent first. Timestamps and metadata are copied from the parent
+ * when the view is created.
+ *
+ * When done with the view, close the handle with \ref image_dec_ref
+ */
+k4a_result_t image_create_view(k4a_image_t parent_handle,
+                               k4a_image_format_t format,
+                               int width_pixels,
+                               int height_pixels,
+                               int stride_bytes,
+                               size_t offset_bytes,
+                               k4a_image_t *view_handle);
+
 /** Removes one reference on image_t, free's when it hits zero
  *
  * \param image_handle [IN]
@@ -123,6 +162,7 @@ uint64_t image_get_system_timestamp_nsec(k4a_image_t image_handle);
 uint64_t image_get_exposure_usec(k4a_image_t image_handle);
 uint32_t image_get_white_balance(k4a_image_t image_handle);
 uint32_t image_get_iso_speed(k4a_image_t image_handle);
+k4a_result_t image_get_info(k4a_image_t image_handle, k4a_image_info_t *info);
 void image_set_device_timestamp_usec(k4a_image_t image_handle, uint64_t timestamp_usec);
 void image_set_system_timestamp_nsec(k4a_image_t image_handle, uint64_t timestamp_nsec);
 k4a_result_t image_apply_system_timestamp(k4a_image_t image_handle);
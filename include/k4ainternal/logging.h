@@ -59,6 +59,32 @@ k4a_result_t logger_register_message_callback(k4a_logging_message_cb_t *message_
 
 void logger_log(k4a_log_level_t level, const char *file, const int line, const char *format, ...);
 
+#if defined(__GNUC__) || defined(__clang__)
+#define K4A_COLD __attribute__((cold, noinline))
+#define K4A_UNLIKELY(_expression_) __builtin_expect(!!(_expression_), 0)
+#elif defined(_MSC_VER)
+#define K4A_COLD __declspec(noinline)
+#define K4A_UNLIKELY(_expression_) (_expression_)
+#else
+#define K4A_COLD
+#define K4A_UNLIKELY(_expression_) (_expression_)
+#endif
+
+// Release builds validate handles inline and report failures from a cold out of line function, so that a valid handle
+// only costs a compare and a predicted branch. Define K4A_DISABLE_FAST_HANDLE_VALIDATION to trace validation inline
+// at every call site instead.
+#if defined(NDEBUG) && !defined(K4A_DISABLE_FAST_HANDLE_VALIDATION)
+#define K4A_FAST_HANDLE_VALIDATION
+#endif
+
+// Logs the use of an invalid handle
+K4A_COLD void logger_log_invalid_handle(const char *szFile,
+                                        int line,
+                                        const char *szFunction,
+                                        const char *szHandleType,
+                                        const char *szExpression,
+                                        void *pHandleValue);
+
 FORCEINLINE k4a_result_t
 TraceError(k4a_result_t result, const char *szCall, const char *szFile, int line, const char *szFunction)
 {
@@ -192,6 +218,14 @@ FORCEINLINE void TraceInvalidHandle(int result,
         TraceArg(1, __FILE__, __LINE__, __func__, #_expression_);                                                      \
     }
 
+#ifdef K4A_FAST_HANDLE_VALIDATION
+#define RETURN_VALUE_IF_HANDLE_INVALID(_fail_value_, _type_, _handle_)                                                 \
+    if (K4A_UNLIKELY(NULL == _type_##_get_context(_handle_)))                                                          \
+    {                                                                                                                  \
+        logger_log_invalid_handle(__FILE__, __LINE__, __func__, #_type_, #_handle_, _handle_);                         \
+        return _fail_value_;                                                                                           \
+    }
+#else
 #define RETURN_VALUE_IF_HANDLE_INVALID(_fail_value_, _type_, _handle_)                                                 \
     if ((NULL == _type_##_get_context(_handle_)))                                                                      \
     {                                                                                                                  \
@@ -202,6 +236,7 @@ FORCEINLINE void TraceInvalidHandle(int result,
     {                                                                                                                  \
         TraceInvalidHandle(1, __FILE__, __LINE__, __func__, #_type_, #_handle_, _handle_);                             \
     }
+#endif
 
 // Logs a message
 #define LOG_TRACE(message, ...)                                                                                        \
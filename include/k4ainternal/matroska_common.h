@@ -82,7 +82,8 @@ constexpr uint64_t operator"" _s(unsigned long long x)
 #endif
 
 #ifndef CLUSTER_WRITE_QUEUE_WARNING_NS
-// If a cluster is in the qeuue too long, warn about disk write speed.
+// If a cluster is in the queue too long, warn about disk write speed. Recordings with a write delay longer than
+// CLUSTER_WRITE_DELAY_NS extend this by the difference, see matroska_writer_thread().
 #define CLUSTER_WRITE_QUEUE_WARNING_NS CLUSTER_WRITE_DELAY_NS + 2_s
 #endif
 
@@ -94,6 +95,27 @@ constexpr uint64_t operator"" _s(unsigned long long x)
 #define CLUSTER_READ_AHEAD_COUNT 2
 #endif
 
+// Defaults for k4a_record_preview_settings_t
+#ifndef PREVIEW_WIDTH
+#define PREVIEW_WIDTH 320
+#endif
+
+#ifndef PREVIEW_HEIGHT
+#define PREVIEW_HEIGHT 180
+#endif
+
+#ifndef PREVIEW_INTERVAL_NS
+#define PREVIEW_INTERVAL_NS 1_s
+#endif
+
+#ifndef PREVIEW_JPEG_QUALITY
+#define PREVIEW_JPEG_QUALITY 75
+#endif
+
+#ifndef PREVIEW_MAX_CPU_PERCENT
+#define PREVIEW_MAX_CPU_PERCENT 5
+#endif
+
 static_assert(MAX_CLUSTER_LENGTH_NS < INT16_MAX * MATROSKA_TIMESCALE_NS, "Cluster length must fit in a 16 bit int");
 static_assert(CLUSTER_WRITE_DELAY_NS >= MAX_CLUSTER_LENGTH_NS * 2, "Cluster write delay is shorter than 2 clusters");
 
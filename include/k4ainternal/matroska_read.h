@@ -13,6 +13,8 @@
 #include <mutex>
 #include <future>
 #include <map>
+#include <atomic>
+#include <chrono>
 
 namespace k4arecord
 {
@@ -53,6 +55,10 @@ typedef struct _loaded_cluster_t
     future_cluster_t previous_clusters[CLUSTER_READ_AHEAD_COUNT];
     future_cluster_t next_clusters[CLUSTER_READ_AHEAD_COUNT];
 #endif
+
+    // Element indices of the blocks in the cluster for each track number, in file order. Built by next_block() the
+    // first time a track is read from the cluster, and searched from either end depending on the read direction.
+    std::map<uint64_t, std::vector<int>> block_index;
 } loaded_cluster_t;
 
 typedef struct _block_info_t
@@ -90,6 +96,54 @@ typedef struct _track_reader_t
     k4a_image_format_t format = K4A_IMAGE_FORMAT_CUSTOM;
 } track_reader_t;
 
+// The number of released data block handles kept for reuse by each playback handle.
+#ifndef DATA_BLOCK_POOL_SIZE
+#define DATA_BLOCK_POOL_SIZE 8
+#endif
+
+// Released data block handles that get_data_block() can reuse instead of allocating new ones. The pool is shared with
+// every outstanding data block so that blocks released after k4a_playback_close() can still find it.
+typedef struct _data_block_pool_t
+{
+    std::mutex lock; // Locks access to free_blocks and closed
+    std::vector<k4a_playback_data_block_t> free_blocks;
+    bool closed = false; // Set by k4a_playback_close(), released blocks are destroyed from then on
+} data_block_pool_t;
+
+// Counts the capture images converted from their blocks, and the lazily loaded images that were never accessed.
+// Shared with every lazily loaded image so that captures released after k4a_playback_close() can still update it.
+typedef struct _image_load_stats_t
+{
+    std::atomic<uint64_t> converted_count;
+    std::atomic<uint64_t> convert_time_ns;
+    std::atomic<uint64_t> skipped_count;
+} image_load_stats_t;
+
+// A video track block along with what is needed to convert it to an image. Lazily loaded capture images hold on to one
+// until the capture is first asked for the image, keeping the cluster of the block loaded until then.
+typedef struct _image_block_t
+{
+    std::shared_ptr<libmatroska::KaxCluster> cluster; // Only set for lazily loaded images
+    libmatroska::KaxInternalBlock *block = NULL;
+
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t stride = 0;
+    k4a_image_format_t format = K4A_IMAGE_FORMAT_CUSTOM; // The format of the block data
+    k4a_image_format_t target_format = K4A_IMAGE_FORMAT_CUSTOM;
+    uint64_t device_timestamp_usec = 0;
+
+    bool loaded = false; // Set once a lazily loaded image has been converted
+    std::shared_ptr<image_load_stats_t> stats;
+} image_block_t;
+
+// Statistics read from the cluster and block headers of a recording by scan_recording().
+typedef struct _recording_scan_t
+{
+    k4a_playback_statistics_t statistics = {};
+    std::map<std::string, k4a_playback_track_statistics_t> tracks; // Indexed by track name
+} recording_scan_t;
+
 typedef struct _k4a_playback_context_t
 {
     const char *file_path;
@@ -100,6 +154,10 @@ typedef struct _k4a_playback_context_t
     uint64_t timecode_scale;
     k4a_record_configuration_t record_config;
     k4a_image_format_t color_format_conversion;
+    bool data_block_zero_copy; // Data blocks reference the loaded cluster instead of copying the block data
+    bool lazy_images;          // Capture images are converted from their blocks on first access
+
+    std::shared_ptr<data_block_pool_t> data_block_pool;
 
     std::unique_ptr<libebml::EbmlStream> stream;
     std::unique_ptr<libmatroska::KaxSegment> segment;
@@ -116,6 +174,7 @@ typedef struct _k4a_playback_context_t
     uint64_t sync_period_ns;
     uint64_t seek_timestamp_ns;
     std::shared_ptr<loaded_cluster_t> seek_cluster;
+    bool reverse_reads; // True if the most recent read was a previous capture, IMU sample or data block
 
     cluster_cache_t cluster_cache;
     std::recursive_mutex cache_lock; // Locks modification of cluster_cache
@@ -136,16 +195,44 @@ typedef struct _k4a_playback_context_t
 
     uint64_t last_file_timestamp_ns; // Relative to start of file.
 
+    std::unique_ptr<recording_scan_t> scan; // Set by the first call to scan_recording()
+    std::mutex scan_lock;                   // Locks access to scan, held for the whole scan
+
+    k4a_playback_open_timing_t open_timing;
+
     // Stats
     uint64_t seek_count, load_count, cache_hits;
+    std::shared_ptr<image_load_stats_t> image_stats;
 } k4a_playback_context_t;
 
 K4A_DECLARE_CONTEXT(k4a_playback_t, k4a_playback_context_t);
 
+// Returns the number of microseconds elapsed since start.
+inline uint64_t elapsed_usec(std::chrono::steady_clock::time_point start)
+{
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+}
+
 typedef struct _k4a_playback_data_block_context_t
 {
     uint64_t device_timestamp_usec;
+    uint8_t *buffer;
+    size_t buffer_size;
+
+    // Owns the buffer when the block data is copied. The capacity is kept while the handle is pooled so that reused
+    // handles do not need to allocate again.
     std::vector<uint8_t> data_block;
+
+    // Keeps the cluster the buffer points into loaded when the block data is not copied.
+    std::shared_ptr<libmatroska::KaxCluster> cluster;
+
+    // The pool the handle is returned to when released, nullptr while the handle is in the pool.
+    std::shared_ptr<data_block_pool_t> pool;
+
+    // Set while the handle is in the pool. A released handle must not be used or released again until get_data_block()
+    // hands it out again.
+    bool in_pool = false;
 } k4a_playback_data_block_context_t;
 
 K4A_DECLARE_CONTEXT(k4a_playback_data_block_t, k4a_playback_data_block_context_t);
@@ -200,6 +287,13 @@ k4a_stream_result_t get_data_block(k4a_playback_context_t *context,
                                    track_reader_t *track_reader,
                                    k4a_playback_data_block_t *data_block_handle,
                                    bool next);
+void release_data_block(k4a_playback_data_block_t data_block_handle);
+void close_data_block_pool(k4a_playback_context_t *context);
+k4a_result_t get_recording_statistics(k4a_playback_context_t *context, k4a_playback_statistics_t *statistics);
+k4a_result_t get_track_statistics(k4a_playback_context_t *context,
+                                  const std::string &track_name,
+                                  k4a_playback_track_statistics_t *statistics);
+k4a_result_t trim_recording(k4a_playback_context_t *context, const char *path, uint64_t start_ns, uint64_t end_ns);
 
 // Template helper functions
 template<typename T> T *read_element(k4a_playback_context_t *context, EbmlElement *element)
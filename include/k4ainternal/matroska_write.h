@@ -10,6 +10,7 @@
 
 #include <k4ainternal/matroska_common.h>
 #include <set>
+#include <chrono>
 #include <condition_variable>
 #include <mutex>
 #include <unordered_map>
@@ -46,6 +47,33 @@ typedef struct _cluster_t
     std::vector<std::pair<uint64_t, track_data_t>> data;
 } cluster_t;
 
+typedef struct _preview_writer_t
+{
+    track_header_t *track;
+
+    // Set from k4a_record_preview_settings_t, or the defaults in matroska_common.h.
+    uint32_t width, height; // The size of each image in a preview frame
+    uint32_t image_count;   // Color and depth images are placed side by side
+    uint64_t interval_ns;
+    int jpeg_quality;
+    uint32_t max_cpu_percent;
+
+    /**
+     * Captures are only handed to the preview thread if their timestamp is at least next_timestamp_ns, and the current
+     * time is after next_encode_time. next_encode_time is max() while a capture is pending or being encoded, and the
+     * preview thread pushes it back after each frame so that it stays within max_cpu_percent.
+     */
+    std::mutex lock; // Locks next_timestamp_ns, next_encode_time, pending_capture, pending_timestamp_ns and stopping
+    uint64_t next_timestamp_ns;
+    std::chrono::steady_clock::time_point next_encode_time;
+    k4a_capture_t pending_capture;
+    uint64_t pending_timestamp_ns;
+
+    bool stopping;
+    std::thread thread;
+    std::condition_variable notify;
+} preview_writer_t;
+
 typedef struct _k4a_record_context_t
 {
     const char *file_path;
@@ -54,6 +82,11 @@ typedef struct _k4a_record_context_t
     uint64_t timecode_scale;
     uint32_t camera_fps;
 
+    // Set from k4a_record_settings_t, or the defaults in matroska_common.h.
+    uint64_t cluster_length_ns;
+    uint64_t cue_entry_gap_ns;
+    uint64_t cluster_write_delay_ns;
+
     k4a_device_configuration_t device_config;
 
     /**
@@ -98,6 +131,9 @@ typedef struct _k4a_record_context_t
     std::unique_ptr<std::condition_variable> writer_notify;
     std::mutex writer_lock;
 
+    // Only set if k4a_record_add_preview_track() was called.
+    std::unique_ptr<preview_writer_t> preview;
+
     bool header_written, first_cluster_written;
 } k4a_record_context_t;
 
@@ -140,6 +176,13 @@ k4a_result_t start_matroska_writer_thread(k4a_record_context_t *context);
 
 void stop_matroska_writer_thread(k4a_record_context_t *context);
 
+k4a_result_t start_preview_writer_thread(k4a_record_context_t *context);
+
+// Encodes any capture still waiting for the preview thread before stopping it.
+void stop_preview_writer_thread(k4a_record_context_t *context);
+
+void queue_preview_capture(k4a_record_context_t *context, k4a_capture_t capture);
+
 libmatroska::KaxTag *add_tag(k4a_record_context_t *context,
                              const char *name,
                              const char *value,
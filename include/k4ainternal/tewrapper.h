@@ -24,6 +24,24 @@ extern "C" {
  */
 K4A_DECLARE_HANDLE(tewrapper_t);
 
+/** Maximum number of frames queued to the transform engine thread.
+ *
+ * \ref tewrapper_submit_frame blocks while this many frames are waiting to be processed.
+ */
+#define TEWRAPPER_MAX_QUEUED_FRAMES (32)
+
+/** Called by \ref tewrapper_submit_frame when a frame has been processed.
+ *
+ * \param context [IN]
+ * The callback_context passed to \ref tewrapper_submit_frame.
+ *
+ * \param result [IN]
+ * K4A_RESULT_SUCCEEDED if the transformed images were written.
+ *
+ * Called from the transform engine thread. Frames queued before \ref tewrapper_destroy are processed before it returns.
+ */
+typedef void(tewrapper_complete_cb_t)(void *context, k4a_result_t result);
+
 tewrapper_t tewrapper_create(k4a_transform_engine_calibration_t *transform_engine_calibration);
 void tewrapper_destroy(tewrapper_t tewrapper_handle);
 k4a_result_t tewrapper_process_frame(tewrapper_t tewrapper_handle,
@@ -39,6 +57,26 @@ k4a_result_t tewrapper_process_frame(tewrapper_t tewrapper_handle,
                                      k4a_transform_engine_interpolation_t interpolation,
                                      uint32_t invalid_value);
 
+/** Queue a frame to the transform engine thread without waiting for it to be processed.
+ *
+ * The image buffers must remain valid until \p callback is called. \p callback is called exactly once if this
+ * function succeeds, and never if it fails.
+ */
+k4a_result_t tewrapper_submit_frame(tewrapper_t tewrapper_handle,
+                                    k4a_transform_engine_type_t type,
+                                    const void *depth_image_data,
+                                    size_t depth_image_size,
+                                    const void *image2_data,
+                                    size_t image2_size,
+                                    void *transformed_image_data,
+                                    size_t transformed_image_size,
+                                    void *transformed_image2_data,
+                                    size_t transformed_image2_size,
+                                    k4a_transform_engine_interpolation_t interpolation,
+                                    uint32_t invalid_value,
+                                    tewrapper_complete_cb_t *callback,
+                                    void *callback_context);
+
 #ifdef __cplusplus
 }
 #endif
@@ -100,8 +100,20 @@ k4a_result_t transformation_color_2d_to_depth_2d(const k4a_calibration_t *calibr
 
 k4a_transformation_t transformation_create(const k4a_calibration_t *calibration, bool gpu_optimization);
 
+// Like transformation_create(), then times each backend per operation and routes operations to the fastest one. The
+// transform engine is only a candidate when gpu_optimization is set and the engine loads.
+k4a_transformation_t transformation_create_auto_tuned(const k4a_calibration_t *calibration, bool gpu_optimization);
+
+k4a_result_t transformation_get_tuning(k4a_transformation_t transformation_handle,
+                                       k4a_transformation_tuning_t *tuning);
+
 void transformation_destroy(k4a_transformation_t transformation_handle);
 
+k4a_result_t transformation_get_calibration(k4a_transformation_t transformation_handle, k4a_calibration_t *calibration);
+
+// Monotonic time in microseconds, used to track timeouts and stage timings
+uint64_t transformation_get_time_usec(void);
+
 k4a_buffer_result_t transformation_depth_image_to_color_camera_validate_parameters(
     const k4a_calibration_t *calibration,
     const k4a_transformation_xy_tables_t *xy_tables_depth_camera,
@@ -128,6 +140,28 @@ k4a_buffer_result_t transformation_depth_image_to_color_camera_internal(
     k4a_transformation_interpolation_type_t interpolation_type,
     uint32_t invalid_custom_value);
 
+// A custom image transformed by transformation_depth_image_to_color_camera_channels_internal()
+typedef struct _k4a_transformation_custom_plane_t
+{
+    const uint8_t *custom_image_data;
+    const k4a_transformation_image_descriptor_t *custom_image_descriptor;
+    uint8_t *transformed_custom_image_data;
+    k4a_transformation_image_descriptor_t *transformed_custom_image_descriptor;
+    k4a_transformation_interpolation_type_t interpolation_type;
+    uint32_t invalid_custom_value;
+} k4a_transformation_custom_plane_t;
+
+// Rasterizes the depth image once and interpolates every custom plane in the same pass
+k4a_buffer_result_t transformation_depth_image_to_color_camera_channels_internal(
+    const k4a_calibration_t *calibration,
+    const k4a_transformation_xy_tables_t *xy_tables_depth_camera,
+    const uint8_t *depth_image_data,
+    const k4a_transformation_image_descriptor_t *depth_image_descriptor,
+    uint8_t *transformed_depth_image_data,
+    k4a_transformation_image_descriptor_t *transformed_depth_image_descriptor,
+    const k4a_transformation_custom_plane_t *planes,
+    uint32_t plane_count);
+
 k4a_result_t transformation_depth_image_to_color_camera_custom(
     k4a_transformation_t transformation_handle,
     const uint8_t *depth_image_data,
@@ -141,6 +175,57 @@ k4a_result_t transformation_depth_image_to_color_camera_custom(
     k4a_transformation_interpolation_type_t interpolation_type,
     uint32_t invalid_custom_value);
 
+// Transforms several custom planes with one rasterization. A single plane uses the backend selected for
+// K4A_TRANSFORMATION_OPERATION_DEPTH_IMAGE_TO_COLOR_CAMERA_CUSTOM, more always run on the CPU.
+k4a_result_t transformation_depth_image_to_color_camera_channels(
+    k4a_transformation_t transformation_handle,
+    const uint8_t *depth_image_data,
+    const k4a_transformation_image_descriptor_t *depth_image_descriptor,
+    uint8_t *transformed_depth_image_data,
+    k4a_transformation_image_descriptor_t *transformed_depth_image_descriptor,
+    const k4a_transformation_custom_plane_t *planes,
+    uint32_t plane_count);
+
+// Registers an IR16 image into the color camera. transformed_depth_image_data may be NULL when the registered depth
+// image is not needed, in which case the depth map is rasterized into a scratch buffer.
+k4a_result_t transformation_ir_image_to_color_camera(
+    k4a_transformation_t transformation_handle,
+    const uint8_t *depth_image_data,
+    const k4a_transformation_image_descriptor_t *depth_image_descriptor,
+    const uint8_t *ir_image_data,
+    const k4a_transformation_image_descriptor_t *ir_image_descriptor,
+    uint8_t *transformed_ir_image_data,
+    k4a_transformation_image_descriptor_t *transformed_ir_image_descriptor,
+    uint8_t *transformed_depth_image_data,
+    k4a_transformation_image_descriptor_t *transformed_depth_image_descriptor);
+
+// Side of the square tiles that transformation_depth_image_to_color_camera_incremental() compares and redraws
+#define TRANSFORMATION_INCREMENTAL_TILE_SIZE (32)
+
+typedef struct _transformation_incremental_t transformation_incremental_t;
+
+transformation_incremental_t *transformation_incremental_create(const k4a_calibration_t *calibration);
+
+void transformation_incremental_destroy(transformation_incremental_t *incremental);
+
+// Transforms a depth image into the color camera reusing the previous frame kept in incremental. Only the output
+// tiles covered by quads of changed depth tiles are rasterized again; if more than max_changed_fraction of the depth
+// tiles changed the whole frame is rasterized. The output matches
+// transformation_depth_image_to_color_camera_internal().
+k4a_buffer_result_t transformation_depth_image_to_color_camera_incremental(
+    const k4a_calibration_t *calibration,
+    const k4a_transformation_xy_tables_t *xy_tables_depth_camera,
+    transformation_incremental_t *incremental,
+    float max_changed_fraction,
+    const uint8_t *depth_image_data,
+    const k4a_transformation_image_descriptor_t *depth_image_descriptor,
+    uint8_t *transformed_depth_image_data,
+    k4a_transformation_image_descriptor_t *transformed_depth_image_descriptor);
+
+k4a_result_t transformation_set_incremental(k4a_transformation_t transformation_handle,
+                                            bool enable,
+                                            float max_changed_fraction);
+
 k4a_buffer_result_t transformation_color_image_to_depth_camera_validate_parameters(
     const k4a_calibration_t *calibration,
     const k4a_transformation_xy_tables_t *xy_tables_depth_camera,
@@ -170,12 +255,18 @@ transformation_color_image_to_depth_camera(k4a_transformation_t transformation_h
                                            uint8_t *transformed_color_image_data,
                                            k4a_transformation_image_descriptor_t *transformed_color_image_descriptor);
 
+// True if the build includes the K4A_TRANSFORMATION_BACKEND_CPU_SIMD point cloud kernel
+bool transformation_point_cloud_simd_supported(void);
+
+// Uses the SIMD kernel when backend is K4A_TRANSFORMATION_BACKEND_CPU_SIMD and it is supported, otherwise the
+// portable one
 k4a_buffer_result_t
 transformation_depth_image_to_point_cloud_internal(k4a_transformation_xy_tables_t *xy_tables,
                                                    const uint8_t *depth_image_data,
                                                    const k4a_transformation_image_descriptor_t *depth_image_descriptor,
                                                    uint8_t *xyz_image_data,
-                                                   k4a_transformation_image_descriptor_t *xyz_image_descriptor);
+                                                   k4a_transformation_image_descriptor_t *xyz_image_descriptor,
+                                                   k4a_transformation_backend_t backend);
 
 k4a_result_t
 transformation_depth_image_to_point_cloud(k4a_transformation_t transformation_handle,
@@ -185,6 +276,72 @@ transformation_depth_image_to_point_cloud(k4a_transformation_t transformation_ha
                                           uint8_t *xyz_image_data,
                                           k4a_transformation_image_descriptor_t *xyz_image_descriptor);
 
+// Upper bound of the threads used by transformation_parallel_for()
+#define TRANSFORMATION_MAX_WORKERS (16)
+
+// Runs the range [begin, end) of the items on worker thread number worker
+typedef void(transformation_parallel_fn_t)(void *context, uint32_t worker, uint32_t begin, uint32_t end);
+
+uint32_t transformation_get_worker_count(void);
+
+// Splits count items in contiguous ranges, in increasing order of worker, and runs them on up to
+// transformation_get_worker_count() threads including the calling one. Returns once every range has run.
+k4a_result_t transformation_parallel_for(uint32_t count, transformation_parallel_fn_t *fn, void *context);
+
+// Number of indices of a mesh where every quad of the depth image has two triangles
+size_t transformation_mesh_max_index_count(const k4a_transformation_image_descriptor_t *depth_image_descriptor);
+
+// Writes three indices into the depth image per triangle. index_count holds the capacity of indices on input; if it is
+// smaller than transformation_mesh_max_index_count() it is set to that value and K4A_BUFFER_RESULT_TOO_SMALL returned.
+k4a_buffer_result_t
+transformation_depth_image_to_mesh_internal(const k4a_transformation_xy_tables_t *xy_tables,
+                                            const uint8_t *depth_image_data,
+                                            const k4a_transformation_image_descriptor_t *depth_image_descriptor,
+                                            float max_discontinuity_ratio,
+                                            uint32_t *indices,
+                                            size_t *index_count);
+
+k4a_buffer_result_t
+transformation_depth_image_to_mesh(k4a_transformation_t transformation_handle,
+                                   const uint8_t *depth_image_data,
+                                   const k4a_transformation_image_descriptor_t *depth_image_descriptor,
+                                   const k4a_calibration_type_t camera,
+                                   float max_discontinuity_ratio,
+                                   uint8_t *xyz_image_data,
+                                   k4a_transformation_image_descriptor_t *xyz_image_descriptor,
+                                   uint32_t *indices,
+                                   size_t *index_count);
+
+// Upper bound of the number of voxels in a voxel cloud: the number of pixels, or of voxels in the grid if smaller
+size_t transformation_voxel_cloud_max_point_count(const k4a_transformation_image_descriptor_t *depth_image_descriptor,
+                                                  const k4a_voxel_grid_t *grid);
+
+// color_image_data is an optional BGRA32 image matching the depth image. Points are rounded to millimeters like
+// transformation_depth_image_to_point_cloud_internal() with the same backend. point_count holds the capacity of points
+// on input; if it is smaller than transformation_voxel_cloud_max_point_count() it is set to that value and
+// K4A_BUFFER_RESULT_TOO_SMALL returned.
+k4a_buffer_result_t
+transformation_depth_image_to_voxel_cloud_internal(const k4a_transformation_xy_tables_t *xy_tables,
+                                                   const uint8_t *depth_image_data,
+                                                   const k4a_transformation_image_descriptor_t *depth_image_descriptor,
+                                                   const uint8_t *color_image_data,
+                                                   const k4a_transformation_image_descriptor_t *color_image_descriptor,
+                                                   const k4a_voxel_grid_t *grid,
+                                                   k4a_transformation_backend_t backend,
+                                                   k4a_voxel_point_t *points,
+                                                   size_t *point_count);
+
+k4a_buffer_result_t
+transformation_depth_image_to_voxel_cloud(k4a_transformation_t transformation_handle,
+                                          const uint8_t *depth_image_data,
+                                          const k4a_transformation_image_descriptor_t *depth_image_descriptor,
+                                          const uint8_t *color_image_data,
+                                          const k4a_transformation_image_descriptor_t *color_image_descriptor,
+                                          const k4a_calibration_type_t camera,
+                                          const k4a_voxel_grid_t *grid,
+                                          k4a_voxel_point_t *points,
+                                          size_t *point_count);
+
 // Mode specific calibration
 k4a_result_t
 transformation_get_mode_specific_depth_camera_calibration(const k4a_calibration_camera_t *raw_camera_calibration,
@@ -202,6 +359,35 @@ transformation_get_mode_specific_camera_calibration(const k4a_calibration_camera
                                                     k4a_calibration_camera_t *mode_specific_camera_calibration,
                                                     bool pixelized_zero_centered_output);
 
+k4a_result_t transformation_set_max_in_flight(k4a_transformation_t transformation_handle, uint32_t max_in_flight);
+
+k4a_wait_result_t transformation_submit(k4a_transformation_t transformation_handle,
+                                        const k4a_transformation_request_t *request,
+                                        int32_t timeout_in_ms,
+                                        k4a_transformation_ticket_t *ticket);
+
+k4a_wait_result_t transformation_wait(k4a_transformation_t transformation_handle,
+                                      k4a_transformation_ticket_t ticket,
+                                      int32_t timeout_in_ms,
+                                      k4a_result_t *result);
+
+// Transformation pipeline
+k4a_result_t transformation_pipeline_create(k4a_transformation_t transformation_handle,
+                                            const k4a_transformation_pipeline_config_t *config,
+                                            k4a_transformation_pipeline_t *pipeline_handle);
+
+void transformation_pipeline_destroy(k4a_transformation_pipeline_t pipeline_handle);
+
+k4a_wait_result_t transformation_pipeline_submit(k4a_transformation_pipeline_t pipeline_handle,
+                                                 k4a_capture_t capture_handle,
+                                                 int32_t timeout_in_ms);
+
+k4a_wait_result_t transformation_pipeline_get_result(k4a_transformation_pipeline_t pipeline_handle,
+                                                     k4a_transformation_pipeline_result_t *result,
+                                                     int32_t timeout_in_ms);
+
+void transformation_pipeline_release_result(k4a_transformation_pipeline_result_t *result);
+
 // Intrinsic transformations
 k4a_result_t transformation_unproject(const k4a_calibration_camera_t *camera_calibration,
                                       const float point2d[2],
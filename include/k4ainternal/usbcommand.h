@@ -54,6 +54,15 @@ K4A_DECLARE_HANDLE(usbcmd_t);
  */
 typedef void(usb_cmd_stream_cb_t)(k4a_result_t result, k4a_image_t image_handle, void *context);
 
+/** Counters of one of the threads handling libusb events for all devices.
+ */
+typedef struct _usb_cmd_event_thread_stats_t
+{
+    uint64_t events_handled;      /**< Number of returns from libusb event handling that completed at least one
+                                       streaming transfer; idle timeouts are not counted */
+    uint64_t transfers_completed; /**< Number of streaming transfers completed on the thread */
+} usb_cmd_event_thread_stats_t;
+
 //************ Declarations (Statics and globals) ***************
 
 //******************* Function Prototypes ***********************
@@ -143,8 +152,27 @@ k4a_result_t usb_cmd_stream_stop(usbcmd_t usb_handle);
 // Get the number of connected devices
 k4a_result_t usb_cmd_get_device_count(uint32_t *p_device_count);
 
+// Enumerate the bus once for several usb_cmd_create() calls; release with usb_cmd_enumeration_release()
+k4a_result_t usb_cmd_enumeration_acquire(void);
+
+void usb_cmd_enumeration_release(void);
+
 const guid_t *usb_cmd_get_container_id(usbcmd_t usbcmd_handle);
 
+/** Set the number of threads handling libusb events for all open devices.
+ *
+ * \remarks
+ * All devices share one libusb context. The count takes effect the next time that context is created, when no
+ * device is open. The K4A_LIBUSB_EVENT_THREADS environment variable overrides it.
+ */
+k4a_result_t usb_cmd_set_event_thread_count(uint32_t thread_count);
+
+// Get the number of libusb event threads currently running
+uint32_t usb_cmd_get_event_thread_count(void);
+
+// Get the counters of a running libusb event thread
+k4a_result_t usb_cmd_get_event_thread_stats(uint32_t thread_index, usb_cmd_event_thread_stats_t *stats);
+
 #ifdef __cplusplus
 } // namespace k4a
 #endif
@@ -47,6 +47,83 @@ extern "C" {
  */
 K4ARECORD_EXPORT k4a_result_t k4a_playback_open(const char *path, k4a_playback_t *playback_handle);
 
+/** Opens many existing recording files for reading at once.
+ *
+ * \param paths
+ * An array of \p path_count file paths.
+ *
+ * \param path_count
+ * The number of recordings in \p paths.
+ *
+ * \param thread_count
+ * The number of recordings opened at the same time, or 0 to use the number of processors.
+ *
+ * \param playback_handles
+ * An array of \p path_count handles. Each entry is set to the handle of the recording at the same index in \p paths,
+ * or NULL if that recording could not be opened. Caller must call k4a_playback_close() on every handle that is not
+ * NULL when finished with the recording, including when this function fails.
+ *
+ * \param calibration_indices
+ * Optional array of \p path_count entries. Each entry is set to the index of the first recording in \p paths with
+ * the same device calibration and camera modes as the recording at the same index. Recordings without a calibration,
+ * or whose calibration cannot be parsed, are given their own index. Can be NULL.
+ *
+ * \returns
+ * ::K4A_RESULT_SUCCEEDED if every recording was opened successfully. ::K4A_RESULT_FAILED otherwise.
+ *
+ * \remarks
+ * This is equivalent to calling k4a_playback_open() and then k4a_playback_get_calibration() for each recording, spread
+ * across \p thread_count threads. Recordings with identical calibration attachments, which is typical of many
+ * recordings made with the same device, only have their calibration parsed once. Applications building calibration
+ * dependent data such as a k4a_transformation_t can use \p calibration_indices to build it once per calibration.
+ *
+ * \remarks
+ * The time spent in each phase of opening a recording is returned by k4a_playback_get_open_timing().
+ *
+ * \relates k4a_playback_t
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">playback.h (include k4arecord/playback.h)</requirement>
+ *   <requirement name="Library">k4arecord.lib</requirement>
+ *   <requirement name="DLL">k4arecord.dll</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+K4ARECORD_EXPORT k4a_result_t k4a_playback_open_multiple(const char *const *paths,
+                                                         size_t path_count,
+                                                         uint32_t thread_count,
+                                                         k4a_playback_t *playback_handles,
+                                                         size_t *calibration_indices);
+
+/** Get the time spent in each phase of opening a recording.
+ *
+ * \param playback_handle
+ * Handle obtained by k4a_playback_open() or k4a_playback_open_multiple().
+ *
+ * \param timing
+ * Location to write the timing.
+ *
+ * \returns
+ * ::K4A_RESULT_SUCCEEDED if \p timing was written. ::K4A_RESULT_FAILED otherwise.
+ *
+ * \remarks
+ * The calibration is parsed the first time it is needed, so k4a_playback_open_timing_t::calibration_usec is only set
+ * after a call to k4a_playback_get_calibration(), or when the recording was opened by k4a_playback_open_multiple().
+ *
+ * \relates k4a_playback_t
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">playback.h (include k4arecord/playback.h)</requirement>
+ *   <requirement name="Library">k4arecord.lib</requirement>
+ *   <requirement name="DLL">k4arecord.dll</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+K4ARECORD_EXPORT k4a_result_t k4a_playback_get_open_timing(k4a_playback_t playback_handle,
+                                                           k4a_playback_open_timing_t *timing);
+
 /** Get the raw calibration blob for the Azure Kinect device used during recording.
  *
  * \param playback_handle
@@ -406,6 +483,81 @@ K4ARECORD_EXPORT k4a_buffer_result_t k4a_playback_get_tag(k4a_playback_t playbac
 K4ARECORD_EXPORT k4a_result_t k4a_playback_set_color_conversion(k4a_playback_t playback_handle,
                                                                 k4a_image_format_t target_format);
 
+/** Set whether data blocks reference the recording's memory instead of copying it.
+ *
+ * \param playback_handle
+ * Handle obtained by k4a_playback_open().
+ *
+ * \param enable
+ * If true, data blocks returned by k4a_playback_get_next_data_block() and k4a_playback_get_previous_data_block() point
+ * directly into the loaded recording data. If false, the default, each data block holds its own copy of the data.
+ *
+ * \returns
+ * ::K4A_RESULT_SUCCEEDED if the mode was set. ::K4A_RESULT_FAILED otherwise.
+ *
+ * \remarks
+ * Without the copy, reading a data block no longer scales with the size of its data, which matters for custom tracks
+ * storing large payloads with every frame. Each data block keeps the part of the recording it was read from loaded in
+ * memory until k4a_playback_data_block_release() is called, so holding onto many data blocks from different parts of
+ * the recording increases memory use.
+ *
+ * \remarks
+ * In this mode the buffer returned by k4a_playback_data_block_get_buffer() is shared with the playback handle and other
+ * data blocks of the same frame, and must not be modified.
+ *
+ * \remarks
+ * The mode applies to data blocks read after this call. Data blocks already returned are not affected.
+ *
+ * \relates k4a_playback_t
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">playback.h (include k4arecord/playback.h)</requirement>
+ *   <requirement name="Library">k4arecord.lib</requirement>
+ *   <requirement name="DLL">k4arecord.dll</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+K4ARECORD_EXPORT k4a_result_t k4a_playback_set_data_block_zero_copy(k4a_playback_t playback_handle, bool enable);
+
+/** Set whether the images of captures are converted from the recording only when they are first accessed.
+ *
+ * \param playback_handle
+ * Handle obtained by k4a_playback_open().
+ *
+ * \param enable
+ * If true, k4a_playback_get_next_capture(), k4a_playback_get_previous_capture() and the seek functions return captures
+ * whose images are read, decoded and converted the first time they are retrieved with k4a_capture_get_color_image(),
+ * k4a_capture_get_depth_image() or k4a_capture_get_ir_image(). If false, the default, every image of the capture is
+ * converted before the capture is returned.
+ *
+ * \returns
+ * ::K4A_RESULT_SUCCEEDED if the mode was set. ::K4A_RESULT_FAILED otherwise.
+ *
+ * \remarks
+ * Applications that only use some of the images in a recording, for example only the depth images of a recording that
+ * also contains color, skip the copy and the color conversion set by k4a_playback_set_color_conversion() for the images
+ * they never retrieve.
+ *
+ * \remarks
+ * Each capture keeps the part of the recording its images are read from loaded in memory until the images are
+ * retrieved or the capture is released. An image that fails to convert is logged and is not returned by the capture.
+ *
+ * \remarks
+ * The mode applies to captures read after this call. Captures already returned are not affected.
+ *
+ * \relates k4a_playback_t
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">playback.h (include k4arecord/playback.h)</requirement>
+ *   <requirement name="Library">k4arecord.lib</requirement>
+ *   <requirement name="DLL">k4arecord.dll</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+K4ARECORD_EXPORT k4a_result_t k4a_playback_set_lazy_images(k4a_playback_t playback_handle, bool enable);
+
 /** Reads an attachment file from a recording.
  *
  * \param playback_handle
@@ -774,6 +926,10 @@ K4ARECORD_EXPORT uint8_t *k4a_playback_data_block_get_buffer(k4a_playback_data_b
  * \remarks
  * Release the memory of a data block. The caller must not access the object after it is released.
  *
+ * \remarks
+ * A small number of released data block handles are kept by the playback handle and reused by later reads until
+ * k4a_playback_close() is called. Data blocks may be released before or after the playback handle is closed.
+ *
  * \relates k4a_playback_data_block_t
  *
  * \xmlonly
@@ -887,6 +1043,126 @@ K4ARECORD_EXPORT uint64_t k4a_playback_get_recording_length_usec(k4a_playback_t
  */
 K4ARECORD_DEPRECATED_EXPORT uint64_t k4a_playback_get_last_timestamp_usec(k4a_playback_t playback_handle);
 
+/** Gets statistics about the structure of a recording.
+ *
+ * \param playback_handle
+ * Handle obtained by k4a_playback_open().
+ *
+ * \param statistics
+ * Location to write the recording statistics.
+ *
+ * \returns
+ * ::K4A_RESULT_SUCCEEDED if the recording was scanned. A recording that ends early is still scanned, and is reported by
+ * the truncated field of \p statistics.
+ *
+ * \relates k4a_playback_t
+ *
+ * \remarks
+ * The first call to this function or k4a_playback_track_get_statistics() scans the whole recording. Only the cluster
+ * and block headers are read, the data in each block is skipped without being read or decoded. The result is kept by
+ * the playback handle, so later calls return immediately.
+ *
+ * \remarks
+ * The scan moves the file position of the playback handle, but does not change which capture, IMU sample or data block
+ * is returned next.
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">playback.h (include k4arecord/playback.h)</requirement>
+ *   <requirement name="Library">k4arecord.lib</requirement>
+ *   <requirement name="DLL">k4arecord.dll</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+K4ARECORD_EXPORT k4a_result_t k4a_playback_get_statistics(k4a_playback_t playback_handle,
+                                                          k4a_playback_statistics_t *statistics);
+
+/** Gets the frame count, timestamp gaps and bitrate of a track.
+ *
+ * \param playback_handle
+ * Handle obtained by k4a_playback_open().
+ *
+ * \param track_name
+ * The name of the track, either a built-in track name such as ::K4A_TRACK_NAME_COLOR or a custom track name.
+ *
+ * \param statistics
+ * Location to write the track statistics.
+ *
+ * \returns
+ * ::K4A_RESULT_SUCCEEDED if the statistics were written to \p statistics. ::K4A_RESULT_FAILED if the track cannot be
+ * found or the recording could not be scanned.
+ *
+ * \relates k4a_playback_t
+ *
+ * \remarks
+ * The statistics are computed from block headers only, see k4a_playback_get_statistics(). A track without any blocks
+ * has a frame count of 0.
+ *
+ * \remarks
+ * Gaps and dropped frames are only counted for tracks with a nominal frame period, such as the built-in color, depth
+ * and IR tracks. A gap longer than 1.5 frame periods counts the frames that would have filled it as dropped.
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">playback.h (include k4arecord/playback.h)</requirement>
+ *   <requirement name="Library">k4arecord.lib</requirement>
+ *   <requirement name="DLL">k4arecord.dll</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+K4ARECORD_EXPORT k4a_result_t k4a_playback_track_get_statistics(k4a_playback_t playback_handle,
+                                                                const char *track_name,
+                                                                k4a_playback_track_statistics_t *statistics);
+
+/** Writes the part of a recording between two timestamps to a new recording file.
+ *
+ * \param playback_handle
+ * Handle obtained by k4a_playback_open().
+ *
+ * \param path
+ * Filesystem path for the new recording. An existing file at this path is overwritten.
+ *
+ * \param start_timestamp_usec
+ * The first timestamp to keep, in microseconds relative to the start of the recording, the same as the offset passed
+ * to k4a_playback_seek_timestamp() with ::K4A_PLAYBACK_SEEK_BEGIN.
+ *
+ * \param end_timestamp_usec
+ * The timestamp to stop at, in microseconds relative to the start of the recording. Data at this timestamp is not
+ * included.
+ *
+ * \returns
+ * ::K4A_RESULT_SUCCEEDED if the new recording was written. ::K4A_RESULT_FAILED if the range is empty, contains no
+ * data, or the file could not be written.
+ *
+ * \relates k4a_playback_t
+ *
+ * \remarks
+ * Image, IMU and custom track data is copied without being decoded or re-encoded. Clusters entirely within the range
+ * are copied as they are, and only the clusters at either end of the range are rebuilt to drop the blocks outside of
+ * it. A block containing several IMU samples is kept if its first sample is within the range.
+ *
+ * \remarks
+ * The new recording starts at \p start_timestamp_usec. Its start timestamp offset is increased by the same amount, so
+ * device timestamps returned when playing back the new recording are the same as in the original recording. Tracks,
+ * attachments such as the calibration, and tags are copied from the original recording.
+ *
+ * \remarks
+ * This function moves the file position of the playback handle, but does not change which capture, IMU sample or
+ * data block is returned next.
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">playback.h (include k4arecord/playback.h)</requirement>
+ *   <requirement name="Library">k4arecord.lib</requirement>
+ *   <requirement name="DLL">k4arecord.dll</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+K4ARECORD_EXPORT k4a_result_t k4a_playback_trim(k4a_playback_t playback_handle,
+                                                const char *path,
+                                                uint64_t start_timestamp_usec,
+                                                uint64_t end_timestamp_usec);
+
 /** Closes a recording playback handle.
  *
  * \param playback_handle
@@ -906,6 +1182,184 @@ K4ARECORD_DEPRECATED_EXPORT uint64_t k4a_playback_get_last_timestamp_usec(k4a_pl
  */
 K4ARECORD_EXPORT void k4a_playback_close(k4a_playback_t playback_handle);
 
+/** Opens several recordings for synchronized playback.
+ *
+ * \param paths
+ * An array of \p path_count file paths, typically one recording per device of a multi-device capture session.
+ *
+ * \param path_count
+ * The number of recordings in \p paths.
+ *
+ * \param group_handle
+ * If successful, this contains a pointer to the playback group handle. Caller must call k4a_playback_group_close() when
+ * finished with the group.
+ *
+ * \returns
+ * ::K4A_RESULT_SUCCEEDED if every recording was opened successfully. ::K4A_RESULT_FAILED otherwise.
+ *
+ * \remarks
+ * The recordings are merged on a shared timeline. A capture's timestamp is the earliest device timestamp of its images,
+ * which already includes the recording's start_timestamp_offset_usec. For recordings made in
+ * ::K4A_WIRED_SYNC_MODE_SUBORDINATE the recording's subordinate_delay_off_master_usec is subtracted, so that captures
+ * triggered by the same master pulse have the same group timestamp.
+ *
+ * \remarks
+ * Each recording is read on its own thread, which reads and decodes a few captures ahead of the caller. Captures are
+ * decoded using the recording's default color format.
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">playback.h (include k4arecord/playback.h)</requirement>
+ *   <requirement name="Library">k4arecord.lib</requirement>
+ *   <requirement name="DLL">k4arecord.dll</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+K4ARECORD_EXPORT k4a_result_t k4a_playback_group_open(const char *const *paths,
+                                                      size_t path_count,
+                                                      k4a_playback_group_t *group_handle);
+
+/** Get the number of recordings in a playback group.
+ *
+ * \param group_handle
+ * Handle obtained by k4a_playback_group_open().
+ *
+ * \returns
+ * The number of recordings in the group, or 0 if the handle is invalid.
+ *
+ * \relates k4a_playback_group_t
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">playback.h (include k4arecord/playback.h)</requirement>
+ *   <requirement name="Library">k4arecord.lib</requirement>
+ *   <requirement name="DLL">k4arecord.dll</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+K4ARECORD_EXPORT size_t k4a_playback_group_get_playback_count(k4a_playback_group_t group_handle);
+
+/** Get the playback handle of one recording in a playback group.
+ *
+ * \param group_handle
+ * Handle obtained by k4a_playback_group_open().
+ *
+ * \param playback_index
+ * The index of the recording, in the order the paths were passed to k4a_playback_group_open().
+ *
+ * \returns
+ * The playback handle, or NULL if the index is out of range.
+ *
+ * \remarks
+ * The handle is owned by the group and remains valid until k4a_playback_group_close() is called. It can be used to
+ * read the calibration, record configuration, tags and attachments of the recording. It must not be closed, and
+ * captures, IMU samples or data blocks must not be read from it, since the group reads captures from it on another
+ * thread.
+ *
+ * \relates k4a_playback_group_t
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">playback.h (include k4arecord/playback.h)</requirement>
+ *   <requirement name="Library">k4arecord.lib</requirement>
+ *   <requirement name="DLL">k4arecord.dll</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+K4ARECORD_EXPORT k4a_playback_t k4a_playback_group_get_playback(k4a_playback_group_t group_handle,
+                                                                size_t playback_index);
+
+/** Read the next capture across all recordings of a playback group.
+ *
+ * \param group_handle
+ * Handle obtained by k4a_playback_group_open().
+ *
+ * \param capture_handle
+ * If successful this contains a handle to a capture object. Caller must call k4a_capture_release() when its done using
+ * this capture.
+ *
+ * \param playback_index
+ * Optional location to write the index of the recording the capture was read from. May be NULL.
+ *
+ * \returns
+ * ::K4A_STREAM_RESULT_SUCCEEDED if a capture is returned, or ::K4A_STREAM_RESULT_EOF if the end of every recording has
+ * been reached. All other failures will return ::K4A_STREAM_RESULT_FAILED.
+ *
+ * \remarks
+ * Captures are returned in order of their group timestamp, see k4a_playback_group_open(). Captures with the same group
+ * timestamp are returned in the order of their recordings in the group.
+ *
+ * \relates k4a_playback_group_t
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">playback.h (include k4arecord/playback.h)</requirement>
+ *   <requirement name="Library">k4arecord.lib</requirement>
+ *   <requirement name="DLL">k4arecord.dll</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+K4ARECORD_EXPORT k4a_stream_result_t k4a_playback_group_get_next_capture(k4a_playback_group_t group_handle,
+                                                                         k4a_capture_t *capture_handle,
+                                                                         size_t *playback_index);
+
+/** Read the next set of captures that were taken at the same time by the recordings of a playback group.
+ *
+ * \param group_handle
+ * Handle obtained by k4a_playback_group_open().
+ *
+ * \param tolerance_usec
+ * The largest difference between the group timestamps of captures returned together.
+ *
+ * \param capture_handles
+ * An array with one entry per recording in the group. If successful, each entry contains a handle to a capture of the
+ * corresponding recording, or NULL if that recording has no capture within the tolerance. Caller must call
+ * k4a_capture_release() on every non-NULL capture.
+ *
+ * \param capture_count
+ * The number of entries in \p capture_handles. Must be equal to k4a_playback_group_get_playback_count().
+ *
+ * \returns
+ * ::K4A_STREAM_RESULT_SUCCEEDED if at least one capture is returned, or ::K4A_STREAM_RESULT_EOF if the end of every
+ * recording has been reached. All other failures will return ::K4A_STREAM_RESULT_FAILED.
+ *
+ * \remarks
+ * The set starts with the capture that has the earliest group timestamp of all recordings. It also holds the next
+ * capture of every other recording if its group timestamp is within \p tolerance_usec of that first capture. Each
+ * capture is returned exactly once, either by this function or by k4a_playback_group_get_next_capture().
+ *
+ * \relates k4a_playback_group_t
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">playback.h (include k4arecord/playback.h)</requirement>
+ *   <requirement name="Library">k4arecord.lib</requirement>
+ *   <requirement name="DLL">k4arecord.dll</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+K4ARECORD_EXPORT k4a_stream_result_t k4a_playback_group_get_next_captures(k4a_playback_group_t group_handle,
+                                                                          uint64_t tolerance_usec,
+                                                                          k4a_capture_t *capture_handles,
+                                                                          size_t capture_count);
+
+/** Closes a playback group and every recording in it.
+ *
+ * \param group_handle
+ * Handle obtained by k4a_playback_group_open().
+ *
+ * \relates k4a_playback_group_t
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">playback.h (include k4arecord/playback.h)</requirement>
+ *   <requirement name="Library">k4arecord.lib</requirement>
+ *   <requirement name="DLL">k4arecord.dll</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+K4ARECORD_EXPORT void k4a_playback_group_close(k4a_playback_group_t group_handle);
+
 /**
  * @}
  */
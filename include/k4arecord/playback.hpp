@@ -402,6 +402,78 @@ public:
         return std::chrono::microseconds(k4a_playback_get_recording_length_usec(m_handle));
     }
 
+    /** Get the time spent in each phase of opening the recording.
+     * Throws error on failure.
+     *
+     * \sa k4a_playback_get_open_timing
+     */
+    k4a_playback_open_timing_t get_open_timing() const
+    {
+        k4a_playback_open_timing_t timing;
+        k4a_result_t result = k4a_playback_get_open_timing(m_handle, &timing);
+
+        if (K4A_RESULT_SUCCEEDED != result)
+        {
+            throw error("Failed to get open timing!");
+        }
+
+        return timing;
+    }
+
+    /** Get statistics about the structure of the recording, read from its cluster and block headers.
+     * Throws error on failure.
+     *
+     * \sa k4a_playback_get_statistics
+     */
+    k4a_playback_statistics_t get_statistics() const
+    {
+        k4a_playback_statistics_t statistics;
+        k4a_result_t result = k4a_playback_get_statistics(m_handle, &statistics);
+
+        if (K4A_RESULT_SUCCEEDED != result)
+        {
+            throw error("Failed to scan recording!");
+        }
+
+        return statistics;
+    }
+
+    /** Get the frame count, timestamp gaps and bitrate of a track.
+     * Throws error on failure.
+     *
+     * \sa k4a_playback_track_get_statistics
+     */
+    k4a_playback_track_statistics_t get_track_statistics(const char *track_name) const
+    {
+        k4a_playback_track_statistics_t statistics;
+        k4a_result_t result = k4a_playback_track_get_statistics(m_handle, track_name, &statistics);
+
+        if (K4A_RESULT_SUCCEEDED != result)
+        {
+            throw error("Failed to read track statistics!");
+        }
+
+        return statistics;
+    }
+
+    /** Write the part of the recording between two timestamps to a new recording file, without re-encoding it.
+     * Throws error on failure.
+     *
+     * \sa k4a_playback_trim
+     */
+    void trim(const char *path, std::chrono::microseconds start_timestamp, std::chrono::microseconds end_timestamp)
+    {
+        k4a_result_t result = k4a_playback_trim(m_handle,
+                                                path,
+                                                static_cast<uint64_t>(start_timestamp.count()),
+                                                static_cast<uint64_t>(end_timestamp.count()));
+
+        if (K4A_RESULT_SUCCEEDED != result)
+        {
+            throw error("Failed to trim recording!");
+        }
+    }
+
     /** Set the image format that color captures will be converted to. By default the conversion format will be the
      * same as the image format stored in the recording file, and no conversion will occur.
      *
@@ -419,6 +491,36 @@ public:
         }
     }
 
+    /** Set whether data blocks reference the recording's memory instead of copying it.
+     * Throws error on failure.
+     *
+     * \sa k4a_playback_set_data_block_zero_copy
+     */
+    void set_data_block_zero_copy(bool enable)
+    {
+        k4a_result_t result = k4a_playback_set_data_block_zero_copy(m_handle, enable);
+
+        if (K4A_RESULT_SUCCEEDED != result)
+        {
+            throw error("Failed to set data block zero copy mode!");
+        }
+    }
+
+    /** Set whether capture images are converted from the recording only when they are first accessed.
+     * Throws error on failure.
+     *
+     * \sa k4a_playback_set_lazy_images
+     */
+    void set_lazy_images(bool enable)
+    {
+        k4a_result_t result = k4a_playback_set_lazy_images(m_handle, enable);
+
+        if (K4A_RESULT_SUCCEEDED != result)
+        {
+            throw error("Failed to set lazy image mode!");
+        }
+    }
+
     /** Get the next data block in the recording.
      * Returns true if a block was available, false if there are none left.
      * Throws error on failure.
@@ -68,6 +68,55 @@ K4ARECORD_EXPORT k4a_result_t k4a_record_create(const char *path,
                                                 const k4a_device_configuration_t device_config,
                                                 k4a_record_t *recording_handle);
 
+/** Opens a new recording file for writing, with custom cluster and index settings.
+ *
+ * \param path
+ * Filesystem path for the new recording.
+ *
+ * \param device
+ * The Azure Kinect device that is being recorded. The device handle is used to store device calibration and serial
+ * number information. May be NULL if recording user-generated data.
+ *
+ * \param device_config
+ * The configuration the Azure Kinect device was started with.
+ *
+ * \param settings
+ * The cluster length, seek index density and write delay of the recording. May be NULL to use the default settings,
+ * in which case this function is the same as k4a_record_create().
+ *
+ * \param recording_handle
+ * If successful, this contains a pointer to the new recording handle. Caller must call k4a_record_close()
+ * when finished with recording.
+ *
+ * \remarks
+ * Recordings for seek-heavy analysis can use shorter clusters and a smaller cue gap so that seeking reads less data.
+ * Long recordings can use a larger cue gap to keep the seek index small. See \ref k4a_record_settings_t for the valid
+ * range of each setting.
+ *
+ * \remarks
+ * Recordings written with any settings can be played back with k4a_playback_open().
+ *
+ * \headerfile record.h <k4arecord/record.h>
+ *
+ * \returns ::K4A_RESULT_SUCCEEDED is returned on success. ::K4A_RESULT_FAILED is returned if \p settings are outside of
+ * their valid range.
+ *
+ * \relates k4a_record_t
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">record.h (include k4arecord/record.h)</requirement>
+ *   <requirement name="Library">k4arecord.lib</requirement>
+ *   <requirement name="DLL">k4arecord.dll</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+K4ARECORD_EXPORT k4a_result_t k4a_record_create_with_settings(const char *path,
+                                                              k4a_device_t device,
+                                                              const k4a_device_configuration_t device_config,
+                                                              const k4a_record_settings_t *settings,
+                                                              k4a_record_t *recording_handle);
+
 /** Adds a tag to the recording.
  *
  * \param recording_handle
@@ -129,6 +178,44 @@ K4ARECORD_EXPORT k4a_result_t k4a_record_add_tag(k4a_record_t recording_handle,
  */
 K4ARECORD_EXPORT k4a_result_t k4a_record_add_imu_track(k4a_record_t recording_handle);
 
+/** Adds a low resolution preview track to the recording.
+ *
+ * \param recording_handle
+ * The handle of a new recording, obtained by k4a_record_create().
+ *
+ * \param settings
+ * The size, rate, quality and CPU budget of the preview. May be NULL to use the default settings.
+ *
+ * \headerfile record.h <k4arecord/record.h>
+ *
+ * \relates k4a_record_t
+ *
+ * \returns ::K4A_RESULT_SUCCEEDED is returned on success. ::K4A_RESULT_FAILED is returned if the recording has no
+ * color or depth track, or \p settings are outside of their valid range.
+ *
+ * \remarks
+ * Preview frames are generated on a background thread from the captures passed to k4a_record_write_capture(), and
+ * written as MJPG frames to the ::K4A_TRACK_NAME_PREVIEW track. The preview track can be read with
+ * k4a_playback_get_next_data_block() without reading the full resolution tracks.
+ *
+ * \remarks
+ * Color images recorded as MJPG are decoded at a reduced scale. Depth images are colorized over the range of the depth
+ * mode, with invalid pixels shown in black.
+ *
+ * \remarks
+ * The track needs to be added before the recording header is written.
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">record.h (include k4arecord/record.h)</requirement>
+ *   <requirement name="Library">k4arecord.lib</requirement>
+ *   <requirement name="DLL">k4arecord.dll</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+K4ARECORD_EXPORT k4a_result_t k4a_record_add_preview_track(k4a_record_t recording_handle,
+                                                           const k4a_record_preview_settings_t *settings);
+
 /** Adds an attachment to the recording.
  *
  * \param recording_handle
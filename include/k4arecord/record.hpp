@@ -134,6 +134,21 @@ public:
         }
     }
 
+    /** Adds a low resolution preview track to the recording
+     * Throws error on failure
+     *
+     * \sa k4a_record_add_preview_track
+     */
+    void add_preview_track(const k4a_record_preview_settings_t &settings = K4A_RECORD_PREVIEW_SETTINGS_INIT_DEFAULT)
+    {
+        k4a_result_t result = k4a_record_add_preview_track(m_handle, &settings);
+
+        if (K4A_FAILED(result))
+        {
+            throw error("Failed to add preview track!");
+        }
+    }
+
     /** Adds an attachment to the recording
      * Throws error on failure
      *
@@ -283,6 +298,28 @@ public:
         return record(handle);
     }
 
+    /** Opens a new recording file for writing, with custom cluster and index settings
+     * Throws error on failure
+     *
+     * \sa k4a_record_create_with_settings
+     */
+    static record create(const char *path,
+                         const device &device,
+                         const k4a_device_configuration_t &device_configuration,
+                         const k4a_record_settings_t &settings)
+    {
+        k4a_record_t handle = nullptr;
+        k4a_result_t result =
+            k4a_record_create_with_settings(path, device.handle(), device_configuration, &settings, &handle);
+
+        if (K4A_FAILED(result))
+        {
+            throw error("Failed to create recorder!");
+        }
+
+        return record(handle);
+    }
+
 private:
     k4a_record_t m_handle;
 };
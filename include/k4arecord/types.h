@@ -63,6 +63,21 @@ K4A_DECLARE_HANDLE(k4a_playback_t);
  */
 K4A_DECLARE_HANDLE(k4a_playback_data_block_t)
 
+/** \class k4a_playback_group_t types.h <k4arecord/types.h>
+ * Handle to a group of k4a recordings played back together in timestamp order.
+ *
+ * \remarks
+ * Handles are created with k4a_playback_group_open(), and closed with k4a_playback_group_close().
+ * Invalid handles are set to 0.
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">types.h (include k4arecord/types.h)</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+K4A_DECLARE_HANDLE(k4a_playback_group_t);
+
 /**
  * @}
  *
@@ -110,6 +125,16 @@ K4A_DECLARE_HANDLE(k4a_playback_data_block_t)
  */
 #define K4A_TRACK_NAME_IMU "IMU"
 
+/** Name of the optional preview track added by k4a_record_add_preview_track().
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">types.h (include k4arecord/types.h)</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+#define K4A_TRACK_NAME_PREVIEW "PREVIEW"
+
 /**
  * @}
  *
@@ -250,6 +275,209 @@ typedef struct _k4a_record_subtitle_settings_t
     bool high_freq_data;
 } k4a_record_subtitle_settings_t;
 
+/** Structure containing the cluster and index settings of a new recording.
+ *
+ * \remarks
+ * Fields set to 0 use the default value. Use ::K4A_RECORD_SETTINGS_INIT_DEFAULT to initialize all fields to their
+ * defaults.
+ *
+ * \see k4a_record_create_with_settings()
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">types.h (include k4arecord/types.h)</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+typedef struct _k4a_record_settings_t
+{
+    /**
+     * The length of each cluster in microseconds. Clusters are the unit that data is written to disk and seeked to
+     * during playback. Shorter clusters allow finer seeking, longer clusters have less overhead per block of data.
+     * Block timestamps within a cluster are stored as 16-bit values, so this must be less than 32767 microseconds.
+     *
+     * Defaults to 32000 microseconds.
+     */
+    uint32_t cluster_length_usec;
+
+    /**
+     * The minimum time between entries in the seek index, in microseconds. A smaller gap makes seeking faster, at the
+     * cost of a larger index that is read when the recording is opened.
+     *
+     * Defaults to 1000000 microseconds.
+     */
+    uint32_t cue_gap_usec;
+
+    /**
+     * How long data is buffered in memory before it is written to disk, in microseconds. Data written to the recording
+     * out of order must arrive within this time. This must be at least 2 cluster lengths.
+     *
+     * Defaults to 2000000 microseconds.
+     */
+    uint32_t cluster_write_delay_usec;
+} k4a_record_settings_t;
+
+/** Initial configuration setting for using the default recording settings.
+ *
+ * \remarks
+ * Use this setting to initialize a \ref k4a_record_settings_t to its default values.
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">types.h (include k4arecord/types.h)</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+static const k4a_record_settings_t K4A_RECORD_SETTINGS_INIT_DEFAULT = { 0, 0, 0 };
+
+/** Structure containing the settings of a recording's preview track.
+ *
+ * \remarks
+ * Each preview frame is a JPEG image of the color camera and a colorized depth image placed side by side. Recordings
+ * without a color or depth track only contain the other image.
+ *
+ * \remarks
+ * Fields set to 0 use the default value. Use ::K4A_RECORD_PREVIEW_SETTINGS_INIT_DEFAULT to initialize all fields to
+ * their defaults.
+ *
+ * \see k4a_record_add_preview_track()
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">types.h (include k4arecord/types.h)</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+typedef struct _k4a_record_preview_settings_t
+{
+    /**
+     * The width in pixels of each image in a preview frame.
+     *
+     * Defaults to 320 pixels.
+     */
+    uint32_t width;
+
+    /**
+     * The height in pixels of each image in a preview frame.
+     *
+     * Defaults to 180 pixels.
+     */
+    uint32_t height;
+
+    /**
+     * The minimum time between preview frames in microseconds, measured in device time.
+     *
+     * Defaults to 1000000 microseconds.
+     */
+    uint32_t interval_usec;
+
+    /**
+     * The JPEG quality of the preview frames, from 1 to 100.
+     *
+     * Defaults to 75.
+     */
+    uint32_t jpeg_quality;
+
+    /**
+     * The share of a single processor core that preview generation may use, in percent from 1 to 100. Captures that
+     * arrive while the preview worker is busy or over its budget are skipped, so the preview may have fewer frames
+     * than \p interval_usec allows.
+     *
+     * Defaults to 5 percent.
+     */
+    uint32_t max_cpu_percent;
+} k4a_record_preview_settings_t;
+
+/** Initial configuration setting for using the default preview settings.
+ *
+ * \remarks
+ * Use this setting to initialize a \ref k4a_record_preview_settings_t to its default values.
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">types.h (include k4arecord/types.h)</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+static const k4a_record_preview_settings_t K4A_RECORD_PREVIEW_SETTINGS_INIT_DEFAULT = { 0, 0, 0, 0, 0 };
+
+/** Structure containing statistics about a single track, computed from the block headers of a recording.
+ *
+ * \remarks
+ * Timestamps are device timestamps in microseconds, matching k4a_image_get_device_timestamp_usec(). Frames batched
+ * together in a single block are counted individually, and the last frame of a batch is assumed to be at the end of the
+ * block duration.
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">types.h (include k4arecord/types.h)</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+typedef struct _k4a_playback_track_statistics_t
+{
+    uint64_t frame_count;            /**< Number of frames in the track */
+    uint64_t block_count;            /**< Number of Matroska blocks in the track */
+    uint64_t data_size_bytes;        /**< Total size of the track's blocks in bytes */
+    uint64_t start_timestamp_usec;   /**< Timestamp of the first frame */
+    uint64_t end_timestamp_usec;     /**< Timestamp of the last frame */
+    uint64_t frame_period_usec;      /**< Nominal frame period of the track, or 0 if the track does not define one */
+    uint64_t max_gap_usec;           /**< Largest timestamp difference between consecutive frames */
+    uint64_t gap_count;              /**< Number of gaps longer than 1.5 frame periods, 0 without a frame period */
+    uint64_t dropped_frame_estimate; /**< Frames missing from those gaps, rounded to the nearest frame period */
+    uint64_t out_of_order_count;     /**< Number of blocks with a timestamp before the previous frame */
+    uint64_t bitrate_bps;            /**< Average bitrate of the track in bits per second */
+} k4a_playback_track_statistics_t;
+
+/** Structure containing statistics about the structure of a recording, computed from its cluster and block headers.
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">types.h (include k4arecord/types.h)</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+typedef struct _k4a_playback_statistics_t
+{
+    uint64_t cluster_count;             /**< Number of clusters scanned */
+    uint64_t block_count;               /**< Number of blocks scanned, in all tracks */
+    uint64_t unknown_track_block_count; /**< Number of blocks belonging to a track missing from the track list */
+    uint64_t file_size_bytes;           /**< Size of the recording file in bytes */
+
+    /**
+     * True if the recording ends in the middle of a cluster or a cluster could not be parsed. Statistics only cover the
+     * blocks before that point.
+     */
+    bool truncated;
+} k4a_playback_statistics_t;
+
+/** Structure containing the time spent in each phase of opening a recording.
+ *
+ * \remarks
+ * All times are in microseconds of wall clock time.
+ *
+ * \xmlonly
+ * <requirements>
+ *   <requirement name="Header">types.h (include k4arecord/types.h)</requirement>
+ * </requirements>
+ * \endxmlonly
+ */
+typedef struct _k4a_playback_open_timing_t
+{
+    uint64_t header_usec;        /**< Opening the file and reading the segment, track, cue and attachment headers */
+    uint64_t config_usec;        /**< Parsing the track list and recording configuration */
+    uint64_t cluster_index_usec; /**< Building the cluster index and finding the end of the recording */
+    uint64_t first_cluster_usec; /**< Loading the first cluster of the recording */
+
+    /**
+     * Parsing the device calibration, 0 until the calibration is first needed. Recordings opened with
+     * k4a_playback_open_multiple() that share their calibration with an earlier recording report 0.
+     */
+    uint64_t calibration_usec;
+
+    uint64_t total_usec; /**< Total time spent in k4a_playback_open(), not including the calibration */
+} k4a_playback_open_timing_t;
+
 /**
  * @}
  */
@@ -17,6 +17,12 @@
 #include <assert.h>
 #include <math.h>
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
 typedef enum
 {
     IMAGE_TYPE_COLOR = 0,
@@ -25,6 +31,52 @@ typedef enum
     IMAGE_TYPE_COUNT,
 } image_type_index_t;
 
+#define ALLOCATION_SOURCE_COUNT (ALLOCATION_SOURCE_USB_IMU + 1)
+
+typedef struct _allocator_pool_t allocator_pool_t;
+
+// A preallocated buffer owned by a pool. It is handed out by allocator_alloc() and comes back to the pool through the
+// allocation context's free callback.
+typedef struct _allocator_pool_buffer_t
+{
+    allocator_pool_t *pool;
+    void *full_buffer; // NULL until the buffer has been created
+    k4a_memory_destroy_cb_t *free;
+    void *free_context;
+    bool in_use;
+} allocator_pool_buffer_t;
+
+// Set of prefaulted buffers recycled for one allocation source
+struct _allocator_pool_t
+{
+    k4a_rwlock_t lock;
+
+    size_t buffer_size;    // Size of each buffer including the allocation context, 0 until the first allocation
+    uint32_t buffer_count; // Number of buffers the pool holds once filled
+    uint32_t enable_count; // Number of allocator_pool_enable() calls sharing this pool
+    uint32_t in_use_count; // Number of buffers currently handed out
+    bool lock_memory;      // Buffers are locked into physical memory
+    bool detached;         // The pool has been disabled and is destroyed once all buffers are returned
+
+    allocator_pool_buffer_t buffers[ALLOCATOR_POOL_MAX_BUFFERS];
+};
+
+// Byte accounting for outstanding allocations, used to apply the memory limits
+typedef struct
+{
+    uint64_t bytes[ALLOCATION_SOURCE_COUNT];
+    uint64_t total_bytes;
+    uint64_t peak_total_bytes;
+
+    // A limit of 0 means no limit
+    uint64_t soft_limit_bytes;
+    uint64_t hard_limit_bytes;
+
+    uint32_t color_frames_dropped;
+    uint32_t depth_frames_dropped;
+    uint32_t user_allocations_refused;
+} allocator_usage_t;
+
 // Global properties of the allocator
 typedef struct
 {
@@ -34,6 +86,13 @@ typedef struct
     // while holding lock
     k4a_memory_allocate_cb_t *alloc;
     k4a_memory_destroy_cb_t *free;
+
+    // Buffer pools, indexed by allocation source. Access may only occur while holding lock
+    allocator_pool_t *pool[ALLOCATION_SOURCE_COUNT];
+
+    // Access to usage may only occur while holding usage_lock
+    k4a_rwlock_t usage_lock;
+    allocator_usage_t usage;
 } allocator_global_t;
 
 // This allocator implementation is used by default
@@ -59,6 +118,7 @@ static void default_free(void *buffer, void *context)
 static void allocator_global_init(allocator_global_t *g_allocator)
 {
     rwlock_init(&g_allocator->lock);
+    rwlock_init(&g_allocator->usage_lock);
 
     g_allocator->alloc = default_alloc;
     g_allocator->free = default_free;
@@ -75,6 +135,7 @@ typedef struct _allocation_context_t
             allocation_source_t source;
             k4a_memory_destroy_cb_t *free;
             void *free_context;
+            size_t size;
         } context;
 
         // Keep 16 byte alignment so that allocations may be used with SSE
@@ -84,6 +145,175 @@ typedef struct _allocation_context_t
 
 K4A_DECLARE_GLOBAL(allocator_global_t, allocator_global_init);
 
+// Adds alloc_size bytes to the accounting for source
+static void allocator_usage_add(allocator_global_t *g_allocator, allocation_source_t source, size_t alloc_size)
+{
+    rwlock_acquire_write(&g_allocator->usage_lock);
+    g_allocator->usage.bytes[source] += alloc_size;
+    g_allocator->usage.total_bytes += alloc_size;
+    if (g_allocator->usage.total_bytes > g_allocator->usage.peak_total_bytes)
+    {
+        g_allocator->usage.peak_total_bytes = g_allocator->usage.total_bytes;
+    }
+    rwlock_release_write(&g_allocator->usage_lock);
+}
+
+// Removes alloc_size bytes from the accounting for source
+static void allocator_usage_remove(allocator_global_t *g_allocator, allocation_source_t source, size_t alloc_size)
+{
+    rwlock_acquire_write(&g_allocator->usage_lock);
+    assert(g_allocator->usage.bytes[source] >= alloc_size);
+    g_allocator->usage.bytes[source] -= alloc_size;
+    g_allocator->usage.total_bytes -= alloc_size;
+    rwlock_release_write(&g_allocator->usage_lock);
+}
+
+// Locks the pages of a buffer into physical memory
+static bool allocator_lock_memory(void *buffer, size_t size)
+{
+#ifdef _WIN32
+    return VirtualLock(buffer, size) != 0;
+#else
+    return mlock(buffer, size) == 0;
+#endif
+}
+
+static void allocator_unlock_memory(void *buffer, size_t size)
+{
+#ifdef _WIN32
+    VirtualUnlock(buffer, size);
+#else
+    munlock(buffer, size);
+#endif
+}
+
+// Creates any pool buffers that don't exist yet. Every page is written so that it is resident before the buffer is
+// first used. Must be called while holding the allocator lock and the pool lock.
+static k4a_result_t allocator_pool_fill(allocator_global_t *g_allocator, allocator_pool_t *pool)
+{
+    k4a_result_t result = K4A_RESULT_SUCCEEDED;
+
+    assert(pool->buffer_size != 0);
+    for (uint32_t i = 0; i < pool->buffer_count && K4A_SUCCEEDED(result); i++)
+    {
+        allocator_pool_buffer_t *pool_buffer = &pool->buffers[i];
+        if (pool_buffer->full_buffer != NULL)
+        {
+            continue;
+        }
+
+        void *user_context;
+        void *full_buffer = g_allocator->alloc((int)pool->buffer_size, &user_context);
+        if (full_buffer == NULL)
+        {
+            LOG_ERROR("Preallocation of %zu byte buffer failed", pool->buffer_size);
+            result = K4A_RESULT_FAILED;
+            break;
+        }
+
+        memset(full_buffer, 0, pool->buffer_size);
+
+        if (pool->lock_memory && !allocator_lock_memory(full_buffer, pool->buffer_size))
+        {
+            LOG_ERROR("Locking %zu byte buffer into memory failed", pool->buffer_size);
+            g_allocator->free(full_buffer, user_context);
+            result = K4A_RESULT_FAILED;
+            break;
+        }
+
+        pool_buffer->pool = pool;
+        pool_buffer->full_buffer = full_buffer;
+        pool_buffer->free = g_allocator->free;
+        pool_buffer->free_context = user_context;
+        pool_buffer->in_use = false;
+    }
+
+    return result;
+}
+
+// Releases a pool and all of its buffers. No buffers may be in use.
+static void allocator_pool_destroy(allocator_pool_t *pool)
+{
+    assert(pool->in_use_count == 0);
+    for (uint32_t i = 0; i < ALLOCATOR_POOL_MAX_BUFFERS; i++)
+    {
+        allocator_pool_buffer_t *pool_buffer = &pool->buffers[i];
+        if (pool_buffer->full_buffer != NULL)
+        {
+            if (pool->lock_memory)
+            {
+                allocator_unlock_memory(pool_buffer->full_buffer, pool->buffer_size);
+            }
+            pool_buffer->free(pool_buffer->full_buffer, pool_buffer->free_context);
+            pool_buffer->full_buffer = NULL;
+        }
+    }
+    rwlock_deinit(&pool->lock);
+    free(pool);
+}
+
+// Hands out an idle pool buffer able to hold required_bytes, or returns NULL if the pool for source can't serve the
+// request. Never allocates; pools are only filled by allocator_pool_enable() and allocator_pool_prepare(). Must be
+// called while holding the allocator lock.
+static allocator_pool_buffer_t *allocator_pool_take(allocator_global_t *g_allocator,
+                                                    allocation_source_t source,
+                                                    size_t required_bytes)
+{
+    allocator_pool_t *pool = g_allocator->pool[source];
+    allocator_pool_buffer_t *taken = NULL;
+
+    if (pool == NULL)
+    {
+        return NULL;
+    }
+
+    rwlock_acquire_write(&pool->lock);
+    if (required_bytes <= pool->buffer_size)
+    {
+        for (uint32_t i = 0; i < pool->buffer_count && taken == NULL; i++)
+        {
+            if (pool->buffers[i].full_buffer != NULL && !pool->buffers[i].in_use)
+            {
+                taken = &pool->buffers[i];
+                taken->in_use = true;
+                pool->in_use_count++;
+            }
+        }
+    }
+    rwlock_release_write(&pool->lock);
+
+    return taken;
+}
+
+// Free callback for pool buffers. The buffer stays allocated and is made available for the next frame.
+static void allocator_pool_return(void *full_buffer, void *context)
+{
+    allocator_pool_buffer_t *pool_buffer = (allocator_pool_buffer_t *)context;
+    allocator_pool_t *pool = pool_buffer->pool;
+
+    (void)full_buffer;
+    assert(full_buffer == pool_buffer->full_buffer);
+
+    rwlock_acquire_write(&pool->lock);
+    assert(pool_buffer->in_use);
+    pool_buffer->in_use = false;
+    pool->in_use_count--;
+    bool destroy = pool->detached && pool->in_use_count == 0;
+    rwlock_release_write(&pool->lock);
+
+    if (destroy)
+    {
+        allocator_pool_destroy(pool);
+    }
+}
+
+// Returns true if allocating alloc_size more bytes would exceed limit_bytes. A limit of 0 is never exceeded.
+// Must be called while holding usage_lock.
+static bool allocator_usage_exceeds(allocator_global_t *g_allocator, uint64_t limit_bytes, size_t alloc_size)
+{
+    return limit_bytes != 0 && g_allocator->usage.total_bytes + alloc_size > limit_bytes;
+}
+
 //
 // Simple counts of memory allocations for the purpose of detecting leaks of the K4A SDK's larger memory objects.
 //
@@ -105,12 +335,21 @@ static volatile long g_allocated_image_count_usb_imu = 0;
 // Count the number of active sessions for this process. A session maps to k4a_device_open
 static volatile long g_allocator_sessions = 0;
 
+// Produces the image of a capture slot on first access, see k4a_capture_set_color_image_loader()
+typedef struct _capture_image_loader_t
+{
+    k4a_capture_image_load_cb_t *load_cb;
+    k4a_capture_image_loader_release_cb_t *release_cb;
+    void *context;
+} capture_image_loader_t;
+
 typedef struct _capture_context_t
 {
     volatile long ref_count;
     k4a_rwlock_t lock;
 
     k4a_image_t image[IMAGE_TYPE_COUNT];
+    capture_image_loader_t loader[IMAGE_TYPE_COUNT]; // Only set while the image slot is empty
 
     float temperature_c; /** Temperature in Celsius */
 } capture_context_t;
@@ -153,6 +392,25 @@ uint8_t *allocator_alloc(allocation_source_t source, size_t alloc_size)
     size_t required_bytes = alloc_size + sizeof(allocation_context_t);
     RETURN_VALUE_IF_ARG(NULL, required_bytes > INT32_MAX);
 
+    if (source == ALLOCATION_SOURCE_USER)
+    {
+        // Streaming sources are throttled by allocator_should_drop() before they allocate. User allocations are
+        // refused outright once the hard limit would be exceeded.
+        rwlock_acquire_write(&g_allocator->usage_lock);
+        bool refused = allocator_usage_exceeds(g_allocator, g_allocator->usage.hard_limit_bytes, alloc_size);
+        if (refused)
+        {
+            g_allocator->usage.user_allocations_refused++;
+        }
+        rwlock_release_write(&g_allocator->usage_lock);
+
+        if (refused)
+        {
+            LOG_ERROR("Allocation of %zu bytes refused, the memory hard limit has been reached", alloc_size);
+            return NULL;
+        }
+    }
+
     volatile long *ref = NULL;
     switch (source)
     {
@@ -183,16 +441,29 @@ uint8_t *allocator_alloc(allocation_source_t source, size_t alloc_size)
 
     rwlock_acquire_read(&g_allocator->lock);
 
-    void *user_context;
-
-    void *full_buffer = g_allocator->alloc((int)required_bytes, &user_context);
+    void *full_buffer;
 
     // Store information about the allocation that we will need during free.
     allocation_context_t allocation_context;
 
     allocation_context.u.context.source = source;
-    allocation_context.u.context.free = g_allocator->free;
-    allocation_context.u.context.free_context = user_context;
+    allocation_context.u.context.size = alloc_size;
+
+    allocator_pool_buffer_t *pool_buffer = allocator_pool_take(g_allocator, source, required_bytes);
+    if (pool_buffer != NULL)
+    {
+        full_buffer = pool_buffer->full_buffer;
+        allocation_context.u.context.free = allocator_pool_return;
+        allocation_context.u.context.free_context = pool_buffer;
+    }
+    else
+    {
+        void *user_context;
+
+        full_buffer = g_allocator->alloc((int)required_bytes, &user_context);
+        allocation_context.u.context.free = g_allocator->free;
+        allocation_context.u.context.free_context = user_context;
+    }
 
     rwlock_release_read(&g_allocator->lock);
 
@@ -202,6 +473,8 @@ uint8_t *allocator_alloc(allocation_source_t source, size_t alloc_size)
         return NULL;
     }
 
+    allocator_usage_add(g_allocator, source, alloc_size);
+
     // Memcpy the context information to the header of the full buffer.
     // Don't cast the buffer directly since there is no alignment constraint
     memcpy(full_buffer, &allocation_context, sizeof(allocation_context));
@@ -252,10 +525,214 @@ void allocator_free(void *buffer)
 
     DEC_REF_VAR(*ref);
 
+    allocator_usage_remove(allocator_global_t_get(), source, allocation_context.u.context.size);
+
     allocation_context.u.context.free(full_buffer, allocation_context.u.context.free_context);
     full_buffer = NULL;
 }
 
+k4a_result_t allocator_set_memory_limits(size_t soft_limit_bytes, size_t hard_limit_bytes)
+{
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, hard_limit_bytes != 0 && soft_limit_bytes > hard_limit_bytes);
+
+    allocator_global_t *g_allocator = allocator_global_t_get();
+    rwlock_acquire_write(&g_allocator->usage_lock);
+
+    g_allocator->usage.soft_limit_bytes = soft_limit_bytes;
+    g_allocator->usage.hard_limit_bytes = hard_limit_bytes;
+
+    rwlock_release_write(&g_allocator->usage_lock);
+
+    return K4A_RESULT_SUCCEEDED;
+}
+
+void allocator_get_memory_usage(k4a_memory_usage_t *usage)
+{
+    RETURN_VALUE_IF_ARG(VOID_VALUE, usage == NULL);
+
+    allocator_global_t *g_allocator = allocator_global_t_get();
+    rwlock_acquire_read(&g_allocator->usage_lock);
+
+    usage->user_bytes = g_allocator->usage.bytes[ALLOCATION_SOURCE_USER];
+    usage->color_bytes = g_allocator->usage.bytes[ALLOCATION_SOURCE_COLOR];
+    usage->depth_bytes = g_allocator->usage.bytes[ALLOCATION_SOURCE_DEPTH];
+    usage->imu_bytes = g_allocator->usage.bytes[ALLOCATION_SOURCE_IMU];
+    usage->usb_bytes = g_allocator->usage.bytes[ALLOCATION_SOURCE_USB_DEPTH] +
+                       g_allocator->usage.bytes[ALLOCATION_SOURCE_USB_IMU];
+    usage->total_bytes = g_allocator->usage.total_bytes;
+    usage->peak_total_bytes = g_allocator->usage.peak_total_bytes;
+    usage->soft_limit_bytes = g_allocator->usage.soft_limit_bytes;
+    usage->hard_limit_bytes = g_allocator->usage.hard_limit_bytes;
+    usage->color_frames_dropped = g_allocator->usage.color_frames_dropped;
+    usage->depth_frames_dropped = g_allocator->usage.depth_frames_dropped;
+    usage->user_allocations_refused = g_allocator->usage.user_allocations_refused;
+
+    rwlock_release_read(&g_allocator->usage_lock);
+}
+
+bool allocator_should_drop(allocation_source_t source, size_t alloc_size)
+{
+    allocator_global_t *g_allocator = allocator_global_t_get();
+    bool drop = false;
+
+    rwlock_acquire_write(&g_allocator->usage_lock);
+    switch (source)
+    {
+    case ALLOCATION_SOURCE_COLOR:
+        // Color is the first stream to be shed, as soon as the soft limit is reached
+        drop = allocator_usage_exceeds(g_allocator, g_allocator->usage.soft_limit_bytes, alloc_size) ||
+               allocator_usage_exceeds(g_allocator, g_allocator->usage.hard_limit_bytes, alloc_size);
+        if (drop)
+        {
+            g_allocator->usage.color_frames_dropped++;
+        }
+        break;
+    case ALLOCATION_SOURCE_DEPTH:
+        // Depth is only shed at the hard limit
+        drop = allocator_usage_exceeds(g_allocator, g_allocator->usage.hard_limit_bytes, alloc_size);
+        if (drop)
+        {
+            g_allocator->usage.depth_frames_dropped++;
+        }
+        break;
+    default:
+        // IMU and USB transfer buffers are small and recycled, dropping them would stall the device
+        break;
+    }
+    rwlock_release_write(&g_allocator->usage_lock);
+
+    return drop;
+}
+
+k4a_result_t allocator_pool_enable(allocation_source_t source,
+                                   size_t buffer_size,
+                                   uint32_t buffer_count,
+                                   bool lock_memory)
+{
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, source < ALLOCATION_SOURCE_USER || source > ALLOCATION_SOURCE_USB_IMU);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, buffer_count == 0 || buffer_count > ALLOCATOR_POOL_MAX_BUFFERS);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, buffer_size > INT32_MAX - sizeof(allocation_context_t));
+
+    allocator_global_t *g_allocator = allocator_global_t_get();
+    k4a_result_t result = K4A_RESULT_SUCCEEDED;
+
+    rwlock_acquire_write(&g_allocator->lock);
+
+    allocator_pool_t *pool = g_allocator->pool[source];
+    if (pool == NULL)
+    {
+        pool = (allocator_pool_t *)malloc(sizeof(allocator_pool_t));
+        result = K4A_RESULT_FROM_BOOL(pool != NULL);
+
+        if (K4A_SUCCEEDED(result))
+        {
+            memset(pool, 0, sizeof(allocator_pool_t));
+            rwlock_init(&pool->lock);
+            pool->buffer_size = buffer_size ? buffer_size + sizeof(allocation_context_t) : 0;
+            pool->lock_memory = lock_memory;
+        }
+    }
+
+    if (K4A_SUCCEEDED(result))
+    {
+        // Another device streaming from the same source shares the pool. It keeps the buffer size of the first device.
+        rwlock_acquire_write(&pool->lock);
+        pool->enable_count++;
+        pool->buffer_count += buffer_count;
+        if (pool->buffer_count > ALLOCATOR_POOL_MAX_BUFFERS)
+        {
+            pool->buffer_count = ALLOCATOR_POOL_MAX_BUFFERS;
+        }
+        if (pool->buffer_size != 0)
+        {
+            result = TRACE_CALL(allocator_pool_fill(g_allocator, pool));
+        }
+        rwlock_release_write(&pool->lock);
+
+        g_allocator->pool[source] = pool;
+    }
+
+    rwlock_release_write(&g_allocator->lock);
+
+    if (K4A_FAILED(result) && pool != NULL)
+    {
+        allocator_pool_disable(source);
+    }
+
+    return result;
+}
+
+k4a_result_t allocator_pool_prepare(allocation_source_t source, size_t buffer_size)
+{
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, source < ALLOCATION_SOURCE_USER || source > ALLOCATION_SOURCE_USB_IMU);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, buffer_size == 0);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, buffer_size > INT32_MAX - sizeof(allocation_context_t));
+
+    allocator_global_t *g_allocator = allocator_global_t_get();
+    k4a_result_t result = K4A_RESULT_SUCCEEDED;
+
+    rwlock_acquire_write(&g_allocator->lock);
+
+    allocator_pool_t *pool = g_allocator->pool[source];
+    if (pool != NULL)
+    {
+        rwlock_acquire_write(&pool->lock);
+        if (pool->buffer_size == 0)
+        {
+            pool->buffer_size = buffer_size + sizeof(allocation_context_t);
+        }
+        else if (pool->buffer_size < buffer_size + sizeof(allocation_context_t))
+        {
+            LOG_WARNING("Pool buffers of %zu bytes are too small for %zu byte frames, they will not be used",
+                        pool->buffer_size - sizeof(allocation_context_t),
+                        buffer_size);
+        }
+        result = TRACE_CALL(allocator_pool_fill(g_allocator, pool));
+        rwlock_release_write(&pool->lock);
+    }
+
+    rwlock_release_write(&g_allocator->lock);
+
+    return result;
+}
+
+void allocator_pool_disable(allocation_source_t source)
+{
+    RETURN_VALUE_IF_ARG(VOID_VALUE, source < ALLOCATION_SOURCE_USER || source > ALLOCATION_SOURCE_USB_IMU);
+
+    allocator_global_t *g_allocator = allocator_global_t_get();
+
+    rwlock_acquire_write(&g_allocator->lock);
+    allocator_pool_t *pool = g_allocator->pool[source];
+    if (pool != NULL)
+    {
+        pool->enable_count--;
+        if (pool->enable_count == 0)
+        {
+            g_allocator->pool[source] = NULL;
+        }
+        else
+        {
+            pool = NULL;
+        }
+    }
+    rwlock_release_write(&g_allocator->lock);
+
+    if (pool != NULL)
+    {
+        // Buffers still held by the application are released when they are returned
+        rwlock_acquire_write(&pool->lock);
+        pool->detached = true;
+        bool destroy = pool->in_use_count == 0;
+        rwlock_release_write(&pool->lock);
+
+        if (destroy)
+        {
+            allocator_pool_destroy(pool);
+        }
+    }
+}
+
 long allocator_test_for_leaks(void)
 {
     if (g_allocator_sessions != 0)
@@ -290,6 +767,72 @@ long allocator_test_for_leaks(void)
            g_allocated_image_count_imu + g_allocated_image_count_usb_depth + g_allocated_image_count_usb_imu;
 }
 
+static void capture_release_loader(capture_image_loader_t *loader)
+{
+    capture_image_loader_t released = *loader;
+    memset(loader, 0, sizeof(*loader));
+    if (released.load_cb != NULL && released.release_cb != NULL)
+    {
+        released.release_cb(released.context);
+    }
+}
+
+// Runs the loader of an empty image slot the first time the image is requested. The loader runs with the write lock
+// held so that concurrent getters wait for the image instead of loading it twice.
+static void capture_load_image(capture_context_t *capture, image_type_index_t type)
+{
+    rwlock_acquire_read(&capture->lock);
+    bool pending = capture->loader[type].load_cb != NULL;
+    rwlock_release_read(&capture->lock);
+    if (!pending)
+    {
+        return;
+    }
+
+    rwlock_acquire_write(&capture->lock);
+    capture_image_loader_t *loader = &capture->loader[type];
+    if (loader->load_cb != NULL)
+    {
+        k4a_image_t image_handle = NULL;
+        if (K4A_SUCCEEDED(TRACE_CALL(loader->load_cb(loader->context, &image_handle))))
+        {
+            // The capture takes over the reference returned by the loader
+            capture->image[type] = image_handle;
+        }
+        else if (image_handle != NULL)
+        {
+            image_dec_ref(image_handle);
+        }
+        capture_release_loader(loader);
+    }
+    rwlock_release_write(&capture->lock);
+}
+
+static k4a_result_t capture_set_image_loader(k4a_capture_t capture_handle,
+                                             image_type_index_t type,
+                                             k4a_capture_image_load_cb_t *load_cb,
+                                             k4a_capture_image_loader_release_cb_t *release_cb,
+                                             void *loader_context)
+{
+    RETURN_VALUE_IF_HANDLE_INVALID(K4A_RESULT_FAILED, k4a_capture_t, capture_handle);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, load_cb == NULL);
+
+    capture_context_t *capture = k4a_capture_t_get_context(capture_handle);
+
+    rwlock_acquire_write(&capture->lock);
+    if (capture->image[type])
+    {
+        image_dec_ref(capture->image[type]); // drop the image that was here
+        capture->image[type] = NULL;
+    }
+    capture_release_loader(&capture->loader[type]);
+    capture->loader[type].load_cb = load_cb;
+    capture->loader[type].release_cb = release_cb;
+    capture->loader[type].context = loader_context;
+    rwlock_release_write(&capture->lock);
+    return K4A_RESULT_SUCCEEDED;
+}
+
 void capture_dec_ref(k4a_capture_t capture_handle)
 {
     RETURN_VALUE_IF_HANDLE_INVALID(VOID_VALUE, k4a_capture_t, capture_handle);
@@ -307,6 +850,7 @@ void capture_dec_ref(k4a_capture_t capture_handle)
             {
                 image_dec_ref(capture->image[x]);
             }
+            capture_release_loader(&capture->loader[x]);
         }
         rwlock_release_write(&capture->lock);
         rwlock_deinit(&capture->lock);
@@ -344,6 +888,7 @@ k4a_image_t capture_get_color_image(k4a_capture_t capture_handle)
     RETURN_VALUE_IF_HANDLE_INVALID(NULL, k4a_capture_t, capture_handle);
 
     capture_context_t *capture = k4a_capture_t_get_context(capture_handle);
+    capture_load_image(capture, IMAGE_TYPE_COLOR);
 
     rwlock_acquire_read(&capture->lock);
     k4a_image_t *image = &capture->image[IMAGE_TYPE_COLOR];
@@ -359,6 +904,7 @@ k4a_image_t capture_get_depth_image(k4a_capture_t capture_handle)
     RETURN_VALUE_IF_HANDLE_INVALID(NULL, k4a_capture_t, capture_handle);
 
     capture_context_t *capture = k4a_capture_t_get_context(capture_handle);
+    capture_load_image(capture, IMAGE_TYPE_DEPTH);
 
     rwlock_acquire_read(&capture->lock);
     k4a_image_t *image = &capture->image[IMAGE_TYPE_DEPTH];
@@ -375,6 +921,7 @@ k4a_image_t capture_get_ir_image(k4a_capture_t capture_handle)
     RETURN_VALUE_IF_HANDLE_INVALID(NULL, k4a_capture_t, capture_handle);
 
     capture_context_t *capture = k4a_capture_t_get_context(capture_handle);
+    capture_load_image(capture, IMAGE_TYPE_IR);
 
     rwlock_acquire_read(&capture->lock);
     k4a_image_t *image = &capture->image[IMAGE_TYPE_IR];
@@ -388,8 +935,20 @@ k4a_image_t capture_get_ir_image(k4a_capture_t capture_handle)
 
 k4a_image_t capture_get_imu_image(k4a_capture_t capture_handle)
 {
-    // We just reuse the ir image location as this is never exposed to the user or combined with ir/color/depth.
-    return capture_get_ir_image(capture_handle);
+    RETURN_VALUE_IF_HANDLE_INVALID(NULL, k4a_capture_t, capture_handle);
+
+    // We just reuse the ir image location as this is never exposed to the user or combined with ir/color/depth. IMU
+    // images are never loaded lazily, so an IR image loader is not run.
+    capture_context_t *capture = k4a_capture_t_get_context(capture_handle);
+
+    rwlock_acquire_read(&capture->lock);
+    k4a_image_t *image = &capture->image[IMAGE_TYPE_IR];
+    if (*image)
+    {
+        image_inc_ref(*image);
+    }
+    rwlock_release_read(&capture->lock);
+    return *image;
 }
 
 void capture_set_color_image(k4a_capture_t capture_handle, k4a_image_t image_handle)
@@ -404,6 +963,7 @@ void capture_set_color_image(k4a_capture_t capture_handle, k4a_image_t image_han
     {
         image_dec_ref(*image); // drop the image that was here
     }
+    capture_release_loader(&capture->loader[IMAGE_TYPE_COLOR]);
     *image = image_handle;
     if (image_handle != NULL)
     {
@@ -423,6 +983,7 @@ void capture_set_depth_image(k4a_capture_t capture_handle, k4a_image_t image_han
     {
         image_dec_ref(*image); // drop the image that was here
     }
+    capture_release_loader(&capture->loader[IMAGE_TYPE_DEPTH]);
     *image = image_handle;
     if (image_handle != NULL)
     {
@@ -441,6 +1002,7 @@ void capture_set_ir_image(k4a_capture_t capture_handle, k4a_image_t image_handle
     {
         image_dec_ref(*image); // drop the image that was here
     }
+    capture_release_loader(&capture->loader[IMAGE_TYPE_IR]);
     *image = image_handle;
     if (image_handle != NULL)
     {
@@ -448,10 +1010,51 @@ void capture_set_ir_image(k4a_capture_t capture_handle, k4a_image_t image_handle
     }
     rwlock_release_write(&capture->lock);
 }
+
+k4a_result_t capture_set_color_image_loader(k4a_capture_t capture_handle,
+                                            k4a_capture_image_load_cb_t *load_cb,
+                                            k4a_capture_image_loader_release_cb_t *release_cb,
+                                            void *loader_context)
+{
+    return capture_set_image_loader(capture_handle, IMAGE_TYPE_COLOR, load_cb, release_cb, loader_context);
+}
+
+k4a_result_t capture_set_depth_image_loader(k4a_capture_t capture_handle,
+                                            k4a_capture_image_load_cb_t *load_cb,
+                                            k4a_capture_image_loader_release_cb_t *release_cb,
+                                            void *loader_context)
+{
+    return capture_set_image_loader(capture_handle, IMAGE_TYPE_DEPTH, load_cb, release_cb, loader_context);
+}
+
+k4a_result_t capture_set_ir_image_loader(k4a_capture_t capture_handle,
+                                         k4a_capture_image_load_cb_t *load_cb,
+                                         k4a_capture_image_loader_release_cb_t *release_cb,
+                                         void *loader_context)
+{
+    return capture_set_image_loader(capture_handle, IMAGE_TYPE_IR, load_cb, release_cb, loader_context);
+}
+
 void capture_set_imu_image(k4a_capture_t capture_handle, k4a_image_t image_handle)
 {
-    // We just reuse the ir image location as this is never exposed to the user.
-    capture_set_ir_image(capture_handle, image_handle);
+    RETURN_VALUE_IF_HANDLE_INVALID(VOID_VALUE, k4a_capture_t, capture_handle);
+
+    // We just reuse the ir image location as this is never exposed to the user. Any IR image loader is released so that
+    // it can not replace the IMU image later.
+    capture_context_t *capture = k4a_capture_t_get_context(capture_handle);
+    rwlock_acquire_write(&capture->lock);
+    k4a_image_t *image = &capture->image[IMAGE_TYPE_IR];
+    if (*image)
+    {
+        image_dec_ref(*image); // drop the image that was here
+    }
+    capture_release_loader(&capture->loader[IMAGE_TYPE_IR]);
+    *image = image_handle;
+    if (image_handle != NULL)
+    {
+        image_inc_ref(*image);
+    }
+    rwlock_release_write(&capture->lock);
 }
 
 void capture_set_temperature_c(k4a_capture_t capture_handle, float temperature_c)
@@ -6,19 +6,36 @@
 
 // Dependent libraries
 #include <k4ainternal/common.h>
+#include <k4ainternal/global.h>
+#include <k4ainternal/logging.h>
+#include <k4ainternal/rwlock.h>
+#include <azure_c_shared_utility/envvariable.h>
 #include <cJSON.h>
 #include <locale.h> //cJSON.h need this set correctly.
 
 // System dependencies
 #include <stdlib.h>
+#include <stdio.h>
 #include <string.h>
 #include <stdbool.h>
 #include <assert.h>
+#ifdef _WIN32
+#include <process.h>
+#define calibration_getpid _getpid
+#else
+#include <unistd.h>
+#define calibration_getpid getpid
+#endif
 
 #define READ_RETRY_ALLOC_INCREASE (5 * 1024)
 #define READ_RETRY_BASE_ALLOCATION (10 * 1024)
 #define MAX_READ_RETRIES (10)
 
+#define CALIBRATION_CACHE_MAGIC (0x4C43344B) // "K4CL"
+#define CALIBRATION_CACHE_FORMAT_VERSION (1)
+#define CALIBRATION_CACHE_EXTENSION ".k4acal"
+#define CALIBRATION_CACHE_MAX_JSON_SIZE (1024 * 1024)
+
 typedef struct _INTRINSIC_TYPE_TO_STRING_MAPPER
 {
     k4a_calibration_model_type_t type_e;
@@ -31,10 +48,43 @@ static intrinsic_type_to_string_mapper_t intrinsic_type_mapper[] =
       { K4A_CALIBRATION_LENS_DISTORTION_MODEL_RATIONAL_6KT, "CALIBRATION_LensDistortionModelRational6KT" },
       { K4A_CALIBRATION_LENS_DISTORTION_MODEL_BROWN_CONRADY, "CALIBRATION_LensDistortionModelBrownConrady" } };
 
+// Header of a calibration cache file, followed by json_size bytes of raw calibration. The file is only valid for
+// builds with the same structure layout, which header_size and format_version guard.
+typedef struct _calibration_cache_header_t
+{
+    uint32_t magic;
+    uint32_t format_version;
+    uint32_t header_size;
+    uint32_t crc; // CRC-32 of the header with crc set to 0, followed by the raw calibration
+
+    depthmcu_firmware_versions_t firmware_versions;
+    k4a_calibration_camera_t depth_calibration;
+    k4a_calibration_camera_t color_calibration;
+    k4a_calibration_imu_t gyro_calibration;
+    k4a_calibration_imu_t accel_calibration;
+    uint64_t json_size;
+} calibration_cache_header_t;
+
+typedef struct _calibration_global_t
+{
+    k4a_rwlock_t lock;
+    char *cache_directory; // NULL unless set by calibration_set_cache_directory()
+} calibration_global_t;
+
+static void calibration_global_init(calibration_global_t *g_calibration)
+{
+    rwlock_init(&g_calibration->lock);
+}
+
+K4A_DECLARE_GLOBAL(calibration_global_t, calibration_global_init);
+
 typedef struct _calibration_context_t
 {
     depthmcu_t depthmcu;
 
+    bool firmware_versions_valid;
+    depthmcu_firmware_versions_t firmware_versions;
+
     size_t json_size;
     char *json; // string representation of JSON file
 
@@ -584,10 +634,205 @@ static k4a_result_t read_extrinsic_calibration(calibration_context_t *calibratio
     return result;
 }
 
+static uint32_t calibration_cache_crc(uint32_t crc, const void *data, size_t size)
+{
+    const uint8_t *bytes = (const uint8_t *)data;
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++)
+    {
+        crc ^= bytes[i];
+        for (int bit = 0; bit < 8; bit++)
+        {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+static uint32_t calibration_cache_header_crc(const calibration_cache_header_t *header, const char *json)
+{
+    calibration_cache_header_t crc_header = *header;
+    crc_header.crc = 0;
+    uint32_t crc = calibration_cache_crc(0, &crc_header, sizeof(crc_header));
+    return calibration_cache_crc(crc, json, (size_t)header->json_size);
+}
+
+// Returns the path of the cache file for the device, or NULL if the cache is disabled. The caller must free the path.
+static char *calibration_cache_get_path(depthmcu_t depthmcu)
+{
+    calibration_global_t *g_calibration = calibration_global_t_get();
+    char serial_number[MAX_SERIAL_NUMBER_LENGTH];
+    size_t serial_number_size = sizeof(serial_number);
+    char *directory = NULL;
+    char *path = NULL;
+
+    // Copy the directory so that the lock is not held while the serial number is read from the device
+    rwlock_acquire_read(&g_calibration->lock);
+    const char *configured_directory = g_calibration->cache_directory;
+    if (configured_directory == NULL)
+    {
+        configured_directory = environment_get_variable("K4A_CALIBRATION_CACHE_DIR");
+    }
+
+    if (configured_directory != NULL && configured_directory[0] != '\0')
+    {
+        size_t directory_size = strlen(configured_directory) + 1;
+        directory = (char *)malloc(directory_size);
+        if (directory != NULL)
+        {
+            memcpy(directory, configured_directory, directory_size);
+        }
+    }
+    rwlock_release_read(&g_calibration->lock);
+
+    if (directory != NULL &&
+        depthmcu_get_serialnum(depthmcu, serial_number, &serial_number_size) == K4A_BUFFER_RESULT_SUCCEEDED)
+    {
+        size_t path_size = strlen(directory) + 1 + strlen(serial_number) + sizeof(CALIBRATION_CACHE_EXTENSION);
+        path = (char *)malloc(path_size);
+        if (path != NULL)
+        {
+            snprintf(path, path_size, "%s/%s%s", directory, serial_number, CALIBRATION_CACHE_EXTENSION);
+        }
+    }
+    free(directory);
+
+    return path;
+}
+
+// Loads the calibration from the cache file if it is intact and was written for the same firmware versions
+static bool calibration_cache_load(calibration_context_t *calibration, const char *path)
+{
+    calibration_cache_header_t header;
+    char *json = NULL;
+    bool loaded = false;
+
+    FILE *file = fopen(path, "rb");
+    if (file == NULL)
+    {
+        return false;
+    }
+
+    if (fread(&header, sizeof(header), 1, file) == 1 && header.magic == CALIBRATION_CACHE_MAGIC &&
+        header.format_version == CALIBRATION_CACHE_FORMAT_VERSION && header.header_size == sizeof(header) &&
+        memcmp(&header.firmware_versions, &calibration->firmware_versions, sizeof(header.firmware_versions)) == 0 &&
+        header.json_size > 0 && header.json_size <= CALIBRATION_CACHE_MAX_JSON_SIZE)
+    {
+        json = (char *)malloc((size_t)header.json_size);
+        if (json != NULL && fread(json, (size_t)header.json_size, 1, file) == 1 &&
+            json[header.json_size - 1] == '\0' && calibration_cache_header_crc(&header, json) == header.crc)
+        {
+            loaded = true;
+        }
+    }
+    fclose(file);
+
+    if (loaded)
+    {
+        calibration->json = json;
+        calibration->json_size = (size_t)header.json_size;
+        calibration->depth_calibration = header.depth_calibration;
+        calibration->color_calibration = header.color_calibration;
+        calibration->gyro_calibration = header.gyro_calibration;
+        calibration->accel_calibration = header.accel_calibration;
+        LOG_INFO("Loaded calibration from %s", path);
+    }
+    else
+    {
+        LOG_INFO("Calibration cache %s is out of date, reading calibration from the device", path);
+        free(json);
+    }
+
+    return loaded;
+}
+
+// Writes the calibration to the cache file. Failures only mean the next open reads from the device again.
+static void calibration_cache_store(calibration_context_t *calibration, const char *path)
+{
+    calibration_cache_header_t header;
+    memset(&header, 0, sizeof(header));
+    header.magic = CALIBRATION_CACHE_MAGIC;
+    header.format_version = CALIBRATION_CACHE_FORMAT_VERSION;
+    header.header_size = sizeof(header);
+    header.firmware_versions = calibration->firmware_versions;
+    header.depth_calibration = calibration->depth_calibration;
+    header.color_calibration = calibration->color_calibration;
+    header.gyro_calibration = calibration->gyro_calibration;
+    header.accel_calibration = calibration->accel_calibration;
+    header.json_size = calibration->json_size;
+    header.crc = calibration_cache_header_crc(&header, calibration->json);
+
+    // Write to a temporary file and rename it so that a reader never sees a partial file. The name is unique to this
+    // process and handle, so that processes storing the same device at once do not write to the same file.
+    char temp_suffix[64];
+    snprintf(temp_suffix,
+             sizeof(temp_suffix),
+             ".%lu.%p.tmp",
+             (unsigned long)calibration_getpid(),
+             (const void *)calibration);
+    size_t temp_path_size = strlen(path) + strlen(temp_suffix) + 1;
+    char *temp_path = (char *)malloc(temp_path_size);
+    if (temp_path == NULL)
+    {
+        return;
+    }
+    snprintf(temp_path, temp_path_size, "%s%s", path, temp_suffix);
+
+    bool written = false;
+    FILE *file = fopen(temp_path, "wb");
+    if (file != NULL)
+    {
+        written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                  fwrite(calibration->json, calibration->json_size, 1, file) == 1;
+        written = (fclose(file) == 0) && written;
+    }
+
+    if (written)
+    {
+        // rename() does not replace an existing file on Windows
+        (void)remove(path);
+        written = rename(temp_path, path) == 0;
+    }
+
+    if (!written)
+    {
+        LOG_WARNING("Unable to write calibration cache %s", path);
+        (void)remove(temp_path);
+    }
+    free(temp_path);
+}
+
+k4a_result_t calibration_set_cache_directory(const char *directory)
+{
+    calibration_global_t *g_calibration = calibration_global_t_get();
+    char *copy = NULL;
+
+    if (directory != NULL)
+    {
+        size_t size = strlen(directory) + 1;
+        copy = (char *)malloc(size);
+        if (copy == NULL)
+        {
+            return K4A_RESULT_FAILED;
+        }
+        memcpy(copy, directory, size);
+    }
+
+    rwlock_acquire_write(&g_calibration->lock);
+    char *previous = g_calibration->cache_directory;
+    g_calibration->cache_directory = copy;
+    rwlock_release_write(&g_calibration->lock);
+
+    free(previous);
+    return K4A_RESULT_SUCCEEDED;
+}
+
 k4a_result_t calibration_create(depthmcu_t depthmcu, calibration_t *calibration_handle)
 {
     calibration_context_t *calibration;
     k4a_result_t result;
+    char *cache_path = NULL;
+    bool cached = false;
 
     RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, depthmcu == NULL);
     RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, calibration_handle == NULL);
@@ -599,19 +844,43 @@ k4a_result_t calibration_create(depthmcu_t depthmcu, calibration_t *calibration_
     {
         calibration->depthmcu = depthmcu;
 
-        result = read_extrinsic_calibration(calibration);
+        // The cache is keyed by serial number and only used if the firmware versions match, which is a much smaller
+        // read than the calibration itself
+        cache_path = calibration_cache_get_path(depthmcu);
+        if (cache_path != NULL)
+        {
+            calibration->firmware_versions_valid = K4A_SUCCEEDED(
+                TRACE_CALL(depthmcu_get_version(depthmcu, &calibration->firmware_versions)));
+        }
+
+        if (calibration->firmware_versions_valid)
+        {
+            cached = calibration_cache_load(calibration, cache_path);
+        }
     }
 
-    if (K4A_SUCCEEDED(result))
+    if (K4A_SUCCEEDED(result) && !cached)
     {
-        result = calibration_create_from_raw(calibration->json,
-                                             calibration->json_size,
-                                             &calibration->depth_calibration,
-                                             &calibration->color_calibration,
-                                             &calibration->gyro_calibration,
-                                             &calibration->accel_calibration);
+        result = read_extrinsic_calibration(calibration);
+
+        if (K4A_SUCCEEDED(result))
+        {
+            result = calibration_create_from_raw(calibration->json,
+                                                 calibration->json_size,
+                                                 &calibration->depth_calibration,
+                                                 &calibration->color_calibration,
+                                                 &calibration->gyro_calibration,
+                                                 &calibration->accel_calibration);
+        }
+
+        if (K4A_SUCCEEDED(result) && calibration->firmware_versions_valid)
+        {
+            calibration_cache_store(calibration, cache_path);
+        }
     }
 
+    free(cache_path);
+
     if (K4A_FAILED(result) && *calibration_handle != NULL)
     {
         calibration_destroy(*calibration_handle);
@@ -622,6 +891,22 @@ k4a_result_t calibration_create(depthmcu_t depthmcu, calibration_t *calibration_
     return result;
 }
 
+k4a_result_t calibration_get_firmware_versions(calibration_t calibration_handle,
+                                               depthmcu_firmware_versions_t *firmware_versions)
+{
+    RETURN_VALUE_IF_HANDLE_INVALID(K4A_RESULT_FAILED, calibration_t, calibration_handle);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, firmware_versions == NULL);
+
+    calibration_context_t *calibration = calibration_t_get_context(calibration_handle);
+    if (!calibration->firmware_versions_valid)
+    {
+        return K4A_RESULT_FAILED;
+    }
+
+    *firmware_versions = calibration->firmware_versions;
+    return K4A_RESULT_SUCCEEDED;
+}
+
 k4a_result_t calibration_create_from_raw(char *raw_calibration,
                                          size_t raw_calibration_size,
                                          k4a_calibration_camera_t *depth_calibration,
@@ -1045,6 +1045,14 @@ STDMETHODIMP CMFCameraReader::OnReadSample(HRESULT hrStatus,
                     LOG_INFO("Dropping color image due to ts:%lld", pFrameContext->GetPTSTime());
                 }
 
+                if (K4A_SUCCEEDED(result) &&
+                    allocator_should_drop(ALLOCATION_SOURCE_COLOR, pFrameContext->GetFrameSize()))
+                {
+                    // Drop frame to stay within the memory limits
+                    dropped = true;
+                    result = K4A_RESULT_FAILED;
+                }
+
                 if (K4A_SUCCEEDED(result))
                 {
                     if (m_use_mf_buffer)
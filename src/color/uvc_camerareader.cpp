@@ -1194,6 +1194,12 @@ void UVCCameraReader::Callback(uvc_frame_t *frame)
             buffer_size = frame->data_bytes;
         }
 
+        if (allocator_should_drop(ALLOCATION_SOURCE_COLOR, buffer_size))
+        {
+            // Drop frame to stay within the memory limits
+            return;
+        }
+
         // Allocate K4A Color buffer
         buffer = allocator_alloc(ALLOCATION_SOURCE_COLOR, buffer_size);
         k4a_result_t result = K4A_RESULT_FROM_BOOL(buffer != NULL);
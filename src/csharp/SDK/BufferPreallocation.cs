@@ -0,0 +1,31 @@
+﻿//------------------------------------------------------------------------------
+// <copyright file="BufferPreallocation.cs" company="Microsoft">
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+// </copyright>
+//------------------------------------------------------------------------------
+
+namespace Microsoft.Azure.Kinect.Sensor
+{
+    /// <summary>
+    /// Preallocation of the frame buffers used while streaming.
+    /// </summary>
+    [Native.NativeReference("k4a_buffer_preallocation_t")]
+    public enum BufferPreallocation
+    {
+        /// <summary>
+        /// Frame buffers are allocated as frames arrive.
+        /// </summary>
+        None = 0,
+
+        /// <summary>
+        /// Frame buffers are allocated up front, touched so that every page is resident, and recycled while streaming.
+        /// </summary>
+        Prefault,
+
+        /// <summary>
+        /// Frame buffers are preallocated as with <see cref="Prefault"/>, and also locked into physical memory.
+        /// </summary>
+        PrefaultAndLock,
+    }
+}
@@ -436,6 +436,8 @@ namespace Microsoft.Azure.Kinect.Sensor
                     throw new ObjectDisposedException(nameof(Device));
                 }
 
+                AzureKinectStartCamerasException.ThrowIfNotSuccess(() => NativeMethods.k4a_device_set_buffer_preallocation(this.handle, configuration.BufferPreallocation));
+
                 NativeMethods.k4a_device_configuration_t nativeConfig = configuration.GetNativeConfiguration();
                 AzureKinectStartCamerasException.ThrowIfNotSuccess(() => NativeMethods.k4a_device_start_cameras(this.handle, ref nativeConfig));
 
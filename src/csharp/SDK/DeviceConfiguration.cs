@@ -64,6 +64,16 @@ namespace Microsoft.Azure.Kinect.Sensor
         /// </summary>
         public bool DisableStreamingIndicator { get; set; } = false;
 
+        /// <summary>
+        /// Gets or sets whether the frame buffers used while streaming are preallocated.
+        /// </summary>
+        /// <remarks>
+        /// Preallocated buffers are created and prefaulted by <see cref="Device.StartCameras"/> so that the streaming
+        /// path does not take page faults. The setting is applied with k4a_device_set_buffer_preallocation rather than
+        /// through the native configuration structure.
+        /// </remarks>
+        public BufferPreallocation BufferPreallocation { get; set; } = BufferPreallocation.None;
+
         /// <summary>
         /// Get the equivalent native configuration structure.
         /// </summary>
@@ -91,6 +91,56 @@ bool is_fw_version_compatable(const char *fw_type, k4a_version_t *fw_version, k4
     return (fw_version_good);
 }
 
+static void depth_convert_version(const depthmcu_firmware_versions_t *mcu_version, k4a_hardware_version_t *version)
+{
+    version->rgb.major = mcu_version->rgb_major;
+    version->rgb.minor = mcu_version->rgb_minor;
+    version->rgb.iteration = mcu_version->rgb_build;
+
+    version->depth.major = mcu_version->depth_major;
+    version->depth.minor = mcu_version->depth_minor;
+    version->depth.iteration = mcu_version->depth_build;
+
+    version->audio.major = mcu_version->audio_major;
+    version->audio.minor = mcu_version->audio_minor;
+    version->audio.iteration = mcu_version->audio_build;
+
+    version->depth_sensor.major = mcu_version->depth_sensor_cfg_major;
+    version->depth_sensor.minor = mcu_version->depth_sensor_cfg_minor;
+    version->depth_sensor.iteration = 0;
+
+    switch (mcu_version->build_config)
+    {
+    case 0:
+        version->firmware_build = K4A_FIRMWARE_BUILD_RELEASE;
+        break;
+    case 1:
+        version->firmware_build = K4A_FIRMWARE_BUILD_DEBUG;
+        break;
+    default:
+        LOG_WARNING("Hardware reported unknown firmware build: %d", mcu_version->build_config);
+        version->firmware_build = K4A_FIRMWARE_BUILD_DEBUG;
+        break;
+    }
+
+    switch (mcu_version->signature_type)
+    {
+    case 0:
+        version->firmware_signature = K4A_FIRMWARE_SIGNATURE_MSFT;
+        break;
+    case 1:
+        version->firmware_signature = K4A_FIRMWARE_SIGNATURE_TEST;
+        break;
+    case 2:
+        version->firmware_signature = K4A_FIRMWARE_SIGNATURE_UNSIGNED;
+        break;
+    default:
+        LOG_WARNING("Hardware reported unknown signature type: %d", mcu_version->signature_type);
+        version->firmware_signature = K4A_FIRMWARE_SIGNATURE_UNSIGNED;
+        break;
+    }
+}
+
 k4a_result_t depth_create(depthmcu_t depthmcu,
                           calibration_t calibration_handle,
                           depth_cb_streaming_capture_t *capture_ready,
@@ -122,7 +172,16 @@ k4a_result_t depth_create(depthmcu_t depthmcu,
 
     if (K4A_SUCCEEDED(result))
     {
-        result = TRACE_CALL(depth_get_device_version(*depth_handle, &depth->version));
+        // The calibration cache already read the versions to validate the cached calibration
+        depthmcu_firmware_versions_t mcu_version;
+        if (K4A_SUCCEEDED(calibration_get_firmware_versions(calibration_handle, &mcu_version)))
+        {
+            depth_convert_version(&mcu_version, &depth->version);
+        }
+        else
+        {
+            result = TRACE_CALL(depth_get_device_version(*depth_handle, &depth->version));
+        }
     }
 
     if (K4A_SUCCEEDED(result))
@@ -310,52 +369,7 @@ k4a_result_t depth_get_device_version(depth_t depth_handle, k4a_hardware_version
 
     if (K4A_SUCCEEDED(result))
     {
-        version->rgb.major = mcu_version.rgb_major;
-        version->rgb.minor = mcu_version.rgb_minor;
-        version->rgb.iteration = mcu_version.rgb_build;
-
-        version->depth.major = mcu_version.depth_major;
-        version->depth.minor = mcu_version.depth_minor;
-        version->depth.iteration = mcu_version.depth_build;
-
-        version->audio.major = mcu_version.audio_major;
-        version->audio.minor = mcu_version.audio_minor;
-        version->audio.iteration = mcu_version.audio_build;
-
-        version->depth_sensor.major = mcu_version.depth_sensor_cfg_major;
-        version->depth_sensor.minor = mcu_version.depth_sensor_cfg_minor;
-        version->depth_sensor.iteration = 0;
-
-        switch (mcu_version.build_config)
-        {
-        case 0:
-            version->firmware_build = K4A_FIRMWARE_BUILD_RELEASE;
-            break;
-        case 1:
-            version->firmware_build = K4A_FIRMWARE_BUILD_DEBUG;
-            break;
-        default:
-            LOG_WARNING("Hardware reported unknown firmware build: %d", mcu_version.build_config);
-            version->firmware_build = K4A_FIRMWARE_BUILD_DEBUG;
-            break;
-        }
-
-        switch (mcu_version.signature_type)
-        {
-        case 0:
-            version->firmware_signature = K4A_FIRMWARE_SIGNATURE_MSFT;
-            break;
-        case 1:
-            version->firmware_signature = K4A_FIRMWARE_SIGNATURE_TEST;
-            break;
-        case 2:
-            version->firmware_signature = K4A_FIRMWARE_SIGNATURE_UNSIGNED;
-            break;
-        default:
-            LOG_WARNING("Hardware reported unknown signature type: %d", mcu_version.signature_type);
-            version->firmware_signature = K4A_FIRMWARE_SIGNATURE_UNSIGNED;
-            break;
-        }
+        depth_convert_version(&mcu_version, version);
     }
 
     return result;
@@ -166,6 +166,13 @@ static k4a_result_t depth_engine_start_helper(dewrapper_context_t *dewrapper,
         result = K4A_RESULT_FROM_BOOL(0 != *depth_engine_output_buffer_size);
     }
 
+    if (K4A_SUCCEEDED(result))
+    {
+        // Fill any buffer pool set aside for depth frames while dewrapper_start() is still waiting on us, so a failure
+        // to allocate or lock it fails the start instead of the first frame
+        result = TRACE_CALL(allocator_pool_prepare(ALLOCATION_SOURCE_DEPTH, *depth_engine_output_buffer_size));
+    }
+
     return result;
 }
 
@@ -235,6 +242,16 @@ static int depth_engine_thread(void *param)
 
             // Allocate 1 buffer for depth engine to write depth and IR images to
             assert(depth_engine_output_buffer_size != 0);
+            if (allocator_should_drop(ALLOCATION_SOURCE_DEPTH, depth_engine_output_buffer_size))
+            {
+                // Over the memory hard limit; skip this frame rather than fail the stream
+                dropped = true;
+                result = K4A_RESULT_FAILED;
+            }
+        }
+
+        if (K4A_SUCCEEDED(result))
+        {
             capture_byte_ptr = allocator_alloc(ALLOCATION_SOURCE_DEPTH, depth_engine_output_buffer_size);
             if (capture_byte_ptr == NULL)
             {
@@ -358,6 +358,121 @@ k4a_result_t image_create(k4a_image_format_t format,
     return result;
 }
 
+static void image_view_free_function(void *buffer, void *context)
+{
+    (void)buffer;
+    // The view's buffer belongs to the parent, drop the reference taken in image_create_view
+    image_dec_ref((k4a_image_t)context);
+}
+
+k4a_result_t image_create_view(k4a_image_t parent_handle,
+                               k4a_image_format_t format,
+                               int width_pixels,
+                               int height_pixels,
+                               int stride_bytes,
+                               size_t offset_bytes,
+                               k4a_image_t *view_handle)
+{
+    RETURN_VALUE_IF_HANDLE_INVALID(K4A_RESULT_FAILED, k4a_image_t, parent_handle);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, format < K4A_IMAGE_FORMAT_COLOR_MJPG || format > K4A_IMAGE_FORMAT_CUSTOM);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, format == K4A_IMAGE_FORMAT_COLOR_MJPG);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, width_pixels <= 0 || width_pixels > 20000);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, height_pixels <= 0 || height_pixels > 20000);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, stride_bytes < 0);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, view_handle == NULL);
+
+    image_context_t *parent = k4a_image_t_get_context(parent_handle);
+    k4a_result_t result = K4A_RESULT_SUCCEEDED;
+    size_t row_bytes = 0;
+    size_t rows = (size_t)height_pixels;
+
+    *view_handle = NULL;
+
+    if (stride_bytes == 0)
+    {
+        stride_bytes = parent->stride_bytes;
+    }
+
+    switch (format)
+    {
+    case K4A_IMAGE_FORMAT_COLOR_NV12:
+        // The interleaved UV plane follows the Y plane using the same stride
+        row_bytes = (size_t)width_pixels;
+        rows = 3 * (size_t)height_pixels / 2;
+        if (height_pixels % 2 != 0 || width_pixels % 2 != 0)
+        {
+            LOG_ERROR("NV12 requires an even width and height. %d x %d is invalid.", width_pixels, height_pixels);
+            result = K4A_RESULT_FAILED;
+        }
+        break;
+    case K4A_IMAGE_FORMAT_CUSTOM8:
+        row_bytes = (size_t)width_pixels;
+        break;
+    case K4A_IMAGE_FORMAT_DEPTH16:
+    case K4A_IMAGE_FORMAT_IR16:
+    case K4A_IMAGE_FORMAT_CUSTOM16:
+    case K4A_IMAGE_FORMAT_COLOR_YUY2:
+        row_bytes = 2 * (size_t)width_pixels;
+        break;
+    case K4A_IMAGE_FORMAT_COLOR_BGRA32:
+        row_bytes = 4 * (size_t)width_pixels;
+        break;
+    case K4A_IMAGE_FORMAT_CUSTOM:
+    default:
+        // Unknown pixel layout, the view spans whole strides
+        row_bytes = (size_t)stride_bytes;
+        break;
+    }
+
+    if (K4A_SUCCEEDED(result) && (size_t)stride_bytes < row_bytes)
+    {
+        LOG_ERROR("Insufficient stride (%d bytes) to represent image width (%d pixels).", stride_bytes, width_pixels);
+        result = K4A_RESULT_FAILED;
+    }
+
+    // The last row of a view only needs to be wide enough for its pixels, which allows views into the bottom right
+    // corner of an image with padding at the end of each line.
+    size_t view_size = (rows - 1) * (size_t)stride_bytes + row_bytes;
+    if (K4A_SUCCEEDED(result) && (offset_bytes > parent->buffer_size || view_size > parent->buffer_size - offset_bytes))
+    {
+        LOG_ERROR("View of %llu bytes at offset %llu exceeds the parent image size of %llu bytes.",
+                  (unsigned long long)view_size,
+                  (unsigned long long)offset_bytes,
+                  (unsigned long long)parent->buffer_size);
+        result = K4A_RESULT_FAILED;
+    }
+
+    if (K4A_SUCCEEDED(result))
+    {
+        // The view keeps the parent's buffer alive until image_view_free_function runs
+        image_inc_ref(parent_handle);
+        result = TRACE_CALL(image_create_from_buffer(format,
+                                                     width_pixels,
+                                                     height_pixels,
+                                                     stride_bytes,
+                                                     parent->buffer + offset_bytes,
+                                                     view_size,
+                                                     image_view_free_function,
+                                                     parent_handle,
+                                                     view_handle));
+        if (K4A_FAILED(result))
+        {
+            image_dec_ref(parent_handle);
+        }
+    }
+
+    if (K4A_SUCCEEDED(result))
+    {
+        image_context_t *view = k4a_image_t_get_context(*view_handle);
+        view->dev_timestamp_usec = parent->dev_timestamp_usec;
+        view->sys_timestamp_nsec = parent->sys_timestamp_nsec;
+        view->exposure_time_usec = parent->exposure_time_usec;
+        view->metadata = parent->metadata;
+    }
+
+    return result;
+}
+
 void image_dec_ref(k4a_image_t image_handle)
 {
     RETURN_VALUE_IF_HANDLE_INVALID(VOID_VALUE, k4a_image_t, image_handle);
@@ -471,6 +586,26 @@ uint32_t image_get_iso_speed(k4a_image_t image_handle)
     return image->metadata.color.iso_speed;
 }
 
+k4a_result_t image_get_info(k4a_image_t image_handle, k4a_image_info_t *info)
+{
+    RETURN_VALUE_IF_HANDLE_INVALID(K4A_RESULT_FAILED, k4a_image_t, image_handle);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, info == NULL);
+    image_context_t *image = k4a_image_t_get_context(image_handle);
+
+    info->buffer = image->buffer;
+    info->size = image->buffer_size;
+    info->format = image->format;
+    info->width_pixels = image->width_pixels;
+    info->height_pixels = image->height_pixels;
+    info->stride_bytes = image->stride_bytes;
+    info->device_timestamp_usec = image->dev_timestamp_usec;
+    info->system_timestamp_nsec = image->sys_timestamp_nsec;
+    info->exposure_usec = image->exposure_time_usec;
+    info->white_balance = image->metadata.color.white_balance;
+    info->iso_speed = image->metadata.color.iso_speed;
+    return K4A_RESULT_SUCCEEDED;
+}
+
 void image_set_device_timestamp_usec(k4a_image_t image_handle, uint64_t timestamp_usec)
 {
     RETURN_VALUE_IF_HANDLE_INVALID(VOID_VALUE, k4a_image_t, image_handle);
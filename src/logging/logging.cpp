@@ -262,6 +262,23 @@ void logger_deinit(void)
     rwlock_release_write(&g_context->lock);
 }
 
+void logger_log_invalid_handle(const char *szFile,
+                               int line,
+                               const char *szFunction,
+                               const char *szHandleType,
+                               const char *szExpression,
+                               void *pHandleValue)
+{
+    logger_log(K4A_LOG_LEVEL_ERROR,
+               szFile,
+               line,
+               "Invalid argument to %s(). %s (%p) is not a valid handle of type %s",
+               szFunction,
+               szExpression,
+               pHandleValue,
+               szHandleType);
+}
+
 #if defined(__GNUC__) || defined(__clang__)
 // Enable printf type checking in clang and gcc
 __attribute__((__format__ (__printf__, 2, 0)))
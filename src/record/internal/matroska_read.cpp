@@ -5,6 +5,8 @@
 #include <iostream>
 #include <algorithm>
 #include <climits>
+#include <cstdio>
+#include <chrono>
 #include <sstream>
 
 #include <k4a/k4a.h>
@@ -225,7 +227,11 @@ k4a_result_t parse_mkv(k4a_playback_context_t *context)
     if (context->tags_offset > 0)
         RETURN_IF_ERROR(read_offset(context, context->tags, context->tags_offset));
 
+    auto phase_start = std::chrono::steady_clock::now();
     RETURN_IF_ERROR(parse_recording_config(context));
+    context->open_timing.config_usec = elapsed_usec(phase_start);
+
+    phase_start = std::chrono::steady_clock::now();
     RETURN_IF_ERROR(populate_cluster_cache(context));
 
     // Find the last timestamp in the file
@@ -288,6 +294,7 @@ k4a_result_t parse_mkv(k4a_playback_context_t *context)
         }
     }
     LOG_TRACE("Found last file timestamp: %llu", context->last_file_timestamp_ns);
+    context->open_timing.cluster_index_usec = elapsed_usec(phase_start);
 
     return K4A_RESULT_SUCCEEDED;
 }
@@ -948,6 +955,24 @@ track_reader_t *get_track_reader_by_name(k4a_playback_context_t *context, std::s
     return nullptr;
 }
 
+static KaxTag *find_tag(KaxTags *tags, const char *name)
+{
+    std::string search(name);
+    KaxTag *tag = NULL;
+    for (EbmlElement *e : tags->GetElementList())
+    {
+        if (check_element_type(e, &tag))
+        {
+            KaxTagSimple &tagSimple = GetChild<KaxTagSimple>(*tag);
+            if (GetChild<KaxTagName>(tagSimple).GetValueUTF8() == search)
+            {
+                return tag;
+            }
+        }
+    }
+    return NULL;
+}
+
 KaxTag *get_tag(k4a_playback_context_t *context, const char *name)
 {
     RETURN_VALUE_IF_ARG(NULL, context == NULL);
@@ -956,19 +981,7 @@ KaxTag *get_tag(k4a_playback_context_t *context, const char *name)
     // Only search for the tag if the parent element exists
     if (context->tags)
     {
-        std::string search(name);
-        KaxTag *tag = NULL;
-        for (EbmlElement *e : context->tags->GetElementList())
-        {
-            if (check_element_type(e, &tag))
-            {
-                KaxTagSimple &tagSimple = GetChild<KaxTagSimple>(*tag);
-                if (GetChild<KaxTagName>(tagSimple).GetValueUTF8() == search)
-                {
-                    return tag;
-                }
-            }
-        }
+        return find_tag(context->tags.get(), name);
     }
 
     return NULL;
@@ -1388,27 +1401,29 @@ std::shared_ptr<loaded_cluster_t> load_cluster(k4a_playback_context_t *context,
 #if CLUSTER_READ_AHEAD_COUNT
     try
     {
-        // Preload the neighboring clusters immediately
-        cluster_info_t *previous_cluster_info = cluster_info;
-        cluster_info_t *next_cluster_info = cluster_info;
+        auto load_neighbor = [context, cluster_info](size_t distance, bool next) {
+            cluster_info_t *neighbor_info = cluster_info;
+            for (size_t i = 0; i <= distance && neighbor_info != NULL; i++)
+            {
+                neighbor_info = next_cluster(context, neighbor_info, next);
+            }
+            return neighbor_info ? load_cluster_internal(context, neighbor_info) : nullptr;
+        };
+
+        // Preload the neighboring clusters in the direction of the most recent reads immediately. The neighbors in the
+        // other direction are only loaded from disk if playback turns around.
         for (size_t i = 0; i < CLUSTER_READ_AHEAD_COUNT; i++)
         {
-            if (previous_cluster_info != NULL)
+            result->previous_clusters[i] = std::async(std::launch::deferred, load_neighbor, i, false);
+            result->next_clusters[i] = std::async(std::launch::deferred, load_neighbor, i, true);
+            if (context->reverse_reads)
             {
-                previous_cluster_info = next_cluster(context, previous_cluster_info, false);
+                result->previous_clusters[i].wait();
             }
-            if (next_cluster_info != NULL)
+            else
             {
-                next_cluster_info = next_cluster(context, next_cluster_info, true);
+                result->next_clusters[i].wait();
             }
-            result->previous_clusters[i] = std::async(std::launch::deferred, [context, previous_cluster_info] {
-                return previous_cluster_info ? load_cluster_internal(context, previous_cluster_info) : nullptr;
-            });
-            result->next_clusters[i] = std::async(std::launch::deferred, [context, next_cluster_info] {
-                return next_cluster_info ? load_cluster_internal(context, next_cluster_info) : nullptr;
-            });
-            result->previous_clusters[i].wait();
-            result->next_clusters[i].wait();
         }
     }
     catch (std::system_error &e)
@@ -1572,6 +1587,40 @@ std::shared_ptr<block_info_t> find_block(k4a_playback_context_t *context, track_
     return nullptr;
 }
 
+// Returns the element indices of a track's blocks within a loaded cluster, building the cluster's block index on first
+// use. Reading a track in either direction then only visits the blocks of that track.
+static const std::vector<int> &get_block_index(loaded_cluster_t *loaded_cluster, uint64_t track_number)
+{
+    auto track_blocks = loaded_cluster->block_index.find(track_number);
+    if (track_blocks != loaded_cluster->block_index.end())
+    {
+        return track_blocks->second;
+    }
+
+    // Index every track at once, a cluster is usually read by more than one track.
+    if (loaded_cluster->block_index.empty())
+    {
+        KaxCluster *cluster = loaded_cluster->cluster.get();
+        KaxSimpleBlock *simple_block = NULL;
+        KaxBlockGroup *block_group = NULL;
+        for (size_t i = 0; i < cluster->ListSize(); i++)
+        {
+            EbmlElement *element = (*cluster)[(unsigned int)i];
+            if (check_element_type(element, &simple_block))
+            {
+                loaded_cluster->block_index[simple_block->TrackNum()].push_back((int)i);
+            }
+            else if (check_element_type(element, &block_group))
+            {
+                loaded_cluster->block_index[block_group->TrackNumber()].push_back((int)i);
+            }
+        }
+    }
+
+    // Tracks without blocks in this cluster get an empty entry.
+    return loaded_cluster->block_index[track_number];
+}
+
 // Find the next / previous block given a current block. If there is no next block, a block pointing to EOF will be
 // returned, or nullptr if an error occurs.
 std::shared_ptr<block_info_t> next_block(k4a_playback_context_t *context, block_info_t *current, bool next)
@@ -1603,47 +1652,54 @@ std::shared_ptr<block_info_t> next_block(k4a_playback_context_t *context, block_
     std::shared_ptr<loaded_cluster_t> search_cluster = next_block->cluster;
     while (search_cluster != nullptr && search_cluster->cluster != nullptr)
     {
-        // Search through the current cluster for the next valid block.
-        std::vector<EbmlElement *> elements = next_block->cluster->cluster->GetElementList();
-        KaxSimpleBlock *simple_block = NULL;
-        KaxBlockGroup *block_group = NULL;
-        while (next_block->index < (int)elements.size() && next_block->index >= 0)
+        // Look up the next block of this track in the cluster's block index, starting from the current index.
+        KaxCluster *cluster = next_block->cluster->cluster.get();
+        const std::vector<int> &track_blocks = get_block_index(next_block->cluster.get(), search_number);
+        auto found = track_blocks.end();
+        if (next)
+        {
+            // The first block at or after the current index.
+            found = std::lower_bound(track_blocks.begin(), track_blocks.end(), next_block->index);
+        }
+        else
         {
-            // We need to support both SimpleBlocks and BlockGroups, check to see if the current element is either of
-            // these types.
-            next_block->block = NULL;
-            if (check_element_type(elements[(size_t)next_block->index], &simple_block))
+            // The last block at or before the current index.
+            auto after = std::upper_bound(track_blocks.begin(), track_blocks.end(), next_block->index);
+            if (after != track_blocks.begin())
             {
-                if (simple_block->TrackNum() == search_number)
-                {
-                    simple_block->SetParent(*next_block->cluster->cluster);
-                    next_block->block = simple_block;
-                    next_block->block_duration_ns = 0;
-                }
+                found = after - 1;
+            }
+        }
+        if (found != track_blocks.end())
+        {
+            // We need to support both SimpleBlocks and BlockGroups, the index only contains elements of these types.
+            next_block->index = *found;
+            EbmlElement *element = (*cluster)[(unsigned int)next_block->index];
+            KaxSimpleBlock *simple_block = NULL;
+            KaxBlockGroup *block_group = NULL;
+            if (check_element_type(element, &simple_block))
+            {
+                simple_block->SetParent(*cluster);
+                next_block->block = simple_block;
+                next_block->block_duration_ns = 0;
             }
-            else if (check_element_type(elements[(size_t)next_block->index], &block_group))
+            else if (check_element_type(element, &block_group))
             {
-                if (block_group->TrackNumber() == search_number)
+                block_group->SetParent(*cluster);
+                block_group->SetParentTrack(*current->reader->track);
+                next_block->block = &GetChild<KaxBlock>(*block_group);
+                if (!block_group->GetBlockDuration(next_block->block_duration_ns))
                 {
-                    block_group->SetParent(*next_block->cluster->cluster);
-                    block_group->SetParentTrack(*current->reader->track);
-                    next_block->block = &GetChild<KaxBlock>(*block_group);
-                    if (!block_group->GetBlockDuration(next_block->block_duration_ns))
-                    {
-                        next_block->block_duration_ns = 0;
-                    }
+                    next_block->block_duration_ns = 0;
                 }
             }
-            if (next_block->block != NULL)
-            {
-                // We found a valid block for this track, update the timestamp and return it.
-                next_block->timestamp_ns = next_block->block->GlobalTimecode();
-                next_block->sync_timestamp_ns = next_block->timestamp_ns + current->reader->sync_delay_ns;
-                next_block->sub_index = next ? 0 : ((int)next_block->block->NumberFrames() - 1);
 
-                return next_block;
-            }
-            next_block->index += next ? 1 : -1;
+            // We found a valid block for this track, update the timestamp and return it.
+            next_block->timestamp_ns = next_block->block->GlobalTimecode();
+            next_block->sync_timestamp_ns = next_block->timestamp_ns + current->reader->sync_delay_ns;
+            next_block->sub_index = next ? 0 : ((int)next_block->block->NumberFrames() - 1);
+
+            return next_block;
         }
 
         // The next block wasn't found in this cluster, go to the next cluster.
@@ -1671,29 +1727,26 @@ static void free_vector_buffer(void *buffer, void *context)
     delete vector;
 }
 
-// Allocates a new image in the specified format from in_block
-k4a_result_t convert_block_to_image(k4a_playback_context_t *context,
-                                    block_info_t *in_block,
-                                    k4a_image_t *image_out,
-                                    k4a_image_format_t target_format)
+// Allocates a new image in the target format of image_block from its block data
+static k4a_result_t convert_image_block(image_block_t *image_block, k4a_image_t *image_out)
 {
-    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, context == NULL);
-    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, in_block == nullptr);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, image_block == nullptr);
     RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, image_out == nullptr);
-    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, in_block->reader == NULL);
-    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, in_block->block == NULL);
-    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, in_block->block->NumberFrames() != 1);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, image_block->block == NULL);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, image_block->block->NumberFrames() != 1);
 
-    DataBuffer &data_buffer = in_block->block->GetBuffer(0);
+    auto convert_start = std::chrono::steady_clock::now();
+    DataBuffer &data_buffer = image_block->block->GetBuffer(0);
+    k4a_image_format_t target_format = image_block->target_format;
 
     k4a_result_t result = K4A_RESULT_SUCCEEDED;
     std::vector<uint8_t> *buffer = NULL;
-    assert(in_block->reader->width <= INT_MAX);
-    assert(in_block->reader->height <= INT_MAX);
-    assert(in_block->reader->stride <= INT_MAX);
-    int out_width = (int)in_block->reader->width;
-    int out_height = (int)in_block->reader->height;
-    int out_stride = (int)in_block->reader->stride;
+    assert(image_block->width <= INT_MAX);
+    assert(image_block->height <= INT_MAX);
+    assert(image_block->stride <= INT_MAX);
+    int out_width = (int)image_block->width;
+    int out_height = (int)image_block->height;
+    int out_stride = (int)image_block->stride;
     assert(out_height >= 0 && out_width >= 0);
 
     switch (target_format)
@@ -1701,7 +1754,7 @@ k4a_result_t convert_block_to_image(k4a_playback_context_t *context,
     case K4A_IMAGE_FORMAT_DEPTH16:
     case K4A_IMAGE_FORMAT_IR16:
         buffer = new std::vector<uint8_t>(data_buffer.Buffer(), data_buffer.Buffer() + data_buffer.Size());
-        if (in_block->reader->format == K4A_IMAGE_FORMAT_DEPTH16 || in_block->reader->format == K4A_IMAGE_FORMAT_IR16)
+        if (image_block->format == K4A_IMAGE_FORMAT_DEPTH16 || image_block->format == K4A_IMAGE_FORMAT_IR16)
         {
             // 16 bit grayscale needs to be converted from big-endian back to little-endian.
             assert(buffer->size() % sizeof(uint16_t) == 0);
@@ -1712,14 +1765,14 @@ k4a_result_t convert_block_to_image(k4a_playback_context_t *context,
                 buffer_raw[i] = swap_bytes_16(buffer_raw[i]);
             }
         }
-        else if (in_block->reader->format == K4A_IMAGE_FORMAT_COLOR_YUY2)
+        else if (image_block->format == K4A_IMAGE_FORMAT_COLOR_YUY2)
         {
             // For backward compatibility with early recordings, the YUY2 format was used. The actual data buffer is
             // 16-bit little-endian, so we can just use the buffer as-is.
         }
         else
         {
-            LOG_ERROR("Unsupported image format conversion: %d to %d", in_block->reader->format, target_format);
+            LOG_ERROR("Unsupported image format conversion: %d to %d", image_block->format, target_format);
             result = K4A_RESULT_FAILED;
         }
         break;
@@ -1727,7 +1780,7 @@ k4a_result_t convert_block_to_image(k4a_playback_context_t *context,
     case K4A_IMAGE_FORMAT_COLOR_NV12:
     case K4A_IMAGE_FORMAT_COLOR_YUY2:
     case K4A_IMAGE_FORMAT_COLOR_BGRA32:
-        if (in_block->reader->format == target_format)
+        if (image_block->format == target_format)
         {
             // No format conversion is required, just copy the buffer.
             buffer = new std::vector<uint8_t>(data_buffer.Buffer(), data_buffer.Buffer() + data_buffer.Size());
@@ -1738,7 +1791,7 @@ k4a_result_t convert_block_to_image(k4a_playback_context_t *context,
             out_stride = out_width * 4 * (int)sizeof(uint8_t);
             buffer = new std::vector<uint8_t>((size_t)(out_height * out_stride));
 
-            if (in_block->reader->format == K4A_IMAGE_FORMAT_COLOR_MJPG)
+            if (image_block->format == K4A_IMAGE_FORMAT_COLOR_MJPG)
             {
                 tjhandle turbojpeg_handle = tjInitDecompress();
                 if (tjDecompress2(turbojpeg_handle,
@@ -1756,13 +1809,13 @@ k4a_result_t convert_block_to_image(k4a_playback_context_t *context,
                 }
                 (void)tjDestroy(turbojpeg_handle);
             }
-            else if (in_block->reader->format == K4A_IMAGE_FORMAT_COLOR_NV12)
+            else if (image_block->format == K4A_IMAGE_FORMAT_COLOR_NV12)
             {
                 // The endianness of libyuv's ARGB is opposite our BGRA format. They are the same byte order.
                 if (libyuv::NV12ToARGB(data_buffer.Buffer(),
-                                       (int)in_block->reader->stride,
-                                       data_buffer.Buffer() + (out_height * (int)in_block->reader->stride),
-                                       (int)in_block->reader->stride,
+                                       (int)image_block->stride,
+                                       data_buffer.Buffer() + (out_height * (int)image_block->stride),
+                                       (int)image_block->stride,
                                        buffer->data(),
                                        out_stride,
                                        out_width,
@@ -1772,11 +1825,11 @@ k4a_result_t convert_block_to_image(k4a_playback_context_t *context,
                     result = K4A_RESULT_FAILED;
                 }
             }
-            else if (in_block->reader->format == K4A_IMAGE_FORMAT_COLOR_YUY2)
+            else if (image_block->format == K4A_IMAGE_FORMAT_COLOR_YUY2)
             {
                 // The endianness of libyuv's ARGB is opposite our BGRA format. They are the same byte order.
                 if (libyuv::YUY2ToARGB(data_buffer.Buffer(),
-                                       (int)in_block->reader->stride,
+                                       (int)image_block->stride,
                                        buffer->data(),
                                        out_stride,
                                        out_width,
@@ -1788,7 +1841,7 @@ k4a_result_t convert_block_to_image(k4a_playback_context_t *context,
             }
             else
             {
-                LOG_ERROR("Unsupported image format conversion: %d to %d", in_block->reader->format, target_format);
+                LOG_ERROR("Unsupported image format conversion: %d to %d", image_block->format, target_format);
                 result = K4A_RESULT_FAILED;
             }
 
@@ -1833,7 +1886,7 @@ k4a_result_t convert_block_to_image(k4a_playback_context_t *context,
                 }
                 else
                 {
-                    LOG_ERROR("Unsupported image format conversion: %d to %d", in_block->reader->format, target_format);
+                    LOG_ERROR("Unsupported image format conversion: %d to %d", image_block->format, target_format);
                     result = K4A_RESULT_FAILED;
                 }
 
@@ -1860,9 +1913,7 @@ k4a_result_t convert_block_to_image(k4a_playback_context_t *context,
                                                          &free_vector_buffer,
                                                          buffer,
                                                          image_out));
-        uint64_t device_timestamp_usec = in_block->timestamp_ns / 1000 +
-                                         (uint64_t)context->record_config.start_timestamp_offset_usec;
-        k4a_image_set_device_timestamp_usec(*image_out, device_timestamp_usec);
+        k4a_image_set_device_timestamp_usec(*image_out, image_block->device_timestamp_usec);
     }
 
     if (K4A_FAILED(result) && buffer != NULL)
@@ -1870,6 +1921,103 @@ k4a_result_t convert_block_to_image(k4a_playback_context_t *context,
         delete buffer;
     }
 
+    if (K4A_SUCCEEDED(result) && image_block->stats != nullptr)
+    {
+        auto convert_time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+                                                                                 convert_start);
+        image_block->stats->converted_count++;
+        image_block->stats->convert_time_ns += (uint64_t)convert_time.count();
+    }
+
+    return result;
+}
+
+// Describes the image that in_block converts to, without converting it yet
+static void init_image_block(k4a_playback_context_t *context,
+                             block_info_t *in_block,
+                             k4a_image_format_t target_format,
+                             image_block_t *image_block)
+{
+    image_block->block = in_block->block;
+    image_block->width = in_block->reader->width;
+    image_block->height = in_block->reader->height;
+    image_block->stride = in_block->reader->stride;
+    image_block->format = in_block->reader->format;
+    image_block->target_format = target_format;
+    image_block->device_timestamp_usec = in_block->timestamp_ns / 1000 +
+                                         (uint64_t)context->record_config.start_timestamp_offset_usec;
+    image_block->stats = context->image_stats;
+}
+
+// Allocates a new image in the specified format from in_block
+k4a_result_t convert_block_to_image(k4a_playback_context_t *context,
+                                    block_info_t *in_block,
+                                    k4a_image_t *image_out,
+                                    k4a_image_format_t target_format)
+{
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, context == NULL);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, in_block == nullptr);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, image_out == nullptr);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, in_block->reader == NULL);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, in_block->block == NULL);
+
+    image_block_t image_block;
+    init_image_block(context, in_block, target_format, &image_block);
+    return TRACE_CALL(convert_image_block(&image_block, image_out));
+}
+
+// Called by the capture the first time a lazily loaded image is accessed
+static k4a_result_t load_lazy_image(void *loader_context, k4a_image_t *image_handle)
+{
+    image_block_t *image_block = static_cast<image_block_t *>(loader_context);
+    image_block->loaded = true;
+    return TRACE_CALL(convert_image_block(image_block, image_handle));
+}
+
+// Called by the capture once the lazily loaded image has been accessed, replaced, or the capture is destroyed
+static void release_lazy_image(void *loader_context)
+{
+    image_block_t *image_block = static_cast<image_block_t *>(loader_context);
+    if (!image_block->loaded && image_block->stats != nullptr)
+    {
+        image_block->stats->skipped_count++;
+    }
+    delete image_block;
+}
+
+// Sets an image of capture_handle to be converted from in_block the first time it is accessed
+static k4a_result_t set_lazy_image(k4a_playback_context_t *context,
+                                   block_info_t *in_block,
+                                   k4a_image_format_t target_format,
+                                   k4a_capture_t capture_handle)
+{
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, in_block->cluster == nullptr);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, in_block->block->NumberFrames() != 1);
+
+    image_block_t *image_block = new image_block_t();
+    init_image_block(context, in_block, target_format, image_block);
+    // Only the cluster is kept, not the loaded_cluster_t, so that its read-ahead clusters can be freed.
+    image_block->cluster = in_block->cluster->cluster;
+
+    k4a_result_t result = K4A_RESULT_FAILED;
+    if (in_block->reader == context->color_track)
+    {
+        result = k4a_capture_set_color_image_loader(capture_handle, &load_lazy_image, &release_lazy_image, image_block);
+    }
+    else if (in_block->reader == context->depth_track)
+    {
+        result = k4a_capture_set_depth_image_loader(capture_handle, &load_lazy_image, &release_lazy_image, image_block);
+    }
+    else if (in_block->reader == context->ir_track)
+    {
+        result = k4a_capture_set_ir_image_loader(capture_handle, &load_lazy_image, &release_lazy_image, image_block);
+    }
+
+    if (K4A_FAILED(result))
+    {
+        // The capture only takes ownership of image_block when the loader is set.
+        delete image_block;
+    }
     return result;
 }
 
@@ -1886,6 +2034,22 @@ k4a_result_t new_capture(k4a_playback_context_t *context, block_info_t *block, k
         RETURN_IF_ERROR(k4a_capture_create(capture_handle));
     }
 
+    if (context->lazy_images)
+    {
+        if (block->reader == context->color_track)
+        {
+            return TRACE_CALL(set_lazy_image(context, block, context->color_format_conversion, *capture_handle));
+        }
+        else if (block->reader == context->depth_track)
+        {
+            return TRACE_CALL(set_lazy_image(context, block, K4A_IMAGE_FORMAT_DEPTH16, *capture_handle));
+        }
+        else if (block->reader == context->ir_track)
+        {
+            return TRACE_CALL(set_lazy_image(context, block, K4A_IMAGE_FORMAT_IR16, *capture_handle));
+        }
+    }
+
     k4a_image_t image_handle = NULL;
     k4a_result_t result = K4A_RESULT_SUCCEEDED;
     if (block->reader == context->color_track)
@@ -1920,6 +2084,7 @@ k4a_stream_result_t get_capture(k4a_playback_context_t *context, k4a_capture_t *
 {
     RETURN_VALUE_IF_ARG(K4A_STREAM_RESULT_FAILED, context == NULL);
     RETURN_VALUE_IF_ARG(K4A_STREAM_RESULT_FAILED, capture_handle == NULL);
+    context->reverse_reads = !next; // Read-ahead after a seek follows the direction of reads
 
     track_reader_t *blocks[] = { context->color_track, context->depth_track, context->ir_track };
     std::shared_ptr<block_info_t> next_blocks[arraysize(blocks)];
@@ -2112,6 +2277,7 @@ k4a_stream_result_t get_imu_sample(k4a_playback_context_t *context, k4a_imu_samp
 {
     RETURN_VALUE_IF_ARG(K4A_STREAM_RESULT_FAILED, context == NULL);
     RETURN_VALUE_IF_ARG(K4A_STREAM_RESULT_FAILED, imu_sample == NULL);
+    context->reverse_reads = !next;
 
     if (context->imu_track == NULL)
     {
@@ -2214,6 +2380,36 @@ k4a_stream_result_t get_imu_sample(k4a_playback_context_t *context, k4a_imu_samp
     return K4A_STREAM_RESULT_EOF;
 }
 
+// Takes a data block handle from the playback's pool, or creates a new one if the pool is empty.
+static k4a_playback_data_block_context_t *acquire_data_block(k4a_playback_context_t *context,
+                                                             k4a_playback_data_block_t *data_block_handle)
+{
+    RETURN_VALUE_IF_ARG(nullptr, context->data_block_pool == nullptr);
+
+    k4a_playback_data_block_context_t *data_block_context = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(context->data_block_pool->lock);
+        if (!context->data_block_pool->free_blocks.empty())
+        {
+            *data_block_handle = context->data_block_pool->free_blocks.back();
+            context->data_block_pool->free_blocks.pop_back();
+            data_block_context = k4a_playback_data_block_t_get_context(*data_block_handle);
+        }
+    }
+
+    if (data_block_context == nullptr)
+    {
+        data_block_context = k4a_playback_data_block_t_create(data_block_handle);
+    }
+
+    if (data_block_context != nullptr)
+    {
+        data_block_context->pool = context->data_block_pool;
+        data_block_context->in_pool = false;
+    }
+    return data_block_context;
+}
+
 k4a_stream_result_t get_data_block(k4a_playback_context_t *context,
                                    track_reader_t *track_reader,
                                    k4a_playback_data_block_t *data_block_handle,
@@ -2222,6 +2418,7 @@ k4a_stream_result_t get_data_block(k4a_playback_context_t *context,
     RETURN_VALUE_IF_ARG(K4A_STREAM_RESULT_FAILED, context == NULL);
     RETURN_VALUE_IF_ARG(K4A_STREAM_RESULT_FAILED, track_reader == NULL);
     RETURN_VALUE_IF_ARG(K4A_STREAM_RESULT_FAILED, data_block_handle == NULL);
+    context->reverse_reads = !next;
 
     std::shared_ptr<block_info_t> read_block = track_reader->current_block;
     if (read_block == nullptr)
@@ -2253,7 +2450,7 @@ k4a_stream_result_t get_data_block(k4a_playback_context_t *context,
         return K4A_STREAM_RESULT_EOF;
     }
 
-    k4a_playback_data_block_context_t *data_block_context = k4a_playback_data_block_t_create(data_block_handle);
+    k4a_playback_data_block_context_t *data_block_context = acquire_data_block(context, data_block_handle);
     if (data_block_context == nullptr)
     {
         LOG_ERROR("Creating data block failed.", 0);
@@ -2265,9 +2462,926 @@ k4a_stream_result_t get_data_block(k4a_playback_context_t *context,
 
     data_block_context->device_timestamp_usec = estimate_block_timestamp_ns(track_reader->current_block) / 1000 +
                                                 context->record_config.start_timestamp_offset_usec;
-    data_block_context->data_block.assign(data_buffer.Buffer(), data_buffer.Buffer() + data_buffer.Size());
+    if (context->data_block_zero_copy)
+    {
+        // The data buffer is owned by the cluster, which stays loaded for as long as the data block holds onto it.
+        data_block_context->cluster = track_reader->current_block->cluster->cluster;
+        data_block_context->buffer = data_buffer.Buffer();
+    }
+    else
+    {
+        data_block_context->data_block.assign(data_buffer.Buffer(), data_buffer.Buffer() + data_buffer.Size());
+        data_block_context->buffer = data_block_context->data_block.data();
+    }
+    data_block_context->buffer_size = data_buffer.Size();
 
     return K4A_STREAM_RESULT_SUCCEEDED;
 }
 
+void release_data_block(k4a_playback_data_block_t data_block_handle)
+{
+    k4a_playback_data_block_context_t *data_block_context = k4a_playback_data_block_t_get_context(data_block_handle);
+    if (data_block_context == NULL)
+    {
+        return;
+    }
+    if (data_block_context->in_pool)
+    {
+        LOG_ERROR("Data block %p has already been released.", data_block_handle);
+        return;
+    }
+
+    std::shared_ptr<data_block_pool_t> pool = std::move(data_block_context->pool);
+    data_block_context->cluster.reset();
+    data_block_context->buffer = nullptr;
+    data_block_context->buffer_size = 0;
+    data_block_context->device_timestamp_usec = 0;
+
+    if (pool)
+    {
+        std::lock_guard<std::mutex> lock(pool->lock);
+        if (!pool->closed && pool->free_blocks.size() < DATA_BLOCK_POOL_SIZE)
+        {
+            data_block_context->in_pool = true;
+            pool->free_blocks.push_back(data_block_handle);
+            return;
+        }
+    }
+
+    k4a_playback_data_block_t_destroy(data_block_handle);
+}
+
+void close_data_block_pool(k4a_playback_context_t *context)
+{
+    RETURN_VALUE_IF_ARG(VOID_VALUE, context == NULL);
+    if (context->data_block_pool == nullptr)
+    {
+        return;
+    }
+
+    std::vector<k4a_playback_data_block_t> free_blocks;
+    {
+        std::lock_guard<std::mutex> lock(context->data_block_pool->lock);
+        context->data_block_pool->closed = true;
+        free_blocks.swap(context->data_block_pool->free_blocks);
+    }
+
+    for (k4a_playback_data_block_t data_block_handle : free_blocks)
+    {
+        k4a_playback_data_block_t_destroy(data_block_handle);
+    }
+    context->data_block_pool.reset();
+}
+
+// The header of a Block or SimpleBlock element, see the Matroska block structure.
+typedef struct _block_header_t
+{
+    uint64_t track_number = 0;
+    int16_t timecode = 0;       // Relative to the cluster timecode
+    size_t timecode_offset = 0; // Offset of the timecode from the start of the block data
+    uint64_t frame_count = 1;
+    uint64_t size = 0; // Size of the whole element, including the EBML header
+} block_header_t;
+
+// Per-track state while scanning a recording.
+typedef struct _scan_track_t
+{
+    k4a_playback_track_statistics_t *statistics = NULL;
+    uint64_t frame_period_ns = 0;
+    uint64_t start_timestamp_ns = 0;
+    uint64_t end_timestamp_ns = 0;
+    uint64_t max_gap_ns = 0;
+} scan_track_t;
+
+// Reads an EBML variable length integer of up to 8 bytes. Element IDs keep their length marker bits, sizes do not.
+// Returns the length of the integer in bytes, or 0 if it is invalid or longer than size.
+static size_t read_ebml_vint(const uint8_t *data, size_t size, bool keep_marker, uint64_t *value)
+{
+    if (size == 0)
+    {
+        return 0;
+    }
+
+    size_t length = 1;
+    while (length <= 8 && (data[0] & (0x80 >> (length - 1))) == 0)
+    {
+        length++;
+    }
+    if (length > 8 || length > size)
+    {
+        return 0;
+    }
+
+    *value = keep_marker ? data[0] : data[0] & (0xFF >> length);
+    for (size_t i = 1; i < length; i++)
+    {
+        *value = (*value << 8) | data[i];
+    }
+    return length;
+}
+
+// Parses the start of a block's data. The size of the header is not set.
+// Returns false if the block header is invalid or longer than size.
+static bool parse_block_header(const uint8_t *data, size_t size, block_header_t *header)
+{
+    // The track number is an EBML variable length integer of up to 8 bytes, followed by a 16-bit timecode, 1 byte of
+    // flags, and the frame count - 1 if the block is laced.
+    size_t length = read_ebml_vint(data, size, false, &header->track_number);
+    if (length == 0 || length + 3 > size)
+    {
+        return false;
+    }
+    header->timecode_offset = length;
+    header->timecode = (int16_t)((data[length] << 8) | data[length + 1]);
+
+    uint8_t flags = data[length + 2];
+    header->frame_count = 1;
+    if ((flags & 0x06) != 0)
+    {
+        if (length + 4 > size)
+        {
+            return false;
+        }
+        header->frame_count = (uint64_t)data[length + 3] + 1;
+    }
+    return true;
+}
+
+// Reads only the start of a block's data, and leaves the file pointer at the end of the block.
+// Returns false if the block header is invalid or the block extends past the end of the file.
+static bool read_block_header(k4a_playback_context_t *context,
+                              EbmlElement *block,
+                              uint64_t file_size,
+                              block_header_t *header)
+{
+    uint8_t buffer[12];
+    uint64_t data_offset = block->GetElementPosition() + block->HeadSize();
+    size_t buffer_size = (size_t)std::min((uint64_t)block->GetSize(), (uint64_t)sizeof(buffer));
+    header->size = block->HeadSize() + block->GetSize();
+    if (data_offset + block->GetSize() > file_size)
+    {
+        return false;
+    }
+
+    try
+    {
+        assert(data_offset + block->GetSize() <= INT64_MAX);
+        context->ebml_file->setFilePointer((int64_t)data_offset);
+        size_t read_size = context->ebml_file->read(buffer, buffer_size);
+        context->ebml_file->setFilePointer((int64_t)(data_offset + block->GetSize()));
+        if (read_size != buffer_size)
+        {
+            return false;
+        }
+    }
+    catch (std::ios_base::failure &e)
+    {
+        LOG_ERROR("Failed to read block header in recording '%s': %s", context->file_path, e.what());
+        return false;
+    }
+
+    return parse_block_header(buffer, buffer_size, header);
+}
+
+static void scan_block(k4a_playback_context_t *context,
+                       std::map<uint64_t, scan_track_t> &tracks,
+                       k4a_playback_statistics_t *statistics,
+                       uint64_t cluster_timestamp_ns,
+                       const block_header_t &header,
+                       uint64_t block_duration_ns)
+{
+    statistics->block_count++;
+
+    auto itr = tracks.find(header.track_number);
+    if (itr == tracks.end())
+    {
+        statistics->unknown_track_block_count++;
+        return;
+    }
+    scan_track_t &track = itr->second;
+
+    int64_t timestamp_ns = (int64_t)cluster_timestamp_ns + header.timecode * (int64_t)context->timecode_scale;
+    uint64_t start_ns = timestamp_ns > 0 ? (uint64_t)timestamp_ns : 0;
+
+    // Same estimate as estimate_block_timestamp_ns(), the last frame of a batch is at the end of the block duration.
+    uint64_t end_ns = start_ns;
+    if (header.frame_count > 1 && block_duration_ns > 0)
+    {
+        end_ns += block_duration_ns - 1;
+    }
+
+    k4a_playback_track_statistics_t *track_statistics = track.statistics;
+    if (track_statistics->frame_count == 0)
+    {
+        track.start_timestamp_ns = start_ns;
+        track.end_timestamp_ns = end_ns;
+    }
+    else if (start_ns < track.end_timestamp_ns)
+    {
+        track_statistics->out_of_order_count++;
+    }
+    else
+    {
+        uint64_t gap_ns = start_ns - track.end_timestamp_ns;
+        track.max_gap_ns = std::max(track.max_gap_ns, gap_ns);
+        if (track.frame_period_ns > 0 && gap_ns * 2 > track.frame_period_ns * 3)
+        {
+            track_statistics->gap_count++;
+            track_statistics->dropped_frame_estimate += (gap_ns + track.frame_period_ns / 2) / track.frame_period_ns -
+                                                        1;
+        }
+    }
+    track.start_timestamp_ns = std::min(track.start_timestamp_ns, start_ns);
+    track.end_timestamp_ns = std::max(track.end_timestamp_ns, end_ns);
+
+    track_statistics->frame_count += header.frame_count;
+    track_statistics->block_count++;
+    track_statistics->data_size_bytes += header.size;
+}
+
+// Walks the children of a cluster, reading the block headers and skipping everything else.
+// Returns false if the cluster could not be fully parsed.
+static bool scan_cluster(k4a_playback_context_t *context,
+                         KaxCluster *cluster,
+                         std::map<uint64_t, scan_track_t> &tracks,
+                         k4a_playback_statistics_t *statistics)
+{
+    uint64_t cluster_timestamp_ns = 0;
+    auto element = next_child(context, cluster);
+    while (element != nullptr)
+    {
+        EbmlId element_id(*element);
+        if (element_id == KaxClusterTimecode::ClassInfos.GlobalId)
+        {
+            KaxClusterTimecode *cluster_timecode = read_element<KaxClusterTimecode>(context, element.get());
+            if (cluster_timecode == NULL)
+            {
+                return false;
+            }
+            cluster_timestamp_ns = cluster_timecode->GetValue() * context->timecode_scale;
+        }
+        else if (element_id == KaxSimpleBlock::ClassInfos.GlobalId)
+        {
+            block_header_t header;
+            if (!read_block_header(context, element.get(), statistics->file_size_bytes, &header))
+            {
+                return false;
+            }
+            scan_block(context, tracks, statistics, cluster_timestamp_ns, header, 0);
+        }
+        else if (element_id == KaxBlockGroup::ClassInfos.GlobalId)
+        {
+            block_header_t header;
+            bool block_found = false;
+            uint64_t block_duration_ns = 0;
+
+            auto child = next_child(context, element.get());
+            while (child != nullptr)
+            {
+                EbmlId child_id(*child);
+                if (child_id == KaxBlock::ClassInfos.GlobalId)
+                {
+                    if (!read_block_header(context, child.get(), statistics->file_size_bytes, &header))
+                    {
+                        return false;
+                    }
+                    block_found = true;
+                }
+                else if (child_id == KaxBlockDuration::ClassInfos.GlobalId)
+                {
+                    KaxBlockDuration *block_duration = read_element<KaxBlockDuration>(context, child.get());
+                    if (block_duration == NULL)
+                    {
+                        return false;
+                    }
+                    block_duration_ns = block_duration->GetValue() * context->timecode_scale;
+                }
+                else if (K4A_FAILED(skip_element(context, child.get())))
+                {
+                    return false;
+                }
+
+                child = next_child(context, element.get());
+            }
+
+            if (block_found)
+            {
+                scan_block(context, tracks, statistics, cluster_timestamp_ns, header, block_duration_ns);
+            }
+        }
+        else if (K4A_FAILED(skip_element(context, element.get())))
+        {
+            return false;
+        }
+
+        element = next_child(context, cluster);
+    }
+    return true;
+}
+
+// Reads the statistics of every track from the cluster and block headers, without loading any block data.
+// The result is stored in context->scan, later calls return immediately. Must be called with scan_lock held.
+static k4a_result_t scan_recording(k4a_playback_context_t *context)
+{
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, context == NULL);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, context->ebml_file == nullptr);
+
+    if (context->scan)
+    {
+        return K4A_RESULT_SUCCEEDED;
+    }
+
+    std::unique_ptr<recording_scan_t> scan(new recording_scan_t());
+    std::map<uint64_t, scan_track_t> tracks;
+    for (auto &itr : context->track_map)
+    {
+        scan_track_t &track = tracks[GetChild<KaxTrackNumber>(*itr.second.track).GetValue()];
+        track.statistics = &scan->tracks[itr.first];
+        track.frame_period_ns = itr.second.frame_period_ns;
+    }
+
+    try
+    {
+        std::lock_guard<std::mutex> lock(context->io_lock);
+        if (context->file_closing)
+        {
+            // User called k4a_playback_close(), return immediately.
+            return K4A_RESULT_FAILED;
+        }
+
+        LargeFileIOCallback *file_io = dynamic_cast<LargeFileIOCallback *>(context->ebml_file.get());
+        if (file_io != NULL)
+        {
+            file_io->setOwnerThread();
+        }
+
+        context->ebml_file->setFilePointer(0, libebml::seek_end);
+        scan->statistics.file_size_bytes = context->ebml_file->getFilePointer();
+
+        if (K4A_FAILED(seek_offset(context, context->first_cluster_offset)))
+        {
+            LOG_ERROR("Failed to seek to first recording cluster.", 0);
+            return K4A_RESULT_FAILED;
+        }
+
+        std::shared_ptr<KaxCluster> cluster = find_next<KaxCluster>(context, true);
+        while (cluster != nullptr)
+        {
+            scan->statistics.cluster_count++;
+            if (!cluster->IsFiniteSize())
+            {
+                scan->statistics.truncated = true;
+                break;
+            }
+
+            uint64_t cluster_end = cluster->GetElementPosition() + cluster->HeadSize() + cluster->GetSize();
+            if (!scan_cluster(context, cluster.get(), tracks, &scan->statistics) ||
+                cluster_end > scan->statistics.file_size_bytes)
+            {
+                scan->statistics.truncated = true;
+                break;
+            }
+
+            assert(cluster_end <= INT64_MAX);
+            context->ebml_file->setFilePointer((int64_t)cluster_end);
+            cluster = find_next<KaxCluster>(context, true);
+        }
+    }
+    catch (std::ios_base::failure &e)
+    {
+        LOG_ERROR("Failed to scan recording '%s': %s", context->file_path, e.what());
+        return K4A_RESULT_FAILED;
+    }
+    catch (std::system_error &e)
+    {
+        LOG_ERROR("Failed to scan recording: %s", e.what());
+        return K4A_RESULT_FAILED;
+    }
+
+    uint64_t start_offset_usec = context->record_config.start_timestamp_offset_usec;
+    for (auto &itr : tracks)
+    {
+        scan_track_t &track = itr.second;
+        k4a_playback_track_statistics_t *track_statistics = track.statistics;
+        track_statistics->frame_period_usec = track.frame_period_ns / 1000;
+        if (track_statistics->frame_count == 0)
+        {
+            continue;
+        }
+
+        track_statistics->start_timestamp_usec = track.start_timestamp_ns / 1000 + start_offset_usec;
+        track_statistics->end_timestamp_usec = track.end_timestamp_ns / 1000 + start_offset_usec;
+        track_statistics->max_gap_usec = track.max_gap_ns / 1000;
+
+        // Each frame lasts for one frame period, so a track of N frames covers N periods.
+        uint64_t duration_ns = track.end_timestamp_ns - track.start_timestamp_ns + track.frame_period_ns;
+        if (duration_ns > 0)
+        {
+            track_statistics->bitrate_bps = (uint64_t)((double)track_statistics->data_size_bytes * 8 * 1e9 /
+                                                       (double)duration_ns);
+        }
+    }
+
+    context->scan = std::move(scan);
+    return K4A_RESULT_SUCCEEDED;
+}
+
+k4a_result_t get_recording_statistics(k4a_playback_context_t *context, k4a_playback_statistics_t *statistics)
+{
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, context == NULL);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, statistics == NULL);
+
+    std::lock_guard<std::mutex> lock(context->scan_lock);
+    RETURN_IF_ERROR(scan_recording(context));
+    *statistics = context->scan->statistics;
+    return K4A_RESULT_SUCCEEDED;
+}
+
+k4a_result_t get_track_statistics(k4a_playback_context_t *context,
+                                  const std::string &track_name,
+                                  k4a_playback_track_statistics_t *statistics)
+{
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, context == NULL);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, statistics == NULL);
+
+    std::lock_guard<std::mutex> lock(context->scan_lock);
+    RETURN_IF_ERROR(scan_recording(context));
+    auto itr = context->scan->tracks.find(track_name);
+    if (itr == context->scan->tracks.end())
+    {
+        LOG_ERROR("Track name cannot be found: %s", track_name.c_str());
+        return K4A_RESULT_FAILED;
+    }
+    *statistics = itr->second;
+    return K4A_RESULT_SUCCEEDED;
+}
+
+// A block of a cluster being copied by trim_recording().
+typedef struct _trim_block_t
+{
+    size_t offset = 0;          // Offset of the block element in the cluster data
+    size_t size = 0;            // Size of the whole element, including the EBML header
+    size_t timecode_offset = 0; // Offset of the block's relative timecode in the cluster data
+    int16_t timecode = 0;
+    uint64_t track_number = 0;
+    int64_t timestamp_ns = 0;
+} trim_block_t;
+
+// Parses the blocks of a cluster from its data, which starts after the cluster's EBML header.
+// Returns false if the cluster could not be fully parsed.
+static bool parse_trim_cluster(k4a_playback_context_t *context,
+                               const std::vector<uint8_t> &data,
+                               uint64_t *cluster_timestamp_ns,
+                               bool *has_crc,
+                               std::vector<trim_block_t> *blocks)
+{
+    bool timecode_found = false;
+    *has_crc = false;
+    blocks->clear();
+
+    size_t offset = 0;
+    while (offset < data.size())
+    {
+        uint64_t id = 0, size = 0;
+        size_t id_length = read_ebml_vint(&data[offset], data.size() - offset, true, &id);
+        size_t size_length = id_length == 0 ? 0 : read_ebml_vint(&data[offset + id_length],
+                                                                  data.size() - offset - id_length,
+                                                                  false,
+                                                                  &size);
+        size_t payload_offset = offset + id_length + size_length;
+        if (size_length == 0 || size > data.size() - payload_offset)
+        {
+            return false;
+        }
+
+        if (id == KaxClusterTimecode::ClassInfos.GlobalId.GetValue())
+        {
+            uint64_t timecode = 0;
+            for (size_t i = 0; i < size; i++)
+            {
+                timecode = (timecode << 8) | data[payload_offset + i];
+            }
+            *cluster_timestamp_ns = timecode * context->timecode_scale;
+            timecode_found = true;
+        }
+        else if (id == EbmlCrc32::ClassInfos.GlobalId.GetValue())
+        {
+            *has_crc = true;
+        }
+        else if (id == KaxSimpleBlock::ClassInfos.GlobalId.GetValue() ||
+                 id == KaxBlockGroup::ClassInfos.GlobalId.GetValue())
+        {
+            // The block of a block group is one of its children, its other children are kept as they are.
+            size_t block_offset = payload_offset;
+            size_t block_size = (size_t)size;
+            if (id == KaxBlockGroup::ClassInfos.GlobalId.GetValue())
+            {
+                block_size = 0;
+                size_t child_offset = payload_offset;
+                while (child_offset < payload_offset + size)
+                {
+                    uint64_t child_id = 0, child_size = 0;
+                    size_t available = payload_offset + (size_t)size - child_offset;
+                    size_t child_id_length = read_ebml_vint(&data[child_offset], available, true, &child_id);
+                    size_t child_size_length = child_id_length == 0 ?
+                                                   0 :
+                                                   read_ebml_vint(&data[child_offset + child_id_length],
+                                                                  available - child_id_length,
+                                                                  false,
+                                                                  &child_size);
+                    if (child_size_length == 0 || child_size > available - child_id_length - child_size_length)
+                    {
+                        return false;
+                    }
+                    if (child_id == KaxBlock::ClassInfos.GlobalId.GetValue())
+                    {
+                        block_offset = child_offset + child_id_length + child_size_length;
+                        block_size = (size_t)child_size;
+                    }
+                    child_offset += child_id_length + child_size_length + (size_t)child_size;
+                }
+            }
+
+            block_header_t header;
+            if (!timecode_found || !parse_block_header(&data[block_offset], block_size, &header))
+            {
+                return false;
+            }
+
+            trim_block_t block;
+            block.offset = offset;
+            block.size = id_length + size_length + (size_t)size;
+            block.timecode_offset = block_offset + header.timecode_offset;
+            block.timecode = header.timecode;
+            block.track_number = header.track_number;
+            block.timestamp_ns = (int64_t)*cluster_timestamp_ns + header.timecode * (int64_t)context->timecode_scale;
+            blocks->push_back(block);
+        }
+        // Any other element is dropped, their content refers to positions in the source file.
+
+        offset = payload_offset + (size_t)size;
+    }
+    return timecode_found;
+}
+
+// Appends an EBML element ID, which is stored with its length marker bits.
+static void append_ebml_id(std::vector<uint8_t> &buffer, uint32_t id)
+{
+    for (int shift = 24; shift >= 0; shift -= 8)
+    {
+        if ((id >> shift) != 0 || shift == 0)
+        {
+            buffer.push_back((uint8_t)(id >> shift));
+        }
+    }
+}
+
+// Appends an EBML element size using all 8 bytes, the same as the recording writer uses for clusters.
+static void append_ebml_size(std::vector<uint8_t> &buffer, uint64_t size)
+{
+    buffer.push_back(0x01);
+    for (int shift = 48; shift >= 0; shift -= 8)
+    {
+        buffer.push_back((uint8_t)(size >> shift));
+    }
+}
+
+// Copies the clusters of a recording between start_ns and end_ns to a new recording at path. The block data is copied
+// as it is, only the clusters at either end of the range are re-muxed to drop the blocks outside of it. Timestamps in
+// the new recording start at start_ns, and the K4A_START_OFFSET_NS tag is moved forward to keep device timestamps the
+// same.
+k4a_result_t trim_recording(k4a_playback_context_t *context, const char *path, uint64_t start_ns, uint64_t end_ns)
+{
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, context == NULL);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, context->ebml_file == nullptr);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, path == NULL);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, start_ns >= end_ns);
+
+    uint64_t timecode_scale = context->timecode_scale;
+    uint64_t shift_ns = start_ns - start_ns % timecode_scale;
+
+    uint64_t start_offset_ns = 0;
+    KaxTag *start_offset_tag = get_tag(context, "K4A_START_OFFSET_NS");
+    if (start_offset_tag != NULL)
+    {
+        std::istringstream start_offset_str(get_tag_string(start_offset_tag));
+        start_offset_str >> start_offset_ns;
+    }
+    start_offset_ns += shift_ns;
+    if (start_offset_ns / 1000 > UINT32_MAX)
+    {
+        LOG_ERROR("Trimmed recording start offset is too large: %llu ns", start_offset_ns);
+        return K4A_RESULT_FAILED;
+    }
+
+    // Clusters before this one only contain blocks before start_ns.
+    cluster_info_t *first_cluster = find_cluster(context, start_ns);
+    if (first_cluster == NULL)
+    {
+        LOG_ERROR("Failed to find the recording cluster at %llu ns.", start_ns);
+        return K4A_RESULT_FAILED;
+    }
+    uint64_t first_cluster_offset = first_cluster->file_offset;
+
+    // The output file is only created once nothing else can fail before writing to it. From then on, every failure
+    // removes it so that no partial recording is left behind.
+    std::unique_ptr<IOCallback> output;
+    k4a_result_t result = K4A_RESULT_SUCCEEDED;
+    uint64_t copied_count = 0, remuxed_count = 0;
+    try
+    {
+        std::lock_guard<std::mutex> lock(context->io_lock);
+        if (context->file_closing)
+        {
+            // User called k4a_playback_close(), return immediately.
+            return K4A_RESULT_FAILED;
+        }
+
+        LargeFileIOCallback *file_io = dynamic_cast<LargeFileIOCallback *>(context->ebml_file.get());
+        if (file_io != NULL)
+        {
+            file_io->setOwnerThread();
+        }
+
+        if (K4A_FAILED(seek_offset(context, first_cluster_offset)))
+        {
+            LOG_ERROR("Failed to seek to recording cluster.", 0);
+            return K4A_RESULT_FAILED;
+        }
+
+        try
+        {
+            output = make_unique<LargeFileIOCallback>(path, MODE_CREATE);
+        }
+        catch (std::ios_base::failure &e)
+        {
+            LOG_ERROR("Unable to open file '%s': %s", path, e.what());
+            return K4A_RESULT_FAILED;
+        }
+
+        { // Render Ebml header
+            EbmlHead file_head;
+
+            GetChild<EDocType>(file_head).SetValue("matroska");
+            GetChild<EDocTypeVersion>(file_head).SetValue(MATROSKA_VERSION);
+            GetChild<EDocTypeReadVersion>(file_head).SetValue(2);
+
+            file_head.Render(*output, true);
+        }
+
+        KaxSegment segment;
+        segment.WriteHead(*output, 8);
+
+        // Reserve space for the seeking metadata and the segment info, which are written once the clusters are copied.
+        EbmlVoid seek_void;
+        seek_void.SetSize(1024);
+        seek_void.Render(*output);
+        EbmlVoid segment_info_void;
+        segment_info_void.SetSize(256);
+        segment_info_void.Render(*output);
+
+        // Header elements are copied so that the playback handle's own copies are left unchanged.
+        std::unique_ptr<KaxTracks> tracks(static_cast<KaxTracks *>(context->tracks->Clone()));
+        tracks->Render(*output);
+
+        std::unique_ptr<KaxAttachments> attachments;
+        if (context->attachments)
+        {
+            attachments.reset(static_cast<KaxAttachments *>(context->attachments->Clone()));
+            attachments->Render(*output);
+        }
+
+        std::unique_ptr<KaxTags> tags(context->tags ? static_cast<KaxTags *>(context->tags->Clone()) : new KaxTags());
+        {
+            KaxTag *tag = find_tag(tags.get(), "K4A_START_OFFSET_NS");
+            if (tag == NULL)
+            {
+                tag = new KaxTag();
+                tags->PushElement(*tag); // Tag will be freed with the tags.
+                // Force KaxTagTargets element to get rendered since it is a "mandatory" element.
+                GetChild<KaxTagTrackUID>(GetChild<KaxTagTargets>(*tag)).SetValue(0);
+                GetChild<KaxTagName>(GetChild<KaxTagSimple>(*tag)).SetValueUTF8("K4A_START_OFFSET_NS");
+            }
+            std::ostringstream offset_str;
+            offset_str << start_offset_ns;
+            GetChild<KaxTagString>(GetChild<KaxTagSimple>(*tag)).SetValueUTF8(offset_str.str());
+        }
+        tags->Render(*output);
+
+        KaxCues cues;
+        bool cue_added = false;
+        uint64_t last_cue_ns = 0;
+        uint64_t last_timestamp_ns = 0;
+
+        std::vector<uint8_t> cluster_data;
+        std::vector<uint8_t> cluster_head;
+        std::vector<uint8_t> cluster_body;
+        std::vector<trim_block_t> blocks;
+
+        std::unique_ptr<KaxCluster> cluster = find_next<KaxCluster>(context, true);
+        while (cluster != nullptr && K4A_SUCCEEDED(result))
+        {
+            uint64_t data_offset = cluster->GetElementPosition() + cluster->HeadSize();
+            if (!cluster->IsFiniteSize() || cluster->GetSize() > SIZE_MAX)
+            {
+                LOG_ERROR("Failed to read recording cluster at offset %llu.", cluster->GetElementPosition());
+                result = K4A_RESULT_FAILED;
+                break;
+            }
+
+            // The whole cluster is read at once, it is parsed in memory to find the blocks to keep.
+            cluster_data.resize((size_t)cluster->GetSize());
+            assert(data_offset + cluster->GetSize() <= INT64_MAX);
+            context->ebml_file->setFilePointer((int64_t)data_offset);
+            uint64_t cluster_timestamp_ns = 0;
+            bool has_crc = false;
+            if (context->ebml_file->read(cluster_data.data(), cluster_data.size()) != cluster_data.size() ||
+                !parse_trim_cluster(context, cluster_data, &cluster_timestamp_ns, &has_crc, &blocks))
+            {
+                LOG_ERROR("Failed to read recording cluster at offset %llu.", cluster->GetElementPosition());
+                result = K4A_RESULT_FAILED;
+                break;
+            }
+            if (cluster_timestamp_ns >= end_ns)
+            {
+                break;
+            }
+
+            std::vector<trim_block_t> kept_blocks;
+            for (const trim_block_t &block : blocks)
+            {
+                if (block.timestamp_ns >= (int64_t)start_ns && block.timestamp_ns < (int64_t)end_ns)
+                {
+                    kept_blocks.push_back(block);
+                }
+            }
+
+            if (!kept_blocks.empty())
+            {
+                // Clusters entirely within the range keep their timecode, so none of their blocks change. Otherwise
+                // the cluster starts at its first remaining block and the relative timecodes of the blocks are
+                // rewritten.
+                int64_t first_timestamp_ns = kept_blocks[0].timestamp_ns;
+                int64_t end_timestamp_ns = kept_blocks[0].timestamp_ns;
+                for (const trim_block_t &block : kept_blocks)
+                {
+                    first_timestamp_ns = std::min(first_timestamp_ns, block.timestamp_ns);
+                    end_timestamp_ns = std::max(end_timestamp_ns, block.timestamp_ns);
+                }
+                bool copied = kept_blocks.size() == blocks.size() && cluster_timestamp_ns >= shift_ns;
+                uint64_t new_cluster_timestamp_ns = copied ? cluster_timestamp_ns : (uint64_t)first_timestamp_ns;
+
+                cluster_body.clear();
+                append_ebml_id(cluster_body, KaxClusterTimecode::ClassInfos.GlobalId.GetValue());
+                append_ebml_size(cluster_body, sizeof(uint64_t));
+                uint64_t new_timecode = (new_cluster_timestamp_ns - shift_ns) / timecode_scale;
+                for (int shift = 56; shift >= 0; shift -= 8)
+                {
+                    cluster_body.push_back((uint8_t)(new_timecode >> shift));
+                }
+
+                for (const trim_block_t &block : kept_blocks)
+                {
+                    int64_t timecode = (block.timestamp_ns - (int64_t)new_cluster_timestamp_ns) /
+                                       (int64_t)timecode_scale;
+                    if (timecode < INT16_MIN || timecode > INT16_MAX)
+                    {
+                        LOG_ERROR("Block timestamp %lld does not fit in the trimmed cluster.", block.timestamp_ns);
+                        result = K4A_RESULT_FAILED;
+                        break;
+                    }
+                    if (timecode != block.timecode)
+                    {
+                        cluster_data[block.timecode_offset] = (uint8_t)((uint16_t)timecode >> 8);
+                        cluster_data[block.timecode_offset + 1] = (uint8_t)timecode;
+                    }
+                    cluster_body.insert(cluster_body.end(),
+                                        cluster_data.begin() + (ptrdiff_t)block.offset,
+                                        cluster_data.begin() + (ptrdiff_t)(block.offset + block.size));
+                }
+                if (K4A_FAILED(result))
+                {
+                    break;
+                }
+
+                cluster_head.clear();
+                append_ebml_id(cluster_head, KaxCluster::ClassInfos.GlobalId.GetValue());
+                append_ebml_size(cluster_head, cluster_body.size() + (has_crc ? 6 : 0));
+                if (has_crc)
+                {
+                    EbmlCrc32 crc32;
+                    assert(cluster_body.size() <= UINT32_MAX);
+                    crc32.FillCRC32(cluster_body.data(), (uint32)cluster_body.size());
+                    uint32 crc32_value = crc32.GetCrc32();
+                    append_ebml_id(cluster_head, EbmlCrc32::ClassInfos.GlobalId.GetValue());
+                    cluster_head.push_back(0x84);
+                    for (int shift = 0; shift < 32; shift += 8)
+                    {
+                        cluster_head.push_back((uint8_t)(crc32_value >> shift));
+                    }
+                }
+
+                uint64_t cluster_position = output->getFilePointer();
+                output->writeFully(cluster_head.data(), cluster_head.size());
+                output->writeFully(cluster_body.data(), cluster_body.size());
+                if (copied)
+                {
+                    copied_count++;
+                }
+                else
+                {
+                    remuxed_count++;
+                }
+
+                // Add cue entries at a maximum rate specified by CUE_ENTRY_GAP_NS, the same as the recording writer.
+                uint64_t cue_timestamp_ns = new_cluster_timestamp_ns - shift_ns;
+                if (!cue_added || cue_timestamp_ns >= last_cue_ns + CUE_ENTRY_GAP_NS)
+                {
+                    KaxCuePoint &cue_point = AddNewChild<KaxCuePoint>(cues);
+                    GetChild<KaxCueTime>(cue_point).SetValue(new_timecode);
+                    KaxCueTrackPositions &positions = GetChild<KaxCueTrackPositions>(cue_point);
+                    GetChild<KaxCueTrack>(positions).SetValue(kept_blocks[0].track_number);
+                    GetChild<KaxCueClusterPosition>(positions).SetValue(segment.GetRelativePosition(cluster_position));
+                    last_cue_ns = cue_timestamp_ns;
+                    cue_added = true;
+                }
+                last_timestamp_ns = std::max(last_timestamp_ns, (uint64_t)end_timestamp_ns - shift_ns);
+            }
+
+            assert(data_offset + cluster->GetSize() <= INT64_MAX);
+            context->ebml_file->setFilePointer((int64_t)(data_offset + cluster->GetSize()));
+            cluster = find_next<KaxCluster>(context, true);
+        }
+
+        if (K4A_SUCCEEDED(result) && !cue_added)
+        {
+            LOG_ERROR("Recording has no data between %llu ns and %llu ns.", start_ns, end_ns);
+            result = K4A_RESULT_FAILED;
+        }
+
+        if (K4A_SUCCEEDED(result))
+        {
+            cues.Render(*output);
+
+            std::unique_ptr<KaxInfo> segment_info(static_cast<KaxInfo *>(context->segment_info->Clone()));
+            GetChild<KaxDuration>(*segment_info).SetValue((double)(last_timestamp_ns / timecode_scale));
+            segment_info_void.ReplaceWith(*segment_info, *output);
+
+            KaxSeekHead seek_head;
+            seek_head.IndexThis(*segment_info, segment);
+            seek_head.IndexThis(*tracks, segment);
+            if (attachments)
+            {
+                seek_head.IndexThis(*attachments, segment);
+            }
+            seek_head.IndexThis(*tags, segment);
+            seek_head.IndexThis(cues, segment);
+            seek_void.ReplaceWith(seek_head, *output);
+
+            // Update the file segment head to write the final size
+            output->setFilePointer(0, seek_end);
+            uint64 segment_size = output->getFilePointer() - segment.GetElementPosition() - segment.HeadSize();
+            // Segment size can only be set once normally, so force the flag.
+            segment.SetSizeInfinite(true);
+            if (!segment.ForceSize(segment_size))
+            {
+                LOG_ERROR("Failed set file segment size.", 0);
+            }
+            segment.OverwriteHead(*output);
+        }
+
+        output->close();
+    }
+    catch (std::ios_base::failure &e)
+    {
+        LOG_ERROR("Failed to write trimmed recording '%s': %s", path, e.what());
+        result = K4A_RESULT_FAILED;
+    }
+    catch (std::system_error &e)
+    {
+        LOG_ERROR("Failed to trim recording: %s", e.what());
+        result = K4A_RESULT_FAILED;
+    }
+
+    if (K4A_FAILED(result) && output != nullptr)
+    {
+        try
+        {
+            output->close();
+        }
+        catch (std::ios_base::failure &)
+        {
+            // The file is removed anyway
+        }
+        output.reset();
+        if (std::remove(path) != 0)
+        {
+            LOG_WARNING("Failed to remove partial trimmed recording '%s'", path);
+        }
+    }
+
+    LOG_TRACE("Trimmed recording: %llu clusters copied, %llu clusters re-muxed", copied_count, remuxed_count);
+    return result;
+}
+
 } // namespace k4arecord
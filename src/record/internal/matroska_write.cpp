@@ -262,15 +262,15 @@ cluster_t *get_cluster_for_timestamp(k4a_record_context_t *context, uint64_t tim
         // Calculate the new cluster start, aligned to the current cluster length.
         uint64_t time_start_ns = selected_cluster == cluster_end ? context->last_written_timestamp :
                                                                    (*selected_cluster)->time_end_ns;
-        if (time_start_ns + MAX_CLUSTER_LENGTH_NS <= timestamp_ns)
+        if (time_start_ns + context->cluster_length_ns <= timestamp_ns)
         {
             uint64_t diff = timestamp_ns - time_start_ns;
-            time_start_ns += diff - (diff % MAX_CLUSTER_LENGTH_NS);
+            time_start_ns += diff - (diff % context->cluster_length_ns);
         }
 
         cluster_t *new_cluster = new cluster_t;
         new_cluster->time_start_ns = time_start_ns;
-        new_cluster->time_end_ns = time_start_ns + MAX_CLUSTER_LENGTH_NS;
+        new_cluster->time_end_ns = time_start_ns + context->cluster_length_ns;
         assert(new_cluster->time_start_ns <= timestamp_ns && new_cluster->time_end_ns > timestamp_ns);
 
         if (selected_cluster == cluster_end)
@@ -394,9 +394,9 @@ k4a_result_t write_cluster(k4a_record_context_t *context, cluster_t *cluster, ui
         // We only need to write Cue entries for the first track.
         if (first && GetChild<KaxTrackNumber>(*data.second.track->track).GetValue() == 1)
         {
-            // Add cue entries at a maximum rate specified by CUE_ENTRY_GAP_NS so that the index doesn't get too large.
+            // Add cue entries at a maximum rate specified by cue_entry_gap_ns so that the index doesn't get too large.
             if (context->last_cues_entry_ns == 0 ||
-                data.first - context->start_timestamp_offset >= context->last_cues_entry_ns + CUE_ENTRY_GAP_NS)
+                data.first - context->start_timestamp_offset >= context->last_cues_entry_ns + context->cue_entry_gap_ns)
             {
                 context->last_cues_entry_ns = data.first - context->start_timestamp_offset;
                 auto &cues = GetChild<KaxCues>(*context->file_segment);
@@ -455,6 +455,14 @@ static void matroska_writer_thread(k4a_record_context_t *context)
 {
     assert(context->writer_notify);
 
+    // Clusters are only written once they are older than the write delay, so a longer delay than the default moves
+    // the warning threshold out by the same amount. Shorter delays keep the default threshold.
+    uint64_t queue_warning_ns = CLUSTER_WRITE_QUEUE_WARNING_NS;
+    if (context->cluster_write_delay_ns > CLUSTER_WRITE_DELAY_NS)
+    {
+        queue_warning_ns += context->cluster_write_delay_ns - CLUSTER_WRITE_DELAY_NS;
+    }
+
     try
     {
         std::unique_lock<std::mutex> lock(context->writer_lock);
@@ -477,12 +485,12 @@ static void matroska_writer_thread(k4a_record_context_t *context)
                 if (context->most_recent_timestamp >= oldest_cluster->time_end_ns)
                 {
                     uint64_t age = context->most_recent_timestamp - oldest_cluster->time_end_ns;
-                    if (age > CLUSTER_WRITE_DELAY_NS)
+                    if (age > context->cluster_write_delay_ns)
                     {
                         assert(oldest_cluster->time_start_ns >= context->last_written_timestamp);
                         context->pending_clusters.pop_front();
                         context->last_written_timestamp = oldest_cluster->time_end_ns;
-                        if (age > CLUSTER_WRITE_QUEUE_WARNING_NS)
+                        if (age > queue_warning_ns)
                         {
                             LOG_ERROR("Disk write speed is too low, write queue is filling up.", 0);
                         }
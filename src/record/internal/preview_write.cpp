@@ -0,0 +1,487 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include <k4a/k4a.h>
+#include <k4ainternal/matroska_write.h>
+#include <k4ainternal/logging.h>
+
+#include <turbojpeg.h>
+#include <libyuv.h>
+
+using namespace LIBMATROSKA_NAMESPACE;
+
+namespace k4arecord
+{
+typedef struct _preview_buffers_t
+{
+    tjhandle compress_handle;
+    tjhandle decompress_handle;
+    std::vector<uint8_t> color_bgra; // The color image converted to BGRA before it is resized
+    std::vector<uint8_t> frame;      // The BGRA preview frame, with each image side by side
+} preview_buffers_t;
+
+// Depth ranges used to colorize each depth mode, these match the ranges used by k4aviewer.
+static void get_depth_range(k4a_depth_mode_t mode, uint16_t *min_depth, uint16_t *max_depth)
+{
+    switch (mode)
+    {
+    case K4A_DEPTH_MODE_NFOV_2X2BINNED:
+        *min_depth = 500;
+        *max_depth = 5800;
+        break;
+    case K4A_DEPTH_MODE_NFOV_UNBINNED:
+        *min_depth = 500;
+        *max_depth = 4000;
+        break;
+    case K4A_DEPTH_MODE_WFOV_2X2BINNED:
+        *min_depth = 250;
+        *max_depth = 3000;
+        break;
+    case K4A_DEPTH_MODE_WFOV_UNBINNED:
+    default:
+        *min_depth = 250;
+        *max_depth = 2500;
+        break;
+    }
+}
+
+// Maps a depth value to a blue (near) to red (far) gradient. Invalid pixels are black.
+static inline void colorize_depth_pixel(uint16_t depth, uint16_t min_depth, uint16_t max_depth, uint8_t *bgra)
+{
+    uint8_t blue = 0, green = 0, red = 0;
+    if (depth != 0)
+    {
+        uint32_t clamped = std::min(std::max(depth, min_depth), max_depth);
+        // The gradient goes through 4 steps of 255: blue, cyan, green, yellow, red.
+        uint32_t value = (clamped - min_depth) * 1020 / (uint32_t)(max_depth - min_depth);
+        if (value < 255)
+        {
+            blue = 255;
+            green = (uint8_t)value;
+        }
+        else if (value < 510)
+        {
+            blue = (uint8_t)(510 - value);
+            green = 255;
+        }
+        else if (value < 765)
+        {
+            green = 255;
+            red = (uint8_t)(value - 510);
+        }
+        else
+        {
+            green = (uint8_t)(1020 - value);
+            red = 255;
+        }
+    }
+    bgra[0] = blue;
+    bgra[1] = green;
+    bgra[2] = red;
+    bgra[3] = 255;
+}
+
+// Centers a src_width x src_height image in a width x height area without changing its aspect ratio.
+static void fit_image(int src_width,
+                      int src_height,
+                      int width,
+                      int height,
+                      int *x,
+                      int *y,
+                      int *fit_width,
+                      int *fit_height)
+{
+    if ((int64_t)src_width * height > (int64_t)src_height * width)
+    {
+        *fit_width = width;
+        *fit_height = std::max(1, (int)((int64_t)src_height * width / src_width));
+    }
+    else
+    {
+        *fit_width = std::max(1, (int)((int64_t)src_width * height / src_height));
+        *fit_height = height;
+    }
+    *x = (width - *fit_width) / 2;
+    *y = (height - *fit_height) / 2;
+}
+
+static k4a_result_t render_color_image(preview_buffers_t *buffers,
+                                       k4a_image_t image,
+                                       uint8_t *dst,
+                                       int dst_stride,
+                                       int width,
+                                       int height)
+{
+    uint8_t *src = k4a_image_get_buffer(image);
+    size_t src_size = k4a_image_get_size(image);
+    int src_width = k4a_image_get_width_pixels(image);
+    int src_height = k4a_image_get_height_pixels(image);
+    int src_stride = k4a_image_get_stride_bytes(image);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, src == NULL || src_width <= 0 || src_height <= 0);
+
+    k4a_image_format_t format = k4a_image_get_format(image);
+    if (format == K4A_IMAGE_FORMAT_COLOR_MJPG)
+    {
+        // Let libjpeg-turbo do most of the downscaling while decoding, this skips most of the IDCT work.
+        int scaling_factor_count = 0;
+        tjscalingfactor *scaling_factors = tjGetScalingFactors(&scaling_factor_count);
+        int decode_width = src_width;
+        int decode_height = src_height;
+        for (int i = 0; scaling_factors != NULL && i < scaling_factor_count; i++)
+        {
+            int scaled_width = TJSCALED(src_width, scaling_factors[i]);
+            int scaled_height = TJSCALED(src_height, scaling_factors[i]);
+            if (scaled_width >= width && scaled_height >= height && scaled_width < decode_width)
+            {
+                decode_width = scaled_width;
+                decode_height = scaled_height;
+            }
+        }
+
+        buffers->color_bgra.resize((size_t)decode_width * (size_t)decode_height * 4);
+        if (tjDecompress2(buffers->decompress_handle,
+                          src,
+                          (unsigned long)src_size,
+                          buffers->color_bgra.data(),
+                          decode_width,
+                          0, // pitch
+                          decode_height,
+                          TJPF_BGRA,
+                          TJFLAG_FASTDCT | TJFLAG_FASTUPSAMPLE) != 0)
+        {
+            LOG_ERROR("Failed to decompress jpeg image for the preview track.", 0);
+            return K4A_RESULT_FAILED;
+        }
+        src = buffers->color_bgra.data();
+        src_width = decode_width;
+        src_height = decode_height;
+        src_stride = decode_width * 4;
+    }
+    else if (format == K4A_IMAGE_FORMAT_COLOR_NV12 || format == K4A_IMAGE_FORMAT_COLOR_YUY2)
+    {
+        buffers->color_bgra.resize((size_t)src_width * (size_t)src_height * 4);
+        // The endianness of libyuv's ARGB is opposite our BGRA format. They are the same byte order.
+        int convert_result = format == K4A_IMAGE_FORMAT_COLOR_NV12 ?
+                                 libyuv::NV12ToARGB(src,
+                                                    src_stride,
+                                                    src + src_height * src_stride,
+                                                    src_stride,
+                                                    buffers->color_bgra.data(),
+                                                    src_width * 4,
+                                                    src_width,
+                                                    src_height) :
+                                 libyuv::YUY2ToARGB(src,
+                                                    src_stride,
+                                                    buffers->color_bgra.data(),
+                                                    src_width * 4,
+                                                    src_width,
+                                                    src_height);
+        if (convert_result != 0)
+        {
+            LOG_ERROR("Failed to convert color image to BGRA format for the preview track.", 0);
+            return K4A_RESULT_FAILED;
+        }
+        src = buffers->color_bgra.data();
+        src_stride = src_width * 4;
+    }
+    else if (format != K4A_IMAGE_FORMAT_COLOR_BGRA32)
+    {
+        LOG_ERROR("Unsupported color format for the preview track: %d", format);
+        return K4A_RESULT_FAILED;
+    }
+
+    int x, y, fit_width, fit_height;
+    fit_image(src_width, src_height, width, height, &x, &y, &fit_width, &fit_height);
+    if (libyuv::ARGBScale(src,
+                          src_stride,
+                          src_width,
+                          src_height,
+                          dst + y * dst_stride + x * 4,
+                          dst_stride,
+                          fit_width,
+                          fit_height,
+                          libyuv::kFilterBox) != 0)
+    {
+        LOG_ERROR("Failed to scale color image for the preview track.", 0);
+        return K4A_RESULT_FAILED;
+    }
+
+    return K4A_RESULT_SUCCEEDED;
+}
+
+// Depth images are sampled at the preview resolution, only the sampled pixels are read.
+static k4a_result_t
+render_depth_image(k4a_image_t image, k4a_depth_mode_t depth_mode, uint8_t *dst, int dst_stride, int width, int height)
+{
+    const uint8_t *src = k4a_image_get_buffer(image);
+    int src_width = k4a_image_get_width_pixels(image);
+    int src_height = k4a_image_get_height_pixels(image);
+    int src_stride = k4a_image_get_stride_bytes(image);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, src == NULL || src_width <= 0 || src_height <= 0);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, k4a_image_get_format(image) != K4A_IMAGE_FORMAT_DEPTH16);
+
+    uint16_t min_depth, max_depth;
+    get_depth_range(depth_mode, &min_depth, &max_depth);
+
+    int x, y, fit_width, fit_height;
+    fit_image(src_width, src_height, width, height, &x, &y, &fit_width, &fit_height);
+    for (int row = 0; row < fit_height; row++)
+    {
+        const uint16_t *src_row = reinterpret_cast<const uint16_t *>(
+            src + (size_t)((int64_t)row * src_height / fit_height) * (size_t)src_stride);
+        uint8_t *dst_row = dst + (size_t)(y + row) * (size_t)dst_stride + (size_t)x * 4;
+        for (int column = 0; column < fit_width; column++)
+        {
+            uint16_t depth = src_row[(int64_t)column * src_width / fit_width];
+            colorize_depth_pixel(depth, min_depth, max_depth, dst_row + column * 4);
+        }
+    }
+
+    return K4A_RESULT_SUCCEEDED;
+}
+
+static k4a_result_t write_preview_frame(k4a_record_context_t *context,
+                                        preview_buffers_t *buffers,
+                                        k4a_capture_t capture,
+                                        uint64_t timestamp_ns)
+{
+    preview_writer_t *preview = context->preview.get();
+    int width = (int)preview->width;
+    int height = (int)preview->height;
+    int frame_width = width * (int)preview->image_count;
+    int frame_stride = frame_width * 4;
+
+    // Images missing from the capture are left black.
+    buffers->frame.assign((size_t)frame_stride * (size_t)height, 0);
+    uint8_t *image_dst = buffers->frame.data();
+
+    k4a_result_t result = K4A_RESULT_SUCCEEDED;
+    if (context->color_track != nullptr)
+    {
+        k4a_image_t color_image = k4a_capture_get_color_image(capture);
+        if (color_image != NULL)
+        {
+            result = TRACE_CALL(render_color_image(buffers, color_image, image_dst, frame_stride, width, height));
+            k4a_image_release(color_image);
+        }
+        image_dst += width * 4;
+    }
+
+    if (K4A_SUCCEEDED(result) && context->depth_track != nullptr)
+    {
+        k4a_image_t depth_image = k4a_capture_get_depth_image(capture);
+        if (depth_image != NULL)
+        {
+            result = TRACE_CALL(render_depth_image(
+                depth_image, context->device_config.depth_mode, image_dst, frame_stride, width, height));
+            k4a_image_release(depth_image);
+        }
+    }
+
+    unsigned char *jpeg_buffer = NULL;
+    unsigned long jpeg_size = 0;
+    if (K4A_SUCCEEDED(result))
+    {
+        if (tjCompress2(buffers->compress_handle,
+                        buffers->frame.data(),
+                        frame_width,
+                        frame_stride,
+                        height,
+                        TJPF_BGRA,
+                        &jpeg_buffer,
+                        &jpeg_size,
+                        TJSAMP_420,
+                        preview->jpeg_quality,
+                        TJFLAG_FASTDCT) != 0)
+        {
+            LOG_ERROR("Failed to compress preview frame to jpeg.", 0);
+            result = K4A_RESULT_FAILED;
+        }
+    }
+
+    if (K4A_SUCCEEDED(result))
+    {
+        // Create a copy of the jpeg buffer for writing to file.
+        assert(jpeg_size <= UINT32_MAX);
+        DataBuffer *data_buffer = new (std::nothrow) DataBuffer(jpeg_buffer, (uint32)jpeg_size, NULL, true);
+        result = K4A_RESULT_FROM_BOOL(data_buffer != NULL);
+        if (K4A_SUCCEEDED(result))
+        {
+            // This fails if the preview thread fell behind by more than the cluster write delay.
+            result = TRACE_CALL(write_track_data(context, preview->track, timestamp_ns, data_buffer));
+            if (K4A_FAILED(result))
+            {
+                data_buffer->FreeBuffer(*data_buffer);
+                delete data_buffer;
+            }
+        }
+    }
+
+    if (jpeg_buffer != NULL)
+    {
+        tjFree(jpeg_buffer);
+    }
+
+    return result;
+}
+
+static void preview_writer_thread(k4a_record_context_t *context)
+{
+    preview_writer_t *preview = context->preview.get();
+
+    preview_buffers_t buffers;
+    buffers.compress_handle = tjInitCompress();
+    buffers.decompress_handle = tjInitDecompress();
+    if (buffers.compress_handle == NULL || buffers.decompress_handle == NULL)
+    {
+        LOG_ERROR("Failed to initialize libjpeg-turbo, no preview frames will be written.", 0);
+    }
+
+    try
+    {
+        std::unique_lock<std::mutex> lock(preview->lock);
+        while (true)
+        {
+            preview->notify.wait(lock, [preview]() { return preview->stopping || preview->pending_capture != NULL; });
+
+            // Captures queued before stopping are still written, so that the preview covers the whole recording.
+            k4a_capture_t capture = preview->pending_capture;
+            uint64_t timestamp_ns = preview->pending_timestamp_ns;
+            preview->pending_capture = NULL;
+            if (capture == NULL)
+            {
+                break;
+            }
+            lock.unlock();
+
+            auto start = std::chrono::steady_clock::now();
+            if (buffers.compress_handle != NULL && buffers.decompress_handle != NULL)
+            {
+                (void)TRACE_CALL(write_preview_frame(context, &buffers, capture, timestamp_ns));
+            }
+            k4a_capture_release(capture);
+            auto end = std::chrono::steady_clock::now();
+
+            lock.lock();
+            // Stay idle long enough that encoding only uses max_cpu_percent of a single core.
+            preview->next_encode_time = end + (end - start) * (100 - preview->max_cpu_percent) /
+                                                  preview->max_cpu_percent;
+        }
+    }
+    catch (std::system_error &e)
+    {
+        LOG_ERROR("Preview thread threw exception: %s", e.what());
+    }
+
+    if (buffers.compress_handle != NULL)
+    {
+        (void)tjDestroy(buffers.compress_handle);
+    }
+    if (buffers.decompress_handle != NULL)
+    {
+        (void)tjDestroy(buffers.decompress_handle);
+    }
+}
+
+k4a_result_t start_preview_writer_thread(k4a_record_context_t *context)
+{
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, context == NULL);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, context->preview == nullptr);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, context->preview->thread.joinable());
+
+    try
+    {
+        context->preview->stopping = false;
+        context->preview->thread = std::thread(preview_writer_thread, context);
+    }
+    catch (std::system_error &e)
+    {
+        LOG_ERROR("Failed to start recording preview thread: %s", e.what());
+        return K4A_RESULT_FAILED;
+    }
+
+    return K4A_RESULT_SUCCEEDED;
+}
+
+void stop_preview_writer_thread(k4a_record_context_t *context)
+{
+    RETURN_VALUE_IF_ARG(VOID_VALUE, context == NULL);
+    RETURN_VALUE_IF_ARG(VOID_VALUE, context->preview == nullptr);
+    RETURN_VALUE_IF_ARG(VOID_VALUE, !context->preview->thread.joinable());
+
+    preview_writer_t *preview = context->preview.get();
+    try
+    {
+        {
+            std::lock_guard<std::mutex> lock(preview->lock);
+            preview->stopping = true;
+        }
+        preview->notify.notify_one();
+        preview->thread.join();
+    }
+    catch (std::system_error &e)
+    {
+        LOG_ERROR("Failed to stop recording preview thread: %s", e.what());
+    }
+
+    // The thread may have exited early without taking the last capture.
+    if (preview->pending_capture != NULL)
+    {
+        k4a_capture_release(preview->pending_capture);
+        preview->pending_capture = NULL;
+    }
+}
+
+// Called for every capture written to the recording, so this only hands the capture to the preview thread if it is
+// time for a new preview frame and the preview thread is within its CPU budget.
+void queue_preview_capture(k4a_record_context_t *context, k4a_capture_t capture)
+{
+    RETURN_VALUE_IF_ARG(VOID_VALUE, context == NULL);
+    RETURN_VALUE_IF_ARG(VOID_VALUE, context->preview == nullptr);
+    RETURN_VALUE_IF_ARG(VOID_VALUE, capture == NULL);
+
+    preview_writer_t *preview = context->preview.get();
+
+    // Preview frames use the timestamp of the color image, or the depth image if there is no color image.
+    k4a_image_t image = context->color_track != nullptr ? k4a_capture_get_color_image(capture) : NULL;
+    if (image == NULL && context->depth_track != nullptr)
+    {
+        image = k4a_capture_get_depth_image(capture);
+    }
+    if (image == NULL)
+    {
+        return;
+    }
+    uint64_t timestamp_ns = k4a_image_get_device_timestamp_usec(image) * 1000;
+    k4a_image_release(image);
+
+    try
+    {
+        std::lock_guard<std::mutex> lock(preview->lock);
+        if (preview->stopping || timestamp_ns < preview->next_timestamp_ns ||
+            std::chrono::steady_clock::now() < preview->next_encode_time)
+        {
+            return;
+        }
+        assert(preview->pending_capture == NULL);
+
+        k4a_capture_reference(capture);
+        preview->pending_capture = capture;
+        preview->pending_timestamp_ns = timestamp_ns;
+        preview->next_timestamp_ns = timestamp_ns + preview->interval_ns;
+        preview->next_encode_time = std::chrono::steady_clock::time_point::max();
+    }
+    catch (std::system_error &e)
+    {
+        LOG_ERROR("Failed to queue capture for the preview track: %s", e.what());
+        return;
+    }
+
+    preview->notify.notify_one();
+}
+
+} // namespace k4arecord
@@ -1,9 +1,13 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+#include <atomic>
 #include <ctime>
 #include <iostream>
 #include <sstream>
+#include <thread>
+#include <unordered_map>
 
 #include <k4a/k4a.h>
 #include <k4arecord/playback.h>
@@ -19,6 +23,7 @@ k4a_result_t k4a_playback_open(const char *path, k4a_playback_t *playback_handle
     RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, playback_handle == NULL);
     k4a_playback_context_t *context = NULL;
     k4a_result_t result = K4A_RESULT_SUCCEEDED;
+    auto open_start = std::chrono::steady_clock::now();
 
     context = k4a_playback_t_create(playback_handle);
     result = K4A_RESULT_FROM_BOOL(context != NULL);
@@ -32,6 +37,8 @@ k4a_result_t k4a_playback_open(const char *path, k4a_playback_t *playback_handle
         {
             context->ebml_file = make_unique<LargeFileIOCallback>(path, MODE_READ);
             context->stream = make_unique<libebml::EbmlStream>(*context->ebml_file);
+            context->data_block_pool = std::make_shared<data_block_pool_t>();
+            context->image_stats = std::make_shared<image_load_stats_t>();
         }
         catch (std::ios_base::failure &e)
         {
@@ -47,7 +54,11 @@ k4a_result_t k4a_playback_open(const char *path, k4a_playback_t *playback_handle
 
     if (K4A_SUCCEEDED(result))
     {
+        context->open_timing.header_usec = elapsed_usec(open_start) - context->open_timing.config_usec -
+                                           context->open_timing.cluster_index_usec;
+
         // Seek to the first cluster
+        auto phase_start = std::chrono::steady_clock::now();
         cluster_info_t *seek_cluster_info = find_cluster(context, 0);
         if (seek_cluster_info == NULL)
         {
@@ -63,11 +74,13 @@ k4a_result_t k4a_playback_open(const char *path, k4a_playback_t *playback_handle
                 result = K4A_RESULT_FAILED;
             }
         }
+        context->open_timing.first_cluster_usec = elapsed_usec(phase_start);
     }
 
     if (K4A_SUCCEEDED(result))
     {
         reset_seek_pointers(context, 0);
+        context->open_timing.total_usec = elapsed_usec(open_start);
     }
     else
     {
@@ -129,6 +142,36 @@ k4a_buffer_result_t k4a_playback_get_raw_calibration(k4a_playback_t playback_han
     }
 }
 
+// Returns a null terminated copy of the calibration attachment.
+static std::vector<char> read_calibration_attachment(k4a_playback_context_t *context)
+{
+    KaxFileData &file_data = GetChild<KaxFileData>(*context->calibration_attachment);
+    // Attachment is stored in binary, not a string, so null termination is not guaranteed.
+    assert(file_data.GetSize() <= SIZE_MAX);
+    std::vector<char> buffer = std::vector<char>((size_t)file_data.GetSize() + 1);
+    memcpy(&buffer[0], file_data.GetBuffer(), (size_t)file_data.GetSize());
+    buffer[buffer.size() - 1] = '\0';
+    return buffer;
+}
+
+// Parses the calibration attachment read by read_calibration_attachment() into context->device_calibration.
+static k4a_result_t parse_device_calibration(k4a_playback_context_t *context, std::vector<char> &buffer)
+{
+    auto parse_start = std::chrono::steady_clock::now();
+    std::unique_ptr<k4a_calibration_t> calibration = make_unique<k4a_calibration_t>();
+    k4a_result_t result = k4a_calibration_get_from_raw(buffer.data(),
+                                                       buffer.size(),
+                                                       context->record_config.depth_mode,
+                                                       context->record_config.color_resolution,
+                                                       calibration.get());
+    if (K4A_SUCCEEDED(result))
+    {
+        context->device_calibration = std::move(calibration);
+    }
+    context->open_timing.calibration_usec = elapsed_usec(parse_start);
+    return result;
+}
+
 k4a_result_t k4a_playback_get_calibration(k4a_playback_t playback_handle, k4a_calibration_t *calibration)
 {
     RETURN_VALUE_IF_HANDLE_INVALID(K4A_RESULT_FAILED, k4a_playback_t, playback_handle);
@@ -144,21 +187,10 @@ k4a_result_t k4a_playback_get_calibration(k4a_playback_t playback_handle, k4a_ca
 
     if (context->device_calibration == nullptr)
     {
-        context->device_calibration = make_unique<k4a_calibration_t>();
-        KaxFileData &file_data = GetChild<KaxFileData>(*context->calibration_attachment);
-        // Attachment is stored in binary, not a string, so null termination is not guaranteed.
-        assert(file_data.GetSize() <= SIZE_MAX);
-        std::vector<char> buffer = std::vector<char>((size_t)file_data.GetSize() + 1);
-        memcpy(&buffer[0], file_data.GetBuffer(), (size_t)file_data.GetSize());
-        buffer[buffer.size() - 1] = '\0';
-        k4a_result_t result = k4a_calibration_get_from_raw(buffer.data(),
-                                                           buffer.size(),
-                                                           context->record_config.depth_mode,
-                                                           context->record_config.color_resolution,
-                                                           context->device_calibration.get());
+        std::vector<char> buffer = read_calibration_attachment(context);
+        k4a_result_t result = parse_device_calibration(context, buffer);
         if (K4A_FAILED(result))
         {
-            context->device_calibration.reset();
             return result;
         }
     }
@@ -167,6 +199,154 @@ k4a_result_t k4a_playback_get_calibration(k4a_playback_t playback_handle, k4a_ca
     return K4A_RESULT_SUCCEEDED;
 }
 
+// A calibration shared by the recordings opened by k4a_playback_open_multiple() with identical calibration attachments
+// and camera modes.
+typedef struct _shared_calibration_t
+{
+    std::once_flag parse_once;
+    k4a_result_t result = K4A_RESULT_FAILED;
+    k4a_calibration_t calibration;
+    size_t first_index = SIZE_MAX; // Index of the first recording in the list of paths using this calibration
+} shared_calibration_t;
+
+k4a_result_t k4a_playback_open_multiple(const char *const *paths,
+                                        size_t path_count,
+                                        uint32_t thread_count,
+                                        k4a_playback_t *playback_handles,
+                                        size_t *calibration_indices)
+{
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, paths == NULL);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, path_count == 0);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, playback_handles == NULL);
+
+    for (size_t i = 0; i < path_count; i++)
+    {
+        playback_handles[i] = NULL;
+        if (calibration_indices != NULL)
+        {
+            calibration_indices[i] = i;
+        }
+    }
+
+    // Calibrations are looked up by the hash of their attachment, the camera modes are appended because the parsed
+    // calibration depends on them too.
+    std::mutex calibrations_lock; // Locks access to calibrations
+    std::unordered_map<std::string, std::shared_ptr<shared_calibration_t>> calibrations;
+    std::vector<std::shared_ptr<shared_calibration_t>> recording_calibrations(path_count);
+    std::atomic<size_t> next_path(0);
+    std::atomic<size_t> failed_count(0);
+
+    // Each thread takes the next recording that nobody is opening yet.
+    auto open_worker = [&]() {
+        for (size_t i = next_path++; i < path_count; i = next_path++)
+        {
+            if (paths[i] == NULL || K4A_FAILED(k4a_playback_open(paths[i], &playback_handles[i])))
+            {
+                LOG_ERROR("Failed to open recording '%s'", paths[i] == NULL ? "(null)" : paths[i]);
+                failed_count++;
+                continue;
+            }
+
+            k4a_playback_context_t *context = k4a_playback_t_get_context(playback_handles[i]);
+            if (context->calibration_attachment == NULL)
+            {
+                continue;
+            }
+
+            std::vector<char> buffer = read_calibration_attachment(context);
+            std::string key(buffer.data(), buffer.size());
+            key += std::to_string(context->record_config.depth_mode) + "," +
+                   std::to_string(context->record_config.color_resolution);
+
+            std::shared_ptr<shared_calibration_t> shared;
+            {
+                std::lock_guard<std::mutex> lock(calibrations_lock);
+                std::shared_ptr<shared_calibration_t> &entry = calibrations[key];
+                if (entry == nullptr)
+                {
+                    entry = std::make_shared<shared_calibration_t>();
+                }
+                shared = entry;
+            }
+
+            // The first recording to get here parses the calibration, the others wait for it and copy the result.
+            std::call_once(shared->parse_once, [&]() {
+                shared->result = parse_device_calibration(context, buffer);
+                if (K4A_SUCCEEDED(shared->result))
+                {
+                    shared->calibration = *context->device_calibration;
+                }
+            });
+            if (K4A_SUCCEEDED(shared->result))
+            {
+                if (context->device_calibration == nullptr)
+                {
+                    context->device_calibration = make_unique<k4a_calibration_t>(shared->calibration);
+                }
+                recording_calibrations[i] = shared;
+            }
+        }
+    };
+
+    if (thread_count == 0)
+    {
+        thread_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < std::min((size_t)thread_count, path_count); i++)
+    {
+        try
+        {
+            threads.emplace_back(open_worker);
+        }
+        catch (std::system_error &e)
+        {
+            // The remaining recordings are opened by the threads that did start.
+            LOG_WARNING("Failed to start playback open thread: %s", e.what());
+            break;
+        }
+    }
+    open_worker();
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+
+    // Recordings are assigned the index of the first recording in the list sharing their calibration, regardless of
+    // the order they were opened in.
+    for (size_t i = 0; i < path_count; i++)
+    {
+        if (recording_calibrations[i] != nullptr)
+        {
+            if (recording_calibrations[i]->first_index == SIZE_MAX)
+            {
+                recording_calibrations[i]->first_index = i;
+            }
+            if (calibration_indices != NULL)
+            {
+                calibration_indices[i] = recording_calibrations[i]->first_index;
+            }
+        }
+    }
+
+    LOG_TRACE("Opened %zu of %zu recordings with %zu unique calibrations",
+              path_count - failed_count,
+              path_count,
+              calibrations.size());
+    return failed_count == 0 ? K4A_RESULT_SUCCEEDED : K4A_RESULT_FAILED;
+}
+
+k4a_result_t k4a_playback_get_open_timing(k4a_playback_t playback_handle, k4a_playback_open_timing_t *timing)
+{
+    RETURN_VALUE_IF_HANDLE_INVALID(K4A_RESULT_FAILED, k4a_playback_t, playback_handle);
+    k4a_playback_context_t *context = k4a_playback_t_get_context(playback_handle);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, context == NULL);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, timing == NULL);
+
+    *timing = context->open_timing;
+    return K4A_RESULT_SUCCEEDED;
+}
+
 k4a_result_t k4a_playback_get_record_configuration(k4a_playback_t playback_handle, k4a_record_configuration_t *config)
 {
     RETURN_VALUE_IF_HANDLE_INVALID(K4A_RESULT_FAILED, k4a_playback_t, playback_handle);
@@ -412,6 +592,26 @@ k4a_result_t k4a_playback_set_color_conversion(k4a_playback_t playback_handle, k
     return K4A_RESULT_SUCCEEDED;
 }
 
+k4a_result_t k4a_playback_set_data_block_zero_copy(k4a_playback_t playback_handle, bool enable)
+{
+    RETURN_VALUE_IF_HANDLE_INVALID(K4A_RESULT_FAILED, k4a_playback_t, playback_handle);
+    k4a_playback_context_t *context = k4a_playback_t_get_context(playback_handle);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, context == NULL);
+
+    context->data_block_zero_copy = enable;
+    return K4A_RESULT_SUCCEEDED;
+}
+
+k4a_result_t k4a_playback_set_lazy_images(k4a_playback_t playback_handle, bool enable)
+{
+    RETURN_VALUE_IF_HANDLE_INVALID(K4A_RESULT_FAILED, k4a_playback_t, playback_handle);
+    k4a_playback_context_t *context = k4a_playback_t_get_context(playback_handle);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, context == NULL);
+
+    context->lazy_images = enable;
+    return K4A_RESULT_SUCCEEDED;
+}
+
 k4a_buffer_result_t
 k4a_playback_get_attachment(k4a_playback_t playback_handle, const char *file_name, uint8_t *data, size_t *data_size)
 {
@@ -541,6 +741,7 @@ uint64_t k4a_playback_data_block_get_device_timestamp_usec(k4a_playback_data_blo
     RETURN_VALUE_IF_HANDLE_INVALID(0, k4a_playback_data_block_t, data_block_handle);
     k4a_playback_data_block_context_t *data_block_context = k4a_playback_data_block_t_get_context(data_block_handle);
     RETURN_VALUE_IF_ARG(0, data_block_context == NULL);
+    RETURN_VALUE_IF_ARG(0, data_block_context->in_pool);
     return data_block_context->device_timestamp_usec;
 }
 
@@ -549,7 +750,8 @@ size_t k4a_playback_data_block_get_buffer_size(k4a_playback_data_block_t data_bl
     RETURN_VALUE_IF_HANDLE_INVALID(0, k4a_playback_data_block_t, data_block_handle);
     k4a_playback_data_block_context_t *data_block_context = k4a_playback_data_block_t_get_context(data_block_handle);
     RETURN_VALUE_IF_ARG(0, data_block_context == NULL);
-    return data_block_context->data_block.size();
+    RETURN_VALUE_IF_ARG(0, data_block_context->in_pool);
+    return data_block_context->buffer_size;
 }
 
 uint8_t *k4a_playback_data_block_get_buffer(k4a_playback_data_block_t data_block_handle)
@@ -557,13 +759,14 @@ uint8_t *k4a_playback_data_block_get_buffer(k4a_playback_data_block_t data_block
     RETURN_VALUE_IF_HANDLE_INVALID(nullptr, k4a_playback_data_block_t, data_block_handle);
     k4a_playback_data_block_context_t *data_block_context = k4a_playback_data_block_t_get_context(data_block_handle);
     RETURN_VALUE_IF_ARG(nullptr, data_block_context == NULL);
-    return data_block_context->data_block.data();
+    RETURN_VALUE_IF_ARG(nullptr, data_block_context->in_pool);
+    return data_block_context->buffer;
 }
 
 void k4a_playback_data_block_release(k4a_playback_data_block_t data_block_handle)
 {
     RETURN_VALUE_IF_HANDLE_INVALID(VOID_VALUE, k4a_playback_data_block_t, data_block_handle);
-    k4a_playback_data_block_t_destroy(data_block_handle);
+    release_data_block(data_block_handle);
 }
 
 k4a_result_t k4a_playback_seek_timestamp(k4a_playback_t playback_handle,
@@ -653,6 +856,53 @@ uint64_t k4a_playback_get_last_timestamp_usec(k4a_playback_t playback_handle)
     return context->last_file_timestamp_ns / 1000;
 }
 
+k4a_result_t k4a_playback_get_statistics(k4a_playback_t playback_handle, k4a_playback_statistics_t *statistics)
+{
+    RETURN_VALUE_IF_HANDLE_INVALID(K4A_RESULT_FAILED, k4a_playback_t, playback_handle);
+    k4a_playback_context_t *context = k4a_playback_t_get_context(playback_handle);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, context == NULL);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, statistics == NULL);
+
+    return TRACE_CALL(get_recording_statistics(context, statistics));
+}
+
+k4a_result_t k4a_playback_track_get_statistics(k4a_playback_t playback_handle,
+                                               const char *track_name,
+                                               k4a_playback_track_statistics_t *statistics)
+{
+    RETURN_VALUE_IF_HANDLE_INVALID(K4A_RESULT_FAILED, k4a_playback_t, playback_handle);
+    k4a_playback_context_t *context = k4a_playback_t_get_context(playback_handle);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, context == NULL);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, track_name == NULL);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, statistics == NULL);
+
+    track_reader_t *track_reader = get_track_reader_by_name(context, track_name);
+    if (track_reader == nullptr)
+    {
+        LOG_ERROR("Track name cannot be found: %s", track_name);
+        return K4A_RESULT_FAILED;
+    }
+
+    return TRACE_CALL(get_track_statistics(context, track_reader->track_name, statistics));
+}
+
+k4a_result_t k4a_playback_trim(k4a_playback_t playback_handle,
+                               const char *path,
+                               uint64_t start_timestamp_usec,
+                               uint64_t end_timestamp_usec)
+{
+    RETURN_VALUE_IF_HANDLE_INVALID(K4A_RESULT_FAILED, k4a_playback_t, playback_handle);
+    k4a_playback_context_t *context = k4a_playback_t_get_context(playback_handle);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, context == NULL);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, path == NULL);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, start_timestamp_usec >= end_timestamp_usec);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, start_timestamp_usec > context->last_file_timestamp_ns / 1000);
+
+    // Ranges ending after the recording are clamped, since the end timestamp is not included anyway.
+    uint64_t end_timestamp_ns = std::min(end_timestamp_usec, (uint64_t)(UINT64_MAX / 1000)) * 1000;
+    return trim_recording(context, path, start_timestamp_usec * 1000, end_timestamp_ns);
+}
+
 void k4a_playback_close(const k4a_playback_t playback_handle)
 {
     RETURN_VALUE_IF_HANDLE_INVALID(VOID_VALUE, k4a_playback_t, playback_handle);
@@ -664,6 +914,13 @@ void k4a_playback_close(const k4a_playback_t playback_handle)
         LOG_TRACE("  Seek count: %llu", context->seek_count);
         LOG_TRACE("  Cluster load count: %llu", context->load_count);
         LOG_TRACE("  Cluster cache hits: %llu", context->cache_hits);
+        if (context->image_stats != nullptr)
+        {
+            LOG_TRACE("  Images converted: %llu (%llu ms)",
+                      context->image_stats->converted_count.load(),
+                      context->image_stats->convert_time_ns.load() / 1000000);
+            LOG_TRACE("  Lazy images never accessed: %llu", context->image_stats->skipped_count.load());
+        }
 
         context->file_closing = true;
 
@@ -685,6 +942,8 @@ void k4a_playback_close(const k4a_playback_t playback_handle)
         }
 
         context->io_lock.unlock();
+
+        close_data_block_pool(context);
     }
     k4a_playback_t_destroy(playback_handle);
 }
@@ -0,0 +1,399 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <k4a/k4a.h>
+#include <k4arecord/playback.h>
+#include <k4ainternal/matroska_common.h>
+#include <k4ainternal/logging.h>
+#include <k4ainternal/common.h>
+
+// The number of captures each recording reads ahead of the caller.
+#ifndef PLAYBACK_GROUP_PREFETCH_COUNT
+#define PLAYBACK_GROUP_PREFETCH_COUNT 3
+#endif
+
+typedef struct _playback_group_file_t
+{
+    std::string path;
+    k4a_playback_t handle = NULL;
+    int64_t sync_offset_usec = 0; // Subtracted from device timestamps to place captures on the group timeline
+
+    std::thread prefetch_thread;
+    std::mutex prefetch_lock; // Locks access to the fields below
+    std::condition_variable prefetch_notify;
+    std::deque<k4a_capture_t> prefetched;
+    k4a_stream_result_t prefetch_result = K4A_STREAM_RESULT_SUCCEEDED; // Set once the prefetch thread stops reading
+    bool prefetch_stopping = false;
+
+    // The capture at the head of this recording, if it is in the merge heap
+    k4a_capture_t head = NULL;
+    bool needs_refill = true;
+} playback_group_file_t;
+
+// Group timestamp and index of the recording, the heap keeps the earliest timestamp and then lowest index on top.
+typedef std::pair<int64_t, size_t> playback_group_head_t;
+
+typedef struct _k4a_playback_group_context_t
+{
+    std::vector<std::unique_ptr<playback_group_file_t>> files;
+    std::priority_queue<playback_group_head_t, std::vector<playback_group_head_t>, std::greater<playback_group_head_t>>
+        heads;
+} k4a_playback_group_context_t;
+
+K4A_DECLARE_CONTEXT(k4a_playback_group_t, k4a_playback_group_context_t);
+
+// Returns the earliest device timestamp of the images in a capture.
+static uint64_t get_capture_timestamp_usec(k4a_capture_t capture)
+{
+    uint64_t min_timestamp = UINT64_MAX;
+    k4a_image_t images[] = { k4a_capture_get_color_image(capture),
+                             k4a_capture_get_depth_image(capture),
+                             k4a_capture_get_ir_image(capture) };
+    for (size_t i = 0; i < arraysize(images); i++)
+    {
+        if (images[i] != NULL)
+        {
+            uint64_t timestamp = k4a_image_get_device_timestamp_usec(images[i]);
+            if (timestamp < min_timestamp)
+            {
+                min_timestamp = timestamp;
+            }
+            k4a_image_release(images[i]);
+        }
+    }
+    return min_timestamp == UINT64_MAX ? 0 : min_timestamp;
+}
+
+static void playback_group_prefetch_thread(playback_group_file_t *file)
+{
+    try
+    {
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(file->prefetch_lock);
+                file->prefetch_notify.wait(lock, [file] {
+                    return file->prefetch_stopping || file->prefetched.size() < PLAYBACK_GROUP_PREFETCH_COUNT;
+                });
+                if (file->prefetch_stopping)
+                {
+                    return;
+                }
+            }
+
+            // Read and decode outside of the lock so that the caller can take captures that are already queued.
+            k4a_capture_t capture = NULL;
+            k4a_stream_result_t result = k4a_playback_get_next_capture(file->handle, &capture);
+            {
+                std::lock_guard<std::mutex> lock(file->prefetch_lock);
+                if (result == K4A_STREAM_RESULT_SUCCEEDED)
+                {
+                    file->prefetched.push_back(capture);
+                }
+                else
+                {
+                    file->prefetch_result = result;
+                }
+            }
+            file->prefetch_notify.notify_all();
+
+            if (result != K4A_STREAM_RESULT_SUCCEEDED)
+            {
+                return;
+            }
+        }
+    }
+    catch (std::system_error &e)
+    {
+        LOG_ERROR("Playback group prefetch thread for '%s' threw exception: %s", file->path.c_str(), e.what());
+        std::lock_guard<std::mutex> lock(file->prefetch_lock);
+        file->prefetch_result = K4A_STREAM_RESULT_FAILED;
+    }
+}
+
+// Waits for the next prefetched capture of a recording.
+static k4a_stream_result_t take_prefetched_capture(playback_group_file_t *file, k4a_capture_t *capture_handle)
+{
+    try
+    {
+        std::unique_lock<std::mutex> lock(file->prefetch_lock);
+        file->prefetch_notify.wait(lock, [file] {
+            return !file->prefetched.empty() || file->prefetch_result != K4A_STREAM_RESULT_SUCCEEDED;
+        });
+        if (file->prefetched.empty())
+        {
+            return file->prefetch_result;
+        }
+
+        *capture_handle = file->prefetched.front();
+        file->prefetched.pop_front();
+        lock.unlock();
+        file->prefetch_notify.notify_all();
+        return K4A_STREAM_RESULT_SUCCEEDED;
+    }
+    catch (std::system_error &e)
+    {
+        LOG_ERROR("Failed to read from playback group recording '%s': %s", file->path.c_str(), e.what());
+        return K4A_STREAM_RESULT_FAILED;
+    }
+}
+
+// Moves the next capture of every recording whose head was taken into the merge heap.
+static k4a_result_t refill_heads(k4a_playback_group_context_t *context)
+{
+    for (size_t i = 0; i < context->files.size(); i++)
+    {
+        playback_group_file_t *file = context->files[i].get();
+        if (!file->needs_refill)
+        {
+            continue;
+        }
+
+        k4a_capture_t capture = NULL;
+        k4a_stream_result_t result = take_prefetched_capture(file, &capture);
+        if (result == K4A_STREAM_RESULT_FAILED)
+        {
+            LOG_ERROR("Failed to read the next capture from recording '%s'", file->path.c_str());
+            return K4A_RESULT_FAILED;
+        }
+
+        file->needs_refill = false;
+        if (result == K4A_STREAM_RESULT_SUCCEEDED)
+        {
+            file->head = capture;
+            context->heads.push(
+                std::make_pair((int64_t)get_capture_timestamp_usec(capture) - file->sync_offset_usec, i));
+        }
+    }
+    return K4A_RESULT_SUCCEEDED;
+}
+
+static void stop_prefetch_thread(playback_group_file_t *file)
+{
+    if (!file->prefetch_thread.joinable())
+    {
+        return;
+    }
+
+    try
+    {
+        {
+            std::lock_guard<std::mutex> lock(file->prefetch_lock);
+            file->prefetch_stopping = true;
+        }
+        file->prefetch_notify.notify_all();
+        file->prefetch_thread.join();
+    }
+    catch (std::system_error &e)
+    {
+        LOG_ERROR("Failed to stop playback group prefetch thread: %s", e.what());
+    }
+}
+
+static void close_playback_group_file(playback_group_file_t *file)
+{
+    stop_prefetch_thread(file);
+
+    for (k4a_capture_t capture : file->prefetched)
+    {
+        k4a_capture_release(capture);
+    }
+    file->prefetched.clear();
+
+    if (file->head != NULL)
+    {
+        k4a_capture_release(file->head);
+        file->head = NULL;
+    }
+
+    if (file->handle != NULL)
+    {
+        k4a_playback_close(file->handle);
+        file->handle = NULL;
+    }
+}
+
+k4a_result_t k4a_playback_group_open(const char *const *paths, size_t path_count, k4a_playback_group_t *group_handle)
+{
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, paths == NULL);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, path_count == 0);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, group_handle == NULL);
+    k4a_playback_group_context_t *context = NULL;
+    k4a_result_t result = K4A_RESULT_SUCCEEDED;
+
+    context = k4a_playback_group_t_create(group_handle);
+    result = K4A_RESULT_FROM_BOOL(context != NULL);
+
+    for (size_t i = 0; K4A_SUCCEEDED(result) && i < path_count; i++)
+    {
+        result = K4A_RESULT_FROM_BOOL(paths[i] != NULL);
+        if (K4A_SUCCEEDED(result))
+        {
+            context->files.emplace_back(new playback_group_file_t());
+            playback_group_file_t *file = context->files.back().get();
+
+            // k4a_playback_open() keeps a pointer to the path, so the group keeps its own copy.
+            file->path = paths[i];
+            result = TRACE_CALL(k4a_playback_open(file->path.c_str(), &file->handle));
+        }
+
+        if (K4A_SUCCEEDED(result))
+        {
+            playback_group_file_t *file = context->files.back().get();
+            k4a_record_configuration_t config;
+            result = TRACE_CALL(k4a_playback_get_record_configuration(file->handle, &config));
+            if (K4A_SUCCEEDED(result) && config.wired_sync_mode == K4A_WIRED_SYNC_MODE_SUBORDINATE)
+            {
+                file->sync_offset_usec = (int64_t)config.subordinate_delay_off_master_usec;
+            }
+        }
+    }
+
+    // Start reading ahead only once every recording opened, so that a failure does not leave threads to stop.
+    for (size_t i = 0; K4A_SUCCEEDED(result) && i < context->files.size(); i++)
+    {
+        try
+        {
+            playback_group_file_t *file = context->files[i].get();
+            file->prefetch_thread = std::thread(playback_group_prefetch_thread, file);
+        }
+        catch (std::system_error &e)
+        {
+            LOG_ERROR("Failed to start playback group prefetch thread: %s", e.what());
+            result = K4A_RESULT_FAILED;
+        }
+    }
+
+    if (K4A_FAILED(result) && context != NULL)
+    {
+        for (auto &file : context->files)
+        {
+            close_playback_group_file(file.get());
+        }
+        k4a_playback_group_t_destroy(*group_handle);
+        *group_handle = NULL;
+    }
+
+    return result;
+}
+
+size_t k4a_playback_group_get_playback_count(k4a_playback_group_t group_handle)
+{
+    RETURN_VALUE_IF_HANDLE_INVALID(0, k4a_playback_group_t, group_handle);
+    k4a_playback_group_context_t *context = k4a_playback_group_t_get_context(group_handle);
+    RETURN_VALUE_IF_ARG(0, context == NULL);
+
+    return context->files.size();
+}
+
+k4a_playback_t k4a_playback_group_get_playback(k4a_playback_group_t group_handle, size_t playback_index)
+{
+    RETURN_VALUE_IF_HANDLE_INVALID(NULL, k4a_playback_group_t, group_handle);
+    k4a_playback_group_context_t *context = k4a_playback_group_t_get_context(group_handle);
+    RETURN_VALUE_IF_ARG(NULL, context == NULL);
+    RETURN_VALUE_IF_ARG(NULL, playback_index >= context->files.size());
+
+    return context->files[playback_index]->handle;
+}
+
+k4a_stream_result_t k4a_playback_group_get_next_capture(k4a_playback_group_t group_handle,
+                                                        k4a_capture_t *capture_handle,
+                                                        size_t *playback_index)
+{
+    RETURN_VALUE_IF_HANDLE_INVALID(K4A_STREAM_RESULT_FAILED, k4a_playback_group_t, group_handle);
+    k4a_playback_group_context_t *context = k4a_playback_group_t_get_context(group_handle);
+    RETURN_VALUE_IF_ARG(K4A_STREAM_RESULT_FAILED, context == NULL);
+    RETURN_VALUE_IF_ARG(K4A_STREAM_RESULT_FAILED, capture_handle == NULL);
+
+    *capture_handle = NULL;
+    if (K4A_FAILED(TRACE_CALL(refill_heads(context))))
+    {
+        return K4A_STREAM_RESULT_FAILED;
+    }
+
+    if (context->heads.empty())
+    {
+        return K4A_STREAM_RESULT_EOF;
+    }
+
+    // The recording is only read again on the next call, so its prefetch thread keeps working in the meantime.
+    size_t index = context->heads.top().second;
+    context->heads.pop();
+    playback_group_file_t *file = context->files[index].get();
+    *capture_handle = file->head;
+    file->head = NULL;
+    file->needs_refill = true;
+
+    if (playback_index != NULL)
+    {
+        *playback_index = index;
+    }
+    return K4A_STREAM_RESULT_SUCCEEDED;
+}
+
+k4a_stream_result_t k4a_playback_group_get_next_captures(k4a_playback_group_t group_handle,
+                                                         uint64_t tolerance_usec,
+                                                         k4a_capture_t *capture_handles,
+                                                         size_t capture_count)
+{
+    RETURN_VALUE_IF_HANDLE_INVALID(K4A_STREAM_RESULT_FAILED, k4a_playback_group_t, group_handle);
+    k4a_playback_group_context_t *context = k4a_playback_group_t_get_context(group_handle);
+    RETURN_VALUE_IF_ARG(K4A_STREAM_RESULT_FAILED, context == NULL);
+    RETURN_VALUE_IF_ARG(K4A_STREAM_RESULT_FAILED, capture_handles == NULL);
+    RETURN_VALUE_IF_ARG(K4A_STREAM_RESULT_FAILED, capture_count != context->files.size());
+    RETURN_VALUE_IF_ARG(K4A_STREAM_RESULT_FAILED, tolerance_usec > INT64_MAX);
+
+    for (size_t i = 0; i < capture_count; i++)
+    {
+        capture_handles[i] = NULL;
+    }
+
+    if (K4A_FAILED(TRACE_CALL(refill_heads(context))))
+    {
+        return K4A_STREAM_RESULT_FAILED;
+    }
+
+    if (context->heads.empty())
+    {
+        return K4A_STREAM_RESULT_EOF;
+    }
+
+    // Every recording has at most one capture in the heap, so each one contributes at most one capture to the set.
+    int64_t start_timestamp_usec = context->heads.top().first;
+    while (!context->heads.empty() && context->heads.top().first - start_timestamp_usec <= (int64_t)tolerance_usec)
+    {
+        size_t index = context->heads.top().second;
+        context->heads.pop();
+        playback_group_file_t *file = context->files[index].get();
+        capture_handles[index] = file->head;
+        file->head = NULL;
+        file->needs_refill = true;
+    }
+
+    return K4A_STREAM_RESULT_SUCCEEDED;
+}
+
+void k4a_playback_group_close(k4a_playback_group_t group_handle)
+{
+    RETURN_VALUE_IF_HANDLE_INVALID(VOID_VALUE, k4a_playback_group_t, group_handle);
+
+    k4a_playback_group_context_t *context = k4a_playback_group_t_get_context(group_handle);
+    if (context != NULL)
+    {
+        for (auto &file : context->files)
+        {
+            close_playback_group_file(file.get());
+        }
+    }
+    k4a_playback_group_t_destroy(group_handle);
+}
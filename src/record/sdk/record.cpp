@@ -18,12 +18,52 @@ k4a_result_t k4a_record_create(const char *path,
                                k4a_device_t device,
                                const k4a_device_configuration_t device_config,
                                k4a_record_t *recording_handle)
+{
+    return k4a_record_create_with_settings(path, device, device_config, NULL, recording_handle);
+}
+
+k4a_result_t k4a_record_create_with_settings(const char *path,
+                                             k4a_device_t device,
+                                             const k4a_device_configuration_t device_config,
+                                             const k4a_record_settings_t *settings,
+                                             k4a_record_t *recording_handle)
 {
     RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, path == NULL);
     RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, recording_handle == NULL);
     k4a_record_context_t *context = NULL;
     k4a_result_t result = K4A_RESULT_SUCCEEDED;
 
+    uint64_t cluster_length_ns = MAX_CLUSTER_LENGTH_NS;
+    uint64_t cue_entry_gap_ns = CUE_ENTRY_GAP_NS;
+    uint64_t cluster_write_delay_ns = CLUSTER_WRITE_DELAY_NS;
+    if (settings != NULL)
+    {
+        if (settings->cluster_length_usec != 0)
+        {
+            cluster_length_ns = settings->cluster_length_usec * 1_us;
+        }
+        if (settings->cue_gap_usec != 0)
+        {
+            cue_entry_gap_ns = settings->cue_gap_usec * 1_us;
+        }
+        if (settings->cluster_write_delay_usec != 0)
+        {
+            cluster_write_delay_ns = settings->cluster_write_delay_usec * 1_us;
+        }
+    }
+
+    // These are the same constraints that are checked for the defaults in matroska_common.h
+    if (cluster_length_ns >= INT16_MAX * MATROSKA_TIMESCALE_NS)
+    {
+        LOG_ERROR("Cluster length must fit in a 16 bit int: %llu usec", cluster_length_ns / 1_us);
+        return K4A_RESULT_FAILED;
+    }
+    if (cluster_write_delay_ns < cluster_length_ns * 2)
+    {
+        LOG_ERROR("Cluster write delay is shorter than 2 clusters: %llu usec", cluster_write_delay_ns / 1_us);
+        return K4A_RESULT_FAILED;
+    }
+
     context = k4a_record_t_create(recording_handle);
     result = K4A_RESULT_FROM_BOOL(context != NULL);
 
@@ -47,6 +87,9 @@ k4a_result_t k4a_record_create(const char *path,
         context->device_config = device_config;
 
         context->timecode_scale = MATROSKA_TIMESCALE_NS;
+        context->cluster_length_ns = cluster_length_ns;
+        context->cue_entry_gap_ns = cue_entry_gap_ns;
+        context->cluster_write_delay_ns = cluster_write_delay_ns;
         context->camera_fps = k4a_convert_fps_to_uint(device_config.camera_fps);
         if (context->camera_fps == 0)
         {
@@ -441,6 +484,129 @@ k4a_result_t k4a_record_add_imu_track(const k4a_record_t recording_handle)
     return K4A_RESULT_SUCCEEDED;
 }
 
+k4a_result_t k4a_record_add_preview_track(const k4a_record_t recording_handle,
+                                          const k4a_record_preview_settings_t *settings)
+{
+    RETURN_VALUE_IF_HANDLE_INVALID(K4A_RESULT_FAILED, k4a_record_t, recording_handle);
+
+    k4a_record_context_t *context = k4a_record_t_get_context(recording_handle);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, context == NULL);
+
+    if (context->header_written)
+    {
+        LOG_ERROR("The preview track must be added before the recording header is written.", 0);
+        return K4A_RESULT_FAILED;
+    }
+
+    if (context->preview)
+    {
+        LOG_ERROR("The preview track has already been added to this recording.", 0);
+        return K4A_RESULT_FAILED;
+    }
+
+    uint32_t image_count = (context->color_track != nullptr ? 1u : 0u) + (context->depth_track != nullptr ? 1u : 0u);
+    if (image_count == 0)
+    {
+        LOG_ERROR("The preview track requires a color or depth track in the recording.", 0);
+        return K4A_RESULT_FAILED;
+    }
+
+    uint32_t width = PREVIEW_WIDTH;
+    uint32_t height = PREVIEW_HEIGHT;
+    uint64_t interval_ns = PREVIEW_INTERVAL_NS;
+    uint32_t jpeg_quality = PREVIEW_JPEG_QUALITY;
+    uint32_t max_cpu_percent = PREVIEW_MAX_CPU_PERCENT;
+    if (settings != NULL)
+    {
+        if (settings->width != 0)
+        {
+            width = settings->width;
+        }
+        if (settings->height != 0)
+        {
+            height = settings->height;
+        }
+        if (settings->interval_usec != 0)
+        {
+            interval_ns = settings->interval_usec * 1_us;
+        }
+        if (settings->jpeg_quality != 0)
+        {
+            jpeg_quality = settings->jpeg_quality;
+        }
+        if (settings->max_cpu_percent != 0)
+        {
+            max_cpu_percent = settings->max_cpu_percent;
+        }
+    }
+
+    // Previews are meant to be small, don't allow them to be larger than the largest color resolution.
+    if (width > 4096 || height > 3072)
+    {
+        LOG_ERROR("Preview size is too large: %ux%u", width, height);
+        return K4A_RESULT_FAILED;
+    }
+    if (jpeg_quality > 100)
+    {
+        LOG_ERROR("Preview jpeg quality must be between 1 and 100: %u", jpeg_quality);
+        return K4A_RESULT_FAILED;
+    }
+    if (max_cpu_percent > 100)
+    {
+        LOG_ERROR("Preview CPU budget must be between 1 and 100 percent: %u", max_cpu_percent);
+        return K4A_RESULT_FAILED;
+    }
+
+    BITMAPINFOHEADER codec_info = {};
+    RETURN_IF_ERROR(
+        populate_bitmap_info_header(&codec_info, width * image_count, height, K4A_IMAGE_FORMAT_COLOR_MJPG));
+
+    std::unique_ptr<preview_writer_t> preview;
+    try
+    {
+        preview.reset(new preview_writer_t());
+    }
+    catch (std::exception &e)
+    {
+        LOG_ERROR("Failed to allocate preview track: %s", e.what());
+        return K4A_RESULT_FAILED;
+    }
+
+    preview->track = add_track(context,
+                               K4A_TRACK_NAME_PREVIEW,
+                               track_video,
+                               "V_MS/VFW/FOURCC",
+                               reinterpret_cast<uint8_t *>(&codec_info),
+                               sizeof(codec_info));
+    if (preview->track == nullptr)
+    {
+        LOG_ERROR("Failed to add preview track.", 0);
+        return K4A_RESULT_FAILED;
+    }
+    // Preview frames are spaced by the interval rather than the camera frame rate.
+    set_track_info_video(preview->track, width * image_count, height, 1);
+    GetChild<KaxTrackDefaultDuration>(*preview->track->track).SetValue(interval_ns);
+
+    preview->width = width;
+    preview->height = height;
+    preview->image_count = image_count;
+    preview->interval_ns = interval_ns;
+    preview->jpeg_quality = (int)jpeg_quality;
+    preview->max_cpu_percent = max_cpu_percent;
+    preview->next_timestamp_ns = 0;
+    preview->pending_capture = NULL;
+    preview->stopping = false;
+
+    uint64_t track_uid = GetChild<KaxTrackUID>(*preview->track->track).GetValue();
+    std::ostringstream track_uid_str;
+    track_uid_str << track_uid;
+    add_tag(context, "K4A_PREVIEW_TRACK", track_uid_str.str().c_str(), TAG_TARGET_TYPE_TRACK, track_uid);
+
+    context->preview = std::move(preview);
+
+    return K4A_RESULT_SUCCEEDED;
+}
+
 k4a_result_t k4a_record_add_custom_video_track(const k4a_record_t recording_handle,
                                                const char *track_name,
                                                const char *codec_id,
@@ -590,6 +756,16 @@ k4a_result_t k4a_record_write_header(const k4a_record_t recording_handle)
 
     RETURN_IF_ERROR(start_matroska_writer_thread(context));
 
+    if (context->preview)
+    {
+        k4a_result_t result = TRACE_CALL(start_preview_writer_thread(context));
+        if (K4A_FAILED(result))
+        {
+            stop_matroska_writer_thread(context);
+            return result;
+        }
+    }
+
     context->header_written = true;
 
     return K4A_RESULT_SUCCEEDED;
@@ -669,6 +845,11 @@ k4a_result_t k4a_record_write_capture(const k4a_record_t recording_handle, k4a_c
         }
     }
 
+    if (K4A_SUCCEEDED(result) && context->preview)
+    {
+        queue_preview_capture(context, capture);
+    }
+
     return result;
 }
 
@@ -903,6 +1084,9 @@ void k4a_record_close(const k4a_record_t recording_handle)
         // If the recording was started, flush any unwritten data.
         if (context->header_written)
         {
+            // Write the last preview frame before the remaining clusters are flushed.
+            stop_preview_writer_thread(context);
+
             // If these fail, there's nothing we can do but log.
             (void)TRACE_CALL(k4a_record_flush(recording_handle));
             stop_matroska_writer_thread(context);
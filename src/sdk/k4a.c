@@ -14,8 +14,11 @@
 #include <k4ainternal/depth_mcu.h>
 #include <k4ainternal/calibration.h>
 #include <k4ainternal/capturesync.h>
+#include <k4ainternal/queue.h>
 #include <k4ainternal/transformation.h>
 #include <k4ainternal/logging.h>
+#include <azure_c_shared_utility/lock.h>
+#include <azure_c_shared_utility/threadapi.h>
 #include <azure_c_shared_utility/tickcounter.h>
 
 // System dependencies
@@ -48,6 +51,9 @@ typedef struct _k4a_context_t
     bool depth_started;
     bool color_started;
     bool imu_started;
+
+    k4a_buffer_preallocation_t buffer_preallocation; // Set by k4a_device_set_buffer_preallocation()
+    bool buffers_preallocated;                       // Frame buffer pools were enabled by k4a_device_start_cameras()
 } k4a_context_t;
 
 K4A_DECLARE_CONTEXT(k4a_device_t, k4a_context_t);
@@ -55,6 +61,7 @@ K4A_DECLARE_CONTEXT(k4a_device_t, k4a_context_t);
 #define DEPTH_CAPTURE (false)
 #define COLOR_CAPTURE (true)
 #define TRANSFORM_ENABLE_GPU_OPTIMIZATION (true)
+#define PREALLOCATED_FRAME_COUNT (QUEUE_DEFAULT_SIZE) // Frame buffers set aside per stream; one capture queue's worth
 #define K4A_DEPTH_MODE_TO_STRING_CASE(depth_mode)                                                                      \
     case depth_mode:                                                                                                   \
         return #depth_mode
@@ -87,6 +94,23 @@ k4a_result_t k4a_set_allocator(k4a_memory_allocate_cb_t allocate, k4a_memory_des
     return allocator_set_allocator(allocate, free);
 }
 
+k4a_result_t k4a_set_memory_limits(size_t soft_limit_bytes, size_t hard_limit_bytes)
+{
+    return allocator_set_memory_limits(soft_limit_bytes, hard_limit_bytes);
+}
+
+k4a_result_t k4a_get_memory_usage(k4a_memory_usage_t *usage)
+{
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, usage == NULL);
+    allocator_get_memory_usage(usage);
+    return K4A_RESULT_SUCCEEDED;
+}
+
+k4a_result_t k4a_set_calibration_cache_directory(const char *path)
+{
+    return calibration_set_cache_directory(path);
+}
+
 depth_cb_streaming_capture_t depth_capture_ready;
 color_cb_streaming_capture_t color_capture_ready;
 
@@ -106,19 +130,104 @@ void color_capture_ready(k4a_result_t result, k4a_capture_t capture_handle, void
     capturesync_add_capture(device->capturesync, result, capture_handle, COLOR_CAPTURE);
 }
 
-k4a_result_t k4a_device_open(uint32_t index, k4a_device_t *device_handle)
+// State for opening one device, shared with the threads that run its steps concurrently
+typedef struct _k4a_device_open_context_t
 {
-    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, device_handle == NULL);
-    k4a_context_t *device = NULL;
-    k4a_result_t result = K4A_RESULT_SUCCEEDED;
-    k4a_device_t handle = NULL;
-    const guid_t *container_id = NULL;
+    uint32_t index;
+    bool concurrent;
+
+    // Serializes the color MCU search across devices; it opens every color MCU to compare container IDs
+    LOCK_HANDLE colormcu_lock;
+
+    k4a_device_t handle;
+    k4a_context_t *device;
+    const guid_t *container_id;
     char serial_number[MAX_SERIAL_NUMBER_LENGTH];
-    size_t serial_number_size = sizeof(serial_number);
 
-    allocator_initialize();
+    k4a_result_t result;
+    k4a_result_t colormcu_result;
+    k4a_result_t color_result;
+    k4a_device_open_timing_t timing;
+} k4a_device_open_context_t;
+
+static uint64_t device_open_elapsed_ms(k4a_device_open_context_t *open, tickcounter_ms_t start_ms)
+{
+    tickcounter_ms_t now_ms = start_ms;
+    (void)tickcounter_get_current_ms(open->device->tick_handle, &now_ms);
+    return (uint64_t)(now_ms - start_ms);
+}
+
+static int device_open_colormcu(void *param)
+{
+    k4a_device_open_context_t *open = (k4a_device_open_context_t *)param;
+    tickcounter_ms_t start_ms = 0;
+    (void)tickcounter_get_current_ms(open->device->tick_handle, &start_ms);
+
+    if (open->colormcu_lock)
+    {
+        Lock(open->colormcu_lock);
+    }
+    open->colormcu_result = TRACE_CALL(colormcu_create(open->container_id, &open->device->colormcu));
+    if (open->colormcu_lock)
+    {
+        Unlock(open->colormcu_lock);
+    }
+
+    open->timing.color_mcu_ms = device_open_elapsed_ms(open, start_ms);
+    return 0;
+}
+
+static int device_open_color(void *param)
+{
+    k4a_device_open_context_t *open = (k4a_device_open_context_t *)param;
+    tickcounter_ms_t start_ms = 0;
+    (void)tickcounter_get_current_ms(open->device->tick_handle, &start_ms);
 
-    device = k4a_device_t_create(&handle);
+    open->color_result = TRACE_CALL(color_create(open->device->tick_handle,
+                                                 open->container_id,
+                                                 open->serial_number,
+                                                 color_capture_ready,
+                                                 open->handle,
+                                                 &open->device->color));
+
+    open->timing.color_ms = device_open_elapsed_ms(open, start_ms);
+    return 0;
+}
+
+// Runs step on a new thread when the open is concurrent, otherwise on the calling thread. Returns the thread to join.
+static THREAD_HANDLE device_open_start_step(k4a_device_open_context_t *open, THREAD_START_FUNC step)
+{
+    THREAD_HANDLE thread = NULL;
+    if (!open->concurrent || ThreadAPI_Create(&thread, step, open) != THREADAPI_OK)
+    {
+        thread = NULL;
+        (void)step(open);
+    }
+    return thread;
+}
+
+static void device_open_join_step(THREAD_HANDLE thread)
+{
+    if (thread)
+    {
+        int thread_result;
+        THREADAPI_RESULT tresult = ThreadAPI_Join(thread, &thread_result);
+        (void)K4A_RESULT_FROM_BOOL(tresult == THREADAPI_OK); // Trace the issue, but we don't return a failure
+    }
+}
+
+// Opens open->index. When open->concurrent is set, the calibration is read while the color MCU is opened and the
+// depth and color modules are created concurrently.
+static int device_open(void *param)
+{
+    k4a_device_open_context_t *open = (k4a_device_open_context_t *)param;
+    k4a_context_t *device = NULL;
+    k4a_result_t result = K4A_RESULT_SUCCEEDED;
+    size_t serial_number_size = sizeof(open->serial_number);
+    tickcounter_ms_t open_start_ms = 0;
+    tickcounter_ms_t step_start_ms = 0;
+
+    device = open->device = k4a_device_t_create(&open->handle);
     result = K4A_RESULT_FROM_BOOL(device != NULL);
 
     if (K4A_SUCCEEDED(result))
@@ -126,36 +235,49 @@ k4a_result_t k4a_device_open(uint32_t index, k4a_device_t *device_handle)
         result = K4A_RESULT_FROM_BOOL((device->tick_handle = tickcounter_create()) != NULL);
     }
 
+    if (K4A_SUCCEEDED(result))
+    {
+        (void)tickcounter_get_current_ms(device->tick_handle, &open_start_ms);
+    }
+
     // Create MCU modules
     if (K4A_SUCCEEDED(result))
     {
         // This will block until the depth process is ready to receive commands
-        result = TRACE_CALL(depthmcu_create(index, &device->depthmcu));
+        step_start_ms = open_start_ms;
+        result = TRACE_CALL(depthmcu_create(open->index, &device->depthmcu));
+        open->timing.depth_mcu_ms = device_open_elapsed_ms(open, step_start_ms);
     }
 
     if (K4A_SUCCEEDED(result))
     {
-        result = K4A_RESULT_FROM_BOOL((container_id = depthmcu_get_container_id(device->depthmcu)) != NULL);
+        result = K4A_RESULT_FROM_BOOL((open->container_id = depthmcu_get_container_id(device->depthmcu)) != NULL);
     }
 
     if (K4A_SUCCEEDED(result))
     {
-        if (TRACE_BUFFER_CALL(depthmcu_get_serialnum(device->depthmcu, serial_number, &serial_number_size) !=
+        if (TRACE_BUFFER_CALL(depthmcu_get_serialnum(device->depthmcu, open->serial_number, &serial_number_size) !=
                               K4A_BUFFER_RESULT_SUCCEEDED))
         {
             result = K4A_RESULT_FAILED;
         }
     }
 
+    // The color MCU and the calibration use different USB interfaces, so they are independent
     if (K4A_SUCCEEDED(result))
     {
-        result = TRACE_CALL(colormcu_create(container_id, &device->colormcu));
-    }
+        THREAD_HANDLE colormcu_thread = device_open_start_step(open, device_open_colormcu);
 
-    // Create calibration module - ensure we can read calibration before proceeding
-    if (K4A_SUCCEEDED(result))
-    {
+        // Create calibration module - ensure we can read calibration before proceeding
+        (void)tickcounter_get_current_ms(device->tick_handle, &step_start_ms);
         result = TRACE_CALL(calibration_create(device->depthmcu, &device->calibration));
+        open->timing.calibration_ms = device_open_elapsed_ms(open, step_start_ms);
+
+        device_open_join_step(colormcu_thread);
+        if (K4A_SUCCEEDED(result))
+        {
+            result = open->colormcu_result;
+        }
     }
 
     if (K4A_SUCCEEDED(result))
@@ -163,35 +285,154 @@ k4a_result_t k4a_device_open(uint32_t index, k4a_device_t *device_handle)
         result = TRACE_CALL(capturesync_create(&device->capturesync));
     }
 
-    // Open Depth Module
+    // Create the depth and color modules; the color camera is a separate USB function
     if (K4A_SUCCEEDED(result))
     {
+        THREAD_HANDLE color_thread = device_open_start_step(open, device_open_color);
+
+        (void)tickcounter_get_current_ms(device->tick_handle, &step_start_ms);
         result = TRACE_CALL(
-            depth_create(device->depthmcu, device->calibration, depth_capture_ready, handle, &device->depth));
+            depth_create(device->depthmcu, device->calibration, depth_capture_ready, open->handle, &device->depth));
+        open->timing.depth_ms = device_open_elapsed_ms(open, step_start_ms);
+
+        device_open_join_step(color_thread);
+        if (K4A_SUCCEEDED(result))
+        {
+            result = open->color_result;
+        }
     }
 
-    // Create color Module
+    // Create imu Module
     if (K4A_SUCCEEDED(result))
     {
-        result = TRACE_CALL(color_create(
-            device->tick_handle, container_id, serial_number, color_capture_ready, handle, &device->color));
+        (void)tickcounter_get_current_ms(device->tick_handle, &step_start_ms);
+        result = TRACE_CALL(imu_create(device->tick_handle, device->colormcu, device->calibration, &device->imu));
+        open->timing.imu_ms = device_open_elapsed_ms(open, step_start_ms);
+    }
+
+    if (device && device->tick_handle)
+    {
+        open->timing.total_ms = device_open_elapsed_ms(open, open_start_ms);
     }
 
-    // Create imu Module
+    if (K4A_FAILED(result) && open->handle)
+    {
+        k4a_device_close(open->handle);
+        open->handle = NULL;
+    }
+
+    open->result = result;
+    return 0;
+}
+
+k4a_result_t k4a_device_open(uint32_t index, k4a_device_t *device_handle)
+{
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, device_handle == NULL);
+    k4a_device_open_context_t open = { 0 };
+
+    allocator_initialize();
+
+    open.index = index;
+    (void)device_open(&open);
+
+    if (K4A_SUCCEEDED(open.result))
+    {
+        *device_handle = open.handle;
+    }
+
+    return open.result;
+}
+
+k4a_result_t k4a_device_open_multiple(const uint32_t *indices,
+                                      uint32_t device_count,
+                                      k4a_device_t *device_handles,
+                                      k4a_result_t *results,
+                                      k4a_device_open_timing_t *timings)
+{
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, indices == NULL);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, device_count == 0);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, device_handles == NULL);
+    k4a_result_t result = K4A_RESULT_SUCCEEDED;
+    k4a_device_open_context_t *opens = NULL;
+    THREAD_HANDLE *threads = NULL;
+    LOCK_HANDLE colormcu_lock = NULL;
+    bool enumerated = false;
+
+    allocator_initialize();
+
+    for (uint32_t i = 0; i < device_count; i++)
+    {
+        device_handles[i] = NULL;
+    }
+
+    opens = (k4a_device_open_context_t *)calloc(device_count, sizeof(k4a_device_open_context_t));
+    threads = (THREAD_HANDLE *)calloc(device_count, sizeof(THREAD_HANDLE));
+    result = K4A_RESULT_FROM_BOOL(opens != NULL && threads != NULL);
+
     if (K4A_SUCCEEDED(result))
     {
-        result = TRACE_CALL(imu_create(device->tick_handle, device->colormcu, device->calibration, &device->imu));
+        result = K4A_RESULT_FROM_BOOL((colormcu_lock = Lock_Init()) != NULL);
     }
 
-    if (K4A_FAILED(result))
+    // Enumerate once for all of the devices
+    if (K4A_SUCCEEDED(result))
+    {
+        result = TRACE_CALL(usb_cmd_enumeration_acquire());
+        enumerated = K4A_SUCCEEDED(result);
+    }
+
+    if (K4A_SUCCEEDED(result))
+    {
+        for (uint32_t i = 0; i < device_count; i++)
+        {
+            opens[i].index = indices[i];
+            opens[i].concurrent = true;
+            opens[i].colormcu_lock = colormcu_lock;
+            if (ThreadAPI_Create(&threads[i], device_open, &opens[i]) != THREADAPI_OK)
+            {
+                threads[i] = NULL;
+                (void)device_open(&opens[i]);
+            }
+        }
+
+        for (uint32_t i = 0; i < device_count; i++)
+        {
+            device_open_join_step(threads[i]);
+
+            device_handles[i] = opens[i].handle;
+            if (results)
+            {
+                results[i] = opens[i].result;
+            }
+            if (timings)
+            {
+                timings[i] = opens[i].timing;
+            }
+            if (K4A_FAILED(opens[i].result))
+            {
+                LOG_ERROR("Failed to open device at index %d", indices[i]);
+                result = K4A_RESULT_FAILED;
+            }
+        }
+    }
+    else if (results)
+    {
+        for (uint32_t i = 0; i < device_count; i++)
+        {
+            results[i] = K4A_RESULT_FAILED;
+        }
+    }
+
+    if (enumerated)
     {
-        k4a_device_close(handle);
-        handle = NULL;
+        usb_cmd_enumeration_release();
     }
-    else
+    if (colormcu_lock)
     {
-        *device_handle = handle;
+        Lock_Deinit(colormcu_lock);
     }
+    free(threads);
+    free(opens);
 
     return result;
 }
@@ -378,6 +619,30 @@ void k4a_capture_set_ir_image(k4a_capture_t capture_handle, k4a_image_t image_ha
     capture_set_ir_image(capture_handle, image_handle);
 }
 
+k4a_result_t k4a_capture_set_color_image_loader(k4a_capture_t capture_handle,
+                                                k4a_capture_image_load_cb_t *load_cb,
+                                                k4a_capture_image_loader_release_cb_t *release_cb,
+                                                void *loader_context)
+{
+    return capture_set_color_image_loader(capture_handle, load_cb, release_cb, loader_context);
+}
+
+k4a_result_t k4a_capture_set_depth_image_loader(k4a_capture_t capture_handle,
+                                                k4a_capture_image_load_cb_t *load_cb,
+                                                k4a_capture_image_loader_release_cb_t *release_cb,
+                                                void *loader_context)
+{
+    return capture_set_depth_image_loader(capture_handle, load_cb, release_cb, loader_context);
+}
+
+k4a_result_t k4a_capture_set_ir_image_loader(k4a_capture_t capture_handle,
+                                             k4a_capture_image_load_cb_t *load_cb,
+                                             k4a_capture_image_loader_release_cb_t *release_cb,
+                                             void *loader_context)
+{
+    return capture_set_ir_image_loader(capture_handle, load_cb, release_cb, loader_context);
+}
+
 void k4a_capture_set_temperature_c(k4a_capture_t capture_handle, float temperature_c)
 {
     capture_set_temperature_c(capture_handle, temperature_c);
@@ -413,6 +678,18 @@ k4a_result_t k4a_image_create_from_buffer(k4a_image_format_t format,
                                     image_handle);
 }
 
+k4a_result_t k4a_image_create_view(k4a_image_t parent_image_handle,
+                                   k4a_image_format_t format,
+                                   int width_pixels,
+                                   int height_pixels,
+                                   int stride_bytes,
+                                   size_t offset_bytes,
+                                   k4a_image_t *view_image_handle)
+{
+    return image_create_view(
+        parent_image_handle, format, width_pixels, height_pixels, stride_bytes, offset_bytes, view_image_handle);
+}
+
 uint8_t *k4a_image_get_buffer(k4a_image_t image_handle)
 {
     return image_get_buffer(image_handle);
@@ -473,6 +750,11 @@ uint32_t k4a_image_get_iso_speed(k4a_image_t image_handle)
     return image_get_iso_speed(image_handle);
 }
 
+k4a_result_t k4a_image_get_info(k4a_image_t image_handle, k4a_image_info_t *info)
+{
+    return image_get_info(image_handle, info);
+}
+
 void k4a_image_set_device_timestamp_usec(k4a_image_t image_handle, uint64_t timestamp_usec)
 {
     image_set_device_timestamp_usec(image_handle, timestamp_usec);
@@ -840,6 +1122,77 @@ static k4a_result_t validate_configuration(k4a_context_t *device, const k4a_devi
     return result;
 }
 
+k4a_result_t k4a_device_set_buffer_preallocation(k4a_device_t device_handle, k4a_buffer_preallocation_t preallocation)
+{
+    RETURN_VALUE_IF_HANDLE_INVALID(K4A_RESULT_FAILED, k4a_device_t, device_handle);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED,
+                        preallocation < K4A_BUFFER_PREALLOCATION_NONE ||
+                            preallocation > K4A_BUFFER_PREALLOCATION_PREFAULT_AND_LOCK);
+    k4a_context_t *device = k4a_device_t_get_context(device_handle);
+
+    if (device->depth_started == true || device->color_started == true)
+    {
+        LOG_ERROR("k4a_device_set_buffer_preallocation called while the cameras are running, stop the cameras", 0);
+        return K4A_RESULT_FAILED;
+    }
+
+    device->buffer_preallocation = preallocation;
+    return K4A_RESULT_SUCCEEDED;
+}
+
+// Sets aside prefaulted frame buffers for each stream the configuration enables. Color buffers are sized and filled
+// from the configured format here. Depth and raw USB buffer sizes depend on the depth engine, so depth_start() fills
+// those pools with allocator_pool_prepare() before it returns; a failure to allocate or lock them fails the start.
+static k4a_result_t preallocate_frame_buffers(k4a_context_t *device, const k4a_device_configuration_t *config)
+{
+    bool lock_memory = device->buffer_preallocation == K4A_BUFFER_PREALLOCATION_PREFAULT_AND_LOCK;
+    size_t color_size = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+
+    if (k4a_convert_resolution_to_width_height(config->color_resolution, &width, &height))
+    {
+        switch (config->color_format)
+        {
+        case K4A_IMAGE_FORMAT_COLOR_NV12:
+            color_size = (size_t)width * height * 3 / 2;
+            break;
+        case K4A_IMAGE_FORMAT_COLOR_BGRA32:
+            color_size = (size_t)width * height * 4;
+            break;
+        default:
+            // MJPG frames vary in size; they do not exceed the size of the equivalent YUY2 frame in practice
+            color_size = (size_t)width * height * 2;
+            break;
+        }
+    }
+
+    // Pools are enabled for all three sources so that k4a_device_stop_cameras() can always disable all three
+    k4a_result_t result =
+        TRACE_CALL(allocator_pool_enable(ALLOCATION_SOURCE_COLOR, color_size, PREALLOCATED_FRAME_COUNT, lock_memory));
+    if (K4A_SUCCEEDED(result))
+    {
+        result = TRACE_CALL(allocator_pool_enable(ALLOCATION_SOURCE_DEPTH, 0, PREALLOCATED_FRAME_COUNT, lock_memory));
+        if (K4A_FAILED(result))
+        {
+            allocator_pool_disable(ALLOCATION_SOURCE_COLOR);
+        }
+    }
+    if (K4A_SUCCEEDED(result))
+    {
+        result = TRACE_CALL(
+            allocator_pool_enable(ALLOCATION_SOURCE_USB_DEPTH, 0, PREALLOCATED_FRAME_COUNT, lock_memory));
+        if (K4A_FAILED(result))
+        {
+            allocator_pool_disable(ALLOCATION_SOURCE_COLOR);
+            allocator_pool_disable(ALLOCATION_SOURCE_DEPTH);
+        }
+    }
+
+    device->buffers_preallocated = K4A_SUCCEEDED(result);
+    return result;
+}
+
 k4a_result_t k4a_device_start_cameras(k4a_device_t device_handle, const k4a_device_configuration_t *config)
 {
     RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, config == NULL);
@@ -875,9 +1228,15 @@ k4a_result_t k4a_device_start_cameras(k4a_device_t device_handle, const k4a_devi
         LOG_INFO("    wired_sync_mode:%d", config->wired_sync_mode);
         LOG_INFO("    subordinate_delay_off_master_usec:%d", config->subordinate_delay_off_master_usec);
         LOG_INFO("    disable_streaming_indicator:%d", config->disable_streaming_indicator);
+        LOG_INFO("    buffer_preallocation:%d", device->buffer_preallocation);
         result = TRACE_CALL(validate_configuration(device, config));
     }
 
+    if (K4A_SUCCEEDED(result) && device->buffer_preallocation != K4A_BUFFER_PREALLOCATION_NONE)
+    {
+        result = TRACE_CALL(preallocate_frame_buffers(device, config));
+    }
+
     if (K4A_SUCCEEDED(result))
     {
         result = TRACE_CALL(colormcu_set_multi_device_mode(device->colormcu, config));
@@ -949,6 +1308,14 @@ void k4a_device_stop_cameras(k4a_device_t device_handle)
         device->color_started = false;
     }
 
+    if (device->buffers_preallocated)
+    {
+        allocator_pool_disable(ALLOCATION_SOURCE_COLOR);
+        allocator_pool_disable(ALLOCATION_SOURCE_DEPTH);
+        allocator_pool_disable(ALLOCATION_SOURCE_USB_DEPTH);
+        device->buffers_preallocated = false;
+    }
+
     LOG_INFO("k4a_device_stop_cameras stopped", 0);
 }
 
@@ -1153,6 +1520,17 @@ k4a_transformation_t k4a_transformation_create(const k4a_calibration_t *calibrat
     return transformation_create(calibration, TRANSFORM_ENABLE_GPU_OPTIMIZATION);
 }
 
+k4a_transformation_t k4a_transformation_create_auto_tuned(const k4a_calibration_t *calibration)
+{
+    return transformation_create_auto_tuned(calibration, TRANSFORM_ENABLE_GPU_OPTIMIZATION);
+}
+
+k4a_result_t k4a_transformation_get_tuning(k4a_transformation_t transformation_handle,
+                                           k4a_transformation_tuning_t *tuning)
+{
+    return transformation_get_tuning(transformation_handle, tuning);
+}
+
 void k4a_transformation_destroy(k4a_transformation_t transformation_handle)
 {
     transformation_destroy(transformation_handle);
@@ -1201,6 +1579,13 @@ k4a_result_t k4a_transformation_depth_image_to_color_camera(k4a_transformation_t
                                                                         invalid_custom_value));
 }
 
+k4a_result_t k4a_transformation_set_incremental(k4a_transformation_t transformation_handle,
+                                                bool enable,
+                                                float max_changed_fraction)
+{
+    return TRACE_CALL(transformation_set_incremental(transformation_handle, enable, max_changed_fraction));
+}
+
 k4a_result_t
 k4a_transformation_depth_image_to_color_camera_custom(k4a_transformation_t transformation_handle,
                                                       const k4a_image_t depth_image,
@@ -1235,6 +1620,74 @@ k4a_transformation_depth_image_to_color_camera_custom(k4a_transformation_t trans
                                                                         invalid_custom_value));
 }
 
+k4a_result_t
+k4a_transformation_depth_image_to_color_camera_custom_channels(k4a_transformation_t transformation_handle,
+                                                               const k4a_image_t depth_image,
+                                                               k4a_image_t transformed_depth_image,
+                                                               const k4a_transformation_custom_channel_t *channels,
+                                                               uint32_t channel_count)
+{
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, channel_count > K4A_TRANSFORMATION_MAX_CUSTOM_CHANNELS);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, channel_count > 0 && channels == NULL);
+
+    k4a_transformation_image_descriptor_t depth_image_descriptor = k4a_image_get_descriptor(depth_image);
+    k4a_transformation_image_descriptor_t transformed_depth_image_descriptor = k4a_image_get_descriptor(
+        transformed_depth_image);
+
+    k4a_transformation_image_descriptor_t custom_descriptors[K4A_TRANSFORMATION_MAX_CUSTOM_CHANNELS];
+    k4a_transformation_image_descriptor_t transformed_custom_descriptors[K4A_TRANSFORMATION_MAX_CUSTOM_CHANNELS];
+    k4a_transformation_custom_plane_t planes[K4A_TRANSFORMATION_MAX_CUSTOM_CHANNELS];
+    for (uint32_t i = 0; i < channel_count; i++)
+    {
+        custom_descriptors[i] = k4a_image_get_descriptor(channels[i].custom_image);
+        transformed_custom_descriptors[i] = k4a_image_get_descriptor(channels[i].transformed_custom_image);
+        planes[i].custom_image_data = k4a_image_get_buffer(channels[i].custom_image);
+        planes[i].custom_image_descriptor = &custom_descriptors[i];
+        planes[i].transformed_custom_image_data = k4a_image_get_buffer(channels[i].transformed_custom_image);
+        planes[i].transformed_custom_image_descriptor = &transformed_custom_descriptors[i];
+        planes[i].interpolation_type = channels[i].interpolation_type;
+        planes[i].invalid_custom_value = channels[i].invalid_custom_value;
+    }
+
+    return TRACE_CALL(transformation_depth_image_to_color_camera_channels(transformation_handle,
+                                                                          k4a_image_get_buffer(depth_image),
+                                                                          &depth_image_descriptor,
+                                                                          k4a_image_get_buffer(transformed_depth_image),
+                                                                          &transformed_depth_image_descriptor,
+                                                                          planes,
+                                                                          channel_count));
+}
+
+k4a_result_t k4a_transformation_ir_image_to_color_camera(k4a_transformation_t transformation_handle,
+                                                         const k4a_image_t depth_image,
+                                                         const k4a_image_t ir_image,
+                                                         k4a_image_t transformed_ir_image,
+                                                         k4a_image_t transformed_depth_image)
+{
+    k4a_transformation_image_descriptor_t depth_image_descriptor = k4a_image_get_descriptor(depth_image);
+    k4a_transformation_image_descriptor_t ir_image_descriptor = k4a_image_get_descriptor(ir_image);
+    k4a_transformation_image_descriptor_t transformed_ir_image_descriptor = k4a_image_get_descriptor(
+        transformed_ir_image);
+
+    uint8_t *transformed_depth_image_buffer = NULL;
+    k4a_transformation_image_descriptor_t transformed_depth_image_descriptor = { 0 };
+    if (transformed_depth_image != NULL)
+    {
+        transformed_depth_image_descriptor = k4a_image_get_descriptor(transformed_depth_image);
+        transformed_depth_image_buffer = k4a_image_get_buffer(transformed_depth_image);
+    }
+
+    return TRACE_CALL(transformation_ir_image_to_color_camera(transformation_handle,
+                                                              k4a_image_get_buffer(depth_image),
+                                                              &depth_image_descriptor,
+                                                              k4a_image_get_buffer(ir_image),
+                                                              &ir_image_descriptor,
+                                                              k4a_image_get_buffer(transformed_ir_image),
+                                                              &transformed_ir_image_descriptor,
+                                                              transformed_depth_image_buffer,
+                                                              &transformed_depth_image_descriptor));
+}
+
 k4a_result_t k4a_transformation_color_image_to_depth_camera(k4a_transformation_t transformation_handle,
                                                             const k4a_image_t depth_image,
                                                             const k4a_image_t color_image,
@@ -1286,6 +1739,109 @@ k4a_result_t k4a_transformation_depth_image_to_point_cloud(k4a_transformation_t
                                                                 &xyz_image_descriptor));
 }
 
+k4a_buffer_result_t k4a_transformation_depth_image_to_mesh(k4a_transformation_t transformation_handle,
+                                                           const k4a_image_t depth_image,
+                                                           const k4a_calibration_type_t camera,
+                                                           float max_discontinuity_ratio,
+                                                           k4a_image_t xyz_image,
+                                                           uint32_t *indices,
+                                                           size_t *index_count)
+{
+    k4a_transformation_image_descriptor_t depth_image_descriptor = k4a_image_get_descriptor(depth_image);
+    k4a_transformation_image_descriptor_t xyz_image_descriptor = k4a_image_get_descriptor(xyz_image);
+
+    return TRACE_BUFFER_CALL(transformation_depth_image_to_mesh(transformation_handle,
+                                                                k4a_image_get_buffer(depth_image),
+                                                                &depth_image_descriptor,
+                                                                camera,
+                                                                max_discontinuity_ratio,
+                                                                k4a_image_get_buffer(xyz_image),
+                                                                &xyz_image_descriptor,
+                                                                indices,
+                                                                index_count));
+}
+
+k4a_buffer_result_t k4a_transformation_depth_image_to_voxel_cloud(k4a_transformation_t transformation_handle,
+                                                                  const k4a_image_t depth_image,
+                                                                  const k4a_image_t color_image,
+                                                                  const k4a_calibration_type_t camera,
+                                                                  const k4a_voxel_grid_t *grid,
+                                                                  k4a_voxel_point_t *points,
+                                                                  size_t *point_count)
+{
+    k4a_transformation_image_descriptor_t depth_image_descriptor = k4a_image_get_descriptor(depth_image);
+
+    uint8_t *color_image_buffer = NULL;
+    k4a_transformation_image_descriptor_t color_image_descriptor = { 0 };
+    if (color_image != NULL)
+    {
+        color_image_descriptor = k4a_image_get_descriptor(color_image);
+        color_image_buffer = k4a_image_get_buffer(color_image);
+    }
+
+    return TRACE_BUFFER_CALL(transformation_depth_image_to_voxel_cloud(transformation_handle,
+                                                                       k4a_image_get_buffer(depth_image),
+                                                                       &depth_image_descriptor,
+                                                                       color_image_buffer,
+                                                                       &color_image_descriptor,
+                                                                       camera,
+                                                                       grid,
+                                                                       points,
+                                                                       point_count));
+}
+
+k4a_result_t k4a_transformation_set_max_in_flight(k4a_transformation_t transformation_handle, uint32_t max_in_flight)
+{
+    return TRACE_CALL(transformation_set_max_in_flight(transformation_handle, max_in_flight));
+}
+
+k4a_wait_result_t k4a_transformation_submit(k4a_transformation_t transformation_handle,
+                                            const k4a_transformation_request_t *request,
+                                            int32_t timeout_in_ms,
+                                            k4a_transformation_ticket_t *ticket)
+{
+    return transformation_submit(transformation_handle, request, timeout_in_ms, ticket);
+}
+
+k4a_wait_result_t k4a_transformation_wait(k4a_transformation_t transformation_handle,
+                                          k4a_transformation_ticket_t ticket,
+                                          int32_t timeout_in_ms,
+                                          k4a_result_t *result)
+{
+    return transformation_wait(transformation_handle, ticket, timeout_in_ms, result);
+}
+
+k4a_result_t k4a_transformation_pipeline_create(k4a_transformation_t transformation_handle,
+                                                const k4a_transformation_pipeline_config_t *config,
+                                                k4a_transformation_pipeline_t *pipeline_handle)
+{
+    return TRACE_CALL(transformation_pipeline_create(transformation_handle, config, pipeline_handle));
+}
+
+void k4a_transformation_pipeline_destroy(k4a_transformation_pipeline_t pipeline_handle)
+{
+    transformation_pipeline_destroy(pipeline_handle);
+}
+
+k4a_wait_result_t k4a_transformation_pipeline_submit(k4a_transformation_pipeline_t pipeline_handle,
+                                                     k4a_capture_t capture_handle,
+                                                     int32_t timeout_in_ms)
+{
+    return transformation_pipeline_submit(pipeline_handle, capture_handle, timeout_in_ms);
+}
+
+k4a_wait_result_t k4a_transformation_pipeline_get_result(k4a_transformation_pipeline_t pipeline_handle,
+                                                         k4a_transformation_pipeline_result_t *result,
+                                                         int32_t timeout_in_ms)
+{
+    return transformation_pipeline_get_result(pipeline_handle, result, timeout_in_ms);
+}
+
+void k4a_transformation_pipeline_release_result(k4a_transformation_pipeline_result_t *result)
+{
+    transformation_pipeline_release_result(result);
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -14,23 +14,8 @@
 #include <stdlib.h>
 #include <stdbool.h>
 
-typedef struct _tewrapper_context_t
+typedef struct _tewrapper_frame_t
 {
-    k4a_transform_engine_calibration_t *transform_engine_calibration; // Copy of transform engine calibration passed in
-                                                                      // - we do not own this memory
-    k4a_transform_engine_context_t *transform_engine;
-
-    THREAD_HANDLE thread;
-    LOCK_HANDLE main_lock;
-    COND_HANDLE main_condition;
-    LOCK_HANDLE worker_lock;
-    COND_HANDLE worker_condition;
-    volatile bool thread_started;
-    volatile bool thread_stop;
-    volatile bool worker_locked;
-    k4a_result_t thread_start_result;
-    k4a_result_t thread_processing_result;
-
     k4a_transform_engine_type_t type;
     const void *depth_image_data;
     size_t depth_image_size;
@@ -42,11 +27,64 @@ typedef struct _tewrapper_context_t
     size_t transformed_image2_size;
     k4a_transform_engine_interpolation_t interpolation;
     uint32_t invalid_value;
+    tewrapper_complete_cb_t *callback;
+    void *callback_context;
+} tewrapper_frame_t;
+
+typedef struct _tewrapper_context_t
+{
+    k4a_transform_engine_calibration_t *transform_engine_calibration; // Copy of transform engine calibration passed in
+                                                                      // - we do not own this memory
+    k4a_transform_engine_context_t *transform_engine;
 
+    THREAD_HANDLE thread;
+    LOCK_HANDLE lock;
+    COND_HANDLE work_condition;     // Posted to the transform engine thread when a frame is queued or it should stop
+    COND_HANDLE space_condition;    // Broadcast when a queued frame is taken or the thread exits
+    COND_HANDLE complete_condition; // Broadcast when the thread has started and when a synchronous frame completes
+    uint32_t space_waiters;         // Threads waiting on space_condition, protected by lock
+    uint32_t complete_waiters;      // Threads waiting on complete_condition, protected by lock
+    volatile bool thread_started;
+    volatile bool thread_running; // Cleared when the thread exits, after which submitted frames fail immediately
+    volatile bool thread_stop;
+    k4a_result_t thread_start_result;
+
+    // Frames waiting for the transform engine thread, protected by lock
+    tewrapper_frame_t frames[TEWRAPPER_MAX_QUEUED_FRAMES];
+    uint32_t frames_head;
+    uint32_t frames_count;
 } tewrapper_context_t;
 
+// Completion state for tewrapper_process_frame, which waits for its frame on the caller's thread
+typedef struct _tewrapper_sync_frame_t
+{
+    tewrapper_context_t *tewrapper;
+    volatile bool complete;
+    k4a_result_t result;
+} tewrapper_sync_frame_t;
+
 K4A_DECLARE_CONTEXT(tewrapper_t, tewrapper_context_t);
 
+// Condition_Post wakes a single waiter, so it is posted once per waiting thread. Each waiter re-checks its predicate.
+// Must be called while holding the lock.
+static void tewrapper_broadcast_locked(COND_HANDLE condition, uint32_t waiters)
+{
+    for (uint32_t i = 0; i < waiters; i++)
+    {
+        Condition_Post(condition);
+    }
+}
+
+// Waits on a condition that is broadcast with tewrapper_broadcast_locked(). Must be called while holding the lock.
+static COND_RESULT tewrapper_wait_locked(tewrapper_context_t *tewrapper, COND_HANDLE condition, uint32_t *waiters)
+{
+    int infinite_timeout = 0;
+    (*waiters)++;
+    COND_RESULT cond_result = Condition_Wait(condition, tewrapper->lock, infinite_timeout);
+    (*waiters)--;
+    return cond_result;
+}
+
 static k4a_result_t transform_engine_start_helper(tewrapper_context_t *tewrapper)
 {
     assert(tewrapper->transform_engine == NULL);
@@ -77,6 +115,51 @@ static void transform_engine_stop_helper(tewrapper_context_t *tewrapper)
     }
 }
 
+static k4a_result_t transform_engine_process_helper(tewrapper_context_t *tewrapper, const tewrapper_frame_t *frame)
+{
+    k4a_result_t result = K4A_RESULT_SUCCEEDED;
+
+    if (frame->type == K4A_TRANSFORM_ENGINE_TYPE_DEPTH_TO_COLOR ||
+        frame->type == K4A_TRANSFORM_ENGINE_TYPE_COLOR_TO_DEPTH)
+    {
+        size_t transform_engine_output_buffer_size =
+            deloader_transform_engine_get_output_frame_size(tewrapper->transform_engine, frame->type);
+        if (frame->transformed_image_size != transform_engine_output_buffer_size)
+        {
+            LOG_ERROR("Transform engine output buffer size not expected. Expect: %d, Actual: %d.",
+                      transform_engine_output_buffer_size,
+                      frame->transformed_image_size);
+            result = K4A_RESULT_FAILED;
+        }
+    }
+    else if (frame->type == K4A_TRANSFORM_ENGINE_TYPE_DEPTH_CUSTOM8_TO_COLOR ||
+             frame->type == K4A_TRANSFORM_ENGINE_TYPE_DEPTH_CUSTOM16_TO_COLOR)
+    {
+        size_t transform_engine_output_buffer_size =
+            deloader_transform_engine_get_output_frame_size(tewrapper->transform_engine,
+                                                            K4A_TRANSFORM_ENGINE_TYPE_DEPTH_TO_COLOR);
+        if (frame->transformed_image_size != transform_engine_output_buffer_size)
+        {
+            LOG_ERROR("Transform engine output buffer size not expected. Expect: %d, Actual: %d.",
+                      transform_engine_output_buffer_size,
+                      frame->transformed_image_size);
+            result = K4A_RESULT_FAILED;
+        }
+
+        size_t transform_engine_output_buffer2_size =
+            deloader_transform_engine_get_output_frame_size(tewrapper->transform_engine, frame->type);
+        if (frame->transformed_image2_size != transform_engine_output_buffer2_size)
+        {
+            LOG_ERROR("Transform engine output buffer 2 size not expected. Expect: %d, Actual: %d.",
+                      transform_engine_output_buffer2_size,
+                      frame->transformed_image2_size);
+            result = K4A_RESULT_FAILED;
+        }
+    }
+
+    return result;
+}
+
 static int transform_engine_thread(void *param)
 {
     tewrapper_context_t *tewrapper = (tewrapper_context_t *)param;
@@ -87,102 +170,99 @@ static int transform_engine_thread(void *param)
 
     // The Start routine is blocked waiting for this thread to complete startup, so we signal it here and share our
     // startup status.
-    Lock(tewrapper->main_lock);
+    Lock(tewrapper->lock);
     tewrapper->thread_started = true;
+    tewrapper->thread_running = K4A_SUCCEEDED(result);
     tewrapper->thread_start_result = result;
-    tewrapper->worker_locked = false;
-    Condition_Post(tewrapper->main_condition);
-    Unlock(tewrapper->main_lock);
+    tewrapper_broadcast_locked(tewrapper->complete_condition, tewrapper->complete_waiters);
+    Unlock(tewrapper->lock);
 
-    while (result != K4A_RESULT_FAILED && tewrapper->thread_stop == false)
+    while (K4A_SUCCEEDED(result))
     {
-        // Waiting the main thread to request processing a frame
-        Lock(tewrapper->worker_lock);
-        tewrapper->worker_locked = true;
-        Condition_Post(tewrapper->main_condition);
-        int infinite_timeout = 0;
-        COND_RESULT cond_result = Condition_Wait(tewrapper->worker_condition, tewrapper->worker_lock, infinite_timeout);
-        result = K4A_RESULT_FROM_BOOL(cond_result == COND_OK);
+        // Wait for the next queued frame; frames queued before a stop are still processed
+        tewrapper_frame_t frame = { 0 };
+        bool have_frame = false;
+
+        Lock(tewrapper->lock);
+        while (tewrapper->thread_stop == false && tewrapper->frames_count == 0 && K4A_SUCCEEDED(result))
+        {
+            int infinite_timeout = 0;
+            COND_RESULT cond_result = Condition_Wait(tewrapper->work_condition, tewrapper->lock, infinite_timeout);
+            result = K4A_RESULT_FROM_BOOL(cond_result == COND_OK);
+        }
 
-        if (tewrapper->thread_stop == false)
+        if (K4A_SUCCEEDED(result) && tewrapper->frames_count > 0)
         {
-            if (K4A_SUCCEEDED(result))
+            frame = tewrapper->frames[tewrapper->frames_head];
+            tewrapper->frames_head = (tewrapper->frames_head + 1) % TEWRAPPER_MAX_QUEUED_FRAMES;
+            tewrapper->frames_count--;
+            have_frame = true;
+
+            // Room for another frame
+            tewrapper_broadcast_locked(tewrapper->space_condition, tewrapper->space_waiters);
+        }
+        Unlock(tewrapper->lock);
+
+        if (!have_frame)
+        {
+            break;
+        }
+
+        k4a_result_t frame_result = TRACE_CALL(transform_engine_process_helper(tewrapper, &frame));
+        if (K4A_SUCCEEDED(frame_result))
+        {
+            k4a_depth_engine_result_code_t teresult =
+                deloader_transform_engine_process_frame(tewrapper->transform_engine,
+                                                        frame.type,
+                                                        frame.depth_image_data,
+                                                        frame.depth_image_size,
+                                                        frame.image2_data,
+                                                        frame.image2_size,
+                                                        frame.transformed_image_data,
+                                                        frame.transformed_image_size,
+                                                        frame.transformed_image2_data,
+                                                        frame.transformed_image2_size,
+                                                        frame.interpolation,
+                                                        frame.invalid_value);
+            if (teresult == K4A_DEPTH_ENGINE_RESULT_FATAL_ERROR_WAIT_PROCESSING_COMPLETE_FAILED ||
+                teresult == K4A_DEPTH_ENGINE_RESULT_FATAL_ERROR_GPU_TIMEOUT)
             {
-                if (tewrapper->type == K4A_TRANSFORM_ENGINE_TYPE_DEPTH_TO_COLOR ||
-                    tewrapper->type == K4A_TRANSFORM_ENGINE_TYPE_COLOR_TO_DEPTH)
-                {
-                    size_t transform_engine_output_buffer_size =
-                        deloader_transform_engine_get_output_frame_size(tewrapper->transform_engine, tewrapper->type);
-                    if (tewrapper->transformed_image_size != transform_engine_output_buffer_size)
-                    {
-                        LOG_ERROR("Transform engine output buffer size not expected. Expect: %d, Actual: %d.",
-                                  transform_engine_output_buffer_size,
-                                  tewrapper->transformed_image_size);
-                        result = K4A_RESULT_FAILED;
-                    }
-                }
-                else if (tewrapper->type == K4A_TRANSFORM_ENGINE_TYPE_DEPTH_CUSTOM8_TO_COLOR ||
-                         tewrapper->type == K4A_TRANSFORM_ENGINE_TYPE_DEPTH_CUSTOM16_TO_COLOR)
-                {
-                    size_t transform_engine_output_buffer_size =
-                        deloader_transform_engine_get_output_frame_size(tewrapper->transform_engine,
-                                                                        K4A_TRANSFORM_ENGINE_TYPE_DEPTH_TO_COLOR);
-                    if (tewrapper->transformed_image_size != transform_engine_output_buffer_size)
-                    {
-                        LOG_ERROR("Transform engine output buffer size not expected. Expect: %d, Actual: %d.",
-                                  transform_engine_output_buffer_size,
-                                  tewrapper->transformed_image_size);
-                        result = K4A_RESULT_FAILED;
-                    }
-
-                    size_t transform_engine_output_buffer2_size =
-                        deloader_transform_engine_get_output_frame_size(tewrapper->transform_engine, tewrapper->type);
-                    if (tewrapper->transformed_image2_size != transform_engine_output_buffer2_size)
-                    {
-                        LOG_ERROR("Transform engine output buffer 2 size not expected. Expect: %d, Actual: %d.",
-                                  transform_engine_output_buffer2_size,
-                                  tewrapper->transformed_image2_size);
-                        result = K4A_RESULT_FAILED;
-                    }
-                }
+                LOG_ERROR("Timeout during depth engine process frame.", 0);
+                LOG_ERROR("SDK should be restarted since it looks like GPU has encountered an unrecoverable error.", 0);
+                frame_result = K4A_RESULT_FAILED;
             }
-
-            if (K4A_SUCCEEDED(result))
+            else if (teresult != K4A_DEPTH_ENGINE_RESULT_SUCCEEDED)
             {
-                k4a_depth_engine_result_code_t teresult =
-                    deloader_transform_engine_process_frame(tewrapper->transform_engine,
-                                                            tewrapper->type,
-                                                            tewrapper->depth_image_data,
-                                                            tewrapper->depth_image_size,
-                                                            tewrapper->image2_data,
-                                                            tewrapper->image2_size,
-                                                            tewrapper->transformed_image_data,
-                                                            tewrapper->transformed_image_size,
-                                                            tewrapper->transformed_image2_data,
-                                                            tewrapper->transformed_image2_size,
-                                                            tewrapper->interpolation,
-                                                            tewrapper->invalid_value);
-                if (teresult == K4A_DEPTH_ENGINE_RESULT_FATAL_ERROR_WAIT_PROCESSING_COMPLETE_FAILED ||
-                    teresult == K4A_DEPTH_ENGINE_RESULT_FATAL_ERROR_GPU_TIMEOUT)
-                {
-                    LOG_ERROR("Timeout during depth engine process frame.", 0);
-                    LOG_ERROR("SDK should be restarted since it looks like GPU has encountered an unrecoverable error.",
-                              0);
-                    result = K4A_RESULT_FAILED;
-                }
-                else if (teresult != K4A_DEPTH_ENGINE_RESULT_SUCCEEDED)
-                {
-                    LOG_ERROR("Transform engine process frame failed with error code: %d.", teresult);
-                    result = K4A_RESULT_FAILED;
-                }
+                LOG_ERROR("Transform engine process frame failed with error code: %d.", teresult);
+                frame_result = K4A_RESULT_FAILED;
             }
+
+            // The engine may be unusable after a failure, so stop processing; queued frames are failed below
+            result = frame_result;
         }
 
-        // Notify the API thread that transform engine thread completed a frame processing
-        tewrapper->thread_processing_result = result;
-        Condition_Post(tewrapper->main_condition);
-        Unlock(tewrapper->worker_lock);
-        tewrapper->worker_locked = false;
+        // Notify the submitter that the frame has been processed
+        frame.callback(frame.callback_context, frame_result);
+    }
+
+    // Fail the frames that will not be processed; no more can be queued once thread_running is cleared
+    tewrapper_frame_t abandoned_frames[TEWRAPPER_MAX_QUEUED_FRAMES];
+    uint32_t abandoned_count = 0;
+
+    Lock(tewrapper->lock);
+    tewrapper->thread_running = false;
+    while (tewrapper->frames_count > 0)
+    {
+        abandoned_frames[abandoned_count++] = tewrapper->frames[tewrapper->frames_head];
+        tewrapper->frames_head = (tewrapper->frames_head + 1) % TEWRAPPER_MAX_QUEUED_FRAMES;
+        tewrapper->frames_count--;
+    }
+    tewrapper_broadcast_locked(tewrapper->space_condition, tewrapper->space_waiters);
+    Unlock(tewrapper->lock);
+
+    for (uint32_t i = 0; i < abandoned_count; i++)
+    {
+        abandoned_frames[i].callback(abandoned_frames[i].callback_context, K4A_RESULT_FAILED);
     }
 
     transform_engine_stop_helper(tewrapper);
@@ -190,6 +270,84 @@ static int transform_engine_thread(void *param)
     return (int)result;
 }
 
+k4a_result_t tewrapper_submit_frame(tewrapper_t tewrapper_handle,
+                                    k4a_transform_engine_type_t type,
+                                    const void *depth_image_data,
+                                    size_t depth_image_size,
+                                    const void *image2_data,
+                                    size_t image2_size,
+                                    void *transformed_image_data,
+                                    size_t transformed_image_size,
+                                    void *transformed_image2_data,
+                                    size_t transformed_image2_size,
+                                    k4a_transform_engine_interpolation_t interpolation,
+                                    uint32_t invalid_value,
+                                    tewrapper_complete_cb_t *callback,
+                                    void *callback_context)
+{
+    RETURN_VALUE_IF_HANDLE_INVALID(K4A_RESULT_FAILED, tewrapper_t, tewrapper_handle);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, callback == NULL);
+    tewrapper_context_t *tewrapper = tewrapper_t_get_context(tewrapper_handle);
+
+    k4a_result_t result = K4A_RESULT_SUCCEEDED;
+
+    Lock(tewrapper->lock);
+
+    // Wait for room in the queue
+    while (K4A_SUCCEEDED(result) && tewrapper->thread_running && tewrapper->thread_stop == false &&
+           tewrapper->frames_count == TEWRAPPER_MAX_QUEUED_FRAMES)
+    {
+        COND_RESULT cond_result =
+            tewrapper_wait_locked(tewrapper, tewrapper->space_condition, &tewrapper->space_waiters);
+        result = K4A_RESULT_FROM_BOOL(cond_result == COND_OK);
+    }
+
+    if (K4A_SUCCEEDED(result) && (!tewrapper->thread_running || tewrapper->thread_stop))
+    {
+        LOG_ERROR("Transform Engine thread is not running", 0);
+        result = K4A_RESULT_FAILED;
+    }
+
+    if (K4A_SUCCEEDED(result))
+    {
+        tewrapper_frame_t *frame =
+            &tewrapper->frames[(tewrapper->frames_head + tewrapper->frames_count) % TEWRAPPER_MAX_QUEUED_FRAMES];
+        frame->type = type;
+        frame->depth_image_data = depth_image_data;
+        frame->depth_image_size = depth_image_size;
+        frame->image2_data = image2_data;
+        frame->image2_size = image2_size;
+        frame->transformed_image_data = transformed_image_data;
+        frame->transformed_image_size = transformed_image_size;
+        frame->transformed_image2_data = transformed_image2_data;
+        frame->transformed_image2_size = transformed_image2_size;
+        frame->interpolation = interpolation;
+        frame->invalid_value = invalid_value;
+        frame->callback = callback;
+        frame->callback_context = callback_context;
+        tewrapper->frames_count++;
+
+        // Notify the transform engine thread to process a frame
+        Condition_Post(tewrapper->work_condition);
+    }
+
+    Unlock(tewrapper->lock);
+
+    return result;
+}
+
+static void tewrapper_sync_frame_complete(void *context, k4a_result_t result)
+{
+    tewrapper_sync_frame_t *sync_frame = (tewrapper_sync_frame_t *)context;
+    tewrapper_context_t *tewrapper = sync_frame->tewrapper;
+
+    Lock(tewrapper->lock);
+    sync_frame->result = result;
+    sync_frame->complete = true;
+    tewrapper_broadcast_locked(tewrapper->complete_condition, tewrapper->complete_waiters);
+    Unlock(tewrapper->lock);
+}
+
 k4a_result_t tewrapper_process_frame(tewrapper_t tewrapper_handle,
                                      k4a_transform_engine_type_t type,
                                      const void *depth_image_data,
@@ -203,54 +361,44 @@ k4a_result_t tewrapper_process_frame(tewrapper_t tewrapper_handle,
                                      k4a_transform_engine_interpolation_t interpolation,
                                      uint32_t invalid_value)
 {
+    RETURN_VALUE_IF_HANDLE_INVALID(K4A_RESULT_FAILED, tewrapper_t, tewrapper_handle);
     tewrapper_context_t *tewrapper = tewrapper_t_get_context(tewrapper_handle);
 
-    k4a_result_t result = K4A_RESULT_SUCCEEDED;
-
-    Lock(tewrapper->main_lock);
-
-    // Ensure the worker thread loop to acquire the worker lock before this function acquires the worker lock to avoid
-    // dead lock
-    if (!tewrapper->worker_locked)
-    {
-        int infinite_timeout = 0;
-        COND_RESULT cond_result = Condition_Wait(tewrapper->main_condition, tewrapper->main_lock, infinite_timeout);
-        result = K4A_RESULT_FROM_BOOL(cond_result == COND_OK);
-    }
+    tewrapper_sync_frame_t sync_frame = { tewrapper, false, K4A_RESULT_FAILED };
+
+    k4a_result_t result = TRACE_CALL(tewrapper_submit_frame(tewrapper_handle,
+                                                            type,
+                                                            depth_image_data,
+                                                            depth_image_size,
+                                                            image2_data,
+                                                            image2_size,
+                                                            transformed_image_data,
+                                                            transformed_image_size,
+                                                            transformed_image2_data,
+                                                            transformed_image2_size,
+                                                            interpolation,
+                                                            invalid_value,
+                                                            tewrapper_sync_frame_complete,
+                                                            &sync_frame));
 
     if (K4A_SUCCEEDED(result))
     {
-        // Notify the transform engine thread to process a frame
-        Lock(tewrapper->worker_lock);
-        tewrapper->type = type;
-        tewrapper->depth_image_data = depth_image_data;
-        tewrapper->depth_image_size = depth_image_size;
-        tewrapper->image2_data = image2_data;
-        tewrapper->image2_size = image2_size;
-        tewrapper->transformed_image_data = transformed_image_data;
-        tewrapper->transformed_image_size = transformed_image_size;
-        tewrapper->transformed_image2_data = transformed_image2_data;
-        tewrapper->transformed_image2_size = transformed_image2_size;
-        tewrapper->interpolation = interpolation;
-        tewrapper->invalid_value = invalid_value;
-        Condition_Post(tewrapper->worker_condition);
-
-        // Waiting the transform engine thread to finish processing
-        int infinite_timeout = 0;
-        COND_RESULT cond_result = Condition_Wait(tewrapper->main_condition, tewrapper->worker_lock, infinite_timeout);
-        result = K4A_RESULT_FROM_BOOL(cond_result == COND_OK);
+        // Waiting the transform engine thread to finish processing. The callback is always called once the frame has
+        // been queued, so the wait can not be abandoned while sync_frame is still referenced.
+        Lock(tewrapper->lock);
+        while (!sync_frame.complete)
+        {
+            (void)tewrapper_wait_locked(tewrapper, tewrapper->complete_condition, &tewrapper->complete_waiters);
+        }
+        Unlock(tewrapper->lock);
 
-        if (K4A_SUCCEEDED(result) && K4A_FAILED(tewrapper->thread_processing_result))
+        if (K4A_FAILED(sync_frame.result))
         {
             LOG_ERROR("Transform Engine thread failed to process", 0);
-            result = tewrapper->thread_processing_result;
+            result = sync_frame.result;
         }
-
-        Unlock(tewrapper->worker_lock);
     }
 
-    Unlock(tewrapper->main_lock);
-
     return result;
 }
 
@@ -264,24 +412,16 @@ tewrapper_t tewrapper_create(k4a_transform_engine_calibration_t *transform_engin
     tewrapper->transform_engine_calibration = transform_engine_calibration;
     tewrapper->thread_start_result = K4A_RESULT_FAILED;
 
-    tewrapper->main_lock = Lock_Init();
-    k4a_result_t result = K4A_RESULT_FROM_BOOL(tewrapper->main_lock != NULL);
-    if (K4A_SUCCEEDED(result))
-    {
-        tewrapper->worker_lock = Lock_Init();
-        result = K4A_RESULT_FROM_BOOL(tewrapper->worker_lock != NULL);
-    }
-
-    if (K4A_SUCCEEDED(result))
-    {
-        tewrapper->main_condition = Condition_Init();
-        result = K4A_RESULT_FROM_BOOL(tewrapper->main_condition != NULL);
-    }
+    tewrapper->lock = Lock_Init();
+    k4a_result_t result = K4A_RESULT_FROM_BOOL(tewrapper->lock != NULL);
 
     if (K4A_SUCCEEDED(result))
     {
-        tewrapper->worker_condition = Condition_Init();
-        result = K4A_RESULT_FROM_BOOL(tewrapper->worker_condition != NULL);
+        tewrapper->work_condition = Condition_Init();
+        tewrapper->space_condition = Condition_Init();
+        tewrapper->complete_condition = Condition_Init();
+        result = K4A_RESULT_FROM_BOOL(tewrapper->work_condition != NULL && tewrapper->space_condition != NULL &&
+                                      tewrapper->complete_condition != NULL);
     }
 
     // Start transform engine thread
@@ -296,14 +436,12 @@ tewrapper_t tewrapper_create(k4a_transform_engine_calibration_t *transform_engin
 
         if (K4A_SUCCEEDED(result))
         {
-            Lock(tewrapper->main_lock);
+            Lock(tewrapper->lock);
             locked = true;
-            if (!tewrapper->thread_started)
+            while (K4A_SUCCEEDED(result) && !tewrapper->thread_started)
             {
-                int infinite_timeout = 0;
-                COND_RESULT cond_result = Condition_Wait(tewrapper->main_condition,
-                                                         tewrapper->main_lock,
-                                                         infinite_timeout);
+                COND_RESULT cond_result =
+                    tewrapper_wait_locked(tewrapper, tewrapper->complete_condition, &tewrapper->complete_waiters);
                 result = K4A_RESULT_FROM_BOOL(cond_result == COND_OK);
             }
         }
@@ -316,7 +454,7 @@ tewrapper_t tewrapper_create(k4a_transform_engine_calibration_t *transform_engin
 
         if (locked)
         {
-            Unlock(tewrapper->main_lock);
+            Unlock(tewrapper->lock);
             locked = false;
         }
     }
@@ -335,16 +473,25 @@ void tewrapper_destroy(tewrapper_t tewrapper_handle)
     RETURN_VALUE_IF_HANDLE_INVALID(VOID_VALUE, tewrapper_t, tewrapper_handle);
     tewrapper_context_t *tewrapper = tewrapper_t_get_context(tewrapper_handle);
 
-    // Notify the transform engine thread to stop
-    Lock(tewrapper->worker_lock);
-    tewrapper->thread_stop = true;
-    Condition_Post(tewrapper->worker_condition);
-    Unlock(tewrapper->worker_lock);
-
-    Lock(tewrapper->main_lock);
-    THREAD_HANDLE thread = tewrapper->thread;
-    tewrapper->thread = NULL;
-    Unlock(tewrapper->main_lock);
+    // Notify the transform engine thread to stop. The thread processes the frames still queued before it exits, and
+    // only completes them with a failure if the engine has failed. Joining it leaves no frame in flight.
+    THREAD_HANDLE thread = NULL;
+    if (tewrapper->lock)
+    {
+        Lock(tewrapper->lock);
+        tewrapper->thread_stop = true;
+        thread = tewrapper->thread;
+        tewrapper->thread = NULL;
+        if (tewrapper->work_condition)
+        {
+            Condition_Post(tewrapper->work_condition);
+        }
+        if (tewrapper->space_condition)
+        {
+            tewrapper_broadcast_locked(tewrapper->space_condition, tewrapper->space_waiters);
+        }
+        Unlock(tewrapper->lock);
+    }
 
     if (thread)
     {
@@ -353,24 +500,22 @@ void tewrapper_destroy(tewrapper_t tewrapper_handle)
         (void)K4A_RESULT_FROM_BOOL(tresult == THREADAPI_OK); // Trace the issue, but we don't return a failure
     }
 
-    if (tewrapper->main_condition)
+    if (tewrapper->work_condition)
     {
-        Condition_Deinit(tewrapper->main_condition);
+        Condition_Deinit(tewrapper->work_condition);
     }
-
-    if (tewrapper->worker_condition)
+    if (tewrapper->space_condition)
     {
-        Condition_Deinit(tewrapper->worker_condition);
+        Condition_Deinit(tewrapper->space_condition);
     }
-
-    if (tewrapper->main_lock)
+    if (tewrapper->complete_condition)
     {
-        Lock_Deinit(tewrapper->main_lock);
+        Condition_Deinit(tewrapper->complete_condition);
     }
 
-    if (tewrapper->worker_lock)
+    if (tewrapper->lock)
     {
-        Lock_Deinit(tewrapper->worker_lock);
+        Lock_Deinit(tewrapper->lock);
     }
 
     tewrapper_t_destroy(tewrapper_handle);
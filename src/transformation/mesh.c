@@ -0,0 +1,190 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+// This library
+#include <k4ainternal/transformation.h>
+
+// Dependent libraries
+#include <k4ainternal/logging.h>
+
+// System dependencies
+#include <math.h>
+#include <string.h>
+
+typedef struct _transformation_mesh_context_t
+{
+    const k4a_transformation_xy_tables_t *xy_tables;
+    const uint16_t *depth_image;
+    int width;
+    float max_discontinuity_ratio;
+    uint32_t *indices;
+
+    // Each worker writes the triangles of its rows from the offset of its first row, assuming two triangles per quad
+    size_t band_offset[TRANSFORMATION_MAX_WORKERS];
+    size_t band_count[TRANSFORMATION_MAX_WORKERS];
+} transformation_mesh_context_t;
+
+static inline bool transformation_mesh_vertex_valid(const transformation_mesh_context_t *mesh, uint32_t index)
+{
+    return mesh->depth_image[index] != 0 && !isnan(mesh->xy_tables->x_table[index]);
+}
+
+static inline uint32_t *transformation_mesh_triangle(uint32_t *indices, uint32_t v1, uint32_t v2, uint32_t v3)
+{
+    indices[0] = v1;
+    indices[1] = v2;
+    indices[2] = v3;
+    return indices + 3;
+}
+
+// Emits the triangles of one quad, keeping the clockwise image space winding of
+// transformation_check_valid_correspondences(). A quad with one invalid vertex keeps the triangle of the other three.
+static uint32_t *transformation_mesh_quad(const transformation_mesh_context_t *mesh,
+                                          uint32_t top_left,
+                                          uint32_t *indices)
+{
+    uint32_t bottom_left = top_left + (uint32_t)mesh->width;
+    uint32_t vertices[4] = { top_left, top_left + 1, bottom_left + 1, bottom_left };
+    int invalid_vertex = -1;
+    uint16_t depth_min = UINT16_MAX;
+    uint16_t depth_max = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        if (!transformation_mesh_vertex_valid(mesh, vertices[i]))
+        {
+            if (invalid_vertex >= 0)
+            {
+                // Two or more invalid vertices leave no triangle
+                return indices;
+            }
+            invalid_vertex = i;
+            continue;
+        }
+
+        uint16_t depth = mesh->depth_image[vertices[i]];
+        depth_min = depth < depth_min ? depth : depth_min;
+        depth_max = depth > depth_max ? depth : depth_max;
+    }
+
+    // Same discontinuity test as the depth to color rasterization: the depth range of the quad relative to its nearest
+    // vertex
+    if ((float)(depth_max - depth_min) > mesh->max_discontinuity_ratio * (float)depth_min)
+    {
+        return indices;
+    }
+
+    switch (invalid_vertex)
+    {
+    case 0:
+        return transformation_mesh_triangle(indices, vertices[1], vertices[2], vertices[3]);
+    case 1:
+        return transformation_mesh_triangle(indices, vertices[0], vertices[2], vertices[3]);
+    case 2:
+        return transformation_mesh_triangle(indices, vertices[0], vertices[1], vertices[3]);
+    case 3:
+        return transformation_mesh_triangle(indices, vertices[0], vertices[1], vertices[2]);
+    default:
+        indices = transformation_mesh_triangle(indices, vertices[0], vertices[1], vertices[2]);
+        return transformation_mesh_triangle(indices, vertices[0], vertices[2], vertices[3]);
+    }
+}
+
+static void transformation_mesh_rows(void *context, uint32_t worker, uint32_t begin, uint32_t end)
+{
+    transformation_mesh_context_t *mesh = (transformation_mesh_context_t *)context;
+    size_t quads_per_row = (size_t)(mesh->width - 1);
+
+    mesh->band_offset[worker] = (size_t)begin * quads_per_row * 6;
+    uint32_t *band = mesh->indices + mesh->band_offset[worker];
+    uint32_t *indices = band;
+    for (uint32_t y = begin; y < end; y++)
+    {
+        uint32_t row = y * (uint32_t)mesh->width;
+        for (uint32_t x = 0; x < (uint32_t)quads_per_row; x++)
+        {
+            indices = transformation_mesh_quad(mesh, row + x, indices);
+        }
+    }
+    mesh->band_count[worker] = (size_t)(indices - band);
+}
+
+size_t transformation_mesh_max_index_count(const k4a_transformation_image_descriptor_t *depth_image_descriptor)
+{
+    if (depth_image_descriptor->width_pixels < 2 || depth_image_descriptor->height_pixels < 2)
+    {
+        return 0;
+    }
+    return (size_t)(depth_image_descriptor->width_pixels - 1) * (size_t)(depth_image_descriptor->height_pixels - 1) *
+           6;
+}
+
+k4a_buffer_result_t
+transformation_depth_image_to_mesh_internal(const k4a_transformation_xy_tables_t *xy_tables,
+                                            const uint8_t *depth_image_data,
+                                            const k4a_transformation_image_descriptor_t *depth_image_descriptor,
+                                            float max_discontinuity_ratio,
+                                            uint32_t *indices,
+                                            size_t *index_count)
+{
+    if (xy_tables == 0 || depth_image_data == 0 || depth_image_descriptor == 0 || index_count == 0)
+    {
+        LOG_ERROR("Depth image, xy tables and index count are required to build a mesh.", 0);
+        return K4A_BUFFER_RESULT_FAILED;
+    }
+
+    if (depth_image_descriptor->format != K4A_IMAGE_FORMAT_DEPTH16 ||
+        depth_image_descriptor->width_pixels != xy_tables->width ||
+        depth_image_descriptor->height_pixels != xy_tables->height ||
+        depth_image_descriptor->stride_bytes != depth_image_descriptor->width_pixels * (int)sizeof(uint16_t))
+    {
+        LOG_ERROR("Unexpected depth image of format %d, %dx%d with stride %d for a %dx%d camera.",
+                  depth_image_descriptor->format,
+                  depth_image_descriptor->width_pixels,
+                  depth_image_descriptor->height_pixels,
+                  depth_image_descriptor->stride_bytes,
+                  xy_tables->width,
+                  xy_tables->height);
+        return K4A_BUFFER_RESULT_FAILED;
+    }
+
+    if (!(max_discontinuity_ratio >= 0.0f))
+    {
+        LOG_ERROR("Unexpected depth discontinuity ratio %f.", (double)max_discontinuity_ratio);
+        return K4A_BUFFER_RESULT_FAILED;
+    }
+
+    size_t max_index_count = transformation_mesh_max_index_count(depth_image_descriptor);
+    if (indices == 0 || *index_count < max_index_count)
+    {
+        *index_count = max_index_count;
+        return K4A_BUFFER_RESULT_TOO_SMALL;
+    }
+
+    transformation_mesh_context_t mesh;
+    memset(&mesh, 0, sizeof(mesh));
+    mesh.xy_tables = xy_tables;
+    mesh.depth_image = (const uint16_t *)(const void *)depth_image_data;
+    mesh.width = depth_image_descriptor->width_pixels;
+    mesh.max_discontinuity_ratio = max_discontinuity_ratio;
+    mesh.indices = indices;
+
+    if (K4A_FAILED(TRACE_CALL(transformation_parallel_for((uint32_t)(depth_image_descriptor->height_pixels - 1),
+                                                          transformation_mesh_rows,
+                                                          &mesh))))
+    {
+        return K4A_BUFFER_RESULT_FAILED;
+    }
+
+    // Bands are in row order, so packing them keeps the triangles in the order a single thread would emit them
+    size_t count = 0;
+    for (uint32_t i = 0; i < TRANSFORMATION_MAX_WORKERS; i++)
+    {
+        if (mesh.band_count[i] != 0 && mesh.band_offset[i] != count)
+        {
+            memmove(indices + count, indices + mesh.band_offset[i], mesh.band_count[i] * sizeof(uint32_t));
+        }
+        count += mesh.band_count[i];
+    }
+    *index_count = count;
+    return K4A_BUFFER_RESULT_SUCCEEDED;
+}
@@ -0,0 +1,98 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+// This library
+#include <k4ainternal/transformation.h>
+
+// Dependent libraries
+#include <k4ainternal/logging.h>
+#include <azure_c_shared_utility/threadapi.h>
+
+// System dependencies
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+typedef struct _transformation_parallel_range_t
+{
+    transformation_parallel_fn_t *fn;
+    void *context;
+    uint32_t worker;
+    uint32_t begin;
+    uint32_t end;
+} transformation_parallel_range_t;
+
+uint32_t transformation_get_worker_count(void)
+{
+#ifdef _WIN32
+    SYSTEM_INFO system_info;
+    GetSystemInfo(&system_info);
+    long processors = (long)system_info.dwNumberOfProcessors;
+#else
+    long processors = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    if (processors < 1)
+    {
+        return 1;
+    }
+    return processors > TRANSFORMATION_MAX_WORKERS ? TRANSFORMATION_MAX_WORKERS : (uint32_t)processors;
+}
+
+static int transformation_parallel_thread(void *param)
+{
+    transformation_parallel_range_t *range = (transformation_parallel_range_t *)param;
+    range->fn(range->context, range->worker, range->begin, range->end);
+    return 0;
+}
+
+k4a_result_t transformation_parallel_for(uint32_t count, transformation_parallel_fn_t *fn, void *context)
+{
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, fn == NULL);
+
+    uint32_t workers = transformation_get_worker_count();
+    if (workers > count)
+    {
+        workers = count == 0 ? 1 : count;
+    }
+
+    transformation_parallel_range_t ranges[TRANSFORMATION_MAX_WORKERS];
+    THREAD_HANDLE threads[TRANSFORMATION_MAX_WORKERS] = { 0 };
+    for (uint32_t i = 0; i < workers; i++)
+    {
+        ranges[i].fn = fn;
+        ranges[i].context = context;
+        ranges[i].worker = i;
+        ranges[i].begin = (uint32_t)((uint64_t)count * i / workers);
+        ranges[i].end = (uint32_t)((uint64_t)count * (i + 1) / workers);
+    }
+
+    // The calling thread takes the first range. A range whose thread could not be started also runs here, so every
+    // range runs exactly once.
+    for (uint32_t i = 1; i < workers; i++)
+    {
+        THREADAPI_RESULT tresult = ThreadAPI_Create(&threads[i], transformation_parallel_thread, &ranges[i]);
+        if (K4A_FAILED(K4A_RESULT_FROM_BOOL(tresult == THREADAPI_OK)))
+        {
+            threads[i] = NULL;
+        }
+    }
+
+    transformation_parallel_thread(&ranges[0]);
+
+    for (uint32_t i = 1; i < workers; i++)
+    {
+        if (threads[i] == NULL)
+        {
+            transformation_parallel_thread(&ranges[i]);
+        }
+        else
+        {
+            int thread_result;
+            THREADAPI_RESULT tresult = ThreadAPI_Join(threads[i], &thread_result);
+            (void)K4A_RESULT_FROM_BOOL(tresult == THREADAPI_OK);
+        }
+    }
+    return K4A_RESULT_SUCCEEDED;
+}
@@ -0,0 +1,886 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+// This library
+#include <k4ainternal/transformation.h>
+
+// Dependent libraries
+#include <k4ainternal/allocator.h>
+#include <k4ainternal/capture.h>
+#include <k4ainternal/common.h>
+#include <k4ainternal/image.h>
+#include <k4ainternal/logging.h>
+#include <azure_c_shared_utility/condition.h>
+#include <azure_c_shared_utility/lock.h>
+#include <azure_c_shared_utility/threadapi.h>
+
+// System dependencies
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PIPELINE_DEFAULT_IN_FLIGHT (4)
+#define PIPELINE_MAX_IN_FLIGHT (32)
+
+#define PIPELINE_ALL_OUTPUTS                                                                                           \
+    (K4A_TRANSFORMATION_PIPELINE_OUTPUT_DEPTH_IN_COLOR | K4A_TRANSFORMATION_PIPELINE_OUTPUT_COLOR_IN_DEPTH |           \
+     K4A_TRANSFORMATION_PIPELINE_OUTPUT_POINT_CLOUD | K4A_TRANSFORMATION_PIPELINE_OUTPUT_COLOR_POINT_CLOUD)
+
+#define PIPELINE_COLOR_OUTPUTS                                                                                         \
+    (K4A_TRANSFORMATION_PIPELINE_OUTPUT_DEPTH_IN_COLOR | K4A_TRANSFORMATION_PIPELINE_OUTPUT_COLOR_IN_DEPTH |           \
+     K4A_TRANSFORMATION_PIPELINE_OUTPUT_COLOR_POINT_CLOUD)
+
+// Indexed by the bit position of the matching k4a_transformation_pipeline_output_t flag
+typedef enum
+{
+    PIPELINE_OUTPUT_DEPTH_IN_COLOR = 0,
+    PIPELINE_OUTPUT_COLOR_IN_DEPTH,
+    PIPELINE_OUTPUT_POINT_CLOUD,
+    PIPELINE_OUTPUT_COLOR_POINT_CLOUD,
+    PIPELINE_OUTPUT_COUNT,
+} pipeline_output_t;
+
+// Depth to color and color to depth run on the first stage and point clouds on the second, so the point clouds of
+// capture N are computed while capture N+1 is being transformed.
+typedef enum
+{
+    PIPELINE_STAGE_TRANSFORM = 0,
+    PIPELINE_STAGE_POINT_CLOUD,
+    PIPELINE_STAGE_COUNT,
+} pipeline_stage_t;
+
+typedef struct _pipeline_ring_t
+{
+    uint32_t slots[PIPELINE_MAX_IN_FLIGHT];
+    uint32_t head;
+    uint32_t count;
+} pipeline_ring_t;
+
+typedef struct _pipeline_state_t pipeline_state_t;
+
+typedef struct _pipeline_slot_t
+{
+    pipeline_state_t *state;
+    uint8_t *buffers[PIPELINE_OUTPUT_COUNT]; // Output buffers, reused by every capture that goes through this slot
+    bool in_use;                             // A capture has been submitted and the slot has not been recycled
+    bool delivered;                          // The result has been handed to the callback or to get_result
+    uint32_t images_outstanding;             // Output images wrapping this slot's buffers that are still alive
+    uint64_t submit_usec;
+    k4a_transformation_pipeline_result_t result;
+} pipeline_slot_t;
+
+// State shared with the output images. Output images may outlive the pipeline handle, so this is freed by whichever
+// of k4a_transformation_pipeline_destroy() or the last image release happens last.
+struct _pipeline_state_t
+{
+    LOCK_HANDLE lock;
+    COND_HANDLE slot_condition; // Posted when a slot is recycled
+    bool detached;              // The pipeline handle has been destroyed
+    uint32_t images_outstanding;
+    uint32_t slot_count;
+    pipeline_slot_t slots[PIPELINE_MAX_IN_FLIGHT];
+};
+
+typedef struct _k4a_transformation_pipeline_context_t
+{
+    pipeline_state_t *state;
+    k4a_transformation_t transformation;
+    uint32_t outputs;
+    k4a_transformation_pipeline_result_cb_t *callback;
+    void *callback_context;
+
+    k4a_transformation_image_descriptor_t depth_descriptor;
+    k4a_transformation_image_descriptor_t color_descriptor;
+    k4a_transformation_image_descriptor_t output_descriptors[PIPELINE_OUTPUT_COUNT];
+
+    // Protected by state->lock
+    volatile bool stop;
+    pipeline_ring_t stage_queue[PIPELINE_STAGE_COUNT];
+    pipeline_ring_t result_queue;
+
+    COND_HANDLE stage_condition[PIPELINE_STAGE_COUNT];
+    COND_HANDLE result_condition;
+    THREAD_HANDLE thread[PIPELINE_STAGE_COUNT];
+} k4a_transformation_pipeline_context_t;
+
+K4A_DECLARE_CONTEXT(k4a_transformation_pipeline_t, k4a_transformation_pipeline_context_t);
+
+static void pipeline_ring_push(pipeline_ring_t *ring, uint32_t slot_index)
+{
+    assert(ring->count < PIPELINE_MAX_IN_FLIGHT);
+    ring->slots[(ring->head + ring->count) % PIPELINE_MAX_IN_FLIGHT] = slot_index;
+    ring->count++;
+}
+
+static uint32_t pipeline_ring_pop(pipeline_ring_t *ring)
+{
+    assert(ring->count > 0);
+    uint32_t slot_index = ring->slots[ring->head];
+    ring->head = (ring->head + 1) % PIPELINE_MAX_IN_FLIGHT;
+    ring->count--;
+    return slot_index;
+}
+
+static k4a_transformation_image_descriptor_t pipeline_get_descriptor(k4a_image_t image)
+{
+    k4a_transformation_image_descriptor_t descriptor;
+    descriptor.width_pixels = image_get_width_pixels(image);
+    descriptor.height_pixels = image_get_height_pixels(image);
+    descriptor.stride_bytes = image_get_stride_bytes(image);
+    descriptor.format = image_get_format(image);
+    return descriptor;
+}
+
+static void pipeline_set_descriptor(k4a_transformation_image_descriptor_t *descriptor,
+                                    k4a_image_format_t format,
+                                    int width_pixels,
+                                    int height_pixels,
+                                    int bytes_per_pixel)
+{
+    descriptor->format = format;
+    descriptor->width_pixels = width_pixels;
+    descriptor->height_pixels = height_pixels;
+    descriptor->stride_bytes = width_pixels * bytes_per_pixel;
+}
+
+static void pipeline_state_destroy(pipeline_state_t *state)
+{
+    for (uint32_t i = 0; i < state->slot_count; i++)
+    {
+        for (int output = 0; output < PIPELINE_OUTPUT_COUNT; output++)
+        {
+            if (state->slots[i].buffers[output])
+            {
+                allocator_free(state->slots[i].buffers[output]);
+            }
+        }
+    }
+
+    if (state->slot_condition)
+    {
+        Condition_Deinit(state->slot_condition);
+    }
+
+    if (state->lock)
+    {
+        Lock_Deinit(state->lock);
+    }
+
+    free(state);
+}
+
+static void pipeline_slot_recycle_if_done_locked(pipeline_state_t *state, pipeline_slot_t *slot)
+{
+    if (slot->delivered && slot->images_outstanding == 0)
+    {
+        slot->in_use = false;
+        slot->delivered = false;
+        Condition_Post(state->slot_condition);
+    }
+}
+
+// image_destroy_cb_t for the output images
+static void pipeline_buffer_release(void *buffer, void *context)
+{
+    (void)buffer;
+    pipeline_slot_t *slot = (pipeline_slot_t *)context;
+    pipeline_state_t *state = slot->state;
+
+    Lock(state->lock);
+    assert(slot->images_outstanding > 0);
+    slot->images_outstanding--;
+    state->images_outstanding--;
+    pipeline_slot_recycle_if_done_locked(state, slot);
+    bool destroy = state->detached && state->images_outstanding == 0;
+    Unlock(state->lock);
+
+    if (destroy)
+    {
+        pipeline_state_destroy(state);
+    }
+}
+
+static k4a_image_t pipeline_create_output(k4a_transformation_pipeline_context_t *pipeline,
+                                          pipeline_slot_t *slot,
+                                          pipeline_output_t output,
+                                          k4a_image_t source_image)
+{
+    pipeline_state_t *state = pipeline->state;
+    const k4a_transformation_image_descriptor_t *descriptor = &pipeline->output_descriptors[output];
+    k4a_image_t image = NULL;
+
+    Lock(state->lock);
+    slot->images_outstanding++;
+    state->images_outstanding++;
+    Unlock(state->lock);
+
+    if (K4A_FAILED(TRACE_CALL(image_create_from_buffer(descriptor->format,
+                                                       descriptor->width_pixels,
+                                                       descriptor->height_pixels,
+                                                       descriptor->stride_bytes,
+                                                       slot->buffers[output],
+                                                       (size_t)descriptor->stride_bytes *
+                                                           (size_t)descriptor->height_pixels,
+                                                       pipeline_buffer_release,
+                                                       slot,
+                                                       &image))))
+    {
+        // The release callback is not called when creation fails
+        Lock(state->lock);
+        slot->images_outstanding--;
+        state->images_outstanding--;
+        Unlock(state->lock);
+        return NULL;
+    }
+
+    image_set_device_timestamp_usec(image, image_get_device_timestamp_usec(source_image));
+    image_set_system_timestamp_nsec(image, image_get_system_timestamp_nsec(source_image));
+    return image;
+}
+
+static void pipeline_output_failed(k4a_transformation_pipeline_result_t *result, k4a_image_t *image)
+{
+    if (*image)
+    {
+        image_dec_ref(*image);
+        *image = NULL;
+    }
+    result->result = K4A_RESULT_FAILED;
+}
+
+static void pipeline_run_transform_stage(k4a_transformation_pipeline_context_t *pipeline, pipeline_slot_t *slot)
+{
+    k4a_transformation_pipeline_result_t *result = &slot->result;
+    k4a_image_t depth_image = capture_get_depth_image(result->capture);
+    k4a_transformation_image_descriptor_t depth_descriptor = pipeline_get_descriptor(depth_image);
+    uint64_t start_usec = transformation_get_time_usec();
+
+    result->queued_usec = start_usec - slot->submit_usec;
+
+    if (pipeline->outputs & K4A_TRANSFORMATION_PIPELINE_OUTPUT_DEPTH_IN_COLOR)
+    {
+        // The custom image parameters are ignored when no custom image is passed in
+        k4a_transformation_image_descriptor_t dummy_descriptor = { 0 };
+        result->depth_image_in_color = pipeline_create_output(pipeline,
+                                                              slot,
+                                                              PIPELINE_OUTPUT_DEPTH_IN_COLOR,
+                                                              depth_image);
+        if (result->depth_image_in_color == NULL ||
+            K4A_FAILED(TRACE_CALL(transformation_depth_image_to_color_camera_custom(
+                pipeline->transformation,
+                image_get_buffer(depth_image),
+                &depth_descriptor,
+                NULL,
+                &dummy_descriptor,
+                image_get_buffer(result->depth_image_in_color),
+                &pipeline->output_descriptors[PIPELINE_OUTPUT_DEPTH_IN_COLOR],
+                NULL,
+                &dummy_descriptor,
+                K4A_TRANSFORMATION_INTERPOLATION_TYPE_LINEAR,
+                0))))
+        {
+            pipeline_output_failed(result, &result->depth_image_in_color);
+        }
+
+        uint64_t end_usec = transformation_get_time_usec();
+        result->depth_to_color_usec = end_usec - start_usec;
+        start_usec = end_usec;
+    }
+
+    if (pipeline->outputs & K4A_TRANSFORMATION_PIPELINE_OUTPUT_COLOR_IN_DEPTH)
+    {
+        k4a_image_t color_image = capture_get_color_image(result->capture);
+        k4a_transformation_image_descriptor_t color_descriptor = pipeline_get_descriptor(color_image);
+
+        result->color_image_in_depth = pipeline_create_output(pipeline,
+                                                              slot,
+                                                              PIPELINE_OUTPUT_COLOR_IN_DEPTH,
+                                                              depth_image);
+        if (result->color_image_in_depth == NULL ||
+            K4A_FAILED(TRACE_CALL(transformation_color_image_to_depth_camera(
+                pipeline->transformation,
+                image_get_buffer(depth_image),
+                &depth_descriptor,
+                image_get_buffer(color_image),
+                &color_descriptor,
+                image_get_buffer(result->color_image_in_depth),
+                &pipeline->output_descriptors[PIPELINE_OUTPUT_COLOR_IN_DEPTH]))))
+        {
+            pipeline_output_failed(result, &result->color_image_in_depth);
+        }
+
+        image_dec_ref(color_image);
+        result->color_to_depth_usec = transformation_get_time_usec() - start_usec;
+    }
+
+    image_dec_ref(depth_image);
+}
+
+static void pipeline_run_point_cloud_stage(k4a_transformation_pipeline_context_t *pipeline, pipeline_slot_t *slot)
+{
+    k4a_transformation_pipeline_result_t *result = &slot->result;
+    k4a_image_t depth_image = capture_get_depth_image(result->capture);
+    uint64_t start_usec = transformation_get_time_usec();
+
+    if (pipeline->outputs & K4A_TRANSFORMATION_PIPELINE_OUTPUT_POINT_CLOUD)
+    {
+        k4a_transformation_image_descriptor_t depth_descriptor = pipeline_get_descriptor(depth_image);
+        result->point_cloud = pipeline_create_output(pipeline, slot, PIPELINE_OUTPUT_POINT_CLOUD, depth_image);
+        if (result->point_cloud == NULL ||
+            K4A_FAILED(TRACE_CALL(transformation_depth_image_to_point_cloud(
+                pipeline->transformation,
+                image_get_buffer(depth_image),
+                &depth_descriptor,
+                K4A_CALIBRATION_TYPE_DEPTH,
+                image_get_buffer(result->point_cloud),
+                &pipeline->output_descriptors[PIPELINE_OUTPUT_POINT_CLOUD]))))
+        {
+            pipeline_output_failed(result, &result->point_cloud);
+        }
+    }
+
+    // Without the depth image in the color camera the failure has already been recorded by the transform stage
+    if ((pipeline->outputs & K4A_TRANSFORMATION_PIPELINE_OUTPUT_COLOR_POINT_CLOUD) && result->depth_image_in_color)
+    {
+        result->color_point_cloud = pipeline_create_output(pipeline,
+                                                           slot,
+                                                           PIPELINE_OUTPUT_COLOR_POINT_CLOUD,
+                                                           depth_image);
+        if (result->color_point_cloud == NULL ||
+            K4A_FAILED(TRACE_CALL(transformation_depth_image_to_point_cloud(
+                pipeline->transformation,
+                image_get_buffer(result->depth_image_in_color),
+                &pipeline->output_descriptors[PIPELINE_OUTPUT_DEPTH_IN_COLOR],
+                K4A_CALIBRATION_TYPE_COLOR,
+                image_get_buffer(result->color_point_cloud),
+                &pipeline->output_descriptors[PIPELINE_OUTPUT_COLOR_POINT_CLOUD]))))
+        {
+            pipeline_output_failed(result, &result->color_point_cloud);
+        }
+    }
+
+    result->point_cloud_usec = transformation_get_time_usec() - start_usec;
+    image_dec_ref(depth_image);
+}
+
+static void pipeline_deliver(k4a_transformation_pipeline_context_t *pipeline, pipeline_slot_t *slot)
+{
+    pipeline_state_t *state = pipeline->state;
+    slot->result.total_usec = transformation_get_time_usec() - slot->submit_usec;
+
+    if (pipeline->callback)
+    {
+        pipeline->callback(pipeline->callback_context, &slot->result);
+
+        // The slot may be recycled as soon as it is marked delivered, so release a copy of the result
+        k4a_transformation_pipeline_result_t result = slot->result;
+        Lock(state->lock);
+        slot->delivered = true;
+        pipeline_slot_recycle_if_done_locked(state, slot);
+        Unlock(state->lock);
+
+        transformation_pipeline_release_result(&result);
+    }
+    else
+    {
+        Lock(state->lock);
+        pipeline_ring_push(&pipeline->result_queue, (uint32_t)(slot - state->slots));
+        Condition_Post(pipeline->result_condition);
+        Unlock(state->lock);
+    }
+}
+
+// Returns NULL when the pipeline is stopping
+static pipeline_slot_t *pipeline_wait_for_stage(k4a_transformation_pipeline_context_t *pipeline, pipeline_stage_t stage)
+{
+    pipeline_state_t *state = pipeline->state;
+    pipeline_slot_t *slot = NULL;
+
+    Lock(state->lock);
+    while (!pipeline->stop && pipeline->stage_queue[stage].count == 0)
+    {
+        int infinite_timeout = 0;
+        (void)Condition_Wait(pipeline->stage_condition[stage], state->lock, infinite_timeout);
+    }
+
+    if (!pipeline->stop)
+    {
+        slot = &state->slots[pipeline_ring_pop(&pipeline->stage_queue[stage])];
+    }
+    Unlock(state->lock);
+
+    return slot;
+}
+
+static int pipeline_transform_thread(void *param)
+{
+    k4a_transformation_pipeline_context_t *pipeline = (k4a_transformation_pipeline_context_t *)param;
+    pipeline_state_t *state = pipeline->state;
+    pipeline_slot_t *slot;
+
+    while ((slot = pipeline_wait_for_stage(pipeline, PIPELINE_STAGE_TRANSFORM)) != NULL)
+    {
+        pipeline_run_transform_stage(pipeline, slot);
+
+        // Always hand the slot on, even when stopping, so destroy can find it in a queue
+        Lock(state->lock);
+        pipeline_ring_push(&pipeline->stage_queue[PIPELINE_STAGE_POINT_CLOUD], (uint32_t)(slot - state->slots));
+        Condition_Post(pipeline->stage_condition[PIPELINE_STAGE_POINT_CLOUD]);
+        Unlock(state->lock);
+    }
+
+    return 0;
+}
+
+static int pipeline_point_cloud_thread(void *param)
+{
+    k4a_transformation_pipeline_context_t *pipeline = (k4a_transformation_pipeline_context_t *)param;
+    pipeline_slot_t *slot;
+
+    while ((slot = pipeline_wait_for_stage(pipeline, PIPELINE_STAGE_POINT_CLOUD)) != NULL)
+    {
+        pipeline_run_point_cloud_stage(pipeline, slot);
+        pipeline_deliver(pipeline, slot);
+    }
+
+    return 0;
+}
+
+k4a_result_t transformation_pipeline_create(k4a_transformation_t transformation_handle,
+                                            const k4a_transformation_pipeline_config_t *config,
+                                            k4a_transformation_pipeline_t *pipeline_handle)
+{
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, config == NULL);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, pipeline_handle == NULL);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, config->outputs == 0);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, (config->outputs & ~(uint32_t)PIPELINE_ALL_OUTPUTS) != 0);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, config->max_in_flight > PIPELINE_MAX_IN_FLIGHT);
+
+    k4a_calibration_t calibration;
+    k4a_result_t result = TRACE_CALL(transformation_get_calibration(transformation_handle, &calibration));
+
+    if (K4A_SUCCEEDED(result) && calibration.depth_mode == K4A_DEPTH_MODE_OFF)
+    {
+        LOG_ERROR("Transformation pipeline requires a calibration with the depth camera enabled.", 0);
+        result = K4A_RESULT_FAILED;
+    }
+
+    if (K4A_SUCCEEDED(result) && (config->outputs & PIPELINE_COLOR_OUTPUTS) &&
+        calibration.color_resolution == K4A_COLOR_RESOLUTION_OFF)
+    {
+        LOG_ERROR("Transformation pipeline outputs 0x%x require a calibration with the color camera enabled.",
+                  config->outputs);
+        result = K4A_RESULT_FAILED;
+    }
+
+    if (K4A_FAILED(result))
+    {
+        return result;
+    }
+
+    k4a_transformation_pipeline_t handle = NULL;
+    k4a_transformation_pipeline_context_t *pipeline = k4a_transformation_pipeline_t_create(&handle);
+    result = K4A_RESULT_FROM_BOOL(pipeline != NULL);
+
+    if (K4A_SUCCEEDED(result))
+    {
+        pipeline->transformation = transformation_handle;
+        pipeline->outputs = config->outputs;
+        pipeline->callback = config->callback;
+        pipeline->callback_context = config->callback_context;
+
+        // The color point cloud is computed from the depth image in the color camera
+        if (pipeline->outputs & K4A_TRANSFORMATION_PIPELINE_OUTPUT_COLOR_POINT_CLOUD)
+        {
+            pipeline->outputs |= K4A_TRANSFORMATION_PIPELINE_OUTPUT_DEPTH_IN_COLOR;
+        }
+
+        int depth_width = calibration.depth_camera_calibration.resolution_width;
+        int depth_height = calibration.depth_camera_calibration.resolution_height;
+        int color_width = calibration.color_camera_calibration.resolution_width;
+        int color_height = calibration.color_camera_calibration.resolution_height;
+
+        pipeline_set_descriptor(&pipeline->depth_descriptor, K4A_IMAGE_FORMAT_DEPTH16, depth_width, depth_height, 2);
+        pipeline_set_descriptor(&pipeline->color_descriptor,
+                                K4A_IMAGE_FORMAT_COLOR_BGRA32,
+                                color_width,
+                                color_height,
+                                4);
+        pipeline_set_descriptor(&pipeline->output_descriptors[PIPELINE_OUTPUT_DEPTH_IN_COLOR],
+                                K4A_IMAGE_FORMAT_DEPTH16,
+                                color_width,
+                                color_height,
+                                2);
+        pipeline_set_descriptor(&pipeline->output_descriptors[PIPELINE_OUTPUT_COLOR_IN_DEPTH],
+                                K4A_IMAGE_FORMAT_COLOR_BGRA32,
+                                depth_width,
+                                depth_height,
+                                4);
+        pipeline_set_descriptor(&pipeline->output_descriptors[PIPELINE_OUTPUT_POINT_CLOUD],
+                                K4A_IMAGE_FORMAT_CUSTOM,
+                                depth_width,
+                                depth_height,
+                                3 * (int)sizeof(int16_t));
+        pipeline_set_descriptor(&pipeline->output_descriptors[PIPELINE_OUTPUT_COLOR_POINT_CLOUD],
+                                K4A_IMAGE_FORMAT_CUSTOM,
+                                color_width,
+                                color_height,
+                                3 * (int)sizeof(int16_t));
+
+        pipeline->state = (pipeline_state_t *)calloc(1, sizeof(pipeline_state_t));
+        result = K4A_RESULT_FROM_BOOL(pipeline->state != NULL);
+    }
+
+    if (K4A_SUCCEEDED(result))
+    {
+        pipeline->state->lock = Lock_Init();
+        result = K4A_RESULT_FROM_BOOL(pipeline->state->lock != NULL);
+    }
+
+    if (K4A_SUCCEEDED(result))
+    {
+        pipeline->state->slot_condition = Condition_Init();
+        result = K4A_RESULT_FROM_BOOL(pipeline->state->slot_condition != NULL);
+    }
+
+    if (K4A_SUCCEEDED(result))
+    {
+        pipeline->result_condition = Condition_Init();
+        result = K4A_RESULT_FROM_BOOL(pipeline->result_condition != NULL);
+    }
+
+    for (int stage = 0; K4A_SUCCEEDED(result) && stage < PIPELINE_STAGE_COUNT; stage++)
+    {
+        pipeline->stage_condition[stage] = Condition_Init();
+        result = K4A_RESULT_FROM_BOOL(pipeline->stage_condition[stage] != NULL);
+    }
+
+    // Allocate every output buffer now so that streaming does not allocate
+    if (K4A_SUCCEEDED(result))
+    {
+        pipeline_state_t *state = pipeline->state;
+        state->slot_count = config->max_in_flight == 0 ? PIPELINE_DEFAULT_IN_FLIGHT : config->max_in_flight;
+
+        for (uint32_t i = 0; K4A_SUCCEEDED(result) && i < state->slot_count; i++)
+        {
+            state->slots[i].state = state;
+            for (int output = 0; K4A_SUCCEEDED(result) && output < PIPELINE_OUTPUT_COUNT; output++)
+            {
+                if (pipeline->outputs & (1u << output))
+                {
+                    const k4a_transformation_image_descriptor_t *descriptor = &pipeline->output_descriptors[output];
+                    state->slots[i].buffers[output] = allocator_alloc(ALLOCATION_SOURCE_USER,
+                                                                      (size_t)descriptor->stride_bytes *
+                                                                          (size_t)descriptor->height_pixels);
+                    result = K4A_RESULT_FROM_BOOL(state->slots[i].buffers[output] != NULL);
+                }
+            }
+        }
+    }
+
+    if (K4A_SUCCEEDED(result))
+    {
+        THREADAPI_RESULT tresult = ThreadAPI_Create(&pipeline->thread[PIPELINE_STAGE_TRANSFORM],
+                                                    pipeline_transform_thread,
+                                                    pipeline);
+        result = K4A_RESULT_FROM_BOOL(tresult == THREADAPI_OK);
+    }
+
+    if (K4A_SUCCEEDED(result))
+    {
+        THREADAPI_RESULT tresult = ThreadAPI_Create(&pipeline->thread[PIPELINE_STAGE_POINT_CLOUD],
+                                                    pipeline_point_cloud_thread,
+                                                    pipeline);
+        result = K4A_RESULT_FROM_BOOL(tresult == THREADAPI_OK);
+    }
+
+    if (K4A_FAILED(result))
+    {
+        transformation_pipeline_destroy(handle);
+        handle = NULL;
+    }
+
+    *pipeline_handle = handle;
+    return result;
+}
+
+void transformation_pipeline_destroy(k4a_transformation_pipeline_t pipeline_handle)
+{
+    RETURN_VALUE_IF_HANDLE_INVALID(VOID_VALUE, k4a_transformation_pipeline_t, pipeline_handle);
+    k4a_transformation_pipeline_context_t *pipeline = k4a_transformation_pipeline_t_get_context(pipeline_handle);
+    pipeline_state_t *state = pipeline->state;
+
+    if (state && state->lock)
+    {
+        Lock(state->lock);
+        pipeline->stop = true;
+        for (int stage = 0; stage < PIPELINE_STAGE_COUNT; stage++)
+        {
+            if (pipeline->stage_condition[stage])
+            {
+                Condition_Post(pipeline->stage_condition[stage]);
+            }
+        }
+        Unlock(state->lock);
+    }
+
+    for (int stage = 0; stage < PIPELINE_STAGE_COUNT; stage++)
+    {
+        if (pipeline->thread[stage])
+        {
+            int thread_result;
+            THREADAPI_RESULT tresult = ThreadAPI_Join(pipeline->thread[stage], &thread_result);
+            (void)K4A_RESULT_FROM_BOOL(tresult == THREADAPI_OK); // Trace the issue, but we don't return a failure
+        }
+    }
+
+    if (state && state->lock)
+    {
+        // With the workers stopped every undelivered capture is waiting in one of the queues
+        pipeline_ring_t *queues[] = { &pipeline->stage_queue[PIPELINE_STAGE_TRANSFORM],
+                                      &pipeline->stage_queue[PIPELINE_STAGE_POINT_CLOUD],
+                                      &pipeline->result_queue };
+        for (size_t i = 0; i < COUNTOF(queues); i++)
+        {
+            while (queues[i]->count > 0)
+            {
+                pipeline_slot_t *slot = &state->slots[pipeline_ring_pop(queues[i])];
+                k4a_transformation_pipeline_result_t result = slot->result;
+
+                Lock(state->lock);
+                slot->delivered = true;
+                pipeline_slot_recycle_if_done_locked(state, slot);
+                Unlock(state->lock);
+
+                transformation_pipeline_release_result(&result);
+            }
+        }
+
+        Lock(state->lock);
+        state->detached = true;
+        bool destroy = state->images_outstanding == 0;
+        Unlock(state->lock);
+
+        if (!destroy)
+        {
+            // The last output image released frees the state
+            state = NULL;
+        }
+    }
+
+    if (state)
+    {
+        pipeline_state_destroy(state);
+    }
+
+    for (int stage = 0; stage < PIPELINE_STAGE_COUNT; stage++)
+    {
+        if (pipeline->stage_condition[stage])
+        {
+            Condition_Deinit(pipeline->stage_condition[stage]);
+        }
+    }
+
+    if (pipeline->result_condition)
+    {
+        Condition_Deinit(pipeline->result_condition);
+    }
+
+    k4a_transformation_pipeline_t_destroy(pipeline_handle);
+}
+
+static bool pipeline_capture_is_valid(k4a_transformation_pipeline_context_t *pipeline, k4a_capture_t capture_handle)
+{
+    bool valid = true;
+    k4a_image_t depth_image = capture_get_depth_image(capture_handle);
+    if (depth_image == NULL || image_get_format(depth_image) != K4A_IMAGE_FORMAT_DEPTH16 ||
+        image_get_width_pixels(depth_image) != pipeline->depth_descriptor.width_pixels ||
+        image_get_height_pixels(depth_image) != pipeline->depth_descriptor.height_pixels)
+    {
+        LOG_ERROR("Transformation pipeline capture requires a %dx%d DEPTH16 image.",
+                  pipeline->depth_descriptor.width_pixels,
+                  pipeline->depth_descriptor.height_pixels);
+        valid = false;
+    }
+
+    if (valid && (pipeline->outputs & K4A_TRANSFORMATION_PIPELINE_OUTPUT_COLOR_IN_DEPTH))
+    {
+        k4a_image_t color_image = capture_get_color_image(capture_handle);
+        if (color_image == NULL || image_get_format(color_image) != K4A_IMAGE_FORMAT_COLOR_BGRA32 ||
+            image_get_width_pixels(color_image) != pipeline->color_descriptor.width_pixels ||
+            image_get_height_pixels(color_image) != pipeline->color_descriptor.height_pixels)
+        {
+            LOG_ERROR("Transformation pipeline capture requires a %dx%d BGRA32 color image.",
+                      pipeline->color_descriptor.width_pixels,
+                      pipeline->color_descriptor.height_pixels);
+            valid = false;
+        }
+
+        if (color_image)
+        {
+            image_dec_ref(color_image);
+        }
+    }
+
+    if (depth_image)
+    {
+        image_dec_ref(depth_image);
+    }
+
+    return valid;
+}
+
+// Waits on condition with state->lock held, tracking the remaining time of timeout_in_ms. Returns
+// K4A_WAIT_RESULT_SUCCEEDED if the caller should check its predicate again.
+static k4a_wait_result_t pipeline_wait_locked(pipeline_state_t *state,
+                                              COND_HANDLE condition,
+                                              int32_t timeout_in_ms,
+                                              uint64_t start_usec)
+{
+    int wait_in_ms = 0; // infinite to Condition_Wait
+    if (timeout_in_ms != K4A_WAIT_INFINITE)
+    {
+        uint64_t elapsed_usec = transformation_get_time_usec() - start_usec;
+        if (elapsed_usec >= (uint64_t)timeout_in_ms * 1000)
+        {
+            return K4A_WAIT_RESULT_TIMEOUT;
+        }
+
+        // Round up so that less than a millisecond left does not become an infinite wait
+        wait_in_ms = (int)(((uint64_t)timeout_in_ms * 1000 - elapsed_usec + 999) / 1000);
+    }
+
+    COND_RESULT cond_result = Condition_Wait(condition, state->lock, wait_in_ms);
+    if (cond_result == COND_ERROR)
+    {
+        LOG_ERROR("Transformation pipeline wait failed.", 0);
+        return K4A_WAIT_RESULT_FAILED;
+    }
+    return K4A_WAIT_RESULT_SUCCEEDED;
+}
+
+k4a_wait_result_t transformation_pipeline_submit(k4a_transformation_pipeline_t pipeline_handle,
+                                                 k4a_capture_t capture_handle,
+                                                 int32_t timeout_in_ms)
+{
+    RETURN_VALUE_IF_HANDLE_INVALID(K4A_WAIT_RESULT_FAILED, k4a_transformation_pipeline_t, pipeline_handle);
+    RETURN_VALUE_IF_ARG(K4A_WAIT_RESULT_FAILED, capture_handle == NULL);
+    k4a_transformation_pipeline_context_t *pipeline = k4a_transformation_pipeline_t_get_context(pipeline_handle);
+    pipeline_state_t *state = pipeline->state;
+
+    if (!pipeline_capture_is_valid(pipeline, capture_handle))
+    {
+        return K4A_WAIT_RESULT_FAILED;
+    }
+
+    uint64_t start_usec = transformation_get_time_usec();
+    k4a_wait_result_t wresult = K4A_WAIT_RESULT_SUCCEEDED;
+    pipeline_slot_t *slot = NULL;
+
+    Lock(state->lock);
+    while (wresult == K4A_WAIT_RESULT_SUCCEEDED && slot == NULL)
+    {
+        if (pipeline->stop)
+        {
+            wresult = K4A_WAIT_RESULT_FAILED;
+            break;
+        }
+
+        for (uint32_t i = 0; i < state->slot_count && slot == NULL; i++)
+        {
+            if (!state->slots[i].in_use)
+            {
+                slot = &state->slots[i];
+            }
+        }
+
+        if (slot == NULL)
+        {
+            wresult = timeout_in_ms == 0 ?
+                          K4A_WAIT_RESULT_TIMEOUT :
+                          pipeline_wait_locked(state, state->slot_condition, timeout_in_ms, start_usec);
+        }
+    }
+
+    if (slot != NULL)
+    {
+        capture_inc_ref(capture_handle);
+        memset(&slot->result, 0, sizeof(slot->result));
+        slot->result.result = K4A_RESULT_SUCCEEDED;
+        slot->result.capture = capture_handle;
+        slot->submit_usec = transformation_get_time_usec();
+        slot->in_use = true;
+        slot->delivered = false;
+
+        pipeline_ring_push(&pipeline->stage_queue[PIPELINE_STAGE_TRANSFORM], (uint32_t)(slot - state->slots));
+        Condition_Post(pipeline->stage_condition[PIPELINE_STAGE_TRANSFORM]);
+    }
+    Unlock(state->lock);
+
+    return wresult;
+}
+
+k4a_wait_result_t transformation_pipeline_get_result(k4a_transformation_pipeline_t pipeline_handle,
+                                                     k4a_transformation_pipeline_result_t *result,
+                                                     int32_t timeout_in_ms)
+{
+    RETURN_VALUE_IF_HANDLE_INVALID(K4A_WAIT_RESULT_FAILED, k4a_transformation_pipeline_t, pipeline_handle);
+    RETURN_VALUE_IF_ARG(K4A_WAIT_RESULT_FAILED, result == NULL);
+    k4a_transformation_pipeline_context_t *pipeline = k4a_transformation_pipeline_t_get_context(pipeline_handle);
+    RETURN_VALUE_IF_ARG(K4A_WAIT_RESULT_FAILED, pipeline->callback != NULL);
+    pipeline_state_t *state = pipeline->state;
+
+    uint64_t start_usec = transformation_get_time_usec();
+    k4a_wait_result_t wresult = K4A_WAIT_RESULT_SUCCEEDED;
+
+    Lock(state->lock);
+    while (wresult == K4A_WAIT_RESULT_SUCCEEDED && pipeline->result_queue.count == 0)
+    {
+        if (pipeline->stop)
+        {
+            wresult = K4A_WAIT_RESULT_FAILED;
+        }
+        else
+        {
+            wresult = timeout_in_ms == 0 ?
+                          K4A_WAIT_RESULT_TIMEOUT :
+                          pipeline_wait_locked(state, pipeline->result_condition, timeout_in_ms, start_usec);
+        }
+    }
+
+    if (wresult == K4A_WAIT_RESULT_SUCCEEDED)
+    {
+        // Ownership of the handles moves to the caller; the slot is recycled once its images are released
+        pipeline_slot_t *slot = &state->slots[pipeline_ring_pop(&pipeline->result_queue)];
+        *result = slot->result;
+        slot->delivered = true;
+        pipeline_slot_recycle_if_done_locked(state, slot);
+    }
+    Unlock(state->lock);
+
+    return wresult;
+}
+
+void transformation_pipeline_release_result(k4a_transformation_pipeline_result_t *result)
+{
+    RETURN_VALUE_IF_ARG(VOID_VALUE, result == NULL);
+
+    k4a_image_t *images[] = { &result->depth_image_in_color,
+                              &result->color_image_in_depth,
+                              &result->point_cloud,
+                              &result->color_point_cloud };
+    for (size_t i = 0; i < COUNTOF(images); i++)
+    {
+        if (*images[i])
+        {
+            image_dec_ref(*images[i]);
+            *images[i] = NULL;
+        }
+    }
+
+    if (result->capture)
+    {
+        capture_dec_ref(result->capture);
+        result->capture = NULL;
+    }
+}
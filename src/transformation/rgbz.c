@@ -29,19 +29,25 @@ typedef struct _k4a_transformation_output_image_t
     uint16_t *data_uint16;
 } k4a_transformation_output_image_t;
 
+// A custom image carried along with the depth image by transformation_depth_to_color()
+typedef struct _k4a_transformation_rgbz_channel_t
+{
+    k4a_transformation_input_image_t image;
+    k4a_transformation_output_image_t transformed_image;
+    bool custom16; // CUSTOM16 if set, otherwise CUSTOM8
+    bool use_linear_interpolation;
+    uint16_t invalid_value;
+} k4a_transformation_rgbz_channel_t;
+
 typedef struct _k4a_transformation_rgbz_context_t
 {
     const k4a_calibration_t *calibration;
     const k4a_transformation_xy_tables_t *xy_tables;
     k4a_transformation_input_image_t depth_image;
     k4a_transformation_input_image_t color_image;
-    k4a_transformation_input_image_t custom_image;
     k4a_transformation_output_image_t transformed_image;
-    k4a_transformation_output_image_t transformed_custom_image;
-    k4a_transformation_interpolation_type_t interpolation_type;
-    uint16_t invalid_value;
-    bool enable_custom8;
-    bool enable_custom16;
+    k4a_transformation_rgbz_channel_t channels[K4A_TRANSFORMATION_MAX_CUSTOM_CHANNELS];
+    int channel_count;
 } k4a_transformation_rgbz_context_t;
 
 typedef struct _k4a_correspondence_t
@@ -57,6 +63,19 @@ typedef struct _k4a_bounding_box_t
     int bottom_right[2];
 } k4a_bounding_box_t;
 
+// Custom values at the corners of a quad, in the order top left, top right, bottom right, bottom left
+typedef uint16_t k4a_custom_quad_t[4];
+
+// Areas of the sub triangles of a point inside a triangle, which weigh the vertices opposite to them
+typedef struct _k4a_triangle_weights_t
+{
+    float area_top_left;
+    float area_intermediate;
+    float area_bottom_right;
+    float sum_weights; // Reciprocal of the sum of the areas
+    bool counter_clockwise;
+} k4a_triangle_weights_t;
+
 static k4a_transformation_image_descriptor_t
 transformation_init_image_descriptor(int width, int height, int stride, k4a_image_format_t format)
 {
@@ -237,12 +256,7 @@ static bool transformation_check_valid_correspondences(const k4a_correspondence_
                                                        k4a_correspondence_t *valid_top_left,
                                                        k4a_correspondence_t *valid_top_right,
                                                        k4a_correspondence_t *valid_bottom_right,
-                                                       k4a_correspondence_t *valid_bottom_left,
-                                                       uint16_t *custom_top_left,
-                                                       uint16_t *custom_top_right,
-                                                       uint16_t *custom_bottom_right,
-                                                       uint16_t *custom_bottom_left,
-                                                       bool use_linear_interpolation)
+                                                       k4a_correspondence_t *valid_bottom_left)
 {
     *valid_top_left = *top_left;
     *valid_top_right = *top_right;
@@ -257,41 +271,23 @@ static bool transformation_check_valid_correspondences(const k4a_correspondence_
     {
         num_invalid++;
         *valid_top_left = transformation_interpolate_correspondences(top_right, bottom_left);
-        *custom_top_left = transformation_interpolate_custom(custom_top_right,
-                                                             custom_bottom_left,
-                                                             custom_bottom_right,
-                                                             use_linear_interpolation);
     }
     if (top_right->valid == 0)
     {
         num_invalid++;
         *valid_top_right = *bottom_right;
         *valid_bottom_right = transformation_interpolate_correspondences(bottom_right, bottom_left);
-        *custom_top_right = *custom_bottom_right;
-        *custom_bottom_right = transformation_interpolate_custom(custom_bottom_right,
-                                                                 custom_bottom_left,
-                                                                 custom_bottom_left,
-                                                                 use_linear_interpolation);
     }
     if (bottom_right->valid == 0)
     {
         num_invalid++;
         *valid_bottom_right = transformation_interpolate_correspondences(top_right, bottom_left);
-        *custom_bottom_right = transformation_interpolate_custom(custom_top_right,
-                                                                 custom_bottom_left,
-                                                                 custom_top_left,
-                                                                 use_linear_interpolation);
     }
     if (bottom_left->valid == 0)
     {
         num_invalid++;
         *valid_bottom_left = *bottom_right;
         *valid_bottom_right = transformation_interpolate_correspondences(top_right, bottom_right);
-        *custom_bottom_left = *custom_bottom_right;
-        *custom_bottom_right = transformation_interpolate_custom(custom_top_right,
-                                                                 custom_bottom_right,
-                                                                 custom_top_right,
-                                                                 use_linear_interpolation);
     }
 
     // If two or more vertices are invalid then we can't create a valid triangle
@@ -323,6 +319,52 @@ static bool transformation_check_valid_correspondences(const k4a_correspondence_
     return valid;
 }
 
+// Replaces the custom values of invalid vertices the same way transformation_check_valid_correspondences() replaces
+// the vertices
+static void transformation_replace_invalid_custom(const k4a_correspondence_t *top_left,
+                                                  const k4a_correspondence_t *top_right,
+                                                  const k4a_correspondence_t *bottom_right,
+                                                  const k4a_correspondence_t *bottom_left,
+                                                  k4a_custom_quad_t custom,
+                                                  bool use_linear_interpolation)
+{
+    uint16_t *custom_top_left = &custom[0];
+    uint16_t *custom_top_right = &custom[1];
+    uint16_t *custom_bottom_right = &custom[2];
+    uint16_t *custom_bottom_left = &custom[3];
+
+    if (top_left->valid == 0)
+    {
+        *custom_top_left = transformation_interpolate_custom(custom_top_right,
+                                                             custom_bottom_left,
+                                                             custom_bottom_right,
+                                                             use_linear_interpolation);
+    }
+    if (top_right->valid == 0)
+    {
+        *custom_top_right = *custom_bottom_right;
+        *custom_bottom_right = transformation_interpolate_custom(custom_bottom_right,
+                                                                 custom_bottom_left,
+                                                                 custom_bottom_left,
+                                                                 use_linear_interpolation);
+    }
+    if (bottom_right->valid == 0)
+    {
+        *custom_bottom_right = transformation_interpolate_custom(custom_top_right,
+                                                                 custom_bottom_left,
+                                                                 custom_top_left,
+                                                                 use_linear_interpolation);
+    }
+    if (bottom_left->valid == 0)
+    {
+        *custom_bottom_left = *custom_bottom_right;
+        *custom_bottom_right = transformation_interpolate_custom(custom_top_right,
+                                                                 custom_bottom_right,
+                                                                 custom_top_right,
+                                                                 use_linear_interpolation);
+    }
+}
+
 static inline float transformation_area_function(const k4a_float2_t *a, const k4a_float2_t *b, const k4a_float2_t *c)
 {
     // Calculate area of parallelogram defined by vectors (ab) and (ac).
@@ -333,15 +375,11 @@ static inline float transformation_area_function(const k4a_float2_t *a, const k4
 static bool transformation_point_inside_triangle(const k4a_correspondence_t *valid_top_left,
                                                  const k4a_correspondence_t *valid_intermediate,
                                                  const k4a_correspondence_t *valid_bottom_right,
-                                                 uint16_t custom_top_left,
-                                                 uint16_t custom_intermediate,
-                                                 uint16_t custom_bottom_right,
                                                  const k4a_float2_t *point,
                                                  float area_intermediate,
                                                  bool counter_clockwise,
                                                  float *depth,
-                                                 float *custom,
-                                                 bool use_linear_interpolation)
+                                                 k4a_triangle_weights_t *weights)
 {
     // Calculate sub triangle areas
     float area_top_left = transformation_area_function(&valid_intermediate->point2d, &valid_top_left->point2d, point);
@@ -373,24 +411,11 @@ static bool transformation_point_inside_triangle(const k4a_correspondence_t *val
                   area_bottom_right * valid_top_left->depth) *
                  sum_weights;
 
-        if (use_linear_interpolation)
-        {
-            *custom = (area_top_left * (float)custom_bottom_right + area_intermediate * (float)custom_intermediate +
-                       area_bottom_right * (float)custom_top_left) *
-                      sum_weights;
-        }
-        else
-        {
-            // Select custom based on highest weight (nearest neighbor)
-            if (area_top_left > area_intermediate)
-            {
-                *custom = area_top_left > area_bottom_right ? (float)custom_bottom_right : (float)custom_top_left;
-            }
-            else
-            {
-                *custom = area_intermediate > area_bottom_right ? (float)custom_intermediate : (float)custom_top_left;
-            }
-        }
+        weights->area_top_left = area_top_left;
+        weights->area_intermediate = area_intermediate;
+        weights->area_bottom_right = area_bottom_right;
+        weights->sum_weights = sum_weights;
+        weights->counter_clockwise = counter_clockwise;
 
         return true;
     }
@@ -398,18 +423,36 @@ static bool transformation_point_inside_triangle(const k4a_correspondence_t *val
     return false;
 }
 
+static inline float transformation_interpolate_triangle_custom(const k4a_triangle_weights_t *weights,
+                                                               const k4a_custom_quad_t custom,
+                                                               bool use_linear_interpolation)
+{
+    float custom_top_left = (float)custom[0];
+    float custom_intermediate = (float)(weights->counter_clockwise ? custom[3] : custom[1]);
+    float custom_bottom_right = (float)custom[2];
+
+    if (use_linear_interpolation)
+    {
+        return (weights->area_top_left * custom_bottom_right + weights->area_intermediate * custom_intermediate +
+                weights->area_bottom_right * custom_top_left) *
+               weights->sum_weights;
+    }
+
+    // Select custom based on highest weight (nearest neighbor)
+    if (weights->area_top_left > weights->area_intermediate)
+    {
+        return weights->area_top_left > weights->area_bottom_right ? custom_bottom_right : custom_top_left;
+    }
+    return weights->area_intermediate > weights->area_bottom_right ? custom_intermediate : custom_top_left;
+}
+
 static bool transformation_point_inside_quad(const k4a_correspondence_t *valid_top_left,
                                              const k4a_correspondence_t *valid_top_right,
                                              const k4a_correspondence_t *valid_bottom_right,
                                              const k4a_correspondence_t *valid_bottom_left,
-                                             uint16_t custom_top_left,
-                                             uint16_t custom_top_right,
-                                             uint16_t custom_bottom_right,
-                                             uint16_t custom_bottom_left,
                                              const k4a_float2_t *point,
                                              float *depth,
-                                             float *custom,
-                                             bool use_linear_interpolation)
+                                             k4a_triangle_weights_t *weights)
 {
     // Calculate area to see if point is to the left or right of vector (valid_top_left - valid_bottom_right).
     // Set counter_clockwise flag true for all positions to the right of the aforementioned vector.
@@ -422,15 +465,11 @@ static bool transformation_point_inside_quad(const k4a_correspondence_t *valid_t
     return transformation_point_inside_triangle(valid_top_left,
                                                 counter_clockwise ? valid_bottom_left : valid_top_right,
                                                 valid_bottom_right,
-                                                custom_top_left,
-                                                counter_clockwise ? custom_bottom_left : custom_top_right,
-                                                custom_bottom_right,
                                                 point,
                                                 area_intermediate,
                                                 counter_clockwise,
                                                 depth,
-                                                custom,
-                                                use_linear_interpolation);
+                                                weights);
 }
 
 static void transformation_draw_rectangle(const k4a_bounding_box_t *bounding_box,
@@ -438,31 +477,16 @@ static void transformation_draw_rectangle(const k4a_bounding_box_t *bounding_box
                                           const k4a_correspondence_t *valid_top_right,
                                           const k4a_correspondence_t *valid_bottom_right,
                                           const k4a_correspondence_t *valid_bottom_left,
-                                          uint16_t custom_top_left,
-                                          uint16_t custom_top_right,
-                                          uint16_t custom_bottom_right,
-                                          uint16_t custom_bottom_left,
-                                          bool use_linear_interpolation,
-                                          bool enable_custom8,
-                                          bool enable_custom16,
-                                          k4a_transformation_output_image_t *depth_out,
-                                          k4a_transformation_output_image_t *custom_out)
+                                          const k4a_custom_quad_t *custom,
+                                          const k4a_transformation_rgbz_channel_t *channels,
+                                          int channel_count,
+                                          k4a_transformation_output_image_t *depth_out)
 {
     k4a_float2_t point;
     for (int y = bounding_box->top_left[1]; y < bounding_box->bottom_right[1]; y++)
     {
         uint16_t *depth_row = depth_out->data_uint16 + y * depth_out->descriptor->width_pixels;
-
-        uint8_t *custom8_row = 0;
-        uint16_t *custom16_row = 0;
-        if (enable_custom8)
-        {
-            custom8_row = custom_out->data_uint8 + y * custom_out->descriptor->width_pixels;
-        }
-        else if (enable_custom16)
-        {
-            custom16_row = custom_out->data_uint16 + y * custom_out->descriptor->width_pixels;
-        }
+        int row_offset = y * depth_out->descriptor->width_pixels;
 
         point.xy.y = (float)y;
 
@@ -471,19 +495,14 @@ static void transformation_draw_rectangle(const k4a_bounding_box_t *bounding_box
             point.xy.x = (float)x;
 
             float interpolated_depth = 0.0f;
-            float interpolated_custom = 0.0f;
+            k4a_triangle_weights_t weights;
             if (transformation_point_inside_quad(valid_top_left,
                                                  valid_top_right,
                                                  valid_bottom_right,
                                                  valid_bottom_left,
-                                                 custom_top_left,
-                                                 custom_top_right,
-                                                 custom_bottom_right,
-                                                 custom_bottom_left,
                                                  &point,
                                                  &interpolated_depth,
-                                                 &interpolated_custom,
-                                                 use_linear_interpolation))
+                                                 &weights))
             {
                 uint16_t depth = (uint16_t)(interpolated_depth + 0.5f);
 
@@ -492,13 +511,24 @@ static void transformation_draw_rectangle(const k4a_bounding_box_t *bounding_box
                 {
                     depth_row[x] = depth;
 
-                    if (enable_custom8)
+                    // Every custom channel shares the rasterization of the depth image
+                    for (int c = 0; c < channel_count; c++)
                     {
-                        custom8_row[x] = (uint8_t)(interpolated_custom + 0.5f);
-                    }
-                    else if (enable_custom16)
-                    {
-                        custom16_row[x] = (uint16_t)(interpolated_custom + 0.5f);
+                        const k4a_transformation_rgbz_channel_t *channel = &channels[c];
+                        float interpolated_custom =
+                            transformation_interpolate_triangle_custom(&weights,
+                                                                       custom[c],
+                                                                       channel->use_linear_interpolation);
+                        if (channel->custom16)
+                        {
+                            channel->transformed_image.data_uint16[row_offset + x] =
+                                (uint16_t)(interpolated_custom + 0.5f);
+                        }
+                        else
+                        {
+                            channel->transformed_image.data_uint8[row_offset + x] =
+                                (uint8_t)(interpolated_custom + 0.5f);
+                        }
                     }
                 }
             }
@@ -513,27 +543,24 @@ static k4a_result_t transformation_depth_to_color(k4a_transformation_rgbz_contex
            (size_t)(context->transformed_image.descriptor->stride_bytes *
                     context->transformed_image.descriptor->height_pixels));
 
-    if (context->enable_custom8)
+    for (int c = 0; c < context->channel_count; c++)
     {
-        int num_pixels = context->transformed_custom_image.descriptor->width_pixels *
-                         context->transformed_custom_image.descriptor->height_pixels;
-        for (int i = 0; i < num_pixels; i++)
+        k4a_transformation_rgbz_channel_t *channel = &context->channels[c];
+        int num_pixels = channel->transformed_image.descriptor->width_pixels *
+                         channel->transformed_image.descriptor->height_pixels;
+        if (channel->custom16)
         {
-            context->transformed_custom_image.data_uint8[i] = (uint8_t)context->invalid_value;
+            for (int i = 0; i < num_pixels; i++)
+            {
+                channel->transformed_image.data_uint16[i] = channel->invalid_value;
+            }
         }
-    }
-    else if (context->enable_custom16)
-    {
-        int num_pixels = context->transformed_custom_image.descriptor->width_pixels *
-                         context->transformed_custom_image.descriptor->height_pixels;
-        for (int i = 0; i < num_pixels; i++)
+        else
         {
-            context->transformed_custom_image.data_uint16[i] = context->invalid_value;
+            memset(channel->transformed_image.data_uint8, (uint8_t)channel->invalid_value, (size_t)num_pixels);
         }
     }
 
-    bool use_linear_interpolation = context->interpolation_type == K4A_TRANSFORMATION_INTERPOLATION_TYPE_LINEAR;
-
     k4a_correspondence_t *vertex_row = (k4a_correspondence_t *)malloc(
         (size_t)context->depth_image.descriptor->width_pixels * sizeof(k4a_correspondence_t));
 
@@ -572,28 +599,6 @@ static k4a_result_t transformation_depth_to_color(k4a_transformation_rgbz_contex
                 return K4A_RESULT_FAILED;
             }
 
-            uint16_t custom_top_left = 0;
-            uint16_t custom_top_right = 0;
-            uint16_t custom_bottom_right = 0;
-            uint16_t custom_bottom_left = 0;
-
-            if (context->enable_custom8)
-            {
-                int custom_width = context->custom_image.descriptor->width_pixels;
-                custom_top_left = context->custom_image.data_uint8[(y - 1) * custom_width + x - 1];
-                custom_top_right = context->custom_image.data_uint8[(y - 1) * custom_width + x];
-                custom_bottom_right = context->custom_image.data_uint8[y * custom_width + x];
-                custom_bottom_left = context->custom_image.data_uint8[y * custom_width + x - 1];
-            }
-            else if (context->enable_custom16)
-            {
-                int custom_width = context->custom_image.descriptor->width_pixels;
-                custom_top_left = context->custom_image.data_uint16[(y - 1) * custom_width + x - 1];
-                custom_top_right = context->custom_image.data_uint16[(y - 1) * custom_width + x];
-                custom_bottom_right = context->custom_image.data_uint16[y * custom_width + x];
-                custom_bottom_left = context->custom_image.data_uint16[y * custom_width + x - 1];
-            }
-
             k4a_correspondence_t valid_top_left, valid_top_right, valid_bottom_right, valid_bottom_left;
             if (transformation_check_valid_correspondences(&top_left,
                                                            &top_right,
@@ -602,13 +607,37 @@ static k4a_result_t transformation_depth_to_color(k4a_transformation_rgbz_contex
                                                            &valid_top_left,
                                                            &valid_top_right,
                                                            &valid_bottom_right,
-                                                           &valid_bottom_left,
-                                                           &custom_top_left,
-                                                           &custom_top_right,
-                                                           &custom_bottom_right,
-                                                           &custom_bottom_left,
-                                                           use_linear_interpolation))
+                                                           &valid_bottom_left))
             {
+                k4a_custom_quad_t custom[K4A_TRANSFORMATION_MAX_CUSTOM_CHANNELS];
+                for (int c = 0; c < context->channel_count; c++)
+                {
+                    const k4a_transformation_rgbz_channel_t *channel = &context->channels[c];
+                    int custom_width = channel->image.descriptor->width_pixels;
+                    int top = (y - 1) * custom_width + x;
+                    int bottom = y * custom_width + x;
+                    if (channel->custom16)
+                    {
+                        custom[c][0] = channel->image.data_uint16[top - 1];
+                        custom[c][1] = channel->image.data_uint16[top];
+                        custom[c][2] = channel->image.data_uint16[bottom];
+                        custom[c][3] = channel->image.data_uint16[bottom - 1];
+                    }
+                    else
+                    {
+                        custom[c][0] = channel->image.data_uint8[top - 1];
+                        custom[c][1] = channel->image.data_uint8[top];
+                        custom[c][2] = channel->image.data_uint8[bottom];
+                        custom[c][3] = channel->image.data_uint8[bottom - 1];
+                    }
+                    transformation_replace_invalid_custom(&top_left,
+                                                          &top_right,
+                                                          &bottom_right,
+                                                          &bottom_left,
+                                                          custom[c],
+                                                          channel->use_linear_interpolation);
+                }
+
                 k4a_bounding_box_t bounding_box =
                     transformation_compute_bounding_box(&valid_top_left,
                                                         &valid_top_right,
@@ -622,15 +651,10 @@ static k4a_result_t transformation_depth_to_color(k4a_transformation_rgbz_contex
                                               &valid_top_right,
                                               &valid_bottom_right,
                                               &valid_bottom_left,
-                                              custom_top_left,
-                                              custom_top_right,
-                                              custom_bottom_right,
-                                              custom_bottom_left,
-                                              use_linear_interpolation,
-                                              context->enable_custom8,
-                                              context->enable_custom16,
-                                              &context->transformed_image,
-                                              &context->transformed_custom_image);
+                                              custom,
+                                              context->channels,
+                                              context->channel_count,
+                                              &context->transformed_image);
             }
 
             vertex_row[x] = bottom_right;
@@ -763,6 +787,49 @@ k4a_buffer_result_t transformation_depth_image_to_color_camera_validate_paramete
     return K4A_BUFFER_RESULT_SUCCEEDED;
 }
 
+// Runs transformation_depth_to_color() on parameters that have been validated
+static k4a_buffer_result_t
+transformation_depth_to_color_channels(const k4a_calibration_t *calibration,
+                                       const k4a_transformation_xy_tables_t *xy_tables_depth_camera,
+                                       const uint8_t *depth_image_data,
+                                       const k4a_transformation_image_descriptor_t *depth_image_descriptor,
+                                       uint8_t *transformed_depth_image_data,
+                                       k4a_transformation_image_descriptor_t *transformed_depth_image_descriptor,
+                                       const k4a_transformation_custom_plane_t *planes,
+                                       uint32_t plane_count)
+{
+    k4a_transformation_rgbz_context_t context;
+    memset(&context, 0, sizeof(k4a_transformation_rgbz_context_t));
+
+    context.xy_tables = xy_tables_depth_camera;
+    context.calibration = calibration;
+
+    context.depth_image = transformation_init_input_image(depth_image_descriptor, depth_image_data);
+
+    context.transformed_image = transformation_init_output_image(transformed_depth_image_descriptor,
+                                                                 transformed_depth_image_data);
+
+    for (uint32_t i = 0; i < plane_count; i++)
+    {
+        k4a_transformation_rgbz_channel_t *channel = &context.channels[i];
+        channel->image = transformation_init_input_image(planes[i].custom_image_descriptor,
+                                                         planes[i].custom_image_data);
+        channel->transformed_image = transformation_init_output_image(planes[i].transformed_custom_image_descriptor,
+                                                                      planes[i].transformed_custom_image_data);
+        channel->custom16 = planes[i].custom_image_descriptor->format == K4A_IMAGE_FORMAT_CUSTOM16;
+        channel->use_linear_interpolation = planes[i].interpolation_type ==
+                                            K4A_TRANSFORMATION_INTERPOLATION_TYPE_LINEAR;
+        channel->invalid_value = (uint16_t)(planes[i].invalid_custom_value & 0xffff);
+    }
+    context.channel_count = (int)plane_count;
+
+    if (K4A_FAILED(TRACE_CALL(transformation_depth_to_color(&context))))
+    {
+        return K4A_BUFFER_RESULT_FAILED;
+    }
+    return K4A_BUFFER_RESULT_SUCCEEDED;
+}
+
 k4a_buffer_result_t transformation_depth_image_to_color_camera_internal(
     const k4a_calibration_t *calibration,
     const k4a_transformation_xy_tables_t *xy_tables_depth_camera,
@@ -793,40 +860,483 @@ k4a_buffer_result_t transformation_depth_image_to_color_camera_internal(
         return K4A_BUFFER_RESULT_FAILED;
     }
 
-    k4a_transformation_rgbz_context_t context;
-    memset(&context, 0, sizeof(k4a_transformation_rgbz_context_t));
+    k4a_transformation_custom_plane_t plane;
+    plane.custom_image_data = custom_image_data;
+    plane.custom_image_descriptor = custom_image_descriptor;
+    plane.transformed_custom_image_data = transformed_custom_image_data;
+    plane.transformed_custom_image_descriptor = transformed_custom_image_descriptor;
+    plane.interpolation_type = interpolation_type;
+    plane.invalid_custom_value = invalid_custom_value;
+
+    bool has_custom = custom_image_data != 0 && (custom_image_descriptor->format == K4A_IMAGE_FORMAT_CUSTOM8 ||
+                                                 custom_image_descriptor->format == K4A_IMAGE_FORMAT_CUSTOM16);
+    return transformation_depth_to_color_channels(calibration,
+                                                  xy_tables_depth_camera,
+                                                  depth_image_data,
+                                                  depth_image_descriptor,
+                                                  transformed_depth_image_data,
+                                                  transformed_depth_image_descriptor,
+                                                  &plane,
+                                                  has_custom ? 1 : 0);
+}
 
-    context.xy_tables = xy_tables_depth_camera;
-    context.calibration = calibration;
+k4a_buffer_result_t transformation_depth_image_to_color_camera_channels_internal(
+    const k4a_calibration_t *calibration,
+    const k4a_transformation_xy_tables_t *xy_tables_depth_camera,
+    const uint8_t *depth_image_data,
+    const k4a_transformation_image_descriptor_t *depth_image_descriptor,
+    uint8_t *transformed_depth_image_data,
+    k4a_transformation_image_descriptor_t *transformed_depth_image_descriptor,
+    const k4a_transformation_custom_plane_t *planes,
+    uint32_t plane_count)
+{
+    if (plane_count > K4A_TRANSFORMATION_MAX_CUSTOM_CHANNELS || (plane_count > 0 && planes == 0))
+    {
+        LOG_ERROR("Expect at most %d custom planes.", K4A_TRANSFORMATION_MAX_CUSTOM_CHANNELS);
+        return K4A_BUFFER_RESULT_FAILED;
+    }
 
-    context.depth_image = transformation_init_input_image(depth_image_descriptor, depth_image_data);
+    for (uint32_t i = 0; i < plane_count; i++)
+    {
+        const k4a_transformation_custom_plane_t *plane = &planes[i];
+        if (plane->custom_image_data == 0 || plane->transformed_custom_image_data == 0 ||
+            plane->custom_image_descriptor == 0 ||
+            (plane->custom_image_descriptor->format != K4A_IMAGE_FORMAT_CUSTOM8 &&
+             plane->custom_image_descriptor->format != K4A_IMAGE_FORMAT_CUSTOM16))
+        {
+            LOG_ERROR("Custom plane %u requires a custom8 or custom16 image and a transformed custom image.", i);
+            return K4A_BUFFER_RESULT_FAILED;
+        }
 
-    context.custom_image = transformation_init_input_image(custom_image_descriptor, custom_image_data);
+        k4a_buffer_result_t result = TRACE_BUFFER_CALL(
+            transformation_depth_image_to_color_camera_validate_parameters(calibration,
+                                                                           xy_tables_depth_camera,
+                                                                           depth_image_data,
+                                                                           depth_image_descriptor,
+                                                                           plane->custom_image_data,
+                                                                           plane->custom_image_descriptor,
+                                                                           transformed_depth_image_data,
+                                                                           transformed_depth_image_descriptor,
+                                                                           plane->transformed_custom_image_data,
+                                                                           plane->transformed_custom_image_descriptor));
+        if (result != K4A_BUFFER_RESULT_SUCCEEDED)
+        {
+            return result;
+        }
+    }
 
-    context.transformed_image = transformation_init_output_image(transformed_depth_image_descriptor,
-                                                                 transformed_depth_image_data);
+    if (plane_count == 0)
+    {
+        k4a_transformation_image_descriptor_t no_custom_descriptor = { 0 };
+        k4a_buffer_result_t result = TRACE_BUFFER_CALL(
+            transformation_depth_image_to_color_camera_validate_parameters(calibration,
+                                                                           xy_tables_depth_camera,
+                                                                           depth_image_data,
+                                                                           depth_image_descriptor,
+                                                                           0,
+                                                                           &no_custom_descriptor,
+                                                                           transformed_depth_image_data,
+                                                                           transformed_depth_image_descriptor,
+                                                                           0,
+                                                                           &no_custom_descriptor));
+        if (result != K4A_BUFFER_RESULT_SUCCEEDED)
+        {
+            return result;
+        }
+    }
 
-    context.transformed_custom_image = transformation_init_output_image(transformed_custom_image_descriptor,
-                                                                        transformed_custom_image_data);
+    return transformation_depth_to_color_channels(calibration,
+                                                  xy_tables_depth_camera,
+                                                  depth_image_data,
+                                                  depth_image_descriptor,
+                                                  transformed_depth_image_data,
+                                                  transformed_depth_image_descriptor,
+                                                  planes,
+                                                  plane_count);
+}
 
-    context.enable_custom8 = false;
-    context.enable_custom16 = false;
-    if (custom_image_descriptor->format == K4A_IMAGE_FORMAT_CUSTOM8)
+// State of transformation_depth_image_to_color_camera_incremental() between frames
+struct _transformation_incremental_t
+{
+    int depth_width;
+    int depth_height;
+    int color_width;
+    int color_height;
+    int depth_tiles_x;
+    int depth_tiles_y;
+    int color_tiles_x;
+    int color_tiles_y;
+    bool primed; // Set once depth_image, correspondences and transformed_depth_image hold a frame
+
+    uint16_t *depth_image;                 // Depth image of the previous frame
+    k4a_correspondence_t *correspondences; // Correspondence of every pixel of depth_image
+    uint16_t *transformed_depth_image;     // Output of the previous frame
+    uint8_t *changed_tiles;                // Depth tiles that differ from depth_image
+    uint8_t *dirty_tiles;                  // Output tiles that need to be rasterized again
+};
+
+transformation_incremental_t *transformation_incremental_create(const k4a_calibration_t *calibration)
+{
+    transformation_incremental_t *incremental = (transformation_incremental_t *)calloc(
+        1, sizeof(transformation_incremental_t));
+    if (incremental == NULL)
     {
-        context.enable_custom8 = true;
+        return NULL;
     }
-    else if (custom_image_descriptor->format == K4A_IMAGE_FORMAT_CUSTOM16)
+
+    incremental->depth_width = calibration->depth_camera_calibration.resolution_width;
+    incremental->depth_height = calibration->depth_camera_calibration.resolution_height;
+    incremental->color_width = calibration->color_camera_calibration.resolution_width;
+    incremental->color_height = calibration->color_camera_calibration.resolution_height;
+    incremental->depth_tiles_x = (incremental->depth_width + TRANSFORMATION_INCREMENTAL_TILE_SIZE - 1) /
+                                 TRANSFORMATION_INCREMENTAL_TILE_SIZE;
+    incremental->depth_tiles_y = (incremental->depth_height + TRANSFORMATION_INCREMENTAL_TILE_SIZE - 1) /
+                                 TRANSFORMATION_INCREMENTAL_TILE_SIZE;
+    incremental->color_tiles_x = (incremental->color_width + TRANSFORMATION_INCREMENTAL_TILE_SIZE - 1) /
+                                 TRANSFORMATION_INCREMENTAL_TILE_SIZE;
+    incremental->color_tiles_y = (incremental->color_height + TRANSFORMATION_INCREMENTAL_TILE_SIZE - 1) /
+                                 TRANSFORMATION_INCREMENTAL_TILE_SIZE;
+
+    size_t depth_pixels = (size_t)incremental->depth_width * (size_t)incremental->depth_height;
+    size_t color_pixels = (size_t)incremental->color_width * (size_t)incremental->color_height;
+    incremental->depth_image = (uint16_t *)malloc(depth_pixels * sizeof(uint16_t));
+    incremental->correspondences = (k4a_correspondence_t *)malloc(depth_pixels * sizeof(k4a_correspondence_t));
+    incremental->transformed_depth_image = (uint16_t *)malloc(color_pixels * sizeof(uint16_t));
+    incremental->changed_tiles = (uint8_t *)malloc(
+        (size_t)(incremental->depth_tiles_x * incremental->depth_tiles_y));
+    incremental->dirty_tiles = (uint8_t *)malloc((size_t)(incremental->color_tiles_x * incremental->color_tiles_y));
+
+    if (incremental->depth_image == NULL || incremental->correspondences == NULL ||
+        incremental->transformed_depth_image == NULL || incremental->changed_tiles == NULL ||
+        incremental->dirty_tiles == NULL)
     {
-        context.enable_custom16 = true;
+        LOG_ERROR("Failed to allocate the incremental transformation state.", 0);
+        transformation_incremental_destroy(incremental);
+        return NULL;
     }
+    return incremental;
+}
 
-    context.interpolation_type = interpolation_type;
-    context.invalid_value = (uint16_t)(invalid_custom_value & 0xffff);
+void transformation_incremental_destroy(transformation_incremental_t *incremental)
+{
+    if (incremental == NULL)
+    {
+        return;
+    }
+    free(incremental->depth_image);
+    free(incremental->correspondences);
+    free(incremental->transformed_depth_image);
+    free(incremental->changed_tiles);
+    free(incremental->dirty_tiles);
+    free(incremental);
+}
 
-    if (K4A_FAILED(TRACE_CALL(transformation_depth_to_color(&context))))
+// Returns true if the depth values of a row segment differ
+static bool transformation_incremental_row_changed(const uint16_t *previous, const uint16_t *current, int count)
+{
+    int x = 0;
+#if defined(K4A_USING_SSE)
+    __m128i difference = _mm_setzero_si128();
+    for (; x + 8 <= count; x += 8)
+    {
+        __m128i a = _mm_loadu_si128((const __m128i *)(previous + x));
+        __m128i b = _mm_loadu_si128((const __m128i *)(current + x));
+        difference = _mm_or_si128(difference, _mm_xor_si128(a, b));
+    }
+    if (!_mm_testz_si128(difference, difference))
+    {
+        return true;
+    }
+#endif
+    for (; x < count; x++)
+    {
+        if (previous[x] != current[x])
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Marks the depth tiles that differ from the previous frame, and returns how many there are
+static int transformation_incremental_diff(transformation_incremental_t *incremental, const uint16_t *depth_image)
+{
+    int changed = 0;
+    for (int ty = 0; ty < incremental->depth_tiles_y; ty++)
+    {
+        int y_begin = ty * TRANSFORMATION_INCREMENTAL_TILE_SIZE;
+        int y_end = transformation_min2(y_begin + TRANSFORMATION_INCREMENTAL_TILE_SIZE, incremental->depth_height);
+        for (int tx = 0; tx < incremental->depth_tiles_x; tx++)
+        {
+            int x_begin = tx * TRANSFORMATION_INCREMENTAL_TILE_SIZE;
+            int x_end = transformation_min2(x_begin + TRANSFORMATION_INCREMENTAL_TILE_SIZE, incremental->depth_width);
+            bool tile_changed = false;
+            for (int y = y_begin; y < y_end && !tile_changed; y++)
+            {
+                int offset = y * incremental->depth_width + x_begin;
+                tile_changed = transformation_incremental_row_changed(incremental->depth_image + offset,
+                                                                      depth_image + offset,
+                                                                      x_end - x_begin);
+            }
+            incremental->changed_tiles[ty * incremental->depth_tiles_x + tx] = tile_changed ? 1 : 0;
+            changed += tile_changed ? 1 : 0;
+        }
+    }
+    return changed;
+}
+
+// Computes the rasterized area of the quad whose bottom right vertex is depth pixel (x, y). Returns false if the quad
+// is not drawn.
+static bool transformation_incremental_quad(const transformation_incremental_t *incremental,
+                                            int x,
+                                            int y,
+                                            k4a_correspondence_t valid[4],
+                                            k4a_bounding_box_t *bounding_box)
+{
+    const k4a_correspondence_t *top = incremental->correspondences + (y - 1) * incremental->depth_width + x;
+    const k4a_correspondence_t *bottom = incremental->correspondences + y * incremental->depth_width + x;
+    if (!transformation_check_valid_correspondences(
+            top - 1, top, bottom, bottom - 1, &valid[0], &valid[1], &valid[2], &valid[3]))
+    {
+        return false;
+    }
+
+    *bounding_box = transformation_compute_bounding_box(
+        &valid[0], &valid[1], &valid[2], &valid[3], incremental->color_width, incremental->color_height);
+    return bounding_box->top_left[0] < bounding_box->bottom_right[0] &&
+           bounding_box->top_left[1] < bounding_box->bottom_right[1];
+}
+
+static void transformation_incremental_mark_dirty(transformation_incremental_t *incremental,
+                                                  const k4a_bounding_box_t *bounding_box)
+{
+    int tx_begin = bounding_box->top_left[0] / TRANSFORMATION_INCREMENTAL_TILE_SIZE;
+    int ty_begin = bounding_box->top_left[1] / TRANSFORMATION_INCREMENTAL_TILE_SIZE;
+    int tx_end = (bounding_box->bottom_right[0] - 1) / TRANSFORMATION_INCREMENTAL_TILE_SIZE;
+    int ty_end = (bounding_box->bottom_right[1] - 1) / TRANSFORMATION_INCREMENTAL_TILE_SIZE;
+    for (int ty = ty_begin; ty <= ty_end; ty++)
+    {
+        memset(incremental->dirty_tiles + ty * incremental->color_tiles_x + tx_begin,
+               1,
+               (size_t)(tx_end - tx_begin + 1));
+    }
+}
+
+static bool transformation_incremental_is_dirty(const transformation_incremental_t *incremental,
+                                                const k4a_bounding_box_t *bounding_box)
+{
+    int tx_begin = bounding_box->top_left[0] / TRANSFORMATION_INCREMENTAL_TILE_SIZE;
+    int ty_begin = bounding_box->top_left[1] / TRANSFORMATION_INCREMENTAL_TILE_SIZE;
+    int tx_end = (bounding_box->bottom_right[0] - 1) / TRANSFORMATION_INCREMENTAL_TILE_SIZE;
+    int ty_end = (bounding_box->bottom_right[1] - 1) / TRANSFORMATION_INCREMENTAL_TILE_SIZE;
+    for (int ty = ty_begin; ty <= ty_end; ty++)
+    {
+        for (int tx = tx_begin; tx <= tx_end; tx++)
+        {
+            if (incremental->dirty_tiles[ty * incremental->color_tiles_x + tx])
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Marks the output tiles covered by every quad that has a vertex in a changed depth tile
+static void transformation_incremental_mark_changed_quads(transformation_incremental_t *incremental)
+{
+    for (int ty = 0; ty < incremental->depth_tiles_y; ty++)
+    {
+        for (int tx = 0; tx < incremental->depth_tiles_x; tx++)
+        {
+            if (!incremental->changed_tiles[ty * incremental->depth_tiles_x + tx])
+            {
+                continue;
+            }
+
+            // A depth pixel is a vertex of the quads to its right and below it
+            int x_begin = transformation_max2(tx * TRANSFORMATION_INCREMENTAL_TILE_SIZE, 1);
+            int y_begin = transformation_max2(ty * TRANSFORMATION_INCREMENTAL_TILE_SIZE, 1);
+            int x_end = transformation_min2((tx + 1) * TRANSFORMATION_INCREMENTAL_TILE_SIZE + 1,
+                                            incremental->depth_width);
+            int y_end = transformation_min2((ty + 1) * TRANSFORMATION_INCREMENTAL_TILE_SIZE + 1,
+                                            incremental->depth_height);
+            for (int y = y_begin; y < y_end; y++)
+            {
+                for (int x = x_begin; x < x_end; x++)
+                {
+                    k4a_correspondence_t valid[4];
+                    k4a_bounding_box_t bounding_box;
+                    if (transformation_incremental_quad(incremental, x, y, valid, &bounding_box))
+                    {
+                        transformation_incremental_mark_dirty(incremental, &bounding_box);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Updates the depth image and correspondences of the changed depth tiles, or of the whole image if all_tiles is set
+static k4a_result_t transformation_incremental_update(transformation_incremental_t *incremental,
+                                                      const k4a_transformation_rgbz_context_t *context,
+                                                      bool all_tiles)
+{
+    for (int ty = 0; ty < incremental->depth_tiles_y; ty++)
     {
+        int y_begin = ty * TRANSFORMATION_INCREMENTAL_TILE_SIZE;
+        int y_end = transformation_min2(y_begin + TRANSFORMATION_INCREMENTAL_TILE_SIZE, incremental->depth_height);
+        for (int tx = 0; tx < incremental->depth_tiles_x; tx++)
+        {
+            if (!all_tiles && !incremental->changed_tiles[ty * incremental->depth_tiles_x + tx])
+            {
+                continue;
+            }
+
+            int x_begin = tx * TRANSFORMATION_INCREMENTAL_TILE_SIZE;
+            int x_end = transformation_min2(x_begin + TRANSFORMATION_INCREMENTAL_TILE_SIZE, incremental->depth_width);
+            for (int y = y_begin; y < y_end; y++)
+            {
+                for (int idx = y * incremental->depth_width + x_begin; idx < y * incremental->depth_width + x_end;
+                     idx++)
+                {
+                    incremental->depth_image[idx] = context->depth_image.data_uint16[idx];
+                    if (K4A_FAILED(TRACE_CALL(transformation_compute_correspondence(
+                            idx, incremental->depth_image[idx], context, incremental->correspondences + idx))))
+                    {
+                        return K4A_RESULT_FAILED;
+                    }
+                }
+            }
+        }
+    }
+    return K4A_RESULT_SUCCEEDED;
+}
+
+// Clears the dirty output tiles and draws every quad that overlaps one of them. A quad that did not change has already
+// been drawn into the clean tiles it overlaps, and drawing it again keeps the nearest depth there, so the bounding box
+// does not need to be clipped.
+static void transformation_incremental_rasterize(transformation_incremental_t *incremental)
+{
+    for (int ty = 0; ty < incremental->color_tiles_y; ty++)
+    {
+        int y_begin = ty * TRANSFORMATION_INCREMENTAL_TILE_SIZE;
+        int y_end = transformation_min2(y_begin + TRANSFORMATION_INCREMENTAL_TILE_SIZE, incremental->color_height);
+        for (int tx = 0; tx < incremental->color_tiles_x; tx++)
+        {
+            if (!incremental->dirty_tiles[ty * incremental->color_tiles_x + tx])
+            {
+                continue;
+            }
+
+            int x_begin = tx * TRANSFORMATION_INCREMENTAL_TILE_SIZE;
+            int x_end = transformation_min2(x_begin + TRANSFORMATION_INCREMENTAL_TILE_SIZE, incremental->color_width);
+            for (int y = y_begin; y < y_end; y++)
+            {
+                memset(incremental->transformed_depth_image + y * incremental->color_width + x_begin,
+                       0,
+                       (size_t)(x_end - x_begin) * sizeof(uint16_t));
+            }
+        }
+    }
+
+    k4a_transformation_image_descriptor_t descriptor = transformation_init_image_descriptor(
+        incremental->color_width,
+        incremental->color_height,
+        incremental->color_width * (int)sizeof(uint16_t),
+        K4A_IMAGE_FORMAT_DEPTH16);
+    k4a_transformation_output_image_t depth_out = transformation_init_output_image(
+        &descriptor, (uint8_t *)incremental->transformed_depth_image);
+
+    for (int y = 1; y < incremental->depth_height; y++)
+    {
+        for (int x = 1; x < incremental->depth_width; x++)
+        {
+            k4a_correspondence_t valid[4];
+            k4a_bounding_box_t bounding_box;
+            if (transformation_incremental_quad(incremental, x, y, valid, &bounding_box) &&
+                transformation_incremental_is_dirty(incremental, &bounding_box))
+            {
+                transformation_draw_rectangle(
+                    &bounding_box, &valid[0], &valid[1], &valid[2], &valid[3], NULL, NULL, 0, &depth_out);
+            }
+        }
+    }
+}
+
+k4a_buffer_result_t transformation_depth_image_to_color_camera_incremental(
+    const k4a_calibration_t *calibration,
+    const k4a_transformation_xy_tables_t *xy_tables_depth_camera,
+    transformation_incremental_t *incremental,
+    float max_changed_fraction,
+    const uint8_t *depth_image_data,
+    const k4a_transformation_image_descriptor_t *depth_image_descriptor,
+    uint8_t *transformed_depth_image_data,
+    k4a_transformation_image_descriptor_t *transformed_depth_image_descriptor)
+{
+    if (incremental == NULL)
+    {
+        LOG_ERROR("Incremental transformation state is null.", 0);
         return K4A_BUFFER_RESULT_FAILED;
     }
+
+    k4a_transformation_image_descriptor_t no_custom_descriptor = { 0 };
+    k4a_buffer_result_t result = TRACE_BUFFER_CALL(
+        transformation_depth_image_to_color_camera_validate_parameters(calibration,
+                                                                       xy_tables_depth_camera,
+                                                                       depth_image_data,
+                                                                       depth_image_descriptor,
+                                                                       0,
+                                                                       &no_custom_descriptor,
+                                                                       transformed_depth_image_data,
+                                                                       transformed_depth_image_descriptor,
+                                                                       0,
+                                                                       &no_custom_descriptor));
+    if (result != K4A_BUFFER_RESULT_SUCCEEDED)
+    {
+        return result;
+    }
+
+    k4a_transformation_rgbz_context_t context;
+    memset(&context, 0, sizeof(k4a_transformation_rgbz_context_t));
+    context.xy_tables = xy_tables_depth_camera;
+    context.calibration = calibration;
+    context.depth_image = transformation_init_input_image(depth_image_descriptor, depth_image_data);
+
+    int tile_count = incremental->depth_tiles_x * incremental->depth_tiles_y;
+    int changed_tiles = incremental->primed ? transformation_incremental_diff(incremental,
+                                                                              context.depth_image.data_uint16) :
+                                              tile_count;
+
+    if (!incremental->primed || changed_tiles > (int)(max_changed_fraction * (float)tile_count))
+    {
+        // Too much of the scene moved for the diff to pay off, rasterize the whole frame
+        incremental->primed = false;
+        if (K4A_FAILED(TRACE_CALL(transformation_incremental_update(incremental, &context, true))))
+        {
+            return K4A_BUFFER_RESULT_FAILED;
+        }
+        memset(incremental->dirty_tiles, 1, (size_t)(incremental->color_tiles_x * incremental->color_tiles_y));
+        transformation_incremental_rasterize(incremental);
+        incremental->primed = true;
+    }
+    else if (changed_tiles > 0)
+    {
+        // Both the area covered by the previous vertices and by the new ones are drawn again
+        memset(incremental->dirty_tiles, 0, (size_t)(incremental->color_tiles_x * incremental->color_tiles_y));
+        transformation_incremental_mark_changed_quads(incremental);
+        if (K4A_FAILED(TRACE_CALL(transformation_incremental_update(incremental, &context, false))))
+        {
+            incremental->primed = false;
+            return K4A_BUFFER_RESULT_FAILED;
+        }
+        transformation_incremental_mark_changed_quads(incremental);
+        transformation_incremental_rasterize(incremental);
+    }
+
+    memcpy(transformed_depth_image_data,
+           incremental->transformed_depth_image,
+           (size_t)incremental->color_width * (size_t)incremental->color_height * sizeof(uint16_t));
     return K4A_BUFFER_RESULT_SUCCEEDED;
 }
 
@@ -1058,9 +1568,8 @@ k4a_buffer_result_t transformation_color_image_to_depth_camera_internal(
     return K4A_BUFFER_RESULT_SUCCEEDED;
 }
 
-#if !defined(K4A_USING_SSE)
-// This is the same function as transformation_depth_to_xyz without the SSE
-// instructions. This code is kept here for readability.
+// This is the same function as transformation_depth_to_xyz_sse without the SSE
+// instructions. It is used where SSE is not available, or when selected by auto tuning.
 static void transformation_depth_to_xyz(k4a_transformation_xy_tables_t *xy_tables,
                                         const void *depth_image_data,
                                         void *xyz_image_data)
@@ -1092,11 +1601,10 @@ static void transformation_depth_to_xyz(k4a_transformation_xy_tables_t *xy_table
     }
 }
 
-#else
-
-static void transformation_depth_to_xyz(k4a_transformation_xy_tables_t *xy_tables,
-                                        const void *depth_image_data,
-                                        void *xyz_image_data)
+#if defined(K4A_USING_SSE)
+static void transformation_depth_to_xyz_sse(k4a_transformation_xy_tables_t *xy_tables,
+                                            const void *depth_image_data,
+                                            void *xyz_image_data)
 {
     const __m128i *depth_image_data_m128i = (const __m128i *)depth_image_data;
 #if defined(__clang__) || defined(__GNUC__)
@@ -1167,12 +1675,22 @@ static void transformation_depth_to_xyz(k4a_transformation_xy_tables_t *xy_table
 }
 #endif
 
+bool transformation_point_cloud_simd_supported(void)
+{
+#if defined(K4A_USING_SSE)
+    return true;
+#else
+    return false;
+#endif
+}
+
 k4a_buffer_result_t
 transformation_depth_image_to_point_cloud_internal(k4a_transformation_xy_tables_t *xy_tables,
                                                    const uint8_t *depth_image_data,
                                                    const k4a_transformation_image_descriptor_t *depth_image_descriptor,
                                                    uint8_t *xyz_image_data,
-                                                   k4a_transformation_image_descriptor_t *xyz_image_descriptor)
+                                                   k4a_transformation_image_descriptor_t *xyz_image_descriptor,
+                                                   k4a_transformation_backend_t backend)
 {
     if (xyz_image_descriptor == 0)
     {
@@ -1214,6 +1732,16 @@ transformation_depth_image_to_point_cloud_internal(k4a_transformation_xy_tables_
         return K4A_BUFFER_RESULT_FAILED;
     }
 
+#if defined(K4A_USING_SSE)
+    if (backend == K4A_TRANSFORMATION_BACKEND_CPU_SIMD)
+    {
+        transformation_depth_to_xyz_sse(xy_tables, (const void *)depth_image_data, (void *)xyz_image_data);
+        return K4A_BUFFER_RESULT_SUCCEEDED;
+    }
+#else
+    (void)backend;
+#endif
+
     transformation_depth_to_xyz(xy_tables, (const void *)depth_image_data, (void *)xyz_image_data);
 
     return K4A_BUFFER_RESULT_SUCCEEDED;
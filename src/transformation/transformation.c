@@ -9,12 +9,27 @@
 #include <k4ainternal/deloader.h>
 #include <k4ainternal/tewrapper.h>
 #include <k4ainternal/image.h>
+#include <azure_c_shared_utility/condition.h>
+#include <azure_c_shared_utility/lock.h>
+#include <azure_c_shared_utility/threadapi.h>
 
 // System dependencies
+#include <assert.h>
 #include <stdlib.h>
 #include <math.h>
 #include <float.h>
 
+#ifndef _WIN32
+#include <time.h>
+#endif
+
+#define TRANSFORMATION_DEFAULT_MAX_IN_FLIGHT (4)
+#define TRANSFORMATION_MAX_IN_FLIGHT (32)
+
+// Auto tuning runs each backend once to warm up and keeps the fastest of the timed runs
+#define TRANSFORMATION_TUNING_RUNS (3)
+#define TRANSFORMATION_TUNING_DEPTH_MM (1500)
+
 k4a_result_t transformation_get_mode_specific_calibration(const k4a_calibration_camera_t *depth_camera_calibration,
                                                           const k4a_calibration_camera_t *color_camera_calibration,
                                                           const k4a_calibration_extrinsics_t *gyro_extrinsics,
@@ -569,6 +584,23 @@ static k4a_result_t transformation_allocate_xy_tables(const k4a_calibration_t *c
     return K4A_RESULT_SUCCEEDED;
 }
 
+typedef enum
+{
+    TRANSFORMATION_REQUEST_FREE = 0,
+    TRANSFORMATION_REQUEST_PENDING,
+    TRANSFORMATION_REQUEST_COMPLETE,
+} transformation_request_state_t;
+
+typedef struct _transformation_async_request_t
+{
+    k4a_transformation_t transformation_handle;
+    struct _k4a_transformation_context_t *transformation_context;
+    transformation_request_state_t state;
+    k4a_transformation_ticket_t ticket;
+    k4a_transformation_request_t request;
+    k4a_result_t result;
+} transformation_async_request_t;
+
 typedef struct _k4a_transformation_context_t
 {
     k4a_calibration_t calibration;
@@ -576,14 +608,60 @@ typedef struct _k4a_transformation_context_t
     float *memory_depth_camera_xy_tables;
     k4a_transformation_xy_tables_t color_camera_xy_tables;
     float *memory_color_camera_xy_tables;
-    bool enable_gpu_optimization;
     bool enable_depth_color_transform;
     tewrapper_t tewrapper;
+
+    // Backend of each k4a_transformation_operation_t, and the timings it was chosen from
+    k4a_transformation_tuning_t tuning;
+
+    // Previous frame of the depth to color transformation when incremental mode is on, protected by incremental_lock
+    LOCK_HANDLE incremental_lock;
+    transformation_incremental_t *incremental;
+    float incremental_max_changed_fraction;
+
+    // Color resolution depth buffer for transformation_ir_image_to_color_camera() callers that do not want the depth
+    // image. Allocated on first use and kept until the handle is destroyed, protected by scratch_lock.
+    LOCK_HANDLE scratch_lock;
+    uint8_t *scratch_depth_image_data;
+
+    // Requests submitted with transformation_submit(), protected by async_lock
+    LOCK_HANDLE async_lock;
+    COND_HANDLE async_queued_condition;   // Posted to async_thread when a request is queued or it should stop
+    COND_HANDLE async_complete_condition; // Broadcast when a request without a callback completes
+    COND_HANDLE async_free_condition;     // Broadcast when a request is freed or max_in_flight changes
+    uint32_t async_complete_waiters;      // Threads waiting on async_complete_condition
+    uint32_t async_free_waiters;          // Threads waiting on async_free_condition
+    THREAD_HANDLE async_thread;           // Runs requests that do not go to the transform engine; started on first use
+    bool async_stop;
+    uint32_t max_in_flight;
+    uint32_t in_flight;
+    k4a_transformation_ticket_t last_ticket;
+    transformation_async_request_t requests[TRANSFORMATION_MAX_IN_FLIGHT];
+    uint32_t cpu_queue[TRANSFORMATION_MAX_IN_FLIGHT];
+    uint32_t cpu_queue_head;
+    uint32_t cpu_queue_count;
 } k4a_transformation_context_t;
 
 K4A_DECLARE_CONTEXT(k4a_transformation_t, k4a_transformation_context_t);
 
-k4a_transformation_t transformation_create(const k4a_calibration_t *calibration, bool gpu_optimization)
+uint64_t transformation_get_time_usec(void)
+{
+#ifdef _WIN32
+    LARGE_INTEGER qpc = { 0 }, freq = { 0 };
+    QueryPerformanceCounter(&qpc);
+    QueryPerformanceFrequency(&freq);
+    return (uint64_t)(qpc.QuadPart / freq.QuadPart * 1000000 + qpc.QuadPart % freq.QuadPart * 1000000 / freq.QuadPart);
+#else
+    struct timespec ts_time;
+    clock_gettime(CLOCK_MONOTONIC, &ts_time);
+    return (uint64_t)ts_time.tv_sec * 1000000 + (uint64_t)ts_time.tv_nsec / 1000;
+#endif
+}
+
+// When gpu_required is false, a transform engine that fails to load leaves the handle on the CPU backends
+static k4a_transformation_t transformation_create_internal(const k4a_calibration_t *calibration,
+                                                           bool gpu_optimization,
+                                                           bool gpu_required)
 {
     k4a_transformation_t transformation_handle = NULL;
     k4a_transformation_context_t *transformation_context = k4a_transformation_t_create(&transformation_handle);
@@ -608,12 +686,29 @@ k4a_transformation_t transformation_create(const k4a_calibration_t *calibration,
         return 0;
     }
 
-    transformation_context->enable_gpu_optimization = gpu_optimization;
+    transformation_context->max_in_flight = TRANSFORMATION_DEFAULT_MAX_IN_FLIGHT;
+    transformation_context->async_lock = Lock_Init();
+    transformation_context->async_queued_condition = Condition_Init();
+    transformation_context->async_complete_condition = Condition_Init();
+    transformation_context->async_free_condition = Condition_Init();
+    transformation_context->incremental_lock = Lock_Init();
+    transformation_context->scratch_lock = Lock_Init();
+    if (K4A_FAILED(K4A_RESULT_FROM_BOOL(transformation_context->async_lock != NULL &&
+                                        transformation_context->async_queued_condition != NULL &&
+                                        transformation_context->async_complete_condition != NULL &&
+                                        transformation_context->async_free_condition != NULL &&
+                                        transformation_context->incremental_lock != NULL &&
+                                        transformation_context->scratch_lock != NULL)))
+    {
+        transformation_destroy(transformation_handle);
+        return 0;
+    }
+
     transformation_context->enable_depth_color_transform = transformation_context->calibration.color_resolution !=
                                                                K4A_COLOR_RESOLUTION_OFF &&
                                                            transformation_context->calibration.depth_mode !=
                                                                K4A_DEPTH_MODE_OFF;
-    if (transformation_context->enable_gpu_optimization && transformation_context->enable_depth_color_transform)
+    if (gpu_optimization && transformation_context->enable_depth_color_transform)
     {
         // Set up transform engine expected calibration struct
         k4a_transform_engine_calibration_t transform_engine_calibration;
@@ -634,21 +729,50 @@ k4a_transformation_t transformation_create(const k4a_calibration_t *calibration,
                sizeof(k4a_transformation_xy_tables_t));
 
         transformation_context->tewrapper = tewrapper_create(&transform_engine_calibration);
-        if (K4A_FAILED(K4A_RESULT_FROM_BOOL(transformation_context->tewrapper != NULL)))
+        if (K4A_FAILED(K4A_RESULT_FROM_BOOL(transformation_context->tewrapper != NULL)) && gpu_required)
         {
             transformation_destroy(transformation_handle);
             return 0;
         }
     }
 
+    k4a_transformation_backend_t image_backend = transformation_context->tewrapper != NULL ?
+                                                     K4A_TRANSFORMATION_BACKEND_GPU :
+                                                     K4A_TRANSFORMATION_BACKEND_CPU;
+    transformation_context->tuning.backend[K4A_TRANSFORMATION_OPERATION_DEPTH_IMAGE_TO_COLOR_CAMERA] = image_backend;
+    transformation_context->tuning.backend[K4A_TRANSFORMATION_OPERATION_DEPTH_IMAGE_TO_COLOR_CAMERA_CUSTOM] =
+        image_backend;
+    transformation_context->tuning.backend[K4A_TRANSFORMATION_OPERATION_COLOR_IMAGE_TO_DEPTH_CAMERA] = image_backend;
+    transformation_context->tuning.backend[K4A_TRANSFORMATION_OPERATION_DEPTH_IMAGE_TO_POINT_CLOUD] =
+        transformation_point_cloud_simd_supported() ? K4A_TRANSFORMATION_BACKEND_CPU_SIMD :
+                                                      K4A_TRANSFORMATION_BACKEND_CPU;
+
     return transformation_handle;
 }
 
+k4a_transformation_t transformation_create(const k4a_calibration_t *calibration, bool gpu_optimization)
+{
+    return transformation_create_internal(calibration, gpu_optimization, true);
+}
+
+static void transformation_async_stop(k4a_transformation_context_t *transformation_context);
+
 void transformation_destroy(k4a_transformation_t transformation_handle)
 {
     RETURN_VALUE_IF_HANDLE_INVALID(VOID_VALUE, k4a_transformation_t, transformation_handle);
     k4a_transformation_context_t *transformation_context = k4a_transformation_t_get_context(transformation_handle);
 
+    // Requests queued to the worker and to the transform engine are still run before the tables and locks they use are
+    // released. The transform engine only completes its queued requests with a failure if it has failed. Joining both
+    // threads leaves no request in flight.
+    transformation_async_stop(transformation_context);
+
+    if (transformation_context->tewrapper)
+    {
+        tewrapper_destroy(transformation_context->tewrapper);
+        transformation_context->tewrapper = NULL;
+    }
+
     if (transformation_context->memory_depth_camera_xy_tables != 0)
     {
 #ifdef _MSC_VER
@@ -665,14 +789,90 @@ void transformation_destroy(k4a_transformation_t transformation_handle)
         free(transformation_context->memory_color_camera_xy_tables);
 #endif
     }
-    if (transformation_context->tewrapper)
+
+    if (transformation_context->async_queued_condition)
     {
-        tewrapper_destroy(transformation_context->tewrapper);
+        Condition_Deinit(transformation_context->async_queued_condition);
+    }
+    if (transformation_context->async_complete_condition)
+    {
+        Condition_Deinit(transformation_context->async_complete_condition);
+    }
+    if (transformation_context->async_free_condition)
+    {
+        Condition_Deinit(transformation_context->async_free_condition);
+    }
+    if (transformation_context->async_lock)
+    {
+        Lock_Deinit(transformation_context->async_lock);
+    }
+
+    transformation_incremental_destroy(transformation_context->incremental);
+    if (transformation_context->incremental_lock)
+    {
+        Lock_Deinit(transformation_context->incremental_lock);
+    }
+
+    free(transformation_context->scratch_depth_image_data);
+    if (transformation_context->scratch_lock)
+    {
+        Lock_Deinit(transformation_context->scratch_lock);
     }
     k4a_transformation_t_destroy(transformation_handle);
 }
 
-k4a_result_t transformation_depth_image_to_color_camera_custom(
+k4a_result_t transformation_get_calibration(k4a_transformation_t transformation_handle, k4a_calibration_t *calibration)
+{
+    RETURN_VALUE_IF_HANDLE_INVALID(K4A_RESULT_FAILED, k4a_transformation_t, transformation_handle);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, calibration == NULL);
+    k4a_transformation_context_t *transformation_context = k4a_transformation_t_get_context(transformation_handle);
+
+    memcpy(calibration, &transformation_context->calibration, sizeof(k4a_calibration_t));
+    return K4A_RESULT_SUCCEEDED;
+}
+
+k4a_result_t transformation_set_incremental(k4a_transformation_t transformation_handle,
+                                            bool enable,
+                                            float max_changed_fraction)
+{
+    RETURN_VALUE_IF_HANDLE_INVALID(K4A_RESULT_FAILED, k4a_transformation_t, transformation_handle);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, !(max_changed_fraction >= 0.0f && max_changed_fraction <= 1.0f));
+    k4a_transformation_context_t *transformation_context = k4a_transformation_t_get_context(transformation_handle);
+
+    if (enable && !transformation_context->enable_depth_color_transform)
+    {
+        LOG_ERROR("Expect both depth camera and color camera are running to enable incremental transformation.", 0);
+        return K4A_RESULT_FAILED;
+    }
+
+    k4a_result_t result = K4A_RESULT_SUCCEEDED;
+    Lock(transformation_context->incremental_lock);
+    if (!enable)
+    {
+        transformation_incremental_destroy(transformation_context->incremental);
+        transformation_context->incremental = NULL;
+    }
+    else if (transformation_context->incremental == NULL)
+    {
+        transformation_context->incremental = transformation_incremental_create(&transformation_context->calibration);
+        result = K4A_RESULT_FROM_BOOL(transformation_context->incremental != NULL);
+    }
+    transformation_context->incremental_max_changed_fraction = max_changed_fraction;
+    Unlock(transformation_context->incremental_lock);
+    return result;
+}
+
+static bool transformation_incremental_enabled(k4a_transformation_context_t *transformation_context)
+{
+    Lock(transformation_context->incremental_lock);
+    bool enabled = transformation_context->incremental != NULL;
+    Unlock(transformation_context->incremental_lock);
+    return enabled;
+}
+
+// When engine_callback is not NULL and the transform engine is in use, the frame is queued to the engine and
+// engine_callback is called once it has been processed.
+static k4a_result_t transformation_depth_image_to_color_camera_custom_engine(
     k4a_transformation_t transformation_handle,
     const uint8_t *depth_image_data,
     const k4a_transformation_image_descriptor_t *depth_image_descriptor,
@@ -683,7 +883,9 @@ k4a_result_t transformation_depth_image_to_color_camera_custom(
     uint8_t *transformed_custom_image_data,
     k4a_transformation_image_descriptor_t *transformed_custom_image_descriptor,
     k4a_transformation_interpolation_type_t interpolation_type,
-    uint32_t invalid_custom_value)
+    uint32_t invalid_custom_value,
+    tewrapper_complete_cb_t *engine_callback,
+    void *engine_callback_context)
 {
     RETURN_VALUE_IF_HANDLE_INVALID(K4A_RESULT_FAILED, k4a_transformation_t, transformation_handle);
     k4a_transformation_context_t *transformation_context = k4a_transformation_t_get_context(transformation_handle);
@@ -694,7 +896,31 @@ k4a_result_t transformation_depth_image_to_color_camera_custom(
         return K4A_RESULT_FAILED;
     }
 
-    if (transformation_context->enable_gpu_optimization)
+    // Incremental mode runs on the calling thread, requests queued to the transform engine bypass it
+    if (custom_image_data == NULL && engine_callback == NULL)
+    {
+        Lock(transformation_context->incremental_lock);
+        if (transformation_context->incremental != NULL)
+        {
+            k4a_buffer_result_t result = TRACE_BUFFER_CALL(transformation_depth_image_to_color_camera_incremental(
+                &transformation_context->calibration,
+                &transformation_context->depth_camera_xy_tables,
+                transformation_context->incremental,
+                transformation_context->incremental_max_changed_fraction,
+                depth_image_data,
+                depth_image_descriptor,
+                transformed_depth_image_data,
+                transformed_depth_image_descriptor));
+            Unlock(transformation_context->incremental_lock);
+            return K4A_RESULT_FROM_BOOL(result == K4A_BUFFER_RESULT_SUCCEEDED);
+        }
+        Unlock(transformation_context->incremental_lock);
+    }
+
+    k4a_transformation_operation_t operation = custom_image_data != NULL ?
+                                                   K4A_TRANSFORMATION_OPERATION_DEPTH_IMAGE_TO_COLOR_CAMERA_CUSTOM :
+                                                   K4A_TRANSFORMATION_OPERATION_DEPTH_IMAGE_TO_COLOR_CAMERA;
+    if (transformation_context->tuning.backend[operation] == K4A_TRANSFORMATION_BACKEND_GPU)
     {
         if (K4A_BUFFER_RESULT_SUCCEEDED !=
             TRACE_BUFFER_CALL(transformation_depth_image_to_color_camera_validate_parameters(
@@ -747,6 +973,24 @@ k4a_result_t transformation_depth_image_to_color_camera_custom(
             break;
         }
 
+        if (engine_callback != NULL)
+        {
+            return TRACE_CALL(tewrapper_submit_frame(transformation_context->tewrapper,
+                                                     transform_type,
+                                                     depth_image_data,
+                                                     depth_image_size,
+                                                     custom_image_data,
+                                                     custom_image_size,
+                                                     transformed_depth_image_data,
+                                                     transformed_depth_image_size,
+                                                     transformed_custom_image_data,
+                                                     transformed_custom_image_size,
+                                                     interpolation,
+                                                     invalid_custom_value,
+                                                     engine_callback,
+                                                     engine_callback_context));
+        }
+
         if (K4A_FAILED(TRACE_CALL(tewrapper_process_frame(transformation_context->tewrapper,
                                                           transform_type,
                                                           depth_image_data,
@@ -786,14 +1030,179 @@ k4a_result_t transformation_depth_image_to_color_camera_custom(
     return K4A_RESULT_SUCCEEDED;
 }
 
-k4a_result_t
-transformation_color_image_to_depth_camera(k4a_transformation_t transformation_handle,
-                                           const uint8_t *depth_image_data,
-                                           const k4a_transformation_image_descriptor_t *depth_image_descriptor,
-                                           const uint8_t *color_image_data,
-                                           const k4a_transformation_image_descriptor_t *color_image_descriptor,
-                                           uint8_t *transformed_color_image_data,
-                                           k4a_transformation_image_descriptor_t *transformed_color_image_descriptor)
+k4a_result_t transformation_depth_image_to_color_camera_custom(
+    k4a_transformation_t transformation_handle,
+    const uint8_t *depth_image_data,
+    const k4a_transformation_image_descriptor_t *depth_image_descriptor,
+    const uint8_t *custom_image_data,
+    const k4a_transformation_image_descriptor_t *custom_image_descriptor,
+    uint8_t *transformed_depth_image_data,
+    k4a_transformation_image_descriptor_t *transformed_depth_image_descriptor,
+    uint8_t *transformed_custom_image_data,
+    k4a_transformation_image_descriptor_t *transformed_custom_image_descriptor,
+    k4a_transformation_interpolation_type_t interpolation_type,
+    uint32_t invalid_custom_value)
+{
+    return transformation_depth_image_to_color_camera_custom_engine(transformation_handle,
+                                                                    depth_image_data,
+                                                                    depth_image_descriptor,
+                                                                    custom_image_data,
+                                                                    custom_image_descriptor,
+                                                                    transformed_depth_image_data,
+                                                                    transformed_depth_image_descriptor,
+                                                                    transformed_custom_image_data,
+                                                                    transformed_custom_image_descriptor,
+                                                                    interpolation_type,
+                                                                    invalid_custom_value,
+                                                                    NULL,
+                                                                    NULL);
+}
+
+k4a_result_t transformation_depth_image_to_color_camera_channels(
+    k4a_transformation_t transformation_handle,
+    const uint8_t *depth_image_data,
+    const k4a_transformation_image_descriptor_t *depth_image_descriptor,
+    uint8_t *transformed_depth_image_data,
+    k4a_transformation_image_descriptor_t *transformed_depth_image_descriptor,
+    const k4a_transformation_custom_plane_t *planes,
+    uint32_t plane_count)
+{
+    RETURN_VALUE_IF_HANDLE_INVALID(K4A_RESULT_FAILED, k4a_transformation_t, transformation_handle);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, plane_count > 0 && planes == NULL);
+    k4a_transformation_context_t *transformation_context = k4a_transformation_t_get_context(transformation_handle);
+
+    if (plane_count == 1)
+    {
+        // The transform engine handles a single custom image
+        return transformation_depth_image_to_color_camera_custom(transformation_handle,
+                                                                 depth_image_data,
+                                                                 depth_image_descriptor,
+                                                                 planes[0].custom_image_data,
+                                                                 planes[0].custom_image_descriptor,
+                                                                 transformed_depth_image_data,
+                                                                 transformed_depth_image_descriptor,
+                                                                 planes[0].transformed_custom_image_data,
+                                                                 planes[0].transformed_custom_image_descriptor,
+                                                                 planes[0].interpolation_type,
+                                                                 planes[0].invalid_custom_value);
+    }
+
+    if (!transformation_context->enable_depth_color_transform)
+    {
+        LOG_ERROR("Expect both depth camera and color camera are running to transform depth image to color camera.", 0);
+        return K4A_RESULT_FAILED;
+    }
+
+    if (K4A_BUFFER_RESULT_SUCCEEDED != TRACE_BUFFER_CALL(transformation_depth_image_to_color_camera_channels_internal(
+                                           &transformation_context->calibration,
+                                           &transformation_context->depth_camera_xy_tables,
+                                           depth_image_data,
+                                           depth_image_descriptor,
+                                           transformed_depth_image_data,
+                                           transformed_depth_image_descriptor,
+                                           planes,
+                                           plane_count)))
+    {
+        return K4A_RESULT_FAILED;
+    }
+    return K4A_RESULT_SUCCEEDED;
+}
+
+k4a_result_t transformation_ir_image_to_color_camera(
+    k4a_transformation_t transformation_handle,
+    const uint8_t *depth_image_data,
+    const k4a_transformation_image_descriptor_t *depth_image_descriptor,
+    const uint8_t *ir_image_data,
+    const k4a_transformation_image_descriptor_t *ir_image_descriptor,
+    uint8_t *transformed_ir_image_data,
+    k4a_transformation_image_descriptor_t *transformed_ir_image_descriptor,
+    uint8_t *transformed_depth_image_data,
+    k4a_transformation_image_descriptor_t *transformed_depth_image_descriptor)
+{
+    RETURN_VALUE_IF_HANDLE_INVALID(K4A_RESULT_FAILED, k4a_transformation_t, transformation_handle);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, ir_image_data == NULL);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, ir_image_descriptor == NULL);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, transformed_ir_image_data == NULL);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, transformed_ir_image_descriptor == NULL);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED,
+                        transformed_depth_image_data != NULL && transformed_depth_image_descriptor == NULL);
+    k4a_transformation_context_t *transformation_context = k4a_transformation_t_get_context(transformation_handle);
+
+    if (ir_image_descriptor->format != K4A_IMAGE_FORMAT_IR16 ||
+        transformed_ir_image_descriptor->format != K4A_IMAGE_FORMAT_IR16)
+    {
+        LOG_ERROR("Expect IR16 input and output images, got %d and %d.",
+                  ir_image_descriptor->format,
+                  transformed_ir_image_descriptor->format);
+        return K4A_RESULT_FAILED;
+    }
+
+    // Both backends treat the IR image as a 16 bit custom image, the descriptors are only retagged
+    k4a_transformation_image_descriptor_t custom_descriptor = *ir_image_descriptor;
+    k4a_transformation_image_descriptor_t transformed_custom_descriptor = *transformed_ir_image_descriptor;
+    custom_descriptor.format = K4A_IMAGE_FORMAT_CUSTOM16;
+    transformed_custom_descriptor.format = K4A_IMAGE_FORMAT_CUSTOM16;
+
+    // The rasterization needs a depth buffer to resolve occlusions even when the caller does not want it. The handle's
+    // buffer is used, and held until the transformation is done.
+    bool use_scratch = transformed_depth_image_data == NULL;
+    k4a_transformation_image_descriptor_t scratch_depth_descriptor;
+    if (use_scratch)
+    {
+        const k4a_calibration_camera_t *color_camera = &transformation_context->calibration.color_camera_calibration;
+        scratch_depth_descriptor.width_pixels = color_camera->resolution_width;
+        scratch_depth_descriptor.height_pixels = color_camera->resolution_height;
+        scratch_depth_descriptor.stride_bytes = color_camera->resolution_width * (int)sizeof(uint16_t);
+        scratch_depth_descriptor.format = K4A_IMAGE_FORMAT_DEPTH16;
+
+        Lock(transformation_context->scratch_lock);
+        if (transformation_context->scratch_depth_image_data == NULL)
+        {
+            transformation_context->scratch_depth_image_data = (uint8_t *)malloc(
+                (size_t)(scratch_depth_descriptor.stride_bytes * scratch_depth_descriptor.height_pixels));
+            if (transformation_context->scratch_depth_image_data == NULL)
+            {
+                Unlock(transformation_context->scratch_lock);
+                LOG_ERROR("Failed to allocate the depth buffer for IR registration.", 0);
+                return K4A_RESULT_FAILED;
+            }
+        }
+        transformed_depth_image_data = transformation_context->scratch_depth_image_data;
+        transformed_depth_image_descriptor = &scratch_depth_descriptor;
+    }
+
+    k4a_result_t result = TRACE_CALL(
+        transformation_depth_image_to_color_camera_custom_engine(transformation_handle,
+                                                                 depth_image_data,
+                                                                 depth_image_descriptor,
+                                                                 ir_image_data,
+                                                                 &custom_descriptor,
+                                                                 transformed_depth_image_data,
+                                                                 transformed_depth_image_descriptor,
+                                                                 transformed_ir_image_data,
+                                                                 &transformed_custom_descriptor,
+                                                                 K4A_TRANSFORMATION_INTERPOLATION_TYPE_LINEAR,
+                                                                 0,
+                                                                 NULL,
+                                                                 NULL));
+
+    if (use_scratch)
+    {
+        Unlock(transformation_context->scratch_lock);
+    }
+    return result;
+}
+
+static k4a_result_t transformation_color_image_to_depth_camera_engine(
+    k4a_transformation_t transformation_handle,
+    const uint8_t *depth_image_data,
+    const k4a_transformation_image_descriptor_t *depth_image_descriptor,
+    const uint8_t *color_image_data,
+    const k4a_transformation_image_descriptor_t *color_image_descriptor,
+    uint8_t *transformed_color_image_data,
+    k4a_transformation_image_descriptor_t *transformed_color_image_descriptor,
+    tewrapper_complete_cb_t *engine_callback,
+    void *engine_callback_context)
 {
     RETURN_VALUE_IF_HANDLE_INVALID(K4A_RESULT_FAILED, k4a_transformation_t, transformation_handle);
     k4a_transformation_context_t *transformation_context = k4a_transformation_t_get_context(transformation_handle);
@@ -804,7 +1213,8 @@ transformation_color_image_to_depth_camera(k4a_transformation_t transformation_h
         return K4A_RESULT_FAILED;
     }
 
-    if (transformation_context->enable_gpu_optimization)
+    if (transformation_context->tuning.backend[K4A_TRANSFORMATION_OPERATION_COLOR_IMAGE_TO_DEPTH_CAMERA] ==
+        K4A_TRANSFORMATION_BACKEND_GPU)
     {
         if (K4A_BUFFER_RESULT_SUCCEEDED !=
             TRACE_BUFFER_CALL(transformation_color_image_to_depth_camera_validate_parameters(
@@ -827,6 +1237,24 @@ transformation_color_image_to_depth_camera(k4a_transformation_t transformation_h
         size_t transformed_color_image_size = (size_t)(transformed_color_image_descriptor->stride_bytes *
                                                        transformed_color_image_descriptor->height_pixels);
 
+        if (engine_callback != NULL)
+        {
+            return TRACE_CALL(tewrapper_submit_frame(transformation_context->tewrapper,
+                                                     K4A_TRANSFORM_ENGINE_TYPE_COLOR_TO_DEPTH,
+                                                     depth_image_data,
+                                                     depth_image_size,
+                                                     color_image_data,
+                                                     color_image_size,
+                                                     transformed_color_image_data,
+                                                     transformed_color_image_size,
+                                                     NULL,
+                                                     (size_t)0,
+                                                     K4A_TRANSFORM_ENGINE_INTERPOLATION_LINEAR,
+                                                     (uint16_t)0,
+                                                     engine_callback,
+                                                     engine_callback_context));
+        }
+
         if (K4A_FAILED(TRACE_CALL(tewrapper_process_frame(transformation_context->tewrapper,
                                                           K4A_TRANSFORM_ENGINE_TYPE_COLOR_TO_DEPTH,
                                                           depth_image_data,
@@ -862,6 +1290,26 @@ transformation_color_image_to_depth_camera(k4a_transformation_t transformation_h
     return K4A_RESULT_SUCCEEDED;
 }
 
+k4a_result_t
+transformation_color_image_to_depth_camera(k4a_transformation_t transformation_handle,
+                                           const uint8_t *depth_image_data,
+                                           const k4a_transformation_image_descriptor_t *depth_image_descriptor,
+                                           const uint8_t *color_image_data,
+                                           const k4a_transformation_image_descriptor_t *color_image_descriptor,
+                                           uint8_t *transformed_color_image_data,
+                                           k4a_transformation_image_descriptor_t *transformed_color_image_descriptor)
+{
+    return transformation_color_image_to_depth_camera_engine(transformation_handle,
+                                                             depth_image_data,
+                                                             depth_image_descriptor,
+                                                             color_image_data,
+                                                             color_image_descriptor,
+                                                             transformed_color_image_data,
+                                                             transformed_color_image_descriptor,
+                                                             NULL,
+                                                             NULL);
+}
+
 k4a_result_t
 transformation_depth_image_to_point_cloud(k4a_transformation_t transformation_handle,
                                           const uint8_t *depth_image_data,
@@ -894,9 +1342,843 @@ transformation_depth_image_to_point_cloud(k4a_transformation_t transformation_ha
 
     if (K4A_BUFFER_RESULT_SUCCEEDED !=
         TRACE_BUFFER_CALL(transformation_depth_image_to_point_cloud_internal(
-            xy_tables, depth_image_data, depth_image_descriptor, xyz_image_data, xyz_image_descriptor)))
+            xy_tables,
+            depth_image_data,
+            depth_image_descriptor,
+            xyz_image_data,
+            xyz_image_descriptor,
+            transformation_context->tuning.backend[K4A_TRANSFORMATION_OPERATION_DEPTH_IMAGE_TO_POINT_CLOUD])))
+    {
+        return K4A_RESULT_FAILED;
+    }
+    return K4A_RESULT_SUCCEEDED;
+}
+
+k4a_buffer_result_t
+transformation_depth_image_to_mesh(k4a_transformation_t transformation_handle,
+                                   const uint8_t *depth_image_data,
+                                   const k4a_transformation_image_descriptor_t *depth_image_descriptor,
+                                   const k4a_calibration_type_t camera,
+                                   float max_discontinuity_ratio,
+                                   uint8_t *xyz_image_data,
+                                   k4a_transformation_image_descriptor_t *xyz_image_descriptor,
+                                   uint32_t *indices,
+                                   size_t *index_count)
+{
+    RETURN_VALUE_IF_HANDLE_INVALID(K4A_BUFFER_RESULT_FAILED, k4a_transformation_t, transformation_handle);
+    RETURN_VALUE_IF_ARG(K4A_BUFFER_RESULT_FAILED, depth_image_descriptor == NULL);
+    RETURN_VALUE_IF_ARG(K4A_BUFFER_RESULT_FAILED, index_count == NULL);
+    k4a_transformation_context_t *transformation_context = k4a_transformation_t_get_context(transformation_handle);
+
+    // Report the capacity before doing any work, so the caller can size the index buffer with a first call
+    size_t max_index_count = transformation_mesh_max_index_count(depth_image_descriptor);
+    if (indices == NULL || *index_count < max_index_count)
+    {
+        *index_count = max_index_count;
+        return K4A_BUFFER_RESULT_TOO_SMALL;
+    }
+
+    // The vertices are the organized point cloud, indexed like the pixels of the depth image
+    if (K4A_FAILED(TRACE_CALL(transformation_depth_image_to_point_cloud(transformation_handle,
+                                                                        depth_image_data,
+                                                                        depth_image_descriptor,
+                                                                        camera,
+                                                                        xyz_image_data,
+                                                                        xyz_image_descriptor))))
+    {
+        return K4A_BUFFER_RESULT_FAILED;
+    }
+
+    const k4a_transformation_xy_tables_t *xy_tables = camera == K4A_CALIBRATION_TYPE_DEPTH ?
+                                                          &transformation_context->depth_camera_xy_tables :
+                                                          &transformation_context->color_camera_xy_tables;
+    return TRACE_BUFFER_CALL(transformation_depth_image_to_mesh_internal(xy_tables,
+                                                                         depth_image_data,
+                                                                         depth_image_descriptor,
+                                                                         max_discontinuity_ratio,
+                                                                         indices,
+                                                                         index_count));
+}
+
+k4a_buffer_result_t
+transformation_depth_image_to_voxel_cloud(k4a_transformation_t transformation_handle,
+                                          const uint8_t *depth_image_data,
+                                          const k4a_transformation_image_descriptor_t *depth_image_descriptor,
+                                          const uint8_t *color_image_data,
+                                          const k4a_transformation_image_descriptor_t *color_image_descriptor,
+                                          const k4a_calibration_type_t camera,
+                                          const k4a_voxel_grid_t *grid,
+                                          k4a_voxel_point_t *points,
+                                          size_t *point_count)
+{
+    RETURN_VALUE_IF_HANDLE_INVALID(K4A_BUFFER_RESULT_FAILED, k4a_transformation_t, transformation_handle);
+    k4a_transformation_context_t *transformation_context = k4a_transformation_t_get_context(transformation_handle);
+
+    const k4a_transformation_xy_tables_t *xy_tables;
+    if (camera == K4A_CALIBRATION_TYPE_DEPTH)
+    {
+        xy_tables = &transformation_context->depth_camera_xy_tables;
+    }
+    else if (camera == K4A_CALIBRATION_TYPE_COLOR)
+    {
+        xy_tables = &transformation_context->color_camera_xy_tables;
+    }
+    else
+    {
+        LOG_ERROR("Unexpected camera calibration type %d, should either be K4A_CALIBRATION_TYPE_DEPTH (%d) or "
+                  "K4A_CALIBRATION_TYPE_COLOR (%d).",
+                  camera,
+                  K4A_CALIBRATION_TYPE_DEPTH,
+                  K4A_CALIBRATION_TYPE_COLOR);
+        return K4A_BUFFER_RESULT_FAILED;
+    }
+
+    return TRACE_BUFFER_CALL(transformation_depth_image_to_voxel_cloud_internal(
+        xy_tables,
+        depth_image_data,
+        depth_image_descriptor,
+        color_image_data,
+        color_image_descriptor,
+        grid,
+        transformation_context->tuning.backend[K4A_TRANSFORMATION_OPERATION_DEPTH_IMAGE_TO_POINT_CLOUD],
+        points,
+        point_count));
+}
+
+typedef struct _transformation_tuning_image_t
+{
+    k4a_transformation_image_descriptor_t descriptor;
+    uint8_t *data;
+} transformation_tuning_image_t;
+
+// Synthetic frames at the resolutions of the calibration, used to time each backend
+typedef struct _transformation_tuning_frames_t
+{
+    transformation_tuning_image_t depth;
+    transformation_tuning_image_t custom;
+    transformation_tuning_image_t color;
+    transformation_tuning_image_t depth_in_color;
+    transformation_tuning_image_t custom_in_color;
+    transformation_tuning_image_t color_in_depth;
+    transformation_tuning_image_t xyz;
+} transformation_tuning_frames_t;
+
+static bool transformation_tuning_allocate(transformation_tuning_image_t *image,
+                                           const k4a_calibration_camera_t *camera,
+                                           int bytes_per_pixel,
+                                           k4a_image_format_t format)
+{
+    int width = camera->resolution_width;
+    int height = camera->resolution_height;
+    image->descriptor.width_pixels = width;
+    image->descriptor.height_pixels = height;
+    image->descriptor.stride_bytes = width * bytes_per_pixel;
+    image->descriptor.format = format;
+    image->data = (uint8_t *)malloc((size_t)(image->descriptor.stride_bytes * height));
+    return image->data != NULL;
+}
+
+static void transformation_tuning_free(transformation_tuning_frames_t *frames)
+{
+    transformation_tuning_image_t *images[] = {
+        &frames->depth,           &frames->custom,         &frames->color, &frames->depth_in_color,
+        &frames->custom_in_color, &frames->color_in_depth, &frames->xyz,
+    };
+    for (size_t i = 0; i < COUNTOF(images); i++)
+    {
+        free(images[i]->data);
+        images[i]->data = NULL;
+    }
+}
+
+static k4a_result_t transformation_tuning_create_frames(const k4a_calibration_t *calibration,
+                                                        transformation_tuning_frames_t *frames)
+{
+    const k4a_calibration_camera_t *depth_camera = &calibration->depth_camera_calibration;
+    const k4a_calibration_camera_t *color_camera = &calibration->color_camera_calibration;
+    int depth_width = depth_camera->resolution_width;
+    int depth_height = depth_camera->resolution_height;
+
+    memset(frames, 0, sizeof(*frames));
+    bool allocated = transformation_tuning_allocate(&frames->depth, depth_camera, 2, K4A_IMAGE_FORMAT_DEPTH16) &&
+                     transformation_tuning_allocate(&frames->custom, depth_camera, 2, K4A_IMAGE_FORMAT_CUSTOM16) &&
+                     transformation_tuning_allocate(
+                         &frames->color_in_depth, depth_camera, 4, K4A_IMAGE_FORMAT_COLOR_BGRA32) &&
+                     transformation_tuning_allocate(&frames->xyz, depth_camera, 6, K4A_IMAGE_FORMAT_CUSTOM);
+    if (allocated && calibration->color_resolution != K4A_COLOR_RESOLUTION_OFF)
     {
+        allocated = transformation_tuning_allocate(&frames->color, color_camera, 4, K4A_IMAGE_FORMAT_COLOR_BGRA32) &&
+                    transformation_tuning_allocate(
+                        &frames->depth_in_color, color_camera, 2, K4A_IMAGE_FORMAT_DEPTH16) &&
+                    transformation_tuning_allocate(
+                        &frames->custom_in_color, color_camera, 2, K4A_IMAGE_FORMAT_CUSTOM16);
+    }
+
+    if (!allocated)
+    {
+        LOG_ERROR("Failed to allocate frames for transformation auto tuning.", 0);
+        transformation_tuning_free(frames);
         return K4A_RESULT_FAILED;
     }
+
+    // A gently sloped surface, so that every backend does the full amount of work per pixel
+    uint16_t *depth = (uint16_t *)frames->depth.data;
+    uint16_t *custom = (uint16_t *)frames->custom.data;
+    for (int y = 0; y < depth_height; y++)
+    {
+        for (int x = 0; x < depth_width; x++)
+        {
+            depth[y * depth_width + x] = (uint16_t)(TRANSFORMATION_TUNING_DEPTH_MM + (x + y) % 64);
+            custom[y * depth_width + x] = (uint16_t)(x ^ y);
+        }
+    }
+    if (frames->color.data != NULL)
+    {
+        for (int i = 0; i < frames->color.descriptor.stride_bytes * frames->color.descriptor.height_pixels; i++)
+        {
+            frames->color.data[i] = (uint8_t)i;
+        }
+    }
+
+    return K4A_RESULT_SUCCEEDED;
+}
+
+static k4a_result_t transformation_tuning_run(k4a_transformation_t transformation_handle,
+                                              k4a_transformation_operation_t operation,
+                                              transformation_tuning_frames_t *frames)
+{
+    k4a_transformation_image_descriptor_t no_descriptor = { 0 };
+
+    switch (operation)
+    {
+    case K4A_TRANSFORMATION_OPERATION_DEPTH_IMAGE_TO_COLOR_CAMERA:
+        return transformation_depth_image_to_color_camera_custom_engine(transformation_handle,
+                                                                        frames->depth.data,
+                                                                        &frames->depth.descriptor,
+                                                                        NULL,
+                                                                        &no_descriptor,
+                                                                        frames->depth_in_color.data,
+                                                                        &frames->depth_in_color.descriptor,
+                                                                        NULL,
+                                                                        &no_descriptor,
+                                                                        K4A_TRANSFORMATION_INTERPOLATION_TYPE_LINEAR,
+                                                                        0,
+                                                                        NULL,
+                                                                        NULL);
+
+    case K4A_TRANSFORMATION_OPERATION_DEPTH_IMAGE_TO_COLOR_CAMERA_CUSTOM:
+        return transformation_depth_image_to_color_camera_custom_engine(transformation_handle,
+                                                                        frames->depth.data,
+                                                                        &frames->depth.descriptor,
+                                                                        frames->custom.data,
+                                                                        &frames->custom.descriptor,
+                                                                        frames->depth_in_color.data,
+                                                                        &frames->depth_in_color.descriptor,
+                                                                        frames->custom_in_color.data,
+                                                                        &frames->custom_in_color.descriptor,
+                                                                        K4A_TRANSFORMATION_INTERPOLATION_TYPE_LINEAR,
+                                                                        0,
+                                                                        NULL,
+                                                                        NULL);
+
+    case K4A_TRANSFORMATION_OPERATION_COLOR_IMAGE_TO_DEPTH_CAMERA:
+        return transformation_color_image_to_depth_camera_engine(transformation_handle,
+                                                                 frames->depth.data,
+                                                                 &frames->depth.descriptor,
+                                                                 frames->color.data,
+                                                                 &frames->color.descriptor,
+                                                                 frames->color_in_depth.data,
+                                                                 &frames->color_in_depth.descriptor,
+                                                                 NULL,
+                                                                 NULL);
+
+    case K4A_TRANSFORMATION_OPERATION_DEPTH_IMAGE_TO_POINT_CLOUD:
+        return transformation_depth_image_to_point_cloud(transformation_handle,
+                                                         frames->depth.data,
+                                                         &frames->depth.descriptor,
+                                                         K4A_CALIBRATION_TYPE_DEPTH,
+                                                         frames->xyz.data,
+                                                         &frames->xyz.descriptor);
+
+    case K4A_TRANSFORMATION_OPERATION_COUNT:
+        break;
+    }
+    return K4A_RESULT_FAILED;
+}
+
+// Returns the fastest of TRANSFORMATION_TUNING_RUNS timed runs after a warm up run, or 0 if the backend failed
+static uint32_t transformation_tuning_measure(k4a_transformation_t transformation_handle,
+                                              k4a_transformation_context_t *transformation_context,
+                                              k4a_transformation_operation_t operation,
+                                              k4a_transformation_backend_t backend,
+                                              transformation_tuning_frames_t *frames)
+{
+    uint64_t fastest = UINT64_MAX;
+
+    transformation_context->tuning.backend[operation] = backend;
+    for (int run = 0; run <= TRANSFORMATION_TUNING_RUNS; run++)
+    {
+        uint64_t start = transformation_get_time_usec();
+        if (K4A_FAILED(transformation_tuning_run(transformation_handle, operation, frames)))
+        {
+            LOG_WARNING("Transformation backend %d failed operation %d during auto tuning.", backend, operation);
+            return 0;
+        }
+        uint64_t elapsed = transformation_get_time_usec() - start;
+        if (run > 0 && elapsed < fastest)
+        {
+            fastest = elapsed;
+        }
+    }
+
+    if (fastest == 0)
+    {
+        return 1;
+    }
+    return fastest > UINT32_MAX ? UINT32_MAX : (uint32_t)fastest;
+}
+
+static bool transformation_tuning_backend_available(const k4a_transformation_context_t *transformation_context,
+                                                    k4a_transformation_operation_t operation,
+                                                    k4a_transformation_backend_t backend)
+{
+    bool point_cloud = operation == K4A_TRANSFORMATION_OPERATION_DEPTH_IMAGE_TO_POINT_CLOUD;
+    switch (backend)
+    {
+    case K4A_TRANSFORMATION_BACKEND_CPU:
+        return true;
+    case K4A_TRANSFORMATION_BACKEND_CPU_SIMD:
+        return point_cloud && transformation_point_cloud_simd_supported();
+    case K4A_TRANSFORMATION_BACKEND_GPU:
+        return !point_cloud && transformation_context->tewrapper != NULL;
+    case K4A_TRANSFORMATION_BACKEND_COUNT:
+        break;
+    }
+    return false;
+}
+
+static k4a_result_t transformation_tune(k4a_transformation_t transformation_handle)
+{
+    k4a_transformation_context_t *transformation_context = k4a_transformation_t_get_context(transformation_handle);
+    k4a_transformation_tuning_t *tuning = &transformation_context->tuning;
+    transformation_tuning_frames_t frames;
+
+    tuning->auto_tuned = true;
+    if (transformation_context->calibration.depth_mode == K4A_DEPTH_MODE_OFF)
+    {
+        // Every operation needs a depth image
+        return K4A_RESULT_SUCCEEDED;
+    }
+
+    if (K4A_FAILED(TRACE_CALL(transformation_tuning_create_frames(&transformation_context->calibration, &frames))))
+    {
+        return K4A_RESULT_FAILED;
+    }
+
+    for (int operation = 0; operation < K4A_TRANSFORMATION_OPERATION_COUNT; operation++)
+    {
+        if (operation != K4A_TRANSFORMATION_OPERATION_DEPTH_IMAGE_TO_POINT_CLOUD &&
+            !transformation_context->enable_depth_color_transform)
+        {
+            continue;
+        }
+
+        k4a_transformation_backend_t selected = tuning->backend[operation];
+        uint32_t selected_time = UINT32_MAX;
+        for (int backend = 0; backend < K4A_TRANSFORMATION_BACKEND_COUNT; backend++)
+        {
+            if (!transformation_tuning_backend_available(transformation_context,
+                                                         (k4a_transformation_operation_t)operation,
+                                                         (k4a_transformation_backend_t)backend))
+            {
+                continue;
+            }
+
+            uint32_t time_usec = transformation_tuning_measure(transformation_handle,
+                                                               transformation_context,
+                                                               (k4a_transformation_operation_t)operation,
+                                                               (k4a_transformation_backend_t)backend,
+                                                               &frames);
+            tuning->time_usec[operation][backend] = time_usec;
+            if (time_usec != 0 && time_usec < selected_time)
+            {
+                selected = (k4a_transformation_backend_t)backend;
+                selected_time = time_usec;
+            }
+        }
+
+        tuning->backend[operation] = selected;
+        LOG_INFO("Transformation operation %d uses backend %d (%u usec).", operation, selected, selected_time);
+    }
+
+    transformation_tuning_free(&frames);
+
+    // Release the transform engine if no operation is faster on it
+    bool uses_engine = false;
+    for (int operation = 0; operation < K4A_TRANSFORMATION_OPERATION_COUNT; operation++)
+    {
+        uses_engine = uses_engine || tuning->backend[operation] == K4A_TRANSFORMATION_BACKEND_GPU;
+    }
+    if (!uses_engine && transformation_context->tewrapper != NULL)
+    {
+        tewrapper_destroy(transformation_context->tewrapper);
+        transformation_context->tewrapper = NULL;
+    }
+
+    return K4A_RESULT_SUCCEEDED;
+}
+
+k4a_transformation_t transformation_create_auto_tuned(const k4a_calibration_t *calibration, bool gpu_optimization)
+{
+    k4a_transformation_t transformation_handle = transformation_create_internal(calibration, gpu_optimization, false);
+    if (transformation_handle != NULL && K4A_FAILED(TRACE_CALL(transformation_tune(transformation_handle))))
+    {
+        transformation_destroy(transformation_handle);
+        return 0;
+    }
+    return transformation_handle;
+}
+
+k4a_result_t transformation_get_tuning(k4a_transformation_t transformation_handle, k4a_transformation_tuning_t *tuning)
+{
+    RETURN_VALUE_IF_HANDLE_INVALID(K4A_RESULT_FAILED, k4a_transformation_t, transformation_handle);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, tuning == NULL);
+    k4a_transformation_context_t *transformation_context = k4a_transformation_t_get_context(transformation_handle);
+
+    *tuning = transformation_context->tuning;
+    return K4A_RESULT_SUCCEEDED;
+}
+
+static k4a_transformation_image_descriptor_t transformation_get_image_descriptor(k4a_image_t image)
+{
+    k4a_transformation_image_descriptor_t descriptor = { 0 };
+    if (image)
+    {
+        descriptor.width_pixels = image_get_width_pixels(image);
+        descriptor.height_pixels = image_get_height_pixels(image);
+        descriptor.stride_bytes = image_get_stride_bytes(image);
+        descriptor.format = image_get_format(image);
+    }
+    return descriptor;
+}
+
+static uint8_t *transformation_get_image_buffer(k4a_image_t image)
+{
+    return image ? image_get_buffer(image) : NULL;
+}
+
+// Runs a request on the calling thread. When engine_callback is not NULL and the request goes to the transform
+// engine, the request is queued and engine_callback reports the result.
+static k4a_result_t transformation_run_request(k4a_transformation_t transformation_handle,
+                                               const k4a_transformation_request_t *request,
+                                               tewrapper_complete_cb_t *engine_callback,
+                                               void *engine_callback_context)
+{
+    k4a_transformation_image_descriptor_t depth_descriptor = transformation_get_image_descriptor(request->depth_image);
+    k4a_transformation_image_descriptor_t transformed_descriptor = transformation_get_image_descriptor(
+        request->transformed_image);
+    k4a_transformation_image_descriptor_t custom_descriptor = { 0 };
+    k4a_transformation_image_descriptor_t transformed_custom_descriptor = { 0 };
+    k4a_transformation_image_descriptor_t color_descriptor;
+
+    switch (request->operation)
+    {
+    case K4A_TRANSFORMATION_OPERATION_DEPTH_IMAGE_TO_COLOR_CAMERA_CUSTOM:
+        custom_descriptor = transformation_get_image_descriptor(request->custom_image);
+        transformed_custom_descriptor = transformation_get_image_descriptor(request->transformed_custom_image);
+        // fall through
+    case K4A_TRANSFORMATION_OPERATION_DEPTH_IMAGE_TO_COLOR_CAMERA:
+        return transformation_depth_image_to_color_camera_custom_engine(
+            transformation_handle,
+            transformation_get_image_buffer(request->depth_image),
+            &depth_descriptor,
+            transformation_get_image_buffer(request->custom_image),
+            &custom_descriptor,
+            transformation_get_image_buffer(request->transformed_image),
+            &transformed_descriptor,
+            transformation_get_image_buffer(request->transformed_custom_image),
+            &transformed_custom_descriptor,
+            request->interpolation_type,
+            request->invalid_custom_value,
+            engine_callback,
+            engine_callback_context);
+
+    case K4A_TRANSFORMATION_OPERATION_COLOR_IMAGE_TO_DEPTH_CAMERA:
+        color_descriptor = transformation_get_image_descriptor(request->color_image);
+        if (color_descriptor.format != K4A_IMAGE_FORMAT_COLOR_BGRA32 ||
+            transformed_descriptor.format != K4A_IMAGE_FORMAT_COLOR_BGRA32)
+        {
+            LOG_ERROR("Require color image and transformed color image both have bgra32 format.", 0);
+            return K4A_RESULT_FAILED;
+        }
+        return transformation_color_image_to_depth_camera_engine(
+            transformation_handle,
+            transformation_get_image_buffer(request->depth_image),
+            &depth_descriptor,
+            transformation_get_image_buffer(request->color_image),
+            &color_descriptor,
+            transformation_get_image_buffer(request->transformed_image),
+            &transformed_descriptor,
+            engine_callback,
+            engine_callback_context);
+
+    case K4A_TRANSFORMATION_OPERATION_DEPTH_IMAGE_TO_POINT_CLOUD:
+        return transformation_depth_image_to_point_cloud(transformation_handle,
+                                                         transformation_get_image_buffer(request->depth_image),
+                                                         &depth_descriptor,
+                                                         request->camera,
+                                                         transformation_get_image_buffer(request->transformed_image),
+                                                         &transformed_descriptor);
+
+    case K4A_TRANSFORMATION_OPERATION_COUNT:
+        break;
+    }
+
+    LOG_ERROR("Unexpected transformation operation %d.", request->operation);
+    return K4A_RESULT_FAILED;
+}
+
+static bool transformation_request_uses_engine(k4a_transformation_context_t *transformation_context,
+                                               const k4a_transformation_request_t *request)
+{
+    if (request->operation == K4A_TRANSFORMATION_OPERATION_DEPTH_IMAGE_TO_COLOR_CAMERA &&
+        transformation_incremental_enabled(transformation_context))
+    {
+        return false;
+    }
+    return transformation_context->enable_depth_color_transform &&
+           request->operation < K4A_TRANSFORMATION_OPERATION_COUNT &&
+           transformation_context->tuning.backend[request->operation] == K4A_TRANSFORMATION_BACKEND_GPU;
+}
+
+static void transformation_request_release_images(k4a_transformation_request_t *request)
+{
+    k4a_image_t images[] = { request->depth_image,
+                             request->color_image,
+                             request->custom_image,
+                             request->transformed_image,
+                             request->transformed_custom_image };
+    for (size_t i = 0; i < sizeof(images) / sizeof(images[0]); i++)
+    {
+        if (images[i])
+        {
+            image_dec_ref(images[i]);
+        }
+    }
+}
+
+// Condition_Post wakes a single waiter, so it is posted once per waiting thread. Each waiter re-checks its predicate.
+// Must be called with async_lock held.
+static void transformation_async_broadcast_locked(COND_HANDLE condition, uint32_t waiters)
+{
+    for (uint32_t i = 0; i < waiters; i++)
+    {
+        Condition_Post(condition);
+    }
+}
+
+// Called once per submitted request, from the worker thread, the transform engine thread, or the submitting thread if
+// the request could not be queued to the transform engine.
+static void transformation_async_complete(void *context, k4a_result_t result)
+{
+    transformation_async_request_t *async_request = (transformation_async_request_t *)context;
+    k4a_transformation_context_t *transformation_context = async_request->transformation_context;
+    k4a_transformation_request_t request = async_request->request;
+    k4a_transformation_ticket_t ticket = async_request->ticket;
+
+    transformation_request_release_images(&request);
+
+    if (request.callback)
+    {
+        request.callback(request.callback_context, ticket, result);
+
+        Lock(transformation_context->async_lock);
+        async_request->state = TRANSFORMATION_REQUEST_FREE;
+        transformation_context->in_flight--;
+        transformation_async_broadcast_locked(transformation_context->async_free_condition,
+                                              transformation_context->async_free_waiters);
+        Unlock(transformation_context->async_lock);
+    }
+    else
+    {
+        Lock(transformation_context->async_lock);
+        async_request->result = result;
+        async_request->state = TRANSFORMATION_REQUEST_COMPLETE;
+        transformation_async_broadcast_locked(transformation_context->async_complete_condition,
+                                              transformation_context->async_complete_waiters);
+        Unlock(transformation_context->async_lock);
+    }
+}
+
+static int transformation_async_thread(void *param)
+{
+    k4a_transformation_context_t *transformation_context = (k4a_transformation_context_t *)param;
+
+    // Requests already queued are completed before the thread exits
+    Lock(transformation_context->async_lock);
+    while (!transformation_context->async_stop || transformation_context->cpu_queue_count > 0)
+    {
+        if (transformation_context->cpu_queue_count == 0)
+        {
+            int infinite_timeout = 0;
+            (void)Condition_Wait(transformation_context->async_queued_condition,
+                                 transformation_context->async_lock,
+                                 infinite_timeout);
+            continue;
+        }
+
+        uint32_t index = transformation_context->cpu_queue[transformation_context->cpu_queue_head];
+        transformation_async_request_t *async_request = &transformation_context->requests[index];
+        transformation_context->cpu_queue_head = (transformation_context->cpu_queue_head + 1) %
+                                                 TRANSFORMATION_MAX_IN_FLIGHT;
+        transformation_context->cpu_queue_count--;
+        Unlock(transformation_context->async_lock);
+
+        k4a_result_t result = TRACE_CALL(
+            transformation_run_request(async_request->transformation_handle, &async_request->request, NULL, NULL));
+        transformation_async_complete(async_request, result);
+
+        Lock(transformation_context->async_lock);
+    }
+    Unlock(transformation_context->async_lock);
+
+    return 0;
+}
+
+static void transformation_async_stop(k4a_transformation_context_t *transformation_context)
+{
+    if (transformation_context->async_lock == NULL)
+    {
+        return;
+    }
+
+    Lock(transformation_context->async_lock);
+    transformation_context->async_stop = true;
+    THREAD_HANDLE thread = transformation_context->async_thread;
+    transformation_context->async_thread = NULL;
+    Condition_Post(transformation_context->async_queued_condition);
+    Unlock(transformation_context->async_lock);
+
+    if (thread)
+    {
+        int thread_result;
+        THREADAPI_RESULT tresult = ThreadAPI_Join(thread, &thread_result);
+        (void)K4A_RESULT_FROM_BOOL(tresult == THREADAPI_OK); // Trace the issue, but we don't return a failure
+    }
+}
+
+// Waits on condition with async_lock held, tracking the remaining time of timeout_in_ms. waiters counts the threads
+// waiting on condition for transformation_async_broadcast_locked(). Returns K4A_WAIT_RESULT_SUCCEEDED if the caller
+// should check its predicate again.
+static k4a_wait_result_t transformation_async_wait_locked(k4a_transformation_context_t *transformation_context,
+                                                          COND_HANDLE condition,
+                                                          uint32_t *waiters,
+                                                          int32_t timeout_in_ms,
+                                                          uint64_t start_usec)
+{
+    int wait_in_ms = 0; // infinite to Condition_Wait
+    if (timeout_in_ms == 0)
+    {
+        return K4A_WAIT_RESULT_TIMEOUT;
+    }
+
+    if (timeout_in_ms != K4A_WAIT_INFINITE)
+    {
+        uint64_t elapsed_usec = transformation_get_time_usec() - start_usec;
+        if (elapsed_usec >= (uint64_t)timeout_in_ms * 1000)
+        {
+            return K4A_WAIT_RESULT_TIMEOUT;
+        }
+
+        // Round up so that less than a millisecond left does not become an infinite wait
+        wait_in_ms = (int)(((uint64_t)timeout_in_ms * 1000 - elapsed_usec + 999) / 1000);
+    }
+
+    (*waiters)++;
+    COND_RESULT cond_result = Condition_Wait(condition, transformation_context->async_lock, wait_in_ms);
+    (*waiters)--;
+    if (cond_result == COND_ERROR)
+    {
+        LOG_ERROR("Transformation wait failed.", 0);
+        return K4A_WAIT_RESULT_FAILED;
+    }
+    return K4A_WAIT_RESULT_SUCCEEDED;
+}
+
+k4a_result_t transformation_set_max_in_flight(k4a_transformation_t transformation_handle, uint32_t max_in_flight)
+{
+    RETURN_VALUE_IF_HANDLE_INVALID(K4A_RESULT_FAILED, k4a_transformation_t, transformation_handle);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, max_in_flight == 0 || max_in_flight > TRANSFORMATION_MAX_IN_FLIGHT);
+    k4a_transformation_context_t *transformation_context = k4a_transformation_t_get_context(transformation_handle);
+
+    Lock(transformation_context->async_lock);
+    transformation_context->max_in_flight = max_in_flight;
+    transformation_async_broadcast_locked(transformation_context->async_free_condition,
+                                          transformation_context->async_free_waiters);
+    Unlock(transformation_context->async_lock);
+
     return K4A_RESULT_SUCCEEDED;
 }
+
+k4a_wait_result_t transformation_submit(k4a_transformation_t transformation_handle,
+                                        const k4a_transformation_request_t *request,
+                                        int32_t timeout_in_ms,
+                                        k4a_transformation_ticket_t *ticket)
+{
+    RETURN_VALUE_IF_HANDLE_INVALID(K4A_WAIT_RESULT_FAILED, k4a_transformation_t, transformation_handle);
+    RETURN_VALUE_IF_ARG(K4A_WAIT_RESULT_FAILED, request == NULL);
+    RETURN_VALUE_IF_ARG(K4A_WAIT_RESULT_FAILED, ticket == NULL);
+    RETURN_VALUE_IF_ARG(K4A_WAIT_RESULT_FAILED, request->depth_image == NULL);
+    RETURN_VALUE_IF_ARG(K4A_WAIT_RESULT_FAILED, request->transformed_image == NULL);
+    RETURN_VALUE_IF_ARG(K4A_WAIT_RESULT_FAILED,
+                        request->operation == K4A_TRANSFORMATION_OPERATION_COLOR_IMAGE_TO_DEPTH_CAMERA &&
+                            request->color_image == NULL);
+    RETURN_VALUE_IF_ARG(K4A_WAIT_RESULT_FAILED,
+                        request->operation == K4A_TRANSFORMATION_OPERATION_DEPTH_IMAGE_TO_COLOR_CAMERA_CUSTOM &&
+                            (request->custom_image == NULL || request->transformed_custom_image == NULL));
+    RETURN_VALUE_IF_ARG(K4A_WAIT_RESULT_FAILED,
+                        request->operation < K4A_TRANSFORMATION_OPERATION_DEPTH_IMAGE_TO_COLOR_CAMERA ||
+                            request->operation > K4A_TRANSFORMATION_OPERATION_DEPTH_IMAGE_TO_POINT_CLOUD);
+    k4a_transformation_context_t *transformation_context = k4a_transformation_t_get_context(transformation_handle);
+
+    uint64_t start_usec = transformation_get_time_usec();
+    k4a_wait_result_t wresult = K4A_WAIT_RESULT_SUCCEEDED;
+    transformation_async_request_t *async_request = NULL;
+    bool uses_engine = transformation_request_uses_engine(transformation_context, request);
+
+    Lock(transformation_context->async_lock);
+    while (wresult == K4A_WAIT_RESULT_SUCCEEDED &&
+           transformation_context->in_flight >= transformation_context->max_in_flight)
+    {
+        wresult = transformation_async_wait_locked(transformation_context,
+                                                   transformation_context->async_free_condition,
+                                                   &transformation_context->async_free_waiters,
+                                                   timeout_in_ms,
+                                                   start_usec);
+    }
+
+    if (wresult == K4A_WAIT_RESULT_SUCCEEDED && !uses_engine && transformation_context->async_thread == NULL)
+    {
+        THREADAPI_RESULT tresult = ThreadAPI_Create(&transformation_context->async_thread,
+                                                    transformation_async_thread,
+                                                    transformation_context);
+        if (K4A_FAILED(K4A_RESULT_FROM_BOOL(tresult == THREADAPI_OK)))
+        {
+            transformation_context->async_thread = NULL;
+            wresult = K4A_WAIT_RESULT_FAILED;
+        }
+    }
+
+    if (wresult == K4A_WAIT_RESULT_SUCCEEDED)
+    {
+        for (uint32_t i = 0; i < TRANSFORMATION_MAX_IN_FLIGHT && async_request == NULL; i++)
+        {
+            if (transformation_context->requests[i].state == TRANSFORMATION_REQUEST_FREE)
+            {
+                async_request = &transformation_context->requests[i];
+            }
+        }
+
+        // in_flight counts every request that is not free
+        assert(async_request != NULL);
+
+        async_request->transformation_handle = transformation_handle;
+        async_request->transformation_context = transformation_context;
+        async_request->state = TRANSFORMATION_REQUEST_PENDING;
+        async_request->ticket = ++transformation_context->last_ticket;
+        async_request->request = *request;
+        async_request->result = K4A_RESULT_FAILED;
+        transformation_context->in_flight++;
+        *ticket = async_request->ticket;
+
+        k4a_image_t images[] = { request->depth_image,
+                                 request->color_image,
+                                 request->custom_image,
+                                 request->transformed_image,
+                                 request->transformed_custom_image };
+        for (size_t i = 0; i < sizeof(images) / sizeof(images[0]); i++)
+        {
+            if (images[i])
+            {
+                image_inc_ref(images[i]);
+            }
+        }
+
+        if (!uses_engine)
+        {
+            uint32_t tail = (transformation_context->cpu_queue_head + transformation_context->cpu_queue_count) %
+                            TRANSFORMATION_MAX_IN_FLIGHT;
+            transformation_context->cpu_queue[tail] = (uint32_t)(async_request - transformation_context->requests);
+            transformation_context->cpu_queue_count++;
+            Condition_Post(transformation_context->async_queued_condition);
+        }
+    }
+    Unlock(transformation_context->async_lock);
+
+    if (async_request != NULL && uses_engine)
+    {
+        // Queue to the transform engine outside of the lock; the engine callback may run before this returns
+        if (K4A_FAILED(TRACE_CALL(transformation_run_request(transformation_handle,
+                                                             &async_request->request,
+                                                             transformation_async_complete,
+                                                             async_request))))
+        {
+            transformation_async_complete(async_request, K4A_RESULT_FAILED);
+        }
+    }
+
+    return wresult;
+}
+
+k4a_wait_result_t transformation_wait(k4a_transformation_t transformation_handle,
+                                      k4a_transformation_ticket_t ticket,
+                                      int32_t timeout_in_ms,
+                                      k4a_result_t *result)
+{
+    RETURN_VALUE_IF_HANDLE_INVALID(K4A_WAIT_RESULT_FAILED, k4a_transformation_t, transformation_handle);
+    RETURN_VALUE_IF_ARG(K4A_WAIT_RESULT_FAILED, result == NULL);
+    k4a_transformation_context_t *transformation_context = k4a_transformation_t_get_context(transformation_handle);
+
+    uint64_t start_usec = transformation_get_time_usec();
+    k4a_wait_result_t wresult = K4A_WAIT_RESULT_SUCCEEDED;
+    transformation_async_request_t *async_request = NULL;
+
+    Lock(transformation_context->async_lock);
+    for (uint32_t i = 0; i < TRANSFORMATION_MAX_IN_FLIGHT && async_request == NULL; i++)
+    {
+        transformation_async_request_t *candidate = &transformation_context->requests[i];
+        if (candidate->state != TRANSFORMATION_REQUEST_FREE && candidate->ticket == ticket &&
+            candidate->request.callback == NULL)
+        {
+            async_request = candidate;
+        }
+    }
+
+    if (async_request == NULL)
+    {
+        LOG_ERROR("Transformation ticket %llu is not outstanding.", (unsigned long long)ticket);
+        wresult = K4A_WAIT_RESULT_FAILED;
+    }
+
+    // A ticket is unique, so the request can not be freed by anyone else while it is waited on
+    while (wresult == K4A_WAIT_RESULT_SUCCEEDED && async_request->state != TRANSFORMATION_REQUEST_COMPLETE)
+    {
+        wresult = transformation_async_wait_locked(transformation_context,
+                                                   transformation_context->async_complete_condition,
+                                                   &transformation_context->async_complete_waiters,
+                                                   timeout_in_ms,
+                                                   start_usec);
+    }
+
+    if (wresult == K4A_WAIT_RESULT_SUCCEEDED)
+    {
+        *result = async_request->result;
+        async_request->state = TRANSFORMATION_REQUEST_FREE;
+        transformation_context->in_flight--;
+        transformation_async_broadcast_locked(transformation_context->async_free_condition,
+                                              transformation_context->async_free_waiters);
+    }
+    Unlock(transformation_context->async_lock);
+
+    return wresult;
+}
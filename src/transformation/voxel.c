@@ -0,0 +1,478 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+// This library
+#include <k4ainternal/transformation.h>
+
+// Dependent libraries
+#include <k4ainternal/logging.h>
+
+// System dependencies
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__amd64__) || defined(_M_AMD64) || defined(__i386__) || defined(_M_X86)
+#define K4A_USING_SSE
+#include <smmintrin.h> // SSE4.1
+#endif
+
+#define VOXEL_INITIAL_CAPACITY (4096)
+
+// Voxels along each axis are limited so that a voxel's coordinates pack into a 64 bit key
+#define VOXEL_MAX_CELLS_PER_AXIS (1 << 20)
+
+// Sums are kept in integers, so the result does not depend on the order in which points are added
+typedef struct _transformation_voxel_t
+{
+    uint64_t key;
+    int64_t position_sum[3];
+    uint32_t color_sum[4];
+    uint32_t count;
+} transformation_voxel_t;
+
+// Open addressing hash table over voxels stored in the order they were first seen
+typedef struct _transformation_voxel_table_t
+{
+    uint32_t *slots; // Index + 1 into voxels, 0 if the slot is empty
+    uint32_t slot_mask;
+    transformation_voxel_t *voxels;
+    uint32_t voxel_count;
+    uint32_t voxel_capacity;
+    bool failed; // Set if the table could not grow
+} transformation_voxel_table_t;
+
+typedef struct _transformation_voxel_context_t
+{
+    const k4a_transformation_xy_tables_t *xy_tables;
+    const uint16_t *depth_image;
+    const uint8_t *color_image; // BGRA32 matching the depth image, or NULL
+    int width;
+    float min_bounds[3];
+    float max_bounds[3];
+    float inverse_voxel_size;
+    uint64_t cells[3];
+    bool round_half_even; // Round coordinates like the SIMD point cloud kernel instead of the portable one
+    transformation_voxel_table_t tables[TRANSFORMATION_MAX_WORKERS];
+} transformation_voxel_context_t;
+
+static inline uint32_t transformation_voxel_hash(uint64_t key)
+{
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    key *= 0xc4ceb9fe1a85ec53ULL;
+    key ^= key >> 33;
+    return (uint32_t)key;
+}
+
+static void transformation_voxel_table_destroy(transformation_voxel_table_t *table)
+{
+    free(table->slots);
+    free(table->voxels);
+    memset(table, 0, sizeof(transformation_voxel_table_t));
+}
+
+static bool transformation_voxel_table_rehash(transformation_voxel_table_t *table, uint32_t slot_count)
+{
+    uint32_t *slots = (uint32_t *)calloc(slot_count, sizeof(uint32_t));
+    if (slots == NULL)
+    {
+        return false;
+    }
+
+    uint32_t slot_mask = slot_count - 1;
+    for (uint32_t i = 0; i < table->voxel_count; i++)
+    {
+        uint32_t slot = transformation_voxel_hash(table->voxels[i].key) & slot_mask;
+        while (slots[slot] != 0)
+        {
+            slot = (slot + 1) & slot_mask;
+        }
+        slots[slot] = i + 1;
+    }
+
+    free(table->slots);
+    table->slots = slots;
+    table->slot_mask = slot_mask;
+    return true;
+}
+
+// Returns the voxel of key, adding an empty one if it is not in the table yet
+static transformation_voxel_t *transformation_voxel_table_find(transformation_voxel_table_t *table, uint64_t key)
+{
+    if (table->failed)
+    {
+        return NULL;
+    }
+
+    // Keep the load factor under one half
+    if (table->slots == NULL || (table->voxel_count + 1) * 2 > table->slot_mask + 1)
+    {
+        uint32_t slot_count = table->slots == NULL ? VOXEL_INITIAL_CAPACITY * 2 : (table->slot_mask + 1) * 2;
+        if (!transformation_voxel_table_rehash(table, slot_count))
+        {
+            table->failed = true;
+            return NULL;
+        }
+    }
+
+    uint32_t slot = transformation_voxel_hash(key) & table->slot_mask;
+    while (table->slots[slot] != 0)
+    {
+        transformation_voxel_t *voxel = &table->voxels[table->slots[slot] - 1];
+        if (voxel->key == key)
+        {
+            return voxel;
+        }
+        slot = (slot + 1) & table->slot_mask;
+    }
+
+    if (table->voxel_count == table->voxel_capacity)
+    {
+        uint32_t voxel_capacity = table->voxel_capacity == 0 ? VOXEL_INITIAL_CAPACITY : table->voxel_capacity * 2;
+        transformation_voxel_t *voxels = (transformation_voxel_t *)realloc(table->voxels,
+                                                                           voxel_capacity *
+                                                                               sizeof(transformation_voxel_t));
+        if (voxels == NULL)
+        {
+            table->failed = true;
+            return NULL;
+        }
+        table->voxels = voxels;
+        table->voxel_capacity = voxel_capacity;
+    }
+
+    transformation_voxel_t *voxel = &table->voxels[table->voxel_count++];
+    memset(voxel, 0, sizeof(transformation_voxel_t));
+    voxel->key = key;
+    table->slots[slot] = table->voxel_count;
+    return voxel;
+}
+
+// Adds the point of depth pixel index, whose position has been rounded to millimeters like the point cloud
+static inline void transformation_voxel_add(const transformation_voxel_context_t *voxels,
+                                            transformation_voxel_table_t *table,
+                                            uint32_t index,
+                                            const int32_t position[3],
+                                            const int32_t cell[3])
+{
+    uint64_t key = (uint64_t)cell[0] + voxels->cells[0] * ((uint64_t)cell[1] + voxels->cells[1] * (uint64_t)cell[2]);
+    transformation_voxel_t *voxel = transformation_voxel_table_find(table, key);
+    if (voxel == NULL)
+    {
+        return;
+    }
+
+    voxel->position_sum[0] += position[0];
+    voxel->position_sum[1] += position[1];
+    voxel->position_sum[2] += position[2];
+    if (voxels->color_image != NULL)
+    {
+        const uint8_t *bgra = voxels->color_image + (size_t)index * 4;
+        voxel->color_sum[0] += bgra[0];
+        voxel->color_sum[1] += bgra[1];
+        voxel->color_sum[2] += bgra[2];
+        voxel->color_sum[3] += bgra[3];
+    }
+    voxel->count++;
+}
+
+// Computes the point and voxel of one depth pixel. Returns false if the pixel has no depth or falls outside the grid.
+static inline bool transformation_voxel_point(const transformation_voxel_context_t *voxels,
+                                              uint32_t index,
+                                              int32_t position[3],
+                                              int32_t cell[3])
+{
+    float x_tab = voxels->xy_tables->x_table[index];
+    uint16_t depth = voxels->depth_image[index];
+    if (depth == 0 || isnan(x_tab))
+    {
+        return false;
+    }
+
+    float z = (float)depth;
+    if (voxels->round_half_even)
+    {
+        position[0] = (int32_t)rintf(z * x_tab);
+        position[1] = (int32_t)rintf(z * voxels->xy_tables->y_table[index]);
+    }
+    else
+    {
+        position[0] = (int32_t)floorf(x_tab * z + 0.5f);
+        position[1] = (int32_t)floorf(voxels->xy_tables->y_table[index] * z + 0.5f);
+    }
+    position[2] = (int32_t)depth;
+
+    for (int axis = 0; axis < 3; axis++)
+    {
+        float coordinate = (float)position[axis];
+        if (!(coordinate >= voxels->min_bounds[axis] && coordinate < voxels->max_bounds[axis]))
+        {
+            return false;
+        }
+        cell[axis] = (int32_t)floorf((coordinate - voxels->min_bounds[axis]) * voxels->inverse_voxel_size);
+        if ((uint64_t)cell[axis] >= voxels->cells[axis])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+#if defined(K4A_USING_SSE)
+// Computes the points and voxels of four depth pixels with the same arithmetic as transformation_voxel_point().
+// Returns a mask of the pixels that have a voxel.
+static inline int transformation_voxel_point_sse(const transformation_voxel_context_t *voxels,
+                                                 uint32_t index,
+                                                 int32_t position[3][4],
+                                                 int32_t cell[3][4])
+{
+    __m128i depth = _mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i *)(voxels->depth_image + index)));
+    __m128 x_tab = _mm_loadu_ps(voxels->xy_tables->x_table + index);
+    __m128 y_tab = _mm_loadu_ps(voxels->xy_tables->y_table + index);
+    __m128 z = _mm_cvtepi32_ps(depth);
+    __m128 half = _mm_set1_ps(0.5f);
+
+    __m128 valid = _mm_and_ps(_mm_cmpeq_ps(x_tab, x_tab), _mm_cmpneq_ps(z, _mm_setzero_ps()));
+    __m128 coordinates[3];
+    if (voxels->round_half_even)
+    {
+        coordinates[0] = _mm_round_ps(_mm_mul_ps(z, x_tab), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+        coordinates[1] = _mm_round_ps(_mm_mul_ps(z, y_tab), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    }
+    else
+    {
+        coordinates[0] = _mm_floor_ps(_mm_add_ps(_mm_mul_ps(x_tab, z), half));
+        coordinates[1] = _mm_floor_ps(_mm_add_ps(_mm_mul_ps(y_tab, z), half));
+    }
+    coordinates[2] = z;
+    __m128 inverse_voxel_size = _mm_set1_ps(voxels->inverse_voxel_size);
+
+    for (int axis = 0; axis < 3; axis++)
+    {
+        __m128 min_bounds = _mm_set1_ps(voxels->min_bounds[axis]);
+        __m128 max_bounds = _mm_set1_ps(voxels->max_bounds[axis]);
+        valid = _mm_and_ps(valid, _mm_cmpge_ps(coordinates[axis], min_bounds));
+        valid = _mm_and_ps(valid, _mm_cmplt_ps(coordinates[axis], max_bounds));
+
+        // Invalid lanes may hold NaN or out of range values, they are masked out below
+        __m128 cells = _mm_floor_ps(_mm_mul_ps(_mm_sub_ps(coordinates[axis], min_bounds), inverse_voxel_size));
+        _mm_storeu_si128((__m128i *)position[axis], _mm_cvttps_epi32(coordinates[axis]));
+        _mm_storeu_si128((__m128i *)cell[axis], _mm_cvttps_epi32(cells));
+    }
+
+    int mask = _mm_movemask_ps(valid);
+    for (int lane = 0; lane < 4; lane++)
+    {
+        for (int axis = 0; axis < 3; axis++)
+        {
+            if ((uint64_t)cell[axis][lane] >= voxels->cells[axis])
+            {
+                mask &= ~(1 << lane);
+            }
+        }
+    }
+    return mask;
+}
+#endif
+
+static void transformation_voxel_rows(void *context, uint32_t worker, uint32_t begin, uint32_t end)
+{
+    transformation_voxel_context_t *voxels = (transformation_voxel_context_t *)context;
+    transformation_voxel_table_t *table = &voxels->tables[worker];
+
+    uint32_t index = begin * (uint32_t)voxels->width;
+    uint32_t end_index = end * (uint32_t)voxels->width;
+#if defined(K4A_USING_SSE)
+    for (; index + 4 <= end_index; index += 4)
+    {
+        int32_t positions[3][4];
+        int32_t cells[3][4];
+        int mask = transformation_voxel_point_sse(voxels, index, positions, cells);
+        for (int lane = 0; mask != 0; lane++, mask >>= 1)
+        {
+            if (mask & 1)
+            {
+                int32_t position[3] = { positions[0][lane], positions[1][lane], positions[2][lane] };
+                int32_t cell[3] = { cells[0][lane], cells[1][lane], cells[2][lane] };
+                transformation_voxel_add(voxels, table, index + (uint32_t)lane, position, cell);
+            }
+        }
+    }
+#endif
+    for (; index < end_index; index++)
+    {
+        int32_t position[3];
+        int32_t cell[3];
+        if (transformation_voxel_point(voxels, index, position, cell))
+        {
+            transformation_voxel_add(voxels, table, index, position, cell);
+        }
+    }
+}
+
+size_t transformation_voxel_cloud_max_point_count(const k4a_transformation_image_descriptor_t *depth_image_descriptor,
+                                                  const k4a_voxel_grid_t *grid)
+{
+    size_t pixels = (size_t)depth_image_descriptor->width_pixels * (size_t)depth_image_descriptor->height_pixels;
+    double cells = 1.0;
+    const float *min_bounds = grid->min_bounds.v;
+    const float *max_bounds = grid->max_bounds.v;
+    for (int axis = 0; axis < 3; axis++)
+    {
+        cells *= ceil(((double)max_bounds[axis] - (double)min_bounds[axis]) / (double)grid->voxel_size);
+    }
+    return cells < (double)pixels ? (size_t)cells : pixels;
+}
+
+k4a_buffer_result_t
+transformation_depth_image_to_voxel_cloud_internal(const k4a_transformation_xy_tables_t *xy_tables,
+                                                   const uint8_t *depth_image_data,
+                                                   const k4a_transformation_image_descriptor_t *depth_image_descriptor,
+                                                   const uint8_t *color_image_data,
+                                                   const k4a_transformation_image_descriptor_t *color_image_descriptor,
+                                                   const k4a_voxel_grid_t *grid,
+                                                   k4a_transformation_backend_t backend,
+                                                   k4a_voxel_point_t *points,
+                                                   size_t *point_count)
+{
+    if (xy_tables == 0 || depth_image_data == 0 || depth_image_descriptor == 0 || grid == 0 || point_count == 0)
+    {
+        LOG_ERROR("Depth image, xy tables, voxel grid and point count are required to build a voxel cloud.", 0);
+        return K4A_BUFFER_RESULT_FAILED;
+    }
+
+    if (depth_image_descriptor->format != K4A_IMAGE_FORMAT_DEPTH16 ||
+        depth_image_descriptor->width_pixels != xy_tables->width ||
+        depth_image_descriptor->height_pixels != xy_tables->height ||
+        depth_image_descriptor->stride_bytes != depth_image_descriptor->width_pixels * (int)sizeof(uint16_t))
+    {
+        LOG_ERROR("Unexpected depth image of format %d, %dx%d with stride %d for a %dx%d camera.",
+                  depth_image_descriptor->format,
+                  depth_image_descriptor->width_pixels,
+                  depth_image_descriptor->height_pixels,
+                  depth_image_descriptor->stride_bytes,
+                  xy_tables->width,
+                  xy_tables->height);
+        return K4A_BUFFER_RESULT_FAILED;
+    }
+
+    if (color_image_data != 0 &&
+        (color_image_descriptor == 0 || color_image_descriptor->format != K4A_IMAGE_FORMAT_COLOR_BGRA32 ||
+         color_image_descriptor->width_pixels != depth_image_descriptor->width_pixels ||
+         color_image_descriptor->height_pixels != depth_image_descriptor->height_pixels ||
+         color_image_descriptor->stride_bytes != depth_image_descriptor->width_pixels * 4))
+    {
+        LOG_ERROR("Expect a BGRA32 color image with the resolution of the depth image.", 0);
+        return K4A_BUFFER_RESULT_FAILED;
+    }
+
+    transformation_voxel_context_t voxels;
+    memset(&voxels, 0, sizeof(voxels));
+    if (!(grid->voxel_size > 0.0f))
+    {
+        LOG_ERROR("Unexpected voxel size %f.", (double)grid->voxel_size);
+        return K4A_BUFFER_RESULT_FAILED;
+    }
+    for (int axis = 0; axis < 3; axis++)
+    {
+        voxels.min_bounds[axis] = grid->min_bounds.v[axis];
+        voxels.max_bounds[axis] = grid->max_bounds.v[axis];
+        double cells = ceil(((double)voxels.max_bounds[axis] - (double)voxels.min_bounds[axis]) /
+                            (double)grid->voxel_size);
+        if (!(cells >= 1.0 && cells <= (double)VOXEL_MAX_CELLS_PER_AXIS))
+        {
+            LOG_ERROR("Voxel grid bounds [%f, %f) on axis %d must hold between 1 and %d voxels.",
+                      (double)voxels.min_bounds[axis],
+                      (double)voxels.max_bounds[axis],
+                      axis,
+                      VOXEL_MAX_CELLS_PER_AXIS);
+            return K4A_BUFFER_RESULT_FAILED;
+        }
+        voxels.cells[axis] = (uint64_t)cells;
+    }
+
+    size_t max_point_count = transformation_voxel_cloud_max_point_count(depth_image_descriptor, grid);
+    if (points == 0 || *point_count < max_point_count)
+    {
+        *point_count = max_point_count;
+        return K4A_BUFFER_RESULT_TOO_SMALL;
+    }
+
+    voxels.xy_tables = xy_tables;
+    voxels.depth_image = (const uint16_t *)(const void *)depth_image_data;
+    voxels.color_image = color_image_data;
+    voxels.width = depth_image_descriptor->width_pixels;
+    voxels.inverse_voxel_size = 1.0f / grid->voxel_size;
+    voxels.round_half_even = backend == K4A_TRANSFORMATION_BACKEND_CPU_SIMD &&
+                             transformation_point_cloud_simd_supported();
+
+    k4a_buffer_result_t result = K4A_BUFFER_RESULT_SUCCEEDED;
+    if (K4A_FAILED(TRACE_CALL(transformation_parallel_for((uint32_t)depth_image_descriptor->height_pixels,
+                                                          transformation_voxel_rows,
+                                                          &voxels))))
+    {
+        result = K4A_BUFFER_RESULT_FAILED;
+    }
+
+    // Workers cover the rows in order, so merging their tables in order keeps the voxels in the order a single thread
+    // would first see them
+    transformation_voxel_table_t *merged = &voxels.tables[0];
+    for (uint32_t i = 1; i < TRANSFORMATION_MAX_WORKERS && result == K4A_BUFFER_RESULT_SUCCEEDED; i++)
+    {
+        const transformation_voxel_table_t *table = &voxels.tables[i];
+        for (uint32_t v = 0; v < table->voxel_count; v++)
+        {
+            const transformation_voxel_t *source = &table->voxels[v];
+            transformation_voxel_t *voxel = transformation_voxel_table_find(merged, source->key);
+            if (voxel == NULL)
+            {
+                break;
+            }
+            for (int c = 0; c < 3; c++)
+            {
+                voxel->position_sum[c] += source->position_sum[c];
+            }
+            for (int c = 0; c < 4; c++)
+            {
+                voxel->color_sum[c] += source->color_sum[c];
+            }
+            voxel->count += source->count;
+        }
+    }
+
+    for (uint32_t i = 0; i < TRANSFORMATION_MAX_WORKERS; i++)
+    {
+        if (voxels.tables[i].failed)
+        {
+            LOG_ERROR("Failed to allocate the voxel table.", 0);
+            result = K4A_BUFFER_RESULT_FAILED;
+        }
+    }
+
+    if (result == K4A_BUFFER_RESULT_SUCCEEDED)
+    {
+        for (uint32_t v = 0; v < merged->voxel_count; v++)
+        {
+            const transformation_voxel_t *voxel = &merged->voxels[v];
+            k4a_voxel_point_t *point = &points[v];
+            for (int c = 0; c < 3; c++)
+            {
+                point->position.v[c] = (float)((double)voxel->position_sum[c] / (double)voxel->count);
+            }
+            for (int c = 0; c < 4; c++)
+            {
+                point->bgra[c] = (uint8_t)((voxel->color_sum[c] + voxel->count / 2) / voxel->count);
+            }
+            point->point_count = voxel->count;
+        }
+        *point_count = merged->voxel_count;
+    }
+
+    for (uint32_t i = 0; i < TRANSFORMATION_MAX_WORKERS; i++)
+    {
+        transformation_voxel_table_destroy(&voxels.tables[i]);
+    }
+    return result;
+}
@@ -16,6 +16,7 @@
 
 // Dependent libraries
 #include <k4ainternal/allocator.h>
+#include <azure_c_shared_utility/condition.h>
 #include <azure_c_shared_utility/lock.h>
 #include <azure_c_shared_utility/threadapi.h>
 
@@ -49,6 +50,8 @@ extern "C" {
 #define K4A_RGB_PID 0x097D
 #define K4A_DEPTH_PID 0x097C
 #define USB_CMD_DEFAULT_CONFIG 1
+#define USB_CMD_DEFAULT_EVENT_THREADS 1 // Threads handling libusb events, shared by all devices
+#define USB_CMD_MAX_EVENT_THREADS 8
 
 #define USB_CMD_DEPTH_INTERFACE 0
 #define USB_CMD_DEPTH_IN_ENDPOINT 0x02
@@ -95,7 +98,11 @@ typedef struct _usbcmd_context_t
     usb_async_transfer_data_t *transfer_list[USB_CMD_MAX_XFR_COUNT];
     size_t stream_size;
     LOCK_HANDLE lock;
-    THREAD_HANDLE stream_handle;
+
+    // Protects transfer_list and transfers_outstanding against the libusb event threads
+    LOCK_HANDLE transfer_lock;
+    COND_HANDLE transfer_condition;
+    uint32_t transfers_outstanding;
 } usbcmd_context_t;
 
 K4A_DECLARE_CONTEXT(usbcmd_t, usbcmd_context_t);
@@ -105,6 +112,14 @@ K4A_DECLARE_CONTEXT(usbcmd_t, usbcmd_context_t);
 //******************* Function Prototypes ***********************
 void LIBUSB_CALL usb_cmd_libusb_cb(struct libusb_transfer *bulk_transfer);
 
+// Shared libusb context, see usbmanager.c
+k4a_result_t usb_manager_acquire(libusb_context **context);
+void usb_manager_release(void);
+k4a_result_t usb_manager_get_device_list(bool refresh, libusb_device ***dev_list, ssize_t *count, bool *refreshed);
+void usb_manager_free_device_list(libusb_device **dev_list, ssize_t count);
+k4a_result_t usb_manager_set_log_level(enum libusb_log_level level);
+void usb_manager_transfer_completed(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -110,7 +110,6 @@ static void uuid_to_string(const guid_t *guid, char *string, size_t string_size)
 static k4a_result_t usb_cmd_set_libusb_debug_verbosity(usbcmd_context_t *usbcmd)
 {
     k4a_result_t result = K4A_RESULT_SUCCEEDED;
-    libusb_context *libusb_ctx = usbcmd ? usbcmd->libusb_context : NULL;
 
     // #if (LIBUSB_API_VERSION >= 0x01000106)
     enum libusb_log_level level = LIBUSB_LOG_LEVEL_WARNING;
@@ -118,7 +117,8 @@ static k4a_result_t usb_cmd_set_libusb_debug_verbosity(usbcmd_context_t *usbcmd)
     {
         usbcmd->libusb_verbosity = level;
     }
-    result = K4A_RESULT_FROM_LIBUSB(libusb_set_option(libusb_ctx, LIBUSB_OPTION_LOG_LEVEL, level));
+    // The context is shared by all devices, so the manager keeps track of its level
+    result = TRACE_CALL(usb_manager_set_log_level(level));
     // #else
     //     libusb_set_debug(libusb_ctx, 3); // set verbosity level to 3, as suggested in the documentation
     // #endif
@@ -227,112 +227,135 @@ static k4a_result_t populate_serialnumber(usbcmd_context_t *usbcmd, struct libus
     return result;
 }
 
-static k4a_result_t find_libusb_device(uint32_t device_index,
+// Opens the device matching device_index or container_id from an enumeration snapshot
+static bool find_libusb_device_in_list(libusb_device **dev_list,
+                                       ssize_t count,
+                                       uint32_t device_index,
                                        const guid_t *container_id,
                                        struct libusb_device_descriptor *desc,
-                                       usbcmd_context_t *usbcmd)
+                                       usbcmd_context_t *usbcmd,
+                                       int *open_attempts,
+                                       int *access_denied)
 {
     k4a_result_t result = K4A_RESULT_FAILED;
-    libusb_device **dev_list = NULL; // pointer to pointer of device, used to retrieve a list of devices
-    ssize_t count = 0;               // holding number of devices in list
     bool found = false;
-    int open_attempts = 0;
-    int access_denied = 0;
-
-    // Initialize library
-    result = K4A_RESULT_FROM_LIBUSB(libusb_init(&usbcmd->libusb_context));
 
-    if (K4A_SUCCEEDED(result))
+    // Traverse list looking for sensor matches
+    uint8_t list_index = 0;
+    for (int loop = 0; loop < count && found == false; loop++)
     {
-        result = usb_cmd_set_libusb_debug_verbosity(usbcmd);
-    }
+        found = false;
+        result = K4A_RESULT_FROM_LIBUSB(libusb_get_device_descriptor(dev_list[loop], desc));
 
-    if (K4A_SUCCEEDED(result))
-    {
-        // Get list of devices attached - LIBUSB (on Windows) will generate ERROR messages when this is called
-        // immediately after a device has been detached from the USB port. So we disable debug output temperarilty.
-        libusb_logging_disable(usbcmd->libusb_context);
-        result = K4A_RESULT_FROM_BOOL((count = libusb_get_device_list(usbcmd->libusb_context, &dev_list)) < INT32_MAX);
-        libusb_logging_restore(usbcmd->libusb_context, usbcmd->libusb_verbosity);
-    }
-
-    if (K4A_SUCCEEDED(result))
-    {
-        result = K4A_RESULT_FROM_BOOL(count != 0);
-    }
-
-    if (K4A_SUCCEEDED(result))
-    {
-        // Traverse list looking for sensor matches
-        uint8_t list_index = 0;
-        for (int loop = 0; loop < count && found == false; loop++)
+        if (K4A_SUCCEEDED(result))
         {
-            found = false;
-            result = K4A_RESULT_FROM_LIBUSB(libusb_get_device_descriptor(dev_list[loop], desc));
-
-            if (K4A_SUCCEEDED(result))
+            // Check if this is our device and correlates to the index number based on discovery order
+            if ((desc->idVendor != K4A_MSFT_VID) || (desc->idProduct != usbcmd->pid) ||
+                ((device_index != list_index++) && container_id == NULL))
             {
-                // Check if this is our device and correlates to the index number based on discovery order
-                if ((desc->idVendor != K4A_MSFT_VID) || (desc->idProduct != usbcmd->pid) ||
-                    ((device_index != list_index++) && container_id == NULL))
-                {
-                    continue;
-                }
+                continue;
             }
+        }
 
-            usbcmd->libusb = NULL;
-            if (K4A_SUCCEEDED(result))
+        usbcmd->libusb = NULL;
+        if (K4A_SUCCEEDED(result))
+        {
+            (*open_attempts)++;
+            int result_libusb;
             {
-                open_attempts++;
-                int result_libusb;
-                {
-                    // LIBUSB (on Windows) will generate ERROR messages when open is called and the device has already
-                    // been opened, which we need to do to get the serial number.
-                    libusb_logging_disable(usbcmd->libusb_context);
-                    result_libusb = libusb_open(dev_list[loop], &usbcmd->libusb);
-                    libusb_logging_restore(usbcmd->libusb_context, usbcmd->libusb_verbosity);
-                }
-                if (LIBUSB_ERROR_ACCESS == result_libusb)
-                {
-                    access_denied++;
-                }
-                if (result_libusb < LIBUSB_SUCCESS)
-                {
-                    continue; // Device is already open
-                }
+                // LIBUSB (on Windows) will generate ERROR messages when open is called and the device has already
+                // been opened, which we need to do to get the serial number.
+                libusb_logging_disable(usbcmd->libusb_context);
+                result_libusb = libusb_open(dev_list[loop], &usbcmd->libusb);
+                libusb_logging_restore(usbcmd->libusb_context, usbcmd->libusb_verbosity);
             }
-
-            if (K4A_SUCCEEDED(result))
+            if (LIBUSB_ERROR_ACCESS == result_libusb)
             {
-                result = populate_container_id(usbcmd);
+                (*access_denied)++;
             }
-
-            if (K4A_SUCCEEDED(result))
+            if (result_libusb < LIBUSB_SUCCESS)
             {
-                if (container_id == NULL)
-                {
-                    // We opened the USB handle based on index
-                    found = true;
-                }
-                else if (memcmp(container_id, &usbcmd->container_id, sizeof(*container_id)) == 0)
-                {
-                    // We have a container ID match
-                    found = true;
-                }
-                else
-                {
-                    char container_id_string[UUID_STR_LENGTH];
-                    uuid_to_string(&usbcmd->container_id, container_id_string, sizeof(container_id_string));
-                    LOG_INFO("Found non matching Container ID: %s ", container_id_string);
-                }
+                continue; // Device is already open
             }
+        }
 
-            if (!found)
+        if (K4A_SUCCEEDED(result))
+        {
+            result = populate_container_id(usbcmd);
+        }
+
+        if (K4A_SUCCEEDED(result))
+        {
+            if (container_id == NULL)
+            {
+                // We opened the USB handle based on index
+                found = true;
+            }
+            else if (memcmp(container_id, &usbcmd->container_id, sizeof(*container_id)) == 0)
             {
-                libusb_close(usbcmd->libusb);
-                usbcmd->libusb = NULL;
+                // We have a container ID match
+                found = true;
+            }
+            else
+            {
+                char container_id_string[UUID_STR_LENGTH];
+                uuid_to_string(&usbcmd->container_id, container_id_string, sizeof(container_id_string));
+                LOG_INFO("Found non matching Container ID: %s ", container_id_string);
             }
         }
+
+        if (!found)
+        {
+            libusb_close(usbcmd->libusb);
+            usbcmd->libusb = NULL;
+        }
+    }
+
+    return found;
+}
+
+static k4a_result_t find_libusb_device(uint32_t device_index,
+                                       const guid_t *container_id,
+                                       struct libusb_device_descriptor *desc,
+                                       usbcmd_context_t *usbcmd)
+{
+    k4a_result_t result = K4A_RESULT_FAILED;
+    bool found = false;
+    int open_attempts = 0;
+    int access_denied = 0;
+
+    // Take a reference on the libusb context shared by all devices
+    result = usb_manager_acquire(&usbcmd->libusb_context);
+
+    if (K4A_SUCCEEDED(result))
+    {
+        result = usb_cmd_set_libusb_debug_verbosity(usbcmd);
+    }
+
+    // Use the enumeration shared with other opens first. If the device is not in it, or it is stale because the device
+    // was reattached, enumerate again.
+    bool refresh = false;
+    bool refreshed = false;
+    while (K4A_SUCCEEDED(result) && !found)
+    {
+        libusb_device **dev_list = NULL;
+        ssize_t count = 0;
+
+        result = usb_manager_get_device_list(refresh, &dev_list, &count, &refreshed);
+        if (K4A_SUCCEEDED(result))
+        {
+            found = find_libusb_device_in_list(
+                dev_list, count, device_index, container_id, desc, usbcmd, &open_attempts, &access_denied);
+
+            // free the list, unref the devices in it
+            usb_manager_free_device_list(dev_list, count);
+        }
+
+        if (refreshed)
+        {
+            break;
+        }
+        refresh = true;
     }
 
     result = K4A_RESULT_FAILED;
@@ -372,9 +395,6 @@ static k4a_result_t find_libusb_device(uint32_t device_index,
         }
     }
 
-    // free the list, unref the devices in it
-    libusb_free_device_list(dev_list, (int)count);
-
     return result;
 }
 
@@ -385,9 +405,7 @@ k4a_result_t usb_cmd_create(usb_command_device_type_t device_type,
 {
     RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, device_type >= USB_DEVICE_TYPE_COUNT);
     k4a_result_t result = K4A_RESULT_FAILED;
-    libusb_device **dev_list = NULL; // pointer to pointer of device, used to retrieve a list of devices
     struct libusb_device_descriptor desc;
-    ssize_t count = 0; // holding number of devices in list
     int32_t activeConfig = 0;
     usbcmd_context_t *usbcmd;
 
@@ -399,6 +417,16 @@ k4a_result_t usb_cmd_create(usb_command_device_type_t device_type,
         result = K4A_RESULT_FROM_BOOL((usbcmd->lock = Lock_Init()) != NULL);
     }
 
+    if (K4A_SUCCEEDED(result))
+    {
+        result = K4A_RESULT_FROM_BOOL((usbcmd->transfer_lock = Lock_Init()) != NULL);
+    }
+
+    if (K4A_SUCCEEDED(result))
+    {
+        result = K4A_RESULT_FROM_BOOL((usbcmd->transfer_condition = Condition_Init()) != NULL);
+    }
+
     if (K4A_SUCCEEDED(result))
     {
         if (device_type == USB_DEVICE_DEPTH_PROCESSOR)
@@ -460,9 +488,6 @@ k4a_result_t usb_cmd_create(usb_command_device_type_t device_type,
         *usbcmd_handle = NULL;
     }
 
-    // free the list, unref the devices in it
-    libusb_free_device_list(dev_list, (int)count);
-
     return result;
 }
 
@@ -504,11 +529,23 @@ void usb_cmd_destroy(usbcmd_t usbcmd_handle)
 
     if (usbcmd->libusb_context)
     {
-        // close the instance
-        libusb_exit(usbcmd->libusb_context);
+        // release the shared instance
+        usb_manager_release();
         usbcmd->libusb_context = 0;
     }
 
+    if (usbcmd->transfer_condition)
+    {
+        Condition_Deinit(usbcmd->transfer_condition);
+        usbcmd->transfer_condition = 0;
+    }
+
+    if (usbcmd->transfer_lock)
+    {
+        Lock_Deinit(usbcmd->transfer_lock);
+        usbcmd->transfer_lock = 0;
+    }
+
     if (usbcmd->lock)
     {
         // release lock resources
@@ -1004,7 +1041,6 @@ k4a_result_t usb_cmd_get_device_count(uint32_t *p_device_count)
     libusb_context *libusb_ctx;
     libusb_device **dev_list; // pointer to pointer of device, used to retrieve a list of devices
     ssize_t count;            // holding number of devices in list
-    int err;
     uint32_t color_device_count = 0;
     uint32_t depth_device_count = 0;
 
@@ -1015,26 +1051,22 @@ k4a_result_t usb_cmd_get_device_count(uint32_t *p_device_count)
     }
 
     *p_device_count = 0;
-    // initialize library
-    if ((err = libusb_init(&libusb_ctx)) < 0)
+    // take a reference on the shared library instance
+    if (K4A_FAILED(usb_manager_acquire(&libusb_ctx)))
     {
-        LOG_ERROR("Error calling libusb_init, result:%s", libusb_error_name(err));
         return K4A_RESULT_FAILED;
     }
 
-    // We disable all LIBUSB logging for this function, which only used this local context. LIBUSB (on Windows)
-    // generates errors when a device is detached moments before this is called.
-    libusb_logging_disable(libusb_ctx);
-
-    count = libusb_get_device_list(libusb_ctx, &dev_list); // get the list of devices
-    if (count > INT32_MAX)
+    // Enumerate again; devices opened after this use the same list
+    if (K4A_FAILED(usb_manager_get_device_list(true, &dev_list, &count, NULL)))
     {
-        LOG_ERROR("List too large", 0);
+        usb_manager_release();
         return K4A_RESULT_FAILED;
     }
     if (count <= 0)
     {
         LOG_ERROR("No devices found", 0);
+        usb_manager_release();
         return K4A_RESULT_FAILED;
     }
 
@@ -1061,10 +1093,10 @@ k4a_result_t usb_cmd_get_device_count(uint32_t *p_device_count)
         }
     }
     // free the list, unref the devices in it
-    libusb_free_device_list(dev_list, (int)count);
+    usb_manager_free_device_list(dev_list, count);
 
-    // close the instance
-    libusb_exit(libusb_ctx);
+    // release the shared instance
+    usb_manager_release();
 
     // Color or Depth end point my be in a bad state so we cound both and return the larger count
     *p_device_count = color_device_count > depth_device_count ? color_device_count : depth_device_count;
@@ -1072,6 +1104,45 @@ k4a_result_t usb_cmd_get_device_count(uint32_t *p_device_count)
     return result;
 }
 
+/**
+ *  Function to enumerate the bus once and keep the result for the usb_cmd_create() calls that follow, until
+ *  usb_cmd_enumeration_release() is called.
+ *
+ *  @return
+ *   K4A_RESULT_SUCCEEDED   Operation successful
+ *   K4A_RESULT_FAILED      Operation failed
+ *
+ */
+k4a_result_t usb_cmd_enumeration_acquire(void)
+{
+    libusb_context *libusb_ctx = NULL;
+    libusb_device **dev_list = NULL;
+    ssize_t count = 0;
+
+    // The reference keeps the shared instance, and with it the enumeration, alive
+    k4a_result_t result = usb_manager_acquire(&libusb_ctx);
+
+    if (K4A_SUCCEEDED(result))
+    {
+        result = usb_manager_get_device_list(true, &dev_list, &count, NULL);
+        if (K4A_SUCCEEDED(result))
+        {
+            usb_manager_free_device_list(dev_list, count);
+        }
+        else
+        {
+            usb_manager_release();
+        }
+    }
+
+    return result;
+}
+
+void usb_cmd_enumeration_release(void)
+{
+    usb_manager_release();
+}
+
 // Waiting on hot-plugging support
 #if 0
 /**
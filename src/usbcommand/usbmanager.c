@@ -0,0 +1,417 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+//************************ Includes *****************************
+// This library
+#include <k4ainternal/usbcommand.h>
+#include "usb_cmd_priv.h"
+
+// Dependent libraries
+#include <k4ainternal/global.h>
+#include <k4ainternal/rwlock.h>
+#include <azure_c_shared_utility/envvariable.h>
+
+// System dependencies
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+//**************Symbolic Constant Macros (defines)  *************
+#define USB_MANAGER_EVENT_TIMEOUT 1 // seconds
+
+#ifdef _MSC_VER
+#define USB_MANAGER_THREAD_LOCAL __declspec(thread)
+#else
+#define USB_MANAGER_THREAD_LOCAL __thread
+#endif
+
+//************************ Typedefs *****************************
+typedef struct _usb_manager_event_thread_t
+{
+    THREAD_HANDLE handle;
+
+    // Only written by the event thread itself
+    usb_cmd_event_thread_stats_t stats;
+} usb_manager_event_thread_t;
+
+// Process wide libusb state shared by all usbcmd handles. Everything is protected by lock.
+typedef struct _usb_manager_global_t
+{
+    k4a_rwlock_t lock;
+
+    uint32_t ref_count;
+    libusb_context *context;
+
+    // Enumeration snapshot shared by device opens, refreshed by usb_cmd_get_device_count()
+    libusb_device **dev_list;
+    ssize_t dev_count;
+
+    // Level last set with usb_manager_set_log_level(), restored after libusb is silenced
+    enum libusb_log_level log_level;
+
+    uint32_t requested_thread_count;
+    uint32_t thread_count;
+    volatile bool stop;
+    usb_manager_event_thread_t threads[USB_CMD_MAX_EVENT_THREADS];
+} usb_manager_global_t;
+
+//************ Declarations (Statics and globals) ***************
+static void usb_manager_global_init(usb_manager_global_t *g_usb_manager)
+{
+    rwlock_init(&g_usb_manager->lock);
+    g_usb_manager->requested_thread_count = USB_CMD_DEFAULT_EVENT_THREADS;
+}
+
+K4A_DECLARE_GLOBAL(usb_manager_global_t, usb_manager_global_init);
+
+// The event thread running on this thread, if any
+static USB_MANAGER_THREAD_LOCAL usb_manager_event_thread_t *g_current_event_thread = NULL;
+
+//*********************** Functions *****************************
+/**
+ *  Thread handling libusb events for all transfers on the shared context
+ *
+ *  @param param
+ *   The usb_manager_event_thread_t the thread reports its counters to.
+ *
+ */
+static int usb_manager_event_thread(void *param)
+{
+    usb_manager_event_thread_t *event_thread = (usb_manager_event_thread_t *)param;
+    usb_manager_global_t *g_usb_manager = usb_manager_global_t_get();
+    libusb_context *context = g_usb_manager->context;
+    struct timeval tv = { 0 };
+    tv.tv_sec = USB_MANAGER_EVENT_TIMEOUT;
+    bool error_logged = false;
+
+    g_current_event_thread = event_thread;
+
+    while (!g_usb_manager->stop)
+    {
+        uint64_t transfers_completed = event_thread->stats.transfers_completed;
+        int err = libusb_handle_events_timeout_completed(context, &tv, NULL);
+        if (err < 0 && err != LIBUSB_ERROR_INTERRUPTED && !error_logged)
+        {
+            // Keep servicing; transfers of other devices may still complete
+            LOG_ERROR("Error calling libusb_handle_events_timeout failed, result:%s", libusb_error_name(err));
+            error_logged = true;
+        }
+
+        // Returns after an idle timeout are not counted
+        if (event_thread->stats.transfers_completed != transfers_completed)
+        {
+            event_thread->stats.events_handled++;
+        }
+    }
+
+    g_current_event_thread = NULL;
+    ThreadAPI_Exit(0);
+    return 0;
+}
+
+// Stops the event threads and closes the shared context. Called with the write lock held.
+static void usb_manager_shutdown(usb_manager_global_t *g_usb_manager)
+{
+    g_usb_manager->stop = true;
+#if (LIBUSB_API_VERSION >= 0x01000105)
+    libusb_interrupt_event_handler(g_usb_manager->context);
+#endif
+
+    // Event threads never take the lock, so they can be joined while it is held. Without
+    // libusb_interrupt_event_handler() this waits for up to USB_MANAGER_EVENT_TIMEOUT.
+    for (uint32_t i = 0; i < g_usb_manager->thread_count; i++)
+    {
+        ThreadAPI_Join(g_usb_manager->threads[i].handle, NULL);
+        g_usb_manager->threads[i].handle = NULL;
+    }
+    g_usb_manager->thread_count = 0;
+
+    if (g_usb_manager->dev_list)
+    {
+        libusb_free_device_list(g_usb_manager->dev_list, 1);
+        g_usb_manager->dev_list = NULL;
+        g_usb_manager->dev_count = 0;
+    }
+
+    libusb_exit(g_usb_manager->context);
+    g_usb_manager->context = NULL;
+}
+
+/**
+ *  Takes a reference on the shared libusb context, creating it and its event threads for the first reference.
+ *
+ *  @param context
+ *   Receives the shared context. It stays valid until the matching usb_manager_release().
+ *
+ *  @return
+ *   K4A_RESULT_SUCCEEDED   Operation successful
+ *   K4A_RESULT_FAILED      Operation failed
+ *
+ */
+k4a_result_t usb_manager_acquire(libusb_context **context)
+{
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, context == NULL);
+
+    usb_manager_global_t *g_usb_manager = usb_manager_global_t_get();
+    k4a_result_t result = K4A_RESULT_SUCCEEDED;
+
+    rwlock_acquire_write(&g_usb_manager->lock);
+    if (g_usb_manager->ref_count == 0)
+    {
+        int err = libusb_init(&g_usb_manager->context);
+        if (err < 0)
+        {
+            LOG_ERROR("Error calling libusb_init, result:%s", libusb_error_name(err));
+            g_usb_manager->context = NULL;
+            result = K4A_RESULT_FAILED;
+        }
+        g_usb_manager->log_level = LIBUSB_LOG_LEVEL_NONE;
+
+        uint32_t thread_count = g_usb_manager->requested_thread_count;
+        const char *env_thread_count = environment_get_variable("K4A_LIBUSB_EVENT_THREADS");
+        if (env_thread_count != NULL && env_thread_count[0] != '\0')
+        {
+            long value = strtol(env_thread_count, NULL, 10);
+            if (value >= 1 && value <= USB_CMD_MAX_EVENT_THREADS)
+            {
+                thread_count = (uint32_t)value;
+            }
+        }
+
+        if (K4A_SUCCEEDED(result))
+        {
+            g_usb_manager->stop = false;
+            for (uint32_t i = 0; i < thread_count && K4A_SUCCEEDED(result); i++)
+            {
+                usb_manager_event_thread_t *event_thread = &g_usb_manager->threads[i];
+                memset(&event_thread->stats, 0, sizeof(event_thread->stats));
+                if (ThreadAPI_Create(&event_thread->handle, usb_manager_event_thread, event_thread) != THREADAPI_OK)
+                {
+                    LOG_ERROR("Could not start libusb event thread", 0);
+                    event_thread->handle = NULL;
+                    result = K4A_RESULT_FAILED;
+                }
+                else
+                {
+                    g_usb_manager->thread_count++;
+                }
+            }
+
+            if (K4A_FAILED(result))
+            {
+                usb_manager_shutdown(g_usb_manager);
+            }
+        }
+    }
+
+    if (K4A_SUCCEEDED(result))
+    {
+        g_usb_manager->ref_count++;
+        *context = g_usb_manager->context;
+    }
+    rwlock_release_write(&g_usb_manager->lock);
+
+    return result;
+}
+
+/**
+ *  Releases a reference taken with usb_manager_acquire(). The last reference stops the event threads and closes
+ *  the shared context; all transfers and device handles must be closed by then.
+ *
+ */
+void usb_manager_release(void)
+{
+    usb_manager_global_t *g_usb_manager = usb_manager_global_t_get();
+
+    rwlock_acquire_write(&g_usb_manager->lock);
+    assert(g_usb_manager->ref_count > 0);
+    if (--g_usb_manager->ref_count == 0)
+    {
+        usb_manager_shutdown(g_usb_manager);
+    }
+    rwlock_release_write(&g_usb_manager->lock);
+}
+
+/**
+ *  Gets a copy of the shared enumeration snapshot. The caller must hold a reference from usb_manager_acquire().
+ *
+ *  @param refresh
+ *   Enumerate the bus again instead of using the existing snapshot.
+ *
+ *  @param dev_list
+ *   Receives a list holding a reference on each device; free it with usb_manager_free_device_list().
+ *
+ *  @param count
+ *   Receives the number of devices in the list.
+ *
+ *  @param refreshed
+ *   Optional, set to true if the list was enumerated by this call.
+ *
+ *  @return
+ *   K4A_RESULT_SUCCEEDED   Operation successful
+ *   K4A_RESULT_FAILED      Operation failed
+ *
+ */
+k4a_result_t usb_manager_get_device_list(bool refresh, libusb_device ***dev_list, ssize_t *count, bool *refreshed)
+{
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, dev_list == NULL);
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, count == NULL);
+
+    usb_manager_global_t *g_usb_manager = usb_manager_global_t_get();
+    k4a_result_t result = K4A_RESULT_SUCCEEDED;
+    bool enumerated = false;
+
+    *dev_list = NULL;
+    *count = 0;
+
+    rwlock_acquire_write(&g_usb_manager->lock);
+    result = K4A_RESULT_FROM_BOOL(g_usb_manager->ref_count > 0);
+
+    if (K4A_SUCCEEDED(result) && (refresh || g_usb_manager->dev_list == NULL))
+    {
+        libusb_device **new_list = NULL;
+
+        // LIBUSB (on Windows) will generate ERROR messages when this is called immediately after a device has been
+        // detached from the USB port. So we disable debug output temporarily.
+        libusb_set_option(g_usb_manager->context, LIBUSB_OPTION_LOG_LEVEL, LIBUSB_LOG_LEVEL_NONE);
+        ssize_t new_count = libusb_get_device_list(g_usb_manager->context, &new_list);
+        libusb_set_option(g_usb_manager->context, LIBUSB_OPTION_LOG_LEVEL, g_usb_manager->log_level);
+
+        if (new_count < 0 || new_count > INT32_MAX)
+        {
+            LOG_ERROR("Error calling libusb_get_device_list, result:%s", libusb_error_name((int)new_count));
+            result = K4A_RESULT_FAILED;
+        }
+        else
+        {
+            if (g_usb_manager->dev_list)
+            {
+                libusb_free_device_list(g_usb_manager->dev_list, 1);
+            }
+            g_usb_manager->dev_list = new_list;
+            g_usb_manager->dev_count = new_count;
+            enumerated = true;
+        }
+    }
+
+    if (K4A_SUCCEEDED(result) && g_usb_manager->dev_count > 0)
+    {
+        *dev_list = (libusb_device **)malloc((size_t)g_usb_manager->dev_count * sizeof(libusb_device *));
+        result = K4A_RESULT_FROM_BOOL(*dev_list != NULL);
+    }
+
+    if (K4A_SUCCEEDED(result))
+    {
+        for (ssize_t i = 0; i < g_usb_manager->dev_count; i++)
+        {
+            (*dev_list)[i] = libusb_ref_device(g_usb_manager->dev_list[i]);
+        }
+        *count = g_usb_manager->dev_count;
+    }
+    rwlock_release_write(&g_usb_manager->lock);
+
+    if (refreshed)
+    {
+        *refreshed = enumerated;
+    }
+
+    return result;
+}
+
+/**
+ *  Sets the log level of the shared context. The caller must hold a reference from usb_manager_acquire().
+ *
+ *  @param level
+ *   The libusb log level, restored by the manager when it silences libusb temporarily.
+ *
+ *  @return
+ *   K4A_RESULT_SUCCEEDED   Operation successful
+ *   K4A_RESULT_FAILED      Operation failed
+ *
+ */
+k4a_result_t usb_manager_set_log_level(enum libusb_log_level level)
+{
+    usb_manager_global_t *g_usb_manager = usb_manager_global_t_get();
+    k4a_result_t result;
+
+    rwlock_acquire_write(&g_usb_manager->lock);
+    result = K4A_RESULT_FROM_BOOL(g_usb_manager->ref_count > 0);
+    if (K4A_SUCCEEDED(result))
+    {
+        int err = libusb_set_option(g_usb_manager->context, LIBUSB_OPTION_LOG_LEVEL, level);
+        if (err < 0)
+        {
+            LOG_ERROR("Error calling libusb_set_option, result:%s", libusb_error_name(err));
+            result = K4A_RESULT_FAILED;
+        }
+        else
+        {
+            g_usb_manager->log_level = level;
+        }
+    }
+    rwlock_release_write(&g_usb_manager->lock);
+
+    return result;
+}
+
+void usb_manager_free_device_list(libusb_device **dev_list, ssize_t count)
+{
+    for (ssize_t i = 0; i < count; i++)
+    {
+        libusb_unref_device(dev_list[i]);
+    }
+    free(dev_list);
+}
+
+// Called from usb_cmd_libusb_cb() to count the transfers completed on each event thread. Transfers may also complete
+// on threads doing synchronous transfers; those are not counted.
+void usb_manager_transfer_completed(void)
+{
+    if (g_current_event_thread)
+    {
+        g_current_event_thread->stats.transfers_completed++;
+    }
+}
+
+k4a_result_t usb_cmd_set_event_thread_count(uint32_t thread_count)
+{
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, thread_count == 0 || thread_count > USB_CMD_MAX_EVENT_THREADS);
+
+    usb_manager_global_t *g_usb_manager = usb_manager_global_t_get();
+
+    rwlock_acquire_write(&g_usb_manager->lock);
+    g_usb_manager->requested_thread_count = thread_count;
+    rwlock_release_write(&g_usb_manager->lock);
+
+    return K4A_RESULT_SUCCEEDED;
+}
+
+uint32_t usb_cmd_get_event_thread_count(void)
+{
+    usb_manager_global_t *g_usb_manager = usb_manager_global_t_get();
+
+    rwlock_acquire_read(&g_usb_manager->lock);
+    uint32_t thread_count = g_usb_manager->thread_count;
+    rwlock_release_read(&g_usb_manager->lock);
+
+    return thread_count;
+}
+
+k4a_result_t usb_cmd_get_event_thread_stats(uint32_t thread_index, usb_cmd_event_thread_stats_t *stats)
+{
+    RETURN_VALUE_IF_ARG(K4A_RESULT_FAILED, stats == NULL);
+
+    usb_manager_global_t *g_usb_manager = usb_manager_global_t_get();
+    k4a_result_t result;
+
+    rwlock_acquire_read(&g_usb_manager->lock);
+    result = K4A_RESULT_FROM_BOOL(thread_index < g_usb_manager->thread_count);
+    if (K4A_SUCCEEDED(result))
+    {
+        // The counters are written without the lock by their event thread, so a read may be slightly stale
+        *stats = g_usb_manager->threads[thread_index].stats;
+    }
+    rwlock_release_read(&g_usb_manager->lock);
+
+    return result;
+}
@@ -14,7 +14,6 @@
 #include <azure_c_shared_utility/envvariable.h>
 
 //**************Symbolic Constant Macros (defines)  *************
-#define USB_CMD_LIBUSB_EVENT_TIMEOUT 1
 
 //************************ Typedefs *****************************
 
@@ -35,10 +34,15 @@ static void usb_cmd_release_xfr(struct libusb_transfer *bulk_transfer)
     usb_async_transfer_data_t *transfer = (usb_async_transfer_data_t *)(bulk_transfer->user_data);
     usbcmd_context_t *usbcmd = transfer->usbcmd;
 
+    Lock(usbcmd->transfer_lock);
     if (usbcmd->transfer_list[transfer->list_index] == transfer)
     {
         usbcmd->transfer_list[transfer->list_index] = NULL;
     }
+    usbcmd->transfers_outstanding--;
+    Condition_Post(usbcmd->transfer_condition);
+    Unlock(usbcmd->transfer_lock);
+
     if (transfer->image)
     {
         image_dec_ref(transfer->image);
@@ -63,6 +67,8 @@ void LIBUSB_CALL usb_cmd_libusb_cb(struct libusb_transfer *bulk_transfer)
     usbcmd_context_t *usbcmd = transfer->usbcmd;
     k4a_result_t result = K4A_RESULT_FAILED;
 
+    usb_manager_transfer_completed();
+
     result = image_apply_system_timestamp(transfer->image);
     if (K4A_SUCCEEDED(result))
     {
@@ -100,10 +106,23 @@ void LIBUSB_CALL usb_cmd_libusb_cb(struct libusb_transfer *bulk_transfer)
                                           usb_cmd_libusb_cb,
                                           transfer,
                                           USB_CMD_MAX_WAIT_TIME);
-                if ((err = libusb_submit_transfer(bulk_transfer)) != LIBUSB_SUCCESS)
+
+                // usb_cmd_stream_stop() cancels transfers under the same lock, so a transfer resubmitted here is
+                // either cancelled by it or not resubmitted at all
+                Lock(usbcmd->transfer_lock);
+                if (!usbcmd->stream_going)
+                {
+                    result = K4A_RESULT_FAILED;
+                }
+                else if ((err = libusb_submit_transfer(bulk_transfer)) != LIBUSB_SUCCESS)
                 {
                     result = K4A_RESULT_FAILED;
                     LOG_ERROR("Error calling libusb_submit_transfer for tx, result:%s", libusb_error_name(err));
+                }
+                Unlock(usbcmd->transfer_lock);
+
+                if (K4A_FAILED(result))
+                {
                     image_dec_ref(transfer->image);
                     transfer->image = NULL;
                 }
@@ -145,24 +164,49 @@ void LIBUSB_CALL usb_cmd_libusb_cb(struct libusb_transfer *bulk_transfer)
 }
 
 /**
- *  LibUsb context thread for monitoring events in the usb lib
+ *  Cancels the streaming transfers and waits for them to be released by the libusb event threads
  *
- *  @param var
- *   context variable.  In this case, this points to a command handle
- *   associated with the streaming.
+ *  @param usbcmd
+ *   Command handle associated with the streaming.
+ *
+ */
+static void usb_cmd_stream_cancel_transfers(usbcmd_context_t *usbcmd)
+{
+    Lock(usbcmd->transfer_lock);
+    usbcmd->stream_going = false;
+    for (uint32_t i = 0; i < USB_CMD_MAX_XFR_COUNT; i++)
+    {
+        if (usbcmd->transfer_list[i] != NULL)
+        {
+            // Cancel any outstanding transfer; its callback releases it
+            libusb_cancel_transfer(usbcmd->transfer_list[i]->bulk_transfer);
+        }
+    }
+
+    while (usbcmd->transfers_outstanding > 0)
+    {
+        int infinite_timeout = 0;
+        (void)Condition_Wait(usbcmd->transfer_condition, usbcmd->transfer_lock, infinite_timeout);
+    }
+    Unlock(usbcmd->transfer_lock);
+}
+
+/**
+ *  Allocates and submits the streaming transfers. Their completions are handled by the libusb event threads
+ *  shared by all devices.
+ *
+ *  @param usbcmd
+ *   Command handle associated with the streaming.
  *
  *  @return
  *   K4A_RESULT_SUCCEEDED   Operation successful
  *   K4A_RESULT_FAILED      Operation failed
  *
  */
-static int usb_cmd_lib_usb_thread(void *var)
+static k4a_result_t usb_cmd_stream_submit_transfers(usbcmd_context_t *usbcmd)
 {
     k4a_result_t result = K4A_RESULT_SUCCEEDED;
-    usbcmd_context_t *usbcmd = (usbcmd_context_t *)var;
-    libusb_context *p_ctx = usbcmd->libusb_context;
     int err = LIBUSB_SUCCESS;
-    struct timeval tv = { 0 };
     size_t xfer_pool = usbcmd->stream_size;
     size_t max_xfr_pool = USB_CMD_MAX_XFR_POOL;
 
@@ -173,121 +217,96 @@ static int usb_cmd_lib_usb_thread(void *var)
         max_xfr_pool = (size_t)strtol(env_max_pool, NULL, 10);
     }
 
-    tv.tv_sec = USB_CMD_LIBUSB_EVENT_TIMEOUT;
-
     if (usbcmd->stream_size > INT32_MAX)
     {
-        result = K4A_RESULT_FAILED;
+        return K4A_RESULT_FAILED;
     }
-    else
+
+    // set up the transfers.  Limit the overall amount of resources to a predefined amount
+    for (uint32_t i = 0; (i < USB_CMD_MAX_XFR_COUNT) && (xfer_pool < max_xfr_pool); i++)
     {
-        // set up the transfers.  Limit the overall amount of resources to a predefined amount
-        for (uint32_t i = 0; (i < USB_CMD_MAX_XFR_COUNT) && (xfer_pool < max_xfr_pool); i++)
+        usb_async_transfer_data_t *transfer;
+        transfer = calloc(sizeof(usb_async_transfer_data_t), sizeof(int));
+        result = K4A_RESULT_FROM_BOOL(transfer != NULL);
+
+        if (K4A_SUCCEEDED(result))
         {
-            usb_async_transfer_data_t *transfer;
-            transfer = calloc(sizeof(usb_async_transfer_data_t), sizeof(int));
-            result = K4A_RESULT_FROM_BOOL(transfer != NULL);
+            xfer_pool += usbcmd->stream_size;
+            transfer->usbcmd = usbcmd;
+            transfer->list_index = i;
+            transfer->bulk_transfer = libusb_alloc_transfer(0);
+            result = K4A_RESULT_FROM_BOOL(transfer->bulk_transfer != NULL);
+        }
 
-            if (K4A_SUCCEEDED(result))
-            {
-                xfer_pool += usbcmd->stream_size;
-                transfer->usbcmd = usbcmd;
-                transfer->list_index = i;
-                usbcmd->transfer_list[i] = transfer;
-                transfer->bulk_transfer = libusb_alloc_transfer(0);
-                result = K4A_RESULT_FROM_BOOL(transfer->bulk_transfer != NULL);
-            }
+        if (K4A_SUCCEEDED(result))
+        {
+            result = TRACE_CALL(image_create_empty_internal(usbcmd->source, usbcmd->stream_size, &transfer->image));
+        }
 
-            if (K4A_SUCCEEDED(result))
+        if (K4A_SUCCEEDED(result))
+        {
+            libusb_fill_bulk_transfer(transfer->bulk_transfer,
+                                      usbcmd->libusb,
+                                      usbcmd->stream_endpoint,
+                                      image_get_buffer(transfer->image),
+                                      (int)usbcmd->stream_size,
+                                      usb_cmd_libusb_cb,
+                                      transfer,
+                                      USB_CMD_MAX_WAIT_TIME);
+
+            // The transfer may complete on an event thread as soon as it is submitted
+            Lock(usbcmd->transfer_lock);
+            if ((err = libusb_submit_transfer(transfer->bulk_transfer)) == LIBUSB_SUCCESS)
             {
-                result = TRACE_CALL(image_create_empty_internal(usbcmd->source, usbcmd->stream_size, &transfer->image));
+                usbcmd->transfer_list[i] = transfer;
+                usbcmd->transfers_outstanding++;
             }
+            Unlock(usbcmd->transfer_lock);
 
-            if (K4A_SUCCEEDED(result))
+            if (err != LIBUSB_SUCCESS)
             {
-
-                libusb_fill_bulk_transfer(transfer->bulk_transfer,
-                                          usbcmd->libusb,
-                                          usbcmd->stream_endpoint,
-                                          image_get_buffer(transfer->image),
-                                          (int)usbcmd->stream_size,
-                                          usb_cmd_libusb_cb,
-                                          transfer,
-                                          USB_CMD_MAX_WAIT_TIME);
-
-                if ((err = libusb_submit_transfer(transfer->bulk_transfer)) != LIBUSB_SUCCESS)
+                if (i == 0)
                 {
-                    if (i == 0)
-                    {
-                        // Could not even submit one.  This is an error
-                        LOG_ERROR("No libusb transfers could not be submitted, error:%s", libusb_error_name(err));
-                        result = K4A_RESULT_FAILED;
-                    }
-                    else
-                    {
-                        // Could not allocate a transfer within the predefined amount.
-                        // This could indicate other resource are competing and the allocation
-                        // pool needs to be adjusted
-                        LOG_WARNING(
-                            "Less than optimal %d libusb transfers submitted. Please evaluate available resources",
-                            i + 1);
-                    }
+                    // Could not even submit one.  This is an error
+                    LOG_ERROR("No libusb transfers could not be submitted, error:%s", libusb_error_name(err));
                 }
-            }
-
-            if (K4A_FAILED(result))
-            {
-                if (transfer)
+                else
                 {
-                    if (transfer->image)
-                    {
-                        image_dec_ref(transfer->image);
-                    }
-                    if (transfer->bulk_transfer)
-                    {
-                        libusb_free_transfer(transfer->bulk_transfer);
-                    }
-                    free(transfer);
+                    // Could not allocate a transfer within the predefined amount.
+                    // This could indicate other resource are competing and the allocation
+                    // pool needs to be adjusted
+                    LOG_WARNING("Less than optimal %d libusb transfers submitted. Please evaluate available resources",
+                                i + 1);
                 }
-
-                usbcmd->transfer_list[i] = NULL;
-                break; // exit loop
+                result = K4A_RESULT_FAILED;
             }
         }
-    }
 
-    // loop servicing libusb
-    if (result == K4A_RESULT_SUCCEEDED)
-    {
-        while (usbcmd->stream_going)
+        if (K4A_FAILED(result))
         {
-            if ((err = libusb_handle_events_timeout_completed(p_ctx, &tv, NULL)) < 0)
+            if (transfer)
             {
-                usbcmd->stream_going = false; // Close stream if error is detected
-                LOG_ERROR("Error calling libusb_handle_events_timeout failed, result:%s", libusb_error_name(err));
-                result = K4A_RESULT_FAILED;
+                if (transfer->image)
+                {
+                    image_dec_ref(transfer->image);
+                }
+                if (transfer->bulk_transfer)
+                {
+                    libusb_free_transfer(transfer->bulk_transfer);
+                }
+                free(transfer);
             }
-        }
-    }
 
-    // cancel everything just in case of errors
-    for (uint32_t i = 0; i < USB_CMD_MAX_XFR_COUNT; i++)
-    {
-        if (usbcmd->transfer_list[i] != NULL)
-        {
-            // Cancel any outstanding transfer
-            libusb_cancel_transfer(usbcmd->transfer_list[i]->bulk_transfer);
-            // Service the library after  cancellation
-            if ((err = libusb_handle_events_timeout_completed(p_ctx, &tv, NULL)) < 0)
+            // Running with fewer transfers is not an error
+            if (i > 0)
             {
-                LOG_ERROR("Error calling libusb_handle_events_timeout failed, result:%s", libusb_error_name(err));
-                result = K4A_RESULT_FAILED;
+                result = K4A_RESULT_SUCCEEDED;
             }
+            break; // exit loop
         }
     }
 
-    ThreadAPI_Exit((int)result);
-    return 0;
+    return result;
 }
 
 /**
@@ -329,17 +348,21 @@ k4a_result_t usb_cmd_stream_start(usbcmd_t usbcmd_handle, size_t payload_size)
             LOG_INFO("Stream already in progress", 0);
         }
         else
+        {
+            // Fill any buffer pool set aside for this stream now that the transfer size is known, so that the
+            // transfer callback never has to allocate one
+            result = TRACE_CALL(allocator_pool_prepare(usbcmd->source, payload_size));
+        }
+
+        if (K4A_SUCCEEDED(result))
         {
             usbcmd->stream_size = payload_size;
             usbcmd->stream_going = true;
-            if (ThreadAPI_Create(&(usbcmd->stream_handle), usb_cmd_lib_usb_thread, usbcmd) != THREADAPI_OK)
-            {
-                usbcmd->stream_going = false;
-                LOG_ERROR("Could not start stream thread", 0);
-            }
-            else
+            result = TRACE_CALL(usb_cmd_stream_submit_transfers(usbcmd));
+            if (K4A_FAILED(result))
             {
-                result = K4A_RESULT_SUCCEEDED;
+                LOG_ERROR("Could not start stream", 0);
+                usb_cmd_stream_cancel_transfers(usbcmd);
             }
         }
         Unlock(usbcmd->lock);
@@ -376,14 +399,9 @@ k4a_result_t usb_cmd_stream_stop(usbcmd_t usbcmd_handle)
 
         // Sync operation with commands going to device
         Lock(usbcmd->lock);
-        usbcmd->stream_going = false;
 
-        // This function is the only place that kills the thread so this should be safe
-        if (usbcmd->stream_handle != NULL) // check if the thread has already stopped
-        {
-            ThreadAPI_Join(usbcmd->stream_handle, NULL);
-            usbcmd->stream_handle = NULL;
-        }
+        // The transfers are released by the shared libusb event threads once cancelled
+        usb_cmd_stream_cancel_transfers(usbcmd);
         Unlock(usbcmd->lock);
 
         result = K4A_RESULT_SUCCEEDED;
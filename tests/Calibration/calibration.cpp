@@ -16,10 +16,14 @@ using namespace testing;
 
 // Define the symbols needed from the usb_cmd module.
 // Only functions required to link the depth module are needed
+static int g_extrinsic_reads = 0;
+static depthmcu_firmware_versions_t g_firmware_versions = { 1, 6, 108, 1, 6, 79, 1, 6, 14, 6109, 7, 0, 0 };
+
 k4a_result_t
 depthmcu_get_extrinsic_calibration(depthmcu_t depthmcu_handle, char *json, size_t json_size, size_t *bytes_read)
 {
     (void)depthmcu_handle;
+    g_extrinsic_reads++;
 
     if (json_size < sizeof(g_test_json))
     {
@@ -30,6 +34,28 @@ depthmcu_get_extrinsic_calibration(depthmcu_t depthmcu_handle, char *json, size_
     return K4A_RESULT_SUCCEEDED;
 }
 
+k4a_buffer_result_t depthmcu_get_serialnum(depthmcu_t depthmcu_handle, char *serial_number, size_t *serial_number_size)
+{
+    (void)depthmcu_handle;
+    const char serial[] = "calibration_ut";
+
+    if (*serial_number_size < sizeof(serial))
+    {
+        *serial_number_size = sizeof(serial);
+        return K4A_BUFFER_RESULT_TOO_SMALL;
+    }
+    memcpy(serial_number, serial, sizeof(serial));
+    *serial_number_size = sizeof(serial);
+    return K4A_BUFFER_RESULT_SUCCEEDED;
+}
+
+k4a_result_t depthmcu_get_version(depthmcu_t depthmcu_handle, depthmcu_firmware_versions_t *version)
+{
+    (void)depthmcu_handle;
+    *version = g_firmware_versions;
+    return K4A_RESULT_SUCCEEDED;
+}
+
 TEST(calibration_ut, api_validation)
 {
     calibration_t calibration;
@@ -347,6 +373,75 @@ TEST(calibration_ut, validate_raw_data_api)
     free(json);
 }
 
+static void create_and_compare(const k4a_calibration_camera_t *expected_depth)
+{
+    calibration_t calibration;
+    k4a_calibration_camera_t depth;
+
+    ASSERT_EQ(calibration_create(FAKE_MCU, &calibration), K4A_RESULT_SUCCEEDED);
+    ASSERT_EQ(calibration_get_camera(calibration, K4A_CALIBRATION_TYPE_DEPTH, &depth), K4A_RESULT_SUCCEEDED);
+    ASSERT_EQ(memcmp(&depth, expected_depth, sizeof(depth)), 0);
+
+    char json[sizeof(g_test_json) + 1];
+    size_t json_size = sizeof(json);
+    ASSERT_EQ(calibration_get_raw_data(calibration, (uint8_t *)json, &json_size), K4A_BUFFER_RESULT_SUCCEEDED);
+    ASSERT_EQ(memcmp(json, g_test_json, sizeof(g_test_json)), 0);
+
+    depthmcu_firmware_versions_t versions;
+    ASSERT_EQ(calibration_get_firmware_versions(calibration, &versions), K4A_RESULT_SUCCEEDED);
+    ASSERT_EQ(memcmp(&versions, &g_firmware_versions, sizeof(versions)), 0);
+
+    calibration_destroy(calibration);
+}
+
+TEST(calibration_ut, cache)
+{
+    const char *cache_file = "./calibration_ut.k4acal";
+    k4a_calibration_camera_t expected_depth;
+    calibration_t calibration;
+
+    (void)remove(cache_file);
+
+    // Without a cache directory the firmware versions are not read
+    ASSERT_EQ(calibration_create(FAKE_MCU, &calibration), K4A_RESULT_SUCCEEDED);
+    ASSERT_EQ(calibration_get_camera(calibration, K4A_CALIBRATION_TYPE_DEPTH, &expected_depth), K4A_RESULT_SUCCEEDED);
+    depthmcu_firmware_versions_t versions;
+    ASSERT_EQ(calibration_get_firmware_versions(calibration, &versions), K4A_RESULT_FAILED);
+    calibration_destroy(calibration);
+
+    ASSERT_EQ(calibration_set_cache_directory("."), K4A_RESULT_SUCCEEDED);
+
+    // The first open reads from the device and populates the cache
+    g_extrinsic_reads = 0;
+    create_and_compare(&expected_depth);
+    ASSERT_EQ(g_extrinsic_reads, 1);
+
+    // The second open is served from the cache
+    create_and_compare(&expected_depth);
+    ASSERT_EQ(g_extrinsic_reads, 1);
+
+    // A firmware update invalidates the cache
+    g_firmware_versions.depth_build++;
+    create_and_compare(&expected_depth);
+    ASSERT_EQ(g_extrinsic_reads, 2);
+    create_and_compare(&expected_depth);
+    ASSERT_EQ(g_extrinsic_reads, 2);
+
+    // A corrupt file is detected by the checksum and rewritten
+    FILE *file = fopen(cache_file, "r+b");
+    ASSERT_NE(file, nullptr);
+    ASSERT_EQ(fseek(file, -8, SEEK_END), 0);
+    ASSERT_EQ(fputc('#', file), '#');
+    fclose(file);
+    create_and_compare(&expected_depth);
+    ASSERT_EQ(g_extrinsic_reads, 3);
+    create_and_compare(&expected_depth);
+    ASSERT_EQ(g_extrinsic_reads, 3);
+
+    ASSERT_EQ(calibration_set_cache_directory(NULL), K4A_RESULT_SUCCEEDED);
+    (void)remove(cache_file);
+}
+
 int main(int argc, char **argv)
 {
     return k4a_test_common_main(argc, argv);
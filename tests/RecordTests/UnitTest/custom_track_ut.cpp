@@ -6,6 +6,8 @@
 #include <k4ainternal/matroska_common.h>
 
 #include <cstdio>
+#include <cstring>
+#include <vector>
 #include <k4arecord/record.h>
 #include <k4arecord/playback.h>
 
@@ -281,6 +283,109 @@ TEST_F(custom_track_ut, read_custom_track_data)
     k4a_playback_close(handle);
 }
 
+TEST_F(custom_track_ut, read_custom_track_data_zero_copy)
+{
+    k4a_playback_t handle = NULL;
+    k4a_result_t result = k4a_playback_open("record_test_custom_track.mkv", &handle);
+    ASSERT_EQ(result, K4A_RESULT_SUCCEEDED);
+
+    k4a_record_configuration_t config;
+    result = k4a_playback_get_record_configuration(handle, &config);
+    ASSERT_EQ(result, K4A_RESULT_SUCCEEDED);
+
+    ASSERT_EQ(k4a_playback_set_data_block_zero_copy(NULL, true), K4A_RESULT_FAILED);
+    ASSERT_EQ(k4a_playback_set_data_block_zero_copy(handle, true), K4A_RESULT_SUCCEEDED);
+
+    // Hold onto every block so that each one has to keep its cluster loaded while later clusters are read
+    std::vector<k4a_playback_data_block_t> data_blocks;
+    k4a_stream_result_t stream_result = K4A_STREAM_RESULT_FAILED;
+    for (size_t i = 0; i < test_frame_count; i++)
+    {
+        k4a_playback_data_block_t data_block = NULL;
+        stream_result = k4a_playback_get_next_data_block(handle, "CUSTOM_TRACK", &data_block);
+        ASSERT_EQ(stream_result, K4A_STREAM_RESULT_SUCCEEDED);
+        data_blocks.push_back(data_block);
+    }
+
+    k4a_playback_data_block_t data_block = NULL;
+    stream_result = k4a_playback_get_next_data_block(handle, "CUSTOM_TRACK", &data_block);
+    ASSERT_EQ(stream_result, K4A_STREAM_RESULT_EOF);
+
+    // Blocks read after switching back to the copy mode hold the same data
+    ASSERT_EQ(k4a_playback_set_data_block_zero_copy(handle, false), K4A_RESULT_SUCCEEDED);
+    stream_result = k4a_playback_get_previous_data_block(handle, "CUSTOM_TRACK", &data_block);
+    ASSERT_EQ(stream_result, K4A_STREAM_RESULT_SUCCEEDED);
+    ASSERT_EQ(k4a_playback_data_block_get_buffer_size(data_block),
+              k4a_playback_data_block_get_buffer_size(data_blocks.back()));
+    ASSERT_NE(k4a_playback_data_block_get_buffer(data_block), k4a_playback_data_block_get_buffer(data_blocks.back()));
+    ASSERT_EQ(memcmp(k4a_playback_data_block_get_buffer(data_block),
+                     k4a_playback_data_block_get_buffer(data_blocks.back()),
+                     k4a_playback_data_block_get_buffer_size(data_block)),
+              0);
+    k4a_playback_data_block_release(data_block);
+
+    // Zero copy blocks stay valid after the playback handle is closed
+    k4a_playback_close(handle);
+
+    uint64_t expected_timestamp_usec = (uint64_t)config.start_timestamp_offset_usec;
+    for (k4a_playback_data_block_t block : data_blocks)
+    {
+        ASSERT_EQ(k4a_playback_data_block_get_device_timestamp_usec(block), expected_timestamp_usec);
+        ASSERT_TRUE(validate_custom_track_block(k4a_playback_data_block_get_buffer(block),
+                                                k4a_playback_data_block_get_buffer_size(block),
+                                                expected_timestamp_usec));
+        k4a_playback_data_block_release(block);
+        expected_timestamp_usec += test_timestamp_delta_usec;
+    }
+}
+
+TEST_F(custom_track_ut, release_custom_track_data_block)
+{
+    k4a_playback_t handle = NULL;
+    k4a_result_t result = k4a_playback_open("record_test_custom_track.mkv", &handle);
+    ASSERT_EQ(result, K4A_RESULT_SUCCEEDED);
+
+    k4a_record_configuration_t config;
+    result = k4a_playback_get_record_configuration(handle, &config);
+    ASSERT_EQ(result, K4A_RESULT_SUCCEEDED);
+
+    k4a_playback_data_block_t data_block = NULL;
+    k4a_stream_result_t stream_result = k4a_playback_get_next_data_block(handle, "CUSTOM_TRACK", &data_block);
+    ASSERT_EQ(stream_result, K4A_STREAM_RESULT_SUCCEEDED);
+    k4a_playback_data_block_release(data_block);
+
+    // The released handle is kept for reuse, but reads nothing until it is handed out again
+    ASSERT_EQ(k4a_playback_data_block_get_device_timestamp_usec(data_block), (uint64_t)0);
+    ASSERT_EQ(k4a_playback_data_block_get_buffer_size(data_block), (size_t)0);
+    ASSERT_EQ(k4a_playback_data_block_get_buffer(data_block), nullptr);
+
+    // Releasing it again is rejected instead of adding it to the pool twice
+    k4a_playback_data_block_release(data_block);
+
+    k4a_playback_data_block_t first_block = NULL;
+    k4a_playback_data_block_t second_block = NULL;
+    stream_result = k4a_playback_get_next_data_block(handle, "CUSTOM_TRACK", &first_block);
+    ASSERT_EQ(stream_result, K4A_STREAM_RESULT_SUCCEEDED);
+    stream_result = k4a_playback_get_next_data_block(handle, "CUSTOM_TRACK", &second_block);
+    ASSERT_EQ(stream_result, K4A_STREAM_RESULT_SUCCEEDED);
+    ASSERT_NE(first_block, second_block);
+
+    uint64_t expected_timestamp_usec = (uint64_t)config.start_timestamp_offset_usec + test_timestamp_delta_usec;
+    ASSERT_EQ(k4a_playback_data_block_get_device_timestamp_usec(first_block), expected_timestamp_usec);
+    ASSERT_TRUE(validate_custom_track_block(k4a_playback_data_block_get_buffer(first_block),
+                                            k4a_playback_data_block_get_buffer_size(first_block),
+                                            expected_timestamp_usec));
+    expected_timestamp_usec += test_timestamp_delta_usec;
+    ASSERT_EQ(k4a_playback_data_block_get_device_timestamp_usec(second_block), expected_timestamp_usec);
+    ASSERT_TRUE(validate_custom_track_block(k4a_playback_data_block_get_buffer(second_block),
+                                            k4a_playback_data_block_get_buffer_size(second_block),
+                                            expected_timestamp_usec));
+
+    k4a_playback_data_block_release(first_block);
+    k4a_playback_data_block_release(second_block);
+    k4a_playback_close(handle);
+}
+
 TEST_F(custom_track_ut, seek_custom_track_frame)
 {
     k4a_playback_t handle = NULL;
@@ -423,6 +528,92 @@ TEST_F(custom_track_ut, seek_custom_track_high_frequency)
     k4a_playback_close(handle);
 }
 
+TEST_F(custom_track_ut, preview_track)
+{
+    k4a_device_configuration_t config = K4A_DEVICE_CONFIG_INIT_DISABLE_ALL;
+    config.color_format = K4A_IMAGE_FORMAT_COLOR_NV12;
+    config.color_resolution = K4A_COLOR_RESOLUTION_720P;
+    config.depth_mode = K4A_DEPTH_MODE_NFOV_UNBINNED;
+    config.camera_fps = K4A_FRAMES_PER_SECOND_30;
+
+    // The preview track needs a color or depth track to draw from.
+    k4a_record_t handle = NULL;
+    k4a_device_configuration_t imu_only_config = K4A_DEVICE_CONFIG_INIT_DISABLE_ALL;
+    ASSERT_EQ(k4a_record_create("record_test_preview.mkv", NULL, imu_only_config, &handle), K4A_RESULT_SUCCEEDED);
+    ASSERT_EQ(k4a_record_add_preview_track(handle, NULL), K4A_RESULT_FAILED);
+    k4a_record_close(handle);
+
+    ASSERT_EQ(k4a_record_create("record_test_preview.mkv", NULL, config, &handle), K4A_RESULT_SUCCEEDED);
+    k4a_record_preview_settings_t settings = K4A_RECORD_PREVIEW_SETTINGS_INIT_DEFAULT;
+    settings.jpeg_quality = 101;
+    ASSERT_EQ(k4a_record_add_preview_track(handle, &settings), K4A_RESULT_FAILED);
+
+    // Let the preview use a whole core so that the test is not limited by the CPU budget.
+    settings = K4A_RECORD_PREVIEW_SETTINGS_INIT_DEFAULT;
+    settings.max_cpu_percent = 100;
+    ASSERT_EQ(k4a_record_add_preview_track(handle, &settings), K4A_RESULT_SUCCEEDED);
+    ASSERT_EQ(k4a_record_add_preview_track(handle, &settings), K4A_RESULT_FAILED);
+    ASSERT_EQ(k4a_record_write_header(handle), K4A_RESULT_SUCCEEDED);
+    ASSERT_EQ(k4a_record_add_preview_track(handle, &settings), K4A_RESULT_FAILED);
+
+    uint64_t timestamps[3] = { 0, 0, 0 };
+    for (size_t i = 0; i < test_frame_count; i++)
+    {
+        k4a_capture_t capture = create_test_capture(timestamps,
+                                                    config.color_format,
+                                                    config.color_resolution,
+                                                    config.depth_mode);
+        ASSERT_EQ(k4a_record_write_capture(handle, capture), K4A_RESULT_SUCCEEDED);
+        k4a_capture_release(capture);
+        timestamps[0] += test_timestamp_delta_usec;
+        timestamps[1] += test_timestamp_delta_usec;
+        timestamps[2] += test_timestamp_delta_usec;
+    }
+    k4a_record_close(handle);
+
+    k4a_playback_t playback = NULL;
+    ASSERT_EQ(k4a_playback_open("record_test_preview.mkv", &playback), K4A_RESULT_SUCCEEDED);
+    ASSERT_TRUE(k4a_playback_check_track_exists(playback, K4A_TRACK_NAME_PREVIEW));
+    ASSERT_FALSE(k4a_playback_track_is_builtin(playback, K4A_TRACK_NAME_PREVIEW));
+
+    // Color and depth are placed side by side.
+    k4a_record_video_settings_t video_settings;
+    ASSERT_EQ(k4a_playback_track_get_video_settings(playback, K4A_TRACK_NAME_PREVIEW, &video_settings),
+              K4A_RESULT_SUCCEEDED);
+    ASSERT_EQ(video_settings.width, 640u);
+    ASSERT_EQ(video_settings.height, 180u);
+
+    // Frames may be skipped while the preview thread is busy, but there is always at least one, and they are never
+    // closer together than the interval.
+    size_t preview_count = 0;
+    uint64_t last_timestamp_usec = 0;
+    k4a_playback_data_block_t data_block = NULL;
+    while (k4a_playback_get_next_data_block(playback, K4A_TRACK_NAME_PREVIEW, &data_block) ==
+           K4A_STREAM_RESULT_SUCCEEDED)
+    {
+        uint64_t timestamp_usec = k4a_playback_data_block_get_device_timestamp_usec(data_block);
+        if (preview_count > 0)
+        {
+            ASSERT_GE(timestamp_usec, last_timestamp_usec + 1000000);
+        }
+        last_timestamp_usec = timestamp_usec;
+
+        size_t block_size = k4a_playback_data_block_get_buffer_size(data_block);
+        uint8_t *block_buffer = k4a_playback_data_block_get_buffer(data_block);
+        ASSERT_GT(block_size, 2u);
+        ASSERT_EQ(block_buffer[0], 0xFF); // JPEG start of image marker
+        ASSERT_EQ(block_buffer[1], 0xD8);
+
+        k4a_playback_data_block_release(data_block);
+        preview_count++;
+    }
+    ASSERT_GE(preview_count, 1u);
+    ASSERT_LE(preview_count, (test_frame_count * test_timestamp_delta_usec) / 1000000 + 1);
+
+    k4a_playback_close(playback);
+    std::remove("record_test_preview.mkv");
+}
+
 int main(int argc, char **argv)
 {
     k4a_unittest_init();
@@ -7,10 +7,13 @@
 #include <k4ainternal/matroska_common.h>
 
 #include "test_helpers.h"
+#include <cstdio>
 #include <fstream>
+#include <vector>
 
 // Module being tested
 #include <k4arecord/playback.h>
+#include <k4arecord/record.h>
 
 using namespace testing;
 
@@ -57,6 +60,15 @@ TEST_F(playback_perf, test_open)
     std::cout << "    Depth delay: " << config.depth_delay_off_color_usec << " usec" << std::endl;
     std::cout << "    Start offset: " << config.start_timestamp_offset_usec << " usec" << std::endl;
 
+    k4a_playback_open_timing_t timing;
+    result = k4a_playback_get_open_timing(handle, &timing);
+    ASSERT_EQ(result, K4A_RESULT_SUCCEEDED);
+    std::cout << "Open timing:" << std::endl;
+    std::cout << "    Headers: " << timing.header_usec << " usec" << std::endl;
+    std::cout << "    Recording config: " << timing.config_usec << " usec" << std::endl;
+    std::cout << "    Cluster index: " << timing.cluster_index_usec << " usec" << std::endl;
+    std::cout << "    First cluster: " << timing.first_cluster_usec << " usec" << std::endl;
+
     std::pair<k4a_image_t, std::string> images[] = { { NULL, "Color" }, { NULL, "Depth" }, { NULL, "IR" } };
     while (images[0].first == NULL || images[1].first == NULL || images[2].first == NULL)
     {
@@ -245,6 +257,74 @@ TEST_F(playback_perf, test_1000_reads_backward)
     k4a_playback_close(handle);
 }
 
+TEST_F(playback_perf, test_forward_vs_reverse_iteration)
+{
+    k4a_playback_t handle = NULL;
+    k4a_result_t result = k4a_playback_open(g_test_file_name.c_str(), &handle);
+    ASSERT_EQ(result, K4A_RESULT_SUCCEEDED);
+
+    for (bool reverse : { false, true })
+    {
+        result = k4a_playback_seek_timestamp(handle, 0, reverse ? K4A_PLAYBACK_SEEK_END : K4A_PLAYBACK_SEEK_BEGIN);
+        ASSERT_EQ(result, K4A_RESULT_SUCCEEDED);
+
+        size_t capture_count = 0;
+        {
+            Timer t(reverse ? "Previous capture, whole recording" : "Next capture, whole recording");
+            while (true)
+            {
+                k4a_capture_t capture = NULL;
+                k4a_stream_result_t playback_result = reverse ? k4a_playback_get_previous_capture(handle, &capture) :
+                                                                k4a_playback_get_next_capture(handle, &capture);
+                ASSERT_NE(playback_result, K4A_STREAM_RESULT_FAILED);
+                if (playback_result == K4A_STREAM_RESULT_EOF)
+                {
+                    break;
+                }
+                capture_count++;
+                k4a_capture_release(capture);
+            }
+        }
+        std::cout << "    Captures: " << capture_count << std::endl;
+    }
+
+    // Scrubbing seeks a short distance and reads a few captures each time, the way a viewer does when the user drags
+    // the timeline.
+    uint64_t recording_length = k4a_playback_get_recording_length_usec(handle);
+    const int64_t scrub_step_usec = 500000;
+    for (bool reverse : { false, true })
+    {
+        size_t capture_count = 0;
+        {
+            Timer t(reverse ? "Scrub backward, 5 previous captures per 500ms" :
+                              "Scrub forward, 5 next captures per 500ms");
+            for (int64_t position = 0; position <= (int64_t)recording_length; position += scrub_step_usec)
+            {
+                int64_t seek_usec = reverse ? (int64_t)recording_length - position : position;
+                result = k4a_playback_seek_timestamp(handle, seek_usec, K4A_PLAYBACK_SEEK_BEGIN);
+                ASSERT_EQ(result, K4A_RESULT_SUCCEEDED);
+                for (int i = 0; i < 5; i++)
+                {
+                    k4a_capture_t capture = NULL;
+                    k4a_stream_result_t playback_result =
+                        reverse ? k4a_playback_get_previous_capture(handle, &capture) :
+                                  k4a_playback_get_next_capture(handle, &capture);
+                    ASSERT_NE(playback_result, K4A_STREAM_RESULT_FAILED);
+                    if (playback_result == K4A_STREAM_RESULT_EOF)
+                    {
+                        break;
+                    }
+                    capture_count++;
+                    k4a_capture_release(capture);
+                }
+            }
+        }
+        std::cout << "    Captures: " << capture_count << std::endl;
+    }
+
+    k4a_playback_close(handle);
+}
+
 TEST_F(playback_perf, test_read_latency_30fps)
 {
     k4a_playback_t handle = NULL;
@@ -351,6 +431,236 @@ TEST_F(playback_perf, test_read_latency_30fps_bgra_conversion)
     k4a_playback_close(handle);
 }
 
+TEST_F(playback_perf, test_data_block_copy_vs_zero_copy)
+{
+    k4a_playback_t handle = NULL;
+    k4a_result_t result = k4a_playback_open(g_test_file_name.c_str(), &handle);
+    ASSERT_EQ(result, K4A_RESULT_SUCCEEDED);
+
+    std::vector<std::string> custom_tracks;
+    size_t track_count = k4a_playback_get_track_count(handle);
+    for (size_t i = 0; i < track_count; i++)
+    {
+        char track_name[256];
+        size_t track_name_size = sizeof(track_name);
+        ASSERT_EQ(k4a_playback_get_track_name(handle, i, track_name, &track_name_size), K4A_BUFFER_RESULT_SUCCEEDED);
+        if (!k4a_playback_track_is_builtin(handle, track_name))
+        {
+            custom_tracks.emplace_back(track_name);
+        }
+    }
+    k4a_playback_close(handle);
+
+    if (custom_tracks.empty())
+    {
+        GTEST_SKIP() << "Input file " << g_test_file_name << " has no custom tracks, record one with a custom track to "
+                     << "compare the data block modes.";
+    }
+
+    for (const std::string &track_name : custom_tracks)
+    {
+        for (bool zero_copy : { false, true })
+        {
+            result = k4a_playback_open(g_test_file_name.c_str(), &handle);
+            ASSERT_EQ(result, K4A_RESULT_SUCCEEDED);
+            result = k4a_playback_set_data_block_zero_copy(handle, zero_copy);
+            ASSERT_EQ(result, K4A_RESULT_SUCCEEDED);
+
+            size_t block_count = 0;
+            size_t total_bytes = 0;
+            uint8_t checksum = 0;
+            {
+                Timer t("Next data block " + track_name + (zero_copy ? " (zero copy)" : " (copy)"));
+                k4a_stream_result_t playback_result = K4A_STREAM_RESULT_FAILED;
+                while (true)
+                {
+                    k4a_playback_data_block_t data_block = NULL;
+                    playback_result = k4a_playback_get_next_data_block(handle, track_name.c_str(), &data_block);
+                    ASSERT_NE(playback_result, K4A_STREAM_RESULT_FAILED);
+                    if (playback_result == K4A_STREAM_RESULT_EOF)
+                    {
+                        break;
+                    }
+
+                    // Touch the data so that both modes pay for reading it at least once
+                    size_t block_size = k4a_playback_data_block_get_buffer_size(data_block);
+                    uint8_t *block_buffer = k4a_playback_data_block_get_buffer(data_block);
+                    for (size_t i = 0; i < block_size; i += 4096)
+                    {
+                        checksum = (uint8_t)(checksum ^ block_buffer[i]);
+                    }
+                    block_count++;
+                    total_bytes += block_size;
+                    k4a_playback_data_block_release(data_block);
+                }
+            }
+            std::cout << "    Blocks: " << block_count << ", bytes: " << total_bytes << ", checksum: " << (int)checksum
+                      << std::endl;
+
+            k4a_playback_close(handle);
+        }
+    }
+}
+
+TEST_F(playback_perf, test_depth_only_eager_vs_lazy_images)
+{
+    for (bool lazy_images : { false, true })
+    {
+        k4a_playback_t handle = NULL;
+        k4a_result_t result = k4a_playback_open(g_test_file_name.c_str(), &handle);
+        ASSERT_EQ(result, K4A_RESULT_SUCCEEDED);
+        k4a_record_configuration_t config;
+        result = k4a_playback_get_record_configuration(handle, &config);
+        ASSERT_EQ(result, K4A_RESULT_SUCCEEDED);
+        if (config.color_track_enabled)
+        {
+            // Converting color is the most expensive part of reading a capture that lazy images can skip
+            result = k4a_playback_set_color_conversion(handle, K4A_IMAGE_FORMAT_COLOR_BGRA32);
+            ASSERT_EQ(result, K4A_RESULT_SUCCEEDED);
+        }
+        result = k4a_playback_set_lazy_images(handle, lazy_images);
+        ASSERT_EQ(result, K4A_RESULT_SUCCEEDED);
+
+        size_t capture_count = 0;
+        size_t depth_count = 0;
+        {
+            Timer t(std::string("Next capture, depth image only") + (lazy_images ? " (lazy)" : " (eager)"));
+            while (true)
+            {
+                k4a_capture_t capture = NULL;
+                k4a_stream_result_t playback_result = k4a_playback_get_next_capture(handle, &capture);
+                ASSERT_NE(playback_result, K4A_STREAM_RESULT_FAILED);
+                if (playback_result == K4A_STREAM_RESULT_EOF)
+                {
+                    break;
+                }
+
+                k4a_image_t depth_image = k4a_capture_get_depth_image(capture);
+                if (depth_image != NULL)
+                {
+                    depth_count++;
+                    k4a_image_release(depth_image);
+                }
+                capture_count++;
+                k4a_capture_release(capture);
+            }
+        }
+        std::cout << "    Captures: " << capture_count << ", depth images: " << depth_count << std::endl;
+
+        k4a_playback_close(handle);
+    }
+}
+
+TEST_F(playback_perf, test_cluster_length_and_cue_density)
+{
+    k4a_playback_t handle = NULL;
+    k4a_result_t result = k4a_playback_open(g_test_file_name.c_str(), &handle);
+    ASSERT_EQ(result, K4A_RESULT_SUCCEEDED);
+    k4a_record_configuration_t config;
+    result = k4a_playback_get_record_configuration(handle, &config);
+    ASSERT_EQ(result, K4A_RESULT_SUCCEEDED);
+
+    k4a_device_configuration_t device_config = K4A_DEVICE_CONFIG_INIT_DISABLE_ALL;
+    device_config.color_format = config.color_format;
+    device_config.color_resolution = config.color_resolution;
+    device_config.depth_mode = config.depth_mode;
+    device_config.camera_fps = config.camera_fps;
+    device_config.depth_delay_off_color_usec = config.depth_delay_off_color_usec;
+
+    // The same captures are re-recorded with each setting, so only the file layout changes
+    std::vector<k4a_capture_t> captures;
+    while (captures.size() < 300)
+    {
+        k4a_capture_t capture = NULL;
+        k4a_stream_result_t playback_result = k4a_playback_get_next_capture(handle, &capture);
+        ASSERT_NE(playback_result, K4A_STREAM_RESULT_FAILED);
+        if (playback_result == K4A_STREAM_RESULT_EOF)
+        {
+            break;
+        }
+        captures.push_back(capture);
+    }
+    k4a_playback_close(handle);
+    ASSERT_FALSE(captures.empty());
+    std::cout << "Re-recording " << captures.size() << " captures" << std::endl;
+
+    static const std::pair<k4a_record_settings_t, std::string> test_settings[] = {
+        { { 0, 0, 0 }, "default: 32ms clusters, 1s cue gap" },
+        { { 0, 100000, 0 }, "32ms clusters, 100ms cue gap" },
+        { { 0, 10000000, 0 }, "32ms clusters, 10s cue gap" },
+        { { 8000, 100000, 0 }, "8ms clusters, 100ms cue gap" },
+        { { 2000, 0, 0 }, "2ms clusters, 1s cue gap" },
+    };
+    const char *test_file_name = "playback_perf_settings.mkv";
+    for (const auto &test_setting : test_settings)
+    {
+        std::cout << "Settings: " << test_setting.second << std::endl;
+        {
+            Timer t("Write " + test_setting.second);
+            k4a_record_t recording = NULL;
+            result = k4a_record_create_with_settings(test_file_name,
+                                                     NULL,
+                                                     device_config,
+                                                     &test_setting.first,
+                                                     &recording);
+            ASSERT_EQ(result, K4A_RESULT_SUCCEEDED);
+            result = k4a_record_write_header(recording);
+            ASSERT_EQ(result, K4A_RESULT_SUCCEEDED);
+            for (k4a_capture_t capture : captures)
+            {
+                result = k4a_record_write_capture(recording, capture);
+                ASSERT_EQ(result, K4A_RESULT_SUCCEEDED);
+            }
+            result = k4a_record_flush(recording);
+            ASSERT_EQ(result, K4A_RESULT_SUCCEEDED);
+            k4a_record_close(recording);
+        }
+
+        std::ifstream file(test_file_name, std::ios::binary | std::ios::ate);
+        std::cout << "    File size: " << file.tellg() << " bytes" << std::endl;
+        file.close();
+
+        {
+            Timer t("Open " + test_setting.second);
+            result = k4a_playback_open(test_file_name, &handle);
+        }
+        ASSERT_EQ(result, K4A_RESULT_SUCCEEDED);
+
+        k4a_playback_statistics_t statistics;
+        result = k4a_playback_get_statistics(handle, &statistics);
+        ASSERT_EQ(result, K4A_RESULT_SUCCEEDED);
+        std::cout << "    Clusters: " << statistics.cluster_count << ", blocks: " << statistics.block_count
+                  << std::endl;
+
+        uint64_t recording_length = k4a_playback_get_recording_length_usec(handle);
+        {
+            Timer t("100 seeks " + test_setting.second);
+            for (uint64_t i = 0; i < 100; i++)
+            {
+                // Spread the seeks across the recording in a fixed, non-sequential order
+                uint64_t seek_timestamp = (i * 7919) % 100 * recording_length / 100;
+                result = k4a_playback_seek_timestamp(handle, (int64_t)seek_timestamp, K4A_PLAYBACK_SEEK_BEGIN);
+                ASSERT_EQ(result, K4A_RESULT_SUCCEEDED);
+
+                k4a_capture_t capture = NULL;
+                k4a_stream_result_t playback_result = k4a_playback_get_next_capture(handle, &capture);
+                ASSERT_NE(playback_result, K4A_STREAM_RESULT_FAILED);
+                if (playback_result == K4A_STREAM_RESULT_SUCCEEDED)
+                {
+                    k4a_capture_release(capture);
+                }
+            }
+        }
+        k4a_playback_close(handle);
+    }
+
+    for (k4a_capture_t capture : captures)
+    {
+        k4a_capture_release(capture);
+    }
+    ASSERT_EQ(std::remove(test_file_name), 0);
+}
+
 int main(int argc, char **argv)
 {
     k4a_unittest_init();
@@ -5,9 +5,15 @@
 #include <k4a/k4a.h>
 #include <k4ainternal/common.h>
 #include <k4ainternal/matroska_common.h>
+#include <k4ainternal/matroska_read.h>
 
 #include "test_helpers.h"
+#include <ut_calibration_data.h>
+#include <k4arecord/record.h>
+#include <cstdio>
+#include <cstring>
 #include <fstream>
+#include <string>
 #include <thread>
 #include <chrono>
 
@@ -1022,6 +1028,471 @@ TEST_F(playback_ut, open_bgra_color_file)
     k4a_playback_close(handle);
 }
 
+TEST_F(playback_ut, playback_group_merge)
+{
+    const char *paths[] = { "record_test_full.mkv", "record_test_sub.mkv" };
+    k4a_playback_group_t group = NULL;
+    ASSERT_EQ(k4a_playback_group_open(NULL, 2, &group), K4A_RESULT_FAILED);
+    ASSERT_EQ(k4a_playback_group_open(paths, 0, &group), K4A_RESULT_FAILED);
+    ASSERT_EQ(k4a_playback_group_open(paths, 2, &group), K4A_RESULT_SUCCEEDED);
+    ASSERT_EQ(k4a_playback_group_get_playback_count(group), (size_t)2);
+    ASSERT_EQ(k4a_playback_group_get_playback(group, 2), nullptr);
+
+    k4a_record_configuration_t config;
+    ASSERT_EQ(k4a_playback_get_record_configuration(k4a_playback_group_get_playback(group, 1), &config),
+              K4A_RESULT_SUCCEEDED);
+    ASSERT_EQ(config.wired_sync_mode, K4A_WIRED_SYNC_MODE_SUBORDINATE);
+
+    // The subordinate capture is 10ms late on the device clock, which its subordinate delay cancels out. It has the
+    // same group timestamp as the first capture of the full recording, so it comes right after it.
+    uint64_t timestamps[3] = { 0, 1000, 1000 };
+    uint64_t sub_timestamps[3] = { 10000, 10000, 10000 };
+    k4a_capture_t capture = NULL;
+    size_t playback_index = 0;
+    for (size_t i = 0; i < test_frame_count + 1; i++)
+    {
+        ASSERT_EQ(k4a_playback_group_get_next_capture(group, &capture, &playback_index), K4A_STREAM_RESULT_SUCCEEDED);
+        if (i == 1)
+        {
+            ASSERT_EQ(playback_index, (size_t)1);
+            ASSERT_TRUE(validate_test_capture(capture,
+                                              sub_timestamps,
+                                              config.color_format,
+                                              config.color_resolution,
+                                              config.depth_mode));
+        }
+        else
+        {
+            ASSERT_EQ(playback_index, (size_t)0);
+            ASSERT_TRUE(validate_test_capture(capture,
+                                              timestamps,
+                                              config.color_format,
+                                              config.color_resolution,
+                                              config.depth_mode));
+            timestamps[0] += test_timestamp_delta_usec;
+            timestamps[1] += test_timestamp_delta_usec;
+            timestamps[2] += test_timestamp_delta_usec;
+        }
+        k4a_capture_release(capture);
+    }
+    ASSERT_EQ(k4a_playback_group_get_next_capture(group, &capture, NULL), K4A_STREAM_RESULT_EOF);
+
+    k4a_playback_group_close(group);
+}
+
+TEST_F(playback_ut, playback_group_aligned_captures)
+{
+    const char *paths[] = { "record_test_full.mkv", "record_test_sub.mkv" };
+    k4a_playback_group_t group = NULL;
+    ASSERT_EQ(k4a_playback_group_open(paths, 2, &group), K4A_RESULT_SUCCEEDED);
+
+    k4a_capture_t captures[2] = { NULL, NULL };
+    ASSERT_EQ(k4a_playback_group_get_next_captures(group, 1000, captures, 1), K4A_STREAM_RESULT_FAILED);
+
+    // Only the first capture of each recording lines up, the rest of the full recording comes alone
+    for (size_t i = 0; i < test_frame_count; i++)
+    {
+        ASSERT_EQ(k4a_playback_group_get_next_captures(group, 1000, captures, 2), K4A_STREAM_RESULT_SUCCEEDED);
+        ASSERT_NE(captures[0], nullptr);
+        ASSERT_EQ(captures[1] != nullptr, i == 0);
+        for (k4a_capture_t capture : captures)
+        {
+            if (capture != NULL)
+            {
+                k4a_capture_release(capture);
+            }
+        }
+    }
+    ASSERT_EQ(k4a_playback_group_get_next_captures(group, 1000, captures, 2), K4A_STREAM_RESULT_EOF);
+    ASSERT_EQ(captures[0], nullptr);
+    ASSERT_EQ(captures[1], nullptr);
+
+    k4a_playback_group_close(group);
+
+    // Closing a group that still has captures read ahead releases them
+    ASSERT_EQ(k4a_playback_group_open(paths, 2, &group), K4A_RESULT_SUCCEEDED);
+    k4a_playback_group_close(group);
+}
+
+TEST_F(playback_ut, recording_statistics)
+{
+    k4a_playback_t handle = NULL;
+    k4a_result_t result = k4a_playback_open("record_test_full.mkv", &handle);
+    ASSERT_EQ(result, K4A_RESULT_SUCCEEDED);
+
+    k4a_playback_track_statistics_t track_statistics;
+    ASSERT_EQ(k4a_playback_track_get_statistics(handle, "UNKNOWN", &track_statistics), K4A_RESULT_FAILED);
+
+    k4a_playback_statistics_t statistics;
+    ASSERT_EQ(k4a_playback_get_statistics(handle, &statistics), K4A_RESULT_SUCCEEDED);
+    ASSERT_FALSE(statistics.truncated);
+    ASSERT_GT(statistics.cluster_count, (uint64_t)0);
+    ASSERT_GT(statistics.block_count, (uint64_t)(test_frame_count * 3));
+    ASSERT_EQ(statistics.unknown_track_block_count, (uint64_t)0);
+
+    const char *camera_tracks[] = { K4A_TRACK_NAME_COLOR, K4A_TRACK_NAME_DEPTH, K4A_TRACK_NAME_IR };
+    for (const char *track_name : camera_tracks)
+    {
+        // Depth and IR are recorded 1ms after color
+        uint64_t start_timestamp = track_name == camera_tracks[0] ? 0 : 1000;
+
+        result = k4a_playback_track_get_statistics(handle, track_name, &track_statistics);
+        ASSERT_EQ(result, K4A_RESULT_SUCCEEDED);
+        ASSERT_EQ(track_statistics.frame_count, (uint64_t)test_frame_count);
+        ASSERT_EQ(track_statistics.block_count, (uint64_t)test_frame_count);
+        ASSERT_EQ(track_statistics.start_timestamp_usec, start_timestamp);
+        ASSERT_EQ(track_statistics.end_timestamp_usec,
+                  start_timestamp + (test_frame_count - 1) * test_timestamp_delta_usec);
+        ASSERT_EQ(track_statistics.frame_period_usec, (uint64_t)test_timestamp_delta_usec);
+        ASSERT_EQ(track_statistics.max_gap_usec, (uint64_t)test_timestamp_delta_usec);
+        ASSERT_EQ(track_statistics.gap_count, (uint64_t)0);
+        ASSERT_EQ(track_statistics.dropped_frame_estimate, (uint64_t)0);
+        ASSERT_EQ(track_statistics.out_of_order_count, (uint64_t)0);
+        ASSERT_GT(track_statistics.data_size_bytes, (uint64_t)0);
+        ASSERT_GT(track_statistics.bitrate_bps, (uint64_t)0);
+    }
+
+    // IMU samples are batched together in blocks, but still counted individually
+    result = k4a_playback_track_get_statistics(handle, K4A_TRACK_NAME_IMU, &track_statistics);
+    ASSERT_EQ(result, K4A_RESULT_SUCCEEDED);
+    ASSERT_LT(track_statistics.block_count, track_statistics.frame_count);
+    ASSERT_EQ(track_statistics.start_timestamp_usec, (uint64_t)1150);
+    ASSERT_EQ(track_statistics.end_timestamp_usec, k4a_playback_get_recording_length_usec(handle));
+    uint64_t imu_sample_count = 0;
+    k4a_imu_sample_t imu_sample = { 0 };
+    while (k4a_playback_get_next_imu_sample(handle, &imu_sample) == K4A_STREAM_RESULT_SUCCEEDED)
+    {
+        imu_sample_count++;
+    }
+    ASSERT_EQ(track_statistics.frame_count, imu_sample_count);
+    ASSERT_EQ(track_statistics.out_of_order_count, (uint64_t)0);
+
+    k4a_playback_close(handle);
+
+    result = k4a_playback_open("record_test_skips.mkv", &handle);
+    ASSERT_EQ(result, K4A_RESULT_SUCCEEDED);
+
+    // Color is missing every other frame
+    result = k4a_playback_track_get_statistics(handle, K4A_TRACK_NAME_COLOR, &track_statistics);
+    ASSERT_EQ(result, K4A_RESULT_SUCCEEDED);
+    ASSERT_EQ(track_statistics.frame_count, (uint64_t)test_frame_count / 2);
+    ASSERT_EQ(track_statistics.start_timestamp_usec, (uint64_t)1000000 + test_timestamp_delta_usec);
+    ASSERT_EQ(track_statistics.max_gap_usec, (uint64_t)test_timestamp_delta_usec * 2);
+    ASSERT_EQ(track_statistics.gap_count, (uint64_t)test_frame_count / 2 - 1);
+    ASSERT_EQ(track_statistics.dropped_frame_estimate, (uint64_t)test_frame_count / 2 - 1);
+
+    // Depth is missing 2 frames out of every 4
+    result = k4a_playback_track_get_statistics(handle, K4A_TRACK_NAME_DEPTH, &track_statistics);
+    ASSERT_EQ(result, K4A_RESULT_SUCCEEDED);
+    ASSERT_EQ(track_statistics.frame_count, (uint64_t)test_frame_count / 2);
+    ASSERT_EQ(track_statistics.start_timestamp_usec, (uint64_t)1001000);
+    ASSERT_EQ(track_statistics.max_gap_usec, (uint64_t)test_timestamp_delta_usec * 3);
+    ASSERT_EQ(track_statistics.gap_count, (uint64_t)test_frame_count / 4);
+    ASSERT_EQ(track_statistics.dropped_frame_estimate, (uint64_t)test_frame_count / 2);
+
+    k4a_playback_close(handle);
+}
+
+TEST_F(playback_ut, lazy_capture_images)
+{
+    k4a_playback_t handle = NULL;
+    k4a_result_t result = k4a_playback_open("record_test_full.mkv", &handle);
+    ASSERT_EQ(result, K4A_RESULT_SUCCEEDED);
+    ASSERT_EQ(k4a_playback_set_lazy_images(NULL, true), K4A_RESULT_FAILED);
+    ASSERT_EQ(k4a_playback_set_lazy_images(handle, true), K4A_RESULT_SUCCEEDED);
+
+    k4a_record_configuration_t config;
+    result = k4a_playback_get_record_configuration(handle, &config);
+    ASSERT_EQ(result, K4A_RESULT_SUCCEEDED);
+
+    // Lazily loaded images are identical to the ones read up front
+    k4a_capture_t capture = NULL;
+    k4a_stream_result_t stream_result = K4A_STREAM_RESULT_FAILED;
+    uint64_t timestamps[3] = { 0, 1000, 1000 };
+    for (size_t i = 0; i < 10; i++)
+    {
+        stream_result = k4a_playback_get_next_capture(handle, &capture);
+        ASSERT_EQ(stream_result, K4A_STREAM_RESULT_SUCCEEDED);
+        ASSERT_TRUE(validate_test_capture(capture,
+                                          timestamps,
+                                          config.color_format,
+                                          config.color_resolution,
+                                          config.depth_mode));
+        k4a_capture_release(capture);
+        timestamps[0] += test_timestamp_delta_usec;
+        timestamps[1] += test_timestamp_delta_usec;
+        timestamps[2] += test_timestamp_delta_usec;
+    }
+
+    // The statistics outlive the playback handle, so that captures released after close still update them
+    std::shared_ptr<image_load_stats_t> image_stats = k4a_playback_t_get_context(handle)->image_stats;
+    ASSERT_NE(image_stats, nullptr);
+    ASSERT_EQ(image_stats->skipped_count.load(), (uint64_t)0);
+
+    // Captures whose images are never accessed are released without converting them
+    uint64_t converted_count = image_stats->converted_count.load();
+    for (size_t i = 0; i < 10; i++)
+    {
+        stream_result = k4a_playback_get_next_capture(handle, &capture);
+        ASSERT_EQ(stream_result, K4A_STREAM_RESULT_SUCCEEDED);
+        k4a_capture_release(capture);
+        timestamps[0] += test_timestamp_delta_usec;
+        timestamps[1] += test_timestamp_delta_usec;
+        timestamps[2] += test_timestamp_delta_usec;
+    }
+    ASSERT_EQ(image_stats->converted_count.load(), converted_count);
+    ASSERT_EQ(image_stats->skipped_count.load(), (uint64_t)(10 * 3)); // Color, depth and IR
+
+    // Images can still be accessed after the playback handle is closed
+    stream_result = k4a_playback_get_next_capture(handle, &capture);
+    ASSERT_EQ(stream_result, K4A_STREAM_RESULT_SUCCEEDED);
+    k4a_image_t depth_image = k4a_capture_get_depth_image(capture);
+    ASSERT_NE(depth_image, (k4a_image_t)NULL);
+    k4a_image_release(depth_image);
+    k4a_playback_close(handle);
+
+    ASSERT_TRUE(validate_test_capture(capture,
+                                      timestamps,
+                                      config.color_format,
+                                      config.color_resolution,
+                                      config.depth_mode));
+    k4a_capture_release(capture);
+    ASSERT_EQ(image_stats->skipped_count.load(), (uint64_t)(10 * 3));
+}
+
+TEST_F(playback_ut, open_multiple_files)
+{
+    const char *paths[] = { "record_test_full.mkv",
+                            "record_test_skips.mkv",
+                            "record_test_missing.mkv",
+                            "record_test_depth_only.mkv" };
+    const size_t path_count = arraysize(paths);
+    k4a_playback_t handles[path_count];
+    size_t calibration_indices[path_count];
+
+    ASSERT_EQ(k4a_playback_open_multiple(NULL, path_count, 0, handles, NULL), K4A_RESULT_FAILED);
+    ASSERT_EQ(k4a_playback_open_multiple(paths, 0, 0, handles, NULL), K4A_RESULT_FAILED);
+    ASSERT_EQ(k4a_playback_open_multiple(paths, path_count, 0, NULL, NULL), K4A_RESULT_FAILED);
+
+    // Recordings that open are returned even if others fail
+    k4a_result_t result = k4a_playback_open_multiple(paths, path_count, 2, handles, calibration_indices);
+    ASSERT_EQ(result, K4A_RESULT_FAILED);
+    ASSERT_EQ(handles[2], (k4a_playback_t)NULL);
+    for (size_t i = 0; i < path_count; i++)
+    {
+        // The test recordings have no calibration to share
+        ASSERT_EQ(calibration_indices[i], i);
+        if (i == 2)
+        {
+            continue;
+        }
+        ASSERT_NE(handles[i], (k4a_playback_t)NULL);
+
+        k4a_playback_open_timing_t timing;
+        ASSERT_EQ(k4a_playback_get_open_timing(handles[i], &timing), K4A_RESULT_SUCCEEDED);
+        ASSERT_GT(timing.total_usec, (uint64_t)0);
+        ASSERT_GE(timing.total_usec,
+                  timing.header_usec + timing.config_usec + timing.cluster_index_usec + timing.first_cluster_usec);
+        ASSERT_EQ(timing.calibration_usec, (uint64_t)0);
+
+        k4a_capture_t capture = NULL;
+        ASSERT_EQ(k4a_playback_get_next_capture(handles[i], &capture), K4A_STREAM_RESULT_SUCCEEDED);
+        k4a_capture_release(capture);
+        k4a_playback_close(handles[i]);
+    }
+
+    result = k4a_playback_open_multiple(paths, 2, 1, handles, NULL);
+    ASSERT_EQ(result, K4A_RESULT_SUCCEEDED);
+    k4a_playback_close(handles[0]);
+    k4a_playback_close(handles[1]);
+}
+
+static void create_calibration_recording(const char *path, const std::string &calibration_json)
+{
+    k4a_device_configuration_t config = K4A_DEVICE_CONFIG_INIT_DISABLE_ALL;
+    config.color_format = K4A_IMAGE_FORMAT_COLOR_MJPG;
+    config.color_resolution = K4A_COLOR_RESOLUTION_1080P;
+    config.depth_mode = K4A_DEPTH_MODE_NFOV_UNBINNED;
+    config.camera_fps = K4A_FRAMES_PER_SECOND_30;
+
+    k4a_record_t handle = NULL;
+    ASSERT_EQ(k4a_record_create(path, NULL, config, &handle), K4A_RESULT_SUCCEEDED);
+
+    // Recordings made with a device store the calibration in the same attachment
+    ASSERT_EQ(k4a_record_add_attachment(handle,
+                                        "calibration.json",
+                                        (const uint8_t *)calibration_json.c_str(),
+                                        calibration_json.size() + 1),
+              K4A_RESULT_SUCCEEDED);
+    ASSERT_EQ(k4a_record_write_header(handle), K4A_RESULT_SUCCEEDED);
+
+    uint64_t timestamps[3] = { 0, 1000, 1000 };
+    k4a_capture_t capture = create_test_capture(timestamps,
+                                                config.color_format,
+                                                config.color_resolution,
+                                                config.depth_mode);
+    ASSERT_EQ(k4a_record_write_capture(handle, capture), K4A_RESULT_SUCCEEDED);
+    k4a_capture_release(capture);
+
+    ASSERT_EQ(k4a_record_flush(handle), K4A_RESULT_SUCCEEDED);
+    k4a_record_close(handle);
+}
+
+TEST_F(playback_ut, open_multiple_files_shared_calibration)
+{
+    const char *paths[] = { "record_test_calibration_0.mkv",
+                            "record_test_calibration_1.mkv",
+                            "record_test_calibration_2.mkv",
+                            "record_test_calibration_3.mkv" };
+    const size_t path_count = arraysize(paths);
+    const size_t different_index = 2;
+
+    // Every recording but one has the same calibration attachment
+    std::string calibration_json(g_test_json);
+    std::string different_json = calibration_json;
+    const std::string metric_radius = "\"MetricRadius\": 1.737323045730591";
+    size_t metric_radius_pos = different_json.find(metric_radius);
+    ASSERT_NE(metric_radius_pos, std::string::npos);
+    different_json.replace(metric_radius_pos, metric_radius.size(), "\"MetricRadius\": 1.5");
+    for (size_t i = 0; i < path_count; i++)
+    {
+        create_calibration_recording(paths[i], i == different_index ? different_json : calibration_json);
+    }
+
+    k4a_playback_t handles[path_count];
+    size_t calibration_indices[path_count];
+    k4a_result_t result =
+        k4a_playback_open_multiple(paths, path_count, (uint32_t)path_count, handles, calibration_indices);
+    ASSERT_EQ(result, K4A_RESULT_SUCCEEDED);
+
+    // Recordings sharing a calibration point to the first of them, whichever thread parsed it
+    ASSERT_EQ(calibration_indices[0], (size_t)0);
+    ASSERT_EQ(calibration_indices[1], (size_t)0);
+    ASSERT_EQ(calibration_indices[2], different_index);
+    ASSERT_EQ(calibration_indices[3], (size_t)0);
+
+    // The calibration of a recording opened on its own is the reference. k4a_calibration_t only has 4 byte members, so
+    // there is no padding to compare.
+    k4a_calibration_t calibrations[path_count];
+    for (size_t i = 0; i < path_count; i++)
+    {
+        ASSERT_NE(handles[i], (k4a_playback_t)NULL);
+        ASSERT_EQ(k4a_playback_get_calibration(handles[i], &calibrations[i]), K4A_RESULT_SUCCEEDED);
+    }
+    k4a_calibration_t expected;
+    ASSERT_EQ(k4a_calibration_get_from_raw((char *)calibration_json.c_str(),
+                                           calibration_json.size() + 1,
+                                           K4A_DEPTH_MODE_NFOV_UNBINNED,
+                                           K4A_COLOR_RESOLUTION_1080P,
+                                           &expected),
+              K4A_RESULT_SUCCEEDED);
+    for (size_t i = 0; i < path_count; i++)
+    {
+        if (i == different_index)
+        {
+            ASSERT_NE(memcmp(&calibrations[i], &expected, sizeof(expected)), 0);
+            ASSERT_FLOAT_EQ(calibrations[i].depth_camera_calibration.metric_radius, 1.5f);
+        }
+        else
+        {
+            ASSERT_EQ(memcmp(&calibrations[i], &expected, sizeof(expected)), 0);
+        }
+    }
+
+    for (size_t i = 0; i < path_count; i++)
+    {
+        k4a_playback_close(handles[i]);
+        ASSERT_EQ(std::remove(paths[i]), 0);
+    }
+}
+
+TEST_F(playback_ut, trim_recording)
+{
+    k4a_playback_t handle = NULL;
+    k4a_result_t result = k4a_playback_open("record_test_full.mkv", &handle);
+    ASSERT_EQ(result, K4A_RESULT_SUCCEEDED);
+
+    ASSERT_EQ(k4a_playback_trim(handle, NULL, 1000000, 2000000), K4A_RESULT_FAILED);
+    ASSERT_EQ(k4a_playback_trim(handle, "record_test_trim.mkv", 2000000, 1000000), K4A_RESULT_FAILED);
+    ASSERT_EQ(k4a_playback_trim(handle, "record_test_trim.mkv", 100000000, 101000000), K4A_RESULT_FAILED);
+    {
+        // A trim that fails after creating the output file removes it
+        std::ifstream trim_file("record_test_trim.mkv");
+        ASSERT_FALSE(trim_file.good());
+    }
+
+    // Trimming doesn't affect the original playback handle
+    k4a_capture_t capture = NULL;
+    ASSERT_EQ(k4a_playback_get_next_capture(handle, &capture), K4A_STREAM_RESULT_SUCCEEDED);
+    result = k4a_playback_trim(handle, "record_test_trim.mkv", 1000000, 2000000);
+    ASSERT_EQ(result, K4A_RESULT_SUCCEEDED);
+    k4a_image_t color_image = k4a_capture_get_color_image(capture);
+    ASSERT_NE(color_image, (k4a_image_t)NULL);
+    ASSERT_EQ(k4a_image_get_device_timestamp_usec(color_image), (uint64_t)0);
+    k4a_image_release(color_image);
+    k4a_capture_release(capture);
+    ASSERT_EQ(k4a_playback_get_next_capture(handle, &capture), K4A_STREAM_RESULT_SUCCEEDED);
+    color_image = k4a_capture_get_color_image(capture);
+    ASSERT_NE(color_image, (k4a_image_t)NULL);
+    ASSERT_EQ(k4a_image_get_device_timestamp_usec(color_image), (uint64_t)test_timestamp_delta_usec);
+    k4a_image_release(color_image);
+    k4a_capture_release(capture);
+    k4a_playback_close(handle);
+
+    result = k4a_playback_open("record_test_trim.mkv", &handle);
+    ASSERT_EQ(result, K4A_RESULT_SUCCEEDED);
+
+    // Device timestamps are the same as in the original recording
+    k4a_record_configuration_t config;
+    result = k4a_playback_get_record_configuration(handle, &config);
+    ASSERT_EQ(result, K4A_RESULT_SUCCEEDED);
+    ASSERT_EQ(config.start_timestamp_offset_usec, (uint32_t)1000000);
+    ASSERT_LE(k4a_playback_get_recording_length_usec(handle), (uint64_t)1000000);
+
+    k4a_playback_statistics_t statistics;
+    ASSERT_EQ(k4a_playback_get_statistics(handle, &statistics), K4A_RESULT_SUCCEEDED);
+    ASSERT_FALSE(statistics.truncated);
+
+    // Color frames 31 to 60 and depth frames 30 to 59 are within the range, depth and IR are recorded 1ms after color
+    size_t color_count = 0, depth_count = 0;
+    uint64_t first_color_timestamp = 0;
+    while (k4a_playback_get_next_capture(handle, &capture) == K4A_STREAM_RESULT_SUCCEEDED)
+    {
+        color_image = k4a_capture_get_color_image(capture);
+        if (color_image != NULL)
+        {
+            uint64_t timestamp = k4a_image_get_device_timestamp_usec(color_image);
+            if (color_count++ == 0)
+            {
+                first_color_timestamp = timestamp;
+            }
+            ASSERT_GE(timestamp, (uint64_t)1000000);
+            ASSERT_LT(timestamp, (uint64_t)2000000);
+            k4a_image_release(color_image);
+        }
+        k4a_image_t depth_image = k4a_capture_get_depth_image(capture);
+        if (depth_image != NULL)
+        {
+            uint64_t timestamp = k4a_image_get_device_timestamp_usec(depth_image);
+            depth_count++;
+            ASSERT_GE(timestamp, (uint64_t)1000000);
+            ASSERT_LT(timestamp, (uint64_t)2000000);
+            k4a_image_release(depth_image);
+        }
+        k4a_capture_release(capture);
+    }
+    ASSERT_EQ(color_count, (size_t)30);
+    ASSERT_EQ(depth_count, (size_t)30);
+    ASSERT_EQ(first_color_timestamp, (uint64_t)31 * test_timestamp_delta_usec);
+
+    k4a_imu_sample_t imu_sample = { 0 };
+    ASSERT_EQ(k4a_playback_get_next_imu_sample(handle, &imu_sample), K4A_STREAM_RESULT_SUCCEEDED);
+    ASSERT_GE(imu_sample.acc_timestamp_usec, (uint64_t)1000000);
+
+    k4a_playback_close(handle);
+    ASSERT_EQ(std::remove("record_test_trim.mkv"), 0);
+}
+
 int main(int argc, char **argv)
 {
     k4a_unittest_init();
@@ -26,6 +26,9 @@ protected:
         context = k4a_record_t_create(&recording_handle);
         context->ebml_file = make_unique<libebml::MemIOCallback>();
         context->timecode_scale = MATROSKA_TIMESCALE_NS;
+        context->cluster_length_ns = MAX_CLUSTER_LENGTH_NS;
+        context->cue_entry_gap_ns = CUE_ENTRY_GAP_NS;
+        context->cluster_write_delay_ns = CLUSTER_WRITE_DELAY_NS;
         context->file_segment = make_unique<libmatroska::KaxSegment>();
     }
 
@@ -132,6 +135,68 @@ TEST_F(record_ut, new_cluster_out_of_order)
     ASSERT_EQ(context->pending_clusters.size(), 3u);
 }
 
+TEST_F(record_ut, new_clusters_custom_length)
+{
+    context->cluster_length_ns = 10_ms;
+
+    cluster_t *cluster1 = get_cluster_for_timestamp(context, 5_ms);
+    ASSERT_NE(cluster1, nullptr);
+    ASSERT_EQ(cluster1->time_start_ns, 0);
+    ASSERT_EQ(cluster1->time_end_ns, 10_ms);
+
+    // Clusters stay aligned to the cluster length when there is a gap in the data
+    cluster_t *cluster2 = get_cluster_for_timestamp(context, 35_ms);
+    ASSERT_NE(cluster2, nullptr);
+    ASSERT_EQ(cluster2->time_start_ns, 30_ms);
+    ASSERT_EQ(cluster2->time_end_ns, 40_ms);
+
+    ASSERT_EQ(context->pending_clusters.size(), 2u);
+}
+
+TEST_F(record_ut, create_with_settings)
+{
+    k4a_device_configuration_t record_config = {};
+    record_config.color_resolution = K4A_COLOR_RESOLUTION_OFF;
+    record_config.depth_mode = K4A_DEPTH_MODE_OFF;
+
+    k4a_record_t handle = NULL;
+    k4a_record_settings_t settings = K4A_RECORD_SETTINGS_INIT_DEFAULT;
+
+    // Block timestamps are relative to their cluster and stored in 16 bits
+    settings.cluster_length_usec = 32767;
+    ASSERT_EQ(k4a_record_create_with_settings("record_test_settings.mkv", NULL, record_config, &settings, &handle),
+              K4A_RESULT_FAILED);
+
+    // The write delay needs to cover 2 clusters
+    settings.cluster_length_usec = 20000;
+    settings.cluster_write_delay_usec = 39999;
+    ASSERT_EQ(k4a_record_create_with_settings("record_test_settings.mkv", NULL, record_config, &settings, &handle),
+              K4A_RESULT_FAILED);
+
+    // Unset values use the defaults
+    settings.cluster_write_delay_usec = 0;
+    settings.cue_gap_usec = 100000;
+    ASSERT_EQ(k4a_record_create_with_settings("record_test_settings.mkv", NULL, record_config, &settings, &handle),
+              K4A_RESULT_SUCCEEDED);
+    k4a_record_context_t *settings_context = k4a_record_t_get_context(handle);
+    ASSERT_NE(settings_context, nullptr);
+    ASSERT_EQ(settings_context->cluster_length_ns, 20_ms);
+    ASSERT_EQ(settings_context->cue_entry_gap_ns, 100_ms);
+    ASSERT_EQ(settings_context->cluster_write_delay_ns, CLUSTER_WRITE_DELAY_NS);
+    k4a_record_close(handle);
+
+    ASSERT_EQ(k4a_record_create_with_settings("record_test_settings.mkv", NULL, record_config, NULL, &handle),
+              K4A_RESULT_SUCCEEDED);
+    settings_context = k4a_record_t_get_context(handle);
+    ASSERT_NE(settings_context, nullptr);
+    ASSERT_EQ(settings_context->cluster_length_ns, MAX_CLUSTER_LENGTH_NS);
+    ASSERT_EQ(settings_context->cue_entry_gap_ns, CUE_ENTRY_GAP_NS);
+    ASSERT_EQ(settings_context->cluster_write_delay_ns, CLUSTER_WRITE_DELAY_NS);
+    k4a_record_close(handle);
+
+    ASSERT_EQ(std::remove("record_test_settings.mkv"), 0);
+}
+
 // This test's goal is to fill up the write queue by saturating disk write.
 // It should trigger the write speed warning message in the logs.
 // Since this test is unlikely to complete, and needs to be manually run, it is disabled.
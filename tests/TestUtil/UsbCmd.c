@@ -397,6 +397,26 @@ static void usb_cmd_stream_callback(k4a_result_t result, k4a_image_t image, void
     }
 }
 
+/**
+ *  Display the counters of the libusb event threads shared by all open devices
+ *
+ */
+static void usb_cmd_print_event_thread_stats(void)
+{
+    uint32_t thread_count = usb_cmd_get_event_thread_count();
+    for (uint32_t i = 0; i < thread_count; i++)
+    {
+        usb_cmd_event_thread_stats_t stats;
+        if (usb_cmd_get_event_thread_stats(i, &stats) == K4A_RESULT_SUCCEEDED)
+        {
+            printf("Event thread %u: events handled %llu, transfers completed %llu\n",
+                   i,
+                   (unsigned long long)stats.events_handled,
+                   (unsigned long long)stats.transfers_completed);
+        }
+    }
+}
+
 /**
  *  Command to read stream data from a device
  *
@@ -474,6 +494,7 @@ static CLI_STATUS usb_cmd_read_imu_stream(int Argc, char **Argv)
             fclose(p_file);
         }
         printf("IMU Stream stopped\n");
+        usb_cmd_print_event_thread_stats();
 
         // Send command to stop the IMU on the device
         if ((result = usb_cmd_write(handle, STOP_IMU_STREAM_CMD, NULL, 0, NULL, 0)) != K4A_RESULT_SUCCEEDED)
@@ -683,6 +704,7 @@ static CLI_STATUS usb_cmd_read_depth_stream(int Argc, char **Argv)
             usb_cmd_stream_stop(handle);
             fclose(p_file);
         }
+        usb_cmd_print_event_thread_stats();
 
         // Send command to stop the depth stream on the device
         if ((result = usb_cmd_write(handle, DEV_CMD_DEPTH_STREAM_STOP, NULL, 0, NULL, 0)) != K4A_RESULT_SUCCEEDED)
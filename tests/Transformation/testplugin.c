@@ -0,0 +1,235 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+// Stand-in for the depth engine plugin. The transform engine runs on the CPU and fills every output pixel with the
+// first pixel of the matching input, so that tests can drive the transform engine path of the transformation module
+// without a GPU. The depth engine is not implemented.
+
+#include "transformation_test_plugin_export.h"
+
+#include <k4ainternal/k4aplugin.h>
+#include <k4ainternal/transformation.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+// Time spent on each frame, so that submitted frames queue up behind the one being processed
+#define TEST_PLUGIN_PROCESS_FRAME_MS 2
+
+struct k4a_transform_engine_context_t
+{
+    size_t depth_pixels;
+    size_t color_pixels;
+};
+
+static void test_plugin_sleep_ms(int ms)
+{
+#ifdef _WIN32
+    Sleep((DWORD)ms);
+#else
+    struct timespec ts = { 0, ms * 1000000L };
+    nanosleep(&ts, NULL);
+#endif
+}
+
+static void test_plugin_fill(void *output, size_t output_size, const void *input, size_t pixel_size)
+{
+    for (size_t offset = 0; offset + pixel_size <= output_size; offset += pixel_size)
+    {
+        memcpy((uint8_t *)output + offset, input, pixel_size);
+    }
+}
+
+static k4a_depth_engine_result_code_t __stdcall de_create_and_initialize(k4a_depth_engine_context_t **context,
+                                                                         size_t cal_block_size_in_bytes,
+                                                                         void *cal_block,
+                                                                         k4a_depth_engine_mode_t mode,
+                                                                         k4a_depth_engine_input_type_t input_format,
+                                                                         void *camera_calibration,
+                                                                         k4a_processing_complete_cb_t *callback,
+                                                                         void *callback_context)
+{
+    (void)cal_block_size_in_bytes;
+    (void)cal_block;
+    (void)mode;
+    (void)input_format;
+    (void)camera_calibration;
+    (void)callback;
+    (void)callback_context;
+
+    *context = NULL;
+    return K4A_DEPTH_ENGINE_RESULT_FATAL_ERROR_INITIALIZE_ENGINE_FAILED;
+}
+
+static k4a_depth_engine_result_code_t __stdcall
+de_process_frame(k4a_depth_engine_context_t *context,
+                 void *input_frame,
+                 size_t input_frame_size,
+                 k4a_depth_engine_output_type_t output_type,
+                 void *output_frame,
+                 size_t output_frame_size,
+                 k4a_depth_engine_output_frame_info_t *output_frame_info,
+                 k4a_depth_engine_input_frame_info_t *input_frame_info)
+{
+    (void)context;
+    (void)input_frame;
+    (void)input_frame_size;
+    (void)output_type;
+    (void)output_frame;
+    (void)output_frame_size;
+    (void)output_frame_info;
+    (void)input_frame_info;
+
+    return K4A_DEPTH_ENGINE_RESULT_FATAL_ERROR_NULL_ENGINE_POINTER;
+}
+
+static size_t __stdcall de_get_output_frame_size(k4a_depth_engine_context_t *context)
+{
+    (void)context;
+    return 0;
+}
+
+static void __stdcall de_destroy(k4a_depth_engine_context_t **context)
+{
+    *context = NULL;
+}
+
+static k4a_depth_engine_result_code_t __stdcall te_create_and_initialize(k4a_transform_engine_context_t **context,
+                                                                         void *camera_calibration,
+                                                                         k4a_processing_complete_cb_t *callback,
+                                                                         void *callback_context)
+{
+    (void)callback;
+    (void)callback_context;
+
+    if (camera_calibration == NULL)
+    {
+        return K4A_DEPTH_ENGINE_RESULT_FATAL_ERROR_NULL_CAMERA_CALIBRATION_POINTER;
+    }
+
+    // The calibration is only valid during this call
+    const k4a_transform_engine_calibration_t *calibration = (const k4a_transform_engine_calibration_t *)
+        camera_calibration;
+    k4a_transform_engine_context_t *engine = (k4a_transform_engine_context_t *)malloc(sizeof(*engine));
+    if (engine == NULL)
+    {
+        return K4A_DEPTH_ENGINE_RESULT_FATAL_ERROR_GPU_OUT_OF_MEMORY;
+    }
+    engine->depth_pixels = (size_t)calibration->depth_camera_calibration.resolution_width *
+                           (size_t)calibration->depth_camera_calibration.resolution_height;
+    engine->color_pixels = (size_t)calibration->color_camera_calibration.resolution_width *
+                           (size_t)calibration->color_camera_calibration.resolution_height;
+
+    *context = engine;
+    return K4A_DEPTH_ENGINE_RESULT_SUCCEEDED;
+}
+
+static size_t __stdcall te_get_output_frame_size(k4a_transform_engine_context_t *context,
+                                                 k4a_transform_engine_type_t type)
+{
+    if (context == NULL)
+    {
+        return 0;
+    }
+
+    switch (type)
+    {
+    case K4A_TRANSFORM_ENGINE_TYPE_COLOR_TO_DEPTH:
+        return context->depth_pixels * 4;
+    case K4A_TRANSFORM_ENGINE_TYPE_DEPTH_TO_COLOR:
+    case K4A_TRANSFORM_ENGINE_TYPE_DEPTH_CUSTOM16_TO_COLOR:
+        return context->color_pixels * 2;
+    case K4A_TRANSFORM_ENGINE_TYPE_DEPTH_CUSTOM8_TO_COLOR:
+        return context->color_pixels;
+    }
+
+    return 0;
+}
+
+static k4a_depth_engine_result_code_t __stdcall te_process_frame(k4a_transform_engine_context_t *context,
+                                                                 k4a_transform_engine_type_t type,
+                                                                 k4a_transform_engine_interpolation_t interpolation,
+                                                                 uint32_t invalid_value,
+                                                                 const void *depth_frame,
+                                                                 size_t depth_frame_size,
+                                                                 const void *frame2,
+                                                                 size_t frame2_size,
+                                                                 void *output_frame,
+                                                                 size_t output_frame_size,
+                                                                 void *output_frame2,
+                                                                 size_t output_frame2_size)
+{
+    (void)interpolation;
+    (void)invalid_value;
+    (void)depth_frame_size;
+    (void)frame2_size;
+
+    if (context == NULL)
+    {
+        return K4A_DEPTH_ENGINE_RESULT_FATAL_ERROR_NULL_ENGINE_POINTER;
+    }
+    if (depth_frame == NULL || (type != K4A_TRANSFORM_ENGINE_TYPE_DEPTH_TO_COLOR && frame2 == NULL))
+    {
+        return K4A_DEPTH_ENGINE_RESULT_DATA_ERROR_NULL_INPUT_BUFFER;
+    }
+    if (output_frame == NULL)
+    {
+        return K4A_DEPTH_ENGINE_RESULT_DATA_ERROR_NULL_OUTPUT_BUFFER;
+    }
+
+    test_plugin_sleep_ms(TEST_PLUGIN_PROCESS_FRAME_MS);
+
+    switch (type)
+    {
+    case K4A_TRANSFORM_ENGINE_TYPE_COLOR_TO_DEPTH:
+        test_plugin_fill(output_frame, output_frame_size, frame2, 4);
+        break;
+    case K4A_TRANSFORM_ENGINE_TYPE_DEPTH_TO_COLOR:
+        test_plugin_fill(output_frame, output_frame_size, depth_frame, 2);
+        break;
+    case K4A_TRANSFORM_ENGINE_TYPE_DEPTH_CUSTOM8_TO_COLOR:
+    case K4A_TRANSFORM_ENGINE_TYPE_DEPTH_CUSTOM16_TO_COLOR:
+        if (output_frame2 == NULL)
+        {
+            return K4A_DEPTH_ENGINE_RESULT_DATA_ERROR_NULL_OUTPUT_BUFFER;
+        }
+        test_plugin_fill(output_frame, output_frame_size, depth_frame, 2);
+        test_plugin_fill(output_frame2,
+                         output_frame2_size,
+                         frame2,
+                         type == K4A_TRANSFORM_ENGINE_TYPE_DEPTH_CUSTOM8_TO_COLOR ? 1 : 2);
+        break;
+    }
+
+    return K4A_DEPTH_ENGINE_RESULT_SUCCEEDED;
+}
+
+static void __stdcall te_destroy(k4a_transform_engine_context_t **context)
+{
+    free(*context);
+    *context = NULL;
+}
+
+TRANSFORMATION_TEST_PLUGIN_EXPORT bool __cdecl k4a_register_plugin(k4a_plugin_t *plugin);
+
+TRANSFORMATION_TEST_PLUGIN_EXPORT bool __cdecl k4a_register_plugin(k4a_plugin_t *plugin)
+{
+    plugin->version.major = K4A_PLUGIN_VERSION;
+    plugin->version.minor = 0;
+    plugin->version.patch = 0;
+    plugin->depth_engine_create_and_initialize = de_create_and_initialize;
+    plugin->depth_engine_process_frame = de_process_frame;
+    plugin->depth_engine_get_output_frame_size = de_get_output_frame_size;
+    plugin->depth_engine_destroy = de_destroy;
+    plugin->transform_engine_create_and_initialize = te_create_and_initialize;
+    plugin->transform_engine_process_frame = te_process_frame;
+    plugin->transform_engine_get_output_frame_size = te_get_output_frame_size;
+    plugin->transform_engine_destroy = te_destroy;
+    return true;
+}
@@ -9,6 +9,11 @@
 #include <k4ainternal/transformation.h>
 #include <k4ainternal/common.h>
 #include <k4ainternal/image.h>
+#include <k4ainternal/capture.h>
+
+#include <algorithm>
+#include <map>
+#include <vector>
 
 using namespace testing;
 
@@ -676,6 +681,1011 @@ TEST_F(transformation_ut, transformation_all_image_functions_with_failure_cases)
     image_dec_ref(xyz_depth_image);
 }
 
+static k4a_transformation_image_descriptor_t make_descriptor(int width,
+                                                             int height,
+                                                             int bytes_per_pixel,
+                                                             k4a_image_format_t format)
+{
+    k4a_transformation_image_descriptor_t descriptor = { width, height, width * bytes_per_pixel, format };
+    return descriptor;
+}
+
+TEST_F(transformation_ut, transformation_depth_image_to_color_camera_custom_channels)
+{
+    k4a_transformation_t transformation_handle = transformation_create(&m_calibration, false);
+    ASSERT_NE(transformation_handle, (k4a_transformation_t)NULL);
+
+    int depth_width = m_calibration.depth_camera_calibration.resolution_width;
+    int depth_height = m_calibration.depth_camera_calibration.resolution_height;
+    int color_width = m_calibration.color_camera_calibration.resolution_width;
+    int color_height = m_calibration.color_camera_calibration.resolution_height;
+    size_t depth_pixels = (size_t)(depth_width * depth_height);
+    size_t color_pixels = (size_t)(color_width * color_height);
+
+    // Steps and holes in the depth image exercise occlusion handling and the replacement of invalid vertices
+    std::vector<uint16_t> depth(depth_pixels);
+    std::vector<uint8_t> labels(depth_pixels);
+    std::vector<uint16_t> confidence(depth_pixels);
+    std::vector<uint16_t> ir(depth_pixels);
+    for (int y = 0; y < depth_height; y++)
+    {
+        for (int x = 0; x < depth_width; x++)
+        {
+            size_t i = (size_t)(y * depth_width + x);
+            depth[i] = (x * 7 + y * 3) % 23 == 0 ? 0 : (uint16_t)(800 + (x % 50) * 10 + (y / 40) * 300);
+            labels[i] = (uint8_t)((x / 16 + y / 16) % 200);
+            confidence[i] = (uint16_t)(x * y);
+            ir[i] = (uint16_t)(x * 31 + y);
+        }
+    }
+
+    k4a_transformation_image_descriptor_t depth_descriptor = make_descriptor(depth_width,
+                                                                             depth_height,
+                                                                             2,
+                                                                             K4A_IMAGE_FORMAT_DEPTH16);
+    k4a_transformation_image_descriptor_t transformed_depth_descriptor = make_descriptor(color_width,
+                                                                                         color_height,
+                                                                                         2,
+                                                                                         K4A_IMAGE_FORMAT_DEPTH16);
+    k4a_transformation_image_descriptor_t custom_descriptors[3] = {
+        make_descriptor(depth_width, depth_height, 1, K4A_IMAGE_FORMAT_CUSTOM8),
+        make_descriptor(depth_width, depth_height, 2, K4A_IMAGE_FORMAT_CUSTOM16),
+        make_descriptor(depth_width, depth_height, 2, K4A_IMAGE_FORMAT_CUSTOM16),
+    };
+    k4a_transformation_image_descriptor_t transformed_descriptors[3] = {
+        make_descriptor(color_width, color_height, 1, K4A_IMAGE_FORMAT_CUSTOM8),
+        make_descriptor(color_width, color_height, 2, K4A_IMAGE_FORMAT_CUSTOM16),
+        make_descriptor(color_width, color_height, 2, K4A_IMAGE_FORMAT_CUSTOM16),
+    };
+    const uint8_t *custom_data[3] = { labels.data(),
+                                      (const uint8_t *)confidence.data(),
+                                      (const uint8_t *)ir.data() };
+    k4a_transformation_interpolation_type_t interpolation[3] = { K4A_TRANSFORMATION_INTERPOLATION_TYPE_NEAREST,
+                                                                 K4A_TRANSFORMATION_INTERPOLATION_TYPE_LINEAR,
+                                                                 K4A_TRANSFORMATION_INTERPOLATION_TYPE_NEAREST };
+    uint32_t invalid_value[3] = { 255, 0, 7 };
+
+    // Reference: one call per channel
+    std::vector<uint16_t> expected_depth(color_pixels);
+    std::vector<std::vector<uint8_t>> expected(3);
+    for (int c = 0; c < 3; c++)
+    {
+        expected[c].resize((size_t)transformed_descriptors[c].stride_bytes * (size_t)color_height);
+        ASSERT_EQ(transformation_depth_image_to_color_camera_custom(transformation_handle,
+                                                                    (const uint8_t *)depth.data(),
+                                                                    &depth_descriptor,
+                                                                    custom_data[c],
+                                                                    &custom_descriptors[c],
+                                                                    (uint8_t *)expected_depth.data(),
+                                                                    &transformed_depth_descriptor,
+                                                                    expected[c].data(),
+                                                                    &transformed_descriptors[c],
+                                                                    interpolation[c],
+                                                                    invalid_value[c]),
+                  K4A_RESULT_SUCCEEDED);
+    }
+
+    std::vector<uint16_t> transformed_depth(color_pixels);
+    std::vector<std::vector<uint8_t>> transformed(3);
+    k4a_transformation_custom_plane_t planes[3];
+    for (int c = 0; c < 3; c++)
+    {
+        transformed[c].resize(expected[c].size());
+        planes[c].custom_image_data = custom_data[c];
+        planes[c].custom_image_descriptor = &custom_descriptors[c];
+        planes[c].transformed_custom_image_data = transformed[c].data();
+        planes[c].transformed_custom_image_descriptor = &transformed_descriptors[c];
+        planes[c].interpolation_type = interpolation[c];
+        planes[c].invalid_custom_value = invalid_value[c];
+    }
+
+    ASSERT_EQ(transformation_depth_image_to_color_camera_channels(transformation_handle,
+                                                                  (const uint8_t *)depth.data(),
+                                                                  &depth_descriptor,
+                                                                  (uint8_t *)transformed_depth.data(),
+                                                                  &transformed_depth_descriptor,
+                                                                  planes,
+                                                                  3),
+              K4A_RESULT_SUCCEEDED);
+    ASSERT_TRUE(transformed_depth == expected_depth);
+    for (int c = 0; c < 3; c++)
+    {
+        ASSERT_TRUE(transformed[c] == expected[c]) << "channel " << c;
+    }
+
+    // Without custom planes only the depth image is written
+    std::fill(transformed_depth.begin(), transformed_depth.end(), (uint16_t)0);
+    ASSERT_EQ(transformation_depth_image_to_color_camera_channels(transformation_handle,
+                                                                  (const uint8_t *)depth.data(),
+                                                                  &depth_descriptor,
+                                                                  (uint8_t *)transformed_depth.data(),
+                                                                  &transformed_depth_descriptor,
+                                                                  NULL,
+                                                                  0),
+              K4A_RESULT_SUCCEEDED);
+    ASSERT_TRUE(transformed_depth == expected_depth);
+
+    // Every plane is validated
+    planes[2].custom_image_descriptor = &custom_descriptors[0];
+    ASSERT_EQ(transformation_depth_image_to_color_camera_channels(transformation_handle,
+                                                                  (const uint8_t *)depth.data(),
+                                                                  &depth_descriptor,
+                                                                  (uint8_t *)transformed_depth.data(),
+                                                                  &transformed_depth_descriptor,
+                                                                  planes,
+                                                                  3),
+              K4A_RESULT_FAILED);
+
+    transformation_destroy(transformation_handle);
+}
+
+TEST_F(transformation_ut, transformation_ir_image_to_color_camera)
+{
+    k4a_transformation_t transformation_handle = transformation_create(&m_calibration, false);
+    ASSERT_NE(transformation_handle, (k4a_transformation_t)NULL);
+
+    int depth_width = m_calibration.depth_camera_calibration.resolution_width;
+    int depth_height = m_calibration.depth_camera_calibration.resolution_height;
+    int color_width = m_calibration.color_camera_calibration.resolution_width;
+    int color_height = m_calibration.color_camera_calibration.resolution_height;
+    size_t depth_pixels = (size_t)(depth_width * depth_height);
+    size_t color_pixels = (size_t)(color_width * color_height);
+
+    std::vector<uint16_t> depth(depth_pixels);
+    std::vector<uint16_t> ir(depth_pixels);
+    for (int y = 0; y < depth_height; y++)
+    {
+        for (int x = 0; x < depth_width; x++)
+        {
+            size_t i = (size_t)(y * depth_width + x);
+            depth[i] = (x * 5 + y) % 19 == 0 ? 0 : (uint16_t)(900 + (x / 30) * 150 + y);
+            ir[i] = (uint16_t)(x * 97 + y * 13);
+        }
+    }
+
+    k4a_transformation_image_descriptor_t depth_descriptor = make_descriptor(depth_width,
+                                                                             depth_height,
+                                                                             2,
+                                                                             K4A_IMAGE_FORMAT_DEPTH16);
+    k4a_transformation_image_descriptor_t custom_descriptor = make_descriptor(depth_width,
+                                                                              depth_height,
+                                                                              2,
+                                                                              K4A_IMAGE_FORMAT_CUSTOM16);
+    k4a_transformation_image_descriptor_t ir_descriptor = make_descriptor(depth_width,
+                                                                          depth_height,
+                                                                          2,
+                                                                          K4A_IMAGE_FORMAT_IR16);
+    k4a_transformation_image_descriptor_t transformed_depth_descriptor = make_descriptor(color_width,
+                                                                                         color_height,
+                                                                                         2,
+                                                                                         K4A_IMAGE_FORMAT_DEPTH16);
+    k4a_transformation_image_descriptor_t transformed_custom_descriptor = make_descriptor(color_width,
+                                                                                          color_height,
+                                                                                          2,
+                                                                                          K4A_IMAGE_FORMAT_CUSTOM16);
+    k4a_transformation_image_descriptor_t transformed_ir_descriptor = make_descriptor(color_width,
+                                                                                      color_height,
+                                                                                      2,
+                                                                                      K4A_IMAGE_FORMAT_IR16);
+
+    // Reference: IR passed as a custom image
+    std::vector<uint16_t> expected_depth(color_pixels);
+    std::vector<uint16_t> expected_ir(color_pixels);
+    ASSERT_EQ(transformation_depth_image_to_color_camera_custom(transformation_handle,
+                                                                (const uint8_t *)depth.data(),
+                                                                &depth_descriptor,
+                                                                (const uint8_t *)ir.data(),
+                                                                &custom_descriptor,
+                                                                (uint8_t *)expected_depth.data(),
+                                                                &transformed_depth_descriptor,
+                                                                (uint8_t *)expected_ir.data(),
+                                                                &transformed_custom_descriptor,
+                                                                K4A_TRANSFORMATION_INTERPOLATION_TYPE_LINEAR,
+                                                                0),
+              K4A_RESULT_SUCCEEDED);
+
+    std::vector<uint16_t> transformed_depth(color_pixels);
+    std::vector<uint16_t> transformed_ir(color_pixels);
+    ASSERT_EQ(transformation_ir_image_to_color_camera(transformation_handle,
+                                                      (const uint8_t *)depth.data(),
+                                                      &depth_descriptor,
+                                                      (const uint8_t *)ir.data(),
+                                                      &ir_descriptor,
+                                                      (uint8_t *)transformed_ir.data(),
+                                                      &transformed_ir_descriptor,
+                                                      (uint8_t *)transformed_depth.data(),
+                                                      &transformed_depth_descriptor),
+              K4A_RESULT_SUCCEEDED);
+    ASSERT_TRUE(transformed_depth == expected_depth);
+    ASSERT_TRUE(transformed_ir == expected_ir);
+
+    // The registered depth image is optional
+    std::fill(transformed_ir.begin(), transformed_ir.end(), (uint16_t)0xffff);
+    ASSERT_EQ(transformation_ir_image_to_color_camera(transformation_handle,
+                                                      (const uint8_t *)depth.data(),
+                                                      &depth_descriptor,
+                                                      (const uint8_t *)ir.data(),
+                                                      &ir_descriptor,
+                                                      (uint8_t *)transformed_ir.data(),
+                                                      &transformed_ir_descriptor,
+                                                      NULL,
+                                                      NULL),
+              K4A_RESULT_SUCCEEDED);
+    ASSERT_TRUE(transformed_ir == expected_ir);
+
+    // The handle keeps its depth buffer, which is cleared again for the next call
+    std::fill(transformed_ir.begin(), transformed_ir.end(), (uint16_t)0xffff);
+    ASSERT_EQ(transformation_ir_image_to_color_camera(transformation_handle,
+                                                      (const uint8_t *)depth.data(),
+                                                      &depth_descriptor,
+                                                      (const uint8_t *)ir.data(),
+                                                      &ir_descriptor,
+                                                      (uint8_t *)transformed_ir.data(),
+                                                      &transformed_ir_descriptor,
+                                                      NULL,
+                                                      NULL),
+              K4A_RESULT_SUCCEEDED);
+    ASSERT_TRUE(transformed_ir == expected_ir);
+
+    // The IR images must be tagged as IR16
+    ASSERT_EQ(transformation_ir_image_to_color_camera(transformation_handle,
+                                                      (const uint8_t *)depth.data(),
+                                                      &depth_descriptor,
+                                                      (const uint8_t *)ir.data(),
+                                                      &custom_descriptor,
+                                                      (uint8_t *)transformed_ir.data(),
+                                                      &transformed_ir_descriptor,
+                                                      NULL,
+                                                      NULL),
+              K4A_RESULT_FAILED);
+
+    transformation_destroy(transformation_handle);
+}
+
+TEST_F(transformation_ut, transformation_depth_image_to_color_camera_incremental)
+{
+    k4a_transformation_t reference_handle = transformation_create(&m_calibration, false);
+    ASSERT_NE(reference_handle, (k4a_transformation_t)NULL);
+    k4a_transformation_t incremental_handle = transformation_create(&m_calibration, false);
+    ASSERT_NE(incremental_handle, (k4a_transformation_t)NULL);
+
+    ASSERT_EQ(transformation_set_incremental(incremental_handle, true, 1.5f), K4A_RESULT_FAILED);
+    ASSERT_EQ(transformation_set_incremental(incremental_handle, true, 0.25f), K4A_RESULT_SUCCEEDED);
+
+    int depth_width = m_calibration.depth_camera_calibration.resolution_width;
+    int depth_height = m_calibration.depth_camera_calibration.resolution_height;
+    int color_width = m_calibration.color_camera_calibration.resolution_width;
+    int color_height = m_calibration.color_camera_calibration.resolution_height;
+    size_t color_pixels = (size_t)(color_width * color_height);
+
+    k4a_transformation_image_descriptor_t depth_descriptor = make_descriptor(depth_width,
+                                                                             depth_height,
+                                                                             2,
+                                                                             K4A_IMAGE_FORMAT_DEPTH16);
+    k4a_transformation_image_descriptor_t transformed_depth_descriptor = make_descriptor(color_width,
+                                                                                         color_height,
+                                                                                         2,
+                                                                                         K4A_IMAGE_FORMAT_DEPTH16);
+
+    // A static background with a box in front of it that moves, disappears, and finally a scene that changes entirely
+    std::vector<uint16_t> background((size_t)(depth_width * depth_height));
+    for (int y = 0; y < depth_height; y++)
+    {
+        for (int x = 0; x < depth_width; x++)
+        {
+            background[(size_t)(y * depth_width + x)] = (x + y) % 37 == 0 ? 0 : (uint16_t)(2500 + x + 2 * y);
+        }
+    }
+
+    struct frame_t
+    {
+        int box_x;
+        int box_y;
+        uint16_t offset;
+    } frames[] = { { 100, 100, 0 }, { 100, 100, 0 }, { 110, 96, 0 }, { -1, -1, 0 }, { 40, 200, 0 }, { 40, 200, 300 } };
+
+    for (size_t f = 0; f < sizeof(frames) / sizeof(frames[0]); f++)
+    {
+        std::vector<uint16_t> depth = background;
+        for (size_t i = 0; i < depth.size(); i++)
+        {
+            depth[i] = depth[i] == 0 ? 0 : (uint16_t)(depth[i] + frames[f].offset);
+        }
+        for (int y = frames[f].box_y; frames[f].box_x >= 0 && y < frames[f].box_y + 60; y++)
+        {
+            for (int x = frames[f].box_x; x < frames[f].box_x + 80; x++)
+            {
+                depth[(size_t)(y * depth_width + x)] = (uint16_t)(900 + x % 7);
+            }
+        }
+
+        std::vector<uint16_t> expected(color_pixels);
+        std::vector<uint16_t> transformed(color_pixels, 0xffff);
+        ASSERT_EQ(transformation_depth_image_to_color_camera_custom(reference_handle,
+                                                                    (const uint8_t *)depth.data(),
+                                                                    &depth_descriptor,
+                                                                    NULL,
+                                                                    &depth_descriptor,
+                                                                    (uint8_t *)expected.data(),
+                                                                    &transformed_depth_descriptor,
+                                                                    NULL,
+                                                                    &transformed_depth_descriptor,
+                                                                    K4A_TRANSFORMATION_INTERPOLATION_TYPE_LINEAR,
+                                                                    0),
+                  K4A_RESULT_SUCCEEDED);
+        ASSERT_EQ(transformation_depth_image_to_color_camera_custom(incremental_handle,
+                                                                    (const uint8_t *)depth.data(),
+                                                                    &depth_descriptor,
+                                                                    NULL,
+                                                                    &depth_descriptor,
+                                                                    (uint8_t *)transformed.data(),
+                                                                    &transformed_depth_descriptor,
+                                                                    NULL,
+                                                                    &transformed_depth_descriptor,
+                                                                    K4A_TRANSFORMATION_INTERPOLATION_TYPE_LINEAR,
+                                                                    0),
+                  K4A_RESULT_SUCCEEDED);
+        ASSERT_TRUE(transformed == expected) << "frame " << f;
+    }
+
+    ASSERT_EQ(transformation_set_incremental(incremental_handle, false, 0.0f), K4A_RESULT_SUCCEEDED);
+
+    transformation_destroy(incremental_handle);
+    transformation_destroy(reference_handle);
+}
+
+TEST_F(transformation_ut, transformation_depth_image_to_mesh)
+{
+    k4a_transformation_t transformation_handle = transformation_create(&m_calibration, false);
+    ASSERT_NE(transformation_handle, (k4a_transformation_t)NULL);
+
+    int width = m_calibration.depth_camera_calibration.resolution_width;
+    int height = m_calibration.depth_camera_calibration.resolution_height;
+    size_t max_index_count = (size_t)((width - 1) * (height - 1) * 6);
+
+    // A slanted plane with a few holes, and a box in front of it
+    std::vector<uint16_t> depth((size_t)(width * height));
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            bool box = x >= width / 2 && x < width / 2 + 40 && y >= height / 2 && y < height / 2 + 40;
+            uint16_t plane = (x * 3 + y) % 101 == 0 ? 0 : (uint16_t)(2000 + x);
+            depth[(size_t)(y * width + x)] = box ? 1000 : plane;
+        }
+    }
+
+    k4a_transformation_image_descriptor_t depth_descriptor = make_descriptor(width,
+                                                                             height,
+                                                                             2,
+                                                                             K4A_IMAGE_FORMAT_DEPTH16);
+    k4a_transformation_image_descriptor_t xyz_descriptor = make_descriptor(width, height, 6, K4A_IMAGE_FORMAT_CUSTOM);
+    std::vector<int16_t> xyz((size_t)(width * height * 3));
+
+    // The required capacity is reported when there is no index buffer
+    size_t index_count = 0;
+    ASSERT_EQ(transformation_depth_image_to_mesh(transformation_handle,
+                                                 (const uint8_t *)depth.data(),
+                                                 &depth_descriptor,
+                                                 K4A_CALIBRATION_TYPE_DEPTH,
+                                                 K4A_TRANSFORMATION_MESH_DEFAULT_DISCONTINUITY_RATIO,
+                                                 (uint8_t *)xyz.data(),
+                                                 &xyz_descriptor,
+                                                 NULL,
+                                                 &index_count),
+              K4A_BUFFER_RESULT_TOO_SMALL);
+    ASSERT_EQ(index_count, max_index_count);
+
+    std::vector<uint32_t> indices(max_index_count);
+    ASSERT_EQ(transformation_depth_image_to_mesh(transformation_handle,
+                                                 (const uint8_t *)depth.data(),
+                                                 &depth_descriptor,
+                                                 K4A_CALIBRATION_TYPE_DEPTH,
+                                                 K4A_TRANSFORMATION_MESH_DEFAULT_DISCONTINUITY_RATIO,
+                                                 (uint8_t *)xyz.data(),
+                                                 &xyz_descriptor,
+                                                 indices.data(),
+                                                 &index_count),
+              K4A_BUFFER_RESULT_SUCCEEDED);
+    ASSERT_EQ(index_count % 3, 0u);
+    ASSERT_GT(index_count, 0u);
+    ASSERT_LT(index_count, max_index_count);
+
+    // Every triangle spans adjacent valid pixels of one surface, and the triangles are in row order
+    uint32_t previous_first = 0;
+    for (size_t t = 0; t < index_count; t += 3)
+    {
+        uint32_t first = indices[t];
+        uint16_t depth_min = UINT16_MAX;
+        uint16_t depth_max = 0;
+        for (size_t v = t; v < t + 3; v++)
+        {
+            ASSERT_LT(indices[v], (uint32_t)(width * height));
+            ASSERT_NE(depth[indices[v]], 0);
+            ASSERT_NE(xyz[indices[v] * 3 + 2], 0);
+            ASSERT_LE(abs((int)(indices[v] % (uint32_t)width) - (int)(first % (uint32_t)width)), 1);
+            ASSERT_LE(indices[v] / (uint32_t)width - first / (uint32_t)width, 1u);
+            depth_min = std::min(depth_min, depth[indices[v]]);
+            depth_max = std::max(depth_max, depth[indices[v]]);
+        }
+        ASSERT_LT(depth_max - depth_min, 100);
+        ASSERT_GE(first / (uint32_t)width, previous_first / (uint32_t)width);
+        previous_first = first;
+    }
+
+    // A fully valid block gives two triangles
+    uint32_t center = (uint32_t)((height / 4) * width + width / 4);
+    while (depth[center] == 0 || depth[center + 1] == 0 || depth[center + (uint32_t)width] == 0 ||
+           depth[center + (uint32_t)width + 1] == 0)
+    {
+        center++;
+    }
+    size_t center_triangles = 0;
+    for (size_t t = 0; t < index_count; t += 3)
+    {
+        center_triangles += indices[t] == center ? 1 : 0;
+    }
+    ASSERT_EQ(center_triangles, 2u);
+
+    // With a zero ratio only blocks of equal depth remain, which excludes the slanted plane
+    size_t flat_index_count = max_index_count;
+    ASSERT_EQ(transformation_depth_image_to_mesh(transformation_handle,
+                                                 (const uint8_t *)depth.data(),
+                                                 &depth_descriptor,
+                                                 K4A_CALIBRATION_TYPE_DEPTH,
+                                                 0.0f,
+                                                 (uint8_t *)xyz.data(),
+                                                 &xyz_descriptor,
+                                                 indices.data(),
+                                                 &flat_index_count),
+              K4A_BUFFER_RESULT_SUCCEEDED);
+    ASSERT_EQ(flat_index_count, (size_t)(39 * 39 * 6));
+
+    transformation_destroy(transformation_handle);
+}
+
+TEST_F(transformation_ut, transformation_depth_image_to_voxel_cloud)
+{
+    k4a_transformation_t transformation_handle = transformation_create(&m_calibration, false);
+    ASSERT_NE(transformation_handle, (k4a_transformation_t)NULL);
+
+    int width = m_calibration.depth_camera_calibration.resolution_width;
+    int height = m_calibration.depth_camera_calibration.resolution_height;
+    size_t pixels = (size_t)(width * height);
+
+    // Part of the scene lies beyond the far bound of the grid
+    std::vector<uint16_t> depth(pixels);
+    std::vector<uint8_t> color(pixels * 4);
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            size_t i = (size_t)(y * width + x);
+            depth[i] = (x + 2 * y) % 53 == 0 ? 0 : (uint16_t)(x < width / 8 ? 5000 : 1200 + 3 * x + y);
+            color[i * 4 + 0] = (uint8_t)x;
+            color[i * 4 + 1] = (uint8_t)y;
+            color[i * 4 + 2] = (uint8_t)(x ^ y);
+            color[i * 4 + 3] = 0xff;
+        }
+    }
+
+    k4a_transformation_image_descriptor_t depth_descriptor = make_descriptor(width,
+                                                                             height,
+                                                                             2,
+                                                                             K4A_IMAGE_FORMAT_DEPTH16);
+    k4a_transformation_image_descriptor_t color_descriptor = make_descriptor(width,
+                                                                             height,
+                                                                             4,
+                                                                             K4A_IMAGE_FORMAT_COLOR_BGRA32);
+    k4a_transformation_image_descriptor_t xyz_descriptor = make_descriptor(width, height, 6, K4A_IMAGE_FORMAT_CUSTOM);
+
+    k4a_voxel_grid_t grid;
+    grid.voxel_size = 50.0f;
+    grid.min_bounds.xyz.x = -3000.0f;
+    grid.min_bounds.xyz.y = -3000.0f;
+    grid.min_bounds.xyz.z = 0.0f;
+    grid.max_bounds.xyz.x = 3000.0f;
+    grid.max_bounds.xyz.y = 3000.0f;
+    grid.max_bounds.xyz.z = 4000.0f;
+
+    // Reference: bin the full point cloud
+    std::vector<int16_t> xyz(pixels * 3);
+    ASSERT_EQ(transformation_depth_image_to_point_cloud(transformation_handle,
+                                                        (const uint8_t *)depth.data(),
+                                                        &depth_descriptor,
+                                                        K4A_CALIBRATION_TYPE_DEPTH,
+                                                        (uint8_t *)xyz.data(),
+                                                        &xyz_descriptor),
+              K4A_RESULT_SUCCEEDED);
+
+    struct reference_voxel_t
+    {
+        int64_t position_sum[3];
+        uint32_t color_sum[4];
+        uint32_t count;
+    };
+    std::map<std::vector<int>, size_t> voxel_index;
+    std::vector<reference_voxel_t> expected;
+    float inverse_voxel_size = 1.0f / grid.voxel_size;
+    for (size_t i = 0; i < pixels; i++)
+    {
+        if (xyz[i * 3 + 2] == 0)
+        {
+            continue;
+        }
+        std::vector<int> cell(3);
+        bool inside = true;
+        for (int axis = 0; axis < 3; axis++)
+        {
+            float coordinate = (float)xyz[i * 3 + (size_t)axis];
+            inside = inside && coordinate >= grid.min_bounds.v[axis] && coordinate < grid.max_bounds.v[axis];
+            cell[(size_t)axis] = (int)floorf((coordinate - grid.min_bounds.v[axis]) * inverse_voxel_size);
+        }
+        if (!inside)
+        {
+            continue;
+        }
+        if (voxel_index.find(cell) == voxel_index.end())
+        {
+            voxel_index[cell] = expected.size();
+            expected.push_back(reference_voxel_t());
+            memset(&expected.back(), 0, sizeof(reference_voxel_t));
+        }
+        reference_voxel_t &voxel = expected[voxel_index[cell]];
+        for (int c = 0; c < 3; c++)
+        {
+            voxel.position_sum[c] += xyz[i * 3 + (size_t)c];
+        }
+        for (int c = 0; c < 4; c++)
+        {
+            voxel.color_sum[c] += color[i * 4 + (size_t)c];
+        }
+        voxel.count++;
+    }
+    ASSERT_GT(expected.size(), 100u);
+
+    size_t point_count = 0;
+    ASSERT_EQ(transformation_depth_image_to_voxel_cloud(transformation_handle,
+                                                        (const uint8_t *)depth.data(),
+                                                        &depth_descriptor,
+                                                        color.data(),
+                                                        &color_descriptor,
+                                                        K4A_CALIBRATION_TYPE_DEPTH,
+                                                        &grid,
+                                                        NULL,
+                                                        &point_count),
+              K4A_BUFFER_RESULT_TOO_SMALL);
+    ASSERT_EQ(point_count, pixels);
+
+    std::vector<k4a_voxel_point_t> points(point_count);
+    ASSERT_EQ(transformation_depth_image_to_voxel_cloud(transformation_handle,
+                                                        (const uint8_t *)depth.data(),
+                                                        &depth_descriptor,
+                                                        color.data(),
+                                                        &color_descriptor,
+                                                        K4A_CALIBRATION_TYPE_DEPTH,
+                                                        &grid,
+                                                        points.data(),
+                                                        &point_count),
+              K4A_BUFFER_RESULT_SUCCEEDED);
+    ASSERT_EQ(point_count, expected.size());
+    for (size_t v = 0; v < point_count; v++)
+    {
+        const reference_voxel_t &voxel = expected[v];
+        ASSERT_EQ(points[v].point_count, voxel.count) << "voxel " << v;
+        for (int c = 0; c < 3; c++)
+        {
+            ASSERT_EQ(points[v].position.v[c], (float)((double)voxel.position_sum[c] / (double)voxel.count));
+        }
+        for (int c = 0; c < 4; c++)
+        {
+            ASSERT_EQ(points[v].bgra[c], (uint8_t)((voxel.color_sum[c] + voxel.count / 2) / voxel.count));
+        }
+    }
+
+    // Without a color image the colors are left at 0
+    point_count = points.size();
+    ASSERT_EQ(transformation_depth_image_to_voxel_cloud(transformation_handle,
+                                                        (const uint8_t *)depth.data(),
+                                                        &depth_descriptor,
+                                                        NULL,
+                                                        NULL,
+                                                        K4A_CALIBRATION_TYPE_DEPTH,
+                                                        &grid,
+                                                        points.data(),
+                                                        &point_count),
+              K4A_BUFFER_RESULT_SUCCEEDED);
+    ASSERT_EQ(point_count, expected.size());
+    ASSERT_EQ(points[0].bgra[3], 0);
+
+    // A grid with fewer voxels than pixels bounds the capacity
+    grid.voxel_size = 1000.0f;
+    point_count = 0;
+    ASSERT_EQ(transformation_depth_image_to_voxel_cloud(transformation_handle,
+                                                        (const uint8_t *)depth.data(),
+                                                        &depth_descriptor,
+                                                        NULL,
+                                                        NULL,
+                                                        K4A_CALIBRATION_TYPE_DEPTH,
+                                                        &grid,
+                                                        NULL,
+                                                        &point_count),
+              K4A_BUFFER_RESULT_TOO_SMALL);
+    ASSERT_EQ(point_count, 6u * 6u * 4u);
+
+    grid.voxel_size = 0.0f;
+    ASSERT_EQ(transformation_depth_image_to_voxel_cloud(transformation_handle,
+                                                        (const uint8_t *)depth.data(),
+                                                        &depth_descriptor,
+                                                        NULL,
+                                                        NULL,
+                                                        K4A_CALIBRATION_TYPE_DEPTH,
+                                                        &grid,
+                                                        points.data(),
+                                                        &point_count),
+              K4A_BUFFER_RESULT_FAILED);
+
+    transformation_destroy(transformation_handle);
+}
+
+static k4a_capture_t create_pipeline_capture(const k4a_calibration_t *calibration, uint64_t timestamp_usec)
+{
+    int width = calibration->depth_camera_calibration.resolution_width;
+    int height = calibration->depth_camera_calibration.resolution_height;
+    k4a_image_t depth_image = NULL;
+    EXPECT_EQ(image_create(K4A_IMAGE_FORMAT_DEPTH16,
+                           width,
+                           height,
+                           width * (int)sizeof(uint16_t),
+                           ALLOCATION_SOURCE_USER,
+                           &depth_image),
+              K4A_RESULT_SUCCEEDED);
+
+    uint16_t *depth_image_buffer = (uint16_t *)(void *)image_get_buffer(depth_image);
+    for (int i = 0; i < width * height; i++)
+    {
+        depth_image_buffer[i] = (uint16_t)1000;
+    }
+    image_set_device_timestamp_usec(depth_image, timestamp_usec);
+
+    k4a_capture_t capture = NULL;
+    EXPECT_EQ(capture_create(&capture), K4A_RESULT_SUCCEEDED);
+    capture_set_depth_image(capture, depth_image);
+    image_dec_ref(depth_image);
+    return capture;
+}
+
+static double point_cloud_check_sum(k4a_image_t xyz_image)
+{
+    int16_t *xyz_image_buffer = (int16_t *)(void *)image_get_buffer(xyz_image);
+    int count = 3 * image_get_width_pixels(xyz_image) * image_get_height_pixels(xyz_image);
+    double check_sum = 0;
+    for (int i = 0; i < count; i++)
+    {
+        check_sum += (double)abs(xyz_image_buffer[i]);
+    }
+    return check_sum / (double)count;
+}
+
+TEST_F(transformation_ut, transformation_pipeline)
+{
+    k4a_transformation_t transformation_handle = transformation_create(&m_calibration, false);
+    ASSERT_NE(transformation_handle, (k4a_transformation_t)NULL);
+
+    k4a_transformation_pipeline_config_t config = {};
+    config.outputs = K4A_TRANSFORMATION_PIPELINE_OUTPUT_POINT_CLOUD |
+                     K4A_TRANSFORMATION_PIPELINE_OUTPUT_COLOR_POINT_CLOUD;
+    config.max_in_flight = 2;
+
+    k4a_transformation_pipeline_t pipeline = NULL;
+    ASSERT_EQ(transformation_pipeline_create(NULL, &config, &pipeline), K4A_RESULT_FAILED);
+    ASSERT_EQ(transformation_pipeline_create(transformation_handle, NULL, &pipeline), K4A_RESULT_FAILED);
+    config.outputs = 0x10;
+    ASSERT_EQ(transformation_pipeline_create(transformation_handle, &config, &pipeline), K4A_RESULT_FAILED);
+    config.outputs = K4A_TRANSFORMATION_PIPELINE_OUTPUT_POINT_CLOUD |
+                     K4A_TRANSFORMATION_PIPELINE_OUTPUT_COLOR_POINT_CLOUD;
+    ASSERT_EQ(transformation_pipeline_create(transformation_handle, &config, &pipeline), K4A_RESULT_SUCCEEDED);
+
+    // A capture without a depth image is rejected
+    k4a_capture_t empty_capture = NULL;
+    ASSERT_EQ(capture_create(&empty_capture), K4A_RESULT_SUCCEEDED);
+    ASSERT_EQ(transformation_pipeline_submit(pipeline, empty_capture, 0), K4A_WAIT_RESULT_FAILED);
+    capture_dec_ref(empty_capture);
+
+    k4a_transformation_pipeline_result_t result;
+    ASSERT_EQ(transformation_pipeline_get_result(pipeline, &result, 0), K4A_WAIT_RESULT_TIMEOUT);
+
+    // Both slots are held until their results are released, so a third capture can not be submitted
+    for (uint64_t timestamp = 1; timestamp <= 3; timestamp++)
+    {
+        k4a_capture_t capture = create_pipeline_capture(&m_calibration, timestamp);
+        ASSERT_EQ(transformation_pipeline_submit(pipeline, capture, 0),
+                  timestamp <= 2 ? K4A_WAIT_RESULT_SUCCEEDED : K4A_WAIT_RESULT_TIMEOUT);
+        capture_dec_ref(capture);
+    }
+
+    k4a_transformation_pipeline_result_t results[2];
+    for (uint64_t timestamp = 1; timestamp <= 2; timestamp++)
+    {
+        k4a_transformation_pipeline_result_t *r = &results[timestamp - 1];
+        ASSERT_EQ(transformation_pipeline_get_result(pipeline, r, 10000), K4A_WAIT_RESULT_SUCCEEDED);
+        ASSERT_EQ(r->result, K4A_RESULT_SUCCEEDED);
+        ASSERT_EQ(r->color_image_in_depth, (k4a_image_t)NULL);
+        ASSERT_NE(r->depth_image_in_color, (k4a_image_t)NULL);
+        ASSERT_NE(r->point_cloud, (k4a_image_t)NULL);
+        ASSERT_NE(r->color_point_cloud, (k4a_image_t)NULL);
+        ASSERT_EQ(image_get_device_timestamp_usec(r->point_cloud), timestamp);
+        ASSERT_GE(r->total_usec, r->depth_to_color_usec + r->point_cloud_usec);
+
+        // Same reference value as transformation_depth_image_to_point_cloud
+        const double reference_val = 562.20976003011071;
+        if (std::abs(point_cloud_check_sum(r->point_cloud) - reference_val) > 0.001)
+        {
+            ASSERT_EQ(point_cloud_check_sum(r->point_cloud), reference_val);
+        }
+    }
+
+    // Releasing a result recycles its output buffers
+    uint8_t *point_cloud_buffer = image_get_buffer(results[0].point_cloud);
+    transformation_pipeline_release_result(&results[0]);
+    ASSERT_EQ(results[0].point_cloud, (k4a_image_t)NULL);
+
+    k4a_capture_t capture = create_pipeline_capture(&m_calibration, 3);
+    ASSERT_EQ(transformation_pipeline_submit(pipeline, capture, 0), K4A_WAIT_RESULT_SUCCEEDED);
+    capture_dec_ref(capture);
+    ASSERT_EQ(transformation_pipeline_get_result(pipeline, &result, 10000), K4A_WAIT_RESULT_SUCCEEDED);
+    ASSERT_EQ(image_get_buffer(result.point_cloud), point_cloud_buffer);
+    ASSERT_EQ(image_get_device_timestamp_usec(result.point_cloud), 3u);
+    transformation_pipeline_release_result(&result);
+
+    // Output images stay valid after the pipeline is destroyed
+    transformation_pipeline_destroy(pipeline);
+    ASSERT_EQ(image_get_device_timestamp_usec(results[1].point_cloud), 2u);
+    transformation_pipeline_release_result(&results[1]);
+
+    transformation_destroy(transformation_handle);
+}
+
+static void pipeline_result_callback(void *context, const k4a_transformation_pipeline_result_t *result)
+{
+    std::vector<uint64_t> *timestamps = (std::vector<uint64_t> *)context;
+    ASSERT_EQ(result->result, K4A_RESULT_SUCCEEDED);
+    timestamps->push_back(image_get_device_timestamp_usec(result->point_cloud));
+}
+
+TEST_F(transformation_ut, transformation_pipeline_callback)
+{
+    k4a_transformation_t transformation_handle = transformation_create(&m_calibration, false);
+    ASSERT_NE(transformation_handle, (k4a_transformation_t)NULL);
+
+    std::vector<uint64_t> timestamps;
+    k4a_transformation_pipeline_config_t config = {};
+    config.outputs = K4A_TRANSFORMATION_PIPELINE_OUTPUT_POINT_CLOUD;
+    config.max_in_flight = 2;
+    config.callback = pipeline_result_callback;
+    config.callback_context = &timestamps;
+
+    k4a_transformation_pipeline_t pipeline = NULL;
+    ASSERT_EQ(transformation_pipeline_create(transformation_handle, &config, &pipeline), K4A_RESULT_SUCCEEDED);
+
+    k4a_transformation_pipeline_result_t result;
+    ASSERT_EQ(transformation_pipeline_get_result(pipeline, &result, 0), K4A_WAIT_RESULT_FAILED);
+
+    // More captures than slots; each submit waits for the callback to release a slot
+    const uint64_t capture_count = 10;
+    for (uint64_t timestamp = 1; timestamp <= capture_count; timestamp++)
+    {
+        k4a_capture_t capture = create_pipeline_capture(&m_calibration, timestamp);
+        ASSERT_EQ(transformation_pipeline_submit(pipeline, capture, 10000), K4A_WAIT_RESULT_SUCCEEDED);
+        capture_dec_ref(capture);
+    }
+
+    // Wait for the last results by filling every slot again
+    for (uint32_t i = 0; i < config.max_in_flight; i++)
+    {
+        k4a_capture_t capture = create_pipeline_capture(&m_calibration, capture_count + 1 + i);
+        ASSERT_EQ(transformation_pipeline_submit(pipeline, capture, 10000), K4A_WAIT_RESULT_SUCCEEDED);
+        capture_dec_ref(capture);
+    }
+
+    transformation_pipeline_destroy(pipeline);
+
+    ASSERT_GE(timestamps.size(), capture_count);
+    for (size_t i = 0; i < timestamps.size(); i++)
+    {
+        ASSERT_EQ(timestamps[i], i + 1);
+    }
+
+    transformation_destroy(transformation_handle);
+}
+
+static k4a_image_t create_point_cloud_request_images(const k4a_calibration_t *calibration,
+                                                      k4a_transformation_request_t *request)
+{
+    int width = calibration->depth_camera_calibration.resolution_width;
+    int height = calibration->depth_camera_calibration.resolution_height;
+
+    k4a_capture_t capture = create_pipeline_capture(calibration, 0);
+    k4a_image_t depth_image = capture_get_depth_image(capture);
+    capture_dec_ref(capture);
+
+    k4a_image_t xyz_image = NULL;
+    EXPECT_EQ(image_create(K4A_IMAGE_FORMAT_CUSTOM,
+                           width,
+                           height,
+                           width * 3 * (int)sizeof(int16_t),
+                           ALLOCATION_SOURCE_USER,
+                           &xyz_image),
+              K4A_RESULT_SUCCEEDED);
+
+    *request = {};
+    request->operation = K4A_TRANSFORMATION_OPERATION_DEPTH_IMAGE_TO_POINT_CLOUD;
+    request->depth_image = depth_image;
+    request->transformed_image = xyz_image;
+    request->camera = K4A_CALIBRATION_TYPE_DEPTH;
+    return depth_image;
+}
+
+TEST_F(transformation_ut, transformation_submit_wait)
+{
+    k4a_transformation_t transformation_handle = transformation_create(&m_calibration, false);
+    ASSERT_NE(transformation_handle, (k4a_transformation_t)NULL);
+
+    k4a_transformation_request_t request;
+    k4a_image_t depth_image = create_point_cloud_request_images(&m_calibration, &request);
+    k4a_image_t xyz_image = request.transformed_image;
+
+    k4a_transformation_ticket_t ticket = 0;
+    k4a_result_t result = K4A_RESULT_FAILED;
+    ASSERT_EQ(transformation_set_max_in_flight(transformation_handle, 0), K4A_RESULT_FAILED);
+    ASSERT_EQ(transformation_set_max_in_flight(transformation_handle, 33), K4A_RESULT_FAILED);
+    ASSERT_EQ(transformation_set_max_in_flight(transformation_handle, 1), K4A_RESULT_SUCCEEDED);
+    ASSERT_EQ(transformation_submit(transformation_handle, NULL, 0, &ticket), K4A_WAIT_RESULT_FAILED);
+    ASSERT_EQ(transformation_wait(transformation_handle, 1, 0, &result), K4A_WAIT_RESULT_FAILED);
+
+    // The images are referenced by the request, so they may be released right after submitting
+    ASSERT_EQ(transformation_submit(transformation_handle, &request, 0, &ticket), K4A_WAIT_RESULT_SUCCEEDED);
+    ASSERT_NE(ticket, 0u);
+    image_dec_ref(depth_image);
+
+    // The request is outstanding until it is waited for
+    k4a_transformation_ticket_t second_ticket = 0;
+    ASSERT_EQ(transformation_submit(transformation_handle, &request, 0, &second_ticket), K4A_WAIT_RESULT_TIMEOUT);
+
+    ASSERT_EQ(transformation_wait(transformation_handle, ticket, 10000, &result), K4A_WAIT_RESULT_SUCCEEDED);
+    ASSERT_EQ(result, K4A_RESULT_SUCCEEDED);
+    ASSERT_EQ(transformation_wait(transformation_handle, ticket, 0, &result), K4A_WAIT_RESULT_FAILED);
+
+    // Same reference value as transformation_depth_image_to_point_cloud
+    const double reference_val = 562.20976003011071;
+    if (std::abs(point_cloud_check_sum(xyz_image) - reference_val) > 0.001)
+    {
+        ASSERT_EQ(point_cloud_check_sum(xyz_image), reference_val);
+    }
+    image_dec_ref(xyz_image);
+
+    // Parameter errors are reported through the result
+    create_point_cloud_request_images(&m_calibration, &request);
+    request.camera = K4A_CALIBRATION_TYPE_NUM;
+    ASSERT_EQ(transformation_submit(transformation_handle, &request, 0, &ticket), K4A_WAIT_RESULT_SUCCEEDED);
+    ASSERT_EQ(transformation_wait(transformation_handle, ticket, 10000, &result), K4A_WAIT_RESULT_SUCCEEDED);
+    ASSERT_EQ(result, K4A_RESULT_FAILED);
+    image_dec_ref(request.depth_image);
+    image_dec_ref(request.transformed_image);
+
+    transformation_destroy(transformation_handle);
+}
+
+static void transformation_complete_callback(void *context, k4a_transformation_ticket_t ticket, k4a_result_t result)
+{
+    EXPECT_EQ(result, K4A_RESULT_SUCCEEDED);
+    std::vector<k4a_transformation_ticket_t> *tickets = (std::vector<k4a_transformation_ticket_t> *)context;
+    tickets->push_back(ticket);
+}
+
+TEST_F(transformation_ut, transformation_submit_callback)
+{
+    k4a_transformation_t transformation_handle = transformation_create(&m_calibration, false);
+    ASSERT_NE(transformation_handle, (k4a_transformation_t)NULL);
+    ASSERT_EQ(transformation_set_max_in_flight(transformation_handle, 2), K4A_RESULT_SUCCEEDED);
+
+    std::vector<k4a_transformation_ticket_t> submitted;
+    std::vector<k4a_transformation_ticket_t> completed;
+    const int request_count = 10;
+    for (int i = 0; i < request_count; i++)
+    {
+        k4a_transformation_request_t request;
+        create_point_cloud_request_images(&m_calibration, &request);
+        request.callback = transformation_complete_callback;
+        request.callback_context = &completed;
+
+        // Each submit waits for a callback to return once two requests are outstanding
+        k4a_transformation_ticket_t ticket = 0;
+        ASSERT_EQ(transformation_submit(transformation_handle, &request, 10000, &ticket), K4A_WAIT_RESULT_SUCCEEDED);
+        submitted.push_back(ticket);
+        image_dec_ref(request.depth_image);
+        image_dec_ref(request.transformed_image);
+
+        // Tickets of requests with a callback can not be waited for
+        k4a_result_t result;
+        ASSERT_EQ(transformation_wait(transformation_handle, ticket, 0, &result), K4A_WAIT_RESULT_FAILED);
+    }
+
+    // Destroying the transformation finishes the queued requests first
+    transformation_destroy(transformation_handle);
+
+    ASSERT_EQ(completed.size(), submitted.size());
+    for (size_t i = 0; i < completed.size(); i++)
+    {
+        ASSERT_EQ(completed[i], submitted[i]);
+    }
+}
+
+TEST_F(transformation_ut, transformation_auto_tuned)
+{
+    k4a_transformation_tuning_t tuning;
+
+    // Handles that are not auto tuned report their fixed backends
+    k4a_transformation_t transformation_handle = transformation_create(&m_calibration, false);
+    ASSERT_NE(transformation_handle, (k4a_transformation_t)NULL);
+    ASSERT_EQ(transformation_get_tuning(transformation_handle, NULL), K4A_RESULT_FAILED);
+    ASSERT_EQ(transformation_get_tuning(transformation_handle, &tuning), K4A_RESULT_SUCCEEDED);
+    ASSERT_FALSE(tuning.auto_tuned);
+    ASSERT_EQ(tuning.backend[K4A_TRANSFORMATION_OPERATION_DEPTH_IMAGE_TO_COLOR_CAMERA], K4A_TRANSFORMATION_BACKEND_CPU);
+    ASSERT_EQ(tuning.time_usec[K4A_TRANSFORMATION_OPERATION_DEPTH_IMAGE_TO_COLOR_CAMERA][K4A_TRANSFORMATION_BACKEND_CPU],
+              0u);
+    transformation_destroy(transformation_handle);
+
+    transformation_handle = transformation_create_auto_tuned(&m_calibration, false);
+    ASSERT_NE(transformation_handle, (k4a_transformation_t)NULL);
+    ASSERT_EQ(transformation_get_tuning(transformation_handle, &tuning), K4A_RESULT_SUCCEEDED);
+    ASSERT_TRUE(tuning.auto_tuned);
+
+    // Every operation was timed on the portable backend and routed to the fastest measured backend
+    for (int operation = 0; operation < K4A_TRANSFORMATION_OPERATION_COUNT; operation++)
+    {
+        ASSERT_NE(tuning.time_usec[operation][K4A_TRANSFORMATION_BACKEND_CPU], 0u);
+        ASSERT_EQ(tuning.time_usec[operation][K4A_TRANSFORMATION_BACKEND_GPU], 0u);
+        ASSERT_NE(tuning.backend[operation], K4A_TRANSFORMATION_BACKEND_GPU);
+        uint32_t selected_time = tuning.time_usec[operation][tuning.backend[operation]];
+        for (int backend = 0; backend < K4A_TRANSFORMATION_BACKEND_COUNT; backend++)
+        {
+            if (tuning.time_usec[operation][backend] != 0)
+            {
+                ASSERT_LE(selected_time, tuning.time_usec[operation][backend]);
+            }
+        }
+    }
+    ASSERT_EQ(tuning.time_usec[K4A_TRANSFORMATION_OPERATION_DEPTH_IMAGE_TO_COLOR_CAMERA]
+                              [K4A_TRANSFORMATION_BACKEND_CPU_SIMD],
+              0u);
+
+    // The selected backend produces the same point cloud
+    k4a_transformation_request_t request;
+    k4a_image_t depth_image = create_point_cloud_request_images(&m_calibration, &request);
+    k4a_image_t xyz_image = request.transformed_image;
+    k4a_transformation_image_descriptor_t depth_image_descriptor = image_get_descriptor(depth_image);
+    k4a_transformation_image_descriptor_t xyz_image_descriptor = image_get_descriptor(xyz_image);
+    ASSERT_EQ(transformation_depth_image_to_point_cloud(transformation_handle,
+                                                        image_get_buffer(depth_image),
+                                                        &depth_image_descriptor,
+                                                        K4A_CALIBRATION_TYPE_DEPTH,
+                                                        image_get_buffer(xyz_image),
+                                                        &xyz_image_descriptor),
+              K4A_RESULT_SUCCEEDED);
+
+    // Same reference value as transformation_depth_image_to_point_cloud
+    const double reference_val = 562.20976003011071;
+    if (std::abs(point_cloud_check_sum(xyz_image) - reference_val) > 0.001)
+    {
+        ASSERT_EQ(point_cloud_check_sum(xyz_image), reference_val);
+    }
+
+    image_dec_ref(depth_image);
+    image_dec_ref(xyz_image);
+    transformation_destroy(transformation_handle);
+}
+
 int main(int argc, char **argv)
 {
     return k4a_test_common_main(argc, argv);
@@ -0,0 +1,287 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+// Drives the transform engine path of the transformation module. The executable is built next to a stub depth engine
+// plugin (testplugin.c), which fills each output pixel with the first pixel of the matching input.
+
+#include <utcommon.h>
+#include <ut_calibration_data.h>
+
+// Module being tested
+#include <k4a/k4a.h>
+#include <k4ainternal/transformation.h>
+#include <k4ainternal/common.h>
+#include <k4ainternal/image.h>
+
+#include <azure_c_shared_utility/lock.h>
+#include <azure_c_shared_utility/threadapi.h>
+
+#include <map>
+#include <vector>
+
+using namespace testing;
+
+#define TEST_DEPTH_VALUE 1000
+
+class transformation_plugin_ut : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        k4a_result_t result = k4a_calibration_get_from_raw(g_test_json,
+                                                           sizeof(g_test_json),
+                                                           K4A_DEPTH_MODE_WFOV_2X2BINNED,
+                                                           K4A_COLOR_RESOLUTION_720P,
+                                                           &m_calibration);
+        ASSERT_EQ(result, K4A_RESULT_SUCCEEDED);
+    };
+
+    k4a_calibration_t m_calibration;
+};
+
+// Counts the image buffers that are released, so that a test can check that no request keeps its images
+typedef struct
+{
+    LOCK_HANDLE lock;
+    int released;
+} buffer_release_t;
+
+static void buffer_release_callback(void *buffer, void *context)
+{
+    buffer_release_t *release = (buffer_release_t *)context;
+    free(buffer);
+    if (release)
+    {
+        Lock(release->lock);
+        release->released++;
+        Unlock(release->lock);
+    }
+}
+
+static k4a_image_t create_depth16_image(int width, int height, uint16_t value, buffer_release_t *release)
+{
+    size_t size = (size_t)width * (size_t)height * sizeof(uint16_t);
+    uint16_t *buffer = (uint16_t *)malloc(size);
+    EXPECT_NE(buffer, (uint16_t *)NULL);
+    for (size_t i = 0; i < size / sizeof(uint16_t); i++)
+    {
+        buffer[i] = value;
+    }
+
+    k4a_image_t image = NULL;
+    EXPECT_EQ(image_create_from_buffer(K4A_IMAGE_FORMAT_DEPTH16,
+                                       width,
+                                       height,
+                                       width * (int)sizeof(uint16_t),
+                                       (uint8_t *)buffer,
+                                       size,
+                                       buffer_release_callback,
+                                       release,
+                                       &image),
+              K4A_RESULT_SUCCEEDED);
+    return image;
+}
+
+static void create_depth_to_color_request(const k4a_calibration_t *calibration,
+                                          uint16_t depth_value,
+                                          buffer_release_t *release,
+                                          k4a_transformation_request_t *request)
+{
+    *request = {};
+    request->operation = K4A_TRANSFORMATION_OPERATION_DEPTH_IMAGE_TO_COLOR_CAMERA;
+    request->depth_image = create_depth16_image(calibration->depth_camera_calibration.resolution_width,
+                                                calibration->depth_camera_calibration.resolution_height,
+                                                depth_value,
+                                                release);
+    request->transformed_image = create_depth16_image(calibration->color_camera_calibration.resolution_width,
+                                                      calibration->color_camera_calibration.resolution_height,
+                                                      0,
+                                                      release);
+}
+
+static bool image_filled_with(k4a_image_t image, uint16_t value)
+{
+    const uint16_t *pixels = (const uint16_t *)image_get_buffer(image);
+    size_t count = image_get_size(image) / sizeof(uint16_t);
+    for (size_t i = 0; i < count; i++)
+    {
+        if (pixels[i] != value)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+TEST_F(transformation_plugin_ut, engine_submit_wait)
+{
+    // Creating with GPU optimization fails if the plugin can not be loaded
+    k4a_transformation_t transformation_handle = transformation_create(&m_calibration, true);
+    ASSERT_NE(transformation_handle, (k4a_transformation_t)NULL);
+
+    k4a_transformation_tuning_t tuning;
+    ASSERT_EQ(transformation_get_tuning(transformation_handle, &tuning), K4A_RESULT_SUCCEEDED);
+    ASSERT_EQ(tuning.backend[K4A_TRANSFORMATION_OPERATION_DEPTH_IMAGE_TO_COLOR_CAMERA], K4A_TRANSFORMATION_BACKEND_GPU);
+
+    k4a_transformation_request_t request;
+    create_depth_to_color_request(&m_calibration, TEST_DEPTH_VALUE, NULL, &request);
+    k4a_image_t transformed_image = request.transformed_image;
+
+    k4a_transformation_ticket_t ticket = 0;
+    k4a_result_t result = K4A_RESULT_FAILED;
+    ASSERT_EQ(transformation_submit(transformation_handle, &request, 10000, &ticket), K4A_WAIT_RESULT_SUCCEEDED);
+    image_dec_ref(request.depth_image);
+    ASSERT_EQ(transformation_wait(transformation_handle, ticket, 10000, &result), K4A_WAIT_RESULT_SUCCEEDED);
+    ASSERT_EQ(result, K4A_RESULT_SUCCEEDED);
+    ASSERT_TRUE(image_filled_with(transformed_image, TEST_DEPTH_VALUE));
+
+    // An output image of the wrong size is rejected before it reaches the engine
+    k4a_image_t small_image = create_depth16_image(m_calibration.depth_camera_calibration.resolution_width,
+                                                   m_calibration.depth_camera_calibration.resolution_height,
+                                                   0,
+                                                   NULL);
+    create_depth_to_color_request(&m_calibration, TEST_DEPTH_VALUE, NULL, &request);
+    image_dec_ref(request.transformed_image);
+    request.transformed_image = small_image;
+    ASSERT_EQ(transformation_submit(transformation_handle, &request, 10000, &ticket), K4A_WAIT_RESULT_SUCCEEDED);
+    ASSERT_EQ(transformation_wait(transformation_handle, ticket, 10000, &result), K4A_WAIT_RESULT_SUCCEEDED);
+    ASSERT_EQ(result, K4A_RESULT_FAILED);
+    image_dec_ref(request.depth_image);
+    image_dec_ref(small_image);
+
+    image_dec_ref(transformed_image);
+    transformation_destroy(transformation_handle);
+}
+
+typedef struct
+{
+    k4a_transformation_t transformation_handle;
+    const k4a_calibration_t *calibration;
+    uint16_t depth_value;
+    int iterations;
+    int failures;
+} submitter_thread_t;
+
+static int submitter_thread(void *param)
+{
+    submitter_thread_t *submitter = (submitter_thread_t *)param;
+
+    for (int i = 0; i < submitter->iterations; i++)
+    {
+        k4a_transformation_request_t request;
+        create_depth_to_color_request(submitter->calibration, submitter->depth_value, NULL, &request);
+
+        k4a_transformation_ticket_t ticket = 0;
+        k4a_result_t result = K4A_RESULT_FAILED;
+        if (transformation_submit(submitter->transformation_handle, &request, 10000, &ticket) !=
+                K4A_WAIT_RESULT_SUCCEEDED ||
+            transformation_wait(submitter->transformation_handle, ticket, 10000, &result) !=
+                K4A_WAIT_RESULT_SUCCEEDED ||
+            K4A_FAILED(result) || !image_filled_with(request.transformed_image, submitter->depth_value))
+        {
+            submitter->failures++;
+        }
+
+        image_dec_ref(request.depth_image);
+        image_dec_ref(request.transformed_image);
+    }
+
+    return 0;
+}
+
+TEST_F(transformation_plugin_ut, engine_concurrent_submitters)
+{
+    k4a_transformation_t transformation_handle = transformation_create(&m_calibration, true);
+    ASSERT_NE(transformation_handle, (k4a_transformation_t)NULL);
+
+    // Fewer slots than threads, so submitters wait for slots while other threads wait for their results
+    ASSERT_EQ(transformation_set_max_in_flight(transformation_handle, 2), K4A_RESULT_SUCCEEDED);
+
+    const int thread_count = 4;
+    submitter_thread_t submitters[thread_count];
+    THREAD_HANDLE threads[thread_count];
+    for (int i = 0; i < thread_count; i++)
+    {
+        submitters[i].transformation_handle = transformation_handle;
+        submitters[i].calibration = &m_calibration;
+        submitters[i].depth_value = (uint16_t)(TEST_DEPTH_VALUE + i);
+        submitters[i].iterations = 8;
+        submitters[i].failures = 0;
+        ASSERT_EQ(ThreadAPI_Create(&threads[i], submitter_thread, &submitters[i]), THREADAPI_OK);
+    }
+
+    for (int i = 0; i < thread_count; i++)
+    {
+        int thread_result;
+        ASSERT_EQ(ThreadAPI_Join(threads[i], &thread_result), THREADAPI_OK);
+        ASSERT_EQ(submitters[i].failures, 0);
+    }
+
+    transformation_destroy(transformation_handle);
+}
+
+typedef struct
+{
+    LOCK_HANDLE lock;
+    std::map<k4a_transformation_ticket_t, int> calls;
+} completion_t;
+
+static void engine_complete_callback(void *context, k4a_transformation_ticket_t ticket, k4a_result_t result)
+{
+    // Destroy still runs the queued requests, a request only fails if the engine failed
+    (void)result;
+    completion_t *completion = (completion_t *)context;
+    Lock(completion->lock);
+    completion->calls[ticket]++;
+    Unlock(completion->lock);
+}
+
+TEST_F(transformation_plugin_ut, engine_destroy_in_flight)
+{
+    k4a_transformation_t transformation_handle = transformation_create(&m_calibration, true);
+    ASSERT_NE(transformation_handle, (k4a_transformation_t)NULL);
+    ASSERT_EQ(transformation_set_max_in_flight(transformation_handle, 32), K4A_RESULT_SUCCEEDED);
+
+    completion_t completion;
+    completion.lock = Lock_Init();
+    ASSERT_NE(completion.lock, (LOCK_HANDLE)NULL);
+    buffer_release_t release;
+    release.lock = Lock_Init();
+    release.released = 0;
+    ASSERT_NE(release.lock, (LOCK_HANDLE)NULL);
+
+    std::vector<k4a_transformation_ticket_t> submitted;
+    const int request_count = 24;
+    for (int i = 0; i < request_count; i++)
+    {
+        k4a_transformation_request_t request;
+        create_depth_to_color_request(&m_calibration, TEST_DEPTH_VALUE, &release, &request);
+        request.callback = engine_complete_callback;
+        request.callback_context = &completion;
+
+        k4a_transformation_ticket_t ticket = 0;
+        ASSERT_EQ(transformation_submit(transformation_handle, &request, 10000, &ticket), K4A_WAIT_RESULT_SUCCEEDED);
+        submitted.push_back(ticket);
+        image_dec_ref(request.depth_image);
+        image_dec_ref(request.transformed_image);
+    }
+
+    // The engine takes a few milliseconds per frame, so most requests are still queued when the handle is destroyed
+    transformation_destroy(transformation_handle);
+
+    // Every request completed exactly once before destroy returned, and released both of its images
+    ASSERT_EQ(completion.calls.size(), submitted.size());
+    for (size_t i = 0; i < submitted.size(); i++)
+    {
+        ASSERT_EQ(completion.calls[submitted[i]], 1);
+    }
+    ASSERT_EQ(release.released, request_count * 2);
+
+    Lock_Deinit(completion.lock);
+    Lock_Deinit(release.lock);
+}
+
+int main(int argc, char **argv)
+{
+    return k4a_test_common_main(argc, argv);
+}
@@ -12,6 +12,13 @@
 #include <azure_c_shared_utility/tickcounter.h>
 #include <azure_c_shared_utility/threadapi.h>
 
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
 int main(int argc, char **argv)
 {
     return k4a_test_common_main(argc, argv);
@@ -555,6 +562,391 @@ TEST(allocator_ut, manual_image_system_time)
     ASSERT_EQ(allocator_test_for_leaks(), 0);
 }
 
+TEST(allocator_ut, image_get_info)
+{
+    k4a_image_t image = NULL;
+    k4a_image_info_t info;
+
+    ASSERT_EQ(K4A_RESULT_FAILED, image_get_info(NULL, &info));
+    ASSERT_EQ(K4A_RESULT_SUCCEEDED,
+              image_create(K4A_IMAGE_FORMAT_COLOR_BGRA32, 10, 20, 48, ALLOCATION_SOURCE_USER, &image));
+    ASSERT_EQ(K4A_RESULT_FAILED, image_get_info(image, NULL));
+
+    image_set_device_timestamp_usec(image, 1234);
+    image_set_system_timestamp_nsec(image, 5678);
+    image_set_exposure_usec(image, 33000);
+    image_set_white_balance(image, 4500);
+    image_set_iso_speed(image, 800);
+
+    ASSERT_EQ(K4A_RESULT_SUCCEEDED, image_get_info(image, &info));
+    ASSERT_EQ(info.buffer, image_get_buffer(image));
+    ASSERT_EQ(info.size, image_get_size(image));
+    ASSERT_EQ(info.format, K4A_IMAGE_FORMAT_COLOR_BGRA32);
+    ASSERT_EQ(info.width_pixels, 10);
+    ASSERT_EQ(info.height_pixels, 20);
+    ASSERT_EQ(info.stride_bytes, 48);
+    ASSERT_EQ(info.device_timestamp_usec, 1234u);
+    ASSERT_EQ(info.system_timestamp_nsec, 5678u);
+    ASSERT_EQ(info.exposure_usec, 33000u);
+    ASSERT_EQ(info.white_balance, 4500u);
+    ASSERT_EQ(info.iso_speed, 800u);
+
+    image_dec_ref(image);
+    ASSERT_EQ(allocator_test_for_leaks(), 0);
+}
+
+TEST(allocator_ut, image_view)
+{
+    k4a_image_t parent = NULL;
+    k4a_image_t view = NULL;
+    k4a_image_t plane = NULL;
+
+    // 10x10 DEPTH16 with 4 bytes of padding per line
+    ASSERT_EQ(K4A_RESULT_SUCCEEDED,
+              image_create(K4A_IMAGE_FORMAT_DEPTH16, 10, 10, 24, ALLOCATION_SOURCE_USER, &parent));
+    image_set_device_timestamp_usec(parent, 1234);
+    uint8_t *parent_buffer = image_get_buffer(parent);
+
+    // Invalid arguments
+    ASSERT_EQ(K4A_RESULT_FAILED, image_create_view(NULL, K4A_IMAGE_FORMAT_DEPTH16, 4, 4, 0, 0, &view));
+    ASSERT_EQ(K4A_RESULT_FAILED, image_create_view(parent, K4A_IMAGE_FORMAT_DEPTH16, 4, 4, 0, 0, NULL));
+    ASSERT_EQ(K4A_RESULT_FAILED, image_create_view(parent, K4A_IMAGE_FORMAT_COLOR_MJPG, 4, 4, 0, 0, &view));
+    ASSERT_EQ(K4A_RESULT_FAILED, image_create_view(parent, K4A_IMAGE_FORMAT_DEPTH16, 0, 4, 0, 0, &view));
+    ASSERT_EQ(K4A_RESULT_FAILED, image_create_view(parent, K4A_IMAGE_FORMAT_DEPTH16, 4, 4, 7, 0, &view));
+    ASSERT_EQ(K4A_RESULT_FAILED, image_create_view(parent, K4A_IMAGE_FORMAT_DEPTH16, 13, 10, 0, 0, &view));
+    ASSERT_EQ(K4A_RESULT_FAILED, image_create_view(parent, K4A_IMAGE_FORMAT_DEPTH16, 10, 10, 0, 6, &view));
+    ASSERT_EQ(K4A_RESULT_FAILED, image_create_view(parent, K4A_IMAGE_FORMAT_DEPTH16, 1, 1, 0, 241, &view));
+
+    // Bottom right 4x4 corner, the last line only needs to cover its own pixels
+    size_t offset = 6 * 24 + 6 * 2;
+    ASSERT_EQ(K4A_RESULT_SUCCEEDED, image_create_view(parent, K4A_IMAGE_FORMAT_DEPTH16, 4, 4, 0, offset, &view));
+    ASSERT_EQ(parent_buffer + offset, image_get_buffer(view));
+    ASSERT_EQ((size_t)(3 * 24 + 4 * 2), image_get_size(view));
+    ASSERT_EQ(4, image_get_width_pixels(view));
+    ASSERT_EQ(4, image_get_height_pixels(view));
+    ASSERT_EQ(24, image_get_stride_bytes(view));
+    ASSERT_EQ(K4A_IMAGE_FORMAT_DEPTH16, image_get_format(view));
+    ASSERT_EQ((uint64_t)1234, image_get_device_timestamp_usec(view));
+
+    // The view keeps the parent buffer alive
+    image_dec_ref(parent);
+    parent_buffer[offset] = 0x5a;
+    ASSERT_EQ(0x5a, image_get_buffer(view)[0]);
+
+    // A view of a view references the original buffer
+    ASSERT_EQ(K4A_RESULT_SUCCEEDED, image_create_view(view, K4A_IMAGE_FORMAT_CUSTOM8, 2, 1, 0, 0, &plane));
+    ASSERT_EQ(parent_buffer + offset, image_get_buffer(plane));
+    image_dec_ref(view);
+    image_dec_ref(plane);
+    ASSERT_EQ(allocator_test_for_leaks(), 0);
+
+    // Y and UV planes of an NV12 image
+    ASSERT_EQ(K4A_RESULT_SUCCEEDED,
+              image_create(K4A_IMAGE_FORMAT_COLOR_NV12, 10, 10, 12, ALLOCATION_SOURCE_USER, &parent));
+    ASSERT_EQ(K4A_RESULT_SUCCEEDED, image_create_view(parent, K4A_IMAGE_FORMAT_CUSTOM8, 10, 10, 0, 0, &plane));
+    ASSERT_EQ(image_get_buffer(parent), image_get_buffer(plane));
+    image_dec_ref(plane);
+    ASSERT_EQ(K4A_RESULT_SUCCEEDED, image_create_view(parent, K4A_IMAGE_FORMAT_CUSTOM16, 5, 5, 0, 10 * 12, &plane));
+    ASSERT_EQ(image_get_buffer(parent) + 10 * 12, image_get_buffer(plane));
+    image_dec_ref(plane);
+    ASSERT_EQ(K4A_RESULT_SUCCEEDED, image_create_view(parent, K4A_IMAGE_FORMAT_COLOR_NV12, 10, 10, 0, 0, &view));
+    ASSERT_EQ(image_get_size(parent) - 2, image_get_size(view));
+    image_dec_ref(view);
+    image_dec_ref(parent);
+    ASSERT_EQ(allocator_test_for_leaks(), 0);
+}
+
+typedef struct _test_image_loader_t
+{
+    bool fail;
+    int load_count;
+    int release_count;
+} test_image_loader_t;
+
+static k4a_result_t test_image_load(void *context, k4a_image_t *image_handle)
+{
+    test_image_loader_t *loader = (test_image_loader_t *)context;
+    loader->load_count++;
+    if (loader->fail)
+    {
+        return K4A_RESULT_FAILED;
+    }
+    return image_create(K4A_IMAGE_FORMAT_DEPTH16, 4, 4, 8, ALLOCATION_SOURCE_USER, image_handle);
+}
+
+static void test_image_loader_release(void *context)
+{
+    ((test_image_loader_t *)context)->release_count++;
+}
+
+TEST(allocator_ut, capture_image_loader)
+{
+    k4a_capture_t capture = NULL;
+    k4a_image_t image = NULL;
+    test_image_loader_t depth_loader = { false, 0, 0 };
+    test_image_loader_t color_loader = { false, 0, 0 };
+    test_image_loader_t ir_loader = { true, 0, 0 };
+
+    ASSERT_EQ(K4A_RESULT_SUCCEEDED, capture_create(&capture));
+    ASSERT_EQ(K4A_RESULT_FAILED, capture_set_depth_image_loader(capture, NULL, NULL, NULL));
+
+    // The image is only produced on first access, and then kept by the capture
+    ASSERT_EQ(K4A_RESULT_SUCCEEDED,
+              capture_set_depth_image_loader(capture, test_image_load, test_image_loader_release, &depth_loader));
+    ASSERT_EQ(depth_loader.load_count, 0);
+    ASSERT_NE((image = capture_get_depth_image(capture)), (k4a_image_t)NULL);
+    ASSERT_EQ(image_get_width_pixels(image), 4);
+    image_dec_ref(image);
+    ASSERT_NE((image = capture_get_depth_image(capture)), (k4a_image_t)NULL);
+    image_dec_ref(image);
+    ASSERT_EQ(depth_loader.load_count, 1);
+    ASSERT_EQ(depth_loader.release_count, 1);
+
+    // Replacing an image that was never accessed releases the loader without loading
+    ASSERT_EQ(K4A_RESULT_SUCCEEDED,
+              capture_set_color_image_loader(capture, test_image_load, test_image_loader_release, &color_loader));
+    capture_set_color_image(capture, NULL);
+    ASSERT_EQ((image = capture_get_color_image(capture)), (k4a_image_t)NULL);
+    ASSERT_EQ(color_loader.load_count, 0);
+    ASSERT_EQ(color_loader.release_count, 1);
+
+    // A failed load leaves the capture without an image and is not retried
+    ASSERT_EQ(K4A_RESULT_SUCCEEDED,
+              capture_set_ir_image_loader(capture, test_image_load, test_image_loader_release, &ir_loader));
+    ASSERT_EQ((image = capture_get_ir_image(capture)), (k4a_image_t)NULL);
+    ASSERT_EQ((image = capture_get_ir_image(capture)), (k4a_image_t)NULL);
+    ASSERT_EQ(ir_loader.load_count, 1);
+    ASSERT_EQ(ir_loader.release_count, 1);
+
+    // The IMU image shares the IR slot, setting it releases the IR loader and getting it never runs a loader
+    ir_loader = { false, 0, 0 };
+    ASSERT_EQ(K4A_RESULT_SUCCEEDED,
+              capture_set_ir_image_loader(capture, test_image_load, test_image_loader_release, &ir_loader));
+    ASSERT_EQ((image = capture_get_imu_image(capture)), (k4a_image_t)NULL);
+    ASSERT_EQ(K4A_RESULT_SUCCEEDED, image_create(K4A_IMAGE_FORMAT_DEPTH16, 4, 4, 8, ALLOCATION_SOURCE_USER, &image));
+    capture_set_imu_image(capture, image);
+    image_dec_ref(image);
+    ASSERT_EQ(ir_loader.load_count, 0);
+    ASSERT_EQ(ir_loader.release_count, 1);
+    ASSERT_NE((image = capture_get_imu_image(capture)), (k4a_image_t)NULL);
+    ASSERT_EQ(image_get_width_pixels(image), 4);
+    image_dec_ref(image);
+    ASSERT_EQ(ir_loader.load_count, 0);
+    capture_set_imu_image(capture, NULL);
+
+    // Loaders still pending when the capture is destroyed are released
+    color_loader.release_count = 0;
+    ASSERT_EQ(K4A_RESULT_SUCCEEDED,
+              capture_set_color_image_loader(capture, test_image_load, test_image_loader_release, &color_loader));
+    capture_dec_ref(capture);
+    ASSERT_EQ(color_loader.load_count, 0);
+    ASSERT_EQ(color_loader.release_count, 1);
+    ASSERT_EQ(allocator_test_for_leaks(), 0);
+}
+
+TEST(allocator_ut, memory_limits)
+{
+    k4a_memory_usage_t usage;
+    k4a_image_t image1 = NULL;
+    k4a_image_t image2 = NULL;
+
+    // Soft limit may not exceed the hard limit
+    ASSERT_EQ(K4A_RESULT_FAILED, allocator_set_memory_limits(2000, 1000));
+    ASSERT_EQ(K4A_RESULT_SUCCEEDED, allocator_set_memory_limits(2000, 0));
+    ASSERT_EQ(K4A_RESULT_SUCCEEDED, allocator_set_memory_limits(0, 0));
+
+    allocator_get_memory_usage(&usage);
+    uint32_t color_dropped = usage.color_frames_dropped;
+    uint32_t depth_dropped = usage.depth_frames_dropped;
+    uint32_t user_refused = usage.user_allocations_refused;
+    ASSERT_EQ(usage.total_bytes, 0u);
+
+    // Bytes are accounted per source until the memory is freed
+    ASSERT_EQ(K4A_RESULT_SUCCEEDED,
+              image_create(K4A_IMAGE_FORMAT_DEPTH16, 10, 50, 20, ALLOCATION_SOURCE_DEPTH, &image1));
+    ASSERT_EQ(K4A_RESULT_SUCCEEDED,
+              image_create(K4A_IMAGE_FORMAT_CUSTOM8, 10, 50, 10, ALLOCATION_SOURCE_USER, &image2));
+    allocator_get_memory_usage(&usage);
+    ASSERT_EQ(usage.depth_bytes, 1000u);
+    ASSERT_EQ(usage.user_bytes, 500u);
+    ASSERT_EQ(usage.color_bytes, 0u);
+    ASSERT_EQ(usage.total_bytes, 1500u);
+    ASSERT_GE(usage.peak_total_bytes, 1500u);
+    image_dec_ref(image2);
+    allocator_get_memory_usage(&usage);
+    ASSERT_EQ(usage.user_bytes, 0u);
+    ASSERT_EQ(usage.total_bytes, 1000u);
+
+    // Nothing is dropped without limits
+    ASSERT_FALSE(allocator_should_drop(ALLOCATION_SOURCE_COLOR, 1000000));
+    ASSERT_FALSE(allocator_should_drop(ALLOCATION_SOURCE_DEPTH, 1000000));
+
+    // Above the soft limit color is dropped, depth is not
+    ASSERT_EQ(K4A_RESULT_SUCCEEDED, allocator_set_memory_limits(1200, 2000));
+    ASSERT_FALSE(allocator_should_drop(ALLOCATION_SOURCE_COLOR, 200));
+    ASSERT_TRUE(allocator_should_drop(ALLOCATION_SOURCE_COLOR, 201));
+    ASSERT_FALSE(allocator_should_drop(ALLOCATION_SOURCE_DEPTH, 1000));
+
+    // Above the hard limit depth is dropped and user allocations fail; IMU and USB are never dropped
+    ASSERT_TRUE(allocator_should_drop(ALLOCATION_SOURCE_DEPTH, 1001));
+    ASSERT_FALSE(allocator_should_drop(ALLOCATION_SOURCE_IMU, 1001));
+    ASSERT_FALSE(allocator_should_drop(ALLOCATION_SOURCE_USB_DEPTH, 1001));
+    ASSERT_EQ(K4A_RESULT_FAILED,
+              image_create(K4A_IMAGE_FORMAT_CUSTOM8, 1001, 1, 1001, ALLOCATION_SOURCE_USER, &image2));
+    ASSERT_EQ(image2, (k4a_image_t)NULL);
+    ASSERT_EQ(K4A_RESULT_SUCCEEDED,
+              image_create(K4A_IMAGE_FORMAT_CUSTOM8, 1000, 1, 1000, ALLOCATION_SOURCE_USER, &image2));
+    image_dec_ref(image2);
+
+    allocator_get_memory_usage(&usage);
+    ASSERT_EQ(usage.soft_limit_bytes, 1200u);
+    ASSERT_EQ(usage.hard_limit_bytes, 2000u);
+    ASSERT_EQ(usage.color_frames_dropped, color_dropped + 1);
+    ASSERT_EQ(usage.depth_frames_dropped, depth_dropped + 1);
+    ASSERT_EQ(usage.user_allocations_refused, user_refused + 1);
+
+    // Freeing memory brings the streams back
+    image_dec_ref(image1);
+    ASSERT_FALSE(allocator_should_drop(ALLOCATION_SOURCE_COLOR, 1200));
+    ASSERT_FALSE(allocator_should_drop(ALLOCATION_SOURCE_DEPTH, 2000));
+
+    ASSERT_EQ(K4A_RESULT_SUCCEEDED, allocator_set_memory_limits(0, 0));
+    allocator_get_memory_usage(&usage);
+    ASSERT_EQ(usage.total_bytes, 0u);
+    ASSERT_EQ(allocator_test_for_leaks(), 0);
+}
+
+// Reads the number of minor and major page faults taken by the process so far
+static void get_page_faults(uint64_t *minor_faults, uint64_t *major_faults)
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters = { 0 };
+    GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+    // Windows reports soft and hard faults together
+    *minor_faults = counters.PageFaultCount;
+    *major_faults = 0;
+#else
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    *minor_faults = (uint64_t)usage.ru_minflt;
+    *major_faults = (uint64_t)usage.ru_majflt;
+#endif
+}
+
+// Synthetic stream: every frame is allocated, written in full like a sensor would, and released once the next two
+// frames have arrived.
+static void stream_frames(allocation_source_t source, size_t frame_size, int frame_count)
+{
+    uint8_t *in_flight[3] = { NULL, NULL, NULL };
+    for (int i = 0; i < frame_count; i++)
+    {
+        uint8_t **slot = &in_flight[i % 3];
+        if (*slot)
+        {
+            allocator_free(*slot);
+        }
+        *slot = allocator_alloc(source, frame_size);
+        ASSERT_NE(*slot, (uint8_t *)NULL);
+        memset(*slot, i, frame_size);
+    }
+    for (int i = 0; i < 3; i++)
+    {
+        if (in_flight[i])
+        {
+            allocator_free(in_flight[i]);
+        }
+    }
+}
+
+static long g_counting_alloc_calls = 0;
+
+static uint8_t *counting_alloc(int size, void **context)
+{
+    g_counting_alloc_calls++;
+    *context = NULL;
+    return (uint8_t *)malloc((size_t)size);
+}
+
+static void counting_free(void *buffer, void *context)
+{
+    (void)context;
+    free(buffer);
+}
+
+TEST(allocator_ut, preallocated_buffers)
+{
+    const size_t frame_size = 4 * 1024 * 1024;
+    const int frame_count = 100;
+    uint64_t minor_start, major_start, minor_end, major_end;
+
+    ASSERT_EQ(K4A_RESULT_FAILED, allocator_pool_enable(ALLOCATION_SOURCE_DEPTH, frame_size, 0, false));
+    ASSERT_EQ(K4A_RESULT_FAILED,
+              allocator_pool_enable(ALLOCATION_SOURCE_DEPTH, frame_size, ALLOCATOR_POOL_MAX_BUFFERS + 1, false));
+    ASSERT_EQ(K4A_RESULT_FAILED, allocator_pool_prepare(ALLOCATION_SOURCE_DEPTH, 0));
+
+    // Preparing a source without a pool does nothing
+    ASSERT_EQ(K4A_RESULT_SUCCEEDED, allocator_pool_prepare(ALLOCATION_SOURCE_DEPTH, frame_size));
+
+    // Without a pool, for comparison
+    get_page_faults(&minor_start, &major_start);
+    stream_frames(ALLOCATION_SOURCE_DEPTH, frame_size, frame_count);
+    get_page_faults(&minor_end, &major_end);
+    uint64_t unpooled_minor_faults = minor_end - minor_start;
+
+    // A pool enabled without a size is not filled by the streaming path; frames fall back to the regular allocator
+    ASSERT_EQ(K4A_RESULT_SUCCEEDED, allocator_set_allocator(counting_alloc, counting_free));
+    ASSERT_EQ(K4A_RESULT_SUCCEEDED, allocator_pool_enable(ALLOCATION_SOURCE_DEPTH, 0, 4, false));
+    g_counting_alloc_calls = 0;
+    stream_frames(ALLOCATION_SOURCE_DEPTH, frame_size, 1);
+    ASSERT_EQ(g_counting_alloc_calls, 1);
+
+    // The pool is filled when the stream starts and knows its frame size
+    ASSERT_EQ(K4A_RESULT_SUCCEEDED, allocator_pool_prepare(ALLOCATION_SOURCE_DEPTH, frame_size));
+    ASSERT_EQ(g_counting_alloc_calls, 5);
+
+    g_counting_alloc_calls = 0;
+    get_page_faults(&minor_start, &major_start);
+    stream_frames(ALLOCATION_SOURCE_DEPTH, frame_size, frame_count);
+    get_page_faults(&minor_end, &major_end);
+    ASSERT_EQ(g_counting_alloc_calls, 0);
+    ASSERT_EQ(major_end - major_start, 0u);
+
+    // Each unpooled frame faults in all of its pages. Other activity in the process may still take a few faults.
+    ASSERT_GT(unpooled_minor_faults, (uint64_t)frame_count);
+    ASSERT_LT(minor_end - minor_start, unpooled_minor_faults / 10);
+
+    // Frames that don't fit, or that arrive while all pool buffers are in use, fall back to the regular allocator
+    uint8_t *frames[5];
+    for (int i = 0; i < 5; i++)
+    {
+        frames[i] = allocator_alloc(ALLOCATION_SOURCE_DEPTH, frame_size);
+        ASSERT_NE(frames[i], (uint8_t *)NULL);
+    }
+    ASSERT_EQ(g_counting_alloc_calls, 1);
+    uint8_t *large = allocator_alloc(ALLOCATION_SOURCE_DEPTH, frame_size + 1);
+    ASSERT_NE(large, (uint8_t *)NULL);
+    ASSERT_EQ(g_counting_alloc_calls, 2);
+    allocator_free(large);
+
+    // Disabling the pool while frames are held releases the buffers when the frames are freed
+    allocator_pool_disable(ALLOCATION_SOURCE_DEPTH);
+    for (int i = 0; i < 5; i++)
+    {
+        allocator_free(frames[i]);
+    }
+    ASSERT_EQ(K4A_RESULT_SUCCEEDED, allocator_set_allocator(NULL, NULL));
+
+    // Sized pools are filled when they are enabled
+    ASSERT_EQ(K4A_RESULT_SUCCEEDED, allocator_pool_enable(ALLOCATION_SOURCE_COLOR, frame_size, 3, false));
+    get_page_faults(&minor_start, &major_start);
+    stream_frames(ALLOCATION_SOURCE_COLOR, frame_size / 2, 10);
+    get_page_faults(&minor_end, &major_end);
+    ASSERT_LT(minor_end - minor_start, (uint64_t)frame_size / 2 / 4096);
+    allocator_pool_disable(ALLOCATION_SOURCE_COLOR);
+
+    ASSERT_EQ(allocator_test_for_leaks(), 0);
+}
+
 static int allocator_thread_adjust_ref(void *param)
 {
     allocator_thread_adjust_ref_data_t *data = (allocator_thread_adjust_ref_data_t *)param;
@@ -0,0 +1,105 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <utcommon.h>
+
+// Module being tested
+#include <k4ainternal/usbcommand.h>
+#include "usb_cmd_priv.h"
+
+#include <azure_c_shared_utility/threadapi.h>
+
+// Longer than the time an idle event thread waits in libusb before checking for a stop
+#define IDLE_WAIT_MS 1500
+
+class usbmanager_ut : public ::testing::Test
+{
+protected:
+    void TearDown() override
+    {
+        // Leave the default for other tests
+        usb_cmd_set_event_thread_count(USB_CMD_DEFAULT_EVENT_THREADS);
+    }
+};
+
+TEST_F(usbmanager_ut, start_stop)
+{
+    ASSERT_EQ(usb_cmd_set_event_thread_count(0), K4A_RESULT_FAILED);
+    ASSERT_EQ(usb_cmd_set_event_thread_count(USB_CMD_MAX_EVENT_THREADS + 1), K4A_RESULT_FAILED);
+    ASSERT_EQ(usb_cmd_set_event_thread_count(2), K4A_RESULT_SUCCEEDED);
+    ASSERT_EQ(usb_manager_acquire(NULL), K4A_RESULT_FAILED);
+
+    // Nothing runs until the shared context is acquired
+    ASSERT_EQ(usb_cmd_get_event_thread_count(), 0u);
+    ASSERT_EQ(usb_manager_set_log_level(LIBUSB_LOG_LEVEL_WARNING), K4A_RESULT_FAILED);
+
+    libusb_context *context = NULL;
+    if (K4A_FAILED(usb_manager_acquire(&context)))
+    {
+        GTEST_SKIP() << "libusb could not be initialized on this machine";
+    }
+    ASSERT_NE(context, (libusb_context *)NULL);
+    ASSERT_EQ(usb_cmd_get_event_thread_count(), 2u);
+    ASSERT_EQ(usb_manager_set_log_level(LIBUSB_LOG_LEVEL_WARNING), K4A_RESULT_SUCCEEDED);
+
+    // Later references share the context and its threads; a new count only applies to the next context
+    libusb_context *second_context = NULL;
+    ASSERT_EQ(usb_cmd_set_event_thread_count(3), K4A_RESULT_SUCCEEDED);
+    ASSERT_EQ(usb_manager_acquire(&second_context), K4A_RESULT_SUCCEEDED);
+    ASSERT_EQ(second_context, context);
+    ASSERT_EQ(usb_cmd_get_event_thread_count(), 2u);
+
+    usb_manager_release();
+    ASSERT_EQ(usb_cmd_get_event_thread_count(), 2u);
+
+    // The last reference stops the threads
+    usb_manager_release();
+    ASSERT_EQ(usb_cmd_get_event_thread_count(), 0u);
+
+    ASSERT_EQ(usb_manager_acquire(&context), K4A_RESULT_SUCCEEDED);
+    ASSERT_EQ(usb_cmd_get_event_thread_count(), 3u);
+    usb_manager_release();
+    ASSERT_EQ(usb_cmd_get_event_thread_count(), 0u);
+
+    // Counting devices takes and releases its own reference
+    uint32_t device_count = 0;
+    ASSERT_EQ(usb_cmd_get_device_count(&device_count), K4A_RESULT_SUCCEEDED);
+    ASSERT_EQ(usb_cmd_get_event_thread_count(), 0u);
+}
+
+TEST_F(usbmanager_ut, event_thread_stats)
+{
+    usb_cmd_event_thread_stats_t stats;
+    ASSERT_EQ(usb_cmd_set_event_thread_count(2), K4A_RESULT_SUCCEEDED);
+    ASSERT_EQ(usb_cmd_get_event_thread_stats(0, &stats), K4A_RESULT_FAILED);
+
+    libusb_context *context = NULL;
+    if (K4A_FAILED(usb_manager_acquire(&context)))
+    {
+        GTEST_SKIP() << "libusb could not be initialized on this machine";
+    }
+    ASSERT_EQ(usb_cmd_get_event_thread_stats(0, NULL), K4A_RESULT_FAILED);
+    ASSERT_EQ(usb_cmd_get_event_thread_stats(2, &stats), K4A_RESULT_FAILED);
+
+    // No transfers are submitted, so the idle timeouts of the event threads are not counted as handled events
+    ThreadAPI_Sleep(IDLE_WAIT_MS);
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        ASSERT_EQ(usb_cmd_get_event_thread_stats(i, &stats), K4A_RESULT_SUCCEEDED);
+        ASSERT_EQ(stats.events_handled, 0u);
+        ASSERT_EQ(stats.transfers_completed, 0u);
+    }
+
+    // Transfers completing on other threads are not counted
+    usb_manager_transfer_completed();
+    ASSERT_EQ(usb_cmd_get_event_thread_stats(0, &stats), K4A_RESULT_SUCCEEDED);
+    ASSERT_EQ(stats.transfers_completed, 0u);
+
+    usb_manager_release();
+    ASSERT_EQ(usb_cmd_get_event_thread_stats(0, &stats), K4A_RESULT_FAILED);
+}
+
+int main(int argc, char **argv)
+{
+    return k4a_test_common_main(argc, argv);
+}
@@ -235,6 +235,47 @@ TEST_F(multidevice_ft, open_close_two)
     m_device2 = NULL;
 }
 
+TEST_F(multidevice_ft, open_multiple)
+{
+    ASSERT_LE((uint32_t)2, k4a_device_get_installed_count());
+
+    uint32_t indices[] = { 0, 1 };
+    k4a_device_t devices[2] = { NULL, NULL };
+    k4a_result_t results[2] = { K4A_RESULT_FAILED, K4A_RESULT_FAILED };
+    k4a_device_open_timing_t timings[2];
+    ASSERT_EQ(K4A_RESULT_SUCCEEDED, k4a_device_open_multiple(indices, 2, devices, results, timings));
+    m_device1 = devices[0];
+    m_device2 = devices[1];
+    ASSERT_NE(m_device1, m_device2);
+
+    for (int i = 0; i < 2; i++)
+    {
+        ASSERT_EQ(K4A_RESULT_SUCCEEDED, results[i]);
+        ASSERT_LE(timings[i].depth_mcu_ms + timings[i].imu_ms, timings[i].total_ms);
+        printf("Device %d opened in %lldms (depth mcu %lldms, color mcu %lldms, calibration %lldms, depth %lldms, "
+               "color %lldms, imu %lldms)\n",
+               i,
+               LLD(timings[i].total_ms),
+               LLD(timings[i].depth_mcu_ms),
+               LLD(timings[i].color_mcu_ms),
+               LLD(timings[i].calibration_ms),
+               LLD(timings[i].depth_ms),
+               LLD(timings[i].color_ms),
+               LLD(timings[i].imu_ms));
+    }
+
+    // The devices are already open, so opening them again fails for both
+    ASSERT_EQ(K4A_RESULT_FAILED, k4a_device_open_multiple(indices, 2, devices, results, NULL));
+    ASSERT_EQ(K4A_RESULT_FAILED, results[0]);
+    ASSERT_EQ(K4A_RESULT_FAILED, results[1]);
+    ASSERT_EQ((k4a_device_t)NULL, devices[0]);
+
+    k4a_device_close(m_device1);
+    m_device1 = NULL;
+    k4a_device_close(m_device2);
+    m_device2 = NULL;
+}
+
 TEST_F(multidevice_ft, stream_two_1_then_2)
 {
     k4a_device_configuration_t config = K4A_DEVICE_CONFIG_INIT_DISABLE_ALL;
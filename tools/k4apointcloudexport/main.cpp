@@ -0,0 +1,639 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <k4a/k4a.h>
+#include <k4arecord/playback.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <direct.h>
+#endif
+
+// Size of the stdio buffer used for the chunked output file
+#define OUTPUT_BUFFER_SIZE (8 * 1024 * 1024)
+
+// Magic numbers of the chunked point cloud format, see README.md
+static const char k4apc_file_magic[8] = { 'K', '4', 'A', 'P', 'C', 'L', 'D', '1' };
+static const uint32_t k4apc_frame_magic = 0x4D415246; // "FRAM"
+static const uint32_t k4apc_flag_color = 0x1;
+
+enum class output_format
+{
+    ply,
+    k4apc,
+};
+
+struct export_options
+{
+    std::string input_path;
+    std::string output_path;
+    output_format format = output_format::ply;
+    bool with_color = false;
+    uint32_t worker_count = 0;
+};
+
+// A capture read from the recording, waiting for a worker
+struct export_job
+{
+    uint32_t frame_index;
+    k4a_capture_t capture;
+};
+
+// A frame that was converted by a worker, waiting to be written in order
+struct export_result
+{
+    uint64_t point_count = 0;
+    std::vector<uint8_t> data;
+    size_t offset = 0; // Where the output starts in data
+
+    const uint8_t *bytes() const
+    {
+        return data.data() + offset;
+    }
+
+    size_t size() const
+    {
+        return data.size() - offset;
+    }
+};
+
+class export_queue
+{
+public:
+    explicit export_queue(size_t capacity) : m_capacity(capacity) {}
+
+    void push(const export_job &job)
+    {
+        std::unique_lock<std::mutex> lock(m_lock);
+        m_not_full.wait(lock, [this] { return m_jobs.size() < m_capacity; });
+        m_jobs.push_back(job);
+        m_not_empty.notify_one();
+    }
+
+    // Returns false once the queue is closed and empty
+    bool pop(export_job *job)
+    {
+        std::unique_lock<std::mutex> lock(m_lock);
+        m_not_empty.wait(lock, [this] { return !m_jobs.empty() || m_closed; });
+        if (m_jobs.empty())
+        {
+            return false;
+        }
+        *job = m_jobs.front();
+        m_jobs.pop_front();
+        m_not_full.notify_one();
+        return true;
+    }
+
+    void close()
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_closed = true;
+        m_not_empty.notify_all();
+    }
+
+private:
+    std::mutex m_lock;
+    std::condition_variable m_not_empty;
+    std::condition_variable m_not_full;
+    std::deque<export_job> m_jobs;
+    size_t m_capacity;
+    bool m_closed = false;
+};
+
+// Writes converted frames to the chunked output file in frame order, whatever order the workers finish in
+class ordered_writer
+{
+public:
+    explicit ordered_writer(FILE *file) : m_file(file) {}
+
+    bool write(uint32_t frame_index, export_result &&result)
+    {
+        std::unique_lock<std::mutex> lock(m_lock);
+        m_pending.emplace(frame_index, std::move(result));
+        if (m_writing)
+        {
+            // The thread that is writing picks this frame up when its turn comes
+            return !m_failed;
+        }
+
+        m_writing = true;
+        while (!m_failed && !m_pending.empty() && m_pending.begin()->first == m_next_frame)
+        {
+            export_result next = std::move(m_pending.begin()->second);
+            m_pending.erase(m_pending.begin());
+            m_next_frame++;
+
+            // Other workers can queue their frames while this one is being written
+            lock.unlock();
+            bool written = fwrite(next.bytes(), 1, next.size(), m_file) == next.size();
+            lock.lock();
+            m_failed = m_failed || !written;
+        }
+        m_writing = false;
+        return !m_failed;
+    }
+
+    // Frames that failed to convert still take their place in the order
+    bool skip(uint32_t frame_index)
+    {
+        return write(frame_index, export_result());
+    }
+
+private:
+    std::mutex m_lock;
+    FILE *m_file;
+    std::map<uint32_t, export_result> m_pending;
+    uint32_t m_next_frame = 0;
+    bool m_writing = false;
+    bool m_failed = false;
+};
+
+struct export_stats
+{
+    std::atomic<uint64_t> frames_written{ 0 };
+    std::atomic<uint64_t> frames_skipped{ 0 };
+    std::atomic<uint64_t> points_written{ 0 };
+    std::atomic<uint64_t> bytes_written{ 0 };
+    std::atomic<bool> failed{ false };
+};
+
+static void print_usage()
+{
+    std::cout << "k4apointcloudexport - Azure Kinect point cloud export tool" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Usage: k4apointcloudexport [options] <input.mkv> <output>" << std::endl;
+    std::cout << std::endl;
+    std::cout << "  -h, --help              Prints this help" << std::endl;
+    std::cout << "  -f, --format ply|k4apc  Output format (default: ply)" << std::endl;
+    std::cout << "                          ply writes one binary PLY file per frame into the <output> directory."
+              << std::endl;
+    std::cout << "                          k4apc writes every frame into the single chunked file <output>."
+              << std::endl;
+    std::cout << "  -c, --color             Register the color camera to each point" << std::endl;
+    std::cout << "  -t, --threads N         Number of worker threads (default: number of processors)" << std::endl;
+}
+
+static bool parse_arguments(int argc, char **argv, export_options *options)
+{
+    std::vector<std::string> positional;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "-h" || arg == "--help")
+        {
+            return false;
+        }
+        else if (arg == "-c" || arg == "--color")
+        {
+            options->with_color = true;
+        }
+        else if ((arg == "-f" || arg == "--format") && i + 1 < argc)
+        {
+            std::string format = argv[++i];
+            if (format == "ply")
+            {
+                options->format = output_format::ply;
+            }
+            else if (format == "k4apc")
+            {
+                options->format = output_format::k4apc;
+            }
+            else
+            {
+                std::cerr << "Unknown output format: " << format << std::endl;
+                return false;
+            }
+        }
+        else if ((arg == "-t" || arg == "--threads") && i + 1 < argc)
+        {
+            int worker_count = atoi(argv[++i]);
+            if (worker_count < 1)
+            {
+                std::cerr << "Thread count must be at least 1" << std::endl;
+                return false;
+            }
+            options->worker_count = (uint32_t)worker_count;
+        }
+        else if (!arg.empty() && arg[0] == '-')
+        {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            return false;
+        }
+        else
+        {
+            positional.push_back(arg);
+        }
+    }
+
+    if (positional.size() != 2)
+    {
+        return false;
+    }
+    options->input_path = positional[0];
+    options->output_path = positional[1];
+    if (options->worker_count == 0)
+    {
+        options->worker_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+    return true;
+}
+
+template<typename T> static void append_value(std::vector<uint8_t> &data, const T &value)
+{
+    const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&value);
+    data.insert(data.end(), bytes, bytes + sizeof(T));
+}
+
+// Packs the valid points of a frame as int16 millimeters, followed by RGB if a color image is given.
+static uint64_t pack_points(const int16_t *xyz, const uint8_t *bgra, size_t pixel_count, uint8_t *out)
+{
+    uint64_t point_count = 0;
+    for (size_t i = 0; i < pixel_count; i++)
+    {
+        if (xyz[3 * i + 2] == 0)
+        {
+            continue;
+        }
+
+        memcpy(out, &xyz[3 * i], 3 * sizeof(int16_t));
+        out += 3 * sizeof(int16_t);
+        if (bgra != NULL)
+        {
+            out[0] = bgra[4 * i + 2];
+            out[1] = bgra[4 * i + 1];
+            out[2] = bgra[4 * i + 0];
+            out += 3;
+        }
+        point_count++;
+    }
+    return point_count;
+}
+
+static std::string ply_header(uint64_t point_count, bool with_color)
+{
+    std::string header = "ply\nformat binary_little_endian 1.0\nelement vertex " + std::to_string(point_count) +
+                         "\nproperty short x\nproperty short y\nproperty short z\n";
+    if (with_color)
+    {
+        header += "property uchar red\nproperty uchar green\nproperty uchar blue\n";
+    }
+    return header + "end_header\n";
+}
+
+// Creates the directory the PLY files are written to, if it does not exist yet
+static bool create_output_directory(const std::string &path)
+{
+#ifdef _WIN32
+    int result = _mkdir(path.c_str());
+#else
+    int result = mkdir(path.c_str(), 0755);
+#endif
+    if (result != 0 && errno != EEXIST)
+    {
+        return false;
+    }
+
+    struct stat info;
+    return stat(path.c_str(), &info) == 0 && (info.st_mode & S_IFMT) == S_IFDIR;
+}
+
+static bool write_file(const std::string &path, const export_result &result)
+{
+    FILE *file = fopen(path.c_str(), "wb");
+    if (file == NULL)
+    {
+        return false;
+    }
+
+    // The frame is written with a single call, so no stream buffering is needed
+    setvbuf(file, NULL, _IONBF, 0);
+    bool written = fwrite(result.bytes(), 1, result.size(), file) == result.size();
+    return fclose(file) == 0 && written;
+}
+
+// Converts one capture into the bytes of its output file or chunk. Returns false if the frame has to be skipped.
+static bool convert_frame(const export_options &options,
+                          k4a_transformation_t transformation,
+                          k4a_capture_t capture,
+                          k4a_image_t xyz_image,
+                          k4a_image_t color_in_depth_image,
+                          export_result *result)
+{
+    k4a_image_t depth_image = k4a_capture_get_depth_image(capture);
+    if (depth_image == NULL)
+    {
+        return false;
+    }
+
+    bool converted = k4a_transformation_depth_image_to_point_cloud(transformation,
+                                                                  depth_image,
+                                                                  K4A_CALIBRATION_TYPE_DEPTH,
+                                                                  xyz_image) == K4A_RESULT_SUCCEEDED;
+
+    k4a_image_t color_image = NULL;
+    if (converted && options.with_color)
+    {
+        color_image = k4a_capture_get_color_image(capture);
+        converted = color_image != NULL &&
+                    k4a_transformation_color_image_to_depth_camera(transformation,
+                                                                   depth_image,
+                                                                   color_image,
+                                                                   color_in_depth_image) == K4A_RESULT_SUCCEEDED;
+    }
+
+    if (converted)
+    {
+        size_t pixel_count = (size_t)k4a_image_get_width_pixels(depth_image) *
+                             (size_t)k4a_image_get_height_pixels(depth_image);
+        size_t point_size = 3 * sizeof(int16_t) + (options.with_color ? 3 : 0);
+        const int16_t *xyz = (const int16_t *)(const void *)k4a_image_get_buffer(xyz_image);
+        const uint8_t *bgra = options.with_color ? k4a_image_get_buffer(color_in_depth_image) : NULL;
+
+        // Reserve room for the worst case of every pixel being valid behind a header of at most 256 bytes. The header
+        // is filled in right in front of the points once the point count is known, so nothing has to be moved.
+        const size_t header_reserve = 256;
+        result->data.resize(header_reserve + pixel_count * point_size);
+        result->point_count = pack_points(xyz, bgra, pixel_count, result->data.data() + header_reserve);
+        size_t body_size = (size_t)result->point_count * point_size;
+
+        std::vector<uint8_t> header;
+        if (options.format == output_format::ply)
+        {
+            std::string text = ply_header(result->point_count, options.with_color);
+            header.assign(text.begin(), text.end());
+        }
+        else
+        {
+            append_value(header, k4apc_frame_magic);
+            append_value(header, k4a_image_get_device_timestamp_usec(depth_image));
+            append_value(header, result->point_count);
+        }
+
+        result->offset = header_reserve - header.size();
+        memcpy(result->data.data() + result->offset, header.data(), header.size());
+        result->data.resize(header_reserve + body_size);
+    }
+
+    if (color_image != NULL)
+    {
+        k4a_image_release(color_image);
+    }
+    k4a_image_release(depth_image);
+    return converted;
+}
+
+static void export_worker(const export_options &options,
+                          const k4a_calibration_t &calibration,
+                          export_queue &queue,
+                          ordered_writer *writer,
+                          export_stats &stats)
+{
+    // Each worker has its own transformation and output images, so workers never wait on each other
+    k4a_transformation_t transformation = k4a_transformation_create(&calibration);
+    int width = calibration.depth_camera_calibration.resolution_width;
+    int height = calibration.depth_camera_calibration.resolution_height;
+    k4a_image_t xyz_image = NULL;
+    k4a_image_t color_in_depth_image = NULL;
+    bool ready = transformation != NULL &&
+                 k4a_image_create(K4A_IMAGE_FORMAT_CUSTOM,
+                                  width,
+                                  height,
+                                  width * 3 * (int)sizeof(int16_t),
+                                  &xyz_image) == K4A_RESULT_SUCCEEDED;
+    if (ready && options.with_color)
+    {
+        ready = k4a_image_create(K4A_IMAGE_FORMAT_COLOR_BGRA32, width, height, width * 4, &color_in_depth_image) ==
+                K4A_RESULT_SUCCEEDED;
+    }
+    if (!ready)
+    {
+        std::cerr << "Failed to create the point cloud transformation" << std::endl;
+        stats.failed = true;
+    }
+
+    export_job job;
+    while (queue.pop(&job))
+    {
+        export_result result;
+        bool converted = ready && !stats.failed &&
+                         convert_frame(options, transformation, job.capture, xyz_image, color_in_depth_image, &result);
+        k4a_capture_release(job.capture);
+
+        bool written = true;
+        uint64_t bytes = result.size();
+        uint64_t points = result.point_count;
+        if (!converted)
+        {
+            stats.frames_skipped++;
+            written = writer == NULL || writer->skip(job.frame_index);
+        }
+        else if (writer != NULL)
+        {
+            written = writer->write(job.frame_index, std::move(result));
+        }
+        else
+        {
+            char file_name[32];
+            snprintf(file_name, sizeof(file_name), "frame_%06u.ply", job.frame_index);
+            written = write_file(options.output_path + "/" + file_name, result);
+        }
+
+        if (!written)
+        {
+            std::cerr << "Failed to write frame " << job.frame_index << std::endl;
+            stats.failed = true;
+        }
+        else if (converted)
+        {
+            stats.frames_written++;
+            stats.points_written += points;
+            stats.bytes_written += bytes;
+        }
+    }
+
+    if (color_in_depth_image != NULL)
+    {
+        k4a_image_release(color_in_depth_image);
+    }
+    if (xyz_image != NULL)
+    {
+        k4a_image_release(xyz_image);
+    }
+    if (transformation != NULL)
+    {
+        k4a_transformation_destroy(transformation);
+    }
+}
+
+static int export_recording(const export_options &options)
+{
+    k4a_playback_t playback = NULL;
+    if (k4a_playback_open(options.input_path.c_str(), &playback) != K4A_RESULT_SUCCEEDED)
+    {
+        std::cerr << "Failed to open recording: " << options.input_path << std::endl;
+        return 1;
+    }
+
+    int exit_code = 1;
+    FILE *output_file = NULL;
+    std::unique_ptr<char[]> output_buffer;
+    k4a_calibration_t calibration;
+    k4a_record_configuration_t config;
+    if (k4a_playback_get_calibration(playback, &calibration) != K4A_RESULT_SUCCEEDED ||
+        k4a_playback_get_record_configuration(playback, &config) != K4A_RESULT_SUCCEEDED)
+    {
+        std::cerr << "Failed to read the calibration of the recording" << std::endl;
+    }
+    else if (!config.depth_track_enabled)
+    {
+        std::cerr << "The recording has no depth track" << std::endl;
+    }
+    else if (options.with_color && (!config.color_track_enabled ||
+                                    k4a_playback_set_color_conversion(playback, K4A_IMAGE_FORMAT_COLOR_BGRA32) !=
+                                        K4A_RESULT_SUCCEEDED))
+    {
+        std::cerr << "The recording has no color track that can be registered" << std::endl;
+    }
+    else if (k4a_playback_set_lazy_images(playback, true) != K4A_RESULT_SUCCEEDED)
+    {
+        std::cerr << "Failed to defer image decoding to the worker threads" << std::endl;
+    }
+    else if (options.format == output_format::ply && !create_output_directory(options.output_path))
+    {
+        std::cerr << "Failed to create output directory: " << options.output_path << std::endl;
+    }
+    else if (options.format == output_format::k4apc &&
+             (output_file = fopen(options.output_path.c_str(), "wb")) == NULL)
+    {
+        std::cerr << "Failed to create output file: " << options.output_path << std::endl;
+    }
+    else
+    {
+        exit_code = 0;
+    }
+
+    if (exit_code != 0)
+    {
+        k4a_playback_close(playback);
+        return exit_code;
+    }
+
+    std::unique_ptr<ordered_writer> writer;
+    if (output_file != NULL)
+    {
+        output_buffer.reset(new char[OUTPUT_BUFFER_SIZE]);
+        setvbuf(output_file, output_buffer.get(), _IOFBF, OUTPUT_BUFFER_SIZE);
+
+        std::vector<uint8_t> header(k4apc_file_magic, k4apc_file_magic + sizeof(k4apc_file_magic));
+        append_value(header, (uint32_t)(options.with_color ? k4apc_flag_color : 0));
+        append_value(header, (uint32_t)calibration.depth_camera_calibration.resolution_width);
+        append_value(header, (uint32_t)calibration.depth_camera_calibration.resolution_height);
+        if (fwrite(header.data(), 1, header.size(), output_file) != header.size())
+        {
+            std::cerr << "Failed to write output file: " << options.output_path << std::endl;
+            exit_code = 1;
+        }
+        writer.reset(new ordered_writer(output_file));
+    }
+
+    std::cout << "Exporting " << options.input_path << " with " << options.worker_count << " threads" << std::endl;
+
+    export_stats stats;
+    export_queue queue(options.worker_count * 2);
+    std::vector<std::thread> workers;
+    for (uint32_t i = 0; i < options.worker_count; i++)
+    {
+        workers.emplace_back(export_worker,
+                             std::cref(options),
+                             std::cref(calibration),
+                             std::ref(queue),
+                             writer.get(),
+                             std::ref(stats));
+    }
+
+    // Playback is read on this thread only. With lazy images the captures hold undecoded blocks, and each image is
+    // converted by the worker that first gets it from the capture, so the MJPG to BGRA conversion of the color images
+    // runs on every worker instead of here.
+    auto start = std::chrono::steady_clock::now();
+    uint32_t frame_index = 0;
+    while (exit_code == 0 && !stats.failed)
+    {
+        k4a_capture_t capture = NULL;
+        k4a_stream_result_t stream_result = k4a_playback_get_next_capture(playback, &capture);
+        if (stream_result == K4A_STREAM_RESULT_EOF)
+        {
+            break;
+        }
+        else if (stream_result != K4A_STREAM_RESULT_SUCCEEDED)
+        {
+            std::cerr << "Failed to read capture " << frame_index << std::endl;
+            exit_code = 1;
+            break;
+        }
+
+        queue.push(export_job{ frame_index++, capture });
+        if (frame_index % 100 == 0)
+        {
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            std::cout << "  " << frame_index << " frames read, " << (double)stats.frames_written / elapsed.count()
+                      << " frames/s" << std::endl;
+        }
+    }
+
+    queue.close();
+    for (std::thread &worker : workers)
+    {
+        worker.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    if (output_file != NULL && fclose(output_file) != 0)
+    {
+        std::cerr << "Failed to write output file: " << options.output_path << std::endl;
+        exit_code = 1;
+    }
+    k4a_playback_close(playback);
+
+    if (stats.failed)
+    {
+        exit_code = 1;
+    }
+
+    double seconds = std::max(elapsed.count(), 1e-9);
+    std::cout << "Exported " << stats.frames_written << " frames (" << stats.frames_skipped << " skipped), "
+              << stats.points_written << " points, " << (double)stats.bytes_written / (1024.0 * 1024.0) << " MB in "
+              << seconds << " s" << std::endl;
+    std::cout << (double)stats.frames_written / seconds << " frames/s, "
+              << (double)stats.bytes_written / (1024.0 * 1024.0) / seconds << " MB/s" << std::endl;
+    return exit_code;
+}
+
+int main(int argc, char **argv)
+{
+    export_options options;
+    if (!parse_arguments(argc, argv, &options))
+    {
+        print_usage();
+        return 1;
+    }
+
+    return export_recording(options);
+}
@@ -116,6 +116,7 @@ int main(int argc, char **argv)
     k4a_fps_t recording_rate = K4A_FRAMES_PER_SECOND_30;
     bool recording_rate_set = false;
     bool recording_imu_enabled = true;
+    bool recording_preview_enabled = false;
     k4a_wired_sync_mode_t wired_sync_mode = K4A_WIRED_SYNC_MODE_STANDALONE;
     int32_t depth_delay_off_color_usec = 0;
     uint32_t subordinate_delay_off_master_usec = 0;
@@ -287,6 +288,25 @@ int main(int argc, char **argv)
                                       throw std::runtime_error(str.str());
                                   }
                               });
+    cmd_parser.RegisterOption("--preview",
+                              "Set the preview track recording mode (ON, OFF, default: OFF)",
+                              1,
+                              [&](const std::vector<char *> &args) {
+                                  if (string_compare(args[0], "on") == 0)
+                                  {
+                                      recording_preview_enabled = true;
+                                  }
+                                  else if (string_compare(args[0], "off") == 0)
+                                  {
+                                      recording_preview_enabled = false;
+                                  }
+                                  else
+                                  {
+                                      std::ostringstream str;
+                                      str << "Unknown preview mode specified: " << args[0];
+                                      throw std::runtime_error(str.str());
+                                  }
+                              });
     cmd_parser.RegisterOption("--external-sync",
                               "Set the external sync mode (Master, Subordinate, Standalone default: Standalone)",
                               1,
@@ -429,6 +449,7 @@ int main(int argc, char **argv)
                         recording_length,
                         &device_config,
                         recording_imu_enabled,
+                        recording_preview_enabled,
                         absoluteExposureValue,
                         gain);
 }
@@ -50,6 +50,7 @@ int do_recording(uint8_t device_index,
                  int recording_length,
                  k4a_device_configuration_t *device_config,
                  bool record_imu,
+                 bool record_preview,
                  int32_t absoluteExposureValue,
                  int32_t gain)
 {
@@ -148,6 +149,10 @@ int do_recording(uint8_t device_index,
     {
         CHECK(k4a_record_add_imu_track(recording), device);
     }
+    if (record_preview)
+    {
+        CHECK(k4a_record_add_preview_track(recording, NULL), device);
+    }
     CHECK(k4a_record_write_header(recording), device);
 
     // Wait for the first capture before starting recording.
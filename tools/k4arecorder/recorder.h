@@ -17,6 +17,7 @@ int do_recording(uint8_t device_index,
                  int recording_length,
                  k4a_device_configuration_t *device_config,
                  bool record_imu,
+                 bool record_preview,
                  int32_t absoluteExposureValue,
                  int32_t gain);
 
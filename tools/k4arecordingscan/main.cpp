@@ -0,0 +1,272 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <k4a/k4a.h>
+#include <k4arecord/playback.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct scan_options
+{
+    std::vector<std::string> paths;
+    bool csv = false;
+    uint32_t thread_count = 0;
+};
+
+struct track_report
+{
+    std::string name;
+    k4a_playback_track_statistics_t statistics;
+};
+
+struct recording_report
+{
+    bool scanned = false;
+    k4a_playback_statistics_t statistics = {};
+    std::vector<track_report> tracks;
+};
+
+static void print_usage()
+{
+    std::cout << "k4arecordingscan - Azure Kinect recording statistics and integrity scanner" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Usage: k4arecordingscan [options] <recording.mkv>..." << std::endl;
+    std::cout << std::endl;
+    std::cout << "  -h, --help       Prints this help" << std::endl;
+    std::cout << "  -c, --csv        Print one comma separated line per track instead of a summary" << std::endl;
+    std::cout << "  -t, --threads N  Number of recordings scanned at once (default: number of processors)"
+              << std::endl;
+}
+
+static bool parse_arguments(int argc, char **argv, scan_options *options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "-h" || arg == "--help")
+        {
+            return false;
+        }
+        else if (arg == "-c" || arg == "--csv")
+        {
+            options->csv = true;
+        }
+        else if ((arg == "-t" || arg == "--threads") && i + 1 < argc)
+        {
+            int thread_count = atoi(argv[++i]);
+            if (thread_count < 1)
+            {
+                std::cerr << "Thread count must be at least 1" << std::endl;
+                return false;
+            }
+            options->thread_count = (uint32_t)thread_count;
+        }
+        else if (!arg.empty() && arg[0] == '-')
+        {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            return false;
+        }
+        else
+        {
+            options->paths.push_back(arg);
+        }
+    }
+
+    if (options->paths.empty())
+    {
+        return false;
+    }
+    if (options->thread_count == 0)
+    {
+        options->thread_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+    return true;
+}
+
+static void scan_recording(const std::string &path, recording_report *report)
+{
+    k4a_playback_t playback = NULL;
+    if (K4A_FAILED(k4a_playback_open(path.c_str(), &playback)))
+    {
+        return;
+    }
+
+    if (K4A_SUCCEEDED(k4a_playback_get_statistics(playback, &report->statistics)))
+    {
+        report->scanned = true;
+
+        size_t track_count = k4a_playback_get_track_count(playback);
+        for (size_t i = 0; i < track_count; i++)
+        {
+            track_report track;
+            size_t name_size = 0;
+            if (k4a_playback_get_track_name(playback, i, NULL, &name_size) != K4A_BUFFER_RESULT_TOO_SMALL)
+            {
+                continue;
+            }
+            std::vector<char> name(name_size);
+            if (k4a_playback_get_track_name(playback, i, name.data(), &name_size) != K4A_BUFFER_RESULT_SUCCEEDED)
+            {
+                continue;
+            }
+            track.name = name.data();
+
+            if (K4A_SUCCEEDED(k4a_playback_track_get_statistics(playback, track.name.c_str(), &track.statistics)))
+            {
+                report->tracks.push_back(track);
+            }
+        }
+    }
+
+    k4a_playback_close(playback);
+}
+
+static void print_summary(const std::string &path, const recording_report &report)
+{
+    if (!report.scanned)
+    {
+        printf("%s: failed to open or scan recording\n", path.c_str());
+        return;
+    }
+
+    const k4a_playback_statistics_t &statistics = report.statistics;
+    printf("%s: %" PRIu64 " clusters, %" PRIu64 " blocks, %.1f MB%s\n",
+           path.c_str(),
+           statistics.cluster_count,
+           statistics.block_count,
+           (double)statistics.file_size_bytes / (1024 * 1024),
+           statistics.truncated ? ", TRUNCATED" : "");
+    if (statistics.unknown_track_block_count > 0)
+    {
+        printf("  %" PRIu64 " blocks belong to unknown tracks\n", statistics.unknown_track_block_count);
+    }
+
+    for (const track_report &track : report.tracks)
+    {
+        const k4a_playback_track_statistics_t &track_statistics = track.statistics;
+        printf("  %-12s %8" PRIu64 " frames  %10.3f - %10.3f s  max gap %8.3f ms  %" PRIu64 " gaps, %" PRIu64
+               " dropped  %8.2f Mbit/s\n",
+               track.name.c_str(),
+               track_statistics.frame_count,
+               (double)track_statistics.start_timestamp_usec / 1e6,
+               (double)track_statistics.end_timestamp_usec / 1e6,
+               (double)track_statistics.max_gap_usec / 1e3,
+               track_statistics.gap_count,
+               track_statistics.dropped_frame_estimate,
+               (double)track_statistics.bitrate_bps / 1e6);
+        if (track_statistics.out_of_order_count > 0)
+        {
+            printf("  %-12s %" PRIu64 " blocks out of order\n",
+                   track.name.c_str(),
+                   track_statistics.out_of_order_count);
+        }
+    }
+}
+
+static void print_csv_header()
+{
+    printf("path,truncated,track,frames,blocks,bytes,start_usec,end_usec,frame_period_usec,max_gap_usec,gaps,dropped,"
+           "out_of_order,bitrate_bps\n");
+}
+
+static void print_csv(const std::string &path, const recording_report &report)
+{
+    if (!report.scanned)
+    {
+        printf("%s,,,,,,,,,,,,,\n", path.c_str());
+        return;
+    }
+
+    for (const track_report &track : report.tracks)
+    {
+        const k4a_playback_track_statistics_t &track_statistics = track.statistics;
+        printf("%s,%d,%s,%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64
+               ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 "\n",
+               path.c_str(),
+               report.statistics.truncated ? 1 : 0,
+               track.name.c_str(),
+               track_statistics.frame_count,
+               track_statistics.block_count,
+               track_statistics.data_size_bytes,
+               track_statistics.start_timestamp_usec,
+               track_statistics.end_timestamp_usec,
+               track_statistics.frame_period_usec,
+               track_statistics.max_gap_usec,
+               track_statistics.gap_count,
+               track_statistics.dropped_frame_estimate,
+               track_statistics.out_of_order_count,
+               track_statistics.bitrate_bps);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    scan_options options;
+    if (!parse_arguments(argc, argv, &options))
+    {
+        print_usage();
+        return 1;
+    }
+
+    // Each thread takes the next recording that nobody is scanning yet. Playback handles are independent, so
+    // recordings are scanned in parallel without any other synchronization.
+    std::vector<recording_report> reports(options.paths.size());
+    std::atomic<size_t> next_recording(0);
+    auto scan_worker = [&]() {
+        for (size_t i = next_recording++; i < options.paths.size(); i = next_recording++)
+        {
+            scan_recording(options.paths[i], &reports[i]);
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    size_t thread_count = std::min((size_t)options.thread_count, options.paths.size());
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < thread_count; i++)
+    {
+        threads.emplace_back(scan_worker);
+    }
+    scan_worker();
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    int exit_code = 0;
+    if (options.csv)
+    {
+        print_csv_header();
+    }
+    for (size_t i = 0; i < options.paths.size(); i++)
+    {
+        if (options.csv)
+        {
+            print_csv(options.paths[i], reports[i]);
+        }
+        else
+        {
+            print_summary(options.paths[i], reports[i]);
+        }
+
+        if (!reports[i].scanned || reports[i].statistics.truncated)
+        {
+            exit_code = 1;
+        }
+    }
+
+    if (!options.csv)
+    {
+        printf("Scanned %zu recordings in %.2f s\n", options.paths.size(), elapsed);
+    }
+    return exit_code;
+}